@@ -0,0 +1,134 @@
+#pragma once
+
+#include <sqlite_orm/sqlite_orm.h>
+#include <string>  //  std::string, std::to_string
+#include <vector>  //  std::vector
+#include <stdexcept>  //  std::runtime_error
+#include <random>  //  std::mt19937
+#include <cstdint>  //  std::uint32_t
+
+/**
+ *  Common schema of all benchmarks. Every ORM benchmark has a `raw_` twin doing the same work with plain
+ *  sqlite3 calls on the same schema, so the difference between the two is the overhead of sqlite_orm.
+ */
+namespace benchmarks {
+    struct User {
+        int id = 0;
+        std::string name;
+        int age = 0;
+        double rating = 0;
+    };
+
+    inline auto make_benchmark_storage() {
+        using namespace sqlite_orm;
+        return make_storage({},
+                            make_table("users",
+                                       make_column("id", &User::id, primary_key()),
+                                       make_column("name", &User::name),
+                                       make_column("age", &User::age),
+                                       make_column("rating", &User::rating)));
+    }
+
+    using storage_type = decltype(make_benchmark_storage());
+
+    inline std::vector<User> make_users(int count) {
+        std::vector<User> users;
+        users.reserve(size_t(count));
+        for(int i = 1; i <= count; ++i) {
+            users.push_back(User{i, "user" + std::to_string(i), 18 + i % 50, i * 0.5});
+        }
+        return users;
+    }
+
+    /**
+     *  `count` users with names, ages and ratings drawn from `std::mt19937` seeded with `seed`. The output of the
+     *  engine is fixed by the standard, unlike the one of the distributions, so a seed gives the same users on every
+     *  platform, and benchmark runs on different machines or library versions work on the same data.
+     */
+    inline std::vector<User> make_random_users(int count, std::uint32_t seed) {
+        std::mt19937 engine{seed};
+        std::vector<User> users;
+        users.reserve(size_t(count));
+        for(int i = 1; i <= count; ++i) {
+            const std::uint32_t value = engine();
+            users.push_back(
+                User{i, "user" + std::to_string(value % 100000), 18 + int(value % 50), (value % 1000) * 0.01});
+        }
+        return users;
+    }
+
+    /**
+     *  Creates the schema and fills it with `count` users. Copying an in-memory storage opens a new empty
+     *  database, so storages are filled in place instead of being returned.
+     */
+    inline void fill_storage(storage_type& storage, int count) {
+        storage.sync_schema();
+        auto users = make_users(count);
+        storage.replace_range(users.begin(), users.end());
+    }
+
+    /**
+     *  Runs `sql` that doesn't return rows on a raw connection.
+     */
+    inline void raw_exec(sqlite3* db, const char* sql) {
+        if(sqlite3_exec(db, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::runtime_error{sqlite3_errmsg(db)};
+        }
+    }
+
+    inline sqlite3_stmt* raw_prepare(sqlite3* db, const char* sql) {
+        sqlite3_stmt* stmt = nullptr;
+        if(sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error{sqlite3_errmsg(db)};
+        }
+        return stmt;
+    }
+
+    /**
+     *  An in-memory raw connection with the same schema and data as `fill_storage(storage, count)`.
+     */
+    struct raw_database {
+        sqlite3* db = nullptr;
+
+        explicit raw_database(int count) {
+            sqlite3_open(":memory:", &this->db);
+            raw_exec(this->db,
+                     "CREATE TABLE \"users\" (\"id\" INTEGER PRIMARY KEY NOT NULL, \"name\" TEXT NOT NULL, "
+                     "\"age\" INTEGER NOT NULL, \"rating\" REAL NOT NULL)");
+            raw_exec(this->db, "BEGIN");
+            sqlite3_stmt* stmt = raw_prepare(
+                this->db,
+                "INSERT INTO \"users\" (\"id\", \"name\", \"age\", \"rating\") VALUES (?, ?, ?, ?)");
+            for(auto& user: make_users(count)) {
+                this->bind_user(stmt, user);
+                sqlite3_step(stmt);
+                sqlite3_reset(stmt);
+            }
+            sqlite3_finalize(stmt);
+            raw_exec(this->db, "COMMIT");
+        }
+
+        raw_database(const raw_database&) = delete;
+        raw_database& operator=(const raw_database&) = delete;
+
+        ~raw_database() {
+            sqlite3_close(this->db);
+        }
+
+        static void bind_user(sqlite3_stmt* stmt, const User& user) {
+            sqlite3_bind_int(stmt, 1, user.id);
+            sqlite3_bind_text(stmt, 2, user.name.c_str(), int(user.name.size()), SQLITE_TRANSIENT);
+            sqlite3_bind_int(stmt, 3, user.age);
+            sqlite3_bind_double(stmt, 4, user.rating);
+        }
+
+        static User extract_user(sqlite3_stmt* stmt) {
+            User user;
+            user.id = sqlite3_column_int(stmt, 0);
+            user.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            user.age = sqlite3_column_int(stmt, 2);
+            user.rating = sqlite3_column_double(stmt, 3);
+            return user;
+        }
+    };
+}
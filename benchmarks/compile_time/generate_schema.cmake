@@ -0,0 +1,42 @@
+# Generates a synthetic schema header with TABLES mapped structs of COLUMNS fields each and the function
+# `make_benchmark_storage()` creating a storage of all of them.
+# Usage: cmake -DTABLES=60 -DCOLUMNS=10 -DOUTPUT=schema.h -P generate_schema.cmake
+
+set(content "#pragma once\n\n#include <sqlite_orm/sqlite_orm.h>\n#include <string>\n\nnamespace compile_benchmark {\n")
+math(EXPR lastTable "${TABLES} - 1")
+math(EXPR lastColumn "${COLUMNS} - 1")
+foreach(t RANGE ${lastTable})
+    string(APPEND content "    struct Table${t} {\n        int id = 0;\n")
+    foreach(c RANGE ${lastColumn})
+        math(EXPR kind "${c} % 3")
+        if(kind EQUAL 0)
+            string(APPEND content "        int field${c} = 0;\n")
+        elseif(kind EQUAL 1)
+            string(APPEND content "        std::string field${c};\n")
+        else()
+            string(APPEND content "        double field${c} = 0;\n")
+        endif()
+    endforeach()
+    string(APPEND content "    };\n")
+endforeach()
+
+string(APPEND content "\n    inline auto make_benchmark_storage() {\n        using namespace sqlite_orm;\n")
+string(APPEND content "        return make_storage(\"\"")
+foreach(t RANGE ${lastTable})
+    string(APPEND content ",\n            make_table(\"table${t}\",\n"
+           "                       make_column(\"id\", &Table${t}::id, primary_key())")
+    foreach(c RANGE ${lastColumn})
+        string(APPEND content ",\n                       make_column(\"field${c}\", &Table${t}::field${c})")
+    endforeach()
+    string(APPEND content ")")
+endforeach()
+string(APPEND content ");\n    }\n}\n")
+
+# don't touch the file if nothing changed so that the benchmarks aren't rebuilt on every configure
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" oldContent)
+    if(oldContent STREQUAL content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")
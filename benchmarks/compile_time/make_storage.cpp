@@ -0,0 +1,7 @@
+#include "schema.h"
+
+//  measures instantiating `make_storage` and the storage type alone
+int main() {
+    auto storage = compile_benchmark::make_benchmark_storage();
+    return storage.filename().empty() ? 0 : 1;
+}
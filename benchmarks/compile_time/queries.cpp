@@ -0,0 +1,31 @@
+#include "schema.h"
+
+using namespace sqlite_orm;
+using namespace compile_benchmark;
+
+//  measures typical CRUD calls and queries against the first and the last table of the schema
+//  because both ends of the storage type are looked up differently
+template<class T, class S>
+void run_queries(S& storage) {
+    T object;
+    object.id = storage.insert(object);
+    storage.update(object);
+    storage.replace(object);
+    (void)storage.template get<T>(object.id);
+    (void)storage.template get_pointer<T>(object.id);
+    (void)storage.template get_all<T>(where(c(&T::id) > 0), order_by(&T::field0), limit(10));
+    (void)storage.select(columns(&T::id, &T::field0, &T::field1), where(c(&T::field0) == 0));
+    (void)storage.template count<T>(where(like(&T::field1, "a%")));
+    for(auto& row: storage.template iterate<T>()) {
+        (void)row;
+    }
+    storage.template remove<T>(object.id);
+}
+
+int main() {
+    auto storage = make_benchmark_storage();
+    storage.sync_schema();
+    run_queries<Table0>(storage);
+    run_queries<SQLITE_ORM_COMPILE_BENCHMARK_LAST_TABLE>(storage);
+    return 0;
+}
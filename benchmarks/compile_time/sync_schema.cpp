@@ -0,0 +1,8 @@
+#include "schema.h"
+
+//  measures instantiating `sync_schema` which walks all tables and columns of the storage
+int main() {
+    auto storage = compile_benchmark::make_benchmark_storage();
+    storage.sync_schema();
+    return 0;
+}
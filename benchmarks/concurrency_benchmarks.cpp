@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>  //  ::remove
+
+#include "benchmark_storage.h"
+
+using namespace sqlite_orm;
+using namespace benchmarks;
+
+/**
+ *  Throughput of one storage shared by 1 to 8 threads. Items per second at each thread count show how far
+ *  the storage scales: a pool of one connection makes the threads take turns, a pool of eight lets reads
+ *  run side by side.
+ */
+namespace {
+    const int usersCount = 1000;
+
+    auto make_shared_storage(const char* filename, int poolSize) {
+        ::remove(filename);
+        return make_storage(pool_options{poolSize},
+                            filename,
+                            make_table("users",
+                                       make_column("id", &User::id, primary_key()),
+                                       make_column("name", &User::name),
+                                       make_column("age", &User::age),
+                                       make_column("rating", &User::rating)));
+    }
+
+    using shared_storage_type = decltype(make_shared_storage("", 1));
+
+    /**
+     *  A storage in WAL mode filled with `usersCount` users. It is made once by whichever thread comes first
+     *  and outlives the benchmarks.
+     */
+    struct shared_storage {
+        shared_storage(const char* filename, int poolSize) : storage{make_shared_storage(filename, poolSize)} {
+            this->storage.on_open = [](sqlite3* db) {
+                sqlite3_busy_timeout(db, 5000);
+            };
+            this->storage.pragma.journal_mode(journal_mode::WAL);
+            this->storage.sync_schema();
+            auto users = make_users(usersCount);
+            this->storage.replace_range(users.begin(), users.end());
+        }
+
+        shared_storage_type storage;
+    };
+
+    shared_storage_type& pooled_storage() {
+        static shared_storage shared{"concurrency_pooled.sqlite", 8};
+        return shared.storage;
+    }
+
+    shared_storage_type& single_connection_storage() {
+        static shared_storage shared{"concurrency_single.sqlite", 1};
+        return shared.storage;
+    }
+
+    void concurrent_get(benchmark::State& state, shared_storage_type& storage) {
+        int id = state.thread_index();
+        for(auto _: state) {
+            benchmark::DoNotOptimize(storage.get<User>(id++ % usersCount + 1));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /**
+     *  Every tenth call updates a user of its own thread, the others read. 1000 users split evenly between
+     *  1, 2, 4 or 8 threads.
+     */
+    void concurrent_mixed(benchmark::State& state, shared_storage_type& storage) {
+        const int threadsCount = state.threads();
+        int id = state.thread_index();
+        int calls = 0;
+        for(auto _: state) {
+            auto user = storage.get<User>(id % usersCount + 1);
+            if(++calls % 10 == 0) {
+                ++user.age;
+                storage.update(user);
+            }
+            id += threadsCount;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void pooled_get(benchmark::State& state) {
+        concurrent_get(state, pooled_storage());
+    }
+    BENCHMARK(pooled_get)->ThreadRange(1, 8)->UseRealTime();
+
+    void single_connection_get(benchmark::State& state) {
+        concurrent_get(state, single_connection_storage());
+    }
+    BENCHMARK(single_connection_get)->ThreadRange(1, 8)->UseRealTime();
+
+    void pooled_mixed(benchmark::State& state) {
+        concurrent_mixed(state, pooled_storage());
+    }
+    BENCHMARK(pooled_mixed)->ThreadRange(1, 8)->UseRealTime();
+
+    void single_connection_mixed(benchmark::State& state) {
+        concurrent_mixed(state, single_connection_storage());
+    }
+    BENCHMARK(single_connection_mixed)->ThreadRange(1, 8)->UseRealTime();
+}
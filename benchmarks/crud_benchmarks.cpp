@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_storage.h"
+
+using namespace sqlite_orm;
+using namespace benchmarks;
+
+namespace {
+    const int usersCount = 1000;
+
+    void orm_get(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        fill_storage(storage, usersCount);
+        int id = 0;
+        for(auto _: state) {
+            benchmark::DoNotOptimize(storage.get<User>(id++ % usersCount + 1));
+        }
+    }
+    BENCHMARK(orm_get);
+
+    void raw_get(benchmark::State& state) {
+        raw_database database{usersCount};
+        sqlite3_stmt* stmt = raw_prepare(
+            database.db,
+            "SELECT \"users\".\"id\", \"users\".\"name\", \"users\".\"age\", \"users\".\"rating\" FROM \"users\" "
+            "WHERE \"users\".\"id\" = ?");
+        int id = 0;
+        for(auto _: state) {
+            sqlite3_bind_int(stmt, 1, id++ % usersCount + 1);
+            sqlite3_step(stmt);
+            benchmark::DoNotOptimize(raw_database::extract_user(stmt));
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
+    BENCHMARK(raw_get);
+
+    void orm_insert(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        storage.sync_schema();
+        User user{0, "Alice", 30, 4.5};
+        for(auto _: state) {
+            benchmark::DoNotOptimize(storage.insert(user));
+        }
+    }
+    BENCHMARK(orm_insert);
+
+    void raw_insert(benchmark::State& state) {
+        raw_database database{0};
+        sqlite3_stmt* stmt =
+            raw_prepare(database.db, "INSERT INTO \"users\" (\"name\", \"age\", \"rating\") VALUES (?, ?, ?)");
+        User user{0, "Alice", 30, 4.5};
+        for(auto _: state) {
+            sqlite3_bind_text(stmt, 1, user.name.c_str(), int(user.name.size()), SQLITE_TRANSIENT);
+            sqlite3_bind_int(stmt, 2, user.age);
+            sqlite3_bind_double(stmt, 3, user.rating);
+            sqlite3_step(stmt);
+            benchmark::DoNotOptimize(sqlite3_last_insert_rowid(database.db));
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
+    BENCHMARK(raw_insert);
+
+    void orm_update(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        fill_storage(storage, usersCount);
+        User user{1, "Alice", 30, 4.5};
+        for(auto _: state) {
+            user.id = user.id % usersCount + 1;
+            ++user.age;
+            storage.update(user);
+        }
+    }
+    BENCHMARK(orm_update);
+
+    void raw_update(benchmark::State& state) {
+        raw_database database{usersCount};
+        sqlite3_stmt* stmt = raw_prepare(
+            database.db,
+            "UPDATE \"users\" SET \"name\" = ?, \"age\" = ?, \"rating\" = ? WHERE \"id\" = ?");
+        User user{1, "Alice", 30, 4.5};
+        for(auto _: state) {
+            user.id = user.id % usersCount + 1;
+            ++user.age;
+            sqlite3_bind_text(stmt, 1, user.name.c_str(), int(user.name.size()), SQLITE_TRANSIENT);
+            sqlite3_bind_int(stmt, 2, user.age);
+            sqlite3_bind_double(stmt, 3, user.rating);
+            sqlite3_bind_int(stmt, 4, user.id);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
+    BENCHMARK(raw_update);
+
+    void orm_bulk_insert(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        storage.sync_schema();
+        auto users = make_users(int(state.range(0)));
+        for(auto _: state) {
+            storage.transaction([&storage, &users] {
+                storage.replace_range(users.begin(), users.end());
+                return true;
+            });
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(orm_bulk_insert)->Arg(1000)->Arg(100000);
+
+    void raw_bulk_insert(benchmark::State& state) {
+        raw_database database{0};
+        auto users = make_users(int(state.range(0)));
+        sqlite3_stmt* stmt = raw_prepare(
+            database.db,
+            "REPLACE INTO \"users\" (\"id\", \"name\", \"age\", \"rating\") VALUES (?, ?, ?, ?)");
+        for(auto _: state) {
+            raw_exec(database.db, "BEGIN");
+            for(auto& user: users) {
+                raw_database::bind_user(stmt, user);
+                sqlite3_step(stmt);
+                sqlite3_reset(stmt);
+            }
+            raw_exec(database.db, "COMMIT");
+        }
+        sqlite3_finalize(stmt);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(raw_bulk_insert)->Arg(1000)->Arg(100000);
+}
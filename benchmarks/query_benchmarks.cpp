@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_storage.h"
+
+using namespace sqlite_orm;
+using namespace benchmarks;
+
+namespace {
+    const char* selectAllUsers =
+        "SELECT \"users\".\"id\", \"users\".\"name\", \"users\".\"age\", \"users\".\"rating\" FROM \"users\"";
+
+    void orm_get_all(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        fill_storage(storage, int(state.range(0)));
+        for(auto _: state) {
+            benchmark::DoNotOptimize(storage.get_all<User>());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(orm_get_all)->Arg(100)->Arg(10000);
+
+    void raw_get_all(benchmark::State& state) {
+        raw_database database{int(state.range(0))};
+        sqlite3_stmt* stmt = raw_prepare(database.db, selectAllUsers);
+        for(auto _: state) {
+            std::vector<User> users;
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                users.push_back(raw_database::extract_user(stmt));
+            }
+            sqlite3_reset(stmt);
+            benchmark::DoNotOptimize(users);
+        }
+        sqlite3_finalize(stmt);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(raw_get_all)->Arg(100)->Arg(10000);
+
+    void orm_iterate(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        fill_storage(storage, int(state.range(0)));
+        for(auto _: state) {
+            int ageSum = 0;
+            for(auto& user: storage.iterate<User>()) {
+                ageSum += user.age;
+            }
+            benchmark::DoNotOptimize(ageSum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(orm_iterate)->Arg(100)->Arg(10000);
+
+    void raw_iterate(benchmark::State& state) {
+        raw_database database{int(state.range(0))};
+        sqlite3_stmt* stmt = raw_prepare(database.db, selectAllUsers);
+        for(auto _: state) {
+            int ageSum = 0;
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                ageSum += raw_database::extract_user(stmt).age;
+            }
+            sqlite3_reset(stmt);
+            benchmark::DoNotOptimize(ageSum);
+        }
+        sqlite3_finalize(stmt);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(raw_iterate)->Arg(100)->Arg(10000);
+
+    void orm_select_tuples(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        fill_storage(storage, int(state.range(0)));
+        for(auto _: state) {
+            benchmark::DoNotOptimize(storage.select(columns(&User::id, &User::name), where(c(&User::age) > 30)));
+        }
+    }
+    BENCHMARK(orm_select_tuples)->Arg(100)->Arg(10000);
+
+    void raw_select_tuples(benchmark::State& state) {
+        raw_database database{int(state.range(0))};
+        sqlite3_stmt* stmt = raw_prepare(
+            database.db,
+            "SELECT \"users\".\"id\", \"users\".\"name\" FROM \"users\" WHERE (\"users\".\"age\" > ?)");
+        for(auto _: state) {
+            std::vector<std::tuple<int, std::string>> rows;
+            sqlite3_bind_int(stmt, 1, 30);
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                rows.emplace_back(sqlite3_column_int(stmt, 0),
+                                  reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+            }
+            sqlite3_reset(stmt);
+            benchmark::DoNotOptimize(rows);
+        }
+        sqlite3_finalize(stmt);
+    }
+    BENCHMARK(raw_select_tuples)->Arg(100)->Arg(10000);
+}
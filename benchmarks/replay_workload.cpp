@@ -0,0 +1,100 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <cstdlib>  //  std::atoi, std::atof
+#include <cstring>  //  std::strcmp
+#include <fstream>  //  std::ifstream
+#include <iostream>  //  std::cout, std::cerr
+#include <string>  //  std::string
+
+/**
+ *  Replays a trace saved from a `workload_recorder` against a copy of the captured database and prints
+ *  throughput and latency percentiles, e.g. to compare pool sizes, performance profiles or library versions:
+ *
+ *      replay_workload <database> <trace> [--threads N] [--speed X] [--pool N] [--profile NAME]
+ *
+ *  `--speed 1` keeps the pace of the capture, 0 (the default) replays as fast as possible. `--profile` is one
+ *  of read_heavy, bulk_load, low_memory or durable. Replaying writes to the database, so pass a copy of it.
+ */
+using namespace sqlite_orm;
+
+namespace {
+    bool find_profile(const std::string& name, performance_profile& profile) {
+        if(name == "read_heavy") {
+            profile = performance_profile::read_heavy();
+        } else if(name == "bulk_load") {
+            profile = performance_profile::bulk_load();
+        } else if(name == "low_memory") {
+            profile = performance_profile::low_memory();
+        } else if(name == "durable") {
+            profile = performance_profile::durable();
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    void print_report(const workload_replay_report& report) {
+        auto ms = [](std::chrono::nanoseconds duration) {
+            return double(duration.count()) / 1e6;
+        };
+        std::cout << "statements: " << report.statements << " (" << report.errors << " failed)\n"
+                  << "elapsed:    " << ms(report.elapsed) << " ms\n"
+                  << "throughput: " << report.throughput << " statements/s\n"
+                  << "latency:    p50 " << ms(report.p50) << " ms, p90 " << ms(report.p90) << " ms, p99 "
+                  << ms(report.p99) << " ms, max " << ms(report.max) << " ms\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        std::cerr << "usage: " << argv[0]
+                  << " <database> <trace> [--threads N] [--speed X] [--pool N] [--profile NAME]\n";
+        return 2;
+    }
+    workload_replay_options options;
+    int poolSize = 0;
+    std::string profileName;
+    for(int i = 3; i + 1 < argc; i += 2) {
+        if(std::strcmp(argv[i], "--threads") == 0) {
+            options.threads = std::atoi(argv[i + 1]);
+        } else if(std::strcmp(argv[i], "--speed") == 0) {
+            options.speed = std::atof(argv[i + 1]);
+        } else if(std::strcmp(argv[i], "--pool") == 0) {
+            poolSize = std::atoi(argv[i + 1]);
+        } else if(std::strcmp(argv[i], "--profile") == 0) {
+            profileName = argv[i + 1];
+        } else {
+            std::cerr << "unknown option " << argv[i] << "\n";
+            return 2;
+        }
+    }
+    performance_profile profile;
+    if(!profileName.empty() && !find_profile(profileName, profile)) {
+        std::cerr << "unknown profile " << profileName << "\n";
+        return 2;
+    }
+
+    std::ifstream file{argv[2]};
+    if(!file) {
+        std::cerr << "cannot open " << argv[2] << "\n";
+        return 1;
+    }
+    try {
+        auto trace = workload_trace::load(file);
+        //  the schema comes with the database, the storage maps no tables
+        auto storage = poolSize > 0 ? make_storage(pool_options{poolSize}, argv[1]) : make_storage(argv[1]);
+        storage.on_open = [](sqlite3* db) {
+            sqlite3_busy_timeout(db, 5000);
+        };
+        if(!profileName.empty()) {
+            storage.apply_performance_profile(profile);
+            //  switching the journal mode needs the database to itself, so one connection applies the profile
+            //  before the replaying threads open theirs
+            storage.session();
+        }
+        print_report(storage.replay_workload(trace, options));
+    } catch(const std::system_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
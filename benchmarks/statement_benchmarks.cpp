@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_storage.h"
+
+using namespace sqlite_orm;
+using namespace benchmarks;
+
+namespace {
+    /**
+     *  Serializing has no raw counterpart: a raw sqlite3 user writes the SQL text by hand,
+     *  so `raw_prepare_only` is the baseline of both `orm_serialize_only` and `orm_prepare_only`.
+     */
+    void orm_serialize_only(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        for(auto _: state) {
+            benchmark::DoNotOptimize(
+                storage.dump(get_all<User>(where(c(&User::age) > 30 and like(&User::name, "user%")),
+                                           order_by(&User::rating).desc(),
+                                           limit(10))));
+        }
+    }
+    BENCHMARK(orm_serialize_only);
+
+    void orm_prepare_only(benchmark::State& state) {
+        auto storage = make_benchmark_storage();
+        storage.sync_schema();
+        for(auto _: state) {
+            auto statement = storage.prepare(get_all<User>(where(c(&User::age) > 30 and like(&User::name, "user%")),
+                                                           order_by(&User::rating).desc(),
+                                                           limit(10)));
+            benchmark::DoNotOptimize(statement);
+        }
+    }
+    BENCHMARK(orm_prepare_only);
+
+    void raw_prepare_only(benchmark::State& state) {
+        raw_database database{0};
+        for(auto _: state) {
+            sqlite3_stmt* stmt =
+                raw_prepare(database.db,
+                            "SELECT \"users\".\"id\", \"users\".\"name\", \"users\".\"age\", \"users\".\"rating\" "
+                            "FROM \"users\" WHERE ((\"users\".\"age\" > ?) AND \"users\".\"name\" LIKE ?) "
+                            "ORDER BY \"users\".\"rating\" DESC LIMIT ?");
+            benchmark::DoNotOptimize(stmt);
+            sqlite3_finalize(stmt);
+        }
+    }
+    BENCHMARK(raw_prepare_only);
+}
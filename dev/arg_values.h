@@ -2,6 +2,7 @@
 
 #include <sqlite3.h>
 
+#include "functional/cxx_string_view.h"
 #include "row_extractor.h"
 
 namespace sqlite_orm {
@@ -12,11 +13,40 @@ namespace sqlite_orm {
 
         arg_value(sqlite3_value* value_) : value(value_) {}
 
+        /**
+         *  Converts the value to `T`. `std::string_view` and `std::span<const std::byte>` refer to the buffer
+         *  of sqlite without copying it and are valid until the function returns.
+         */
         template<class T>
         T get() const {
             return row_extractor<T>().extract(this->value);
         }
 
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+        /**
+         *  The value as text without copying it. Valid until the function returns.
+         */
+        std::string_view text() const {
+            return this->get<std::string_view>();
+        }
+#endif  //  SQLITE_ORM_STRING_VIEW_SUPPORTED
+
+#if __cpp_lib_span >= 202002L
+        /**
+         *  The value as a blob without copying it. Valid until the function returns.
+         */
+        std::span<const std::byte> blob() const {
+            return this->get<std::span<const std::byte>>();
+        }
+#endif
+
+        /**
+         *  Size of the value in bytes as text or blob.
+         */
+        int bytes() const {
+            return sqlite3_value_bytes(this->value);
+        }
+
         bool is_null() const {
             auto type = sqlite3_value_type(this->value);
             return type == SQLITE_NULL;
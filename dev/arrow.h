@@ -0,0 +1,610 @@
+#pragma once
+
+#ifdef SQLITE_ORM_ARROW_ENABLED
+#include <sqlite3.h>
+#include <cerrno>  //  EINVAL, EIO
+#include <cstdint>  //  int64_t, int32_t, uint8_t
+#include <cstring>  //  std::memcpy, std::strcmp
+#include <exception>  //  std::exception
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <string>  //  std::string
+#include <system_error>  //  std::system_error
+#include <tuple>  //  std::tuple, std::get
+#include <type_traits>  //  std::is_arithmetic, std::is_floating_point, std::is_signed, std::is_same
+#include <utility>  //  std::move, std::index_sequence, std::index_sequence_for
+#include <vector>  //  std::vector
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+#include <optional>  //  std::optional
+#endif
+
+#include "functional/cxx_universal.h"
+#include "functional/static_magic.h"
+#include "error_code.h"
+#include "column.h"
+#include "row_extractor.h"
+#include "columnar.h"
+#include "util.h"
+
+//  Arrow C data interface and C stream interface, see https://arrow.apache.org/docs/format/CDataInterface.html.
+//  The structures are an ABI of their own: everyone defines them the same way under the same guards.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+#endif
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+    void (*release)(struct ArrowArrayStream*);
+    void* private_data;
+};
+#endif
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        template<class T, class SFINAE = void>
+        struct arrow_format;
+
+        template<>
+        struct arrow_format<bool, void> {
+            static constexpr const char* value = "b";
+        };
+
+        template<class T>
+        struct arrow_format<T, std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>> {
+            static constexpr const char* value = std::is_floating_point<T>::value
+                                                     ? (sizeof(T) == 4 ? "f" : "g")
+                                                     : sizeof(T) == 1 ? (std::is_signed<T>::value ? "c" : "C")
+                                                     : sizeof(T) == 2 ? (std::is_signed<T>::value ? "s" : "S")
+                                                     : sizeof(T) == 4 ? (std::is_signed<T>::value ? "i" : "I")
+                                                                      : (std::is_signed<T>::value ? "l" : "L");
+        };
+
+        template<>
+        struct arrow_format<std::string, void> {
+            static constexpr const char* value = "u";
+        };
+
+        template<>
+        struct arrow_format<std::vector<char>, void> {
+            static constexpr const char* value = "z";
+        };
+
+        /**
+         *  Buffers of one exported Arrow column: the validity bitmap, the offsets of a variable-size column and
+         *  the values, with booleans packed into bits.
+         */
+        struct arrow_column_data {
+            std::vector<uint8_t> validity;
+            std::vector<int32_t> offsets;
+            std::vector<char> values;
+            int64_t length = 0;
+            int64_t nullCount = 0;
+            bool nullable = false;
+            bool variableSize = false;
+
+            void append_validity(bool valid) {
+                if(!this->nullable) {
+                    return;
+                }
+                if(this->length % 8 == 0) {
+                    this->validity.push_back(0);
+                }
+                if(valid) {
+                    this->validity.back() |= uint8_t(1 << (this->length % 8));
+                } else {
+                    ++this->nullCount;
+                }
+            }
+        };
+
+        template<class T, std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, bool> = true>
+        void append_arrow_value(arrow_column_data& column, sqlite3_stmt* stmt, int columnIndex) {
+            const T value = row_extractor<T>().extract(stmt, columnIndex);
+            const auto size = column.values.size();
+            column.values.resize(size + sizeof(T));
+            std::memcpy(column.values.data() + size, &value, sizeof(T));
+        }
+
+        template<class T, std::enable_if_t<std::is_same<T, bool>::value, bool> = true>
+        void append_arrow_value(arrow_column_data& column, sqlite3_stmt* stmt, int columnIndex) {
+            if(column.length % 8 == 0) {
+                column.values.push_back(0);
+            }
+            if(sqlite3_column_int(stmt, columnIndex)) {
+                column.values.back() |= char(1 << (column.length % 8));
+            }
+        }
+
+        template<class T,
+                 std::enable_if_t<std::is_same<T, std::string>::value || std::is_same<T, std::vector<char>>::value,
+                                  bool> = true>
+        void append_arrow_value(arrow_column_data& column, sqlite3_stmt* stmt, int columnIndex) {
+            if(column.offsets.empty()) {
+                column.offsets.push_back(0);
+            }
+            const void* bytes = std::is_same<T, std::string>::value
+                                    ? static_cast<const void*>(sqlite3_column_text(stmt, columnIndex))
+                                    : sqlite3_column_blob(stmt, columnIndex);
+            const auto size = size_t(sqlite3_column_bytes(stmt, columnIndex));
+            const auto offset = column.values.size();
+            if(size) {
+                column.values.resize(offset + size);
+                std::memcpy(column.values.data() + offset, bytes, size);
+            }
+            column.offsets.push_back(int32_t(offset + size));
+        }
+
+        /**
+         *  Appends the column `columnIndex` of the current row of `stmt` to `column`, a null being appended as a
+         *  zero value with its validity bit cleared.
+         */
+        template<class T>
+        void append_arrow_column(arrow_column_data& column, sqlite3_stmt* stmt, int columnIndex) {
+            const bool valid = !column.nullable || sqlite3_column_type(stmt, columnIndex) != SQLITE_NULL;
+            column.append_validity(valid);
+            append_arrow_value<T>(column, stmt, columnIndex);
+            ++column.length;
+        }
+
+        /**
+         *  Owner of the buffers, children and names referenced by an exported `ArrowSchema` or `ArrowArray`.
+         */
+        struct arrow_export_data {
+            std::vector<arrow_column_data> columns;
+            std::vector<const void*> buffers;
+            std::vector<ArrowArray> childArrays;
+            std::vector<ArrowArray*> childArrayPointers;
+            std::vector<ArrowSchema> childSchemas;
+            std::vector<ArrowSchema*> childSchemaPointers;
+            std::vector<std::string> names;
+        };
+
+        inline void release_arrow_array(ArrowArray* array) {
+            delete static_cast<arrow_export_data*>(array->private_data);
+            array->release = nullptr;
+        }
+
+        inline void release_arrow_child_array(ArrowArray* array) {
+            array->release = nullptr;
+        }
+
+        inline void release_arrow_schema(ArrowSchema* schema) {
+            delete static_cast<arrow_export_data*>(schema->private_data);
+            schema->release = nullptr;
+        }
+
+        inline void release_arrow_child_schema(ArrowSchema* schema) {
+            schema->release = nullptr;
+        }
+
+        /**
+         *  Moves `columns` into a struct array of `length` rows, the columns being its children.
+         */
+        inline void export_arrow_batch(std::vector<arrow_column_data> columns, int64_t length, ArrowArray* out) {
+            auto data = std::make_unique<arrow_export_data>();
+            data->columns = std::move(columns);
+            const auto count = data->columns.size();
+            data->buffers.reserve(1 + 3 * count);
+            data->buffers.push_back(nullptr);
+            data->childArrays.resize(count);
+            for(size_t i = 0; i < count; ++i) {
+                auto& column = data->columns[i];
+                auto& child = data->childArrays[i];
+                child = ArrowArray{};
+                child.length = column.length;
+                child.null_count = column.nullCount;
+                child.buffers = data->buffers.data() + data->buffers.size();
+                data->buffers.push_back(column.nullCount ? column.validity.data() : nullptr);
+                if(column.variableSize) {
+                    if(column.offsets.empty()) {
+                        column.offsets.push_back(0);
+                    }
+                    data->buffers.push_back(column.offsets.data());
+                }
+                data->buffers.push_back(column.values.data());
+                child.n_buffers = int64_t(data->buffers.size() - size_t(child.buffers - data->buffers.data()));
+                child.release = release_arrow_child_array;
+                data->childArrayPointers.push_back(&child);
+            }
+            *out = ArrowArray{};
+            out->length = length;
+            out->n_buffers = 1;
+            out->buffers = data->buffers.data();
+            out->n_children = int64_t(count);
+            out->children = data->childArrayPointers.data();
+            out->release = release_arrow_array;
+            out->private_data = data.release();
+        }
+
+        /**
+         *  Makes the struct schema of a batch with children of `formats`, `names` and nullability `nullables`.
+         */
+        inline void export_arrow_schema(const std::vector<const char*>& formats,
+                                        std::vector<std::string> names,
+                                        const std::vector<bool>& nullables,
+                                        ArrowSchema* out) {
+            auto data = std::make_unique<arrow_export_data>();
+            data->names = std::move(names);
+            data->childSchemas.resize(formats.size());
+            for(size_t i = 0; i < formats.size(); ++i) {
+                auto& child = data->childSchemas[i];
+                child = ArrowSchema{};
+                child.format = formats[i];
+                child.name = data->names[i].c_str();
+                child.flags = nullables[i] ? ARROW_FLAG_NULLABLE : 0;
+                child.release = release_arrow_child_schema;
+                data->childSchemaPointers.push_back(&child);
+            }
+            *out = ArrowSchema{};
+            out->format = "+s";
+            out->name = "";
+            out->n_children = int64_t(formats.size());
+            out->children = data->childSchemaPointers.data();
+            out->release = release_arrow_schema;
+            out->private_data = data.release();
+        }
+
+        /**
+         *  Row type of a select exported to Arrow: the tuple of the columns, or a tuple of a single column.
+         */
+        template<class T>
+        struct arrow_row {
+            using type = std::tuple<T>;
+        };
+
+        template<class... Args>
+        struct arrow_row<std::tuple<Args...>> {
+            using type = std::tuple<Args...>;
+        };
+
+        /**
+         *  State of an exported `ArrowArrayStream`, which steps a prepared and bound select batch by batch.
+         */
+        struct arrow_stream_base {
+            std::string lastError;
+
+            virtual ~arrow_stream_base() = default;
+            virtual void get_schema(ArrowSchema* out) = 0;
+            virtual void get_next(ArrowArray* out) = 0;
+        };
+
+        template<class Row, class Statement>
+        struct arrow_stream;
+
+        template<class... R, class Statement>
+        struct arrow_stream<std::tuple<R...>, Statement> : arrow_stream_base {
+            Statement statement;
+            size_t batchSize;
+            bool done = false;
+
+            arrow_stream(Statement statement_, size_t batchSize_) :
+                statement(std::move(statement_)), batchSize(batchSize_ ? batchSize_ : 1) {}
+
+            void get_schema(ArrowSchema* out) override {
+                std::vector<std::string> names;
+                for(int i = 0; i < int(sizeof...(R)); ++i) {
+                    const char* name = sqlite3_column_name(this->statement.stmt, i);
+                    names.emplace_back(name ? name : "");
+                }
+                export_arrow_schema({arrow_format<typename columnar_value<R>::type>::value...},
+                                    std::move(names),
+                                    {columnar_value<R>::nullable...},
+                                    out);
+            }
+
+            void get_next(ArrowArray* out) override {
+                std::vector<arrow_column_data> columns(sizeof...(R));
+                const bool nullables[] = {columnar_value<R>::nullable...};
+                const char* formats[] = {arrow_format<typename columnar_value<R>::type>::value...};
+                for(size_t i = 0; i < columns.size(); ++i) {
+                    columns[i].nullable = nullables[i];
+                    columns[i].variableSize = formats[i][0] == 'u' || formats[i][0] == 'z';
+                }
+                int64_t length = 0;
+                while(!this->done && size_t(length) < this->batchSize) {
+                    auto rc = step_stmt(this->statement.stmt);
+                    if(rc == SQLITE_DONE) {
+                        this->done = true;
+                    } else if(rc == SQLITE_ROW) {
+                        this->append_row(columns, std::index_sequence_for<R...>{});
+                        ++length;
+                    } else {
+                        throw_translated_sqlite_error(this->statement.con.get());
+                    }
+                }
+                if(length == 0) {
+                    //  end of stream
+                    *out = ArrowArray{};
+                    return;
+                }
+                export_arrow_batch(std::move(columns), length, out);
+            }
+
+          private:
+            template<size_t... Is>
+            void append_row(std::vector<arrow_column_data>& columns, std::index_sequence<Is...>) {
+                using expand = int[];
+                (void)expand{0,
+                             (append_arrow_column<typename columnar_value<R>::type>(columns[Is],
+                                                                                    this->statement.stmt,
+                                                                                    int(Is)),
+                              0)...};
+            }
+        };
+
+        template<class F>
+        int call_arrow_stream(ArrowArrayStream* stream, F f) {
+            auto state = static_cast<arrow_stream_base*>(stream->private_data);
+            try {
+                f(*state);
+                return 0;
+            } catch(const std::exception& e) {
+                state->lastError = e.what();
+                return EIO;
+            }
+        }
+
+        /**
+         *  Makes `out` an Arrow stream of the rows of the bound `statement` in batches of `batchSize` rows.
+         *  The stream keeps the statement, and so its connection, until it is released.
+         */
+        template<class Row, class Statement>
+        void make_arrow_stream(ArrowArrayStream* out, Statement statement, size_t batchSize) {
+            *out = ArrowArrayStream{};
+            out->private_data = new arrow_stream<Row, Statement>{std::move(statement), batchSize};
+            out->get_schema = [](ArrowArrayStream* stream, ArrowSchema* schema) {
+                return call_arrow_stream(stream, [schema](arrow_stream_base& state) {
+                    state.get_schema(schema);
+                });
+            };
+            out->get_next = [](ArrowArrayStream* stream, ArrowArray* array) {
+                return call_arrow_stream(stream, [array](arrow_stream_base& state) {
+                    state.get_next(array);
+                });
+            };
+            out->get_last_error = [](ArrowArrayStream* stream) {
+                return static_cast<arrow_stream_base*>(stream->private_data)->lastError.c_str();
+            };
+            out->release = [](ArrowArrayStream* stream) {
+                delete static_cast<arrow_stream_base*>(stream->private_data);
+                stream->release = nullptr;
+            };
+        }
+
+        /**
+         *  Reads an imported Arrow stream batch by batch and releases it when destroyed.
+         */
+        struct arrow_stream_reader {
+            ArrowArrayStream* stream;
+            ArrowSchema schema{};
+            ArrowArray batch{};
+
+            arrow_stream_reader(ArrowArrayStream* stream_) : stream(stream_) {
+                this->check(this->stream->get_schema(this->stream, &this->schema));
+                if(std::strcmp(this->schema.format, "+s") != 0) {
+                    throw std::system_error{orm_error_code::incompatible_arrow_format, "not a struct schema"};
+                }
+            }
+
+            arrow_stream_reader(const arrow_stream_reader&) = delete;
+
+            ~arrow_stream_reader() {
+                if(this->batch.release) {
+                    this->batch.release(&this->batch);
+                }
+                if(this->schema.release) {
+                    this->schema.release(&this->schema);
+                }
+                if(this->stream->release) {
+                    this->stream->release(this->stream);
+                }
+            }
+
+            /**
+             *  @return index of the child named `name` or -1.
+             */
+            int64_t child_index(const std::string& name) const {
+                for(int64_t i = 0; i < this->schema.n_children; ++i) {
+                    if(name == this->schema.children[i]->name) {
+                        return i;
+                    }
+                }
+                return -1;
+            }
+
+            /**
+             *  Moves to the next batch.
+             *  @return false at the end of the stream.
+             */
+            bool next() {
+                if(this->batch.release) {
+                    this->batch.release(&this->batch);
+                }
+                this->check(this->stream->get_next(this->stream, &this->batch));
+                return this->batch.release != nullptr;
+            }
+
+          private:
+            void check(int rc) {
+                if(rc != 0) {
+                    const char* message = this->stream->get_last_error ? this->stream->get_last_error(this->stream)
+                                                                       : nullptr;
+                    throw std::system_error{rc, std::generic_category(), message ? message : "Arrow stream error"};
+                }
+            }
+        };
+
+        /**
+         *  One value of an imported Arrow column.
+         */
+        struct arrow_value_view {
+            const char* format;
+            const ArrowArray* array;
+            int64_t row;
+
+            bool is_null() const {
+                const auto index = this->array->offset + this->row;
+                auto validity = static_cast<const uint8_t*>(this->array->buffers[0]);
+                return this->array->null_count != 0 && validity && !(validity[index / 8] & (1 << (index % 8)));
+            }
+
+            template<class T>
+            T fixed(size_t bufferIndex = 1) const {
+                return static_cast<const T*>(this->array->buffers[bufferIndex])[this->array->offset + this->row];
+            }
+
+            template<class T>
+            T number() const {
+                switch(this->format[0]) {
+                    case 'b': {
+                        const auto index = this->array->offset + this->row;
+                        auto bits = static_cast<const uint8_t*>(this->array->buffers[1]);
+                        return T((bits[index / 8] >> (index % 8)) & 1);
+                    }
+                    case 'c':
+                        return T(this->fixed<int8_t>());
+                    case 'C':
+                        return T(this->fixed<uint8_t>());
+                    case 's':
+                        return T(this->fixed<int16_t>());
+                    case 'S':
+                        return T(this->fixed<uint16_t>());
+                    case 'i':
+                        return T(this->fixed<int32_t>());
+                    case 'I':
+                        return T(this->fixed<uint32_t>());
+                    case 'l':
+                        return T(this->fixed<int64_t>());
+                    case 'L':
+                        return T(this->fixed<uint64_t>());
+                    case 'f':
+                        return T(this->fixed<float>());
+                    case 'g':
+                        return T(this->fixed<double>());
+                    default:
+                        throw std::system_error{orm_error_code::incompatible_arrow_format, this->format};
+                }
+            }
+
+            template<class R>
+            R bytes() const {
+                const auto index = this->array->offset + this->row;
+                auto data = static_cast<const char*>(this->array->buffers[2]);
+                switch(this->format[0]) {
+                    case 'u':
+                    case 'z': {
+                        auto offsets = static_cast<const int32_t*>(this->array->buffers[1]);
+                        return R(data + offsets[index], data + offsets[index + 1]);
+                    }
+                    case 'U':
+                    case 'Z': {
+                        auto offsets = static_cast<const int64_t*>(this->array->buffers[1]);
+                        return R(data + offsets[index], data + offsets[index + 1]);
+                    }
+                    default:
+                        throw std::system_error{orm_error_code::incompatible_arrow_format, this->format};
+                }
+            }
+        };
+
+        template<class T, std::enable_if_t<std::is_arithmetic<T>::value, bool> = true>
+        void read_arrow_value(const arrow_value_view& value, T& field) {
+            field = value.number<T>();
+        }
+
+        inline void read_arrow_value(const arrow_value_view& value, std::string& field) {
+            field = value.bytes<std::string>();
+        }
+
+        inline void read_arrow_value(const arrow_value_view& value, std::vector<char>& field) {
+            field = value.bytes<std::vector<char>>();
+        }
+
+        template<class T>
+        void read_arrow_value(const arrow_value_view& value, std::unique_ptr<T>& field) {
+            if(value.is_null()) {
+                field.reset();
+            } else {
+                field = std::make_unique<T>();
+                read_arrow_value(value, *field);
+            }
+        }
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        template<class T>
+        void read_arrow_value(const arrow_value_view& value, std::optional<T>& field) {
+            if(value.is_null()) {
+                field.reset();
+            } else {
+                read_arrow_value(value, field.emplace());
+            }
+        }
+#endif
+
+        /**
+         *  Fields of other types can't be imported.
+         */
+        template<class T, std::enable_if_t<!std::is_arithmetic<T>::value, bool> = true>
+        void read_arrow_value(const arrow_value_view& value, T&) {
+            throw std::system_error{orm_error_code::incompatible_arrow_format, value.format};
+        }
+
+        /**
+         *  Reads `value` into the field of `object` mapped by `column`, through its setter if it has one.
+         */
+        template<class O, class G, class S>
+        void read_arrow_field(O& object, const column_field<G, S>& column, const arrow_value_view& value) {
+            static_if<std::is_member_object_pointer<G>::value>(
+                [&object, &value](const auto& column) {
+                    read_arrow_value(value, object.*column.member_pointer);
+                },
+                [&object, &value](const auto& column) {
+                    static_if<is_read_only_field_v<G, S>>(
+                        [&object, &value](const auto& column) {
+                            read_arrow_value(value, read_only_field(object, column.member_pointer));
+                        },
+                        [&object, &value](const auto& column) {
+                            member_field_type_t<G> field{};
+                            read_arrow_value(value, field);
+                            (object.*column.setter)(std::move(field));
+                        })(column);
+                })(column);
+        }
+    }
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <utility>  //  std::move
+
+#include "../functional/cxx_type_traits_polyfill.h"
+
+namespace sqlite_orm {
+    namespace internal {
+
+        /**
+         *  Statement `S` followed by a RETURNING clause of the result columns `T`.
+         *  S is `insert_t`, `insert_range_t`, `replace_t`, `replace_range_t`, `update_all_t` or `remove_all_t`.
+         */
+        template<class S, class T>
+        struct returning_t {
+            using statement_type = S;
+            using return_type = T;
+
+            statement_type statement;
+            return_type columns;
+
+            returning_t(statement_type statement_, return_type columns_) :
+                statement(std::move(statement_)), columns(std::move(columns_)) {}
+        };
+
+        template<class T>
+        using is_returning = polyfill::is_specialization_of<T, returning_t>;
+    }
+
+    /**
+     *  INSERT, REPLACE, UPDATE or DELETE statement with a RETURNING clause: its step returns `columns` for every
+     *  row it writes, e.g. the keys, defaults and generated columns SQLite assigned, so they don't need a second
+     *  query. `columns` is a single column, `columns(...)` or `object<T>()`, as the result columns of `select()`.
+     *  Example:
+     *  auto ids = storage.returning(insert_range(users.begin(), users.end()), &User::id);
+     *  auto renamed = storage.returning(update_all(set(c(&User::name) = "x"), where(c(&User::id) < 10)),
+     *                                   columns(&User::id, &User::updatedAt));
+     *  RETURNING needs SQLite 3.35.0.
+     */
+    template<class S, class T>
+    internal::returning_t<S, T> returning(S statement, T columns) {
+        return {std::move(statement), std::move(columns)};
+    }
+}
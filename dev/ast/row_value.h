@@ -0,0 +1,70 @@
+#pragma once
+
+#include <tuple>  //  std::tuple, std::make_tuple
+#include <utility>  //  std::move
+
+#include "../conditions.h"
+
+namespace sqlite_orm {
+    namespace internal {
+
+        /**
+         *  Row value `(a, b, ...)`, compared with another row value or a `std::tuple` of values element by
+         *  element in order, the way composite keys sort.
+         */
+        template<class... Args>
+        struct row_value_t {
+            using args_type = std::tuple<Args...>;
+
+            args_type args;
+
+            row_value_t(args_type args_) : args(std::move(args_)) {}
+        };
+    }
+
+    /**
+     *  Row value of expressions, usually the columns of a composite key. Comparing it with a `std::tuple`
+     *  gives one comparison SQLite can answer with a seek on an index over those columns, unlike the
+     *  equivalent `a > ? OR (a = ? AND b > ?)`:
+     *  storage.get_all<Entry>(where(tuple_value(&Entry::day, &Entry::id) > std::make_tuple(day, id)),
+     *                         multi_order_by(order_by(&Entry::day), order_by(&Entry::id)), limit(100));
+     *  `in(tuple_value(...), std::vector<std::tuple<...>>)` looks up a batch of composite keys with
+     *  `(a, b) IN (VALUES (?, ?), ...)`. Row values need SQLite 3.15.0.
+     */
+    template<class... Args>
+    internal::row_value_t<Args...> tuple_value(Args... args) {
+        return {std::make_tuple(std::move(args)...)};
+    }
+
+    template<class... Args, class R>
+    internal::is_equal_t<internal::row_value_t<Args...>, R> operator==(internal::row_value_t<Args...> l, R r) {
+        return {std::move(l), std::move(r)};
+    }
+
+    template<class... Args, class R>
+    internal::is_not_equal_t<internal::row_value_t<Args...>, R> operator!=(internal::row_value_t<Args...> l, R r) {
+        return {std::move(l), std::move(r)};
+    }
+
+    template<class... Args, class R>
+    internal::lesser_than_t<internal::row_value_t<Args...>, R> operator<(internal::row_value_t<Args...> l, R r) {
+        return {std::move(l), std::move(r)};
+    }
+
+    template<class... Args, class R>
+    internal::lesser_or_equal_t<internal::row_value_t<Args...>, R> operator<=(internal::row_value_t<Args...> l,
+                                                                             R r) {
+        return {std::move(l), std::move(r)};
+    }
+
+    template<class... Args, class R>
+    internal::greater_than_t<internal::row_value_t<Args...>, R> operator>(internal::row_value_t<Args...> l, R r) {
+        return {std::move(l), std::move(r)};
+    }
+
+    template<class... Args, class R>
+    internal::greater_or_equal_t<internal::row_value_t<Args...>, R> operator>=(internal::row_value_t<Args...> l,
+                                                                              R r) {
+        return {std::move(l), std::move(r)};
+    }
+}
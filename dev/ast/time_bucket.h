@@ -0,0 +1,72 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>  //  std::string, std::to_string
+#include <type_traits>  //  std::is_arithmetic, std::is_integral, std::is_same
+
+namespace sqlite_orm {
+    namespace internal {
+
+        /**
+         *  How a time column is stored: seconds since the epoch as integer or real, or text as
+         *  'YYYY-MM-DD HH:MM:SS'.
+         */
+        enum class time_column_kind { integer, real, text };
+
+        /**
+         *  time_bucket(X, seconds), see `time_bucket()`.
+         */
+        template<class O, class F>
+        struct time_bucket_t {
+            using object_type = O;
+            using field_type = F;
+            using member_pointer_type = F O::*;
+
+            static constexpr time_column_kind kind = std::is_same<F, std::string>::value ? time_column_kind::text
+                                                     : std::is_integral<F>::value        ? time_column_kind::integer
+                                                                                         : time_column_kind::real;
+
+            member_pointer_type field;
+            sqlite3_int64 seconds;
+        };
+
+        /**
+         *  SQL of the start of the bucket of `seconds` seconds the time in `column` falls into.
+         */
+        inline std::string time_bucket_sql(const std::string& column, sqlite3_int64 seconds, time_column_kind kind) {
+            const auto width = std::to_string(seconds);
+            switch(kind) {
+                case time_column_kind::integer:
+                    return "(" + column + " / " + width + " * " + width + ")";
+                case time_column_kind::real:
+                    return "(CAST(" + column + " AS INTEGER) / " + width + " * " + width + ")";
+                case time_column_kind::text:
+                    break;
+            }
+            return "strftime('%Y-%m-%d %H:%M:%S', CAST(strftime('%s', " + column + ") AS INTEGER) / " + width +
+                   " * " + width + ", 'unixepoch')";
+        }
+    }
+
+    /**
+     *  The start of the bucket of `seconds` seconds the time of `field` falls into, to group rows by time in
+     *  `select()` and `group_by()`. Buckets start at multiples of `seconds` since 1970-01-01 00:00:00 UTC.
+     *  A numeric field holds seconds since the epoch and the bucket is a number of seconds too, computed by
+     *  integer division, so times before the epoch are rounded towards it. A `std::string` field holds text
+     *  understood by `strftime()`, e.g. 'YYYY-MM-DD HH:MM:SS', and the bucket is text of this format.
+     *  Example: storage.select(columns(time_bucket(&Point::ts, 300), avg(&Point::value)),
+     *                          where(between(&Point::ts, from, to)),
+     *                          group_by(time_bucket(&Point::ts, 300)));
+     *  A materialized view grouping by a time bucket keeps a rollup table up to date, so that charts of long
+     *  ranges read a row per bucket instead of every point:
+     *  make_materialized_view<PointRollup>("points_5m",
+     *                                      select(columns(time_bucket(&Point::ts, 300), count(), total(&Point::value)),
+     *                                             group_by(time_bucket(&Point::ts, 300))))
+     */
+    template<class O, class F>
+    internal::time_bucket_t<O, F> time_bucket(F O::*field, sqlite3_int64 seconds) {
+        static_assert(std::is_arithmetic<F>::value || std::is_same<F, std::string>::value,
+                      "time_bucket() reads a numeric or std::string field");
+        return {field, seconds};
+    }
+}
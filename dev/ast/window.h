@@ -0,0 +1,204 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>  //  std::string
+#include <tuple>  //  std::tuple
+#include <type_traits>  //  std::enable_if_t, std::false_type, std::true_type
+#include <utility>  //  std::move
+
+#include "../functional/cxx_type_traits_polyfill.h"
+#include "../operators.h"
+#include "../conditions.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        template<class... Args>
+        struct partition_by_t {
+            using args_type = std::tuple<Args...>;
+
+            args_type args;
+        };
+
+        /**
+         *  One end of a window frame: UNBOUNDED PRECEDING, N PRECEDING, CURRENT ROW, N FOLLOWING or
+         *  UNBOUNDED FOLLOWING.
+         */
+        struct frame_bound_t {
+            enum class kind {
+                unbounded_preceding,
+                preceding,
+                current_row,
+                following,
+                unbounded_following,
+            };
+
+            kind type;
+            sqlite3_int64 offset;
+        };
+
+        /**
+         *  ROWS, RANGE or GROUPS BETWEEN start AND end.
+         */
+        struct frame_spec_t {
+            const char* units;
+            frame_bound_t start;
+            frame_bound_t end;
+        };
+
+        template<class... Args>
+        struct named_window_t {
+            using definition_type = std::tuple<Args...>;
+
+            std::string name;
+            definition_type definition;
+        };
+
+        template<class T>
+        struct is_window_definition_element : std::false_type {};
+
+        template<class... Args>
+        struct is_window_definition_element<partition_by_t<Args...>> : std::true_type {};
+
+        template<class O>
+        struct is_window_definition_element<order_by_t<O>> : std::true_type {};
+
+        template<class... Args>
+        struct is_window_definition_element<multi_order_by_t<Args...>> : std::true_type {};
+
+        template<>
+        struct is_window_definition_element<frame_spec_t> : std::true_type {};
+
+        template<class... Args>
+        using enable_if_window_definition =
+            std::enable_if_t<polyfill::conjunction_v<is_window_definition_element<Args>...>, bool>;
+
+        template<class... Windows>
+        using enable_if_named_windows =
+            std::enable_if_t<polyfill::conjunction_v<polyfill::is_specialization_of<Windows, named_window_t>...>,
+                             bool>;
+
+        /**
+         *  `function OVER (definition)` or `function OVER name`, where `name` is a window of a WINDOW clause.
+         */
+        template<class F, class... Args>
+        struct over_t : arithmetic_t {
+            using function_type = F;
+            using definition_type = std::tuple<Args...>;
+
+            function_type function;
+            definition_type definition;
+            std::string window_name;
+
+            over_t(function_type function_, Args... definition_) :
+                function(std::move(function_)), definition{std::move(definition_)...} {}
+
+            over_t(function_type function_, std::string windowName) :
+                function(std::move(function_)), window_name(std::move(windowName)) {}
+        };
+
+        /**
+         *  WINDOW clause of a select. It belongs after GROUP BY/HAVING and before ORDER BY.
+         */
+        template<class... Windows>
+        struct window_t {
+            using windows_type = std::tuple<Windows...>;
+
+            windows_type windows;
+        };
+
+        /**
+         *  Adds `over()` to the functions that can be used as window functions.
+         */
+        template<class F>
+        struct windowable_function {
+
+            /**
+             *  Makes a window function with `definition`, which consists of `partition_by()`, `order_by()` or
+             *  `multi_order_by()` and a frame like `rows_between()`, in this order.
+             */
+            template<class... Args, enable_if_window_definition<Args...> = true>
+            over_t<F, Args...> over(Args... definition) const {
+                return {static_cast<const F&>(*this), std::move(definition)...};
+            }
+
+            /**
+             *  Makes a window function over the window `windowName` of the WINDOW clause of the select.
+             */
+            over_t<F> over(std::string windowName) const {
+                return {static_cast<const F&>(*this), std::move(windowName)};
+            }
+        };
+    }
+
+    /**
+     *  PARTITION BY of a window definition.
+     */
+    template<class... Args>
+    internal::partition_by_t<Args...> partition_by(Args... args) {
+        return {{std::move(args)...}};
+    }
+
+    inline internal::frame_bound_t unbounded_preceding() {
+        return {internal::frame_bound_t::kind::unbounded_preceding, 0};
+    }
+
+    inline internal::frame_bound_t preceding(sqlite3_int64 offset) {
+        return {internal::frame_bound_t::kind::preceding, offset};
+    }
+
+    inline internal::frame_bound_t current_row() {
+        return {internal::frame_bound_t::kind::current_row, 0};
+    }
+
+    inline internal::frame_bound_t following(sqlite3_int64 offset) {
+        return {internal::frame_bound_t::kind::following, offset};
+    }
+
+    inline internal::frame_bound_t unbounded_following() {
+        return {internal::frame_bound_t::kind::unbounded_following, 0};
+    }
+
+    /**
+     *  ROWS BETWEEN start AND end frame of a window definition.
+     *  Example: sum(&Sale::amount).over(order_by(&Sale::day), rows_between(preceding(6), current_row()))
+     */
+    inline internal::frame_spec_t rows_between(internal::frame_bound_t start, internal::frame_bound_t end) {
+        return {"ROWS", start, end};
+    }
+
+    inline internal::frame_spec_t range_between(internal::frame_bound_t start, internal::frame_bound_t end) {
+        return {"RANGE", start, end};
+    }
+
+    inline internal::frame_spec_t groups_between(internal::frame_bound_t start, internal::frame_bound_t end) {
+        return {"GROUPS", start, end};
+    }
+
+    /**
+     *  A named window of a WINDOW clause, used by `window()`.
+     */
+    template<class... Args, internal::enable_if_window_definition<Args...> = true>
+    internal::named_window_t<Args...> named_window(std::string name, Args... definition) {
+        return {std::move(name), {std::move(definition)...}};
+    }
+
+    /**
+     *  WINDOW clause with one window which the window functions of the select use by name.
+     *  Example: storage.select(columns(&Sale::day, rank().over("w"), sum(&Sale::amount).over("w")),
+     *                          window("w", partition_by(&Sale::region), order_by(&Sale::day)));
+     */
+    template<class... Args, internal::enable_if_window_definition<Args...> = true>
+    internal::window_t<internal::named_window_t<Args...>> window(std::string name, Args... definition) {
+        return {std::make_tuple(named_window(std::move(name), std::move(definition)...))};
+    }
+
+    /**
+     *  WINDOW clause with several windows made by `named_window()`.
+     */
+    template<class... Windows, internal::enable_if_named_windows<Windows...> = true>
+    internal::window_t<Windows...> window(Windows... windows) {
+        return {std::make_tuple(std::move(windows)...)};
+    }
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <string>  //  std::string
+#include <tuple>  //  std::tuple, std::make_tuple
+#include <type_traits>  //  std::enable_if_t
+#include <utility>  //  std::move, std::index_sequence, std::index_sequence_for
+
+#include "../is_base_of_template.h"
+#include "../select_constraints.h"
+#include "../table.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        enum class cte_materialization {
+            unspecified,
+            materialized,
+            not_materialized,
+        };
+
+        /**
+         *  One common table expression `name(columns) AS [NOT] MATERIALIZED (select)` of a WITH clause.
+         *  `table` names the CTE and its columns the way a table mapping does. The statements of the WITH
+         *  clause read the CTE through the member pointers of its row type.
+         */
+        template<class T, class S>
+        struct common_table_expression {
+            using table_type = T;
+            using expression_type = S;
+
+            table_type table;
+            expression_type expression;
+            cte_materialization materialization = cte_materialization::unspecified;
+
+            common_table_expression(table_type table_, expression_type expression_) :
+                table(std::move(table_)), expression(std::move(expression_)) {}
+
+            /**
+             *  AS MATERIALIZED: SQLite computes the CTE once into a temporary table instead of inlining it
+             *  into every statement that reads it. Requires SQLite 3.35.0.
+             */
+            common_table_expression materialized() const {
+                auto res = *this;
+                res.materialization = cte_materialization::materialized;
+                return res;
+            }
+
+            /**
+             *  AS NOT MATERIALIZED: SQLite may inline the CTE like a view, so that constraints of the outer
+             *  statement reach its index lookups. Requires SQLite 3.35.0.
+             */
+            common_table_expression not_materialized() const {
+                auto res = *this;
+                res.materialization = cte_materialization::not_materialized;
+                return res;
+            }
+        };
+
+        template<class T, class... Args>
+        select_t<T, Args...> make_cte_select(select_t<T, Args...> sel) {
+            sel.highest_level = true;
+            return sel;
+        }
+
+        template<class E, std::enable_if_t<is_base_of_template_v<E, compound_operator>, bool> = true>
+        select_t<E> make_cte_select(E compound) {
+            return make_cte_select(sqlite_orm::select(std::move(compound)));
+        }
+
+        template<class T>
+        struct cte_builder {
+            using table_type = T;
+
+            table_type table;
+
+            /**
+             *  Defines the CTE as `expression`, which is a `select()` or a compound select like `union_all()`.
+             */
+            template<class E>
+            auto as(E expression) const {
+                auto sel = make_cte_select(std::move(expression));
+                return common_table_expression<table_type, decltype(sel)>{this->table, std::move(sel)};
+            }
+        };
+
+        template<class CTEs, class E>
+        struct with_t {
+            using cte_type = CTEs;
+            using expression_type = E;
+
+            cte_type cte;
+            expression_type expression;
+            bool recursive = false;
+
+            with_t(cte_type cte_, expression_type expression_, bool recursive_) :
+                cte(std::move(cte_)), expression(std::move(expression_)), recursive(recursive_) {
+                this->expression.highest_level = true;
+            }
+        };
+
+        template<class T>
+        using is_with = polyfill::is_specialization_of<T, with_t>;
+
+        template<class... T, class... S, size_t... Is>
+        std::tuple<T...> get_cte_tables(const std::tuple<common_table_expression<T, S>...>& ctes,
+                                        std::index_sequence<Is...>) {
+            return std::tuple<T...>{std::get<Is>(ctes).table...};
+        }
+
+        /**
+         *  The tables of `ctes`, which the statements of a WITH clause see in addition to the mapped ones.
+         */
+        template<class... T, class... S>
+        std::tuple<T...> get_cte_tables(const std::tuple<common_table_expression<T, S>...>& ctes) {
+            return get_cte_tables(ctes, std::index_sequence_for<T...>{});
+        }
+    }
+
+    /**
+     *  Names a common table expression and its columns, its row type being the object type of the columns.
+     *  The CTE is defined with `.as(select(...))` and used by `with()`. Its row type must not be mapped
+     *  by the storage, its columns are read with its member pointers and its name is used by FROM and
+     *  JOIN clauses wherever the row type is.
+     *  @example: struct Ancestor { int id = 0; int depth = 0; };
+     *            auto ancestors = cte("ancestors", make_column("id", &Ancestor::id),
+     *                                 make_column("depth", &Ancestor::depth))
+     *                                 .as(union_all(select(columns(&Node::parentId, 1), where(c(&Node::id) == 5)),
+     *                                     select(columns(&Node::parentId, c(&Ancestor::depth) + 1),
+     *                                         join<Ancestor>(on(c(&Ancestor::id) == &Node::id)))));
+     *            storage.with_recursive(ancestors, select(&Ancestor::id, order_by(&Ancestor::depth)));
+     *            - WITH RECURSIVE "ancestors"("id", "depth") AS (SELECT ... UNION ALL SELECT ...)
+     *              SELECT "ancestors"."id" FROM "ancestors" ORDER BY "ancestors"."depth"
+     */
+    template<class... Cols>
+    auto cte(std::string name, Cols... columns) {
+        auto table = make_table(std::move(name), std::move(columns)...);
+        return internal::cte_builder<decltype(table)>{std::move(table)};
+    }
+
+    /**
+     *  WITH clause: `statement` is a `select()` that reads the common table expressions `ctes`.
+     */
+    template<class... CTEs, class T, class... Args>
+    internal::with_t<std::tuple<CTEs...>, internal::select_t<T, Args...>>
+    with(std::tuple<CTEs...> ctes, internal::select_t<T, Args...> statement) {
+        return {std::move(ctes), std::move(statement), false};
+    }
+
+    template<class C, class S, class T, class... Args>
+    internal::with_t<std::tuple<internal::common_table_expression<C, S>>, internal::select_t<T, Args...>>
+    with(internal::common_table_expression<C, S> cte, internal::select_t<T, Args...> statement) {
+        return {std::make_tuple(std::move(cte)), std::move(statement), false};
+    }
+
+    /**
+     *  WITH RECURSIVE clause: a CTE may read itself, typically from the right side of a `union_all()`.
+     */
+    template<class... CTEs, class T, class... Args>
+    internal::with_t<std::tuple<CTEs...>, internal::select_t<T, Args...>>
+    with_recursive(std::tuple<CTEs...> ctes, internal::select_t<T, Args...> statement) {
+        return {std::move(ctes), std::move(statement), true};
+    }
+
+    template<class C, class S, class T, class... Args>
+    internal::with_t<std::tuple<internal::common_table_expression<C, S>>, internal::select_t<T, Args...>>
+    with_recursive(internal::common_table_expression<C, S> cte, internal::select_t<T, Args...> statement) {
+        return {std::make_tuple(std::move(cte)), std::move(statement), true};
+    }
+}
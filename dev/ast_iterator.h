@@ -10,13 +10,20 @@
 #include "core_functions.h"
 #include "prepared_statement.h"
 #include "values.h"
+#include "indexed_column.h"
 #include "function.h"
 #include "ast/excluded.h"
 #include "ast/upsert_clause.h"
 #include "ast/where.h"
+#include "dynamic_where.h"
 #include "ast/into.h"
 #include "ast/group_by.h"
 #include "ast/exists.h"
+#include "ast/with.h"
+#include "ast/row_value.h"
+#include "ast/returning.h"
+#include "ast/time_bucket.h"
+#include "byte_vector.h"
 
 namespace sqlite_orm {
 
@@ -75,6 +82,16 @@ namespace sqlite_orm {
             }
         };
 
+        template<class C>
+        struct ast_iterator<indexed_column_t<C>, void> {
+            using node_type = indexed_column_t<C>;
+
+            template<class L>
+            void operator()(const node_type& node, L& lambda) const {
+                iterate_ast(node.column_or_expression, lambda);
+            }
+        };
+
         template<class... Args>
         struct ast_iterator<group_by_t<Args...>, void> {
             using node_type = group_by_t<Args...>;
@@ -95,6 +112,16 @@ namespace sqlite_orm {
             }
         };
 
+        template<class O, class F>
+        struct ast_iterator<time_bucket_t<O, F>, void> {
+            using node_type = time_bucket_t<O, F>;
+
+            template<class L>
+            void operator()(const node_type& expression, L& lambda) const {
+                iterate_ast(expression.field, lambda);
+            }
+        };
+
         template<class... TargetArgs, class... ActionsArgs>
         struct ast_iterator<upsert_clause<std::tuple<TargetArgs...>, std::tuple<ActionsArgs...>>, void> {
             using node_type = upsert_clause<std::tuple<TargetArgs...>, std::tuple<ActionsArgs...>>;
@@ -115,6 +142,23 @@ namespace sqlite_orm {
             }
         };
 
+        /**
+         *  The values of the conditions, in the order of the conditions.
+         */
+        template<class C>
+        struct ast_iterator<dynamic_where_t<C>, void> {
+            using node_type = dynamic_where_t<C>;
+
+            template<class L>
+            void operator()(const node_type& expression, L& lambda) const {
+                for(auto& entry: expression) {
+                    for(auto& value: entry.values) {
+                        lambda(value);
+                    }
+                }
+            }
+        };
+
         template<class T>
         struct ast_iterator<T, std::enable_if_t<is_base_of_template_v<T, binary_condition>>> {
             using node_type = T;
@@ -158,6 +202,16 @@ namespace sqlite_orm {
             }
         };
 
+        template<class... Args>
+        struct ast_iterator<row_value_t<Args...>, void> {
+            using node_type = row_value_t<Args...>;
+
+            template<class L>
+            void operator()(const node_type& row, L& lambda) const {
+                iterate_ast(row.args, lambda);
+            }
+        };
+
         template<class L, class... Args>
         struct ast_iterator<in_t<L, Args...>, void> {
             using node_type = in_t<L, Args...>;
@@ -170,7 +224,7 @@ namespace sqlite_orm {
         };
 
         template<class T>
-        struct ast_iterator<std::vector<T>, void> {
+        struct ast_iterator<std::vector<T>, std::enable_if_t<!is_blob_byte_v<T>>> {
             using node_type = std::vector<T>;
 
             template<class L>
@@ -191,6 +245,16 @@ namespace sqlite_orm {
             }
         };
 
+        template<class T>
+        struct ast_iterator<T, std::enable_if_t<is_byte_vector_v<T>>> {
+            using node_type = T;
+
+            template<class L>
+            void operator()(const node_type& vec, L& lambda) const {
+                lambda(vec);
+            }
+        };
+
         template<class T>
         struct ast_iterator<T, std::enable_if_t<is_base_of_template_v<T, compound_operator>>> {
             using node_type = T;
@@ -243,6 +307,27 @@ namespace sqlite_orm {
             }
         };
 
+        template<class T, class S>
+        struct ast_iterator<common_table_expression<T, S>, void> {
+            using node_type = common_table_expression<T, S>;
+
+            template<class L>
+            void operator()(const node_type& cte, L& lambda) const {
+                iterate_ast(cte.expression, lambda);
+            }
+        };
+
+        template<class CTEs, class E>
+        struct ast_iterator<with_t<CTEs, E>, void> {
+            using node_type = with_t<CTEs, E>;
+
+            template<class L>
+            void operator()(const node_type& statement, L& lambda) const {
+                iterate_ast(statement.cte, lambda);
+                iterate_ast(statement.expression, lambda);
+            }
+        };
+
         template<class T, class R, class... Args>
         struct ast_iterator<get_all_t<T, R, Args...>, void> {
             using node_type = get_all_t<T, R, Args...>;
@@ -296,6 +381,17 @@ namespace sqlite_orm {
             }
         };
 
+        template<class S, class T>
+        struct ast_iterator<returning_t<S, T>, void> {
+            using node_type = returning_t<S, T>;
+
+            template<class L>
+            void operator()(const node_type& node, L& lambda) const {
+                iterate_ast(node.statement, lambda);
+                iterate_ast(node.columns, lambda);
+            }
+        };
+
         template<class... Args>
         struct ast_iterator<set_t<Args...>, void> {
             using node_type = set_t<Args...>;
@@ -466,6 +562,57 @@ namespace sqlite_orm {
             }
         };
 
+        template<class R, class S, class... Args>
+        struct ast_iterator<built_in_window_function_t<R, S, Args...>, void> {
+            using node_type = built_in_window_function_t<R, S, Args...>;
+
+            template<class L>
+            void operator()(const node_type& node, L& lambda) const {
+                iterate_ast(node.args, lambda);
+            }
+        };
+
+        template<class F, class... Args>
+        struct ast_iterator<over_t<F, Args...>, void> {
+            using node_type = over_t<F, Args...>;
+
+            template<class L>
+            void operator()(const node_type& node, L& lambda) const {
+                iterate_ast(node.function, lambda);
+                iterate_ast(node.definition, lambda);
+            }
+        };
+
+        template<class... Args>
+        struct ast_iterator<partition_by_t<Args...>, void> {
+            using node_type = partition_by_t<Args...>;
+
+            template<class L>
+            void operator()(const node_type& node, L& lambda) const {
+                iterate_ast(node.args, lambda);
+            }
+        };
+
+        template<class... Args>
+        struct ast_iterator<named_window_t<Args...>, void> {
+            using node_type = named_window_t<Args...>;
+
+            template<class L>
+            void operator()(const node_type& node, L& lambda) const {
+                iterate_ast(node.definition, lambda);
+            }
+        };
+
+        template<class... Windows>
+        struct ast_iterator<window_t<Windows...>, void> {
+            using node_type = window_t<Windows...>;
+
+            template<class L>
+            void operator()(const node_type& node, L& lambda) const {
+                iterate_ast(node.windows, lambda);
+            }
+        };
+
         template<class F, class W>
         struct ast_iterator<filtered_aggregate_function<F, W>, void> {
             using node_type = filtered_aggregate_function<F, W>;
@@ -558,6 +705,23 @@ namespace sqlite_orm {
             }
         };
 
+        template<class R, class T, class K, class V>
+        struct ast_iterator<dynamic_case_t<R, T, K, V>, void> {
+            using node_type = dynamic_case_t<R, T, K, V>;
+
+            template<class L>
+            void operator()(const node_type& c, L& lambda) const {
+                if(c.args.empty()) {
+                    return;
+                }
+                iterate_ast(c.case_expression, lambda);
+                for(auto& pair: c.args) {
+                    iterate_ast(pair.first, lambda);
+                    iterate_ast(pair.second, lambda);
+                }
+            }
+        };
+
         template<class T, class E>
         struct ast_iterator<as_t<T, E>, void> {
             using node_type = as_t<T, E>;
@@ -0,0 +1,475 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <algorithm>  //  std::find
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::system_clock
+#include <condition_variable>  //  std::condition_variable
+#include <deque>  //  std::deque
+#include <functional>  //  std::function
+#include <iterator>  //  std::make_move_iterator
+#include <map>  //  std::map
+#include <mutex>  //  std::mutex, std::unique_lock, std::lock_guard
+#include <string>  //  std::string
+#include <system_error>  //  std::system_error
+#include <thread>  //  std::thread
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "error_code.h"
+#include "util.h"
+#include "bound_array.h"
+#include "change_hooks.h"
+#include "change_stream.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Settings of `storage.enable_audit_log()`.
+     */
+    struct audit_log_options {
+
+        /**
+         *  Database file the audit table is written to. Empty writes it into the database file of the storage,
+         *  which an in-memory storage doesn't have.
+         */
+        std::string path;
+
+        /**
+         *  Table of the audit records, created if it doesn't exist.
+         */
+        std::string table = "audit_log";
+
+        /**
+         *  Names of the audited tables, all tables of the main schema if empty.
+         */
+        std::vector<std::string> tables;
+
+        /**
+         *  Committed changes are written at the latest this long after their commit. It is the durability
+         *  window of the audit log: a crash loses the records of at most this long.
+         */
+        std::chrono::milliseconds flush_interval{1000};
+
+        /**
+         *  A flush starts before `flush_interval` is over once this many records are buffered.
+         */
+        size_t batch_size = 1024;
+
+        /**
+         *  Called on the flushing thread when a batch can't be written. The records stay buffered and are
+         *  written with the next batch.
+         */
+        std::function<void(const std::system_error&)> on_error;
+    };
+
+    /**
+     *  A committed change of a row, one row of the audit table.
+     */
+    struct audit_record {
+
+        /**
+         *  Time of the commit, milliseconds since the Unix epoch.
+         */
+        sqlite3_int64 time = 0;
+        std::string table;
+        change_operation operation = change_operation::insert;
+
+        /**
+         *  Rowid of the changed row, the new one for an update that changes it. Undefined for WITHOUT ROWID tables.
+         */
+        sqlite3_int64 rowid = 0;
+
+        /**
+         *  Values of the row before an update or a removal and after an insert or an update as a JSON array
+         *  in the order of the columns, BLOBs as hex strings. Only set if sqlite_orm is compiled with
+         *  SQLITE_ENABLE_PREUPDATE_HOOK, which also makes WITHOUT ROWID tables audited.
+         */
+        std::string old_values;
+        std::string new_values;
+    };
+
+    namespace internal {
+
+        inline const char* audit_operation_name(change_operation operation) {
+            switch(operation) {
+                case change_operation::insert:
+                    return "INSERT";
+                case change_operation::update:
+                    return "UPDATE";
+                default:
+                    return "DELETE";
+            }
+        }
+
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+        /**
+         *  Values of the row of the running preupdate hook of `db` as a JSON array.
+         */
+        inline std::string preupdate_values_json(sqlite3* db, bool old) {
+            static constexpr const char hexDigits[] = "0123456789abcdef";
+            std::string json = "[";
+            const int count = sqlite3_preupdate_count(db);
+            for(int index = 0; index < count; ++index) {
+                if(index > 0) {
+                    json += ',';
+                }
+                sqlite3_value* value = nullptr;
+                if(old) {
+                    sqlite3_preupdate_old(db, index, &value);
+                } else {
+                    sqlite3_preupdate_new(db, index, &value);
+                }
+                switch(value ? sqlite3_value_type(value) : SQLITE_NULL) {
+                    case SQLITE_INTEGER:
+                        append_json_value(json, sqlite3_value_int64(value));
+                        break;
+                    case SQLITE_FLOAT:
+                        append_json_value(json, sqlite3_value_double(value));
+                        break;
+                    case SQLITE_TEXT:
+                        append_json_value(json,
+                                          std::string(reinterpret_cast<const char*>(sqlite3_value_text(value)),
+                                                      size_t(sqlite3_value_bytes(value))));
+                        break;
+                    case SQLITE_BLOB: {
+                        auto bytes = static_cast<const unsigned char*>(sqlite3_value_blob(value));
+                        const int size = sqlite3_value_bytes(value);
+                        json += '"';
+                        for(int i = 0; i < size; ++i) {
+                            json += hexDigits[bytes[i] >> 4];
+                            json += hexDigits[bytes[i] & 0xf];
+                        }
+                        json += '"';
+                    } break;
+                    default:
+                        json += "null";
+                }
+            }
+            json += ']';
+            return json;
+        }
+#endif
+
+        /**
+         *  Audit log of `storage.enable_audit_log()`. The hooks only append the changes of a transaction to a
+         *  buffer of its connection, the commit hook moves them to the records to write, and a thread writes
+         *  those in batches, one transaction each, through a connection of its own. So the audited transaction
+         *  doesn't write the audit table and doesn't wait for it.
+         */
+        struct audit_log : change_listener {
+
+            audit_log() = default;
+            audit_log(const audit_log&) = delete;
+            audit_log& operator=(const audit_log&) = delete;
+
+            ~audit_log() {
+                this->disable();
+            }
+
+            /**
+             *  Opens `options.path`, creates the audit table and starts the flushing thread. Records buffered
+             *  by a previous `enable()` are written with the new options.
+             */
+            void enable(audit_log_options options) {
+                this->disable();
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->options = std::move(options);
+                }
+                {
+                    std::lock_guard<std::mutex> writeLock{this->writeMutex};
+                    this->open();
+                }
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->enabled = true;
+                    this->stopping = false;
+                }
+                this->thread = std::thread{[this] {
+                    this->run();
+                }};
+            }
+
+            /**
+             *  Stops auditing, writes the buffered records and closes the audit connection. Changes of
+             *  transactions that didn't commit yet are not recorded.
+             */
+            void disable() {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    if(!this->enabled) {
+                        return;
+                    }
+                    this->enabled = false;
+                    this->stopping = true;
+                    this->pending.clear();
+                }
+                this->flushNeeded.notify_one();
+                this->thread.join();
+                try {
+                    this->flush();
+                } catch(const std::system_error& error) {
+                    this->report(error);
+                }
+                std::lock_guard<std::mutex> lock{this->writeMutex};
+                this->close();
+            }
+
+            /**
+             *  Writes the buffered records now.
+             *  @return number of records written.
+             */
+            size_t flush() {
+                std::lock_guard<std::mutex> writeLock{this->writeMutex};
+                std::vector<audit_record> batch;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    batch.assign(std::make_move_iterator(this->committed.begin()),
+                                 std::make_move_iterator(this->committed.end()));
+                    this->committed.clear();
+                }
+                if(batch.empty()) {
+                    return 0;
+                }
+                try {
+                    this->write(batch);
+                } catch(...) {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->committed.insert(this->committed.begin(),
+                                           std::make_move_iterator(batch.begin()),
+                                           std::make_move_iterator(batch.end()));
+                    throw;
+                }
+                return batch.size();
+            }
+
+            /**
+             *  Number of committed records not written yet.
+             */
+            size_t buffered() const {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->committed.size();
+            }
+
+            bool listening() const override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->enabled;
+            }
+
+            void changed(sqlite3* db, int operation, const char* table, sqlite3_int64 rowid) override {
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+                //  recorded by the preupdate hook together with the values
+                (void)db;
+                (void)operation;
+                (void)table;
+                (void)rowid;
+#else
+                this->record(db, operation, table, rowid, false);
+#endif
+            }
+
+            void preupdate(sqlite3* db,
+                           int operation,
+                           const char* table,
+                           sqlite3_int64 rowid,
+                           sqlite3_int64 newRowid) override {
+                this->record(db, operation, table, operation == SQLITE_DELETE ? rowid : newRowid, true);
+            }
+
+            void commit(sqlite3* db) override {
+                const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count();
+                bool full = false;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    auto it = this->pending.find(db);
+                    if(it == this->pending.end()) {
+                        return;
+                    }
+                    for(auto& record: it->second) {
+                        record.time = now;
+                        this->committed.push_back(std::move(record));
+                    }
+                    this->pending.erase(it);
+                    full = this->committed.size() >= this->options.batch_size;
+                }
+                if(full) {
+                    this->flushNeeded.notify_one();
+                }
+            }
+
+            void rollback(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->pending.erase(db);
+            }
+
+            void closed(sqlite3* db) override {
+                this->rollback(db);
+            }
+
+          protected:
+            void record(sqlite3* db, int operation, const char* table, sqlite3_int64 rowid, bool preupdate) {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    if(!this->enabled || (!this->options.tables.empty() &&
+                                          std::find(this->options.tables.begin(), this->options.tables.end(),
+                                                    table) == this->options.tables.end())) {
+                        return;
+                    }
+                }
+                audit_record record;
+                record.table = table;
+                record.operation = static_cast<change_operation>(operation);
+                record.rowid = rowid;
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+                if(preupdate) {
+                    if(operation != SQLITE_INSERT) {
+                        record.old_values = preupdate_values_json(db, true);
+                    }
+                    if(operation != SQLITE_DELETE) {
+                        record.new_values = preupdate_values_json(db, false);
+                    }
+                }
+#else
+                (void)preupdate;
+#endif
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->pending[db].push_back(std::move(record));
+            }
+
+            void run() {
+                std::unique_lock<std::mutex> lock{this->mutex};
+                for(;;) {
+                    this->flushNeeded.wait_for(lock, this->options.flush_interval, [this] {
+                        return this->stopping || this->committed.size() >= this->options.batch_size;
+                    });
+                    if(this->stopping) {
+                        return;
+                    }
+                    lock.unlock();
+                    try {
+                        this->flush();
+                    } catch(const std::system_error& error) {
+                        this->report(error);
+                    }
+                    lock.lock();
+                }
+            }
+
+            void report(const std::system_error& error) {
+                std::function<void(const std::system_error&)> onError;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    onError = this->options.on_error;
+                }
+                if(onError) {
+                    onError(error);
+                }
+            }
+
+            /**
+             *  Called with `writeMutex` locked.
+             */
+            void write(const std::vector<audit_record>& batch) {
+                if(!this->db) {
+                    this->open();
+                }
+                perform_void_exec(this->db, "BEGIN IMMEDIATE");
+                try {
+                    for(auto& record: batch) {
+                        sqlite3_reset(this->insertStatement);
+                        sqlite3_bind_int64(this->insertStatement, 1, record.time);
+                        sqlite3_bind_text(this->insertStatement,
+                                          2,
+                                          record.table.c_str(),
+                                          int(record.table.size()),
+                                          SQLITE_STATIC);
+                        sqlite3_bind_text(this->insertStatement,
+                                          3,
+                                          audit_operation_name(record.operation),
+                                          -1,
+                                          SQLITE_STATIC);
+                        sqlite3_bind_int64(this->insertStatement, 4, record.rowid);
+                        bind_optional_text(5, record.old_values);
+                        bind_optional_text(6, record.new_values);
+                        if(sqlite3_step(this->insertStatement) != SQLITE_DONE) {
+                            throw_translated_sqlite_error(this->db);
+                        }
+                    }
+                    sqlite3_reset(this->insertStatement);
+                    perform_void_exec(this->db, "COMMIT");
+                } catch(...) {
+                    sqlite3_reset(this->insertStatement);
+                    sqlite3_exec(this->db, "ROLLBACK", nullptr, nullptr, nullptr);
+                    throw;
+                }
+            }
+
+            void bind_optional_text(int index, const std::string& text) {
+                if(text.empty()) {
+                    sqlite3_bind_null(this->insertStatement, index);
+                } else {
+                    sqlite3_bind_text(this->insertStatement, index, text.c_str(), int(text.size()), SQLITE_STATIC);
+                }
+            }
+
+            void open() {
+                std::string path, table;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    path = this->options.path;
+                    table = quote_identifier(this->options.table);
+                }
+                const int rc =
+                    sqlite3_open_v2(path.c_str(), &this->db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+                if(rc != SQLITE_OK) {
+                    this->close();
+                    throw_translated_sqlite_error(rc);
+                }
+                try {
+                    //  waits for the writers of the storage when the audit table is in the same database
+                    sqlite3_busy_timeout(this->db, 5000);
+                    perform_void_exec(this->db,
+                                      "CREATE TABLE IF NOT EXISTS " + table +
+                                          " (\"id\" INTEGER PRIMARY KEY, \"time\" INTEGER NOT NULL, \"table_name\" "
+                                          "TEXT NOT NULL, \"operation\" TEXT NOT NULL, \"row_id\" INTEGER, "
+                                          "\"old_values\" TEXT, \"new_values\" TEXT)");
+                    const std::string sql = "INSERT INTO " + table +
+                                            " (\"time\", \"table_name\", \"operation\", \"row_id\", \"old_values\", "
+                                            "\"new_values\") VALUES (?, ?, ?, ?, ?, ?)";
+                    auto& stmt = this->insertStatement;
+                    if(prepare_sqlite_stmt(this->db, sql.c_str(), -1, prepare_flags::persistent, &stmt) != SQLITE_OK) {
+                        throw_translated_sqlite_error(this->db);
+                    }
+                } catch(...) {
+                    this->close();
+                    throw;
+                }
+            }
+
+            void close() {
+                sqlite3_finalize(this->insertStatement);
+                this->insertStatement = nullptr;
+                sqlite3_close(this->db);
+                this->db = nullptr;
+            }
+
+            mutable std::mutex mutex;
+            std::condition_variable flushNeeded;
+            audit_log_options options;
+            bool enabled = false;
+            bool stopping = false;
+            std::map<sqlite3*, std::vector<audit_record>> pending;
+            std::deque<audit_record> committed;
+            std::thread thread;
+
+            /**
+             *  Serializes the writes of the thread and of `flush()` on the audit connection.
+             */
+            std::mutex writeMutex;
+            sqlite3* db = nullptr;
+            sqlite3_stmt* insertStatement = nullptr;
+        };
+    }
+}
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <sqlite3.h>
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::steady_clock
+#include <functional>  //  std::function
 #include <system_error>  //  std::system_error
 #include <string>  //  std::string
 #include <memory>
+#include <thread>  //  std::this_thread::sleep_for
 #include <utility>  //  std::move, std::exchange
 
 #include "error_code.h"
@@ -11,6 +14,34 @@
 
 namespace sqlite_orm {
 
+    /**
+     *  Settings of an incremental backup made by `storage.backup_to(target, options)` or `backup.run(options)`.
+     *  The source is locked only while a step copies its pages, so writers can go on between the steps.
+     *  SQLite restarts the backup by itself when another connection changes the source in the meantime.
+     */
+    struct backup_options {
+
+        /**
+         *  Pages copied by one step, -1 copies all of them at once.
+         */
+        int pages_per_step = 100;
+
+        /**
+         *  Pause after every step in which writers can take the lock.
+         */
+        std::chrono::milliseconds sleep_between{0};
+
+        /**
+         *  Called after every step with the number of pages that remain and the number of pages of the source.
+         */
+        std::function<void(int remaining, int pagecount)> on_progress;
+
+        /**
+         *  The backup stops unfinished if it takes longer, zero means no limit.
+         */
+        std::chrono::milliseconds max_duration{0};
+    };
+
     namespace internal {
 
         /**
@@ -63,6 +94,41 @@ namespace sqlite_orm {
                 return sqlite3_backup_pagecount(this->handle);
             }
 
+            /**
+             *  Copies the source in steps as `options` say until the backup is complete. A step that finds the
+             *  source or the destination locked (SQLITE_BUSY or SQLITE_LOCKED) is tried again after the pause.
+             *  @return true if the backup is complete, false if `options.max_duration` passed before. Calling `run()`
+             *  again continues the backup.
+             */
+            bool run(const backup_options& options) {
+                auto start = std::chrono::steady_clock::now();
+                while(true) {
+                    auto rc = this->step(options.pages_per_step);
+                    switch(rc) {
+                        case SQLITE_OK:
+                        case SQLITE_BUSY:
+                        case SQLITE_LOCKED:
+                        case SQLITE_DONE:
+                            break;
+                        default:
+                            throw_translated_sqlite_error(rc);
+                    }
+                    if(options.on_progress) {
+                        options.on_progress(this->remaining(), this->pagecount());
+                    }
+                    if(rc == SQLITE_DONE) {
+                        return true;
+                    }
+                    if(options.max_duration.count() &&
+                       std::chrono::steady_clock::now() - start >= options.max_duration) {
+                        return false;
+                    }
+                    if(options.sleep_between.count()) {
+                        std::this_thread::sleep_for(options.sleep_between);
+                    }
+                }
+            }
+
           protected:
             sqlite3_backup* handle = nullptr;
             std::unique_ptr<connection_holder> holder;
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>  //  std::string
+#include <utility>  //  std::exchange
+#include <vector>  //  std::vector
+#if SQLITE_ORM_HAS_INCLUDE(<span>)
+#include <span>  //  std::span
+#endif
+
+#include "functional/cxx_universal.h"
+#include "error_code.h"
+#include "connection_holder.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  An incremental BLOB I/O class. Don't construct it as is, call storage.open_blob instead.
+         *  An instance of this class represents a wrapper around sqlite3_blob pointer which lets you read and write
+         *  a BLOB value in chunks without materializing it in memory. A BLOB can't be resized this way, so
+         *  insert a row with `zeroblob(n)` first to reserve the space you are going to write.
+         */
+        struct blob_t {
+            blob_t(connection_ref con_,
+                   const std::string& schemaName,
+                   const std::string& tableName,
+                   const std::string& columnName,
+                   sqlite3_int64 rowid,
+                   bool readonly) :
+                con(con_) {
+                if(sqlite3_blob_open(this->con.get(),
+                                     schemaName.empty() ? "main" : schemaName.c_str(),
+                                     tableName.c_str(),
+                                     columnName.c_str(),
+                                     rowid,
+                                     readonly ? 0 : 1,
+                                     &this->handle) != SQLITE_OK) {
+                    throw_translated_sqlite_error(this->con.get());
+                }
+            }
+
+            blob_t(blob_t&& other) : handle(std::exchange(other.handle, nullptr)), con(other.con) {}
+
+            ~blob_t() {
+                if(this->handle) {
+                    (void)sqlite3_blob_close(this->handle);
+                }
+            }
+
+            /**
+             *  Returns sqlite3_blob_bytes result
+             */
+            int size() const {
+                return sqlite3_blob_bytes(this->handle);
+            }
+
+            /**
+             *  Reads `n` bytes starting at `offset` into `data`. Throws if the range exceeds the BLOB size.
+             */
+            void read(int offset, void* data, int n) const {
+                if(sqlite3_blob_read(this->handle, data, n, offset) != SQLITE_OK) {
+                    throw_translated_sqlite_error(this->con.get());
+                }
+            }
+
+            /**
+             *  Reads `n` bytes starting at `offset`.
+             */
+            std::vector<char> read(int offset, int n) const {
+                std::vector<char> result(static_cast<size_t>(n));
+                this->read(offset, result.data(), n);
+                return result;
+            }
+
+            /**
+             *  Writes `n` bytes from `data` starting at `offset`. Throws if the range exceeds the BLOB size
+             *  or the BLOB was opened readonly.
+             */
+            void write(int offset, const void* data, int n) {
+                if(sqlite3_blob_write(this->handle, data, n, offset) != SQLITE_OK) {
+                    throw_translated_sqlite_error(this->con.get());
+                }
+            }
+
+#if __cpp_lib_span >= 202002L
+            /**
+             *  Fills `buffer` with bytes starting at `offset`.
+             */
+            template<class T, size_t N>
+            void read(int offset, std::span<T, N> buffer) const {
+                this->read(offset, buffer.data(), int(buffer.size_bytes()));
+            }
+
+            template<class T, size_t N>
+            void write(int offset, std::span<T, N> buffer) {
+                this->write(offset, buffer.data(), int(buffer.size_bytes()));
+            }
+#endif
+
+            /**
+             *  Moves this handle to the same column of another row which is much faster than opening a new one.
+             *  Calls sqlite3_blob_reopen.
+             */
+            void reopen(sqlite3_int64 rowid) {
+                if(sqlite3_blob_reopen(this->handle, rowid) != SQLITE_OK) {
+                    throw_translated_sqlite_error(this->con.get());
+                }
+            }
+
+          protected:
+            sqlite3_blob* handle = nullptr;
+            connection_ref con;
+        };
+    }
+}
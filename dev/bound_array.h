@@ -0,0 +1,120 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cmath>  //  std::isfinite
+#include <cstdint>  //  std::int64_t
+#include <limits>  //  std::numeric_limits
+#include <locale>  //  std::locale
+#include <sstream>  //  std::ostringstream
+#include <string>  //  std::string, std::to_string
+#include <type_traits>  //  std::enable_if_t, std::is_integral, std::is_floating_point
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+
+/*
+ *  SQLite's ext/misc/carray.h declares `sqlite3_carray_bind` and the CARRAY_* types.
+ *  If it is included before sqlite_orm, `as_array()` values are bound with it.
+ */
+#ifdef CARRAY_INT64
+#define SQLITE_ORM_CARRAY_BIND_SUPPORTED
+#endif
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Values of `as_array()` bound to a single parameter of an IN operator.
+         */
+        template<class E>
+        struct bound_array_t {
+            using value_type = E;
+
+            std::vector<E> values;
+        };
+
+        template<class E, std::enable_if_t<std::is_integral<E>::value, bool> = true>
+        void append_json_value(std::string& json, E value) {
+            json += std::to_string(value);
+        }
+
+        template<class E, std::enable_if_t<std::is_floating_point<E>::value, bool> = true>
+        void append_json_value(std::string& json, E value) {
+            //  JSON has no NaN and infinity
+            if(!std::isfinite(value)) {
+                json += "null";
+                return;
+            }
+            std::ostringstream ss;
+            ss.imbue(std::locale::classic());
+            ss.precision(std::numeric_limits<E>::max_digits10);
+            ss << value;
+            json += ss.str();
+        }
+
+        inline void append_json_value(std::string& json, const std::string& value) {
+            static constexpr const char hexDigits[] = "0123456789abcdef";
+            json += '"';
+            for(unsigned char c: value) {
+                switch(c) {
+                    case '"':
+                        json += "\\\"";
+                        break;
+                    case '\\':
+                        json += "\\\\";
+                        break;
+                    default:
+                        if(c < 0x20) {
+                            json += "\\u00";
+                            json += hexDigits[c >> 4];
+                            json += hexDigits[c & 0xf];
+                        } else {
+                            json += char(c);
+                        }
+                }
+            }
+            json += '"';
+        }
+
+        /**
+         *  Returns `values` as a JSON array for `json_each()`.
+         */
+        template<class E>
+        std::string make_json_array(const std::vector<E>& values) {
+            std::string json = "[";
+            for(size_t i = 0; i < values.size(); ++i) {
+                if(i > 0) {
+                    json += ',';
+                }
+                append_json_value(json, values[i]);
+            }
+            json += ']';
+            return json;
+        }
+
+#ifdef SQLITE_ORM_CARRAY_BIND_SUPPORTED
+        template<class E, std::enable_if_t<std::is_integral<E>::value, bool> = true>
+        int bind_carray(sqlite3_stmt* stmt, int index, const std::vector<E>& values) {
+            std::vector<sqlite3_int64> array(values.begin(), values.end());
+            return sqlite3_carray_bind(stmt, index, array.data(), int(array.size()), CARRAY_INT64, SQLITE_TRANSIENT);
+        }
+
+        template<class E, std::enable_if_t<std::is_floating_point<E>::value, bool> = true>
+        int bind_carray(sqlite3_stmt* stmt, int index, const std::vector<E>& values) {
+            std::vector<double> array(values.begin(), values.end());
+            return sqlite3_carray_bind(stmt, index, array.data(), int(array.size()), CARRAY_DOUBLE, SQLITE_TRANSIENT);
+        }
+
+        inline int bind_carray(sqlite3_stmt* stmt, int index, const std::vector<std::string>& values) {
+            std::vector<const char*> array;
+            array.reserve(values.size());
+            for(auto& value: values) {
+                array.push_back(value.c_str());
+            }
+            //  SQLITE_TRANSIENT copies the strings too
+            return sqlite3_carray_bind(stmt, index, array.data(), int(array.size()), CARRAY_TEXT, SQLITE_TRANSIENT);
+        }
+#endif
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>  //  size_t
+
+namespace sqlite_orm {
+
+    /**
+     *  How `storage.bulk_load()` writes a range of objects.
+     */
+    struct bulk_load_options {
+
+        /**
+         *  Drop the non-unique indexes of the table that exist before the load and create them again from their
+         *  `make_index()` definitions afterwards, which builds every index once instead of updating it per row.
+         *  Unique indexes stay, they reject duplicates during the load.
+         */
+        bool defer_indexes = true;
+
+        /**
+         *  Turn `foreign_keys` off during the load. The loaded rows are not checked afterwards, run
+         *  `PRAGMA foreign_key_check` if they may violate a foreign key. Ignored if a transaction is already open.
+         */
+        bool disable_foreign_keys = true;
+
+        /**
+         *  Write the rows in the order of their primary key so that the table b-tree gets appended to instead of
+         *  split. The range itself isn't changed.
+         */
+        bool sort_by_primary_key = true;
+
+        /**
+         *  Rows get new rowids like by `insert_range()` instead of keeping their primary keys and being written
+         *  like by `replace_range()`. `sort_by_primary_key` is ignored then.
+         */
+        bool assign_primary_keys = false;
+
+        /**
+         *  Rows written by one transaction, 0 writes the whole range in one transaction. Ignored if a transaction
+         *  is already open.
+         */
+        size_t rows_per_transaction = 1000000;
+
+        /**
+         *  Apply `performance_profile::bulk_load()` during the load like `csv_options::bulk_load_profile`.
+         */
+        bool bulk_load_profile = true;
+    };
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>  //  std::atomic
+#include <chrono>  //  std::chrono::nanoseconds
+#include <map>  //  std::map
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <string>  //  std::string
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+namespace sqlite_orm {
+
+    /**
+     *  Waits for locks held by other connections, counted once `storage.enable_busy_statistics()` is called.
+     */
+    struct busy_wait_stats {
+
+        /**
+         *  Calls of the busy handler. SQLite calls it when it finds the database locked and again after every
+         *  failed retry.
+         */
+        size_t callbacks = 0;
+
+        /**
+         *  Lock requests that found the database locked, the first call of the busy handler of every request.
+         */
+        size_t waits = 0;
+
+        /**
+         *  Lock requests given up by the busy handler, they failed with `SQLITE_BUSY`.
+         */
+        size_t timeouts = 0;
+
+        /**
+         *  Time spent in the busy handler, i.e. sleeping before retries.
+         */
+        std::chrono::nanoseconds wait_time{0};
+
+        busy_wait_stats& operator+=(const busy_wait_stats& other) {
+            this->callbacks += other.callbacks;
+            this->waits += other.waits;
+            this->timeouts += other.timeouts;
+            this->wait_time += other.wait_time;
+            return *this;
+        }
+    };
+
+    /**
+     *  Waits by the transaction the waiting connection was in.
+     */
+    struct busy_transaction_stats {
+
+        /**
+         *  Statements run outside of a transaction.
+         */
+        busy_wait_stats autocommit;
+
+        /**
+         *  `BEGIN`, `BEGIN DEFERRED`, `read_transaction()` and transactions begun with SQL. A deferred transaction
+         *  waiting when it starts writing is a candidate for `immediate_transaction_guard()`.
+         */
+        busy_wait_stats deferred;
+        busy_wait_stats immediate;
+        busy_wait_stats exclusive;
+    };
+
+    /**
+     *  Lock contention of a storage, `storage_status::busy`.
+     */
+    struct busy_status {
+
+        /**
+         *  Waits of all connections, including the ones closed meanwhile.
+         */
+        busy_wait_stats total;
+
+        /**
+         *  Waits of every opened connection, in the order `storage_status::connections` is summed up in.
+         */
+        std::vector<busy_wait_stats> connections;
+
+        /**
+         *  Waits by the SQL text of the waiting statement, as prepared, e.g. "COMMIT" or the SQL of a `replace`.
+         */
+        std::map<std::string, busy_wait_stats> statements;
+
+        busy_transaction_stats transactions;
+    };
+
+    namespace internal {
+
+        enum class busy_transaction_kind { autocommit, deferred, immediate, exclusive };
+
+        /**
+         *  The kind of transaction begun by `sql`, a statement beginning a transaction.
+         */
+        inline busy_transaction_kind busy_transaction_kind_of(const std::string& sql) {
+            if(sql.compare(0, 15, "BEGIN IMMEDIATE") == 0) {
+                return busy_transaction_kind::immediate;
+            }
+            if(sql.compare(0, 15, "BEGIN EXCLUSIVE") == 0) {
+                return busy_transaction_kind::exclusive;
+            }
+            return busy_transaction_kind::deferred;
+        }
+
+        /**
+         *  The statement of `db` the busy handler is called for: the most recently prepared statement that is
+         *  running. A statement stepped and not reset yet, e.g. one whose rows are still being iterated, may be
+         *  taken for it if it was prepared later.
+         */
+        inline sqlite3_stmt* busy_statement(sqlite3* db) {
+            for(auto stmt = sqlite3_next_stmt(db, nullptr); stmt; stmt = sqlite3_next_stmt(db, stmt)) {
+                if(sqlite3_stmt_busy(stmt)) {
+                    return stmt;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         *  Emulates the busy handler of `sqlite3_busy_timeout()`, which the counting busy handler replaces:
+         *  sleeps with growing delays until `timeout` milliseconds passed since the first call.
+         *  @return 0 to give up.
+         */
+        inline int sleep_for_busy_timeout(int timeout, int triesCount) {
+            static const int delays[] = {1, 2, 5, 10, 15, 20, 25, 25, 25, 50, 50, 100};
+            static const int totals[] = {0, 1, 3, 8, 18, 33, 53, 78, 103, 128, 178, 228};
+            const int count = int(sizeof(delays) / sizeof(delays[0]));
+            int delay;
+            int prior;
+            if(triesCount < count) {
+                delay = delays[triesCount];
+                prior = totals[triesCount];
+            } else {
+                delay = delays[count - 1];
+                prior = totals[count - 1] + delay * (triesCount - (count - 1));
+            }
+            if(prior + delay > timeout) {
+                delay = timeout - prior;
+                if(delay <= 0) {
+                    return 0;
+                }
+            }
+            sqlite3_sleep(delay);
+            return 1;
+        }
+
+        /**
+         *  Counters of `storage.enable_busy_statistics()`. Every connection gets a busy handler whose argument
+         *  is its `busy_connection`, which counts the calls and delegates to the busy handler of the storage or,
+         *  if there is none, sleeps like `sqlite3_busy_timeout()` with the timeout of the connection.
+         *  Thread safe.
+         */
+        struct busy_recorder {
+
+            struct busy_connection {
+                void* owner = nullptr;
+                sqlite3* db = nullptr;
+
+                /**
+                 *  Milliseconds of `busy_timeout()`, guarded by the mutex of the recorder.
+                 */
+                int timeout = 0;
+
+                /**
+                 *  Kind of the last transaction begun by the storage, guarded by the mutex of the recorder.
+                 */
+                busy_transaction_kind transaction = busy_transaction_kind::deferred;
+                busy_wait_stats stats;
+            };
+
+            busy_recorder() = default;
+            busy_recorder(const busy_recorder&) = delete;
+            busy_recorder& operator=(const busy_recorder&) = delete;
+
+            bool enabled() const {
+                return this->isEnabled;
+            }
+
+            void enable() {
+                this->isEnabled = true;
+            }
+
+            void disable() {
+                this->isEnabled = false;
+            }
+
+            /**
+             *  The entry of `db`, made with `timeout` for a connection seen the first time. It is stable until
+             *  `closed(db)`.
+             */
+            busy_connection& connection(sqlite3* db, void* owner, int timeout) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto inserted = this->connections.emplace(db, busy_connection{});
+                if(inserted.second) {
+                    inserted.first->second.owner = owner;
+                    inserted.first->second.db = db;
+                    inserted.first->second.timeout = timeout;
+                }
+                return inserted.first->second;
+            }
+
+            busy_connection* find(sqlite3* db) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                return it != this->connections.end() ? &it->second : nullptr;
+            }
+
+            int timeout(const busy_connection& connection) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return connection.timeout;
+            }
+
+            void set_timeout(busy_connection& connection, int timeout) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                connection.timeout = timeout;
+            }
+
+            void began(sqlite3* db, busy_transaction_kind kind) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it != this->connections.end()) {
+                    it->second.transaction = kind;
+                }
+            }
+
+            /**
+             *  Counts a call of the busy handler of `connection` for `stmt`, which returned `retry` after
+             *  `elapsed`.
+             */
+            void record(busy_connection& connection,
+                        sqlite3_stmt* stmt,
+                        int triesCount,
+                        int retry,
+                        std::chrono::nanoseconds elapsed) {
+                busy_wait_stats wait;
+                wait.callbacks = 1;
+                wait.waits = triesCount == 0 ? 1 : 0;
+                wait.timeouts = retry ? 0 : 1;
+                wait.wait_time = elapsed;
+                const bool autocommit = sqlite3_get_autocommit(connection.db) != 0;
+                const char* sql = stmt ? sqlite3_sql(stmt) : nullptr;
+                std::string text = sql ? sql : "";
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto kind = connection.transaction;
+                //  the connection is in autocommit mode while BEGIN takes its locks and while COMMIT waits
+                if(text.compare(0, 5, "BEGIN") == 0) {
+                    kind = busy_transaction_kind_of(text);
+                } else if(autocommit && text.compare(0, 6, "COMMIT") != 0 && text.compare(0, 3, "END") != 0) {
+                    kind = busy_transaction_kind::autocommit;
+                }
+                this->total += wait;
+                connection.stats += wait;
+                this->statements[std::move(text)] += wait;
+                switch(kind) {
+                    case busy_transaction_kind::autocommit:
+                        this->transactions.autocommit += wait;
+                        break;
+                    case busy_transaction_kind::deferred:
+                        this->transactions.deferred += wait;
+                        break;
+                    case busy_transaction_kind::immediate:
+                        this->transactions.immediate += wait;
+                        break;
+                    case busy_transaction_kind::exclusive:
+                        this->transactions.exclusive += wait;
+                        break;
+                }
+            }
+
+            /**
+             *  Appends the waits of the opened connection `db` to `status.connections`.
+             */
+            void add_connection(busy_status& status, sqlite3* db, bool reset) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it == this->connections.end()) {
+                    status.connections.emplace_back();
+                    return;
+                }
+                status.connections.push_back(it->second.stats);
+                if(reset) {
+                    it->second.stats = {};
+                }
+            }
+
+            void add_totals(busy_status& status, bool reset) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                status.total = this->total;
+                status.statements = this->statements;
+                status.transactions = this->transactions;
+                if(reset) {
+                    this->total = {};
+                    this->statements.clear();
+                    this->transactions = {};
+                }
+            }
+
+            /**
+             *  Forgets `db` before it is closed, a connection opened later may get the same handle.
+             */
+            void closed(sqlite3* db) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->connections.erase(db);
+            }
+
+          protected:
+            std::atomic<bool> isEnabled{false};
+            std::mutex mutex;
+            std::map<sqlite3*, busy_connection> connections;
+            busy_wait_stats total;
+            std::map<std::string, busy_wait_stats> statements;
+            busy_transaction_stats transactions;
+        };
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <type_traits>  //  std::is_same
+#include <vector>  //  std::vector
+#include <array>  //  std::array
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
+#include "functional/cxx_byte.h"
+
+namespace sqlite_orm {
+    namespace internal {
+
+        /**
+         *  Whether `std::vector<B>` is mapped to a BLOB the way `std::vector<char>` is: B is `unsigned char`, which
+         *  `uint8_t` is an alias of, or `std::byte`. The bytes are copied as they are, without conversion.
+         */
+        template<class B>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_blob_byte_v = polyfill::disjunction_v<std::is_same<B, unsigned char>
+#ifdef SQLITE_ORM_BYTE_SUPPORTED
+                                                                                      ,
+                                                                                      std::is_same<B, std::byte>
+#endif
+                                                                                      >;
+
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_byte_vector_v = false;
+
+        template<class B>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_byte_vector_v<std::vector<B>> = is_blob_byte_v<B>;
+
+        template<class T>
+        using is_byte_vector = polyfill::bool_constant<is_byte_vector_v<T>>;
+
+        /**
+         *  A fixed size BLOB such as a 16 byte UUID.
+         */
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_byte_array_v = false;
+
+        template<class B, size_t N>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_byte_array_v<std::array<B, N>> = is_blob_byte_v<B>;
+
+        template<class T>
+        using is_byte_array = polyfill::bool_constant<is_byte_array_v<T>>;
+    }
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstring>  //  strcmp
+#include <map>  //  std::map
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <utility>  //  std::pair
+#include <vector>  //  std::vector
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Receives the row changes and transaction ends of every connection of a storage from `change_hooks`.
+         *  Only changes of the main schema are reported.
+         */
+        struct change_listener {
+            virtual ~change_listener() = default;
+
+            /**
+             *  Returns true if the hooks have to be installed for this listener.
+             */
+            virtual bool listening() const = 0;
+
+            /**
+             *  A row of `table` changed (update hook).
+             */
+            virtual void changed(sqlite3* db, int operation, const char* table, sqlite3_int64 rowid) = 0;
+
+            /**
+             *  A row of `table` is about to change (preupdate hook), only called if sqlite_orm is compiled with
+             *  SQLITE_ENABLE_PREUPDATE_HOOK. `sqlite3_preupdate_old` and `sqlite3_preupdate_new` may be called.
+             */
+            virtual void preupdate(sqlite3* /*db*/,
+                                   int /*operation*/,
+                                   const char* /*table*/,
+                                   sqlite3_int64 /*rowid*/,
+                                   sqlite3_int64 /*newRowid*/) {}
+
+            /**
+             *  The transaction of `db` is committing (commit hook).
+             */
+            virtual void commit(sqlite3* db) = 0;
+
+            virtual void rollback(sqlite3* db) = 0;
+
+            /**
+             *  The transaction of `db` whose commit hook was called has committed, see `commit_scope`. The commit
+             *  hook runs before the COMMIT, which may still fail and either roll back or leave the transaction open.
+             */
+            virtual void committed(sqlite3* /*db*/) {}
+
+            /**
+             *  `db` is closed or its hooks are removed, a transaction it had open is gone.
+             */
+            virtual void closed(sqlite3* db) = 0;
+        };
+
+        struct change_hooks;
+
+        /**
+         *  Collects the commit hooks that run on this thread while it exists. Once it is destroyed, the listeners
+         *  of every connection that has no transaction open any more, i.e. whose COMMIT succeeded, are told
+         *  with `change_listener::committed()`. Created around every step and exec, which run the commit hooks.
+         */
+        class commit_scope {
+          public:
+            commit_scope() : previous{current()} {
+                current() = this;
+            }
+
+            commit_scope(const commit_scope&) = delete;
+            commit_scope& operator=(const commit_scope&) = delete;
+
+            ~commit_scope();
+
+            static void committing(change_hooks* hooks, sqlite3* db) {
+                if(auto scope = current()) {
+                    scope->commits.emplace_back(hooks, db);
+                }
+            }
+
+          private:
+            commit_scope* previous;
+            std::vector<std::pair<change_hooks*, sqlite3*>> commits;
+
+            static commit_scope*& current() {
+                thread_local commit_scope* scope = nullptr;
+                return scope;
+            }
+        };
+
+        /**
+         *  Installs the update, preupdate, commit and rollback hooks on connections and dispatches them
+         *  to `listeners`. Every hook of SQLite holds a single callback, so storage features that watch changes
+         *  share these ones.
+         */
+        struct change_hooks {
+            std::vector<change_listener*> listeners;
+
+            change_hooks() = default;
+            change_hooks(const change_hooks&) = delete;
+            change_hooks& operator=(const change_hooks&) = delete;
+
+            bool needed() const {
+                for(auto listener: this->listeners) {
+                    if(listener->listening()) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void install(sqlite3* db) {
+                connection_context* context = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    auto& contextPointer = this->contexts[db];
+                    if(!contextPointer) {
+                        contextPointer = std::make_unique<connection_context>();
+                        contextPointer->hooks = this;
+                        contextPointer->db = db;
+                    }
+                    context = contextPointer.get();
+                }
+                sqlite3_update_hook(db, update_callback, context);
+                sqlite3_commit_hook(db, commit_callback, context);
+                sqlite3_rollback_hook(db, rollback_callback, context);
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+                sqlite3_preupdate_hook(db, preupdate_callback, this);
+#endif
+            }
+
+            void uninstall(sqlite3* db) {
+                sqlite3_update_hook(db, nullptr, nullptr);
+                sqlite3_commit_hook(db, nullptr, nullptr);
+                sqlite3_rollback_hook(db, nullptr, nullptr);
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+                sqlite3_preupdate_hook(db, nullptr, nullptr);
+#endif
+                this->closed(db);
+            }
+
+            void committed(sqlite3* db) {
+                for(auto listener: this->listeners) {
+                    listener->committed(db);
+                }
+            }
+
+            void closed(sqlite3* db) {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    if(!this->contexts.erase(db)) {
+                        return;
+                    }
+                }
+                for(auto listener: this->listeners) {
+                    listener->closed(db);
+                }
+            }
+
+          protected:
+            /**
+             *  Tells the callbacks which connection they are called for, the update, commit and rollback hooks
+             *  don't.
+             */
+            struct connection_context {
+                change_hooks* hooks = nullptr;
+                sqlite3* db = nullptr;
+            };
+
+            static void update_callback(void* contextPointer,
+                                        int operation,
+                                        const char* schema,
+                                        const char* table,
+                                        sqlite3_int64 rowid) {
+                auto& context = *static_cast<connection_context*>(contextPointer);
+                if(strcmp(schema, "main") != 0) {
+                    return;
+                }
+                for(auto listener: context.hooks->listeners) {
+                    listener->changed(context.db, operation, table, rowid);
+                }
+            }
+
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+            static void preupdate_callback(void* selfPointer,
+                                           sqlite3* db,
+                                           int operation,
+                                           const char* schema,
+                                           const char* table,
+                                           sqlite3_int64 rowid,
+                                           sqlite3_int64 newRowid) {
+                auto& self = *static_cast<change_hooks*>(selfPointer);
+                if(strcmp(schema, "main") != 0) {
+                    return;
+                }
+                for(auto listener: self.listeners) {
+                    listener->preupdate(db, operation, table, rowid, newRowid);
+                }
+            }
+#endif
+
+            static int commit_callback(void* contextPointer) {
+                auto& context = *static_cast<connection_context*>(contextPointer);
+                for(auto listener: context.hooks->listeners) {
+                    listener->commit(context.db);
+                }
+                commit_scope::committing(context.hooks, context.db);
+                return 0;
+            }
+
+            static void rollback_callback(void* contextPointer) {
+                auto& context = *static_cast<connection_context*>(contextPointer);
+                for(auto listener: context.hooks->listeners) {
+                    listener->rollback(context.db);
+                }
+            }
+
+            std::mutex mutex;
+            std::map<sqlite3*, std::unique_ptr<connection_context>> contexts;
+        };
+
+        inline commit_scope::~commit_scope() {
+            current() = this->previous;
+            for(auto& commit: this->commits) {
+                if(sqlite3_get_autocommit(commit.second)) {
+                    commit.first->committed(commit.second);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <functional>  //  std::function
+#include <iterator>  //  std::make_move_iterator
+#include <map>  //  std::map
+#include <memory>  //  std::shared_ptr, std::unique_ptr
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <string>  //  std::string
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "change_hooks.h"
+
+namespace sqlite_orm {
+
+    enum class change_operation {
+        insert = SQLITE_INSERT,
+        update = SQLITE_UPDATE,
+        remove = SQLITE_DELETE,
+    };
+
+    /**
+     *  A change of a row of a mapped table delivered by `storage.on_change<T>()`.
+     */
+    template<class T>
+    struct change_event {
+        change_operation operation = change_operation::insert;
+
+        /**
+         *  Rowid of the changed row. For an update that changes the rowid it's the new one.
+         */
+        sqlite3_int64 rowid = 0;
+
+        /**
+         *  The row before an update or a removal. Only set if sqlite_orm is compiled with
+         *  SQLITE_ENABLE_PREUPDATE_HOOK, which requires SQLite built with it.
+         */
+        std::shared_ptr<const T> old_object;
+
+        /**
+         *  The row after an insert or an update. Set under the same conditions as `old_object`.
+         */
+        std::shared_ptr<const T> new_object;
+    };
+
+    namespace internal {
+
+        struct change_subscription_base {
+            explicit change_subscription_base(std::string table_) : table(std::move(table_)) {}
+            virtual ~change_subscription_base() = default;
+
+            /**
+             *  Records a change of the current transaction of `db`. `preupdate` is true if it's called
+             *  from the preupdate hook, so that old and new values are available.
+             */
+            virtual void record(sqlite3* db, int operation, sqlite3_int64 rowid, bool preupdate) = 0;
+
+            /**
+             *  Keeps the changes of the committing transaction of `db` until its COMMIT succeeds.
+             */
+            virtual void commit(sqlite3* db) = 0;
+
+            virtual void deliver(sqlite3* db) = 0;
+
+            virtual void discard(sqlite3* db) = 0;
+
+            const std::string table;
+        };
+
+        template<class T>
+        struct change_subscription : change_subscription_base {
+            using callback_type = std::function<void(const change_event<T>&)>;
+
+            /**
+             *  Makes the object from the old (true) or new (false) values of the preupdate hook.
+             */
+            using object_maker = std::function<std::shared_ptr<const T>(sqlite3*, bool)>;
+
+            change_subscription(std::string table_, callback_type callback_, object_maker makeObject) :
+                change_subscription_base{std::move(table_)}, callback(std::move(callback_)),
+                make_object(std::move(makeObject)) {}
+
+            void record(sqlite3* db, int operation, sqlite3_int64 rowid, bool preupdate) override {
+                change_event<T> event;
+                event.operation = static_cast<change_operation>(operation);
+                event.rowid = rowid;
+                if(preupdate) {
+                    if(operation != SQLITE_INSERT) {
+                        event.old_object = this->make_object(db, true);
+                    }
+                    if(operation != SQLITE_DELETE) {
+                        event.new_object = this->make_object(db, false);
+                    }
+                }
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->connections[db].pending.push_back(std::move(event));
+            }
+
+            void commit(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it == this->connections.end()) {
+                    return;
+                }
+                //  a COMMIT that failed without rolling back left its transaction open to be committed again
+                auto& events = it->second;
+                events.committed.insert(events.committed.end(),
+                                        std::make_move_iterator(events.pending.begin()),
+                                        std::make_move_iterator(events.pending.end()));
+                events.pending.clear();
+            }
+
+            void deliver(sqlite3* db) override {
+                std::vector<change_event<T>> events;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    auto it = this->connections.find(db);
+                    if(it == this->connections.end()) {
+                        return;
+                    }
+                    events = std::move(it->second.committed);
+                    it->second.committed.clear();
+                    if(it->second.pending.empty()) {
+                        this->connections.erase(it);
+                    }
+                }
+                for(auto& event: events) {
+                    this->callback(event);
+                }
+            }
+
+            void discard(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->connections.erase(db);
+            }
+
+          protected:
+            /**
+             *  Changes of the open transaction of a connection and of its committing one.
+             */
+            struct connection_events {
+                std::vector<change_event<T>> pending;
+                std::vector<change_event<T>> committed;
+            };
+
+            const callback_type callback;
+            const object_maker make_object;
+            std::mutex mutex;
+            std::map<sqlite3*, connection_events> connections;
+        };
+
+        /**
+         *  Subscriptions of `storage.on_change<T>()`. Changes are collected per connection and transaction,
+         *  kept aside by the commit hook and delivered once the COMMIT succeeded; a rollback discards them.
+         *
+         *  Subscribing is not thread safe, the hooks are.
+         */
+        struct change_streams : change_listener {
+
+            change_streams() = default;
+            change_streams(const change_streams&) = delete;
+            change_streams& operator=(const change_streams&) = delete;
+
+            /**
+             *  Replaces the subscription of the same table. A null `subscription` only removes it.
+             */
+            void subscribe(const std::string& table, std::unique_ptr<change_subscription_base> subscription) {
+                for(auto it = this->subscriptions.begin(); it != this->subscriptions.end(); ++it) {
+                    if((*it)->table == table) {
+                        this->subscriptions.erase(it);
+                        break;
+                    }
+                }
+                if(subscription) {
+                    this->subscriptions.push_back(std::move(subscription));
+                }
+            }
+
+            bool listening() const override {
+                return !this->subscriptions.empty();
+            }
+
+            void changed(sqlite3* db, int operation, const char* table, sqlite3_int64 rowid) override {
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+                //  recorded by the preupdate hook together with the values
+                (void)db;
+                (void)operation;
+                (void)table;
+                (void)rowid;
+#else
+                for(auto& subscription: this->subscriptions) {
+                    if(subscription->table == table) {
+                        subscription->record(db, operation, rowid, false);
+                    }
+                }
+#endif
+            }
+
+            void preupdate(sqlite3* db,
+                           int operation,
+                           const char* table,
+                           sqlite3_int64 rowid,
+                           sqlite3_int64 newRowid) override {
+                for(auto& subscription: this->subscriptions) {
+                    if(subscription->table == table) {
+                        subscription->record(db, operation, operation == SQLITE_DELETE ? rowid : newRowid, true);
+                    }
+                }
+            }
+
+            void commit(sqlite3* db) override {
+                for(auto& subscription: this->subscriptions) {
+                    subscription->commit(db);
+                }
+            }
+
+            void committed(sqlite3* db) override {
+                for(auto& subscription: this->subscriptions) {
+                    subscription->deliver(db);
+                }
+            }
+
+            void rollback(sqlite3* db) override {
+                for(auto& subscription: this->subscriptions) {
+                    subscription->discard(db);
+                }
+            }
+
+            void closed(sqlite3* db) override {
+                this->rollback(db);
+            }
+
+          protected:
+            std::vector<std::unique_ptr<change_subscription_base>> subscriptions;
+        };
+    }
+}
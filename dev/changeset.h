@@ -0,0 +1,150 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <memory>  //  std::unique_ptr
+#include <string>  //  std::string
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "error_code.h"
+#include "connection_holder.h"
+
+namespace sqlite_orm {
+#if defined(SQLITE_ENABLE_SESSION) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+
+    /**
+     *  What `storage.apply_changeset()` does with a change that conflicts with the rows of the database.
+     *  https://sqlite.org/session/sqlite3changeset_apply.html
+     */
+    enum class changeset_conflict_policy {
+
+        /**
+         *  Stop, roll the changeset back and throw.
+         */
+        abort = SQLITE_CHANGESET_ABORT,
+
+        /**
+         *  Skip the conflicting change.
+         */
+        omit = SQLITE_CHANGESET_OMIT,
+
+        /**
+         *  Apply the change over the conflicting row. Changes to rows that don't exist any more and changes that
+         *  violate a constraint are skipped.
+         */
+        replace = SQLITE_CHANGESET_REPLACE,
+    };
+
+    /**
+     *  Records the changes made to tables on one connection with the session extension, made by
+     *  `storage.record_changes()`. The changes are read as a changeset, old and new values of every changed
+     *  row, or as a smaller patchset, which has only the primary keys of deleted rows and the new values of
+     *  updated columns. Both are binary and applied with `storage.apply_changeset()`.
+     *  Only tables with a primary key are recorded. It keeps the connection open, which is why it belongs to
+     *  one thread with a connection pool. https://sqlite.org/sessionintro.html
+     */
+    class change_recorder {
+      public:
+        /**
+         *  Records `tables` of `schemaName`, all tables if `tables` is empty.
+         */
+        change_recorder(internal::connection_ref connection_,
+                        const std::vector<std::string>& tables,
+                        const std::string& schemaName = "main") :
+            connection(std::move(connection_)),
+            session(nullptr, sqlite3session_delete) {
+            sqlite3_session* created = nullptr;
+            auto rc = sqlite3session_create(this->connection.get(), schemaName.c_str(), &created);
+            if(rc != SQLITE_OK) {
+                throw_translated_sqlite_error(rc);
+            }
+            this->session.reset(created);
+            if(tables.empty()) {
+                this->attach(nullptr);
+            }
+            for(auto& table: tables) {
+                this->attach(table.c_str());
+            }
+        }
+
+        /**
+         *  The changes recorded so far, each row once with its net change.
+         */
+        std::vector<char> changeset() const {
+            return this->read(sqlite3session_changeset);
+        }
+
+        std::vector<char> patchset() const {
+            return this->read(sqlite3session_patchset);
+        }
+
+        /**
+         *  Whether no change has been recorded yet.
+         */
+        bool empty() const {
+            return sqlite3session_isempty(this->session.get()) != 0;
+        }
+
+        /**
+         *  Pauses recording while `enabled` is false.
+         */
+        void enable(bool enabled) {
+            sqlite3session_enable(this->session.get(), enabled ? 1 : 0);
+        }
+
+      protected:
+        void attach(const char* table) {
+            auto rc = sqlite3session_attach(this->session.get(), table);
+            if(rc != SQLITE_OK) {
+                throw_translated_sqlite_error(rc);
+            }
+        }
+
+        std::vector<char> read(int (*produce)(sqlite3_session*, int*, void**)) const {
+            int size = 0;
+            void* data = nullptr;
+            auto rc = produce(this->session.get(), &size, &data);
+            std::unique_ptr<void, void (*)(void*)> guard{data, sqlite3_free};
+            if(rc != SQLITE_OK) {
+                throw_translated_sqlite_error(rc);
+            }
+            auto bytes = static_cast<const char*>(data);
+            return {bytes, bytes + size};
+        }
+
+        //  the session has to be deleted before the connection is closed
+        internal::connection_ref connection;
+        std::unique_ptr<sqlite3_session, void (*)(sqlite3_session*)> session;
+    };
+
+    namespace internal {
+
+        inline int changeset_conflict_callback(void* policy, int conflict, sqlite3_changeset_iter*) {
+            auto result = *static_cast<const int*>(policy);
+            //  SQLite accepts REPLACE only for rows that exist with different values or a conflicting key
+            if(result == SQLITE_CHANGESET_REPLACE && conflict != SQLITE_CHANGESET_DATA &&
+               conflict != SQLITE_CHANGESET_CONFLICT) {
+                return SQLITE_CHANGESET_OMIT;
+            }
+            return result;
+        }
+
+        /**
+         *  Applies `changeset` or a patchset to `db` in one savepoint.
+         */
+        inline void apply_changeset(sqlite3* db, const std::vector<char>& changeset, changeset_conflict_policy policy) {
+            int result = static_cast<int>(policy);
+            auto rc = sqlite3changeset_apply(db,
+                                             int(changeset.size()),
+                                             const_cast<char*>(changeset.data()),
+                                             nullptr,
+                                             changeset_conflict_callback,
+                                             &result);
+            //  an aborted changeset leaves no error on the connection
+            if(rc != SQLITE_OK) {
+                throw_translated_sqlite_error(rc);
+            }
+        }
+    }
+#endif  //  defined(SQLITE_ENABLE_SESSION) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+}
@@ -3,7 +3,7 @@
 #include <tuple>  //  std::tuple
 #include <string>  //  std::string
 #include <memory>  //  std::unique_ptr
-#include <type_traits>  //  std::is_same, std::is_member_object_pointer
+#include <type_traits>  //  std::is_same, std::is_member_object_pointer, std::is_const, std::is_lvalue_reference
 
 #include "functional/cxx_universal.h"
 #include "functional/cxx_type_traits_polyfill.h"
@@ -13,6 +13,7 @@
 #include "member_traits/member_traits.h"
 #include "type_is_nullable.h"
 #include "constraints.h"
+#include "fixed_name.h"
 
 namespace sqlite_orm {
 
@@ -62,6 +63,28 @@ namespace sqlite_orm {
             }
         };
 
+        /**
+         *  Whether a column is mapped by a getter alone. Such a column is read-only for anything but sqlite_orm,
+         *  which reads its value into the member the getter returns a const reference to, e.g. the value of a
+         *  generated column: `const std::string& key() const { return this->_key; }`.
+         */
+        template<class G, class S>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_read_only_field_v =
+            !std::is_member_object_pointer<G>::value && std::is_same<S, empty_setter>::value;
+
+        /**
+         *  The member of `object` a read-only column mapped by `getter` is read into.
+         */
+        template<class O, class G>
+        member_field_type_t<G>& read_only_field(O& object, G getter) {
+            using reference_type = decltype((object.*getter)());
+            static_assert(std::is_lvalue_reference<reference_type>::value &&
+                              std::is_const<std::remove_reference_t<reference_type>>::value,
+                          "A column mapped by a getter alone needs a getter returning a const reference to a member");
+            //  the member itself isn't const, only the access the getter gives to it
+            return const_cast<member_field_type_t<G>&>((object.*getter)());
+        }
+
         /*
          *  Encapsulates a tuple of column constraints.
          *  
@@ -147,6 +170,19 @@ namespace sqlite_orm {
         SQLITE_ORM_CLANG_SUPPRESS_MISSING_BRACES(return {move(name), m, {}, std::make_tuple(constraints...)});
     }
 
+    /**
+     *  Column builder function with a getter alone, which makes the column read-only for the code using the
+     *  mapped object. Values are read into the member the getter returns a const reference to. Meant for generated
+     *  columns, e.g. `make_column("key", &Product::key, generated_always_as(lower(&Product::name)).stored())`,
+     *  whose values insert and update never write.
+     */
+    template<class G, class... Op, internal::satisfies<internal::is_getter, G> = true>
+    internal::column_t<G, internal::empty_setter, Op...> make_column(std::string name, G getter, Op... constraints) {
+        static_assert(polyfill::conjunction_v<internal::is_constraint<Op>...>, "Incorrect constraints pack");
+
+        SQLITE_ORM_CLANG_SUPPRESS_MISSING_BRACES(return {move(name), getter, {}, std::make_tuple(constraints...)});
+    }
+
     /**
      *  Column builder function with setter and getter. You should use it to create columns instead of constructor
      */
@@ -179,4 +215,16 @@ namespace sqlite_orm {
 
         SQLITE_ORM_CLANG_SUPPRESS_MISSING_BRACES(return {move(name), getter, setter, std::make_tuple(constraints...)});
     }
+
+#ifdef SQLITE_ORM_CLASSTYPE_TEMPLATE_ARGS_SUPPORTED
+    /**
+     *  Column builder function with the name as a template argument, checked at compile time:
+     *  `make_column<"id">(&User::id, primary_key())`. Takes the same arguments as the builders above.
+     */
+    template<internal::fixed_name name, class... Args>
+    auto make_column(Args... args) {
+        static_assert(name.size() > 0, "Column names can't be empty");
+        return make_column(name.str(), std::move(args)...);
+    }
+#endif
 }
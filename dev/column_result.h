@@ -15,6 +15,7 @@
 #include "column.h"
 #include "storage_traits.h"
 #include "function.h"
+#include "ast/time_bucket.h"
 
 namespace sqlite_orm {
 
@@ -71,6 +72,11 @@ namespace sqlite_orm {
             using type = R;
         };
 
+        template<class DBOs, class O, class F>
+        struct column_result_t<DBOs, time_bucket_t<O, F>, void> {
+            using type = std::conditional_t<std::is_same<F, std::string>::value, std::string, int64>;
+        };
+
         template<class DBOs, class F, class... Args>
         struct column_result_t<DBOs, function_call<F, Args...>, void> {
             using type = typename callable_arguments<F>::return_type;
@@ -86,6 +92,24 @@ namespace sqlite_orm {
             using type = std::unique_ptr<column_result_of_t<DBOs, X>>;
         };
 
+        template<class DBOs, class R, class S, class... Args>
+        struct column_result_t<DBOs, built_in_window_function_t<R, S, Args...>, void> {
+            using type = R;
+        };
+
+        template<class DBOs, class X, class... Rest, class S>
+        struct column_result_t<DBOs,
+                               built_in_window_function_t<internal::unique_ptr_result_of<X>, S, X, Rest...>,
+                               void> {
+            using type = std::unique_ptr<column_result_of_t<DBOs, X>>;
+        };
+
+        template<class DBOs, class F, class W>
+        struct column_result_t<DBOs, filtered_aggregate_function<F, W>, void> : column_result_t<DBOs, F> {};
+
+        template<class DBOs, class F, class... Args>
+        struct column_result_t<DBOs, over_t<F, Args...>, void> : column_result_t<DBOs, F> {};
+
         template<class DBOs, class T>
         struct column_result_t<DBOs, count_asterisk_t<T>, void> {
             using type = int;
@@ -257,6 +281,13 @@ namespace sqlite_orm {
             using type = T;
         };
 
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        template<class DBOs, class T>
+        struct column_result_t<DBOs, optional_object_t<T>, void> {
+            using type = std::optional<T>;
+        };
+#endif
+
         template<class DBOs, class T, class E>
         struct column_result_t<DBOs, cast_t<T, E>, void> {
             using type = T;
@@ -267,6 +298,11 @@ namespace sqlite_orm {
             using type = R;
         };
 
+        template<class DBOs, class R, class T, class K, class V>
+        struct column_result_t<DBOs, dynamic_case_t<R, T, K, V>, void> {
+            using type = R;
+        };
+
         template<class DBOs, class A, class T, class E>
         struct column_result_t<DBOs, like_t<A, T, E>, void> {
             using type = bool;
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <memory>  //  std::unique_ptr, std::shared_ptr
+#include <tuple>  //  std::tuple, std::get
+#include <utility>  //  std::index_sequence, std::index_sequence_for
+#include <vector>  //  std::vector
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+#include <optional>  //  std::optional
+#endif
+
+#include "functional/cxx_universal.h"
+#include "row_extractor.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  One column of the result of `select_columnar()`: the values of all rows in one contiguous vector.
+     *  The column of a nullable type like `std::optional<double>` holds `double` values, a null being a
+     *  value-initialized value with its flag in `nulls` set.
+     */
+    template<class T>
+    struct column_data {
+        using value_type = T;
+
+        std::vector<value_type> values;
+
+        /**
+         *  Null flags of `values`, filled only if the column is nullable.
+         */
+        std::vector<bool> nulls;
+        bool nullable = false;
+
+        size_t size() const {
+            return this->values.size();
+        }
+
+        bool is_null(size_t index) const {
+            return this->nullable && this->nulls[index];
+        }
+    };
+
+    namespace internal {
+
+        /**
+         *  Value type of a column of type T in `column_data`, nullable wrappers being removed, e.g. `int` for
+         *  `std::unique_ptr<std::unique_ptr<int>>` which `max()` of a `std::unique_ptr<int>` column returns.
+         */
+        template<class T>
+        struct columnar_value {
+            using type = T;
+            static constexpr bool nullable = false;
+        };
+
+        template<class T>
+        struct columnar_value<std::unique_ptr<T>> {
+            using type = typename columnar_value<T>::type;
+            static constexpr bool nullable = true;
+        };
+
+        template<class T>
+        struct columnar_value<std::shared_ptr<T>> {
+            using type = typename columnar_value<T>::type;
+            static constexpr bool nullable = true;
+        };
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        template<class T>
+        struct columnar_value<std::optional<T>> {
+            using type = typename columnar_value<T>::type;
+            static constexpr bool nullable = true;
+        };
+#endif
+
+        /**
+         *  Appends the value of the column `columnIndex` of the current row of `stmt` to `column`.
+         */
+        template<class T>
+        void append_column_value(column_data<T>& column, sqlite3_stmt* stmt, int columnIndex) {
+            if(column.nullable) {
+                const bool null = sqlite3_column_type(stmt, columnIndex) == SQLITE_NULL;
+                column.nulls.push_back(null);
+                if(null) {
+                    column.values.emplace_back();
+                    return;
+                }
+            }
+            column.values.push_back(row_extractor<T>{}.extract(stmt, columnIndex));
+        }
+
+        template<class Row>
+        struct columnar_result;
+
+        template<class... R>
+        struct columnar_result<std::tuple<R...>> {
+            using type = std::tuple<column_data<typename columnar_value<R>::type>...>;
+
+            static type make() {
+                return type{make_column<R>()...};
+            }
+
+            static void append_row(type& res, sqlite3_stmt* stmt) {
+                append_row(res, stmt, std::index_sequence_for<R...>{});
+            }
+
+          private:
+            template<class V>
+            static column_data<typename columnar_value<V>::type> make_column() {
+                column_data<typename columnar_value<V>::type> res;
+                res.nullable = columnar_value<V>::nullable;
+                return res;
+            }
+
+            template<size_t... Is>
+            static void append_row(type& res, sqlite3_stmt* stmt, std::index_sequence<Is...>) {
+                using expand = int[];
+                (void)expand{0, (append_column_value(std::get<Is>(res), stmt, int(Is)), 0)...};
+            }
+        };
+    }
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstdint>  //  uint64_t
+#include <cstring>  //  std::memcpy, ::strlen
+#include <string>  //  std::string
+#include <system_error>  //  std::system_error
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+#ifdef SQLITE_ORM_ZLIB_ENABLED
+#include <zlib.h>
+#endif
+#ifdef SQLITE_ORM_ZSTD_ENABLED
+#include <zstd.h>
+#endif
+
+#include "error_code.h"
+#include "type_printer.h"
+#include "statement_binder.h"
+#include "row_extractor.h"
+#include "field_printer.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  A member of type T (`std::string`, `std::vector<char>` or another contiguous container of chars) stored
+     *  compressed by `Codec` in a BLOB column, e.g. `compressed<std::string, zstd_codec<3>>` for a large JSON
+     *  document. The value is compressed when it is bound and decompressed on the first `get()` after it was
+     *  read, so objects read for other members never pay for decompression. Both forms are cached, which makes
+     *  concurrent `get()` calls on the same object unsafe.
+     *
+     *  A codec is a type with the static member functions
+     *  `void compress(const char* data, size_t size, std::vector<char>& out)` and
+     *  `template<class Buffer> void decompress(const char* data, size_t size, Buffer& out)`.
+     */
+    template<class T, class Codec>
+    class compressed {
+      public:
+        using value_type = T;
+        using codec_type = Codec;
+
+        compressed() = default;
+
+        compressed(value_type value_) : value(std::move(value_)) {}
+
+        compressed& operator=(value_type value_) {
+            this->value = std::move(value_);
+            this->decoded = true;
+            this->encoded.clear();
+            this->encodedValid = false;
+            return *this;
+        }
+
+        /**
+         *  Makes a value from bytes compressed by `Codec`, which are decompressed on the first `get()`.
+         */
+        static compressed from_bytes(std::vector<char> bytes) {
+            compressed res;
+            res.encoded = std::move(bytes);
+            res.encodedValid = true;
+            res.decoded = false;
+            return res;
+        }
+
+        const value_type& get() const {
+            if(!this->decoded) {
+                this->value = value_type{};
+                if(!this->encoded.empty()) {
+                    codec_type::decompress(this->encoded.data(), this->encoded.size(), this->value);
+                }
+                this->decoded = true;
+            }
+            return this->value;
+        }
+
+        operator const value_type&() const {
+            return this->get();
+        }
+
+        /**
+         *  The value compressed by `Codec`, an empty value being stored as no bytes.
+         */
+        const std::vector<char>& bytes() const {
+            if(!this->encodedValid) {
+                this->encoded.clear();
+                if(!this->value.empty()) {
+                    codec_type::compress(this->value.data(), this->value.size(), this->encoded);
+                }
+                this->encodedValid = true;
+            }
+            return this->encoded;
+        }
+
+        bool is_decoded() const {
+            return this->decoded;
+        }
+
+      private:
+        mutable value_type value;
+        mutable std::vector<char> encoded;
+        mutable bool decoded = true;
+        mutable bool encodedValid = false;
+    };
+
+    template<class T, class Codec>
+    bool operator==(const compressed<T, Codec>& lhs, const compressed<T, Codec>& rhs) {
+        return lhs.get() == rhs.get();
+    }
+
+    template<class T, class Codec>
+    bool operator!=(const compressed<T, Codec>& lhs, const compressed<T, Codec>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    namespace internal {
+
+        /**
+         *  Appends `value` to `out` as 8 bytes in little endian order.
+         */
+        inline void append_uncompressed_size(std::vector<char>& out, uint64_t value) {
+            for(int i = 0; i < 8; ++i) {
+                out.push_back(char((value >> (8 * i)) & 0xff));
+            }
+        }
+
+        inline uint64_t read_uncompressed_size(const char* data, size_t size) {
+            if(size < 8) {
+                throw std::system_error{orm_error_code::invalid_compressed_value};
+            }
+            uint64_t value = 0;
+            for(int i = 0; i < 8; ++i) {
+                value |= uint64_t((unsigned char)data[i]) << (8 * i);
+            }
+            return value;
+        }
+    }
+
+#ifdef SQLITE_ORM_ZLIB_ENABLED
+    /**
+     *  zlib's `compress2()` at `Level`, the bytes being prefixed by the uncompressed size.
+     */
+    template<int Level = Z_DEFAULT_COMPRESSION>
+    struct zlib_codec {
+        static void compress(const char* data, size_t size, std::vector<char>& out) {
+            internal::append_uncompressed_size(out, size);
+            const size_t prefix = out.size();
+            uLongf length = compressBound(uLong(size));
+            out.resize(prefix + length);
+            auto rc = compress2(reinterpret_cast<Bytef*>(out.data() + prefix),
+                                &length,
+                                reinterpret_cast<const Bytef*>(data),
+                                uLong(size),
+                                Level);
+            if(rc != Z_OK) {
+                throw std::system_error{orm_error_code::invalid_compressed_value, zError(rc)};
+            }
+            out.resize(prefix + length);
+        }
+
+        template<class Buffer>
+        static void decompress(const char* data, size_t size, Buffer& out) {
+            const auto uncompressedSize = internal::read_uncompressed_size(data, size);
+            out.resize(size_t(uncompressedSize));
+            uLongf length = uLongf(uncompressedSize);
+            auto rc = uncompress(reinterpret_cast<Bytef*>(&out[0]),
+                                 &length,
+                                 reinterpret_cast<const Bytef*>(data + 8),
+                                 uLong(size - 8));
+            if(rc != Z_OK || length != uncompressedSize) {
+                throw std::system_error{orm_error_code::invalid_compressed_value, zError(rc)};
+            }
+        }
+    };
+#endif
+
+#ifdef SQLITE_ORM_ZSTD_ENABLED
+    /**
+     *  A zstd frame compressed at `Level`, which holds the uncompressed size itself.
+     */
+    template<int Level = ZSTD_CLEVEL_DEFAULT>
+    struct zstd_codec {
+        static void compress(const char* data, size_t size, std::vector<char>& out) {
+            const size_t prefix = out.size();
+            out.resize(prefix + ZSTD_compressBound(size));
+            const size_t length = ZSTD_compress(out.data() + prefix, out.size() - prefix, data, size, Level);
+            if(ZSTD_isError(length)) {
+                throw std::system_error{orm_error_code::invalid_compressed_value, ZSTD_getErrorName(length)};
+            }
+            out.resize(prefix + length);
+        }
+
+        template<class Buffer>
+        static void decompress(const char* data, size_t size, Buffer& out) {
+            const auto uncompressedSize = ZSTD_getFrameContentSize(data, size);
+            if(uncompressedSize == ZSTD_CONTENTSIZE_ERROR || uncompressedSize == ZSTD_CONTENTSIZE_UNKNOWN) {
+                throw std::system_error{orm_error_code::invalid_compressed_value};
+            }
+            out.resize(size_t(uncompressedSize));
+            const size_t length = ZSTD_decompress(&out[0], out.size(), data, size);
+            if(ZSTD_isError(length) || length != uncompressedSize) {
+                throw std::system_error{orm_error_code::invalid_compressed_value};
+            }
+        }
+    };
+#endif
+
+    template<class T, class Codec>
+    struct type_printer<compressed<T, Codec>, void> : blob_printer {};
+
+    template<class T, class Codec>
+    struct statement_binder<compressed<T, Codec>, void> {
+        int bind(sqlite3_stmt* stmt, int index, const compressed<T, Codec>& value) const {
+            return statement_binder<std::vector<char>>().bind(stmt, index, value.bytes());
+        }
+
+        void result(sqlite3_context* context, const compressed<T, Codec>& value) const {
+            statement_binder<std::vector<char>>().result(context, value.bytes());
+        }
+    };
+
+    template<class T, class Codec>
+    struct row_extractor<compressed<T, Codec>, void> {
+        compressed<T, Codec> extract(const char* row_value) const {
+            return compressed<T, Codec>::from_bytes(row_extractor<std::vector<char>>().extract(row_value));
+        }
+
+        compressed<T, Codec> extract(sqlite3_stmt* stmt, int columnIndex) const {
+            return compressed<T, Codec>::from_bytes(row_extractor<std::vector<char>>().extract(stmt, columnIndex));
+        }
+
+        compressed<T, Codec> extract(sqlite3_value* value) const {
+            return compressed<T, Codec>::from_bytes(row_extractor<std::vector<char>>().extract(value));
+        }
+    };
+
+    template<class T, class Codec>
+    struct field_printer<compressed<T, Codec>, void> {
+        std::string operator()(const compressed<T, Codec>& value) const {
+            return field_printer<T>()(value.get());
+        }
+    };
+}
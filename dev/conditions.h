@@ -1,7 +1,8 @@
 #pragma once
 
 #include <string>  //  std::string
-#include <type_traits>  //  std::enable_if, std::is_same
+#include <chrono>  //  std::chrono::milliseconds
+#include <type_traits>  //  std::enable_if, std::is_same, std::is_member_object_pointer
 #include <vector>  //  std::vector
 #include <tuple>  //  std::tuple, std::tuple_size
 #include <sstream>  //  std::stringstream
@@ -17,6 +18,8 @@
 #include "expression.h"
 #include "type_printer.h"
 #include "literal.h"
+#include "bound_array.h"
+#include "exec_options.h"
 
 namespace sqlite_orm {
 
@@ -60,6 +63,66 @@ namespace sqlite_orm {
         template<class T>
         using is_offset = polyfill::is_specialization_of<T, offset_t>;
 
+        /**
+         *  Capacity hint of a `get_all` result. It is not a part of the SQL.
+         */
+        struct reserve_t {
+            size_t capacity = 0;
+        };
+
+        template<class T>
+        using is_reserve = std::is_same<T, reserve_t>;
+
+        /**
+         *  Hint of `select` to use the query cache. It is not a part of the SQL.
+         */
+        struct cached_t {
+            std::chrono::milliseconds ttl{0};
+        };
+
+        template<class T>
+        using is_cached = std::is_same<T, cached_t>;
+
+        /**
+         *  Number of rows `iterate` reads ahead on a producer thread. It is not a part of the SQL.
+         */
+        struct prefetch_t {
+            size_t rows = 0;
+        };
+
+        template<class T>
+        using is_prefetch = std::is_same<T, prefetch_t>;
+
+        /**
+         *  Members that `get_all` reads, instead of all the columns of the table. The other members of the
+         *  objects keep the values their default constructor gives them.
+         */
+        template<class... Cols>
+        struct only_t {
+            using columns_type = std::tuple<Cols...>;
+
+            columns_type columns;
+        };
+
+        template<class T>
+        using is_only = polyfill::is_specialization_of<T, only_t>;
+
+        /**
+         *  INDEXED BY or NOT INDEXED of the table of T in the FROM clause of a select or get_all.
+         */
+        template<class T>
+        struct indexed_by_t {
+            using type = T;
+
+            /**
+             *  Empty for NOT INDEXED.
+             */
+            std::string index_name;
+        };
+
+        template<class T>
+        using is_indexed_by = polyfill::is_specialization_of<T, indexed_by_t>;
+
         /**
          *  Collated something
          */
@@ -527,9 +590,33 @@ namespace sqlite_orm {
                 auto newContext = this->context;
                 newContext.skip_table_name = true;
                 auto columnName = serialize(order_by.expression, newContext);
+                if(!this->entries.empty()) {
+                    this->serialized += ", ";
+                }
+                this->serialized += columnName;
+                if(!order_by._collate_argument.empty()) {
+                    this->serialized += " COLLATE ";
+                    this->serialized += order_by._collate_argument;
+                }
+                switch(order_by.asc_desc) {
+                    case 1:
+                        this->serialized += " ASC";
+                        break;
+                    case -1:
+                        this->serialized += " DESC";
+                        break;
+                }
                 entries.emplace_back(move(columnName), order_by.asc_desc, move(order_by._collate_argument));
             }
 
+            /**
+             *  The terms of the ORDER BY clause, serialized as they are pushed back. It is the shape of a
+             *  statement with this clause too, so every sort order gets its own cached statement.
+             */
+            const std::string& terms() const {
+                return this->serialized;
+            }
+
             const_iterator begin() const {
                 return this->entries.begin();
             }
@@ -540,10 +627,12 @@ namespace sqlite_orm {
 
             void clear() {
                 this->entries.clear();
+                this->serialized.clear();
             }
 
           protected:
             std::vector<entry_t> entries;
+            std::string serialized;
             context_t context;
         };
 
@@ -1035,6 +1124,71 @@ namespace sqlite_orm {
         return {std::move(lim), {std::move(offt.off)}};
     }
 
+    /**
+     *  Reserves capacity for `capacity` rows in the container returned by `get_all`, `get_all_pointer` or
+     *  `get_all_optional` if the container has `reserve()`. Use it when the number of rows is known in advance
+     *  to avoid reallocations while the result is being filled:
+     *  `storage.get_all<User>(where(c(&User::id) < 100000), reserve(100000))`.
+     */
+    inline internal::reserve_t reserve(size_t capacity) {
+        return {capacity};
+    }
+
+    /**
+     *  Makes `get_all`, `get_all_pointer`, `get_all_optional`, `for_each` and `iterate` select only the columns
+     *  of the member pointers `columns` and fill only these members, leaving the others default. Reading
+     *  a few narrow columns this way lets SQLite answer from a covering index and skip wide blob columns:
+     *  `storage.get_all<User>(only(&User::id, &User::name), where(c(&User::id) > 10))`.
+     */
+    template<class... Cols>
+    internal::only_t<Cols...> only(Cols... columns) {
+        static_assert(sizeof...(Cols) > 0, "only() needs at least one column");
+        static_assert(polyfill::conjunction_v<std::is_member_object_pointer<Cols>...>,
+                      "only() takes member pointers to fields");
+        return {{std::move(columns)...}};
+    }
+
+    /**
+     *  Makes SQLite read the table of T with the index `indexName` (INDEXED BY), for the queries the query planner
+     *  picks a worse plan for. The statement fails to prepare if the index doesn't exist or can't be used.
+     *  Applies to the tables of the FROM clause that `select` and `get_all` make, not to joined tables.
+     *  Example: storage.get_all<User>(where(c(&User::email) == email), indexed_by<User>("idx_users_email"));
+     */
+    template<class T>
+    internal::indexed_by_t<T> indexed_by(std::string indexName) {
+        return {std::move(indexName)};
+    }
+
+    /**
+     *  Makes SQLite read the table of T without an index (NOT INDEXED), see `indexed_by()`.
+     */
+    template<class T>
+    internal::indexed_by_t<T> not_indexed() {
+        return {};
+    }
+
+    /**
+     *  Takes the result of `select` from the query cache if the same query with the same bound values ran before
+     *  and none of its tables changed since, e.g. `storage.select(count<User>(), where(...), cached())`.
+     *  The result is kept for `ttl`, or for `query_cache_options::ttl` if it's zero. Does nothing unless
+     *  `storage.enable_query_cache()` was called.
+     */
+    inline internal::cached_t cached(std::chrono::milliseconds ttl = std::chrono::milliseconds{0}) {
+        return {ttl};
+    }
+
+    /**
+     *  Makes `iterate` read the rows on a thread of its own, up to `rows` of them ahead of the loop consuming
+     *  them, so that waiting for the disk and processing the rows overlap, e.g. for a database on network storage:
+     *  `for(auto& user: storage.iterate<User>(prefetch(256))) { ... }`.
+     *  The thread reads with a connection of its own if the storage has a pool, so it needs a free connection
+     *  and doesn't see the changes of a transaction of the iterating thread. The view has to outlive the
+     *  iteration as usual, and ending the loop early waits for the row the thread is reading.
+     */
+    inline internal::prefetch_t prefetch(size_t rows) {
+        return {rows};
+    }
+
     template<class L,
              class R,
              std::enable_if_t<polyfill::disjunction_v<std::is_base_of<internal::condition_t, L>,
@@ -1092,6 +1246,24 @@ namespace sqlite_orm {
         return {std::move(l), std::move(arg), false};
     }
 
+    /**
+     *  Makes `in()` and `not_in()` bind `values` as one parameter instead of one parameter per value:
+     *  `in(&User::id, as_array(ids))` is serialized as `id IN (SELECT value FROM json_each(?))`, or as
+     *  `id IN carray(?)` if the carray extension is compiled in (its carray.h is included before sqlite_orm).
+     *  The SQL is the same for any number of values, so a prepared statement is reused for all of them
+     *  and the statement cache keeps one entry.
+     *  `E` has to be an arithmetic type or std::string. json_each needs SQLite 3.38.0 or JSON1.
+     */
+    template<class E>
+    internal::bound_array_t<E> as_array(std::vector<E> values) {
+        return {std::move(values)};
+    }
+
+    template<class E>
+    internal::bound_array_t<E> as_array(std::initializer_list<E> values) {
+        return {std::vector<E>(values)};
+    }
+
     template<class L, class E>
     internal::dynamic_in_t<L, std::vector<E>> not_in(L l, std::vector<E> values) {
         return {std::move(l), std::move(values), true};
@@ -2,36 +2,372 @@
 
 #include <sqlite3.h>
 #include <atomic>
+#include <algorithm>  //  std::max
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::microseconds, std::chrono::steady_clock
+#include <cstdint>  //  uint64_t
+#include <map>  //  std::map
 #include <string>  //  std::string
+#include <vector>  //  std::vector
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <functional>  //  std::function
+#include <mutex>  //  std::mutex, std::recursive_mutex, std::unique_lock, std::lock_guard
+#include <condition_variable>  //  std::condition_variable
+#include <thread>  //  std::thread::id, std::this_thread::get_id
+#include <utility>  //  std::move
 
+#include "functional/cxx_universal.h"
 #include "error_code.h"
 
 namespace sqlite_orm {
 
+    /**
+     *  Priority class of the calling thread when it borrows a connection from a pool, see `pool_priority_scope`.
+     *  A connection that is returned goes to a waiting thread of the most urgent class first.
+     */
+    enum class pool_priority : int {
+        interactive = 0,
+        normal = 1,
+        batch = 2,
+    };
+
+    /**
+     *  Options for a storage that keeps a pool of connections to the same database file.
+     *  Pass it as the first argument to `make_storage`:
+     *  ```
+     *  auto storage = make_storage(pool_options{4}, "db.sqlite", make_table(...));
+     *  ```
+     *  Every thread that talks to the storage borrows one connection from the pool and keeps it
+     *  while it holds any `connection_ref` (a prepared statement, an iteration view, an open transaction).
+     *  If all connections are borrowed the calling thread waits until one is returned.
+     *  Pooled connections are opened lazily and stay open until the storage is destroyed.
+     */
+    struct pool_options {
+        /**
+         *  Maximum number of connections opened to the database file.
+         *  With `single_writer` this is the number of reader connections.
+         */
+        int size = 4;
+
+        /**
+         *  If true `insert`, `update`, `replace`, `remove`, transactions and every other modifying call
+         *  run on one dedicated writer connection; threads that want to write wait for it in turn.
+         *  `get`, `get_all`, `select`, `count` and `iterate` run on reader connections opened with
+         *  `SQLITE_OPEN_READONLY` unless the calling thread holds the writer (e.g. inside a transaction).
+         *  Best used together with `journal_mode::WAL` so readers never block the writer.
+         */
+        bool single_writer = false;
+
+        /**
+         *  Connections borrowed at most by threads of `pool_priority::normal` and `pool_priority::batch`,
+         *  0 for no limit. E.g. `batch_limit = 2` leaves the other connections to interactive queries however
+         *  many batch threads run. Interactive threads have no limit.
+         */
+        int normal_limit = 0;
+        int batch_limit = 0;
+
+        /**
+         *  How long a thread waits for a connection at most before `std::system_error` with
+         *  `orm_error_code::pool_timeout` is thrown, 0 for no limit.
+         */
+        std::chrono::milliseconds acquire_timeout{0};
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        pool_options(int size = 4, bool single_writer = false) : size{size}, single_writer{single_writer} {}
+#endif
+    };
+
+    /**
+     *  How connections of a storage are opened with `sqlite3_open_v2`. Pass it to `make_storage`
+     *  before the filename:
+     *  ```
+     *  open_options options;
+     *  options.no_mutex = true;
+     *  auto storage = make_storage(options, "db.sqlite", make_table(...));
+     *  ```
+     *  https://sqlite.org/c3ref/open.html
+     */
+    struct open_options {
+        /**
+         *  SQLITE_OPEN_READONLY instead of SQLITE_OPEN_READWRITE. Every modifying call fails with SQLITE_READONLY.
+         */
+        bool readonly = false;
+
+        /**
+         *  SQLITE_OPEN_CREATE: a missing database file is created. If false opening a missing file fails
+         *  with SQLITE_CANTOPEN. Ignored for read-only connections.
+         */
+        bool create = true;
+
+        /**
+         *  SQLITE_OPEN_NOMUTEX: the connection uses no mutex of its own. Safe as long as the connection is used
+         *  by one thread at a time, which is the case for pooled connections.
+         */
+        bool no_mutex = false;
+
+        /**
+         *  SQLITE_OPEN_FULLMUTEX: the connection is serialized, so that it can be used by many threads at once.
+         */
+        bool full_mutex = false;
+
+        /**
+         *  SQLITE_OPEN_SHAREDCACHE or SQLITE_OPEN_PRIVATECACHE. At most one of them may be set. Shared cache
+         *  lets connections to the same `:memory:` database share it.
+         */
+        bool shared_cache = false;
+        bool private_cache = false;
+
+        /**
+         *  Errors of the connection carry extended result codes, e.g. SQLITE_CONSTRAINT_UNIQUE
+         *  instead of SQLITE_CONSTRAINT (`sqlite3_extended_result_codes`).
+         */
+        bool extended_result_codes = false;
+
+        /**
+         *  Name of the VFS the connection uses. Empty for the default VFS.
+         */
+        std::string vfs;
+
+        /**
+         *  URI parameter `immutable=1`: the database file is read-only media that no process changes,
+         *  so no locks are taken and no change detection is done.
+         */
+        bool immutable = false;
+
+        /**
+         *  URI parameter `nolock=1`: no file locks are taken. Only safe if no other process writes the file.
+         */
+        bool nolock = false;
+
+        /**
+         *  This process is the only user of the database file: connections run `PRAGMA locking_mode = EXCLUSIVE`
+         *  right after they are opened, before the journal mode is set, so the file locks are taken once and
+         *  kept, the change counter isn't read again for every transaction and WAL mode works without a shared
+         *  memory file. The storage keeps its connection open from the first call on as if `open_forever()` was
+         *  called, because the locks are only released by closing it, and it doesn't create a pool, whose
+         *  connections would lock each other out. Another storage or process opening the file gets SQLITE_BUSY
+         *  until the storage is destroyed; this includes a copy of the storage. `backup_to()` and `backup_from()`
+         *  of the storage itself work as they run on its connection, a backup of the file by anybody else doesn't.
+         */
+        bool single_process = false;
+
+        /**
+         *  Any other SQLITE_OPEN_* flags, or-ed with the ones above.
+         */
+        int flags = 0;
+    };
+
+    /**
+     *  Borrowing counters of one priority class of a pool.
+     */
+    struct pool_class_stats {
+        size_t acquisitions = 0;
+
+        /**
+         *  Acquisitions that had to wait for a connection, and the time they waited.
+         */
+        size_t waits = 0;
+        std::chrono::microseconds wait_time{0};
+        std::chrono::microseconds max_wait{0};
+
+        size_t timeouts = 0;
+
+        /**
+         *  Connections borrowed by the class now.
+         */
+        int borrowed = 0;
+    };
+
+    /**
+     *  Result of `storage.pool_stats()`.
+     */
+    struct pool_stats {
+        pool_class_stats interactive;
+        pool_class_stats normal;
+        pool_class_stats batch;
+
+        const pool_class_stats& operator[](pool_priority priority) const {
+            switch(priority) {
+                case pool_priority::interactive:
+                    return this->interactive;
+                case pool_priority::normal:
+                    break;
+                case pool_priority::batch:
+                    return this->batch;
+            }
+            return this->normal;
+        }
+
+        pool_class_stats& operator[](pool_priority priority) {
+            return const_cast<pool_class_stats&>(static_cast<const pool_stats&>(*this)[priority]);
+        }
+    };
+
+    /**
+     *  While it exists, the calling thread borrows connections of pools with `priority`. Threads borrow with
+     *  `pool_priority::normal` otherwise.
+     *  Example: pool_priority_scope batch{pool_priority::batch};
+     *           auto orders = storage.get_all<Order>();
+     *  The priority is taken into account when a connection is borrowed: a thread keeps a connection it has
+     *  borrowed already.
+     */
+    class pool_priority_scope {
+      public:
+        pool_priority_scope(pool_priority priority_) : priority(priority_), previous(current()) {
+            current() = this;
+        }
+
+        pool_priority_scope(const pool_priority_scope&) = delete;
+        pool_priority_scope& operator=(const pool_priority_scope&) = delete;
+
+        ~pool_priority_scope() {
+            current() = this->previous;
+        }
+
+        static pool_priority current_priority() {
+            auto scope = current();
+            return scope ? scope->priority : pool_priority::normal;
+        }
+
+      private:
+        pool_priority priority;
+        pool_priority_scope* previous;
+
+        static pool_priority_scope*& current() {
+            thread_local pool_priority_scope* scope = nullptr;
+            return scope;
+        }
+    };
+
     namespace internal {
 
+        /**
+         *  Returns `filename` as a `file:` URI with the query parameters of `options` if it needs any,
+         *  otherwise `filename` itself.
+         */
+        inline std::string make_open_filename(const std::string& filename, const open_options& options) {
+            if(!options.immutable && !options.nolock) {
+                return filename;
+            }
+            std::string res = "file:";
+            for(char c: filename) {
+                if(c == '?' || c == '#' || c == '%') {
+                    static const char digits[] = "0123456789ABCDEF";
+                    res += '%';
+                    res += digits[(unsigned char)c >> 4];
+                    res += digits[(unsigned char)c & 0xF];
+                } else {
+                    res += c;
+                }
+            }
+            char separator = '?';
+            if(options.immutable) {
+                res += separator;
+                res += "immutable=1";
+                separator = '&';
+            }
+            if(options.nolock) {
+                res += separator;
+                res += "nolock=1";
+            }
+            return res;
+        }
+
+        /**
+         *  Returns the flags `sqlite3_open_v2` gets for `options`. `readonly` is set for reader connections
+         *  of a pool.
+         */
+        inline int make_open_flags(const open_options& options, bool readonly) {
+            int res = options.flags;
+            if(readonly || options.readonly) {
+                res |= SQLITE_OPEN_READONLY;
+            } else {
+                res |= SQLITE_OPEN_READWRITE;
+                if(options.create) {
+                    res |= SQLITE_OPEN_CREATE;
+                }
+            }
+            if(options.no_mutex) {
+                res |= SQLITE_OPEN_NOMUTEX;
+            }
+            if(options.full_mutex) {
+                res |= SQLITE_OPEN_FULLMUTEX;
+            }
+            if(options.shared_cache) {
+                res |= SQLITE_OPEN_SHAREDCACHE;
+            }
+            if(options.private_cache) {
+                res |= SQLITE_OPEN_PRIVATECACHE;
+            }
+            if(options.immutable || options.nolock) {
+                res |= SQLITE_OPEN_URI;
+            }
+            return res;
+        }
+
+        struct connection_pool;
+        struct connection_ref;
+
+        /**
+         *  A statement owned by a connection and finalized right before the connection is closed,
+         *  see `storage_t::statement()`.
+         */
+        struct connection_statement_slot {
+            virtual ~connection_statement_slot() = default;
+        };
+
         struct connection_holder {
 
-            connection_holder(std::string filename_) : filename(move(filename_)) {}
+            connection_holder(std::string filename_,
+                              connection_pool* pool_ = nullptr,
+                              bool readonly_ = false,
+                              open_options options_ = {}) :
+                filename(move(filename_)),
+                readonly(readonly_), options(std::move(options_)), pool(pool_) {}
 
+            /**
+             *  Opens the connection on the first retain. The retain count is the state of the connection: 0 is
+             *  closed, more is open and set up. Only an open connection is retained and released without a lock;
+             *  opening it, `after_open` included, and closing it on the last release happen under
+             *  `lifecycleMutex`, so a thread retaining the holder meanwhile waits for either to finish instead of
+             *  seeing a connection that is half open or being closed. `after_open` may retain and release the
+             *  holder on the same thread.
+             */
             void retain() {
-                if(1 == ++this->_retain_count) {
-                    auto rc = sqlite3_open(this->filename.c_str(), &this->db);
-                    if(rc != SQLITE_OK) {
-                        throw_translated_sqlite_error(db);
-                    }
+                if(this->pool) {
+                    ++this->_retain_count;
+                    return;
                 }
-            }
-
-            void release() {
-                if(0 == --this->_retain_count) {
-                    auto rc = sqlite3_close(this->db);
-                    if(rc != SQLITE_OK) {
-                        throw_translated_sqlite_error(db);
+                if(this->try_retain_open()) {
+                    return;
+                }
+                std::lock_guard<std::recursive_mutex> lock{this->lifecycleMutex};
+                if(this->opening) {
+                    ++this->retainsWhileOpening;
+                    return;
+                }
+                //  the count can't drop to 0 while the lock is held
+                if(this->_retain_count.load() > 0) {
+                    ++this->_retain_count;
+                    return;
+                }
+                this->opening = true;
+                this->retainsWhileOpening = 1;
+                try {
+                    this->open();
+                    if(this->after_open) {
+                        this->after_open(this->db);
                     }
+                } catch(...) {
+                    this->opening = false;
+                    this->abandon();
+                    throw;
                 }
+                this->opening = false;
+                this->_retain_count.store(this->retainsWhileOpening, std::memory_order_release);
             }
 
+            void release();
+
             sqlite3* get() const {
                 return this->db;
             }
@@ -41,10 +377,305 @@ namespace sqlite_orm {
             }
 
             const std::string filename;
+            const bool readonly;
+            const open_options options;
+
+            /**
+             *  Called with the connection right after it is opened, before other threads can use it.
+             *  Connections of a pool are set up by the pool instead.
+             */
+            std::function<void(sqlite3*)> after_open;
+
+            /**
+             *  Called with the connection right before it is closed.
+             */
+            std::function<void(sqlite3*)> before_close;
+
+            /**
+             *  Statements prepared on this connection by `storage_t::statement()`, indexed by the statement type.
+             */
+            std::vector<std::unique_ptr<connection_statement_slot>> statementSlots;
+
+            /**
+             *  Statements prepared on this connection for `shared_statement_t`s, keyed by the id of the shared
+             *  statement. Unlike the slots these may be looked up by several threads sharing the connection, so
+             *  they are guarded by `sharedStatementsMutex`.
+             */
+            std::map<uint64_t, std::unique_ptr<connection_statement_slot>> sharedStatements;
+            std::mutex sharedStatementsMutex;
 
           protected:
+            friend struct connection_pool;
+
+            void open() {
+                const auto openFilename = make_open_filename(this->filename, this->options);
+                auto rc = sqlite3_open_v2(openFilename.c_str(),
+                                          &this->db,
+                                          make_open_flags(this->options, this->readonly),
+                                          this->options.vfs.empty() ? nullptr : this->options.vfs.c_str());
+                if(rc != SQLITE_OK) {
+                    throw_translated_sqlite_error(db);
+                }
+                if(this->options.extended_result_codes) {
+                    sqlite3_extended_result_codes(this->db, 1);
+                }
+                if(this->options.single_process &&
+                   sqlite3_exec(this->db, "PRAGMA locking_mode = EXCLUSIVE", nullptr, nullptr, nullptr) != SQLITE_OK) {
+                    throw_translated_sqlite_error(db);
+                }
+            }
+
+            void close() {
+                if(this->before_close) {
+                    this->before_close(this->db);
+                }
+                this->statementSlots.clear();
+                this->sharedStatements.clear();
+                auto rc = sqlite3_close(this->db);
+                if(rc != SQLITE_OK) {
+                    throw_translated_sqlite_error(db);
+                }
+                this->db = nullptr;
+            }
+
+            /**
+             *  Retains the connection without a lock if it is open.
+             */
+            bool try_retain_open() {
+                int count = this->_retain_count.load(std::memory_order_acquire);
+                while(count > 0) {
+                    if(this->_retain_count.compare_exchange_weak(count, count + 1, std::memory_order_acquire)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             *  Releases the connection without a lock unless this is its last retain, which closes it.
+             */
+            bool try_release_shared() {
+                int count = this->_retain_count.load(std::memory_order_relaxed);
+                while(count > 1) {
+                    if(this->_retain_count.compare_exchange_weak(count, count - 1, std::memory_order_release)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             *  Closes a connection whose opening failed. Its setup didn't finish, so `before_close` isn't called.
+             */
+            void abandon() {
+                this->statementSlots.clear();
+                this->sharedStatements.clear();
+                sqlite3_close(this->db);
+                this->db = nullptr;
+            }
+
             sqlite3* db = nullptr;
             std::atomic_int _retain_count{};
+            std::recursive_mutex lifecycleMutex;
+            bool opening = false;
+            int retainsWhileOpening = 0;
+            connection_pool* const pool;
+        };
+
+        /**
+         *  A fixed set of connections to the same database file.
+         *  A connection is assigned to a thread on the first `acquire()` call of that thread and
+         *  goes back to the pool as soon as its retain count drops to zero.
+         *  With `pool_options::single_writer` the first slot is the writer and the rest are read-only readers.
+         */
+        struct connection_pool {
+            using on_open_t = std::function<void(sqlite3*)>;
+
+            connection_pool(const std::string& filename,
+                            const pool_options& options_,
+                            const open_options& openOptions,
+                            on_open_t onOpen) :
+                options(options_),
+                slots(size_t(std::max(options_.size, 1)) + options_.single_writer), on_open(move(onOpen)) {
+                for(size_t i = 0; i < this->slots.size(); ++i) {
+                    const bool readonly = this->options.single_writer && i > 0;
+                    this->slots[i].holder =
+                        std::make_unique<connection_holder>(filename, this, readonly, openOptions);
+                }
+            }
+
+            connection_pool(const connection_pool&) = delete;
+            connection_pool& operator=(const connection_pool&) = delete;
+
+            ~connection_pool() {
+                for(auto& slot: this->slots) {
+                    slot.holder->statementSlots.clear();
+                    slot.holder->sharedStatements.clear();
+                    if(slot.holder->db) {
+                        sqlite3_close(slot.holder->db);
+                    }
+                }
+            }
+
+            /**
+             *  Returns a reference to the connection assigned to the calling thread. Assigns a free connection
+             *  (waiting for one if all connections are borrowed) and opens it if needed.
+             *  With `single_writer` this is always the writer connection.
+             */
+            connection_ref acquire();
+
+            /**
+             *  Same as `acquire()` but prefers a read-only connection with `single_writer`.
+             */
+            connection_ref acquire_reader();
+
+            /**
+             *  Returns the connection assigned to the calling thread or nullptr if there is none.
+             *  The writer is returned if the thread holds both the writer and a reader.
+             */
+            connection_holder* current() {
+                const auto threadId = std::this_thread::get_id();
+                std::lock_guard<std::mutex> lock{this->mutex};
+                for(auto& slot: this->slots) {
+                    if(slot.owner == threadId) {
+                        return slot.holder.get();
+                    }
+                }
+                return nullptr;
+            }
+
+            /**
+             *  Calls `lambda` with every database handle opened so far.
+             */
+            template<class L>
+            void for_each_opened(L&& lambda) {
+                std::vector<sqlite3*> opened;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    for(auto& slot: this->slots) {
+                        if(slot.opened) {
+                            opened.push_back(slot.holder->db);
+                        }
+                    }
+                }
+                for(sqlite3* db: opened) {
+                    lambda(db);
+                }
+            }
+
+            /**
+             *  Calls `lambda` with every opened database handle that is not borrowed by another thread.
+             *  The pool stays locked meanwhile, so none of them can be borrowed until `lambda` returns.
+             */
+            template<class L>
+            void for_each_idle(L&& lambda) {
+                const auto threadId = std::this_thread::get_id();
+                std::lock_guard<std::mutex> lock{this->mutex};
+                for(auto& slot: this->slots) {
+                    if(slot.opened && (slot.owner == std::thread::id{} || slot.owner == threadId)) {
+                        lambda(slot.holder->db);
+                    }
+                }
+            }
+
+            bool has_opened() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                for(auto& slot: this->slots) {
+                    if(slot.opened) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            int size() const {
+                return int(this->slots.size());
+            }
+
+            /**
+             *  @param reset resets the counters, except `borrowed`, after reading them.
+             */
+            pool_stats stats(bool reset) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto res = this->statistics;
+                if(reset) {
+                    for(auto priority: {pool_priority::interactive, pool_priority::normal, pool_priority::batch}) {
+                        auto& stats = this->statistics[priority];
+                        stats = pool_class_stats{};
+                        stats.borrowed = res[priority].borrowed;
+                    }
+                }
+                return res;
+            }
+
+            const pool_options options;
+
+          protected:
+            friend struct connection_holder;
+
+            struct slot_t {
+                std::unique_ptr<connection_holder> holder;
+                std::thread::id owner;
+                pool_priority priority = pool_priority::normal;
+                bool opened = false;
+            };
+
+            connection_ref acquire(std::unique_lock<std::mutex>& lock, size_t first, size_t last);
+
+            int limit_of(pool_priority priority) const {
+                switch(priority) {
+                    case pool_priority::interactive:
+                        break;
+                    case pool_priority::normal:
+                        return this->options.normal_limit;
+                    case pool_priority::batch:
+                        return this->options.batch_limit;
+                }
+                return 0;
+            }
+
+            /**
+             *  A thread of `priority` may borrow a connection unless its class has borrowed as many as its limit
+             *  or a thread of a more urgent class waits.
+             */
+            bool may_borrow(pool_priority priority) const {
+                const int limit = this->limit_of(priority);
+                if(limit > 0 && this->statistics[priority].borrowed >= limit) {
+                    return false;
+                }
+                for(int urgent = 0; urgent < int(priority); ++urgent) {
+                    if(this->waiting[urgent] > 0) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void recycle(connection_holder& holder) {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    for(auto& slot: this->slots) {
+                        if(slot.holder.get() == &holder) {
+                            slot.owner = std::thread::id{};
+                            --this->statistics[slot.priority].borrowed;
+                            break;
+                        }
+                    }
+                }
+                //  the connection may be for a waiting thread of another class than the first one woken up
+                this->released.notify_all();
+            }
+
+            std::vector<slot_t> slots;
+            on_open_t on_open;
+            std::mutex mutex;
+            std::condition_variable released;
+            pool_stats statistics;
+
+            /**
+             *  Number of threads waiting for a connection by priority.
+             */
+            int waiting[3] = {};
         };
 
         struct connection_ref {
@@ -52,24 +683,177 @@ namespace sqlite_orm {
                 this->holder.retain();
             }
 
-            connection_ref(const connection_ref& other) : holder(other.holder) {
-                this->holder.retain();
+            connection_ref(const connection_ref& other) : holder(other.holder), retained(other.retained) {
+                if(this->retained) {
+                    this->holder.retain();
+                }
             }
 
-            connection_ref(connection_ref&& other) : holder(other.holder) {
-                this->holder.retain();
-            }
+            connection_ref(connection_ref&& other) : connection_ref(static_cast<const connection_ref&>(other)) {}
 
             ~connection_ref() {
-                this->holder.release();
+                if(this->retained) {
+                    this->holder.release();
+                }
             }
 
             sqlite3* get() const {
                 return this->holder.get();
             }
 
+            /**
+             *  A reference to the same connection which doesn't keep it open, for statements owned by the
+             *  connection itself. Its copies don't keep it open either.
+             */
+            connection_ref unretained() const {
+                return connection_ref{this->holder, false};
+            }
+
+            std::vector<std::unique_ptr<connection_statement_slot>>& statement_slots() const {
+                return this->holder.statementSlots;
+            }
+
+            /**
+             *  Returns the statement this connection has for the shared statement with `id`, making it with
+             *  `make()` if there is none yet.
+             */
+            template<class F>
+            connection_statement_slot& shared_statement(uint64_t id, F&& make) const {
+                std::lock_guard<std::mutex> lock{this->holder.sharedStatementsMutex};
+                auto& slot = this->holder.sharedStatements[id];
+                if(!slot) {
+                    slot = make();
+                }
+                return *slot;
+            }
+
           protected:
+            connection_ref(connection_holder& holder_, bool retained_) : holder(holder_), retained(retained_) {}
+
             connection_holder& holder;
+            bool retained = true;
         };
+
+        inline connection_ref connection_pool::acquire() {
+            std::unique_lock<std::mutex> lock{this->mutex};
+            return this->acquire(lock, 0, this->options.single_writer ? 1 : this->slots.size());
+        }
+
+        inline connection_ref connection_pool::acquire_reader() {
+            std::unique_lock<std::mutex> lock{this->mutex};
+            if(!this->options.single_writer) {
+                return this->acquire(lock, 0, this->slots.size());
+            }
+            //  reads inside a transaction have to see its changes, and a database file
+            //  that was never opened for writing may not exist yet
+            auto& writer = this->slots.front();
+            if(writer.owner == std::this_thread::get_id() || !writer.opened) {
+                return this->acquire(lock, 0, 1);
+            }
+            return this->acquire(lock, 1, this->slots.size());
+        }
+
+        inline connection_ref connection_pool::acquire(std::unique_lock<std::mutex>& lock, size_t first, size_t last) {
+            const auto threadId = std::this_thread::get_id();
+            const auto priority = pool_priority_scope::current_priority();
+            auto& stats = this->statistics[priority];
+            slot_t* freeSlot = nullptr;
+            bool waited = false;
+            std::chrono::steady_clock::time_point waitStart;
+            auto countWait = [&stats, &waitStart] {
+                const auto waitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - waitStart);
+                stats.wait_time += waitTime;
+                stats.max_wait = std::max(stats.max_wait, waitTime);
+            };
+            for(;;) {
+                for(size_t i = first; i < last; ++i) {
+                    auto& slot = this->slots[i];
+                    if(slot.owner == threadId) {
+                        if(waited) {
+                            --this->waiting[int(priority)];
+                        }
+                        return {*slot.holder};
+                    }
+                    //  prefer connections that are already open
+                    if(slot.owner == std::thread::id{} && (!freeSlot || (!freeSlot->opened && slot.opened))) {
+                        freeSlot = &slot;
+                    }
+                }
+                if(waited) {
+                    --this->waiting[int(priority)];
+                }
+                if(freeSlot && this->may_borrow(priority)) {
+                    break;
+                }
+                freeSlot = nullptr;
+                if(!waited) {
+                    waited = true;
+                    waitStart = std::chrono::steady_clock::now();
+                    ++stats.waits;
+                }
+                ++this->waiting[int(priority)];
+                if(this->options.acquire_timeout.count() == 0) {
+                    this->released.wait(lock);
+                } else if(this->released.wait_until(lock, waitStart + this->options.acquire_timeout) ==
+                          std::cv_status::timeout) {
+                    --this->waiting[int(priority)];
+                    ++stats.timeouts;
+                    countWait();
+                    //  a connection returned meanwhile may be for a thread of a less urgent class
+                    this->released.notify_all();
+                    throw std::system_error{orm_error_code::pool_timeout};
+                }
+            }
+            if(waited) {
+                countWait();
+            }
+            ++stats.acquisitions;
+            ++stats.borrowed;
+            freeSlot->owner = threadId;
+            freeSlot->priority = priority;
+            connection_ref res{*freeSlot->holder};
+            if(freeSlot->opened) {
+                return res;
+            }
+            lock.unlock();
+
+            //  the slot is owned by this thread now and the reference keeps it that way,
+            //  so `on_open` may safely borrow the same connection again
+            auto& holder = *freeSlot->holder;
+            try {
+                holder.open();
+                if(this->on_open) {
+                    this->on_open(holder.db);
+                }
+            } catch(...) {
+                sqlite3_close(holder.db);
+                holder.db = nullptr;
+                throw;
+            }
+            lock.lock();
+            freeSlot->opened = true;
+            return res;
+        }
+
+        inline void connection_holder::release() {
+            if(this->pool) {
+                if(0 == --this->_retain_count) {
+                    this->pool->recycle(*this);
+                }
+                return;
+            }
+            if(this->try_release_shared()) {
+                return;
+            }
+            std::lock_guard<std::recursive_mutex> lock{this->lifecycleMutex};
+            if(this->opening) {
+                --this->retainsWhileOpening;
+                return;
+            }
+            if(0 == --this->_retain_count) {
+                this->close();
+            }
+        }
     }
 }
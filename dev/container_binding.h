@@ -0,0 +1,168 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <algorithm>  //  std::find
+#include <memory>  //  std::shared_ptr, std::make_shared, std::default_delete
+#include <type_traits>  //  std::integral_constant, std::decay_t, std::is_lvalue_reference, std::enable_if_t
+#include <typeinfo>  //  std::type_info
+#include <utility>  //  std::forward, std::declval
+
+#include "functional/cxx_type_traits_polyfill.h"
+#include "pointer_value.h"
+#include "row_extractor.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  The object a container binding passes to SQLite. It knows the type of the container, so the
+         *  `container_arg<C>` of a function gets the container only if it is a C.
+         */
+        struct bound_container {
+            const std::type_info* type;
+            std::shared_ptr<const void> container;
+        };
+
+        /**
+         *  The name of the pointer type, a template so that it has external linkage before C++17 too.
+         */
+        template<class = void>
+        struct container_pvt_name {
+            static constexpr const char value[] = "sqlite_orm::container";
+        };
+
+        template<class X>
+        constexpr const char container_pvt_name<X>::value[];
+
+        template<class C, class SFINAE = void>
+        struct container_key {
+            using type = typename C::value_type;
+        };
+
+        template<class C>
+        struct container_key<C, polyfill::void_t<typename C::key_type>> {
+            using type = typename C::key_type;
+        };
+
+        template<class C, class K, class SFINAE = void>
+        struct has_find_member : std::false_type {};
+
+        template<class C, class K>
+        struct has_find_member<C,
+                               K,
+                               polyfill::void_t<decltype(std::declval<const C&>().find(std::declval<const K&>()))>>
+            : std::true_type {};
+
+        template<class C, class K>
+        bool container_contains(const C& container, const K& key, std::true_type) {
+            return container.find(key) != container.end();
+        }
+
+        template<class C, class K>
+        bool container_contains(const C& container, const K& key, std::false_type) {
+            return std::find(container.begin(), container.end(), key) != container.end();
+        }
+    }
+
+    using container_pvt = std::integral_constant<const char*, internal::container_pvt_name<>::value>;
+
+    using container_binding = pointer_binding<const internal::bound_container,
+                                              container_pvt,
+                                              std::default_delete<const internal::bound_container>>;
+
+    /**
+     *  Binds a C++ container to a parameter of a user defined function taking a `container_arg<C>`, without
+     *  copying it into SQL values or a temporary table, e.g. for membership checks during a scan:
+     *  @example: std::unordered_set<int64> ids = ...;
+     *            storage.create_scalar_function<contains_fn<std::unordered_set<int64>>>();
+     *            storage.get_all<User>(where(func<contains_fn<std::unordered_set<int64>>>(&User::id,
+     *                                                                                    bind_container(ids))));
+     *  An lvalue container is referenced and has to outlive the execution of the statement, or of the prepared
+     *  statement it is bound to. An rvalue is moved into the binding and a `std::shared_ptr<const C>` is shared
+     *  with it, so those live as long as the statement needs them.
+     */
+    template<class C>
+    container_binding bind_container(const std::shared_ptr<const C>& container) {
+        return bindable_pointer<container_binding>(new internal::bound_container{&typeid(C), container});
+    }
+
+    template<class C>
+    container_binding bind_container(const std::shared_ptr<C>& container) {
+        return bind_container<C>(std::shared_ptr<const C>{container});
+    }
+
+    template<class C,
+             std::enable_if_t<!std::is_lvalue_reference<C>::value &&
+                                  !polyfill::is_specialization_of_v<std::decay_t<C>, std::shared_ptr>,
+                              bool> = true>
+    container_binding bind_container(C&& container) {
+        return bind_container<std::decay_t<C>>(std::make_shared<const std::decay_t<C>>(std::forward<C>(container)));
+    }
+
+    template<class C>
+    container_binding bind_container(const C& container) {
+        //  aliasing constructor: points to `container` without owning it
+        return bind_container<C>(std::shared_ptr<const C>{std::shared_ptr<const C>{}, &container});
+    }
+
+    /**
+     *  Parameter of a user defined function receiving a container bound with `bind_container()`. It is empty
+     *  if the argument isn't a bound container of type C. Virtual table cursors get one from an argument of
+     *  `filter()` with `row_extractor<container_arg<C>>().extract(argv[i])`.
+     */
+    template<class C>
+    struct container_arg {
+        using tag = container_pvt;
+
+        const C* p_;
+
+        const C* ptr() const noexcept {
+            return this->p_;
+        }
+
+        explicit operator bool() const noexcept {
+            return this->p_ != nullptr;
+        }
+
+        const C& operator*() const noexcept {
+            return *this->p_;
+        }
+
+        const C* operator->() const noexcept {
+            return this->p_;
+        }
+    };
+
+    template<class C>
+    struct row_extractor<container_arg<C>, void> {
+        container_arg<C> extract(sqlite3_value* value) const {
+            auto bound =
+                static_cast<const internal::bound_container*>(sqlite3_value_pointer(value, container_pvt::value));
+            if(!bound || *bound->type != typeid(C)) {
+                return {nullptr};
+            }
+            return {static_cast<const C*>(bound->container.get())};
+        }
+    };
+
+    /**
+     *  Scalar function `contains(value, container)` returning whether a container bound with
+     *  `bind_container()` holds `value`, using the `find()` member function of sets and maps.
+     *  Functions are registered by name, so derive from it with another `name()` to register it for
+     *  several container types.
+     */
+    template<class C>
+    struct contains_fn {
+        using key_type = typename internal::container_key<C>::type;
+
+        bool operator()(const key_type& value, container_arg<C> container) const {
+            return container &&
+                   internal::container_contains(*container, value, internal::has_find_member<C, key_type>{});
+        }
+
+        static constexpr const char* name() {
+            return "contains";
+        }
+    };
+}
@@ -13,6 +13,7 @@
 #include "serialize_result_type.h"
 #include "operators.h"
 #include "ast/into.h"
+#include "ast/window.h"
 
 namespace sqlite_orm {
 
@@ -44,19 +45,23 @@ namespace sqlite_orm {
         };
 
         template<class F, class W>
-        struct filtered_aggregate_function {
+        struct filtered_aggregate_function : windowable_function<filtered_aggregate_function<F, W>> {
             using function_type = F;
             using where_expression = W;
 
             function_type function;
             where_expression where;
+
+            filtered_aggregate_function(function_type function_, where_expression where_) :
+                function(std::move(function_)), where(std::move(where_)) {}
         };
 
         template<class C>
         struct where_t;
 
         template<class R, class S, class... Args>
-        struct built_in_aggregate_function_t : built_in_function_t<R, S, Args...> {
+        struct built_in_aggregate_function_t : built_in_function_t<R, S, Args...>,
+                                               windowable_function<built_in_aggregate_function_t<R, S, Args...>> {
             using super = built_in_function_t<R, S, Args...>;
 
             using super::super;
@@ -67,6 +72,84 @@ namespace sqlite_orm {
             }
         };
 
+        /**
+         *  A function that is only valid as a window function, like ROW_NUMBER(), and has to be
+         *  followed by `over()`.
+         */
+        template<class R, class S, class... Args>
+        struct built_in_window_function_t : built_in_function_t<R, S, Args...>,
+                                            windowable_function<built_in_window_function_t<R, S, Args...>> {
+            using super = built_in_function_t<R, S, Args...>;
+
+            using super::super;
+        };
+
+        struct row_number_string {
+            serialize_result_type serialize() const {
+                return "ROW_NUMBER";
+            }
+        };
+
+        struct rank_string {
+            serialize_result_type serialize() const {
+                return "RANK";
+            }
+        };
+
+        struct dense_rank_string {
+            serialize_result_type serialize() const {
+                return "DENSE_RANK";
+            }
+        };
+
+        struct percent_rank_string {
+            serialize_result_type serialize() const {
+                return "PERCENT_RANK";
+            }
+        };
+
+        struct cume_dist_string {
+            serialize_result_type serialize() const {
+                return "CUME_DIST";
+            }
+        };
+
+        struct ntile_string {
+            serialize_result_type serialize() const {
+                return "NTILE";
+            }
+        };
+
+        struct lag_string {
+            serialize_result_type serialize() const {
+                return "LAG";
+            }
+        };
+
+        struct lead_string {
+            serialize_result_type serialize() const {
+                return "LEAD";
+            }
+        };
+
+        struct first_value_string {
+            serialize_result_type serialize() const {
+                return "FIRST_VALUE";
+            }
+        };
+
+        struct last_value_string {
+            serialize_result_type serialize() const {
+                return "LAST_VALUE";
+            }
+        };
+
+        struct nth_value_string {
+            serialize_result_type serialize() const {
+                return "NTH_VALUE";
+            }
+        };
+
         struct typeof_string {
             serialize_result_type serialize() const {
                 return "TYPEOF";
@@ -209,6 +292,12 @@ namespace sqlite_orm {
             }
         };
 
+        struct iif_string {
+            serialize_result_type serialize() const {
+                return "IIF";
+            }
+        };
+
         struct date_string {
             serialize_result_type serialize() const {
                 return "DATE";
@@ -281,7 +370,7 @@ namespace sqlite_orm {
          *  T can be omitted with void.
          */
         template<class T>
-        struct count_asterisk_t : count_string {
+        struct count_asterisk_t : count_string, windowable_function<count_asterisk_t<T>> {
             using type = T;
 
             template<class W>
@@ -310,7 +399,13 @@ namespace sqlite_orm {
          *          group_by(&Customer::grade),
          *          having(greater_than(count(), 2))))));
          */
-        struct count_asterisk_without_type : count_string {};
+        struct count_asterisk_without_type : count_string, windowable_function<count_asterisk_without_type> {
+
+            template<class W>
+            filtered_aggregate_function<count_asterisk_without_type, W> filter(where_t<W> wh) {
+                return {*this, std::move(wh.expression)};
+            }
+        };
 
         struct avg_string {
             serialize_result_type serialize() const {
@@ -1716,6 +1811,29 @@ namespace sqlite_orm {
         return {std::make_tuple(std::move(x), std::move(y))};
     }
 
+#if SQLITE_VERSION_NUMBER >= 3032000
+    /**
+     *  IIF(X,Y,Z) function https://www.sqlite.org/lang_corefunc.html#iif
+     *  Y if X is true, otherwise Z, which is the same as CASE WHEN X THEN Y ELSE Z END.
+     *
+     *  Example:
+     *  storage.update_all(set(c(&Job::state) = iif(c(&Job::attempts) > 3, "failed", "retry")),
+     *                     where(in(&Job::id, ids)));
+     */
+    template<class R = void, class X, class Y, class Z>
+    auto iif(X x, Y y, Z z) -> internal::built_in_function_t<
+        typename std::conditional_t<  //  choose R or common type
+            std::is_void<R>::value,
+            std::common_type<internal::field_type_or_type_t<Y>, internal::field_type_or_type_t<Z>>,
+            polyfill::type_identity<R>>::type,
+        internal::iif_string,
+        X,
+        Y,
+        Z> {
+        return {std::make_tuple(std::move(x), std::move(y), std::move(z))};
+    }
+#endif
+
     /**
      *  NULLIF(X,Y) function https://www.sqlite.org/lang_corefunc.html#nullif
      */
@@ -1926,6 +2044,100 @@ namespace sqlite_orm {
     internal::built_in_aggregate_function_t<std::string, internal::group_concat_string, X, Y> group_concat(X x, Y y) {
         return {std::tuple<X, Y>{std::forward<X>(x), std::forward<Y>(y)}};
     }
+
+    /**
+     *  ROW_NUMBER() window function https://sqlite.org/windowfunctions.html#builtins
+     *  Example: storage.select(columns(&Sale::id,
+     *                                  row_number().over(partition_by(&Sale::region), order_by(&Sale::day))));
+     */
+    inline internal::built_in_window_function_t<int, internal::row_number_string> row_number() {
+        return {{}};
+    }
+
+    /**
+     *  RANK() window function.
+     */
+    inline internal::built_in_window_function_t<int, internal::rank_string> rank() {
+        return {{}};
+    }
+
+    /**
+     *  DENSE_RANK() window function.
+     */
+    inline internal::built_in_window_function_t<int, internal::dense_rank_string> dense_rank() {
+        return {{}};
+    }
+
+    /**
+     *  PERCENT_RANK() window function.
+     */
+    inline internal::built_in_window_function_t<double, internal::percent_rank_string> percent_rank() {
+        return {{}};
+    }
+
+    /**
+     *  CUME_DIST() window function.
+     */
+    inline internal::built_in_window_function_t<double, internal::cume_dist_string> cume_dist() {
+        return {{}};
+    }
+
+    /**
+     *  NTILE(N) window function.
+     */
+    template<class N>
+    internal::built_in_window_function_t<int, internal::ntile_string, N> ntile(N n) {
+        return {std::tuple<N>{std::forward<N>(n)}};
+    }
+
+    /**
+     *  LAG(X[, offset[, default]]) window function. The value is null in front of the partition unless
+     *  `default` is given.
+     */
+    template<class X, class... Rest>
+    internal::built_in_window_function_t<internal::unique_ptr_result_of<X>, internal::lag_string, X, Rest...>
+    lag(X x, Rest... rest) {
+        static_assert(sizeof...(Rest) <= 2, "LAG takes up to 3 arguments");
+        return {std::tuple<X, Rest...>{std::forward<X>(x), std::forward<Rest>(rest)...}};
+    }
+
+    /**
+     *  LEAD(X[, offset[, default]]) window function. The value is null past the partition unless
+     *  `default` is given.
+     */
+    template<class X, class... Rest>
+    internal::built_in_window_function_t<internal::unique_ptr_result_of<X>, internal::lead_string, X, Rest...>
+    lead(X x, Rest... rest) {
+        static_assert(sizeof...(Rest) <= 2, "LEAD takes up to 3 arguments");
+        return {std::tuple<X, Rest...>{std::forward<X>(x), std::forward<Rest>(rest)...}};
+    }
+
+    /**
+     *  FIRST_VALUE(X) window function.
+     */
+    template<class X>
+    internal::built_in_window_function_t<internal::unique_ptr_result_of<X>, internal::first_value_string, X>
+    first_value(X x) {
+        return {std::tuple<X>{std::forward<X>(x)}};
+    }
+
+    /**
+     *  LAST_VALUE(X) window function.
+     */
+    template<class X>
+    internal::built_in_window_function_t<internal::unique_ptr_result_of<X>, internal::last_value_string, X>
+    last_value(X x) {
+        return {std::tuple<X>{std::forward<X>(x)}};
+    }
+
+    /**
+     *  NTH_VALUE(X, N) window function.
+     */
+    template<class X, class N>
+    internal::built_in_window_function_t<internal::unique_ptr_result_of<X>, internal::nth_value_string, X, N>
+    nth_value(X x, N n) {
+        return {std::tuple<X, N>{std::forward<X>(x), std::forward<N>(n)}};
+    }
 #ifdef SQLITE_ENABLE_JSON1
     template<class X>
     internal::built_in_function_t<std::string, internal::json_string, X> json(X x) {
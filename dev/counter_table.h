@@ -0,0 +1,249 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::steady_clock
+#include <functional>  //  std::hash
+#include <map>  //  std::map
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <string>  //  std::string
+#include <thread>  //  std::thread::id, std::this_thread::get_id
+#include <tuple>  //  std::make_tuple
+#include <utility>  //  std::move, std::swap
+
+#include "functional/cxx_universal.h"
+#include "conditions.h"
+#include "ast/excluded.h"
+#include "ast/upsert_clause.h"
+#include "prepared_statement.h"
+#include "column.h"
+#include "constraints.h"
+#include "table.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  One shard row of a counter, see `make_counter_shards_table()`. The value of a counter is the sum of
+     *  the values of its shards. `Tag` tells apart counter tables.
+     */
+    template<class Tag = void>
+    struct counter_shard {
+        std::string name;
+        int slot = 0;
+        sqlite3_int64 value = 0;
+    };
+
+    /**
+     *  How `storage.make_counter_table<Tag>()` writes and reads counters.
+     */
+    struct counter_options {
+
+        /**
+         *  Rows every counter is spread over. A thread always increments the same one, so concurrent writers
+         *  of one counter seldom update the same row.
+         */
+        int shards = 16;
+
+        /**
+         *  Increments are summed up in memory and written at most this often, by the increment that finds the
+         *  oldest one older than this, or by `flush()`. 0 writes every increment at once.
+         */
+        std::chrono::milliseconds flush_interval{0};
+
+        /**
+         *  How long the value of a counter read from the database is reused, 0 reads it every time.
+         */
+        std::chrono::milliseconds read_cache{0};
+    };
+
+    namespace internal {
+
+        /**
+         *  Counters spread over shard rows of a table made by `make_counter_shards_table<Tag>()`. Don't construct
+         *  it as is, call `storage.make_counter_table<Tag>()` instead.
+         *  A hot counter kept in one row serializes its writers on that row and rewrites the same page for every
+         *  increment. Here an increment adds to one of `shards` rows by an UPSERT, optionally after summing up
+         *  increments in memory for `flush_interval`, and reading sums the rows of the counter up.
+         *  Values read include the increments not written yet. Increments not written when the table is
+         *  destroyed are written then. Counter tables can be used by many threads.
+         */
+        template<class S, class Tag>
+        struct counter_table {
+            using storage_type = S;
+            using shard_type = counter_shard<Tag>;
+
+            counter_table(storage_type& storage_, counter_options options_) :
+                options(options_), storage(storage_), state(std::make_unique<shared_state>()) {
+                if(this->options.shards < 1) {
+                    this->options.shards = 1;
+                }
+            }
+
+            counter_table(counter_table&&) = default;
+
+            ~counter_table() {
+                if(!this->state) {
+                    return;
+                }
+                try {
+                    this->flush();
+                } catch(...) {
+                }
+            }
+
+            /**
+             *  Adds `delta` to the counter `name`.
+             */
+            void add(const std::string& name, sqlite3_int64 delta = 1) {
+                if(this->options.flush_interval.count() == 0) {
+                    this->write(name, delta);
+                    return;
+                }
+                const auto now = std::chrono::steady_clock::now();
+                bool due;
+                {
+                    std::lock_guard<std::mutex> lock{this->state->mutex};
+                    if(this->state->pending.empty()) {
+                        this->state->pendingSince = now;
+                    }
+                    this->state->pending[name] += delta;
+                    due = now - this->state->pendingSince >= this->options.flush_interval;
+                }
+                if(due) {
+                    this->flush();
+                }
+            }
+
+            /**
+             *  @return value of the counter `name`, 0 if it was never incremented.
+             */
+            sqlite3_int64 get(const std::string& name) {
+                const auto now = std::chrono::steady_clock::now();
+                sqlite3_int64 pending = 0;
+                {
+                    std::lock_guard<std::mutex> lock{this->state->mutex};
+                    auto it = this->state->pending.find(name);
+                    if(it != this->state->pending.end()) {
+                        pending = it->second;
+                    }
+                    auto cached = this->state->cache.find(name);
+                    if(cached != this->state->cache.end() && now - cached->second.read < this->options.read_cache) {
+                        return cached->second.value + pending;
+                    }
+                }
+                sqlite3_int64 value = 0;
+                for(auto shardValue: this->storage.select(
+                        &shard_type::value,
+                        sqlite_orm::where(sqlite_orm::c(&shard_type::name) == name))) {
+                    value += shardValue;
+                }
+                if(this->options.read_cache.count() > 0) {
+                    std::lock_guard<std::mutex> lock{this->state->mutex};
+                    this->state->cache[name] = cached_value{value, now};
+                }
+                return value + pending;
+            }
+
+            /**
+             *  Writes the increments summed up in memory, in one transaction.
+             */
+            void flush() {
+                std::map<std::string, sqlite3_int64> pending;
+                {
+                    std::lock_guard<std::mutex> lock{this->state->mutex};
+                    std::swap(pending, this->state->pending);
+                }
+                if(pending.empty()) {
+                    return;
+                }
+                try {
+                    auto guard = this->storage.transaction_guard();
+                    for(auto& pair: pending) {
+                        this->write(pair.first, pair.second);
+                    }
+                    guard.commit();
+                } catch(...) {
+                    std::lock_guard<std::mutex> lock{this->state->mutex};
+                    for(auto& pair: pending) {
+                        this->state->pending[pair.first] += pair.second;
+                    }
+                    throw;
+                }
+            }
+
+            /**
+             *  Removes the counter `name`, its value is 0 again.
+             */
+            void reset(const std::string& name) {
+                {
+                    std::lock_guard<std::mutex> lock{this->state->mutex};
+                    this->state->pending.erase(name);
+                    this->state->cache.erase(name);
+                }
+                this->storage.template remove_all<shard_type>(
+                    sqlite_orm::where(sqlite_orm::c(&shard_type::name) == name));
+            }
+
+            counter_options options;
+
+          protected:
+            struct cached_value {
+                sqlite3_int64 value = 0;
+                std::chrono::steady_clock::time_point read;
+            };
+
+            struct shared_state {
+                std::mutex mutex;
+                std::map<std::string, sqlite3_int64> pending;
+                std::chrono::steady_clock::time_point pendingSince;
+                std::map<std::string, cached_value> cache;
+            };
+
+            void write(const std::string& name, sqlite3_int64 delta) {
+                const int slot = int(std::hash<std::thread::id>{}(std::this_thread::get_id()) % this->options.shards);
+                this->storage.insert(
+                    sqlite_orm::into<shard_type>(),
+                    sqlite_orm::columns(&shard_type::name, &shard_type::slot, &shard_type::value),
+                    sqlite_orm::values(std::make_tuple(name, slot, delta)),
+                    sqlite_orm::on_conflict(sqlite_orm::columns(&shard_type::name, &shard_type::slot))
+                        .do_update(sqlite_orm::set(sqlite_orm::c(&shard_type::value) =
+                                                       sqlite_orm::c(&shard_type::value) +
+                                                       sqlite_orm::excluded(&shard_type::value))));
+                std::lock_guard<std::mutex> lock{this->state->mutex};
+                //  keeps a cached value current with the increments of this table
+                auto cached = this->state->cache.find(name);
+                if(cached != this->state->cache.end()) {
+                    cached->second.value += delta;
+                }
+            }
+
+            storage_type& storage;
+
+            /**
+             *  Allocated so that the table can be moved.
+             */
+            std::unique_ptr<shared_state> state;
+        };
+    }
+
+    /**
+     *  Table of the shard rows of counters, `CREATE TABLE name ("name", "slot", "value", PRIMARY KEY ("name",
+     *  "slot")) WITHOUT ROWID`: the shards of a counter are neighbours in the primary key index, so summing
+     *  them up reads one or two pages. Use it with `storage.make_counter_table<Tag>()`:
+     *  auto storage = make_storage("stats.sqlite", make_counter_shards_table("page_views"));
+     *  auto views = storage.make_counter_table(counter_options{16, std::chrono::milliseconds{100}});
+     *  views.add("/index.html");
+     *  auto count = views.get("/index.html");
+     *  UPSERT needs SQLite 3.24.0.
+     */
+    template<class Tag = void>
+    auto make_counter_shards_table(std::string name) {
+        using shard_type = counter_shard<Tag>;
+        return make_table<shard_type>(std::move(name),
+                                      make_column("name", &shard_type::name),
+                                      make_column("slot", &shard_type::slot),
+                                      make_column("value", &shard_type::value, default_value(0)),
+                                      primary_key(&shard_type::name, &shard_type::slot))
+            .without_rowid();
+    }
+}
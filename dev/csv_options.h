@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>  //  size_t
+
+namespace sqlite_orm {
+
+    /**
+     *  How `storage.import_csv()` reads a file. The defaults read RFC 4180 CSV with a header line,
+     *  `delimiter = '\t'` reads TSV.
+     */
+    struct csv_options {
+        char delimiter = ',';
+
+        /**
+         *  Fields enclosed in `quote` may contain delimiters, line breaks and doubled quotes.
+         */
+        char quote = '"';
+
+        /**
+         *  Skip the first record.
+         */
+        bool header = true;
+
+        /**
+         *  Rows inserted by one statement, at most as many as fit into `limit.variable_number()` bound variables
+         *  and 0 for that many. A few hundred rows load faster than statements with thousands of rows.
+         */
+        size_t rows_per_statement = 512;
+
+        /**
+         *  Rows inserted by one transaction, 0 inserts the whole file in one transaction. Ignored if a
+         *  transaction is already open.
+         */
+        size_t rows_per_transaction = 1000000;
+
+        /**
+         *  Size of the read buffer in bytes. It grows if a single record doesn't fit into it.
+         */
+        size_t buffer_size = 4 * 1024 * 1024;
+
+        /**
+         *  Apply `performance_profile::bulk_load()` during the import and restore the former settings
+         *  afterwards. Exclusive locking isn't applied, nor is the journal mode of a database in WAL mode
+         *  changed. Ignored if a transaction is already open.
+         */
+        bool bulk_load_profile = true;
+    };
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <algorithm>  //  std::max
+#include <cerrno>  //  errno
+#include <cstdio>  //  std::FILE, std::fopen, std::fread, std::ferror, std::fclose
+#include <cstring>  //  std::memchr, std::memmove
+#include <string>  //  std::string, std::to_string
+#include <system_error>  //  std::system_error, std::generic_category
+#include <type_traits>  //  std::enable_if_t, std::is_arithmetic, std::is_same
+#include <vector>  //  std::vector
+
+#include "error_code.h"
+#include "csv_options.h"
+#include "type_is_nullable.h"
+#include "statement_binder.h"
+#include "row_extractor.h"
+#include "columnar.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  A field of a CSV record, unquoted and null-terminated in the read buffer of `csv_reader`.
+         */
+        struct csv_field {
+            const char* data;
+            size_t size;
+            bool quoted;
+        };
+
+        /**
+         *  Reads the records of a CSV file block by block. A record is first located in the read buffer and,
+         *  once it is complete, its fields are unquoted and null-terminated in place, so no field is copied.
+         *  Fields point into the buffer until the next `refill()`.
+         */
+        class csv_reader {
+          public:
+            csv_reader(const std::string& path, const csv_options& options_) :
+                options(options_), buffer(std::max<size_t>(options_.buffer_size, 2)) {
+                this->file = std::fopen(path.c_str(), "rb");
+                if(!this->file) {
+                    throw std::system_error{errno, std::generic_category(), path};
+                }
+                for(auto& special: this->specials) {
+                    special = false;
+                }
+                this->specials[(unsigned char)'\n'] = true;
+                this->specials[(unsigned char)'\r'] = true;
+                this->specials[(unsigned char)this->options.delimiter] = true;
+            }
+
+            csv_reader(const csv_reader&) = delete;
+
+            ~csv_reader() {
+                std::fclose(this->file);
+            }
+
+            /**
+             *  Parses the next record of the buffer into `fields`, skipping blank lines and the header.
+             *  @return false if the buffer holds no complete record, see `refill()`.
+             */
+            bool next(std::vector<csv_field>& fields) {
+                size_t recordEnd = 0;
+                while(this->locate(recordEnd)) {
+                    const bool blank = this->spans.size() == 1 && this->spans[0].size == 0 && !this->spans[0].quoted;
+                    const bool header = this->options.header && this->recordNumber == 0;
+                    if(!blank) {
+                        ++this->recordNumber;
+                    }
+                    if(blank || header) {
+                        this->begin = recordEnd;
+                        continue;
+                    }
+                    this->materialize(fields);
+                    this->begin = recordEnd;
+                    return true;
+                }
+                return false;
+            }
+
+            /**
+             *  Moves the unparsed rest of the buffer to its front and reads more of the file, growing the buffer
+             *  if a single record fills it. Fields returned by `next()` become invalid.
+             *  @return false at the end of the file.
+             */
+            bool refill() {
+                if(this->eof) {
+                    if(this->begin != this->end) {
+                        throw std::system_error{orm_error_code::invalid_csv_record,
+                                                "unterminated quoted field in record " +
+                                                    std::to_string(this->recordNumber + 1)};
+                    }
+                    return false;
+                }
+                std::memmove(this->buffer.data(), this->buffer.data() + this->begin, this->end - this->begin);
+                this->end -= this->begin;
+                this->begin = 0;
+                if(this->end == this->buffer.size()) {
+                    this->buffer.resize(this->buffer.size() * 2);
+                }
+                const size_t read =
+                    std::fread(this->buffer.data() + this->end, 1, this->buffer.size() - this->end, this->file);
+                if(read == 0) {
+                    if(std::ferror(this->file)) {
+                        throw std::system_error{errno, std::generic_category()};
+                    }
+                    this->eof = true;
+                    if(this->end == 0) {
+                        return false;
+                    }
+                    //  terminates the last record
+                    if(this->end == this->buffer.size()) {
+                        this->buffer.push_back('\n');
+                    } else {
+                        this->buffer[this->end] = '\n';
+                    }
+                    ++this->end;
+                    return true;
+                }
+                this->end += read;
+                return true;
+            }
+
+            /**
+             *  Number of the last record returned by `next()`, the header counting as the first one.
+             */
+            size_t record_number() const {
+                return this->recordNumber;
+            }
+
+          private:
+            struct csv_span {
+                size_t start;
+                size_t size;
+                bool quoted;
+            };
+
+            csv_options options;
+            std::FILE* file = nullptr;
+            std::vector<char> buffer;
+            size_t begin = 0;
+            size_t end = 0;
+            bool eof = false;
+            size_t recordNumber = 0;
+            bool specials[256];
+            std::vector<csv_span> spans;
+
+            /**
+             *  Finds the fields of the record at `begin` without changing the buffer, so that an incomplete
+             *  record can be located again after `refill()`.
+             */
+            bool locate(size_t& recordEnd) {
+                this->spans.clear();
+                const char* data = this->buffer.data();
+                const char quote = this->options.quote;
+                size_t position = this->begin;
+                for(;;) {
+                    csv_span span{position, 0, false};
+                    if(position < this->end && data[position] == quote) {
+                        size_t closing = position + 1;
+                        for(;;) {
+                            auto found =
+                                static_cast<const char*>(std::memchr(data + closing, quote, this->end - closing));
+                            if(!found || size_t(found - data) + 1 == this->end) {
+                                return false;
+                            }
+                            closing = size_t(found - data);
+                            if(data[closing + 1] != quote) {
+                                break;
+                            }
+                            closing += 2;
+                        }
+                        span = {position + 1, closing - position - 1, true};
+                        position = closing + 1;
+                    } else {
+                        while(position < this->end && !this->specials[(unsigned char)data[position]]) {
+                            ++position;
+                        }
+                        span.size = position - span.start;
+                    }
+                    if(position == this->end) {
+                        return false;
+                    }
+                    const char c = data[position];
+                    if(c == this->options.delimiter) {
+                        this->spans.push_back(span);
+                        ++position;
+                    } else if(c == '\n') {
+                        this->spans.push_back(span);
+                        recordEnd = position + 1;
+                        return true;
+                    } else if(c == '\r') {
+                        if(position + 1 == this->end) {
+                            return false;
+                        }
+                        this->spans.push_back(span);
+                        recordEnd = position + (data[position + 1] == '\n' ? 2 : 1);
+                        return true;
+                    } else {
+                        throw std::system_error{orm_error_code::invalid_csv_record,
+                                                "text after a closing quote in record " +
+                                                    std::to_string(this->recordNumber + 1)};
+                    }
+                }
+            }
+
+            void materialize(std::vector<csv_field>& fields) {
+                fields.clear();
+                const char quote = this->options.quote;
+                for(auto& span: this->spans) {
+                    char* field = this->buffer.data() + span.start;
+                    size_t size = span.size;
+                    if(span.quoted) {
+                        size = 0;
+                        for(size_t i = 0; i < span.size; ++i, ++size) {
+                            field[size] = field[i];
+                            //  skips the second quote of a doubled one
+                            if(field[i] == quote) {
+                                ++i;
+                            }
+                        }
+                    }
+                    //  overwrites the delimiter, line break or closing quote
+                    field[size] = '\0';
+                    fields.push_back({field, size, span.quoted});
+                }
+            }
+        };
+
+        template<class V, std::enable_if_t<std::is_arithmetic<V>::value, bool> = true>
+        int bind_csv_value(sqlite3_stmt* stmt, int index, const csv_field& field) {
+            return statement_binder<V>().bind(stmt, index, row_extractor<V>().extract(field.data));
+        }
+
+        template<class V, std::enable_if_t<std::is_same<V, std::vector<char>>::value, bool> = true>
+        int bind_csv_value(sqlite3_stmt* stmt, int index, const csv_field& field) {
+            return sqlite3_bind_blob(stmt, index, field.data, int(field.size), SQLITE_STATIC);
+        }
+
+        /**
+         *  Fields of other types are bound as text and converted by the affinity of their column.
+         */
+        template<class V,
+                 std::enable_if_t<!std::is_arithmetic<V>::value && !std::is_same<V, std::vector<char>>::value,
+                                  bool> = true>
+        int bind_csv_value(sqlite3_stmt* stmt, int index, const csv_field& field) {
+            return sqlite3_bind_text(stmt, index, field.data, int(field.size), SQLITE_STATIC);
+        }
+
+        /**
+         *  Binds `field` to the parameter `index` for a column of type T without copying it: an unquoted empty
+         *  field of a nullable type is bound as null, numbers are parsed by `row_extractor`.
+         */
+        template<class T>
+        void bind_csv_field(sqlite3_stmt* stmt, int index, const csv_field& field) {
+            int rc;
+            if(type_is_nullable<T>::value && field.size == 0 && !field.quoted) {
+                rc = sqlite3_bind_null(stmt, index);
+            } else {
+                rc = bind_csv_value<typename columnar_value<T>::type>(stmt, index, field);
+            }
+            if(rc != SQLITE_OK) {
+                throw_translated_sqlite_error(stmt);
+            }
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>  //  std::atomic
+#include <map>  //  std::map
+#include <mutex>  //  std::mutex, std::lock_guard
+
+#include "row_extractor.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Last `PRAGMA data_version` seen on every connection of a storage. The value of a connection
+         *  changes when another connection, of this process or another one, commits a change to the
+         *  database file, not when the connection itself does.
+         */
+        struct data_version_watch {
+
+            data_version_watch() = default;
+            data_version_watch(const data_version_watch&) = delete;
+            data_version_watch& operator=(const data_version_watch&) = delete;
+
+            bool enabled() const {
+                return this->isEnabled;
+            }
+
+            void enable() {
+                this->isEnabled = true;
+            }
+
+            void disable() {
+                this->isEnabled = false;
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->versions.clear();
+            }
+
+            /**
+             *  True if another connection changed the database since the last call for `db`, and on the
+             *  first call for `db` which has nothing to compare with.
+             */
+            bool changed(sqlite3* db) {
+                int version = 0;
+                perform_exec(db, "PRAGMA data_version", extract_single_value<int>, &version);
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto inserted = this->versions.emplace(db, version);
+                if(inserted.second) {
+                    return true;
+                }
+                if(inserted.first->second == version) {
+                    return false;
+                }
+                inserted.first->second = version;
+                return true;
+            }
+
+            /**
+             *  Forgets `db` before it is closed, a connection opened later may get the same handle.
+             */
+            void closed(sqlite3* db) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->versions.erase(db);
+            }
+
+          protected:
+            std::atomic<bool> isEnabled{false};
+            std::mutex mutex;
+            std::map<sqlite3*, int> versions;
+        };
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <algorithm>  //  std::upper_bound
+#include <memory>  //  std::shared_ptr, std::make_shared
+#include <string>  //  std::string
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
+#include "type_traits.h"
+#include "serializer_context.h"
+#include "statement_binder.h"
+#include "ast/where.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Copy of a value bound by a condition of a `dynamic_where_t`, binding it without its type.
+         */
+        struct dynamic_where_value {
+            std::shared_ptr<const void> value;
+            int (*bind)(sqlite3_stmt* stmt, int index, const void* value);
+        };
+
+        template<class T>
+        int bind_dynamic_where_value(sqlite3_stmt* stmt, int index, const void* value) {
+            return statement_binder<T>{}.bind(stmt, index, *static_cast<const T*>(value));
+        }
+
+        /**
+         *  Collects copies of the bindable values of an expression, in the order they are bound.
+         */
+        struct dynamic_where_values_collector {
+            std::vector<dynamic_where_value>& values;
+
+            template<class T, satisfies<is_bindable, T> = true>
+            void operator()(const T& value) const {
+                this->values.push_back({std::make_shared<const T>(value), &bind_dynamic_where_value<T>});
+            }
+
+            template<class T, satisfies_not<is_bindable, T> = true>
+            void operator()(const T&) const {}
+        };
+
+        struct dynamic_where_entry {
+
+            /**
+             *  SQL of the condition with `?` for its bound values.
+             */
+            std::string sql;
+
+            /**
+             *  SQL of the condition with its values as literals, for `dump()`.
+             */
+            std::string literal_sql;
+
+            std::vector<dynamic_where_value> values;
+        };
+
+        /**
+         *  C - serializer context class
+         */
+        template<class C>
+        struct dynamic_where_t {
+            using context_t = C;
+            using entry_t = dynamic_where_entry;
+            using const_iterator = typename std::vector<entry_t>::const_iterator;
+
+            dynamic_where_t(const context_t& context_) : context(context_) {}
+
+            /**
+             *  Adds a condition, ANDed with the others. Its values are copied, so it is serialized and its
+             *  values are collected right away.
+             */
+            template<class E>
+            void push_back(const E& expression) {
+                auto newContext = this->context;
+                newContext.skip_table_name = false;
+                entry_t entry;
+                newContext.replace_bindable_with_question = true;
+                entry.sql = serialize(expression, newContext);
+                newContext.replace_bindable_with_question = false;
+                entry.literal_sql = serialize(expression, newContext);
+                iterate_ast(expression, dynamic_where_values_collector{entry.values});
+                //  the conditions are kept ordered by their SQL, so the same set of conditions has one shape
+                //  whatever the order they are added in
+                auto position = std::upper_bound(this->entries.begin(),
+                                                 this->entries.end(),
+                                                 entry,
+                                                 [](const entry_t& lhs, const entry_t& rhs) {
+                                                     return lhs.sql < rhs.sql;
+                                                 });
+                this->entries.insert(position, std::move(entry));
+            }
+
+            const_iterator begin() const {
+                return this->entries.begin();
+            }
+
+            const_iterator end() const {
+                return this->entries.end();
+            }
+
+            bool empty() const {
+                return this->entries.empty();
+            }
+
+            void clear() {
+                this->entries.clear();
+            }
+
+          protected:
+            std::vector<entry_t> entries;
+            context_t context;
+        };
+
+        template<class C>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_where_v<dynamic_where_t<C>> = true;
+    }
+
+    template<>
+    struct statement_binder<internal::dynamic_where_value, void> {
+        int bind(sqlite3_stmt* stmt, int index, const internal::dynamic_where_value& value) const {
+            return value.bind(stmt, index, value.value.get());
+        }
+    };
+
+    /**
+     *  WHERE clause built at runtime: the conditions pushed into it are ANDed, and without any there is no WHERE.
+     *  The conditions are serialized as they are added and their values copied, so a query takes one type
+     *  whichever conditions it has, and the same set of conditions shares one statement in the statement cache.
+     *  Example:
+     *  auto filter = dynamic_where(storage);
+     *  if(minAge) {
+     *      filter.push_back(c(&User::age) >= *minAge);
+     *  }
+     *  if(!namePattern.empty()) {
+     *      filter.push_back(like(&User::name, namePattern));
+     *  }
+     *  auto users = storage.get_all<User>(filter, order_by(&User::id));
+     *  A `dynamic_where` holds the table names of `storage` and is used with it only.
+     */
+    template<class S>
+    internal::dynamic_where_t<internal::serializer_context<typename S::db_objects_type>>
+    dynamic_where(const S& storage) {
+        internal::serializer_context_builder<S> builder(storage);
+        return builder();
+    }
+}
@@ -38,6 +38,17 @@ namespace sqlite_orm {
         index_is_out_of_bounds,
         value_is_null,
         no_tables_specified,
+        deadline_exceeded,
+        no_shards,
+        incompatible_arrow_format,
+        invalid_csv_record,
+        invalid_compressed_value,
+        vfs_not_found,
+        blob_exceeds_buffer,
+        invalid_workload_trace,
+        no_audit_database,
+        pool_timeout,
+        version_conflict,
     };
 
 }
@@ -98,6 +109,28 @@ namespace sqlite_orm {
                     return "Value is null";
                 case orm_error_code::no_tables_specified:
                     return "No tables specified";
+                case orm_error_code::deadline_exceeded:
+                    return "Deadline exceeded";
+                case orm_error_code::no_shards:
+                    return "No shards specified";
+                case orm_error_code::incompatible_arrow_format:
+                    return "Arrow format is incompatible with the column type";
+                case orm_error_code::invalid_csv_record:
+                    return "Invalid CSV record";
+                case orm_error_code::invalid_compressed_value:
+                    return "Compressed value is invalid";
+                case orm_error_code::vfs_not_found:
+                    return "VFS not found";
+                case orm_error_code::blob_exceeds_buffer:
+                    return "BLOB doesn't fit the buffer";
+                case orm_error_code::invalid_workload_trace:
+                    return "Invalid workload trace";
+                case orm_error_code::no_audit_database:
+                    return "An in-memory database needs an audit database file";
+                case orm_error_code::pool_timeout:
+                    return "Timed out waiting for a pooled connection";
+                case orm_error_code::version_conflict:
+                    return "The row was updated or removed since it was read";
                 default:
                     return "unknown error";
             }
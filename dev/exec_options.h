@@ -0,0 +1,144 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstdlib>  //  std::atoi
+#include <string>  //  std::string, std::to_string
+#include <type_traits>  //  std::is_same
+
+namespace sqlite_orm {
+
+    /**
+     *  Settings of the connection for the execution of one `get_all` or `select`, passed along with its
+     *  conditions, e.g. `storage.get_all<Order>(order_by(&Order::total), exec_options{true, -512 * 1024})`
+     *  for a report sorting a lot of rows while the storage is tuned for small queries. They are applied to
+     *  the connection that runs the statement and restored once it finished. It is not a part of the SQL.
+     */
+    struct exec_options {
+
+        /**
+         *  Keeps sorts and temporary b-trees in memory (`temp_store = MEMORY`). SQLite deletes the temporary
+         *  tables of a connection when its temp_store changes, and refuses to change it inside a transaction,
+         *  so it is left alone then and on connections with temporary tables or a temp_store of MEMORY already.
+         */
+        bool temp_store_memory = false;
+
+        /**
+         *  `cache_size` of the main database during the statement: pages if positive, KiB if negative.
+         *  0 keeps the one of the connection.
+         */
+        int cache_size = 0;
+
+        /**
+         *  Number of auxiliary threads a sort may use, `SQLITE_LIMIT_WORKER_THREADS`. -1 keeps the limit
+         *  of the connection. SQLite caps it at `SQLITE_MAX_WORKER_THREADS`.
+         */
+        int worker_threads = -1;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        exec_options(bool temp_store_memory = false, int cache_size = 0, int worker_threads = -1) :
+            temp_store_memory{temp_store_memory}, cache_size{cache_size}, worker_threads{worker_threads} {}
+#endif
+    };
+
+    namespace internal {
+
+        template<class T>
+        using is_exec_options = std::is_same<T, exec_options>;
+
+        /**
+         *  Applies `exec_options` to the connection of `stmt` for its lifetime. When it is destroyed it resets
+         *  `stmt`, which ends its read transaction even if stepping threw, and restores the previous settings.
+         *  Does nothing without options.
+         */
+        class exec_options_scope {
+          public:
+            exec_options_scope(sqlite3_stmt* stmt_, const exec_options* options) :
+                stmt(options ? stmt_ : nullptr), db(sqlite3_db_handle(stmt_)) {
+                if(!options) {
+                    return;
+                }
+                if(options->temp_store_memory && sqlite3_get_autocommit(this->db) &&
+                   !has_rows(this->db, "SELECT 1 FROM sqlite_temp_master LIMIT 1")) {
+                    this->tempStore = read_int(this->db, "PRAGMA temp_store");
+                    if(this->tempStore == 2) {
+                        this->tempStore = -1;
+                    } else {
+                        exec(this->db, "PRAGMA temp_store = 2");
+                    }
+                }
+                if(options->cache_size) {
+                    this->cacheSize = read_int(this->db, "PRAGMA cache_size");
+                    this->restoreCacheSize = true;
+                    exec(this->db, "PRAGMA cache_size = " + std::to_string(options->cache_size));
+                }
+                if(options->worker_threads >= 0) {
+                    this->workerThreads =
+                        sqlite3_limit(this->db, SQLITE_LIMIT_WORKER_THREADS, options->worker_threads);
+                }
+            }
+
+            exec_options_scope(const exec_options_scope&) = delete;
+            exec_options_scope& operator=(const exec_options_scope&) = delete;
+
+            ~exec_options_scope() {
+                if(!this->stmt) {
+                    return;
+                }
+                sqlite3_reset(this->stmt);
+                if(this->workerThreads >= 0) {
+                    sqlite3_limit(this->db, SQLITE_LIMIT_WORKER_THREADS, this->workerThreads);
+                }
+                if(this->restoreCacheSize) {
+                    exec(this->db, "PRAGMA cache_size = " + std::to_string(this->cacheSize));
+                }
+                //  fails inside a transaction, the setting then stays
+                if(this->tempStore >= 0) {
+                    exec(this->db, "PRAGMA temp_store = " + std::to_string(this->tempStore));
+                }
+            }
+
+          private:
+            static int read_int(sqlite3* db, const char* sql) {
+                int value = 0;
+                sqlite3_exec(
+                    db,
+                    sql,
+                    [](void* data, int argc, char** argv, char**) {
+                        if(argc && argv[0]) {
+                            *static_cast<int*>(data) = std::atoi(argv[0]);
+                        }
+                        return 0;
+                    },
+                    &value,
+                    nullptr);
+                return value;
+            }
+
+            static bool has_rows(sqlite3* db, const char* sql) {
+                bool found = false;
+                sqlite3_exec(
+                    db,
+                    sql,
+                    [](void* data, int, char**, char**) {
+                        *static_cast<bool*>(data) = true;
+                        return 0;
+                    },
+                    &found,
+                    nullptr);
+                return found;
+            }
+
+            //  settings are best effort: a failure leaves the statement to run with the settings it has
+            static void exec(sqlite3* db, const std::string& sql) {
+                sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+            }
+
+            sqlite3_stmt* stmt;
+            sqlite3* db;
+            int tempStore = -1;
+            int cacheSize = 0;
+            bool restoreCacheSize = false;
+            int workerThreads = -1;
+        };
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <sqlite3.h>
+#ifdef SQLITE_ORM_ENABLE_EXECUTE_TRACING
+#include <array>  //  std::array
+#include <chrono>  //  std::chrono::steady_clock, std::chrono::nanoseconds
+#include <functional>  //  std::function
+#endif
+#include <utility>  //  std::forward, std::move
+
+namespace sqlite_orm {
+
+    /**
+     *  Phases of executing a statement reported to `storage.on_execute_event`.
+     */
+    enum class execute_phase {
+        serialize,
+        prepare,
+        bind,
+        step,
+        extract,
+    };
+
+#ifdef SQLITE_ORM_ENABLE_EXECUTE_TRACING
+    /**
+     *  Time spent in one phase of one prepared or executed statement. Phases that alternate
+     *  (`step` and `extract` for every row) are summed up and reported once.
+     *  `stmt` is the statement the phase was spent for, it is null only if preparing failed.
+     */
+    struct execute_event {
+        execute_phase phase;
+        std::chrono::nanoseconds duration;
+        sqlite3_stmt* stmt;
+    };
+
+    using execute_event_sink = std::function<void(const execute_event&)>;
+#endif
+
+    namespace internal {
+
+#ifdef SQLITE_ORM_ENABLE_EXECUTE_TRACING
+        /**
+         *  Measures the phases of one `prepare()` or `execute()` call and reports them to the sink
+         *  when it is destroyed. Does nothing if the sink is empty.
+         */
+        struct execute_tracer {
+            execute_tracer(const execute_event_sink& sink_, sqlite3_stmt* stmt_, execute_phase first) :
+                sink(sink_ ? &sink_ : nullptr), stmt(stmt_), current(first) {
+                if(this->sink) {
+                    this->start = std::chrono::steady_clock::now();
+                }
+            }
+
+            ~execute_tracer() {
+                if(!this->sink) {
+                    return;
+                }
+                this->phase(this->current);
+                for(size_t i = 0; i < this->durations.size(); ++i) {
+                    if(this->ran[i]) {
+                        (*this->sink)({static_cast<execute_phase>(i), this->durations[i], this->stmt});
+                    }
+                }
+            }
+
+            /**
+             *  Ends the current phase and starts `next`.
+             */
+            void phase(execute_phase next) {
+                if(!this->sink) {
+                    return;
+                }
+                const auto now = std::chrono::steady_clock::now();
+                const auto index = static_cast<size_t>(this->current);
+                this->durations[index] += now - this->start;
+                this->ran[index] = true;
+                this->current = next;
+                this->start = now;
+            }
+
+            void set_stmt(sqlite3_stmt* stmt_) {
+                this->stmt = stmt_;
+            }
+
+            /**
+             *  Wraps a row callback passed to `perform_step(s)` so that it is measured as `extract`.
+             */
+            template<class L>
+            auto extracting(L lambda) {
+                return [this, lambda = std::move(lambda)](sqlite3_stmt* stmt) mutable -> decltype(auto) {
+                    this->phase(execute_phase::extract);
+                    step_restorer restorer{*this};
+                    return lambda(stmt);
+                };
+            }
+
+          protected:
+            struct step_restorer {
+                execute_tracer& tracer;
+
+                ~step_restorer() {
+                    this->tracer.phase(execute_phase::step);
+                }
+            };
+
+            const execute_event_sink* sink;
+            sqlite3_stmt* stmt;
+            execute_phase current;
+            std::chrono::steady_clock::time_point start;
+            std::array<std::chrono::nanoseconds, 5> durations{};
+            std::array<bool, 5> ran{};
+        };
+#else
+        /**
+         *  No-op tracer used unless `SQLITE_ORM_ENABLE_EXECUTE_TRACING` is defined. All its calls are inlined away.
+         */
+        struct execute_tracer {
+            void phase(execute_phase) {}
+
+            void set_stmt(sqlite3_stmt*) {}
+
+            template<class L>
+            L&& extracting(L&& lambda) {
+                return std::forward<L>(lambda);
+            }
+        };
+#endif
+    }
+}
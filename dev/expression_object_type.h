@@ -34,6 +34,13 @@ namespace sqlite_orm {
             using type = typename replace_range_t<std::reference_wrapper<It>, L, O>::object_type;
         };
 
+#if SQLITE_VERSION_NUMBER >= 3024000
+        template<class It, class L, class O, class U>
+        struct expression_object_type<upsert_range_t<It, L, O, U>> {
+            using type = O;
+        };
+#endif
+
         template<class T, class... Ids>
         struct expression_object_type<remove_t<T, Ids...>> {
             using type = T;
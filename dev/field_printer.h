@@ -1,18 +1,18 @@
 #pragma once
 
-#include <locale>  // std::wstring_convert
 #include <string>  //  std::string
 #include <sstream>  //  std::stringstream
 #include <vector>  //  std::vector
 #include <memory>  //  std::shared_ptr, std::unique_ptr
-#ifndef SQLITE_ORM_OMITS_CODECVT
-#include <codecvt>  //  std::codecvt_utf8_utf16
-#endif  //  SQLITE_ORM_OMITS_CODECVT
 #include "functional/cxx_optional.h"
+#include "wide_string.h"
+#include "functional/cxx_memory_resource.h"
 
 #include "functional/cxx_universal.h"
 #include "functional/cxx_type_traits_polyfill.h"
 #include "is_std_ptr.h"
+#include "byte_vector.h"
+#include "stored_value.h"
 
 namespace sqlite_orm {
 
@@ -97,15 +97,61 @@ namespace sqlite_orm {
             return ss.str();
         }
     };
+
+    /**
+     *  Specialization for vectors and arrays of `unsigned char` or `std::byte`, printed like std::vector<char>.
+     */
+    template<class T>
+    struct field_printer<T, std::enable_if_t<internal::is_byte_vector_v<T> || internal::is_byte_array_v<T>>> {
+        std::string operator()(const T& t) const {
+            std::stringstream ss;
+            ss << std::hex;
+            for(auto c: t) {
+                ss << char(c);
+            }
+            return ss.str();
+        }
+    };
+
+    /**
+     *  Specialization for scoped enums and std::chrono types, printed as the value they are stored as.
+     */
+    template<class T>
+    struct field_printer<T, std::enable_if_t<internal::is_stored_value_v<T>>> {
+        using stored_value = internal::stored_value<T>;
+
+        std::string operator()(const T& t) const {
+            return field_printer<typename stored_value::stored_type>{}(stored_value::to_stored(t));
+        }
+    };
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+    template<>
+    struct field_printer<std::pmr::string, void> {
+        std::string operator()(const std::pmr::string& string) const {
+            return {string.data(), string.size()};
+        }
+    };
+
+    template<>
+    struct field_printer<std::pmr::vector<char>, void> {
+        std::string operator()(const std::pmr::vector<char>& t) const {
+            std::stringstream ss;
+            ss << std::hex;
+            for(auto c: t) {
+                ss << c;
+            }
+            return ss.str();
+        }
+    };
+#endif
 #ifndef SQLITE_ORM_OMITS_CODECVT
     /**
-     *  Specialization for std::wstring (UTF-16 assumed).
+     *  Specialization for std::wstring, UTF-16 or UTF-32 depending on the size of `wchar_t`.
      */
     template<class T>
     struct field_printer<T, std::enable_if_t<std::is_base_of<std::wstring, T>::value>> {
         std::string operator()(const std::wstring& wideString) const {
-            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-            return converter.to_bytes(wideString);
+            return internal::to_utf8(wideString);
         }
     };
 #endif  //  SQLITE_ORM_OMITS_CODECVT
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "functional/cxx_universal.h"
+
+#ifdef SQLITE_ORM_CLASSTYPE_TEMPLATE_ARGS_SUPPORTED
+#include <cstddef>  //  size_t
+#include <string>  //  std::string
+#include <string_view>  //  std::string_view
+
+namespace sqlite_orm {
+    namespace internal {
+
+        /**
+         *  Name of a table or column given as a template argument, e.g. `make_table<"users">(...)`. Its characters
+         *  are part of the template argument, which lives in static storage, and are checked at compile time.
+         */
+        template<size_t N>
+        struct fixed_name {
+            char text[N];
+
+            consteval fixed_name(const char (&name)[N]) {
+                for(size_t i = 0; i < N; ++i) {
+                    if(i + 1 < N && name[i] == '\0') {
+                        throw "Names can't contain NUL characters";
+                    }
+                    this->text[i] = name[i];
+                }
+            }
+
+            static constexpr size_t size() {
+                return N - 1;
+            }
+
+            constexpr std::string_view view() const {
+                return {this->text, N - 1};
+            }
+
+            std::string str() const {
+                return std::string{this->text, N - 1};
+            }
+        };
+    }
+}
+#endif
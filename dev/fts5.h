@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cctype>  //  std::tolower
+#include <memory>  //  std::make_shared
+#include <string>  //  std::string
+#include <tuple>  //  std::tuple
+#include <type_traits>  //  std::tuple_element_t
+#include <utility>  //  std::move, std::forward
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "serialize_result_type.h"
+#include "fts5_options.h"
+#include "conditions.h"
+#include "core_functions.h"
+#include "table.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  The FTS5 table of T as the first argument of `MATCH` and of the FTS5 auxiliary functions, which is
+         *  the hidden column having the name of the table.
+         */
+        template<class T>
+        struct fts5_table_t {
+            using type = T;
+        };
+
+        struct match_string {
+            operator std::string() const {
+                return "MATCH";
+            }
+        };
+
+        /**
+         *  X MATCH Y
+         */
+        template<class L, class R>
+        struct match_t : binary_condition<L, R, match_string, bool> {
+            using binary_condition<L, R, match_string, bool>::binary_condition;
+        };
+
+        struct bm25_string {
+            serialize_result_type serialize() const {
+                return "bm25";
+            }
+        };
+
+        struct highlight_string {
+            serialize_result_type serialize() const {
+                return "highlight";
+            }
+        };
+
+        struct snippet_string {
+            serialize_result_type serialize() const {
+                return "snippet";
+            }
+        };
+
+        /**
+         *  Whether `name` is one of the names of the rowid, which a FTS5 table doesn't declare as a column.
+         */
+        inline bool is_rowid_alias(std::string name) {
+            for(auto& c: name) {
+                c = char(std::tolower(static_cast<unsigned char>(c)));
+            }
+            return name == "rowid" || name == "oid" || name == "_rowid_";
+        }
+
+        /**
+         *  Names of the columns of the FTS5 table `table`, that is the mapped columns but its rowid.
+         */
+        template<class Table>
+        std::vector<std::string> fts5_column_names(const Table& table) {
+            std::vector<std::string> res;
+            table.for_each_column([&res](auto& column) {
+                if(!is_rowid_alias(column.name)) {
+                    res.push_back(column.name);
+                }
+            });
+            return res;
+        }
+
+        /**
+         *  Whether the FTS5 table `table` is an external content table.
+         */
+        template<class Table>
+        bool is_fts5_external_content(const Table& table) {
+            return table.fts5 && !table.fts5->contentless && !table.fts5->content.empty();
+        }
+    }
+
+    /**
+     *  Maps an FTS5 virtual table, which `sync_schema()` creates by `CREATE VIRTUAL TABLE ... USING fts5(...)`.
+     *  The columns only need names, FTS5 ignores their types and constraints. A column named "rowid" maps the
+     *  rowid of the table, e.g. `make_column("rowid", &Document::id, primary_key())` to get and remove rows by
+     *  it. An existing FTS5 table is dropped and created again if its module arguments differ from the mapped
+     *  ones, see `fts5_options` for external content tables.
+     *  Example: make_fts5_table("documents_fts", {}, make_column("rowid", &Document::id, primary_key()),
+     *                           make_column("title", &Document::title), make_column("body", &Document::body))
+     */
+    template<class... Cs, class T = typename std::tuple_element_t<0, std::tuple<Cs...>>::object_type>
+    internal::table_t<T, false, Cs...> make_fts5_table(std::string name, fts5_options options, Cs... args) {
+        auto res = make_table<T>(move(name), std::forward<Cs>(args)...);
+        res.fts5 = std::make_shared<const fts5_options>(std::move(options));
+        return res;
+    }
+
+    /**
+     *  `make_fts5_table()` with the mapped object type being explicitly specified.
+     */
+    template<class T, class... Cs>
+    internal::table_t<T, false, Cs...> make_fts5_table(std::string name, fts5_options options, Cs... args) {
+        auto res = make_table<T>(move(name), std::forward<Cs>(args)...);
+        res.fts5 = std::make_shared<const fts5_options>(std::move(options));
+        return res;
+    }
+
+    /**
+     *  The full-text query `query` on all columns of the FTS5 table of T.
+     *  Example: storage.get_all<Document>(where(match<Document>("sqlite AND orm")))
+     */
+    template<class T, class X>
+    internal::match_t<internal::fts5_table_t<T>, X> match(X query) {
+        return {{}, std::move(query)};
+    }
+
+    /**
+     *  The full-text query `query` on the column `column` of an FTS5 table or, with a custom geometry made
+     *  by `rtree_query()`, the rows of an R*Tree table the geometry selects.
+     *  Example: storage.get_all<Document>(where(match(&Document::title, "orm")))
+     */
+    template<class F, class O, class X>
+    internal::match_t<F O::*, X> match(F O::*column, X query) {
+        return {column, std::move(query)};
+    }
+
+    /**
+     *  The BM25 rank of the current match of the FTS5 table of T, the better the lower. The weights of the
+     *  columns default to 1.
+     *  Example: storage.get_all<Document>(where(match<Document>("orm")), order_by(bm25<Document>(10.0, 1.0)))
+     */
+    template<class T, class... Weights>
+    internal::built_in_function_t<double, internal::bm25_string, internal::fts5_table_t<T>, Weights...>
+    bm25(Weights... weights) {
+        return {std::tuple<internal::fts5_table_t<T>, Weights...>{internal::fts5_table_t<T>{}, std::forward<Weights>(weights)...}};
+    }
+
+    /**
+     *  The text of the column with index `columnIndex` in the FTS5 table of T with the phrases of the current
+     *  match enclosed by `open` and `close`.
+     *  Example: highlight<Document>(0, "<b>", "</b>")
+     */
+    template<class T, class I, class O, class C>
+    internal::built_in_function_t<std::string, internal::highlight_string, internal::fts5_table_t<T>, I, O, C>
+    highlight(I columnIndex, O open, C close) {
+        return {std::tuple<internal::fts5_table_t<T>, I, O, C>{internal::fts5_table_t<T>{},
+                                                               std::forward<I>(columnIndex),
+                                                               std::forward<O>(open),
+                                                               std::forward<C>(close)}};
+    }
+
+    /**
+     *  A fragment of at most `maxTokens` tokens of the column with index `columnIndex` in the FTS5 table of T,
+     *  -1 for any column, with the phrases of the current match enclosed by `open` and `close` and `ellipsis`
+     *  where the text was cut.
+     *  Example: snippet<Document>(-1, "<b>", "</b>", "...", 16)
+     */
+    template<class T, class I, class O, class C, class E, class N>
+    internal::built_in_function_t<std::string, internal::snippet_string, internal::fts5_table_t<T>, I, O, C, E, N>
+    snippet(I columnIndex, O open, C close, E ellipsis, N maxTokens) {
+        return {std::tuple<internal::fts5_table_t<T>, I, O, C, E, N>{internal::fts5_table_t<T>{},
+                                                                     std::forward<I>(columnIndex),
+                                                                     std::forward<O>(open),
+                                                                     std::forward<C>(close),
+                                                                     std::forward<E>(ellipsis),
+                                                                     std::forward<N>(maxTokens)}};
+    }
+}
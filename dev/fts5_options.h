@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+
+namespace sqlite_orm {
+
+    /**
+     *  The options of an FTS5 virtual table made by `make_fts5_table()`. Empty options are left out of
+     *  `CREATE VIRTUAL TABLE ... USING fts5(...)`, so FTS5 uses its defaults.
+     */
+    struct fts5_options {
+
+        /**
+         *  Name of an ordinary table holding the indexed text, whose columns have the names of the FTS5 columns.
+         *  The FTS5 table then stores only its index. `sync_schema()` keeps the index in sync with the content
+         *  table by triggers, so the FTS5 table has to be mapped before the content table, like indexes.
+         */
+        std::string content;
+
+        /**
+         *  Column of `content` the rowids of the FTS5 table refer to, its rowid if empty.
+         */
+        std::string content_rowid;
+
+        /**
+         *  The FTS5 table stores only its index and its columns read as null, e.g. to search documents kept
+         *  elsewhere by their rowids.
+         */
+        bool contentless = false;
+
+        /**
+         *  Whether `sync_schema()` creates the triggers updating the index of an external content table,
+         *  named after the FTS5 table with the suffixes "_ai", "_ad" and "_au".
+         */
+        bool sync_triggers = true;
+
+        /**
+         *  Tokenizer and its arguments, e.g. "porter unicode61".
+         */
+        std::string tokenize;
+
+        /**
+         *  Lengths of the prefixes to index for prefix queries, e.g. "2 3".
+         */
+        std::string prefix;
+
+        /**
+         *  "full", "column" or "none".
+         */
+        std::string detail;
+
+        /**
+         *  Names of the columns which are stored but not indexed.
+         */
+        std::vector<std::string> unindexed;
+    };
+}
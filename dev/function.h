@@ -5,6 +5,7 @@
 #include <string>  //  std::string
 #include <tuple>  //  std::tuple
 #include <functional>  //  std::function
+#include <memory>  //  std::unique_ptr
 #include <algorithm>  //  std::min
 #include <utility>  //  std::move, std::forward
 
@@ -32,6 +33,17 @@ namespace sqlite_orm {
             std::function<int*()> create;
             void (*destroy)(int*) = nullptr;
 
+            /**
+             *  Function object shared by all calls if the function class allows it, otherwise null
+             *  and a new object is created for every call.
+             */
+            std::unique_ptr<int, void (*)(int*)> instance{nullptr, nullptr};
+
+            /**
+             *  `SQLITE_DETERMINISTIC`, `SQLITE_DIRECTONLY` or `SQLITE_INNOCUOUS` flags the function is registered with.
+             */
+            int flags = 0;
+
 #ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
             user_defined_function_base(decltype(name) name_,
                                        decltype(argumentsCount) argumentsCount_,
@@ -58,6 +70,12 @@ namespace sqlite_orm {
             func_call step;
             final_call finalCall;
 
+            /**
+             *  Set only for aggregate functions that can be used as window functions (see `is_window_function_v`).
+             */
+            func_call inverse;
+            final_call valueCall;
+
             user_defined_aggregate_function_t(decltype(name) name_,
                                               int argumentsCount_,
                                               decltype(create) create_,
@@ -94,6 +112,29 @@ namespace sqlite_orm {
                              std::enable_if_t<std::is_member_function_pointer<aggregate_fin_function_t<F>>::value>>> =
             true;
 
+        template<class F>
+        using aggregate_inverse_function_t = decltype(&F::inverse);
+
+        template<class F>
+        using aggregate_value_function_t = decltype(&F::value);
+
+        /**
+         *  An aggregate function class with `inverse` (removes a row from the window frame, takes the same arguments
+         *  as `step`) and `value` (returns the current result without finalizing) member functions
+         *  is registered as an aggregate window function.
+         */
+        template<class F, class = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_window_function_v = false;
+        template<class F>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_window_function_v<
+            F,
+            polyfill::void_t<aggregate_inverse_function_t<F>,
+                             aggregate_value_function_t<F>,
+                             std::enable_if_t<is_aggregate_function_v<F>>,
+                             std::enable_if_t<std::is_member_function_pointer<aggregate_inverse_function_t<F>>::value>,
+                             std::enable_if_t<std::is_member_function_pointer<aggregate_value_function_t<F>>::value>>> =
+            true;
+
         template<class T>
         struct member_function_arguments;
 
@@ -102,6 +143,7 @@ namespace sqlite_orm {
             using member_function_type = R (O::*)(Args...) const;
             using tuple_type = std::tuple<std::decay_t<Args>...>;
             using return_type = R;
+            static constexpr bool is_const = true;
         };
 
         template<class O, class R, class... Args>
@@ -109,6 +151,7 @@ namespace sqlite_orm {
             using member_function_type = R (O::*)(Args...);
             using tuple_type = std::tuple<std::decay_t<Args>...>;
             using return_type = R;
+            static constexpr bool is_const = false;
         };
 
         template<class F, class SFINAE = void>
@@ -129,12 +172,68 @@ namespace sqlite_orm {
         template<class F>
         struct callable_arguments : callable_arguments_impl<F> {};
 
+        template<class F, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_deterministic_function_v = false;
+        template<class F>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_deterministic_function_v<F, polyfill::void_t<decltype(F::deterministic)>> =
+            F::deterministic;
+
+        template<class F, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_direct_only_function_v = false;
+        template<class F>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_direct_only_function_v<F, polyfill::void_t<decltype(F::direct_only)>> =
+            F::direct_only;
+
+        template<class F, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_innocuous_function_v = false;
+        template<class F>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_innocuous_function_v<F, polyfill::void_t<decltype(F::innocuous)>> =
+            F::innocuous;
+
+        /**
+         *  Flags for `sqlite3_create_function_v2` taken from static members of a function class:
+         *  `deterministic` - same arguments always give the same result (`SQLITE_DETERMINISTIC`),
+         *  lets SQLite factor calls out of loops and use the function in indexes on expressions and partial indexes;
+         *  `direct_only` - may not be used in triggers, views, CHECK constraints and indexes (`SQLITE_DIRECTONLY`);
+         *  `innocuous` - has no side effects and is safe to use in the schema (`SQLITE_INNOCUOUS`).
+         */
+        template<class F>
+        constexpr int user_defined_function_flags() {
+            return (is_deterministic_function_v<F> ? SQLITE_DETERMINISTIC : 0)
+#if SQLITE_VERSION_NUMBER >= 3031000
+                   | (is_direct_only_function_v<F> ? SQLITE_DIRECTONLY : 0) |
+                   (is_innocuous_function_v<F> ? SQLITE_INNOCUOUS : 0)
+#endif
+                ;
+        }
+
+        /**
+         *  A scalar function object can be shared by all calls if it has no state or its call operator is const.
+         */
+        template<class F>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_reusable_scalar_function_v =
+            std::is_empty<F>::value || member_function_arguments<scalar_call_function_t<F>>::is_const;
+
+        template<class F, class W>
+        struct filtered_aggregate_function;
+
+        template<class C>
+        struct where_t;
+
         template<class F, class... Args>
         struct function_call {
             using function_type = F;
             using args_tuple = std::tuple<Args...>;
 
             args_tuple args;
+
+            /**
+             *  Aggregates only the rows `wh` holds for, like the built-in aggregate functions: `FILTER (WHERE ...)`.
+             */
+            template<class W, class Fn = F, std::enable_if_t<is_aggregate_function_v<Fn>, bool> = true>
+            filtered_aggregate_function<function_call, W> filter(where_t<W> wh) const {
+                return {*this, std::move(wh.expression)};
+            }
         };
 
         template<class T>
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>  //  std::byte
+
+#if __cpp_lib_byte >= 201603L
+#define SQLITE_ORM_BYTE_SUPPORTED
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "cxx_core_features.h"
+
+#if __cpp_impl_coroutine >= 201902L && SQLITE_ORM_HAS_INCLUDE(<coroutine>)
+#include <coroutine>
+#endif
+
+#if __cpp_lib_coroutine >= 201902L && SQLITE_ORM_HAS_INCLUDE(<ranges>)
+#include <ranges>
+#endif
+
+#if __cpp_lib_coroutine >= 201902L && __cpp_lib_ranges >= 201911L
+#define SQLITE_ORM_COROUTINES_SUPPORTED
+#endif
+
+#if defined(SQLITE_ORM_COROUTINES_SUPPORTED) && SQLITE_ORM_HAS_INCLUDE(<generator>)
+#include <generator>
+#endif
+
+#if __cpp_lib_generator >= 202207L
+#define SQLITE_ORM_GENERATOR_SUPPORTED
+#endif
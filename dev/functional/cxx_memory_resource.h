@@ -0,0 +1,11 @@
+#pragma once
+
+#include "cxx_core_features.h"
+
+#if SQLITE_ORM_HAS_INCLUDE(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#if __cpp_lib_memory_resource >= 201603L
+#define SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+#endif
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <sqlite3.h>
+
+#include "column.h"
+#include "statement_binder.h"
+#include "virtual_table.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  A row of `generate_series`, the integers from `start` to `stop` by `step`, which are given as equality
+     *  constraints, e.g. `where(c(&generate_series::start) == 1 and c(&generate_series::stop) == 100)`.
+     *  `step` defaults to 1 and `stop` to 4294967295 like in the generate_series extension of SQLite.
+     */
+    struct generate_series {
+        int64 value = 0;
+        int64 start = 0;
+        int64 stop = 0;
+        int64 step = 0;
+    };
+
+    namespace internal {
+
+        struct generate_series_module {
+            enum : int {
+                start_argument = 1,
+                stop_argument = 2,
+                step_argument = 4,
+            };
+
+            struct cursor_type {
+                sqlite3_int64 value = 0;
+                sqlite3_int64 start = 0;
+                sqlite3_int64 stop = 4294967295;
+                sqlite3_int64 step = 1;
+
+                void filter(int idxNum, const char*, int, sqlite3_value** argv) {
+                    int argument = 0;
+                    if(idxNum & start_argument) {
+                        this->start = sqlite3_value_int64(argv[argument++]);
+                    }
+                    if(idxNum & stop_argument) {
+                        this->stop = sqlite3_value_int64(argv[argument++]);
+                    }
+                    if(idxNum & step_argument) {
+                        this->step = sqlite3_value_int64(argv[argument++]);
+                    }
+                    if(this->step == 0) {
+                        this->step = 1;
+                    }
+                    this->value = this->start;
+                }
+
+                bool eof() const {
+                    return this->step > 0 ? this->value > this->stop : this->value < this->stop;
+                }
+
+                void next() {
+                    this->value += this->step;
+                }
+
+                void column(sqlite3_context* context, int index) const {
+                    const sqlite3_int64 values[] = {this->value, this->start, this->stop, this->step};
+                    sqlite3_result_int64(context, values[index]);
+                }
+
+                sqlite3_int64 rowid() const {
+                    return (this->value - this->start) / this->step + 1;
+                }
+            };
+
+            cursor_type open() const {
+                return {};
+            }
+
+            /**
+             *  Uses the equality constraints on `start`, `stop` and `step`, passing them in this order.
+             */
+            int best_index(sqlite3_index_info& info) const {
+                int constraintIndexes[] = {-1, -1, -1};
+                for(int i = 0; i < info.nConstraint; ++i) {
+                    auto& constraint = info.aConstraint[i];
+                    if(constraint.usable && constraint.op == SQLITE_INDEX_CONSTRAINT_EQ && constraint.iColumn >= 1 &&
+                       constraint.iColumn <= 3) {
+                        constraintIndexes[constraint.iColumn - 1] = i;
+                    }
+                }
+                int argument = 0;
+                info.idxNum = 0;
+                for(int column = 0; column < 3; ++column) {
+                    if(constraintIndexes[column] != -1) {
+                        auto& usage = info.aConstraintUsage[constraintIndexes[column]];
+                        usage.argvIndex = ++argument;
+                        usage.omit = 1;
+                        info.idxNum |= 1 << column;
+                    }
+                }
+                const int bounds = start_argument | stop_argument;
+                const bool bounded = (info.idxNum & bounds) == bounds;
+                info.estimatedCost = bounded ? 1000 : 2147483647;
+                info.estimatedRows = bounded ? 1000 : 2147483647;
+                if(info.nOrderBy == 1 && info.aOrderBy[0].iColumn == 0 && !info.aOrderBy[0].desc &&
+                   !(info.idxNum & step_argument)) {
+                    info.orderByConsumed = 1;
+                }
+                return SQLITE_OK;
+            }
+        };
+    }
+
+    inline auto make_generate_series_table() {
+        return make_virtual_table("generate_series",
+                                  internal::generate_series_module{},
+                                  make_column("value", &generate_series::value),
+                                  make_column("start", &generate_series::start),
+                                  make_column("stop", &generate_series::stop),
+                                  make_column("step", &generate_series::step));
+    }
+}
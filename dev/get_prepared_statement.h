@@ -29,6 +29,18 @@ namespace sqlite_orm {
         return std::get<N>(statement.expression.range);
     }
 
+#if SQLITE_VERSION_NUMBER >= 3024000
+    template<int N, class It, class L, class O, class U>
+    auto& get(internal::prepared_statement_t<internal::upsert_range_t<It, L, O, U>>& statement) {
+        return std::get<N>(statement.expression.range);
+    }
+
+    template<int N, class It, class L, class O, class U>
+    const auto& get(const internal::prepared_statement_t<internal::upsert_range_t<It, L, O, U>>& statement) {
+        return std::get<N>(statement.expression.range);
+    }
+#endif
+
     template<int N, class T, class... Ids>
     auto& get(internal::prepared_statement_t<internal::get_t<T, Ids...>>& statement) {
         return internal::get_ref(std::get<N>(statement.expression.ids));
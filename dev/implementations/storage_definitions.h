@@ -9,6 +9,7 @@
 #include <algorithm>  //  std::find_if, std::ranges::find
 
 #include "../dbstat.h"
+#include "../json_each.h"
 #include "../util.h"
 #include "../serializing_util.h"
 #include "../storage.h"
@@ -18,16 +19,31 @@ namespace sqlite_orm {
 
         template<class... DBO>
         template<class Table, satisfies<is_table, Table>>
-        sync_schema_result storage_t<DBO...>::sync_table(const Table& table, sqlite3* db, bool preserve) {
+        sync_schema_result storage_t<DBO...>::sync_table(const Table& table,
+                                                          sqlite3* db,
+                                                          bool preserve,
+                                                          const schema_snapshot& snapshot) {
 #ifdef SQLITE_ENABLE_DBSTAT_VTAB
-            if(std::is_same<Table, dbstat>::value) {
+            if(std::is_same<typename Table::object_type, dbstat>::value) {
                 return sync_schema_result::already_in_sync;
             }
 #endif  //  SQLITE_ENABLE_DBSTAT_VTAB
+#ifdef SQLITE_ENABLE_JSON1
+            if(std::is_same<typename Table::object_type, json_each>::value ||
+               std::is_same<typename Table::object_type, json_tree>::value) {
+                return sync_schema_result::already_in_sync;
+            }
+#endif  //  SQLITE_ENABLE_JSON1
+            if(table.virtual_module) {
+                return sync_schema_result::already_in_sync;
+            }
+            if(table.fts5 || table.rtree) {
+                return this->sync_virtual_table(db, table, snapshot);
+            }
             auto res = sync_schema_result::already_in_sync;
             bool attempt_to_preserve = true;
 
-            auto schema_stat = this->schema_status(table, db, preserve, &attempt_to_preserve);
+            auto schema_stat = this->schema_status(table, db, preserve, &attempt_to_preserve, snapshot);
             if(schema_stat != sync_schema_result::already_in_sync) {
                 if(schema_stat == sync_schema_result::new_table_created) {
                     this->create_table(db, table.name, table);
@@ -41,7 +57,8 @@ namespace sqlite_orm {
                         auto storageTableInfo = table.get_table_info();
 
                         //  now get current table info from db using `PRAGMA table_xinfo` query..
-                        auto dbTableInfo = this->pragma.table_xinfo(table.name);  // should include generated columns
+                        //  should include generated columns
+                        auto dbTableInfo = this->db_table_xinfo(table.name, table.schema_name, snapshot);
 
                         //  this vector will contain pointers to columns that gotta be added..
                         std::vector<const table_xinfo*> columnsToAdd;
@@ -51,7 +68,7 @@ namespace sqlite_orm {
                         if(schema_stat == sync_schema_result::old_columns_removed) {
 #if SQLITE_VERSION_NUMBER >= 3035000  //  DROP COLUMN feature exists (v3.35.0)
                             for(auto& tableInfo: dbTableInfo) {
-                                this->drop_column(db, table.name, tableInfo.name);
+                                this->drop_column(db, table.schema_name, table.name, tableInfo.name);
                             }
                             res = sync_schema_result::old_columns_removed;
 #else
@@ -63,11 +80,11 @@ namespace sqlite_orm {
 
                         if(schema_stat == sync_schema_result::new_columns_added) {
                             for(const table_xinfo* colInfo: columnsToAdd) {
-                                table.for_each_column([this, colInfo, &tableName = table.name, db](auto& column) {
+                                table.for_each_column([this, colInfo, &table, db](auto& column) {
                                     if(column.name != colInfo->name) {
                                         return;
                                     }
-                                    this->add_column(db, tableName, column);
+                                    this->add_column(db, table.schema_name, table.name, column);
                                 });
                             }
                             res = sync_schema_result::new_columns_added;
@@ -84,7 +101,8 @@ namespace sqlite_orm {
                         }
                     } else if(schema_stat == sync_schema_result::dropped_and_recreated) {
                         //  now get current table info from db using `PRAGMA table_xinfo` query..
-                        auto dbTableInfo = this->pragma.table_xinfo(table.name);  // should include generated columns
+                        //  should include generated columns
+                        auto dbTableInfo = this->db_table_xinfo(table.name, table.schema_name, snapshot);
                         auto storageTableInfo = table.get_table_info();
 
                         //  this vector will contain pointers to columns that gotta be added..
@@ -133,10 +151,10 @@ namespace sqlite_orm {
             });
 
             std::stringstream ss;
-            ss << "INSERT INTO " << streaming_identifier(destinationTableName) << " ("
+            ss << "INSERT INTO " << streaming_identifier(table.schema_name, destinationTableName, std::string{}) << " ("
                << streaming_identifiers(columnNames) << ") "
-               << "SELECT " << streaming_identifiers(columnNames) << " FROM " << streaming_identifier(sourceTableName)
-               << std::flush;
+               << "SELECT " << streaming_identifiers(columnNames) << " FROM "
+               << streaming_identifier(table.schema_name, sourceTableName, std::string{}) << std::flush;
             perform_void_exec(db, ss.str());
         }
     }
@@ -28,7 +28,7 @@ namespace sqlite_orm {
                                  column.name,
                                  type_printer<field_type>().print(),
                                  column.is_not_null(),
-                                 dft,
+                                 move(dft),
                                  column.template is<is_primary_key>(),
                                  column.is_generated());
             });
@@ -0,0 +1,445 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cctype>  //  std::isspace
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+#include <map>  //  std::map
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <atomic>  //  std::atomic
+#include <algorithm>  //  std::find, std::find_if, std::sort
+#include <initializer_list>  //  std::initializer_list
+#include <system_error>  //  std::system_error
+#include <utility>  //  std::move, std::pair
+#include <functional>  //  std::function
+
+#include "util.h"
+#include "query_plan.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Settings of `storage.enable_index_advisor()`.
+     */
+    struct index_advisor_options {
+
+        /**
+         *  Number of statement shapes kept. Executions of new shapes are not counted once it is reached.
+         */
+        size_t max_shapes = 256;
+
+        /**
+         *  Called after every execution that filled an automatic index, SQLite's transient index for a join or
+         *  a subquery without a usable index, with the SQL text of the statement and the number of rows
+         *  `SQLITE_STMTSTATUS_AUTOINDEX` counted. SQLite builds the index anew on every execution, so this is the
+         *  place to log such statements in an audit build; `suggest_indexes()` names the permanent index to add.
+         *  Called from the thread that executed the statement, after it finished.
+         */
+        std::function<void(const std::string& sql, int rows)> on_automatic_index;
+    };
+
+    /**
+     *  An index suggested by `storage.suggest_indexes()` for statements whose plan scans a table or sorts
+     *  its rows in a temporary b-tree.
+     */
+    struct index_suggestion {
+        std::string table;
+
+        /**
+         *  Indexed columns: the ones compared for equality first, then one compared by range or the ORDER BY
+         *  columns.
+         */
+        std::vector<std::string> columns;
+
+        /**
+         *  The query plan details the index would avoid, e.g. `SCAN users`.
+         */
+        std::vector<std::string> reasons;
+
+        /**
+         *  SQL texts with placeholders of the recorded statements the index is suggested for.
+         */
+        std::vector<std::string> queries;
+
+        /**
+         *  Number of recorded executions of `queries`.
+         */
+        size_t executions = 0;
+
+        /**
+         *  Number of `executions` that filled an automatic index, which the suggested index replaces.
+         */
+        size_t automatic_index_executions = 0;
+
+        std::string name() const {
+            std::string result = "idx_" + this->table;
+            for(auto& column: this->columns) {
+                result += '_';
+                result += column;
+            }
+            return result;
+        }
+
+        /**
+         *  The CREATE INDEX statement, e.g. `CREATE INDEX "idx_users_name" ON "users" ("name")`.
+         */
+        std::string sql() const {
+            std::string result = "CREATE INDEX " + quote_identifier(this->name()) + " ON " +
+                                 quote_identifier(this->table) + " (";
+            for(size_t i = 0; i < this->columns.size(); ++i) {
+                if(i) {
+                    result += ", ";
+                }
+                result += quote_identifier(this->columns[i]);
+            }
+            return result + ")";
+        }
+
+        /**
+         *  The index as an argument of `make_storage()`, e.g. `make_index("idx_users_name", &T::name)`, where
+         *  `T` stands for the class mapped to the table and members are assumed to be named like the columns.
+         */
+        std::string cpp() const {
+            std::string result = "make_index(\"" + this->name() + "\"";
+            for(auto& column: this->columns) {
+                result += ", &T::" + column;
+            }
+            return result + ")";
+        }
+    };
+
+    namespace internal {
+
+        /**
+         *  The columns of a statement made by sqlite_orm a plan node refers to, found in its SQL text.
+         */
+        struct index_candidate_columns {
+            std::vector<std::string> equal;
+            std::vector<std::string> range;
+            std::vector<std::string> orderBy;
+        };
+
+        /**
+         *  Returns the part of `sql` after the first `keyword` up to the first of `ends` following it.
+         */
+        inline std::string sql_clause(const std::string& sql,
+                                      const std::string& keyword,
+                                      std::initializer_list<const char*> ends) {
+            auto begin = sql.find(keyword);
+            if(begin == std::string::npos) {
+                return {};
+            }
+            begin += keyword.size();
+            auto end = sql.size();
+            for(auto ending: ends) {
+                auto position = sql.find(ending, begin);
+                if(position != std::string::npos && position < end) {
+                    end = position;
+                }
+            }
+            return sql.substr(begin, end - begin);
+        }
+
+        /**
+         *  Calls `onColumn(columnName, rest)` for every column of `table` in `clause`, `rest` being the text that
+         *  follows the column. Columns are qualified like `"users"."name"`, or not qualified at all if `unqualified`,
+         *  which single table UPDATE and DELETE statements are.
+         */
+        template<class F>
+        void for_each_column_of(const std::string& clause, const std::string& table, bool unqualified, F onColumn) {
+            const std::string qualifier = quote_identifier(table) + ".";
+            for(size_t position = clause.find('"'); position != std::string::npos;) {
+                bool qualified = clause.compare(position, qualifier.size(), qualifier) == 0;
+                auto nameBegin = qualified ? position + qualifier.size() : position;
+                if(nameBegin >= clause.size() || clause[nameBegin] != '"') {
+                    position = clause.find('"', position + 1);
+                    continue;
+                }
+                std::string name;
+                auto i = nameBegin + 1;
+                for(; i < clause.size(); ++i) {
+                    if(clause[i] == '"') {
+                        if(i + 1 < clause.size() && clause[i + 1] == '"') {
+                            name += '"';
+                            ++i;
+                        } else {
+                            break;
+                        }
+                    } else {
+                        name += clause[i];
+                    }
+                }
+                if(i >= clause.size()) {
+                    break;
+                }
+                ++i;
+                const bool otherQualifier = !qualified && i < clause.size() && clause[i] == '.';
+                if(otherQualifier) {
+                    //  skip the column of another table
+                    i = clause.find('"', i + 2);
+                    i = i == std::string::npos ? clause.size() : i + 1;
+                } else if(qualified || unqualified) {
+                    onColumn(name, clause.substr(i));
+                }
+                position = clause.find('"', i);
+            }
+        }
+
+        /**
+         *  Finds the columns of `table` `sql` compares with `=`, `IN` or `IS` and with `<`, `>` or `BETWEEN` in
+         *  its WHERE clause, and the ones it is ordered by.
+         */
+        inline index_candidate_columns find_index_candidate_columns(const std::string& sql, const std::string& table) {
+            index_candidate_columns result;
+            const bool unqualified = sql.compare(0, 7, "UPDATE ") == 0 || sql.compare(0, 7, "DELETE ") == 0;
+            auto addUnique = [](std::vector<std::string>& columns, const std::string& column) {
+                if(std::find(columns.begin(), columns.end(), column) == columns.end()) {
+                    columns.push_back(column);
+                }
+            };
+            auto where = sql_clause(sql, " WHERE ", {" GROUP BY ", " ORDER BY ", " LIMIT ", " HAVING "});
+            for_each_column_of(where, table, unqualified, [&](const std::string& column, const std::string& rest) {
+                size_t i = 0;
+                while(i < rest.size() && std::isspace(static_cast<unsigned char>(rest[i]))) {
+                    ++i;
+                }
+                auto startsWith = [&rest, i](const char* op) {
+                    return rest.compare(i, std::char_traits<char>::length(op), op) == 0;
+                };
+                if(startsWith("!=") || startsWith("<>") || startsWith("IS NOT ") || startsWith("NOT ")) {
+                    return;
+                }
+                if(startsWith("=") || startsWith("IN ") || startsWith("IN(") || startsWith("IS ")) {
+                    addUnique(result.equal, column);
+                } else if(startsWith("<") || startsWith(">") || startsWith("BETWEEN ")) {
+                    addUnique(result.range, column);
+                }
+            });
+            auto orderBy = sql_clause(sql, " ORDER BY ", {" LIMIT "});
+            for_each_column_of(orderBy, table, unqualified, [&](const std::string& column, const std::string&) {
+                addUnique(result.orderBy, column);
+            });
+            return result;
+        }
+
+        /**
+         *  Returns the table a `SCAN` node of a plan scans or an empty string for other nodes.
+         */
+        inline std::string scanned_table(const query_plan_node& node) {
+            //  SQLite before 3.36.0 reports `SCAN TABLE users`, newer versions `SCAN users`
+            for(const char* prefix: {"SCAN TABLE ", "SCAN "}) {
+                const std::string scan = prefix;
+                if(node.detail.compare(0, scan.size(), scan) == 0) {
+                    auto end = node.detail.find(' ', scan.size());
+                    auto table = node.detail.substr(scan.size(), end - scan.size());
+                    //  scans of subqueries and CTEs can't be indexed
+                    if(table == "CONSTANT" || table == "SUBQUERY" || table.compare(0, 1, "(") == 0) {
+                        return {};
+                    }
+                    return table;
+                }
+            }
+            return {};
+        }
+
+        /**
+         *  Returns the table and columns of an automatic index a plan node uses, e.g.
+         *  `SEARCH orders USING AUTOMATIC COVERING INDEX (customer_id=?)`, or an empty table for other nodes.
+         */
+        inline std::pair<std::string, std::vector<std::string>> automatic_index_columns(const query_plan_node& node) {
+            std::pair<std::string, std::vector<std::string>> result;
+            const auto automatic = node.detail.find(" USING AUTOMATIC ");
+            if(automatic == std::string::npos) {
+                return result;
+            }
+            //  SQLite before 3.36.0 reports `SEARCH TABLE orders`, newer versions `SEARCH orders`
+            for(const char* prefix: {"SEARCH TABLE ", "SEARCH "}) {
+                const std::string search = prefix;
+                if(node.detail.compare(0, search.size(), search) == 0) {
+                    result.first = node.detail.substr(search.size(), node.detail.find(' ', search.size()) - search.size());
+                    break;
+                }
+            }
+            auto begin = node.detail.find('(', automatic);
+            auto end = node.detail.find(')', begin);
+            if(result.first.empty() || begin == std::string::npos || end == std::string::npos) {
+                result.first.clear();
+                return result;
+            }
+            const std::string terms = node.detail.substr(begin + 1, end - begin - 1);
+            for(size_t position = 0; position < terms.size();) {
+                auto termEnd = terms.find(" AND ", position);
+                if(termEnd == std::string::npos) {
+                    termEnd = terms.size();
+                }
+                auto term = terms.substr(position, termEnd - position);
+                auto column = term.substr(0, term.find_first_of("=<>"));
+                if(!column.empty() && std::find(result.second.begin(), result.second.end(), column) == result.second.end()) {
+                    result.second.push_back(std::move(column));
+                }
+                position = termEnd + 5;
+            }
+            if(result.second.empty()) {
+                result.first.clear();
+            }
+            return result;
+        }
+
+        /**
+         *  Counts the executions of every statement shape of a storage and suggests indexes for them. Recording
+         *  happens from trace callbacks of all connections, so every member function is thread safe.
+         */
+        struct index_advisor_recorder {
+
+            bool enabled() const {
+                return this->isEnabled;
+            }
+
+            void enable(index_advisor_options options_) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->options = std::move(options_);
+                this->isEnabled = true;
+            }
+
+            void disable() {
+                this->isEnabled = false;
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->shapes.clear();
+            }
+
+            /**
+             *  Counts an execution of `sql` which filled an automatic index with `automaticIndexRows` rows.
+             */
+            void record(const std::string& sql, int automaticIndexRows = 0) {
+                //  the plans the advisor and the slow query log explain themselves
+                if(sql.compare(0, 8, "EXPLAIN ") == 0) {
+                    return;
+                }
+                std::function<void(const std::string&, int)> onAutomaticIndex;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    if(automaticIndexRows > 0) {
+                        onAutomaticIndex = this->options.on_automatic_index;
+                    }
+                    auto it = this->shapes.find(sql);
+                    if(it == this->shapes.end() && this->shapes.size() < this->options.max_shapes) {
+                        it = this->shapes.emplace(sql, shape_counts{}).first;
+                    }
+                    if(it != this->shapes.end()) {
+                        ++it->second.executions;
+                        if(automaticIndexRows > 0) {
+                            ++it->second.automaticIndexExecutions;
+                        }
+                    }
+                }
+                if(onAutomaticIndex) {
+                    onAutomaticIndex(sql, automaticIndexRows);
+                }
+            }
+
+            /**
+             *  Explains the recorded shapes on `db` and returns an index for every table one of them scans
+             *  while comparing its columns, sorts by its columns or searches with an automatic index, the most
+             *  executed first. Shapes that can't be explained any more, e.g. because a table got dropped, are
+             *  skipped.
+             */
+            std::vector<index_suggestion> get(sqlite3* db) {
+                std::vector<std::pair<std::string, shape_counts>> recorded;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    recorded.assign(this->shapes.begin(), this->shapes.end());
+                }
+                std::vector<index_suggestion> result;
+                for(auto& shape: recorded) {
+                    query_plan plan;
+                    try {
+                        plan = explain_query_plan(db, shape.first);
+                    } catch(const std::system_error&) {
+                        continue;
+                    }
+                    const bool sorts = plan.contains("USE TEMP B-TREE FOR ORDER BY");
+                    for(auto& node: plan.nodes) {
+                        auto automaticIndex = automatic_index_columns(node);
+                        if(!automaticIndex.first.empty()) {
+                            add_suggestion(result,
+                                           std::move(automaticIndex.first),
+                                           std::move(automaticIndex.second),
+                                           {node.detail},
+                                           shape);
+                            continue;
+                        }
+                        auto table = scanned_table(node);
+                        if(table.empty()) {
+                            continue;
+                        }
+                        auto candidates = find_index_candidate_columns(shape.first, table);
+                        std::vector<std::string> reasons{node.detail};
+                        auto columns = std::move(candidates.equal);
+                        if(!candidates.range.empty()) {
+                            columns.push_back(candidates.range.front());
+                        } else if(sorts && !candidates.orderBy.empty()) {
+                            for(auto& column: candidates.orderBy) {
+                                if(std::find(columns.begin(), columns.end(), column) == columns.end()) {
+                                    columns.push_back(column);
+                                }
+                            }
+                            reasons.emplace_back("USE TEMP B-TREE FOR ORDER BY");
+                        }
+                        if(columns.empty()) {
+                            continue;
+                        }
+                        add_suggestion(result, std::move(table), std::move(columns), reasons, shape);
+                    }
+                }
+                std::sort(result.begin(),
+                          result.end(),
+                          [](const index_suggestion& lhs, const index_suggestion& rhs) {
+                              return lhs.executions > rhs.executions;
+                          });
+                return result;
+            }
+
+          protected:
+            struct shape_counts {
+                size_t executions = 0;
+                size_t automaticIndexExecutions = 0;
+            };
+
+            static void add_suggestion(std::vector<index_suggestion>& suggestions,
+                                   std::string table,
+                                   std::vector<std::string> columns,
+                                   const std::vector<std::string>& reasons,
+                                   const std::pair<std::string, shape_counts>& shape) {
+                auto it = std::find_if(suggestions.begin(),
+                                       suggestions.end(),
+                                       [&table, &columns](const index_suggestion& suggestion) {
+                                           return suggestion.table == table && suggestion.columns == columns;
+                                       });
+                if(it == suggestions.end()) {
+                    index_suggestion suggestion;
+                    suggestion.table = std::move(table);
+                    suggestion.columns = std::move(columns);
+                    it = suggestions.insert(suggestions.end(), std::move(suggestion));
+                }
+                for(auto& reason: reasons) {
+                    if(std::find(it->reasons.begin(), it->reasons.end(), reason) == it->reasons.end()) {
+                        it->reasons.push_back(reason);
+                    }
+                }
+                if(std::find(it->queries.begin(), it->queries.end(), shape.first) == it->queries.end()) {
+                    it->queries.push_back(shape.first);
+                    it->executions += shape.second.executions;
+                    it->automatic_index_executions += shape.second.automaticIndexExecutions;
+                }
+            }
+
+            std::atomic<bool> isEnabled{false};
+            std::mutex mutex;
+            index_advisor_options options;
+            std::map<std::string, shape_counts> shapes;
+        };
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>  //  std::array
+#include <chrono>  //  std::chrono::nanoseconds, std::chrono::duration_cast
+#include <cstdint>  //  uint64_t
+#include <map>  //  std::map
+#include <memory>  //  std::shared_ptr, std::make_shared
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <string>  //  std::string
+
+namespace sqlite_orm {
+
+    /**
+     *  File I/O counted by an `io_accounting_shim`, for the database file together with its journal and WAL.
+     */
+    struct io_counters {
+        uint64_t reads = 0;
+        uint64_t bytes_read = 0;
+        uint64_t writes = 0;
+        uint64_t bytes_written = 0;
+        uint64_t syncs = 0;
+        std::chrono::nanoseconds sync_time{0};
+
+        /**
+         *  Attempts to lock the database that found it locked by another connection. The waits themselves are
+         *  spent in the busy handler.
+         */
+        uint64_t busy_locks = 0;
+
+        io_counters& operator-=(const io_counters& other) {
+            this->reads -= other.reads;
+            this->bytes_read -= other.bytes_read;
+            this->writes -= other.writes;
+            this->bytes_written -= other.bytes_written;
+            this->syncs -= other.syncs;
+            this->sync_time -= other.sync_time;
+            this->busy_locks -= other.busy_locks;
+            return *this;
+        }
+    };
+
+    /**
+     *  Latencies of file calls: `buckets[0]` counts the calls that took less than 1 microsecond, `buckets[i]`
+     *  the calls that took at least 2^(i - 1) and less than 2^i microseconds, the last bucket all slower ones.
+     */
+    struct io_latency_histogram {
+        std::array<uint64_t, 24> buckets{};
+
+        void record(std::chrono::nanoseconds duration) {
+            auto microseconds = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+            size_t index = 0;
+            while(microseconds && index + 1 < this->buckets.size()) {
+                microseconds >>= 1;
+                ++index;
+            }
+            ++this->buckets[index];
+        }
+
+        uint64_t count() const {
+            uint64_t result = 0;
+            for(auto bucket: this->buckets) {
+                result += bucket;
+            }
+            return result;
+        }
+    };
+
+    /**
+     *  Result of `storage.io_stats()`.
+     */
+    struct io_statistics : io_counters {
+        io_latency_histogram read_latency;
+        io_latency_histogram write_latency;
+        io_latency_histogram sync_latency;
+    };
+
+    namespace internal {
+
+        /**
+         *  I/O of every database file opened through an `io_accounting_shim` by its full path. Entries live as
+         *  long as the process so that the files can be opened and closed with every connection.
+         */
+        struct io_accounting_registry {
+            struct entry {
+                std::mutex mutex;
+                io_statistics stats;
+            };
+
+            std::mutex mutex;
+            std::map<std::string, std::shared_ptr<entry>> entries;
+
+            static io_accounting_registry& instance() {
+                static io_accounting_registry registry;
+                return registry;
+            }
+
+            std::shared_ptr<entry> get(const std::string& path, bool create) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->entries.find(path);
+                if(it != this->entries.end()) {
+                    return it->second;
+                }
+                if(!create) {
+                    return nullptr;
+                }
+                return this->entries[path] = std::make_shared<entry>();
+            }
+        };
+
+        /**
+         *  I/O of the current thread through an `io_accounting_shim`, which `on_profile()` takes the difference
+         *  of for every statement.
+         */
+        inline io_counters& thread_io_counters() {
+            static thread_local io_counters counters;
+            return counters;
+        }
+    }
+}
@@ -6,7 +6,6 @@
 #include <utility>  //  std::move
 #include <iterator>  //  std::input_iterator_tag
 #include <system_error>  //  std::system_error
-#include <functional>  //  std::bind
 
 #include "functional/cxx_universal.h"
 #include "statement_finalizer.h"
@@ -37,23 +36,35 @@ namespace sqlite_orm {
             /**
              *  shared_ptr is used over unique_ptr here
              *  so that the iterator can be copyable.
+             *  The object is reused for every row as long as no copy of the iterator refers to it,
+             *  so single-pass iteration allocates one object and reuses the capacity of its members.
              */
             std::shared_ptr<value_type> current;
 
             void extract_value() {
                 auto& dbObjects = obtain_db_objects(this->view->storage);
-                this->current = std::make_shared<value_type>();
-                object_from_column_builder<value_type> builder{*this->current, this->stmt.get()};
-                pick_table<value_type>(dbObjects).for_each_column(builder);
+                if(!this->current || this->current.use_count() > 1) {
+                    this->current = std::make_shared<value_type>();
+                }
+                build_object(*this->current,
+                             this->stmt.get(),
+                             pick_table<value_type>(dbObjects),
+                             this->view->args.conditions);
             }
 
             void next() {
-                this->current.reset();
                 if(sqlite3_stmt* stmt = this->stmt.get()) {
-                    perform_step(stmt, std::bind(&iterator_t::extract_value, this));
-                    if(!this->current) {
+                    bool hasRow = false;
+                    perform_step(stmt, [this, &hasRow](sqlite3_stmt*) {
+                        this->extract_value();
+                        hasRow = true;
+                    });
+                    if(!hasRow) {
+                        this->current.reset();
                         this->stmt.reset();
                     }
+                } else {
+                    this->current.reset();
                 }
             }
 
@@ -65,7 +76,10 @@ namespace sqlite_orm {
 
             iterator_t(){};
 
-            iterator_t(statement_finalizer stmt_, view_type& view_) : stmt{move(stmt_)}, view{&view_} {
+            /**
+             *  @param stmt_ statement whose rows are iterated over, the deleter finalizes or resets it.
+             */
+            iterator_t(std::shared_ptr<sqlite3_stmt> stmt_, view_type& view_) : stmt{move(stmt_)}, view{&view_} {
                 next();
             }
 
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::system_clock, std::chrono::duration_cast
+#include <string>  //  std::string
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "literal.h"
+#include "conditions.h"
+#include "select_constraints.h"
+#include "prepared_statement.h"
+#include "ast/returning.h"
+#include "column.h"
+#include "constraints.h"
+#include "index.h"
+#include "table.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  States of a `queued_job`.
+     */
+    enum job_state : int {
+        job_pending = 0,
+
+        /**
+         *  Claimed by a worker until its lease expires.
+         */
+        job_claimed = 1,
+
+        /**
+         *  Failed `max_attempts` times, kept for inspection and not claimed any more.
+         */
+        job_failed = 2,
+    };
+
+    /**
+     *  Row of a job queue table, see `make_job_queue_table()`. `Tag` tells apart queues with the same payload type.
+     */
+    template<class P, class Tag = void>
+    struct queued_job {
+        sqlite3_int64 id = 0;
+        P payload;
+        int state = job_pending;
+
+        /**
+         *  End of the lease of a claimed job, milliseconds since the Unix epoch.
+         */
+        sqlite3_int64 lease_until = 0;
+
+        /**
+         *  Number of times the job was claimed.
+         */
+        int attempts = 0;
+    };
+
+    namespace internal {
+
+        /**
+         *  `state = <literal>`: a partial index is used only for a query whose WHERE clause has the terms of
+         *  the WHERE clause of the index, with the same literals rather than bound values.
+         */
+        template<class J>
+        auto job_state_is(job_state state) {
+            return sqlite_orm::c(&J::state) == literal_holder<int>{int(state)};
+        }
+
+        inline sqlite3_int64 job_queue_now() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /**
+         *  Job queue over a table made by `make_job_queue_table<P, Tag>()`. Don't construct it as is, call
+         *  `storage.make_job_queue<P, Tag>()` instead.
+         *  Jobs are claimed in the order they were enqueued, by one `UPDATE ... RETURNING` in an immediate
+         *  transaction, so that concurrent workers of any process never claim the same job. A claimed job is
+         *  leased: it has to be acknowledged or given back before the lease expires, otherwise the next claim
+         *  makes it pending again, or failed once it was claimed `max_attempts` times.
+         *  With the indexes of `make_job_queue_index()` and `make_job_lease_index()` a claim costs O(log n)
+         *  however many failed jobs the table holds. Needs SQLite 3.35.0 for RETURNING.
+         *  Queues can be used by many threads.
+         */
+        template<class S, class P, class Tag>
+        struct job_queue {
+            using storage_type = S;
+            using payload_type = P;
+            using job_type = queued_job<P, Tag>;
+
+            job_queue(storage_type& storage_, int maxAttempts_) : max_attempts(maxAttempts_), storage(storage_) {}
+
+            /**
+             *  @return id of the new job.
+             */
+            sqlite3_int64 enqueue(P payload) {
+                job_type job;
+                job.payload = std::move(payload);
+                auto ids = this->storage.returning(sqlite_orm::insert(job), &job_type::id);
+                return ids.front();
+            }
+
+            /**
+             *  Enqueues the payloads in [from, to) with multi-row INSERTs in one transaction.
+             */
+            template<class It>
+            void enqueue(It from, It to) {
+                std::vector<job_type> jobs;
+                for(; from != to; ++from) {
+                    jobs.emplace_back();
+                    jobs.back().payload = *from;
+                }
+                if(jobs.empty()) {
+                    return;
+                }
+                auto guard = this->storage.transaction_guard();
+                this->storage.insert_range(jobs.begin(), jobs.end());
+                guard.commit();
+            }
+
+            /**
+             *  Claims up to `count` pending jobs, the oldest first, for `lease`. Jobs whose lease expired are
+             *  made pending again first.
+             *  @return the claimed jobs, with their new state, lease and number of attempts.
+             */
+            std::vector<job_type> claim(int count, std::chrono::milliseconds lease) {
+                const auto now = job_queue_now();
+                auto guard = this->storage.immediate_transaction_guard();
+                this->expire_leases(now);
+                auto res = this->storage.returning(
+                    sqlite_orm::update_all(
+                        sqlite_orm::set(sqlite_orm::c(&job_type::state) = int(job_claimed),
+                                        sqlite_orm::c(&job_type::lease_until) = now + lease.count(),
+                                        sqlite_orm::c(&job_type::attempts) = sqlite_orm::c(&job_type::attempts) + 1),
+                        sqlite_orm::where(sqlite_orm::in(&job_type::id,
+                                                         sqlite_orm::select(&job_type::id,
+                                                                            sqlite_orm::where(
+                                                                                job_state_is<job_type>(job_pending)),
+                                                                            sqlite_orm::order_by(&job_type::id),
+                                                                            sqlite_orm::limit(count))))),
+                    sqlite_orm::object<job_type>());
+                guard.commit();
+                return res;
+            }
+
+            /**
+             *  Removes the job claimed as `job`, done.
+             *  @return false if its lease expired and it was made pending or claimed again meanwhile.
+             */
+            bool ack(const job_type& job) {
+                return !this->storage
+                            .returning(sqlite_orm::remove_all<job_type>(sqlite_orm::where(this->is_held(job))),
+                                       &job_type::id)
+                            .empty();
+            }
+
+            /**
+             *  Gives the job claimed as `job` back: it is pending again, or failed once it was claimed
+             *  `max_attempts` times.
+             *  @return false if its lease expired and it was made pending or claimed again meanwhile.
+             */
+            bool nack(const job_type& job) {
+                const int state = job.attempts >= this->max_attempts ? job_failed : job_pending;
+                //  not a literal 0, which would also convert to the member pointer of the column
+                const sqlite3_int64 leaseUntil = 0;
+                auto giveBack = sqlite_orm::update_all(
+                    sqlite_orm::set(sqlite_orm::c(&job_type::state) = state,
+                                    sqlite_orm::c(&job_type::lease_until) = leaseUntil),
+                    sqlite_orm::where(this->is_held(job)));
+                return !this->storage.returning(std::move(giveBack), &job_type::id).empty();
+            }
+
+            /**
+             *  Extends the lease of the job claimed as `job` to `lease` from now, for jobs that run longer than
+             *  expected.
+             *  @return false if its lease expired and it was made pending or claimed again meanwhile.
+             */
+            bool renew(job_type& job, std::chrono::milliseconds lease) {
+                const auto leaseUntil = job_queue_now() + lease.count();
+                const bool renewed =
+                    !this->storage
+                         .returning(sqlite_orm::update_all(
+                                        sqlite_orm::set(sqlite_orm::c(&job_type::lease_until) = leaseUntil),
+                                        sqlite_orm::where(this->is_held(job))),
+                                    &job_type::id)
+                         .empty();
+                if(renewed) {
+                    job.lease_until = leaseUntil;
+                }
+                return renewed;
+            }
+
+            int pending_count() {
+                return this->storage.template count<job_type>(sqlite_orm::where(job_state_is<job_type>(job_pending)));
+            }
+
+            const int max_attempts;
+
+          protected:
+            /**
+             *  The job is still claimed by the claim that returned `job`: every claim increments `attempts`.
+             */
+            auto is_held(const job_type& job) const {
+                return sqlite_orm::c(&job_type::id) == job.id and job_state_is<job_type>(job_claimed) and
+                       sqlite_orm::c(&job_type::attempts) == job.attempts;
+            }
+
+            void expire_leases(sqlite3_int64 now) {
+                auto expired = job_state_is<job_type>(job_claimed) and sqlite_orm::c(&job_type::lease_until) <= now;
+                this->storage.update_all(
+                    sqlite_orm::set(sqlite_orm::c(&job_type::state) = int(job_failed)),
+                    sqlite_orm::where(expired and sqlite_orm::c(&job_type::attempts) >= this->max_attempts));
+                this->storage.update_all(sqlite_orm::set(sqlite_orm::c(&job_type::state) = int(job_pending)),
+                                         sqlite_orm::where(expired));
+            }
+
+            storage_type& storage;
+        };
+    }
+
+    /**
+     *  Table of a job queue, used with `storage.make_job_queue<P, Tag>()` and the indexes of
+     *  `make_job_queue_index()` and `make_job_lease_index()`:
+     *  auto storage = make_storage("jobs.sqlite",
+     *                              make_job_queue_index<Email>("emails_pending"),
+     *                              make_job_lease_index<Email>("emails_leased"),
+     *                              make_job_queue_table<Email>("emails"));
+     *  auto emails = storage.make_job_queue<Email>();
+     *  for(auto& job: emails.claim(10, std::chrono::seconds{30})) {
+     *      send(job.payload) ? emails.ack(job) : emails.nack(job);
+     *  }
+     *  The payload is one column, a string, a blob or any other type with a column mapping.
+     */
+    template<class P, class Tag = void>
+    auto make_job_queue_table(std::string name) {
+        using job_type = queued_job<P, Tag>;
+        return make_table<job_type>(std::move(name),
+                                    make_column("id", &job_type::id, primary_key()),
+                                    make_column("payload", &job_type::payload),
+                                    make_column("state", &job_type::state, default_value(int(job_pending))),
+                                    make_column("lease_until", &job_type::lease_until, default_value(0)),
+                                    make_column("attempts", &job_type::attempts, default_value(0)));
+    }
+
+    /**
+     *  Partial index of the pending jobs in the order they are claimed.
+     */
+    template<class P, class Tag = void>
+    auto make_job_queue_index(std::string name) {
+        using job_type = queued_job<P, Tag>;
+        return make_index(std::move(name), &job_type::id, where(internal::job_state_is<job_type>(job_pending)));
+    }
+
+    /**
+     *  Partial index of the leases of the claimed jobs, which claims look for expired ones in.
+     */
+    template<class P, class Tag = void>
+    auto make_job_lease_index(std::string name) {
+        using job_type = queued_job<P, Tag>;
+        return make_index(std::move(name),
+                          &job_type::lease_until,
+                          where(internal::job_state_is<job_type>(job_claimed)));
+    }
+}
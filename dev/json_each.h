@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>  //  std::string
+
+#include "column.h"
+#include "table.h"
+
+namespace sqlite_orm {
+#ifdef SQLITE_ENABLE_JSON1
+    namespace internal {
+
+        /**
+         *  A row of the table-valued functions `json_each()` and `json_tree()`, see
+         *  https://sqlite.org/json1.html#jeach. The hidden columns `json` and `root` are their arguments.
+         */
+        template<class Tag>
+        struct json_table_row {
+            std::string key;
+            std::string value;
+            std::string type;
+            std::string atom;
+            int id = 0;
+            int parent = 0;
+            std::string fullkey;
+            std::string path;
+            std::string json;
+            std::string root;
+        };
+
+        struct json_each_tag {};
+        struct json_tree_tag {};
+
+        template<class T>
+        auto make_json_table(std::string name) {
+            return make_table<T>(move(name),
+                                 make_column("key", &T::key),
+                                 make_column("value", &T::value),
+                                 make_column("type", &T::type),
+                                 make_column("atom", &T::atom),
+                                 make_column("id", &T::id),
+                                 make_column("parent", &T::parent),
+                                 make_column("fullkey", &T::fullkey),
+                                 make_column("path", &T::path),
+                                 make_column("json", &T::json),
+                                 make_column("root", &T::root));
+        }
+    }
+
+    /**
+     *  The elements of the top-level array or object of a JSON document, which is given as a constraint on
+     *  the `json` column, e.g. joined to the documents stored in a column:
+     *  `storage.select(&User::id, inner_join<json_each>(on(c(&json_each::json) == &User::tags)),
+     *                  where(c(&json_each::value) == "admin"))`
+     *  makes SQLite filter the array elements instead of the documents being read.
+     */
+    using json_each = internal::json_table_row<internal::json_each_tag>;
+
+    /**
+     *  All the elements of a JSON document, walking it recursively; see `json_each`.
+     */
+    using json_tree = internal::json_table_row<internal::json_tree_tag>;
+
+    inline auto make_json_each_table() {
+        return internal::make_json_table<json_each>("json_each");
+    }
+
+    inline auto make_json_tree_table() {
+        return internal::make_json_table<json_tree>("json_tree");
+    }
+#endif  //  SQLITE_ENABLE_JSON1
+}
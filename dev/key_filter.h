@@ -0,0 +1,384 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstdint>  //  uint64_t
+#include <cmath>  //  std::log
+#include <functional>  //  std::hash, std::less
+#include <map>  //  std::map
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <set>  //  std::set
+#include <string>  //  std::string, std::to_string
+#include <type_traits>  //  std::enable_if_t, std::is_integral, std::is_same, std::is_convertible
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "change_hooks.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Counters of one key filter returned by `storage.filter_stats<T>()`.
+     */
+    struct key_filter_stats {
+
+        /**
+         *  Lookups by primary key that consulted the filter.
+         */
+        size_t lookups = 0;
+
+        /**
+         *  Lookups answered by the filter, without a query.
+         */
+        size_t negatives = 0;
+
+        /**
+         *  Lookups the filter let through that found no row.
+         */
+        size_t false_positives = 0;
+
+        /**
+         *  Number of times the keys were read from the table.
+         */
+        size_t rebuilds = 0;
+
+        /**
+         *  Keys added since the last rebuild, including the ones of rows removed meanwhile.
+         */
+        size_t keys = 0;
+
+        size_t bits = 0;
+    };
+
+    namespace internal {
+
+        template<class T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
+        void append_key_filter_key(std::string& key, const T& value) {
+            key += std::to_string(value);
+        }
+
+        inline void append_key_filter_key(std::string& key, const std::string& value) {
+            key += value;
+        }
+
+        inline void append_key_filter_key(std::string& key, const char* value) {
+            key += value;
+        }
+
+        /**
+         *  Is never called, key filters are enabled for integer and text keys only. Keeps the statements
+         *  writing objects with other keys compiling.
+         */
+        template<class T,
+                 std::enable_if_t<!std::is_integral<T>::value && !std::is_convertible<T, const char*>::value, bool> =
+                     true>
+        void append_key_filter_key(std::string&, const T&) {}
+
+        /**
+         *  Whether a lookup key of type I has the text of the key of a primary key column of type F.
+         */
+        template<class F, class I>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_key_filter_key_v =
+            std::is_same<F, I>::value || (std::is_integral<F>::value && std::is_integral<I>::value) ||
+            (std::is_same<F, std::string>::value &&
+             (std::is_same<I, const char*>::value || std::is_same<I, char*>::value));
+
+        /**
+         *  Bloom filter of the primary keys of a table, a key being the text of its columns joined by '\x1f'.
+         *  It never denies a key the table has, it may admit keys the table doesn't have: rows removed are not
+         *  removed from the filter and a fraction of the other keys collide. The filter is rebuilt from the
+         *  table when it is stale, at the next lookup.
+         *
+         *  While a transaction that wrote the table is open the filter denies no key and isn't rebuilt: a rebuild
+         *  doesn't see the uncommitted rows whose keys the hooks added.
+         */
+        struct key_filter {
+            key_filter(size_t expectedKeys_, int bitsPerKey_, bool keyedByRowid_) :
+                keyedByRowid(keyedByRowid_), expectedKeys(expectedKeys_ > 0 ? expectedKeys_ : 1),
+                bitsPerKey(bitsPerKey_ > 0 ? bitsPerKey_ : 1) {
+                //  k = ln 2 * bits per key minimizes the false positive rate
+                this->hashes = int(double(this->bitsPerKey) * std::log(2.0) + 0.5);
+                this->hashes = this->hashes < 1 ? 1 : (this->hashes > 16 ? 16 : this->hashes);
+            }
+
+            /**
+             *  @return false if the table surely has no row with primary key `key`.
+             */
+            bool may_contain(const std::string& key) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->statistics.lookups;
+                if(this->stale || this->rebuilding > 0 || this->writers > 0) {
+                    return true;
+                }
+                const auto hash = std::hash<std::string>{}(key);
+                for(int i = 0; i < this->hashes; ++i) {
+                    const auto bit = this->bit_of(hash, i);
+                    if(!((this->bits[bit / 64] >> (bit % 64)) & 1)) {
+                        ++this->statistics.negatives;
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void add(const std::string& key) {
+                const auto hash = std::hash<std::string>{}(key);
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if(this->stale) {
+                    return;
+                }
+                for(int i = 0; i < this->hashes; ++i) {
+                    const auto bit = this->bit_of(hash, i);
+                    this->bits[bit / 64] |= uint64_t(1) << (bit % 64);
+                }
+                //  past twice the expected keys the false positive rate soars, a rebuild makes the filter larger
+                if(++this->statistics.keys > 2 * this->expectedKeys) {
+                    this->stale = true;
+                }
+            }
+
+            void false_positive() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->statistics.false_positives;
+            }
+
+            /**
+             *  The table changed in a way the filter can't follow, e.g. a row inserted by SQL whose key is
+             *  unknown.
+             */
+            void mark_stale() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->stale = true;
+            }
+
+            bool is_stale() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->stale;
+            }
+
+            /**
+             *  Called when a transaction writes the table for the first time. Until `end_write()` the filter
+             *  denies no key and isn't rebuilt.
+             */
+            void begin_write() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->writers;
+            }
+
+            void end_write() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                --this->writers;
+            }
+
+            /**
+             *  Empties the filter to add the `count` keys of the table. Keys added by hooks meanwhile are kept,
+             *  lookups are let through until `end_rebuild()`.
+             *  @return false, leaving the filter as it is, if a transaction that wrote the table is open.
+             */
+            bool begin_rebuild(size_t count) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if(this->writers > 0) {
+                    return false;
+                }
+                if(count > this->expectedKeys) {
+                    this->expectedKeys = count + count / 2;
+                }
+                const size_t bitCount = this->expectedKeys * size_t(this->bitsPerKey);
+                this->bits.assign((bitCount + 63) / 64, 0);
+                this->stale = false;
+                this->statistics.keys = 0;
+                ++this->statistics.rebuilds;
+                ++this->rebuilding;
+                return true;
+            }
+
+            void end_rebuild(bool succeeded) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                --this->rebuilding;
+                if(!succeeded) {
+                    this->stale = true;
+                }
+            }
+
+            key_filter_stats stats() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto result = this->statistics;
+                result.bits = this->bits.size() * 64;
+                return result;
+            }
+
+            /**
+             *  True if the primary key is the rowid, i.e. a single integer column of a rowid table: the update
+             *  hook then tells the key of every inserted row.
+             */
+            const bool keyedByRowid;
+
+          protected:
+            size_t bit_of(size_t hash, int i) const {
+                //  double hashing, the second hash being odd so that the probes of a key are distinct
+                const uint64_t second = (uint64_t(hash) * 0x9E3779B97F4A7C15ull) >> 17 | 1;
+                return size_t((uint64_t(hash) + uint64_t(i) * second) % (this->bits.size() * 64));
+            }
+
+            std::mutex mutex;
+            size_t expectedKeys;
+            const int bitsPerKey;
+            int hashes = 1;
+            std::vector<uint64_t> bits;
+            bool stale = true;
+            int rebuilding = 0;
+            int writers = 0;
+            key_filter_stats statistics;
+        };
+
+        /**
+         *  Marks the keys of the rows the current thread writes as added to `filter` already, so that the
+         *  update hook of these rows doesn't make the filter stale. Hooks run on the thread that steps.
+         */
+        class key_filter_write_scope {
+          public:
+            explicit key_filter_write_scope(key_filter* filter) : filter{filter}, previous{current()} {
+                current() = this;
+            }
+
+            key_filter_write_scope(const key_filter_write_scope&) = delete;
+            key_filter_write_scope& operator=(const key_filter_write_scope&) = delete;
+
+            ~key_filter_write_scope() {
+                current() = this->previous;
+            }
+
+            static bool announced(const key_filter* filter) {
+                for(auto scope = current(); scope; scope = scope->previous) {
+                    if(scope->filter == filter) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+          private:
+            key_filter* filter;
+            key_filter_write_scope* previous;
+
+            static key_filter_write_scope*& current() {
+                thread_local key_filter_write_scope* scope = nullptr;
+                return scope;
+            }
+        };
+
+        /**
+         *  Key filters of a storage by table name, kept current by the update hooks of every connection: the
+         *  rowid of an inserted or updated row is added to a filter keyed by rowid, other filters get the keys
+         *  from `insert`, `replace` and `update` of objects and go stale when a row is written otherwise.
+         *  The filters a transaction writes are told so until it ends.
+         *
+         *  Adding and removing filters is not thread safe, lookups and hooks are.
+         */
+        struct key_filter_registry : change_listener {
+
+            key_filter_registry() = default;
+            key_filter_registry(const key_filter_registry&) = delete;
+            key_filter_registry& operator=(const key_filter_registry&) = delete;
+
+            bool empty() const {
+                return this->filters.empty();
+            }
+
+            key_filter* find(const std::string& table) const {
+                auto it = this->filters.find(table);
+                return it != this->filters.end() ? it->second.get() : nullptr;
+            }
+
+            void add(const std::string& table, size_t expectedKeys, int bitsPerKey, bool keyedByRowid) {
+                this->remove(table);
+                this->filters[table] = std::make_unique<key_filter>(expectedKeys, bitsPerKey, keyedByRowid);
+            }
+
+            void remove(const std::string& table) {
+                auto it = this->filters.find(table);
+                if(it == this->filters.end()) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock{this->mutex};
+                for(auto& pair: this->writes) {
+                    pair.second.erase(it->second.get());
+                }
+                this->filters.erase(it);
+            }
+
+            /**
+             *  Another connection may have written any table, see `enable_cache_coherence()`.
+             */
+            void mark_all_stale() {
+                for(auto& pair: this->filters) {
+                    pair.second->mark_stale();
+                }
+            }
+
+            bool listening() const override {
+                return !this->empty();
+            }
+
+            void changed(sqlite3* db, int operation, const char* table, sqlite3_int64 rowid) override {
+                if(operation == SQLITE_DELETE) {
+                    return;
+                }
+                auto it = this->filters.find(table);
+                if(it == this->filters.end()) {
+                    return;
+                }
+                auto& filter = *it->second;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    if(this->writes[db].insert(&filter).second) {
+                        filter.begin_write();
+                    }
+                }
+                if(filter.keyedByRowid) {
+                    filter.add(std::to_string(rowid));
+                } else if(!key_filter_write_scope::announced(&filter)) {
+                    filter.mark_stale();
+                }
+            }
+
+            void commit(sqlite3* db) override {
+                this->end_writes(db);
+            }
+
+            void rollback(sqlite3* db) override {
+                this->end_writes(db);
+            }
+
+            void closed(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->writes.find(db);
+                if(it != this->writes.end()) {
+                    end_writes(it->second);
+                    this->writes.erase(it);
+                }
+            }
+
+          protected:
+            void end_writes(sqlite3* db) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->writes.find(db);
+                if(it != this->writes.end()) {
+                    end_writes(it->second);
+                }
+            }
+
+            static void end_writes(std::set<key_filter*>& written) {
+                for(auto filter: written) {
+                    filter->end_write();
+                }
+                written.clear();
+            }
+
+            std::map<std::string, std::unique_ptr<key_filter>, std::less<>> filters;
+            std::mutex mutex;
+            //  filters written by the open transaction of each connection
+            std::map<sqlite3*, std::set<key_filter*>> writes;
+        };
+    }
+}
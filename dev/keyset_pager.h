@@ -0,0 +1,291 @@
+#pragma once
+
+#include <functional>  //  std::reference_wrapper, std::ref
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <tuple>  //  std::tuple, std::get, std::tuple_cat
+#include <type_traits>  //  std::is_member_object_pointer
+#include <utility>  //  std::move, std::declval, std::index_sequence, std::index_sequence_for
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
+#include "member_traits/member_traits.h"
+#include "select_constraints.h"
+#include "conditions.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Condition of a pager without `where()`.
+         */
+        struct no_page_condition {};
+
+        /**
+         *  Pages of mapped objects, like `get_all<O>()`.
+         */
+        template<class O>
+        struct object_page_query {
+
+            template<class... Args>
+            auto make(Args... args) const {
+                return sqlite_orm::get_all<O>(std::move(args)...);
+            }
+
+            template<class K, class... Keys, size_t... Is>
+            static K key_of(const O& object, const std::tuple<Keys...>& keys, std::index_sequence<Is...>) {
+                return K{object.*std::get<Is>(keys)...};
+            }
+
+            template<class S, class St, class F>
+            static void stream(S& storage, const St& statement, F& callback) {
+                storage.for_each(statement, callback);
+            }
+        };
+
+        template<class Columns, class Keys>
+        struct columns_page_query;
+
+        /**
+         *  Pages of columns, like `select(columns(...))`. The sort key columns are selected after `Cols`.
+         */
+        template<class... Cols, class... Keys>
+        struct columns_page_query<columns_t<Cols...>, std::tuple<Keys...>> {
+            columns_t<Cols..., Keys...> columns;
+
+            template<class... Args>
+            auto make(Args... args) const {
+                return sqlite_orm::select(this->columns, std::move(args)...);
+            }
+
+            template<class K, class Row, size_t... Is>
+            static K key_of(const Row& row, const std::tuple<Keys...>&, std::index_sequence<Is...>) {
+                return K{std::get<sizeof...(Cols) + Is>(row)...};
+            }
+
+            template<class S, class St, class F>
+            static void stream(S& storage, const St& statement, F& callback) {
+                storage.for_each_row(statement, callback);
+            }
+        };
+
+        template<class... Cols, class... Keys>
+        columns_page_query<columns_t<Cols...>, std::tuple<Keys...>>
+        make_columns_page_query(columns_t<Cols...> cols, const std::tuple<Keys...>& keys) {
+            columns_page_query<columns_t<Cols...>, std::tuple<Keys...>> query{
+                columns_t<Cols..., Keys...>{std::tuple_cat(std::move(cols.columns), keys)}};
+            query.columns.distinct = cols.distinct;
+            return query;
+        }
+
+        template<class Q, class... Args>
+        auto make_page_expression(const Q& query, const no_page_condition&, Args... args) {
+            return query.make(std::move(args)...);
+        }
+
+        template<class Q, class C, class... Args>
+        auto make_page_expression(const Q& query, const C& condition, Args... args) {
+            return query.make(sqlite_orm::where(condition), std::move(args)...);
+        }
+
+        template<class K>
+        K and_page_condition(K keyCondition, const no_page_condition&) {
+            return keyCondition;
+        }
+
+        template<class K, class C>
+        auto and_page_condition(K keyCondition, const C& condition) {
+            return sqlite_orm::and_(std::move(keyCondition), condition);
+        }
+
+        template<class... Keys, size_t... Is>
+        auto make_page_order(const std::tuple<Keys...>& keys, std::index_sequence<Is...>) {
+            return sqlite_orm::multi_order_by(sqlite_orm::order_by(std::get<Is>(keys))...);
+        }
+
+        /**
+         *  The first page: `[WHERE condition] ORDER BY keys LIMIT pageSize`.
+         */
+        template<class Q, class C, class... Keys>
+        auto make_first_page_expression(const Q& query,
+                                        const std::tuple<Keys...>& keys,
+                                        const C& condition,
+                                        int pageSize) {
+            return make_page_expression(query,
+                                        condition,
+                                        make_page_order(keys, std::index_sequence_for<Keys...>{}),
+                                        sqlite_orm::limit(pageSize));
+        }
+
+        /**
+         *  The pages after a key: `WHERE (keys) > (?, ...) [AND condition] ORDER BY keys LIMIT pageSize`.
+         *  The key is bound by reference, so that the statement is executed again with whatever `lastKey`
+         *  holds.
+         */
+        template<class K, class Q, class C, class... Keys>
+        auto make_next_page_expression(const Q& query,
+                                       const std::tuple<Keys...>& keys,
+                                       const C& condition,
+                                       int pageSize,
+                                       K& lastKey) {
+            auto keyCondition = sqlite_orm::c(columns_t<Keys...>{keys}) > std::ref(lastKey);
+            return make_page_expression(query,
+                                        and_page_condition(std::move(keyCondition), condition),
+                                        make_page_order(keys, std::index_sequence_for<Keys...>{}),
+                                        sqlite_orm::limit(pageSize));
+        }
+
+        /**
+         *  Cursor returned by `storage.paginate()`. Every page continues after the sort key of the last row
+         *  of the previous page (keyset or seek pagination) instead of skipping rows with OFFSET, so reading
+         *  a page costs the same wherever it is, provided there is an index on the key columns.
+         *  The pages after the first one are read with one prepared statement, which keeps
+         *  a connection of the storage borrowed for the lifetime of the pager.
+         *
+         *  The key columns have to identify a row (e.g. end with the primary key) and are sorted ascending.
+         *  Rows inserted or changed behind the current key during paging are seen by the following pages,
+         *  unless the pages are read inside one `storage.read_transaction()`.
+         */
+        template<class S, class Q, class C, class... Keys>
+        struct keyset_pager {
+            static_assert(polyfill::conjunction_v<std::is_member_object_pointer<Keys>...>,
+                          "Keys of a pager have to be member pointers");
+
+            using key_type = std::tuple<member_field_type_t<Keys>...>;
+            using next_expression_type =
+                decltype(make_next_page_expression<key_type>(std::declval<const Q&>(),
+                                                             std::declval<const std::tuple<Keys...>&>(),
+                                                             std::declval<const C&>(),
+                                                             0,
+                                                             std::declval<key_type&>()));
+            using next_statement_type = decltype(std::declval<S&>().prepare(std::declval<next_expression_type>()));
+            using page_type = decltype(std::declval<S&>().execute(std::declval<const next_statement_type&>()));
+
+            keyset_pager(S& storage_, Q query_, std::tuple<Keys...> keys_, int pageSize_, C condition_) :
+                storage(storage_), query(std::move(query_)), keys(std::move(keys_)), pageSize(pageSize_),
+                condition(std::move(condition_)), lastKey(std::make_unique<key_type>()) {}
+
+            /**
+             *  Returns the next page, which is empty after the last one.
+             */
+            page_type next() {
+                page_type page;
+                if(this->finished) {
+                    return page;
+                }
+                if(!this->hasKey) {
+                    page = this->storage.execute(this->first_statement());
+                } else {
+                    page = this->storage.execute(this->next_statement());
+                }
+                if(!page.empty()) {
+                    this->set_key(page.back());
+                }
+                this->finished = page.size() < size_t(this->pageSize);
+                return page;
+            }
+
+            /**
+             *  Calls `callback` with every row of the next page instead of collecting them, like `storage.for_each()`
+             *  or `storage.for_each_row()`. `callback` may return false to stop, the next page then continues
+             *  after the last row it was called with.
+             *  @return number of rows `callback` was called with, 0 after the last page.
+             */
+            template<class F>
+            size_t next(F&& callback) {
+                size_t count = 0;
+                if(this->finished) {
+                    return count;
+                }
+                bool stopped = false;
+                auto visit = [this, &callback, &count, &stopped](auto&& row) {
+                    this->set_key(row);
+                    ++count;
+                    stopped = !call_row_callback(callback, std::move(row));
+                    return !stopped;
+                };
+                if(!this->hasKey) {
+                    Q::stream(this->storage, this->first_statement(), visit);
+                } else {
+                    Q::stream(this->storage, this->next_statement(), visit);
+                }
+                this->finished = !stopped && count < size_t(this->pageSize);
+                return count;
+            }
+
+            /**
+             *  True once a page shorter than the page size was read.
+             */
+            bool done() const {
+                return this->finished;
+            }
+
+            /**
+             *  Starts over from the first page.
+             */
+            void rewind() {
+                this->hasKey = false;
+                this->finished = false;
+            }
+
+            /**
+             *  The sort key of the last row read, valid once a row was read. It can be stored to continue
+             *  later with `seek()`.
+             */
+            const key_type& last_key() const {
+                return *this->lastKey;
+            }
+
+            /**
+             *  Makes the next page start after `key`.
+             */
+            void seek(key_type key) {
+                *this->lastKey = std::move(key);
+                this->hasKey = true;
+                this->finished = false;
+            }
+
+          protected:
+            template<class Row>
+            void set_key(const Row& row) {
+                *this->lastKey = Q::template key_of<key_type>(row, this->keys, std::index_sequence_for<Keys...>{});
+                this->hasKey = true;
+            }
+
+            /**
+             *  The first page is read once, its statement is not kept.
+             */
+            auto first_statement() {
+                return this->storage.prepare(
+                    make_first_page_expression(this->query, this->keys, this->condition, this->pageSize));
+            }
+
+            next_statement_type& next_statement() {
+                if(!this->nextStatement) {
+                    this->nextStatement = std::make_unique<next_statement_type>(this->storage.prepare(
+                        make_next_page_expression(this->query,
+                                                  this->keys,
+                                                  this->condition,
+                                                  this->pageSize,
+                                                  *this->lastKey)));
+                }
+                return *this->nextStatement;
+            }
+
+            S& storage;
+            const Q query;
+            const std::tuple<Keys...> keys;
+            const int pageSize;
+            const C condition;
+
+            /**
+             *  Bound by reference to `nextStatement`, allocated so that moving the pager doesn't move it.
+             */
+            std::unique_ptr<key_type> lastKey;
+            bool hasKey = false;
+            bool finished = false;
+            std::unique_ptr<next_statement_type> nextStatement;
+        };
+    }
+}
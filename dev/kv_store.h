@@ -0,0 +1,306 @@
+#pragma once
+
+#include <functional>  //  std::ref
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <string>  //  std::string
+#include <type_traits>  //  std::is_same
+#include <utility>  //  std::move, std::declval, std::pair
+#include <vector>  //  std::vector
+
+#include "functional/cxx_optional.h"
+#include "functional/cxx_universal.h"
+#include "conditions.h"
+#include "select_constraints.h"
+#include "ast/excluded.h"
+#include "ast/upsert_clause.h"
+#include "prepared_statement.h"
+#include "column.h"
+#include "constraints.h"
+#include "table.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Row of a key-value table, see `make_kv_table()`. `Tag` tells apart tables with the same key and value
+     *  types.
+     */
+    template<class K, class V, class Tag = void>
+    struct kv_entry {
+        K key;
+        V value;
+    };
+
+    namespace internal {
+
+        /**
+         *  Values the statements of a `kv_store` are bound to by reference.
+         */
+        template<class K, class V>
+        struct kv_bindings {
+            K key;
+            V value;
+            K upper;
+        };
+
+        template<class E, class K, class V>
+        auto make_kv_get_expression(kv_bindings<K, V>& bindings) {
+            return sqlite_orm::select(&E::value, sqlite_orm::where(sqlite_orm::c(&E::key) == std::ref(bindings.key)));
+        }
+
+        template<class E, class K, class V>
+        auto make_kv_put_expression(kv_bindings<K, V>& bindings) {
+            return sqlite_orm::insert(
+                sqlite_orm::into<E>(),
+                sqlite_orm::columns(&E::key, &E::value),
+                sqlite_orm::values(std::make_tuple(std::ref(bindings.key), std::ref(bindings.value))),
+                sqlite_orm::on_conflict(&E::key).do_update(
+                    sqlite_orm::set(sqlite_orm::c(&E::value) = sqlite_orm::excluded(&E::value))));
+        }
+
+        template<class E, class K, class V>
+        auto make_kv_remove_expression(kv_bindings<K, V>& bindings) {
+            return sqlite_orm::remove_all<E>(sqlite_orm::where(sqlite_orm::c(&E::key) == std::ref(bindings.key)));
+        }
+
+        /**
+         *  Entries with `key <= key < upper` by key.
+         */
+        template<class E, class K, class V>
+        auto make_kv_range_expression(kv_bindings<K, V>& bindings) {
+            return sqlite_orm::select(sqlite_orm::columns(&E::key, &E::value),
+                                      sqlite_orm::where(sqlite_orm::c(&E::key) >= std::ref(bindings.key) and
+                                                        sqlite_orm::c(&E::key) < std::ref(bindings.upper)),
+                                      sqlite_orm::order_by(&E::key));
+        }
+
+        /**
+         *  Entries with `key <= key` by key.
+         */
+        template<class E, class K, class V>
+        auto make_kv_tail_expression(kv_bindings<K, V>& bindings) {
+            return sqlite_orm::select(sqlite_orm::columns(&E::key, &E::value),
+                                      sqlite_orm::where(sqlite_orm::c(&E::key) >= std::ref(bindings.key)),
+                                      sqlite_orm::order_by(&E::key));
+        }
+
+        /**
+         *  Key-value store over a table made by `make_kv_table<K, V, Tag>()`. Don't construct it as is, call
+         *  `storage.make_kv_store<K, V, Tag>()` instead.
+         *  Every kind of call has one statement, prepared the first time it is needed and executed again with
+         *  the new key and value: nothing is serialized or prepared twice. `put()` is an UPSERT, which updates
+         *  the value of an existing key in place, unlike REPLACE which deletes and inserts the row.
+         *  The prepared statements keep a connection of the storage borrowed for the lifetime of the store.
+         *  A store is not thread safe, make one per thread.
+         */
+        template<class S, class K, class V, class Tag>
+        struct kv_store {
+            using storage_type = S;
+            using key_type = K;
+            using value_type = V;
+            using entry_type = kv_entry<K, V, Tag>;
+            using bindings_type = kv_bindings<K, V>;
+
+            kv_store(storage_type& storage_) : storage(storage_), bindings(std::make_unique<bindings_type>()) {}
+
+            /**
+             *  Reads the value of `key` into `value`.
+             *  @return false if there is no such key, `value` is left as it is then.
+             */
+            bool get(K key, V& value) {
+                this->bindings->key = std::move(key);
+                bool found = false;
+                this->storage.for_each_row(this->get_statement(), [&value, &found](V row) {
+                    value = std::move(row);
+                    found = true;
+                    return false;
+                });
+                return found;
+            }
+
+            std::unique_ptr<V> get_pointer(K key) {
+                auto value = std::make_unique<V>();
+                return this->get(std::move(key), *value) ? std::move(value) : nullptr;
+            }
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+            std::optional<V> get_optional(K key) {
+                V value;
+                if(this->get(std::move(key), value)) {
+                    return value;
+                }
+                return std::nullopt;
+            }
+#endif
+
+            /**
+             *  Sets the value of `key`, adding the key if it doesn't exist.
+             */
+            void put(K key, V value) {
+                this->bindings->key = std::move(key);
+                this->bindings->value = std::move(value);
+                this->storage.execute(this->put_statement());
+            }
+
+            /**
+             *  Removes `key` if it exists.
+             */
+            void remove(K key) {
+                this->bindings->key = std::move(key);
+                this->storage.execute(this->remove_statement());
+            }
+
+            /**
+             *  Reads the values of the keys in [from, to) in one transaction, so they are read from one
+             *  snapshot and the database is locked once.
+             *  @return the entries of the keys that exist, in the order of the keys.
+             */
+            template<class It>
+            std::vector<std::pair<K, V>> multi_get(It from, It to) {
+                std::vector<std::pair<K, V>> res;
+                auto guard = this->storage.transaction_guard();
+                for(; from != to; ++from) {
+                    V value;
+                    if(this->get(*from, value)) {
+                        res.emplace_back(*from, std::move(value));
+                    }
+                }
+                guard.commit();
+                return res;
+            }
+
+            /**
+             *  Puts the entries in [from, to), pairs of key and value such as the elements of a `std::map`,
+             *  in one transaction.
+             */
+            template<class It>
+            void multi_put(It from, It to) {
+                auto guard = this->storage.transaction_guard();
+                for(; from != to; ++from) {
+                    this->put(from->first, from->second);
+                }
+                guard.commit();
+            }
+
+            /**
+             *  Calls `callback(key, value)` with the entries of the keys in [from, to) by key. `callback` may
+             *  return false to stop. Seeks the primary key index rather than scanning the table.
+             */
+            template<class F>
+            void scan(K from, K to, F&& callback) {
+                this->bindings->key = std::move(from);
+                this->bindings->upper = std::move(to);
+                this->scan_rows(this->range_statement(), callback);
+            }
+
+            /**
+             *  Calls `callback(key, value)` with the entries whose key starts with `prefix` by key. `callback`
+             *  may return false to stop. Text keys only: the prefix is turned into a range of keys, which seeks
+             *  the primary key index rather than scanning the table like LIKE would.
+             */
+            template<class F>
+            void scan_prefix(std::string prefix, F&& callback) {
+                static_assert(std::is_same<K, std::string>::value, "Prefix scans need std::string keys");
+                //  the least key greater than every key starting with `prefix`: keys compare byte by byte
+                std::string upper = prefix;
+                while(!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xff) {
+                    upper.pop_back();
+                }
+                this->bindings->key = std::move(prefix);
+                if(upper.empty()) {
+                    this->scan_rows(this->tail_statement(), callback);
+                } else {
+                    upper.back() = char(static_cast<unsigned char>(upper.back()) + 1);
+                    this->bindings->upper = std::move(upper);
+                    this->scan_rows(this->range_statement(), callback);
+                }
+            }
+
+            std::vector<std::pair<K, V>> scan_prefix(std::string prefix) {
+                std::vector<std::pair<K, V>> res;
+                this->scan_prefix(std::move(prefix), [&res](K key, V value) {
+                    res.emplace_back(std::move(key), std::move(value));
+                });
+                return res;
+            }
+
+          protected:
+            using get_statement_type = decltype(std::declval<S&>().prepare(
+                make_kv_get_expression<entry_type>(std::declval<bindings_type&>())));
+            using put_statement_type = decltype(std::declval<S&>().prepare(
+                make_kv_put_expression<entry_type>(std::declval<bindings_type&>())));
+            using remove_statement_type = decltype(std::declval<S&>().prepare(
+                make_kv_remove_expression<entry_type>(std::declval<bindings_type&>())));
+            using range_statement_type = decltype(std::declval<S&>().prepare(
+                make_kv_range_expression<entry_type>(std::declval<bindings_type&>())));
+            using tail_statement_type = decltype(std::declval<S&>().prepare(
+                make_kv_tail_expression<entry_type>(std::declval<bindings_type&>())));
+
+            template<class St, class F>
+            void scan_rows(const St& statement, F& callback) {
+                this->storage.for_each_row(statement, [&callback](std::tuple<K, V> row) {
+                    return call_row_callback(callback, std::move(std::get<0>(row)), std::move(std::get<1>(row)));
+                });
+            }
+
+            template<class St, class M>
+            St& statement(std::unique_ptr<St>& statement, M makeExpression) {
+                if(!statement) {
+                    statement = std::make_unique<St>(this->storage.prepare(makeExpression(*this->bindings)));
+                }
+                return *statement;
+            }
+
+            get_statement_type& get_statement() {
+                return this->statement(this->getStatement, make_kv_get_expression<entry_type, K, V>);
+            }
+
+            put_statement_type& put_statement() {
+                return this->statement(this->putStatement, make_kv_put_expression<entry_type, K, V>);
+            }
+
+            remove_statement_type& remove_statement() {
+                return this->statement(this->removeStatement, make_kv_remove_expression<entry_type, K, V>);
+            }
+
+            range_statement_type& range_statement() {
+                return this->statement(this->rangeStatement, make_kv_range_expression<entry_type, K, V>);
+            }
+
+            tail_statement_type& tail_statement() {
+                return this->statement(this->tailStatement, make_kv_tail_expression<entry_type, K, V>);
+            }
+
+            storage_type& storage;
+
+            /**
+             *  Bound by reference to the statements, allocated so that moving the store doesn't move it.
+             */
+            std::unique_ptr<bindings_type> bindings;
+            std::unique_ptr<get_statement_type> getStatement;
+            std::unique_ptr<put_statement_type> putStatement;
+            std::unique_ptr<remove_statement_type> removeStatement;
+            std::unique_ptr<range_statement_type> rangeStatement;
+            std::unique_ptr<tail_statement_type> tailStatement;
+        };
+    }
+
+    /**
+     *  Table of a key-value store, `CREATE TABLE name ("key" PRIMARY KEY, "value") WITHOUT ROWID`: the entries
+     *  are stored in the primary key index itself, so a lookup is one b-tree search. Use it with
+     *  `storage.make_kv_store<K, V, Tag>()`:
+     *  auto storage = make_storage("app.sqlite", make_kv_table<std::string, std::string>("settings"));
+     *  auto settings = storage.make_kv_store<std::string, std::string>();
+     *  settings.put("theme", "dark");
+     *  auto theme = settings.get_pointer("theme");
+     *  UPSERT needs SQLite 3.24.0.
+     */
+    template<class K, class V, class Tag = void>
+    auto make_kv_table(std::string name) {
+        using entry_type = kv_entry<K, V, Tag>;
+        return make_table<entry_type>(std::move(name),
+                                      make_column("key", &entry_type::key, primary_key()),
+                                      make_column("value", &entry_type::value))
+            .without_rowid();
+    }
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <functional>  //  std::function
+#include <memory>  //  std::shared_ptr
+#include <sstream>  //  std::stringstream
+#include <string>  //  std::string
+#include <system_error>  //  std::system_error
+#include <type_traits>  //  std::false_type, std::true_type
+#include <utility>  //  std::move
+
+#include "functional/cxx_universal.h"
+#include "error_code.h"
+#include "connection_holder.h"
+#include "statement_finalizer.h"
+#include "type_printer.h"
+#include "type_is_nullable.h"
+#include "statement_binder.h"
+#include "row_extractor.h"
+#include "field_printer.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Where the lazy columns of the objects read by one statement are loaded from: the table, its integer
+         *  primary key and a connection of the storage. It is shared by all these objects.
+         */
+        struct lazy_source {
+            std::function<connection_ref()> connection;
+            std::string schemaName;
+            std::string tableName;
+            std::string primaryKeyName;
+
+            /**
+             *  Index of the primary key column in the rows the objects are read from.
+             */
+            int primaryKeyIndex = -1;
+        };
+
+        template<class T>
+        struct is_lazy : std::false_type {};
+    }
+
+    /**
+     *  A member of type T whose column is read only when the member is used, e.g. a large `std::vector<char>`
+     *  payload of objects that are mostly read for their other members. Objects read by `get_all`, `get`,
+     *  `get_pointer` and `for_each` don't read the column, so SQLite doesn't read its overflow pages, and `get()`
+     *  loads it by a point query on the primary key. The table needs a single integer primary key and the
+     *  storage has to outlive the objects; otherwise the column is read right away. Mapping lazy columns last
+     *  spares SQLite even the overflow pages before them.
+     *  The loaded value is cached, which makes concurrent `get()` calls on the same object unsafe. Binding
+     *  the member, e.g. by `update()`, loads it first.
+     */
+    template<class T>
+    class lazy {
+      public:
+        using value_type = T;
+
+        lazy() = default;
+
+        lazy(value_type value_) : value(std::move(value_)) {}
+
+        lazy& operator=(value_type value_) {
+            this->value = std::move(value_);
+            this->loaded = true;
+            this->source.reset();
+            return *this;
+        }
+
+        const value_type& get() const {
+            if(!this->loaded) {
+                this->load();
+            }
+            return this->value;
+        }
+
+        operator const value_type&() const {
+            return this->get();
+        }
+
+        bool is_loaded() const {
+            return this->loaded;
+        }
+
+        /**
+         *  Makes the member load column `columnName` of the row whose primary key is `primaryKey` on first use.
+         */
+        void defer(std::shared_ptr<const internal::lazy_source> source_,
+                   const std::string* columnName_,
+                   sqlite3_int64 primaryKey_) {
+            this->source = std::move(source_);
+            this->columnName = columnName_;
+            this->primaryKey = primaryKey_;
+            this->loaded = false;
+        }
+
+      private:
+        mutable value_type value{};
+        mutable bool loaded = true;
+        std::shared_ptr<const internal::lazy_source> source;
+        const std::string* columnName = nullptr;
+        sqlite3_int64 primaryKey = 0;
+
+        void load() const {
+            std::stringstream ss;
+            ss << "SELECT \"" << sql_escape(*this->columnName, '"') << "\" FROM ";
+            if(!this->source->schemaName.empty()) {
+                ss << "\"" << sql_escape(this->source->schemaName, '"') << "\".";
+            }
+            ss << "\"" << sql_escape(this->source->tableName, '"') << "\" WHERE \""
+               << sql_escape(this->source->primaryKeyName, '"') << "\" = ?" << std::flush;
+            auto con = this->source->connection();
+            statement_finalizer statement{internal::prepare_stmt(con.get(), ss.str())};
+            sqlite3_stmt* stmt = statement.get();
+            if(sqlite3_bind_int64(stmt, 1, this->primaryKey) != SQLITE_OK) {
+                throw_translated_sqlite_error(stmt);
+            }
+            switch(internal::step_stmt(stmt)) {
+                case SQLITE_ROW:
+                    this->value = row_extractor<value_type>().extract(stmt, 0);
+                    break;
+                case SQLITE_DONE:
+                    throw std::system_error{orm_error_code::not_found};
+                default:
+                    throw_translated_sqlite_error(stmt);
+            }
+            this->loaded = true;
+        }
+    };
+
+    template<class T>
+    bool operator==(const lazy<T>& lhs, const lazy<T>& rhs) {
+        return lhs.get() == rhs.get();
+    }
+
+    template<class T>
+    bool operator!=(const lazy<T>& lhs, const lazy<T>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    namespace internal {
+
+        template<class T>
+        struct is_lazy<lazy<T>> : std::true_type {};
+
+        /**
+         *  Reads the column `columnIndex` into `field` or, if `source` can load it later, defers it.
+         */
+        template<class T>
+        void extract_lazy(lazy<T>& field,
+                          sqlite3_stmt* stmt,
+                          int columnIndex,
+                          const std::shared_ptr<const lazy_source>& source,
+                          const std::string& columnName) {
+            if(source) {
+                field.defer(source, &columnName, sqlite3_column_int64(stmt, source->primaryKeyIndex));
+            } else {
+                field = row_extractor<T>().extract(stmt, columnIndex);
+            }
+        }
+
+        /**
+         *  Makes the source of the lazy columns of the objects of `table`, which are loaded on a connection
+         *  returned by `connection`, or null if `table` has no lazy columns or no single integer primary key.
+         */
+        template<class Table, class F>
+        std::shared_ptr<const lazy_source> make_lazy_source(const Table& table, F connection) {
+            bool hasLazyColumns = false;
+            table.for_each_column([&hasLazyColumns](auto& column) {
+                using field_type = typename std::decay_t<decltype(column)>::field_type;
+                hasLazyColumns = hasLazyColumns || is_lazy<field_type>::value;
+            });
+            if(!hasLazyColumns) {
+                return nullptr;
+            }
+            auto primaryKeyNames = table.primary_key_column_names();
+            if(primaryKeyNames.size() != 1) {
+                return nullptr;
+            }
+            auto res = std::make_shared<lazy_source>();
+            int index = 0;
+            table.for_each_column([&res, &primaryKeyNames, &index](auto& column) {
+                using field_type = typename std::decay_t<decltype(column)>::field_type;
+                if(std::is_integral<field_type>::value && column.name == primaryKeyNames.front()) {
+                    res->primaryKeyIndex = index;
+                }
+                ++index;
+            });
+            if(res->primaryKeyIndex == -1) {
+                return nullptr;
+            }
+            res->connection = std::move(connection);
+            res->schemaName = table.schema_name;
+            res->tableName = table.name;
+            res->primaryKeyName = std::move(primaryKeyNames.front());
+            return res;
+        }
+    }
+
+    template<class T>
+    struct type_printer<lazy<T>, void> : type_printer<T> {};
+
+    template<class T>
+    struct type_is_nullable<lazy<T>, void> : type_is_nullable<T> {
+        bool operator()(const lazy<T>& value) const {
+            return type_is_nullable<T>()(value.get());
+        }
+    };
+
+    template<class T>
+    struct statement_binder<lazy<T>, void> {
+        int bind(sqlite3_stmt* stmt, int index, const lazy<T>& value) const {
+            return statement_binder<T>().bind(stmt, index, value.get());
+        }
+
+        void result(sqlite3_context* context, const lazy<T>& value) const {
+            statement_binder<T>().result(context, value.get());
+        }
+    };
+
+    template<class T>
+    struct row_extractor<lazy<T>, void> {
+        lazy<T> extract(const char* row_value) const {
+            return row_extractor<T>().extract(row_value);
+        }
+
+        lazy<T> extract(sqlite3_stmt* stmt, int columnIndex) const {
+            return row_extractor<T>().extract(stmt, columnIndex);
+        }
+
+        lazy<T> extract(sqlite3_value* value) const {
+            return row_extractor<T>().extract(value);
+        }
+    };
+
+    template<class T>
+    struct field_printer<lazy<T>, void> {
+        std::string operator()(const lazy<T>& value) const {
+            return field_printer<T>()(value.get());
+        }
+    };
+}
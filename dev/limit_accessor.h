@@ -2,7 +2,6 @@
 
 #include <sqlite3.h>
 #include <map>  //  std::map
-#include <functional>  //  std::function
 #include <memory>  //  std::shared_ptr
 
 #include "connection_holder.h"
@@ -10,11 +9,10 @@
 namespace sqlite_orm {
 
     namespace internal {
+        struct storage_base;
 
         struct limit_accessor {
-            using get_connection_t = std::function<connection_ref()>;
-
-            limit_accessor(get_connection_t get_connection_) : get_connection(std::move(get_connection_)) {}
+            explicit limit_accessor(storage_base& storage_) : storage(&storage_) {}
 
             int length() {
                 return this->get(SQLITE_LIMIT_LENGTH);
@@ -115,10 +113,15 @@ namespace sqlite_orm {
 #endif
 
           protected:
-            get_connection_t get_connection;
+            storage_base* storage;
 
             friend struct storage_base;
 
+            /**
+             *  Defined after `storage_base`, whose connection it returns.
+             */
+            connection_ref get_connection() const;
+
             /**
              *  Stores limit set between connections.
              */
@@ -23,7 +23,7 @@ namespace sqlite_orm {
             V extract(sqlite3_stmt* stmt, int /*columnIndex*/) const {
                 V res;
                 object_from_column_builder<V> builder{res, stmt};
-                this->tableInfo.for_each_column(builder);
+                build_object_columns(builder, this->tableInfo);
                 return res;
             }
 
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+#include <type_traits>  //  std::is_member_object_pointer, std::conditional_t, std::is_void, std::enable_if_t
+#include <algorithm>  //  std::find_if
+#include <tuple>  //  std::tuple, std::tuple_size, std::get
+#include <utility>  //  std::move, std::pair
+#include <system_error>  //  std::system_error
+#include <functional>  //  std::function
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
+#include "functional/static_magic.h"
+#include "tuple_helper/tuple_iteration.h"
+#include "error_code.h"
+#include "core_functions.h"
+#include "ast/time_bucket.h"
+#include "select_constraints.h"
+#include "table_type_of.h"
+#include "storage_impl.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  The column `columnName` of `row`, or of the table the statement reads if `row` is empty.
+         */
+        inline std::string materialized_row_column(const std::string& row, const std::string& columnName) {
+            return row.empty() ? quote_identifier(columnName) : row + "." + quote_identifier(columnName);
+        }
+
+        /**
+         *  How a column of the SELECT of a materialized view is maintained: a grouping column computed from the
+         *  changed row, or an aggregate changed by the delta of a row, `1` for COUNT(*). `source_type` is the
+         *  object the SELECT reads, void if the column doesn't tell it.
+         */
+        template<class T, class SFINAE = void>
+        struct materialized_term {
+            static constexpr bool supported = false;
+            using source_type = void;
+        };
+
+        template<class T>
+        struct materialized_term<T, std::enable_if_t<std::is_member_object_pointer<T>::value>> {
+            static constexpr bool supported = true;
+            static constexpr bool is_key = true;
+            static constexpr bool has_argument = true;
+            using source_type = table_type_of_t<T>;
+
+            static T column(const T& memberPointer) {
+                return memberPointer;
+            }
+
+            static std::string key(const T&, const std::string& row, const std::string& columnName) {
+                return materialized_row_column(row, columnName);
+            }
+        };
+
+        template<class O, class F>
+        struct materialized_term<time_bucket_t<O, F>, void> {
+            static constexpr bool supported = true;
+            static constexpr bool is_key = true;
+            static constexpr bool has_argument = true;
+            using source_type = O;
+
+            static F O::*column(const time_bucket_t<O, F>& bucket) {
+                return bucket.field;
+            }
+
+            static std::string
+            key(const time_bucket_t<O, F>& bucket, const std::string& row, const std::string& columnName) {
+                return time_bucket_sql(materialized_row_column(row, columnName),
+                                       bucket.seconds,
+                                       time_bucket_t<O, F>::kind);
+            }
+        };
+
+        template<class T>
+        struct materialized_count_asterisk_term {
+            static constexpr bool supported = true;
+            static constexpr bool is_key = false;
+            static constexpr bool has_argument = false;
+            using source_type = T;
+
+            static std::string delta(const std::string& /*row*/, const std::string* /*columnName*/) {
+                return "1";
+            }
+        };
+
+        template<class T>
+        struct materialized_term<count_asterisk_t<T>, void> : materialized_count_asterisk_term<T> {};
+
+        template<>
+        struct materialized_term<count_asterisk_without_type, void> : materialized_count_asterisk_term<void> {};
+
+        template<class R, class S, class X>
+        struct materialized_aggregate_term {
+            static constexpr bool supported = true;
+            static constexpr bool is_key = false;
+            static constexpr bool has_argument = true;
+            using source_type = table_type_of_t<X>;
+
+            static X column(const built_in_aggregate_function_t<R, S, X>& function) {
+                return std::get<0>(function.args);
+            }
+        };
+
+        template<class R, class X>
+        struct materialized_term<built_in_aggregate_function_t<R, count_string, X>,
+                                 std::enable_if_t<std::is_member_object_pointer<X>::value>>
+            : materialized_aggregate_term<R, count_string, X> {
+
+            static std::string delta(const std::string& row, const std::string* columnName) {
+                return "(" + row + "." + quote_identifier(*columnName) + " IS NOT NULL)";
+            }
+        };
+
+        template<class R, class S, class X>
+        struct materialized_sum_term : materialized_aggregate_term<R, S, X> {
+
+            static std::string delta(const std::string& row, const std::string* columnName) {
+                return "coalesce(" + row + "." + quote_identifier(*columnName) + ", 0)";
+            }
+        };
+
+        template<class R, class X>
+        struct materialized_term<built_in_aggregate_function_t<R, sum_string, X>,
+                                 std::enable_if_t<std::is_member_object_pointer<X>::value>>
+            : materialized_sum_term<R, sum_string, X> {};
+
+        template<class R, class X>
+        struct materialized_term<built_in_aggregate_function_t<R, total_string, X>,
+                                 std::enable_if_t<std::is_member_object_pointer<X>::value>>
+            : materialized_sum_term<R, total_string, X> {};
+
+        /**
+         *  Whether all columns of a SELECT can be maintained incrementally, and the object they read.
+         */
+        template<class Columns>
+        struct materialized_terms;
+
+        template<>
+        struct materialized_terms<std::tuple<>> {
+            static constexpr bool supported = true;
+            using source_type = void;
+        };
+
+        template<class T, class... Rest>
+        struct materialized_terms<std::tuple<T, Rest...>> {
+            static constexpr bool supported =
+                materialized_term<T>::supported && materialized_terms<std::tuple<Rest...>>::supported;
+            using source_type = std::conditional_t<std::is_void<typename materialized_term<T>::source_type>::value,
+                                                   typename materialized_terms<std::tuple<Rest...>>::source_type,
+                                                   typename materialized_term<T>::source_type>;
+        };
+
+        /**
+         *  A table of O holding the aggregates of `select`, kept up to date by triggers on the table the
+         *  SELECT reads from. Made by `make_materialized_view()`.
+         */
+        template<class O, class S>
+        struct materialized_view_t {
+            using object_type = void;
+            using aggregate_type = O;
+            using select_type = S;
+
+            /**
+             *  Prefix of the names of the triggers.
+             */
+            std::string name;
+            select_type select;
+        };
+
+        /**
+         *  SQL of a materialized view resolved against a storage: the CREATE TRIGGER statements and the statement
+         *  filling the aggregate table from the source table.
+         */
+        struct materialized_view_sql {
+            std::vector<std::pair<std::string, std::string>> triggers;
+            std::string refill;
+        };
+
+        /**
+         *  One column of the aggregate table and what the SELECT makes of it.
+         */
+        struct materialized_column {
+            std::string name;
+            bool isKey = false;
+
+            /**
+             *  The source column, null for COUNT(*).
+             */
+            const std::string* source = nullptr;
+            std::string (*delta)(const std::string& row, const std::string* columnName) = nullptr;
+
+            /**
+             *  The value of a grouping column computed from `row`, see `materialized_row_column()`.
+             */
+            std::function<std::string(const std::string& row)> key;
+        };
+
+        template<class DBOs>
+        struct materialized_column_collector {
+            const DBOs& dbObjects;
+            std::vector<materialized_column>& columns;
+            const std::vector<std::string>& aggregateNames;
+
+            template<class T>
+            void operator()(const T& expression) const {
+                using term = materialized_term<T>;
+                materialized_column column;
+                column.name = this->aggregateNames[this->columns.size()];
+                column.isKey = term::is_key;
+                static_if<!term::is_key>([&column](auto termTag) {
+                    column.delta = decltype(termTag)::type::delta;
+                })(polyfill::type_identity<term>{});
+                static_if<term::has_argument>([this, &column](auto& expression) {
+                    using expression_term = materialized_term<std::decay_t<decltype(expression)>>;
+                    column.source = find_column_name(this->dbObjects, expression_term::column(expression));
+                    if(!column.source) {
+                        throw std::system_error{orm_error_code::column_not_found};
+                    }
+                })(expression);
+                static_if<term::is_key>([&column](auto& expression) {
+                    using expression_term = materialized_term<std::decay_t<decltype(expression)>>;
+                    const std::string* source = column.source;
+                    column.key = [expression, source](const std::string& row) {
+                        return expression_term::key(expression, row, *source);
+                    };
+                })(expression);
+                this->columns.push_back(std::move(column));
+            }
+        };
+
+        /**
+         *  Builds the SQL maintaining `view` in the main schema of a storage with `dbObjects`. `AFTER` triggers
+         *  add the row inserted and subtract the row deleted from the aggregate row of its group, which is
+         *  made on the first row and removed with the last one if the view counts rows. An update does both
+         *  if it changes one of the columns the SELECT reads.
+         */
+        template<class O, class S, class DBOs>
+        materialized_view_sql make_materialized_view_sql(const materialized_view_t<O, S>& view, const DBOs& dbObjects) {
+            using columns_type = typename S::return_type::columns_type;
+            using source_type = typename materialized_terms<columns_type>::source_type;
+            using aggregate_table_type = storage_pick_table_t<O, DBOs>;
+            static_assert(filter_tuple_sequence_t<typename aggregate_table_type::elements_type, is_column>::size() ==
+                              std::tuple_size<columns_type>::value,
+                          "The table of a materialized view needs a column for every selected column");
+
+            auto& aggregateTable = pick_table<O>(dbObjects);
+            auto& sourceTable = pick_table<source_type>(dbObjects);
+            std::vector<std::string> aggregateNames;
+            aggregateTable.for_each_column([&aggregateNames](auto& column) {
+                aggregateNames.push_back(column.name);
+            });
+            std::vector<materialized_column> columns;
+            iterate_tuple(view.select.col.columns,
+                          materialized_column_collector<DBOs>{dbObjects, columns, aggregateNames});
+
+            const auto aggregateName = quote_identifier(aggregateTable.name);
+            const auto sourceName = quote_identifier(sourceTable.name);
+            auto matchesRow = [&columns](const std::string& row) {
+                std::string result;
+                for(auto& column: columns) {
+                    if(column.isKey) {
+                        result += result.empty() ? " WHERE " : " AND ";
+                        result += quote_identifier(column.name) + " IS " + column.key(row);
+                    }
+                }
+                return result;
+            };
+            auto applyRow = [&](const std::string& row, char sign) {
+                std::string result;
+                std::string names;
+                std::string initialValues;
+                std::string assignments;
+                for(auto& column: columns) {
+                    names += (names.empty() ? "" : ", ") + quote_identifier(column.name);
+                    initialValues += initialValues.empty() ? "" : ", ";
+                    if(column.isKey) {
+                        initialValues += column.key(row);
+                    } else {
+                        initialValues += "0";
+                        assignments += assignments.empty() ? "" : ", ";
+                        assignments += quote_identifier(column.name) + " = " + quote_identifier(column.name) + ' ' +
+                                       sign + ' ' + column.delta(row, column.source);
+                    }
+                }
+                if(sign == '+') {
+                    result += "INSERT INTO " + aggregateName + " (" + names + ") SELECT " + initialValues +
+                              " WHERE NOT EXISTS (SELECT 1 FROM " + aggregateName + matchesRow(row) + "); ";
+                }
+                if(!assignments.empty()) {
+                    result += "UPDATE " + aggregateName + " SET " + assignments + matchesRow(row) + "; ";
+                }
+                auto counter = std::find_if(columns.begin(), columns.end(), [](const materialized_column& column) {
+                    return !column.isKey && !column.source;
+                });
+                auto match = matchesRow(row);
+                if(sign == '-' && counter != columns.end() && !match.empty()) {
+                    result += "DELETE FROM " + aggregateName + match + " AND " + quote_identifier(counter->name) +
+                              " = 0; ";
+                }
+                return result;
+            };
+            std::string readColumns;
+            for(auto& column: columns) {
+                if(column.source &&
+                   readColumns.find(quote_identifier(*column.source)) == std::string::npos) {
+                    readColumns += (readColumns.empty() ? "" : ", ") + quote_identifier(*column.source);
+                }
+            }
+
+            materialized_view_sql result;
+            auto addTrigger = [&result, &view, &sourceName](const char* suffix, const std::string& event,
+                                                              const std::string& body) {
+                auto triggerName = view.name + suffix;
+                result.triggers.emplace_back(triggerName,
+                                             "CREATE TRIGGER " + quote_identifier(triggerName) + " AFTER " + event +
+                                                 " ON " + sourceName + " BEGIN " + body + "END");
+            };
+            addTrigger("_insert", "INSERT", applyRow("NEW", '+'));
+            addTrigger("_delete", "DELETE", applyRow("OLD", '-'));
+            if(!readColumns.empty()) {
+                addTrigger("_update", "UPDATE OF " + readColumns, applyRow("OLD", '-') + applyRow("NEW", '+'));
+            }
+
+            std::string names;
+            std::string selected;
+            std::string groupBy;
+            for(auto& column: columns) {
+                names += (names.empty() ? "" : ", ") + quote_identifier(column.name);
+                selected += selected.empty() ? "" : ", ";
+                if(column.isKey) {
+                    selected += column.key({});
+                    groupBy += (groupBy.empty() ? " GROUP BY " : ", ") + column.key({});
+                } else {
+                    //  the delta of a single row summed up over the group
+                    selected += "coalesce(SUM(" + column.delta(sourceName, column.source) + "), 0)";
+                }
+            }
+            //  without grouping columns the table gets its single row even if the source table is empty
+            result.refill = "INSERT INTO " + aggregateName + " (" + names + ") SELECT " + selected + " FROM " +
+                            sourceName + groupBy;
+            return result;
+        }
+    }
+
+    /**
+     *  Makes the table of O a materialized view of `select`: its rows hold the aggregates of the SELECT per
+     *  group and are changed by triggers whenever a row of the source table is inserted, updated or deleted,
+     *  so reading an aggregate is a lookup of one row instead of a GROUP BY over the source table.
+     *  `sync_schema()` creates the triggers, named `name` with `_insert`, `_update` and `_delete` appended, and
+     *  fills the table from the source table when it creates them. Pass it to `make_storage()` before the
+     *  tables like triggers.
+     *  The SELECT reads one table and its columns are, in the order of the columns of the table of O, the
+     *  grouping columns or `time_bucket()`s of columns, and `count()`, `count<T>()`, `count(&T::x)`,
+     *  `sum(&T::x)` or `total(&T::x)`, which can be maintained incrementally. Grouping by a time bucket makes
+     *  a rollup table of a time series. Sums of groups without values are 0 rather than NULL. The GROUP BY
+     *  of the SELECT has to list the grouping columns, the table of O doesn't need any constraint on them.
+     *  A group's row is deleted when its last source row is, if the view counts rows with `count()`.
+     *
+     *  Example:
+     *  make_materialized_view<VisitStats>("visit_stats",
+     *                                      select(columns(&Visit::userId, count(), sum(&Visit::duration)),
+     *                                             group_by(&Visit::userId)))
+     */
+    template<class O, class S>
+    internal::materialized_view_t<O, S> make_materialized_view(std::string name, S select) {
+        using columns_type = typename S::return_type::columns_type;
+        static_assert(internal::is_select_v<S>, "A materialized view is made of a SELECT");
+        static_assert(std::tuple_size<columns_type>::value > 0, "A materialized view needs columns");
+        static_assert(internal::materialized_terms<columns_type>::supported,
+                      "A materialized view selects columns, time_bucket(), count(), count(column), sum(column) and "
+                      "total(column)");
+        static_assert(!std::is_void<typename internal::materialized_terms<columns_type>::source_type>::value,
+                      "The table a materialized view reads has to be known, e.g. by count<T>() instead of count()");
+        SQLITE_ORM_CLANG_SUPPRESS_MISSING_BRACES(return {std::move(name), std::move(select)});
+    }
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cmath>  //  std::acos, std::sqrt, std::isnan, ...
+
+#include "error_code.h"
+
+namespace sqlite_orm {
+#ifdef SQLITE_ENABLE_MATH_FUNCTIONS
+
+    namespace internal {
+
+        /**
+         *  C++ implementations of the scalar math functions https://sqlite.org/lang_mathfunc.html for SQLite
+         *  libraries built without them. They behave like the built-in ones: arguments are converted to
+         *  numbers like in arithmetic, non-numeric arguments and results outside of the domain give NULL.
+         */
+        struct math_function {
+            const char* name;
+            int argumentsCount;
+            void (*callback)(sqlite3_context*, int, sqlite3_value**);
+        };
+
+        /**
+         *  `argument` as a number, false for NULL, blobs and text that doesn't look like a number.
+         */
+        inline bool math_argument(sqlite3_value* argument, double& value, bool* isInteger = nullptr) {
+            auto type = sqlite3_value_numeric_type(argument);
+            if(type != SQLITE_INTEGER && type != SQLITE_FLOAT) {
+                return false;
+            }
+            if(isInteger) {
+                *isInteger = type == SQLITE_INTEGER;
+            }
+            value = sqlite3_value_double(argument);
+            return true;
+        }
+
+        inline void math_result(sqlite3_context* context, double value) {
+            if(std::isnan(value)) {
+                sqlite3_result_null(context);
+            } else {
+                sqlite3_result_double(context, value);
+            }
+        }
+
+        template<double (*F)(double)>
+        void math_unary_function(sqlite3_context* context, int, sqlite3_value** argv) {
+            double x;
+            if(math_argument(argv[0], x)) {
+                math_result(context, F(x));
+            }
+        }
+
+        template<double (*F)(double, double)>
+        void math_binary_function(sqlite3_context* context, int, sqlite3_value** argv) {
+            double x;
+            double y;
+            if(math_argument(argv[0], x) && math_argument(argv[1], y)) {
+                math_result(context, F(x, y));
+            }
+        }
+
+        /**
+         *  CEIL, FLOOR and TRUNC return integers unchanged.
+         */
+        template<double (*F)(double)>
+        void math_rounding_function(sqlite3_context* context, int, sqlite3_value** argv) {
+            double x;
+            bool isInteger = false;
+            if(math_argument(argv[0], x, &isInteger)) {
+                if(isInteger) {
+                    sqlite3_result_int64(context, sqlite3_value_int64(argv[0]));
+                } else {
+                    math_result(context, F(x));
+                }
+            }
+        }
+
+        /**
+         *  Logarithms are NULL for arguments that aren't positive and for bases not greater than 1.
+         */
+        template<double (*F)(double)>
+        void math_logarithm_function(sqlite3_context* context, int, sqlite3_value** argv) {
+            double x;
+            if(math_argument(argv[0], x) && x > 0) {
+                math_result(context, F(x));
+            }
+        }
+
+        inline double math_log10(double x) {
+            return std::log10(x);
+        }
+
+        inline void math_log_function(sqlite3_context* context, int argc, sqlite3_value** argv) {
+            if(argc == 1) {
+                math_logarithm_function<math_log10>(context, argc, argv);
+                return;
+            }
+            double base;
+            double x;
+            if(math_argument(argv[0], base) && math_argument(argv[1], x) && base > 0 && x > 0) {
+                auto logBase = std::log(base);
+                if(logBase > 0) {
+                    math_result(context, std::log(x) / logBase);
+                }
+            }
+        }
+
+        inline void math_pi_function(sqlite3_context* context, int, sqlite3_value**) {
+            sqlite3_result_double(context, 3.141592653589793238462643383279502884);
+        }
+
+        //  wrappers pick one overload of the functions of <cmath> and give every function an address
+
+        inline double math_acos(double x) {
+            return std::acos(x);
+        }
+        inline double math_acosh(double x) {
+            return std::acosh(x);
+        }
+        inline double math_asin(double x) {
+            return std::asin(x);
+        }
+        inline double math_asinh(double x) {
+            return std::asinh(x);
+        }
+        inline double math_atan(double x) {
+            return std::atan(x);
+        }
+        inline double math_atan2(double y, double x) {
+            return std::atan2(y, x);
+        }
+        inline double math_atanh(double x) {
+            return std::atanh(x);
+        }
+        inline double math_ceil(double x) {
+            return std::ceil(x);
+        }
+        inline double math_cos(double x) {
+            return std::cos(x);
+        }
+        inline double math_cosh(double x) {
+            return std::cosh(x);
+        }
+        inline double math_degrees(double x) {
+            return x * 180.0 / 3.141592653589793238462643383279502884;
+        }
+        inline double math_exp(double x) {
+            return std::exp(x);
+        }
+        inline double math_floor(double x) {
+            return std::floor(x);
+        }
+        inline double math_ln(double x) {
+            return std::log(x);
+        }
+        inline double math_log2(double x) {
+            return std::log2(x);
+        }
+        inline double math_mod(double x, double y) {
+            return std::fmod(x, y);
+        }
+        inline double math_pow(double x, double y) {
+            return std::pow(x, y);
+        }
+        inline double math_radians(double x) {
+            return x * 3.141592653589793238462643383279502884 / 180.0;
+        }
+        inline double math_sin(double x) {
+            return std::sin(x);
+        }
+        inline double math_sinh(double x) {
+            return std::sinh(x);
+        }
+        inline double math_sqrt(double x) {
+            return std::sqrt(x);
+        }
+        inline double math_tan(double x) {
+            return std::tan(x);
+        }
+        inline double math_tanh(double x) {
+            return std::tanh(x);
+        }
+        inline double math_trunc(double x) {
+            return std::trunc(x);
+        }
+
+        /**
+         *  Registers the math functions on `db`, replacing any with the same names.
+         */
+        inline void register_math_functions(sqlite3* db) {
+            static const math_function functions[] = {
+                {"acos", 1, math_unary_function<math_acos>},
+                {"acosh", 1, math_unary_function<math_acosh>},
+                {"asin", 1, math_unary_function<math_asin>},
+                {"asinh", 1, math_unary_function<math_asinh>},
+                {"atan", 1, math_unary_function<math_atan>},
+                {"atan2", 2, math_binary_function<math_atan2>},
+                {"atanh", 1, math_unary_function<math_atanh>},
+                {"ceil", 1, math_rounding_function<math_ceil>},
+                {"ceiling", 1, math_rounding_function<math_ceil>},
+                {"cos", 1, math_unary_function<math_cos>},
+                {"cosh", 1, math_unary_function<math_cosh>},
+                {"degrees", 1, math_unary_function<math_degrees>},
+                {"exp", 1, math_unary_function<math_exp>},
+                {"floor", 1, math_rounding_function<math_floor>},
+                {"ln", 1, math_logarithm_function<math_ln>},
+                {"log", 1, math_log_function},
+                {"log", 2, math_log_function},
+                {"log10", 1, math_logarithm_function<math_log10>},
+                {"log2", 1, math_logarithm_function<math_log2>},
+                {"mod", 2, math_binary_function<math_mod>},
+                {"pi", 0, math_pi_function},
+                {"pow", 2, math_binary_function<math_pow>},
+                {"power", 2, math_binary_function<math_pow>},
+                {"radians", 1, math_unary_function<math_radians>},
+                {"sin", 1, math_unary_function<math_sin>},
+                {"sinh", 1, math_unary_function<math_sinh>},
+                {"sqrt", 1, math_unary_function<math_sqrt>},
+                {"tan", 1, math_unary_function<math_tan>},
+                {"tanh", 1, math_unary_function<math_tanh>},
+                {"trunc", 1, math_rounding_function<math_trunc>},
+            };
+#if SQLITE_VERSION_NUMBER >= 3008003
+            constexpr int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+#else
+            constexpr int flags = SQLITE_UTF8;
+#endif
+            for(auto& function: functions) {
+                auto resultCode = sqlite3_create_function_v2(db,
+                                                             function.name,
+                                                             function.argumentsCount,
+                                                             flags,
+                                                             nullptr,
+                                                             function.callback,
+                                                             nullptr,
+                                                             nullptr,
+                                                             nullptr);
+                if(resultCode != SQLITE_OK) {
+                    throw_translated_sqlite_error(db);
+                }
+            }
+        }
+
+        /**
+         *  Whether the SQLite library `db` is opened with has the math functions built in.
+         */
+        inline bool has_builtin_math_functions(sqlite3* db) {
+            sqlite3_stmt* stmt = nullptr;
+            auto resultCode = sqlite3_prepare_v2(db, "SELECT sqrt(1)", -1, &stmt, nullptr);
+            sqlite3_finalize(stmt);
+            return resultCode == SQLITE_OK;
+        }
+    }
+#endif  //  SQLITE_ENABLE_MATH_FUNCTIONS
+}
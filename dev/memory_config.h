@@ -0,0 +1,172 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <algorithm>  //  std::find
+#include <functional>  //  std::function
+#include <limits>  //  std::numeric_limits
+#include <memory>  //  std::unique_ptr
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "error_code.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Process-wide memory settings passed to `configure_memory()`. Zero values leave SQLite defaults.
+     *  https://sqlite.org/malloc.html
+     */
+    struct memory_config {
+
+        /**
+         *  Default lookaside memory of every connection (SQLITE_CONFIG_LOOKASIDE): `lookaside_slots` slots
+         *  of `lookaside_slot_size` bytes each serve small allocations without calling malloc.
+         *  `storage.lookaside()` overrides it for the connections of one storage.
+         */
+        int lookaside_slot_size = 0;
+        int lookaside_slots = 0;
+
+        /**
+         *  Page cache memory (SQLITE_CONFIG_PAGECACHE): `pagecache_slots` slots of `pagecache_slot_size` bytes,
+         *  which has to be the page size plus a small header (e.g. 4096 + 256). The memory is allocated
+         *  by `configure_memory()` and is kept until the process exits. Pages that do not fit use malloc.
+         */
+        int pagecache_slot_size = 0;
+        int pagecache_slots = 0;
+
+        /**
+         *  A fixed heap of `heap_size` bytes all allocations of SQLite come from (SQLITE_CONFIG_HEAP),
+         *  allocated by `configure_memory()`. Works only if SQLite is built with SQLITE_ENABLE_MEMSYS3
+         *  or SQLITE_ENABLE_MEMSYS5, otherwise `configure_memory()` throws.
+         */
+        int heap_size = 0;
+        int heap_min_allocation = 64;
+    };
+
+    namespace internal {
+
+        struct memory_buffers {
+            std::mutex mutex;
+            std::unique_ptr<char[]> pagecache;
+            std::unique_ptr<char[]> heap;
+
+            static memory_buffers& instance() {
+                static memory_buffers buffers;
+                return buffers;
+            }
+        };
+
+        inline void check_config_result(int rc) {
+            if(rc != SQLITE_OK) {
+                throw_translated_sqlite_error(rc);
+            }
+        }
+
+        /**
+         *  Registers a callback of `notify_memory_pressure()` for its lifetime.
+         */
+        struct memory_pressure_listener {
+            explicit memory_pressure_listener(std::function<void()> onPressure_) :
+                on_pressure(std::move(onPressure_)) {
+                auto& listeners = registry();
+                std::lock_guard<std::mutex> lock{listeners.mutex};
+                listeners.items.push_back(this);
+            }
+
+            memory_pressure_listener(const memory_pressure_listener&) = delete;
+            memory_pressure_listener& operator=(const memory_pressure_listener&) = delete;
+
+            /**
+             *  Waits for a running `notify_memory_pressure()`, so the callback is never called afterwards.
+             */
+            ~memory_pressure_listener() {
+                auto& listeners = registry();
+                std::lock_guard<std::mutex> lock{listeners.mutex};
+                listeners.items.erase(std::find(listeners.items.begin(), listeners.items.end(), this));
+            }
+
+            static void notify_all() {
+                auto& listeners = registry();
+                std::lock_guard<std::mutex> lock{listeners.mutex};
+                for(auto listener: listeners.items) {
+                    listener->on_pressure();
+                }
+            }
+
+          private:
+            struct listeners_t {
+                std::mutex mutex;
+                std::vector<memory_pressure_listener*> items;
+            };
+
+            static listeners_t& registry() {
+                static listeners_t listeners;
+                return listeners;
+            }
+
+            const std::function<void()> on_pressure;
+        };
+    }
+
+    /**
+     *  Applies `config` with `sqlite3_config`. It has to be called before the first connection of the process
+     *  is opened (or after `sqlite3_shutdown()`), otherwise it throws SQLITE_MISUSE.
+     */
+    inline void configure_memory(const memory_config& config) {
+        using internal::check_config_result;
+        auto& buffers = internal::memory_buffers::instance();
+        std::lock_guard<std::mutex> lock{buffers.mutex};
+        if(config.lookaside_slot_size > 0 && config.lookaside_slots > 0) {
+            check_config_result(
+                sqlite3_config(SQLITE_CONFIG_LOOKASIDE, config.lookaside_slot_size, config.lookaside_slots));
+        }
+        if(config.pagecache_slot_size > 0 && config.pagecache_slots > 0) {
+            //  SQLite keeps using the former buffer until the new one is set
+            std::unique_ptr<char[]> pagecache{new char[size_t(config.pagecache_slot_size) *
+                                                        size_t(config.pagecache_slots)]};
+            check_config_result(sqlite3_config(SQLITE_CONFIG_PAGECACHE,
+                                               pagecache.get(),
+                                               config.pagecache_slot_size,
+                                               config.pagecache_slots));
+            buffers.pagecache = std::move(pagecache);
+        }
+        if(config.heap_size > 0) {
+            std::unique_ptr<char[]> heap{new char[size_t(config.heap_size)]};
+            check_config_result(
+                sqlite3_config(SQLITE_CONFIG_HEAP, heap.get(), config.heap_size, config.heap_min_allocation));
+            buffers.heap = std::move(heap);
+        }
+    }
+
+    /**
+     *  Sets the soft heap limit of the process (`sqlite3_soft_heap_limit64`) in bytes and returns
+     *  the previous one. Once SQLite uses more memory it releases page cache memory before allocating,
+     *  allocations still succeed. 0 removes the limit, a negative value only returns the current one.
+     */
+    inline sqlite3_int64 soft_heap_limit(sqlite3_int64 limit) {
+        return sqlite3_soft_heap_limit64(limit);
+    }
+
+#if SQLITE_VERSION_NUMBER >= 3031001
+    /**
+     *  Sets the hard heap limit of the process (`sqlite3_hard_heap_limit64`) in bytes and returns
+     *  the previous one. Allocations beyond it fail with SQLITE_NOMEM. 0 removes the limit, a negative
+     *  value only returns the current one. The soft limit is lowered to the hard limit if it's higher.
+     */
+    inline sqlite3_int64 hard_heap_limit(sqlite3_int64 limit) {
+        return sqlite3_hard_heap_limit64(limit);
+    }
+#endif
+
+    /**
+     *  Tells sqlite_orm that the process is short of memory, e.g. from a handler of a cgroup memory
+     *  pressure notification or from a timer. Every storage that enabled `shrink_on_memory_pressure()` runs
+     *  `shrink_memory()`, then `sqlite3_release_memory` frees what it can process-wide (this needs SQLite
+     *  built with SQLITE_ENABLE_MEMORY_MANAGEMENT). May be called from any thread.
+     */
+    inline void notify_memory_pressure() {
+        internal::memory_pressure_listener::notify_all();
+        sqlite3_release_memory(std::numeric_limits<int>::max());
+    }
+}
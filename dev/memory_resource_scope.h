@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>  //  std::addressof
+#include <new>  //  ::operator new
+#include <utility>  //  std::move
+
+#include "functional/cxx_memory_resource.h"
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  The memory resource values are extracted into on this thread, null if none was given.
+         */
+        inline std::pmr::memory_resource*& scoped_memory_resource() {
+            thread_local std::pmr::memory_resource* resource = nullptr;
+            return resource;
+        }
+
+        /**
+         *  Makes `std::pmr::string` and `std::pmr::vector<char>` values extracted on this thread allocate
+         *  from `resource` for the lifetime of the scope.
+         */
+        struct memory_resource_scope {
+            explicit memory_resource_scope(std::pmr::memory_resource* resource) :
+                previous{scoped_memory_resource()} {
+                scoped_memory_resource() = resource;
+            }
+
+            memory_resource_scope(const memory_resource_scope&) = delete;
+            memory_resource_scope& operator=(const memory_resource_scope&) = delete;
+
+            ~memory_resource_scope() {
+                scoped_memory_resource() = this->previous;
+            }
+
+          private:
+            std::pmr::memory_resource* const previous;
+        };
+
+        /**
+         *  Returns the memory resource extracted values allocate from.
+         */
+        inline std::pmr::memory_resource* extraction_memory_resource() {
+            auto resource = scoped_memory_resource();
+            return resource ? resource : std::pmr::get_default_resource();
+        }
+
+        /**
+         *  Gives a default constructed field of an object being extracted the allocator of the current
+         *  scope. An allocator of a container can't be replaced by assignment, so the field is recreated
+         *  in place. Has no effect outside of a scope or if the field already uses its resource.
+         */
+        template<class F>
+        void adopt_scoped_memory_resource(F& field) noexcept {
+            auto resource = scoped_memory_resource();
+            if(!resource || field.get_allocator().resource() == resource) {
+                return;
+            }
+            F replacement{typename F::allocator_type{resource}};
+            field.~F();
+            ::new(static_cast<void*>(std::addressof(field))) F(std::move(replacement));
+        }
+    }
+}
+#endif
@@ -18,6 +18,9 @@
 #include "ast/where.h"
 #include "ast/into.h"
 #include "ast/group_by.h"
+#include "ast/with.h"
+#include "ast/row_value.h"
+#include "ast/time_bucket.h"
 
 namespace sqlite_orm {
 
@@ -64,6 +67,9 @@ namespace sqlite_orm {
         template<class T>
         struct node_tuple<excluded_t<T>, void> : node_tuple<T> {};
 
+        template<class O, class F>
+        struct node_tuple<time_bucket_t<O, F>, void> : node_tuple<F O::*> {};
+
         template<class C>
         struct node_tuple<where_t<C>, void> : node_tuple<C> {};
 
@@ -114,6 +120,9 @@ namespace sqlite_orm {
             using type = tuple_cat_t<left_tuple, right_tuple>;
         };
 
+        template<class... Args>
+        struct node_tuple<row_value_t<Args...>, void> : node_tuple<std::tuple<Args...>> {};
+
         template<class L, class... Args>
         struct node_tuple<in_t<L, Args...>, void> {
             using left_tuple = node_tuple_t<L>;
@@ -138,6 +147,14 @@ namespace sqlite_orm {
             using type = tuple_cat_t<columns_tuple, args_tuple>;
         };
 
+        template<class T, class S>
+        struct node_tuple<common_table_expression<T, S>, void> : node_tuple<S> {};
+
+        template<class... CTEs, class E>
+        struct node_tuple<with_t<std::tuple<CTEs...>, E>, void> {
+            using type = tuple_cat_t<node_tuple_t<CTEs>..., node_tuple_t<E>>;
+        };
+
         template<class... Args>
         struct node_tuple<insert_raw_t<Args...>, void> {
             using type = tuple_cat_t<node_tuple_t<Args>...>;
@@ -247,6 +264,31 @@ namespace sqlite_orm {
             using type = tuple_cat_t<node_tuple_t<Args>...>;
         };
 
+        template<class R, class S, class... Args>
+        struct node_tuple<built_in_window_function_t<R, S, Args...>, void> {
+            using type = tuple_cat_t<node_tuple_t<Args>...>;
+        };
+
+        template<class F, class... Args>
+        struct node_tuple<over_t<F, Args...>, void> {
+            using type = tuple_cat_t<node_tuple_t<F>, node_tuple_t<Args>...>;
+        };
+
+        template<class... Args>
+        struct node_tuple<partition_by_t<Args...>, void> {
+            using type = tuple_cat_t<node_tuple_t<Args>...>;
+        };
+
+        template<class... Args>
+        struct node_tuple<named_window_t<Args...>, void> {
+            using type = tuple_cat_t<node_tuple_t<Args>...>;
+        };
+
+        template<class... Windows>
+        struct node_tuple<window_t<Windows...>, void> {
+            using type = tuple_cat_t<node_tuple_t<Windows>...>;
+        };
+
         template<class F, class W>
         struct node_tuple<filtered_aggregate_function<F, W>, void> {
             using left_tuple = node_tuple_t<F>;
@@ -287,6 +329,11 @@ namespace sqlite_orm {
             using type = tuple_cat_t<case_tuple, args_tuple, else_tuple>;
         };
 
+        template<class R, class T, class K, class V>
+        struct node_tuple<dynamic_case_t<R, T, K, V>, void> {
+            using type = tuple_cat_t<node_tuple_t<T>, node_tuple_t<K>, node_tuple_t<V>>;
+        };
+
         template<class L, class R>
         struct node_tuple<std::pair<L, R>, void> {
             using left_tuple = node_tuple_t<L>;
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <functional>  //  std::less
+#include <list>  //  std::list
+#include <map>  //  std::map
+#include <memory>  //  std::shared_ptr, std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <string>  //  std::string, std::to_string
+#include <type_traits>  //  std::enable_if_t, std::is_integral
+#include <unordered_map>  //  std::unordered_map
+#include <utility>  //  std::move, std::pair
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "field_printer.h"
+#include "change_hooks.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Counters of one object cache returned by `storage.cache_stats<T>()`.
+     */
+    struct object_cache_stats {
+        size_t hits = 0;
+        size_t misses = 0;
+
+        /**
+         *  Number of entries dropped because their rows changed.
+         */
+        size_t invalidations = 0;
+
+        /**
+         *  Number of least recently used entries dropped to stay within the capacity.
+         */
+        size_t evictions = 0;
+
+        size_t size = 0;
+    };
+
+    namespace internal {
+
+        template<class T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
+        void append_object_cache_key(std::string& key, const T& value) {
+            key += std::to_string(value);
+        }
+
+        template<class T, std::enable_if_t<!std::is_integral<T>::value, bool> = true>
+        void append_object_cache_key(std::string& key, const T& value) {
+            key += field_printer<T>{}(value);
+        }
+
+        inline void append_object_cache_key(std::string& key, const char* value) {
+            key += value;
+        }
+
+        inline void append_object_cache_keys(std::string&) {}
+
+        template<class Id, class... Ids>
+        void append_object_cache_keys(std::string& key, const Id& id, const Ids&... ids) {
+            append_object_cache_key(key, id);
+            if(sizeof...(Ids) > 0) {
+                key += '\x1f';
+            }
+            append_object_cache_keys(key, ids...);
+        }
+
+        /**
+         *  Returns the key of the object with primary key `ids` in an object cache.
+         */
+        template<class... Ids>
+        std::string make_object_cache_key(const Ids&... ids) {
+            std::string key;
+            append_object_cache_keys(key, ids...);
+            return key;
+        }
+
+        /**
+         *  Least recently used objects of one table by primary key. Objects are stored type erased,
+         *  the storage knows their type.
+         *
+         *  A lookup that misses the cache reads `generation()` before querying the object and passes it
+         *  to `insert()`: if the table changed in between, or a transaction that changed it is not committed yet,
+         *  the object is not cached because it may be outdated or never be committed.
+         */
+        struct object_cache {
+            object_cache(size_t capacity_, bool keyedByRowid_) : keyedByRowid(keyedByRowid_), capacity(capacity_) {}
+
+            std::shared_ptr<const void> find(const std::string& key) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->index.find(key);
+                if(it == this->index.end()) {
+                    ++this->statistics.misses;
+                    return nullptr;
+                }
+                ++this->statistics.hits;
+                this->entries.splice(this->entries.begin(), this->entries, it->second);
+                return it->second->second;
+            }
+
+            size_t generation() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->changes;
+            }
+
+            void insert(std::string key, std::shared_ptr<const void> value, size_t generation) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if(generation != this->changes || this->writers > 0 || this->capacity == 0) {
+                    return;
+                }
+                auto it = this->index.find(key);
+                if(it != this->index.end()) {
+                    it->second->second = std::move(value);
+                    this->entries.splice(this->entries.begin(), this->entries, it->second);
+                    return;
+                }
+                this->entries.emplace_front(key, std::move(value));
+                this->index.emplace(std::move(key), this->entries.begin());
+                if(this->entries.size() > this->capacity) {
+                    this->index.erase(this->entries.back().first);
+                    this->entries.pop_back();
+                    ++this->statistics.evictions;
+                }
+            }
+
+            void invalidate(const std::string& key) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->changes;
+                auto it = this->index.find(key);
+                if(it != this->index.end()) {
+                    this->entries.erase(it->second);
+                    this->index.erase(it);
+                    ++this->statistics.invalidations;
+                }
+            }
+
+            /**
+             *  Drops the object of the row with `rowid`. Drops every object if keys are not rowids.
+             */
+            void invalidate_row(sqlite3_int64 rowid) {
+                if(this->keyedByRowid) {
+                    this->invalidate(make_object_cache_key(rowid));
+                } else {
+                    this->clear();
+                }
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->changes;
+                this->statistics.invalidations += this->entries.size();
+                this->index.clear();
+                this->entries.clear();
+            }
+
+            /**
+             *  Called when a transaction changes the table for the first time. Until `end_write()` nothing
+             *  gets cached.
+             */
+            void begin_write() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->writers;
+                ++this->changes;
+            }
+
+            void end_write() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                --this->writers;
+                ++this->changes;
+            }
+
+            object_cache_stats stats() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto result = this->statistics;
+                result.size = this->entries.size();
+                return result;
+            }
+
+            /**
+             *  True if the primary key is the rowid, i.e. a single integer column of a rowid table.
+             */
+            const bool keyedByRowid;
+            const size_t capacity;
+
+          protected:
+            using entry = std::pair<std::string, std::shared_ptr<const void>>;
+
+            std::mutex mutex;
+            size_t changes = 0;
+            int writers = 0;
+            std::list<entry> entries;
+            std::unordered_map<std::string, std::list<entry>::iterator> index;
+            object_cache_stats statistics;
+        };
+
+        /**
+         *  Object caches of a storage by table name. They are kept coherent by the change hooks of every
+         *  connection: a changed row is dropped at once, once more when its transaction commits, and nothing
+         *  of the table is cached while the transaction is open.
+         *
+         *  Adding and removing caches is not thread safe, lookups and hooks are.
+         */
+        struct object_cache_registry : change_listener {
+
+            object_cache_registry() = default;
+            object_cache_registry(const object_cache_registry&) = delete;
+            object_cache_registry& operator=(const object_cache_registry&) = delete;
+
+            bool empty() const {
+                return this->caches.empty();
+            }
+
+            object_cache* find(const std::string& table) const {
+                auto it = this->caches.find(table);
+                return it != this->caches.end() ? it->second.get() : nullptr;
+            }
+
+            void add(const std::string& table, size_t capacity, bool keyedByRowid) {
+                this->remove(table);
+                this->caches[table] = std::make_unique<object_cache>(capacity, keyedByRowid);
+            }
+
+            void remove(const std::string& table) {
+                auto it = this->caches.find(table);
+                if(it == this->caches.end()) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock{this->mutex};
+                for(auto& pair: this->connections) {
+                    pair.second.pending.erase(it->second.get());
+                    pair.second.committed.erase(it->second.get());
+                }
+                this->caches.erase(it);
+            }
+
+            /**
+             *  Drops the objects of every cache.
+             */
+            void clear() {
+                for(auto& pair: this->caches) {
+                    pair.second->clear();
+                }
+            }
+
+            /**
+             *  Called after a COMMIT of `db` has finished. The commit hook runs before the transaction
+             *  is visible to other connections, which may have cached rows as they were before.
+             */
+            void committed(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it != this->connections.end()) {
+                    for(auto& pair: it->second.committed) {
+                        pair.second.invalidate(*pair.first);
+                    }
+                    it->second.committed.clear();
+                }
+            }
+
+            bool listening() const override {
+                return !this->empty();
+            }
+
+            void changed(sqlite3* db, int /*operation*/, const char* table, sqlite3_int64 rowid) override {
+                auto it = this->caches.find(table);
+                if(it == this->caches.end()) {
+                    return;
+                }
+                auto& cache = *it->second;
+                std::lock_guard<std::mutex> lock{this->mutex};
+                cache.invalidate_row(rowid);
+                auto inserted = this->connections[db].pending.emplace(&cache, changed_rows{});
+                if(inserted.second) {
+                    cache.begin_write();
+                }
+                auto& rows = inserted.first->second;
+                if(rows.all) {
+                    return;
+                }
+                //  remembering more rows than the cache can hold is pointless
+                if(cache.keyedByRowid && rows.rowids.size() < cache.capacity) {
+                    rows.rowids.push_back(rowid);
+                } else {
+                    rows.rowids.clear();
+                    rows.all = true;
+                }
+            }
+
+            void commit(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it == this->connections.end()) {
+                    return;
+                }
+                auto& changes = it->second;
+                for(auto& pair: changes.pending) {
+                    pair.second.invalidate(*pair.first);
+                    pair.first->end_write();
+                }
+                changes.committed = std::move(changes.pending);
+                changes.pending.clear();
+            }
+
+            void rollback(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it != this->connections.end()) {
+                    it->second.end_writes();
+                }
+            }
+
+            void closed(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it != this->connections.end()) {
+                    it->second.end_writes();
+                    this->connections.erase(it);
+                }
+            }
+
+          protected:
+            struct changed_rows {
+                std::vector<sqlite3_int64> rowids;
+                bool all = false;
+
+                void invalidate(object_cache& cache) const {
+                    if(this->all) {
+                        cache.clear();
+                    } else {
+                        for(auto rowid: this->rowids) {
+                            cache.invalidate_row(rowid);
+                        }
+                    }
+                }
+            };
+
+            /**
+             *  Rows a connection changed in its current transaction and in its last committed one.
+             */
+            struct connection_changes {
+                std::map<object_cache*, changed_rows> pending;
+                std::map<object_cache*, changed_rows> committed;
+
+                void end_writes() {
+                    for(auto& pair: this->pending) {
+                        pair.first->end_write();
+                    }
+                    this->pending.clear();
+                    this->committed.clear();
+                }
+            };
+
+            std::map<std::string, std::unique_ptr<object_cache>, std::less<>> caches;
+            std::mutex mutex;
+            std::map<sqlite3*, connection_changes> connections;
+        };
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <tuple>  //  std::tuple, std::get, std::tuple_element_t, std::make_tuple
+#include <utility>  //  std::index_sequence, std::index_sequence_for
+#include <vector>  //  std::vector
+
+#include "functional/cxx_optional.h"
+#include "functional/cxx_universal.h"
+#include "tuple_helper/tuple_iteration.h"
+#include "select_constraints.h"
+#include "storage_lookup.h"
+#include "storage_impl.h"
+#include "object_from_column_builder.h"
+#include "row_extractor_builder.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Element of a row of `object_columns_extractor`, reading the column(s) of `Col` into `field`.
+         */
+        template<class Col, class F>
+        struct object_columns_element {
+            F& field;
+        };
+
+        /**
+         *  Row extractor of `columns()` with `object<T>()` among them, such as the objects of the tables of a join.
+         *  Every object is built from the columns of its table by `object_from_column_builder`, starting after the
+         *  columns of the elements before it; other elements take one column each.
+         *  R is the tuple the row is read into.
+         */
+        template<class R, class DBOs, class... Cols>
+        struct object_columns_extractor {
+            const DBOs& dbObjects;
+
+            R extract(sqlite3_stmt* stmt, int columnIndex) const {
+                R row;
+                this->extract_into(row, stmt, columnIndex);
+                return row;
+            }
+
+            void extract_into(R& row, sqlite3_stmt* stmt, int columnIndex) const {
+                this->extract_into(row, stmt, columnIndex, std::index_sequence_for<Cols...>{});
+            }
+
+          private:
+            template<size_t... Idx>
+            void extract_into(R& row, sqlite3_stmt* stmt, int columnIndex, std::index_sequence<Idx...>) const {
+                auto elements = std::make_tuple(
+                    object_columns_element<Cols, std::tuple_element_t<Idx, R>>{std::get<Idx>(row)}...);
+                iterate_tuple(elements, [this, stmt, &columnIndex](auto& element) {
+                    this->extract_element(element, stmt, columnIndex);
+                });
+            }
+
+            template<class Col, class F>
+            void extract_element(const object_columns_element<Col, F>& element, sqlite3_stmt* stmt, int& columnIndex) const {
+                internal::extract_into(element.field, stmt, columnIndex++);
+            }
+
+            template<class O>
+            void extract_element(const object_columns_element<object_t<O>, O>& element,
+                                 sqlite3_stmt* stmt,
+                                 int& columnIndex) const {
+                object_from_column_builder<O> builder{element.field, stmt};
+                builder.index = columnIndex;
+                build_object_columns(builder, pick_table<O>(this->dbObjects));
+                columnIndex = builder.index;
+            }
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+            template<class O>
+            void extract_element(const object_columns_element<optional_object_t<O>, std::optional<O>>& element,
+                                 sqlite3_stmt* stmt,
+                                 int& columnIndex) const {
+                auto& table = pick_table<O>(this->dbObjects);
+                const int end = columnIndex + table.count_columns_amount() + (table.rowid_member ? 1 : 0);
+                bool matched = false;
+                for(int index = columnIndex; index < end && !matched; ++index) {
+                    matched = sqlite3_column_type(stmt, index) != SQLITE_NULL;
+                }
+                if(matched) {
+                    object_from_column_builder<O> builder{element.field.emplace(), stmt};
+                    builder.index = columnIndex;
+                    build_object_columns(builder, table);
+                } else {
+                    element.field.reset();
+                }
+                columnIndex = end;
+            }
+#endif
+        };
+
+        template<class R, class DBOs, class... Cols>
+        void append_row(std::vector<R>& rows,
+                        const object_columns_extractor<R, DBOs, Cols...>& rowExtractor,
+                        sqlite3_stmt* stmt) {
+            rows.emplace_back();
+            rowExtractor.extract_into(rows.back(), stmt, 0);
+        }
+
+        template<class R, class DBOs, class... Cols>
+        object_columns_extractor<R, DBOs, Cols...> make_object_columns_extractor(const DBOs& dbObjects,
+                                                                                 const columns_t<Cols...>*) {
+            return {dbObjects};
+        }
+
+        /**
+         *  Row extractor for the rows of type R of a select of the result columns T.
+         */
+        template<class R, class T, class DBOs, std::enable_if_t<!has_object_columns_v<T>, bool> = true>
+        auto make_select_row_extractor(const DBOs& dbObjects) {
+            return make_row_extractor<R>(lookup_table<R>(dbObjects));
+        }
+
+        template<class R, class T, class DBOs, std::enable_if_t<has_object_columns_v<T>, bool> = true>
+        auto make_select_row_extractor(const DBOs& dbObjects) {
+            return make_object_columns_extractor<R>(dbObjects, (const T*)nullptr);
+        }
+    }
+}
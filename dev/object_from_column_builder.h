@@ -1,15 +1,179 @@
 #pragma once
 
 #include <sqlite3.h>
-#include <type_traits>  //  std::is_member_object_pointer
+#include <type_traits>  //  std::is_member_object_pointer, std::is_base_of, std::decay_t, std::enable_if_t
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+#include <utility>  //  std::move, std::index_sequence, std::index_sequence_for, std::make_index_sequence
+#include <tuple>  //  std::tuple, std::get, std::tuple_element_t
+#include <memory>  //  std::shared_ptr
+#include <algorithm>  //  std::copy
+#include <system_error>  //  std::system_error
+#if SQLITE_ORM_HAS_INCLUDE(<span>)
+#include <span>  //  std::span
+#endif
 
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
 #include "functional/static_magic.h"
+#include "tuple_helper/tuple_filter.h"
+#include "tuple_helper/tuple_iteration.h"
+#include "error_code.h"
+#include "byte_vector.h"
 #include "row_extractor.h"
+#include "memory_resource_scope.h"
+#include "conditions.h"
+#include "column.h"
+#include "lazy.h"
 
 namespace sqlite_orm {
 
+    /**
+     *  Makes the objects of type O read by `get_all()` and `get_all_into()` if O isn't default constructible.
+     *  It's called with the values of all the mapped columns of O, in the order of the columns, and passes them to
+     *  `O{...}` by default: an aggregate or a constructor taking the columns in order. Specialize it to construct
+     *  the objects some other way, e.g. by a factory function.
+     */
+    template<class O, class SFINAE = void>
+    struct object_factory {
+        template<class... Fields>
+        O operator()(Fields... fields) const {
+            return O{std::move(fields)...};
+        }
+    };
+
     namespace internal {
 
+        /**
+         *  Extracts a column value into an existing field. Strings and blobs are assigned in place
+         *  so that an object reused for many rows keeps the capacity of its members.
+         */
+        template<class T>
+        void extract_into(T& field, sqlite3_stmt* stmt, int columnIndex) {
+            field = row_extractor<T>().extract(stmt, columnIndex);
+        }
+
+        inline void extract_into(std::string& field, sqlite3_stmt* stmt, int columnIndex) {
+            if(auto cStr = (const char*)sqlite3_column_text(stmt, columnIndex)) {
+                field.assign(cStr, size_t(sqlite3_column_bytes(stmt, columnIndex)));
+            } else {
+                field.clear();
+            }
+        }
+
+        inline void extract_into(std::vector<char>& field, sqlite3_stmt* stmt, int columnIndex) {
+            auto bytes = static_cast<const char*>(sqlite3_column_blob(stmt, columnIndex));
+            field.assign(bytes, bytes + sqlite3_column_bytes(stmt, columnIndex));
+        }
+
+        template<class B, std::enable_if_t<is_blob_byte_v<B>, bool> = true>
+        void extract_into(std::vector<B>& field, sqlite3_stmt* stmt, int columnIndex) {
+            auto bytes = static_cast<const B*>(sqlite3_column_blob(stmt, columnIndex));
+            field.assign(bytes, bytes + sqlite3_column_bytes(stmt, columnIndex));
+        }
+
+#if __cpp_lib_span >= 202002L
+        /**
+         *  Copies a BLOB into the caller's buffer `field` refers to and shrinks `field` to the copied bytes.
+         *  Throws `orm_error_code::blob_exceeds_buffer` if the BLOB doesn't fit, leaving the buffer as it was.
+         */
+        inline void extract_into(std::span<std::byte>& field, sqlite3_stmt* stmt, int columnIndex) {
+            auto bytes = static_cast<const std::byte*>(sqlite3_column_blob(stmt, columnIndex));
+            auto len = size_t(sqlite3_column_bytes(stmt, columnIndex));
+            if(len > field.size()) {
+                throw std::system_error{orm_error_code::blob_exceeds_buffer};
+            }
+            std::copy(bytes, bytes + len, field.begin());
+            field = field.first(len);
+        }
+#endif
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+        inline void extract_into(std::pmr::string& field, sqlite3_stmt* stmt, int columnIndex) {
+            adopt_scoped_memory_resource(field);
+            if(auto cStr = (const char*)sqlite3_column_text(stmt, columnIndex)) {
+                field.assign(cStr, size_t(sqlite3_column_bytes(stmt, columnIndex)));
+            } else {
+                field.clear();
+            }
+        }
+
+        inline void extract_into(std::pmr::vector<char>& field, sqlite3_stmt* stmt, int columnIndex) {
+            adopt_scoped_memory_resource(field);
+            auto bytes = static_cast<const char*>(sqlite3_column_blob(stmt, columnIndex));
+            field.assign(bytes, bytes + sqlite3_column_bytes(stmt, columnIndex));
+        }
+#endif
+
+#ifdef SQLITE_ORM_FOLD_EXPRESSIONS_SUPPORTED
+        template<class Row, size_t... Idx>
+        void extract_elements_into(Row& row, sqlite3_stmt* stmt, int columnIndex, std::index_sequence<Idx...>) {
+            (extract_into(std::get<Idx>(row), stmt, columnIndex + int(Idx)), ...);
+        }
+#else
+        template<class Row>
+        void extract_elements_into(Row&, sqlite3_stmt*, int, std::index_sequence<>) {}
+
+        template<class Row, size_t I, size_t... Idx>
+        void extract_elements_into(Row& row, sqlite3_stmt* stmt, int columnIndex, std::index_sequence<I, Idx...>) {
+            extract_into(std::get<I>(row), stmt, columnIndex + int(I));
+            extract_elements_into(row, stmt, columnIndex, std::index_sequence<Idx...>{});
+        }
+#endif
+
+        /**
+         *  Extracts the columns of a row starting at `columnIndex` into the elements of `row`, in place like the
+         *  fields of an object. The loop over the elements is unrolled at compile time.
+         */
+        template<class... Args>
+        void extract_into(std::tuple<Args...>& row, sqlite3_stmt* stmt, int columnIndex) {
+            extract_elements_into(row, stmt, columnIndex, std::index_sequence_for<Args...>{});
+        }
+
+        template<class Row, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_tuple_like_v = false;
+
+        template<class Row>
+        SQLITE_ORM_INLINE_VAR constexpr bool
+            is_tuple_like_v<Row, polyfill::void_t<decltype(std::tuple_size<Row>::value)>> = !is_byte_array_v<Row>;
+
+        /**
+         *  Extracts the current row of `stmt` into `row` of a caller's buffer, each column as the type it is stored
+         *  in: column I into element I of a tuple-like row such as `std::pair`, `std::tuple` or `std::array`,
+         *  column 0 into any other row. Arrays of bytes are BLOBs rather than rows.
+         */
+        template<class Row, std::enable_if_t<is_tuple_like_v<Row>, bool> = true>
+        void extract_flat_row(Row& row, sqlite3_stmt* stmt) {
+            extract_elements_into(row, stmt, 0, std::make_index_sequence<std::tuple_size<Row>::value>{});
+        }
+
+        template<class Row, std::enable_if_t<!is_tuple_like_v<Row>, bool> = true>
+        void extract_flat_row(Row& row, sqlite3_stmt* stmt) {
+            extract_into(row, stmt, 0);
+        }
+
+        template<class R>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_fillable_row_v = false;
+
+        template<class... Args>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_fillable_row_v<std::tuple<Args...>> =
+            polyfill::conjunction_v<std::is_default_constructible<Args>..., std::is_move_assignable<Args>...>;
+
+        /**
+         *  Appends the current row of `stmt` to `rows`. A tuple row is default constructed at the end of `rows` and
+         *  filled there, other rows are extracted by `rowExtractor` and moved in.
+         */
+        template<class R, class E, std::enable_if_t<!is_fillable_row_v<R>, bool> = true>
+        void append_row(std::vector<R>& rows, const E& rowExtractor, sqlite3_stmt* stmt) {
+            rows.push_back(rowExtractor.extract(stmt, 0));
+        }
+
+        template<class R, class E, std::enable_if_t<is_fillable_row_v<R>, bool> = true>
+        void append_row(std::vector<R>& rows, const E&, sqlite3_stmt* stmt) {
+            rows.emplace_back();
+            extract_into(rows.back(), stmt, 0);
+        }
+
         struct object_from_column_builder_base {
             sqlite3_stmt* stmt = nullptr;
             int index = 0;
@@ -28,18 +192,164 @@ namespace sqlite_orm {
 
             object_type& object;
 
-            object_from_column_builder(object_type& object_, sqlite3_stmt* stmt_) :
+            /**
+             *  Source of `lazy` members, which are read right away if it is null.
+             */
+            std::shared_ptr<const lazy_source> lazySource;
+
+            object_from_column_builder(object_type& object_,
+                                       sqlite3_stmt* stmt_,
+                                       std::shared_ptr<const lazy_source> lazySource_ = nullptr) :
+                object_from_column_builder_base{stmt_},
+                object(object_), lazySource(std::move(lazySource_)) {}
+
+            template<class G, class S, class... Op>
+            void operator()(const column_t<G, S, Op...>& column) {
+                const int columnIndex = this->index++;
+                static_if<is_lazy<member_field_type_t<G>>::value>(
+                    [this, columnIndex](const auto& column) {
+                        extract_lazy(this->object.*column.member_pointer,
+                                     this->stmt,
+                                     columnIndex,
+                                     this->lazySource,
+                                     column.name);
+                    },
+                    [this, columnIndex](const auto& column) {
+                        this->extract_column(column, columnIndex);
+                    })(column);
+            }
+
+          private:
+            template<class G, class S>
+            void extract_column(const column_field<G, S>& column, int columnIndex) {
+                static_if<std::is_member_object_pointer<G>::value>(
+                    [stmt = this->stmt, columnIndex, &object = this->object](const auto& column) {
+                        extract_into(object.*column.member_pointer, stmt, columnIndex);
+                    },
+                    [stmt = this->stmt, columnIndex, &object = this->object](const auto& column) {
+                        static_if<is_read_only_field_v<G, S>>(
+                            [stmt, columnIndex, &object](const auto& column) {
+                                extract_into(read_only_field(object, column.member_pointer), stmt, columnIndex);
+                            },
+                            [stmt, columnIndex, &object](const auto& column) {
+                                (object.*column.setter)(
+                                    row_extractor<member_field_type_t<G>>().extract(stmt, columnIndex));
+                            })(column);
+                    })(column);
+            }
+        };
+
+        /**
+         *  Same as `object_from_column_builder` for the member pointers of `only()`, in their order.
+         */
+        template<class O>
+        struct object_from_only_builder : object_from_column_builder_base {
+            using object_type = O;
+
+            object_type& object;
+
+            object_from_only_builder(object_type& object_, sqlite3_stmt* stmt_) :
                 object_from_column_builder_base{stmt_}, object(object_) {}
 
+            template<class F, class C>
+            void operator()(F C::*memberPointer) {
+                static_assert(std::is_base_of<C, object_type>::value, "only() column of another type");
+                extract_into(this->object.*memberPointer, this->stmt, this->index++);
+            }
+        };
+
+        /**
+         *  Reads all the columns of `table` into the object of `builder`, then the rowid that follows them
+         *  if the table has a rowid member.
+         */
+        template<class O, class Table>
+        void build_object_columns(object_from_column_builder<O>& builder, const Table& table) {
+            table.for_each_column(builder);
+            if(table.rowid_member) {
+                builder.object.*table.rowid_member = sqlite3_column_int64(builder.stmt, builder.index++);
+            }
+        }
+
+        /**
+         *  Fills `object` from a row of a `get_all` like statement with `conditions`: the columns of `only()`
+         *  if they contain it, all the columns of `table` otherwise, `lazy` members being deferred to
+         *  `lazySource`.
+         */
+        template<class O, class Table, class Conditions>
+        void build_object(O& object,
+                          sqlite3_stmt* stmt,
+                          const Table& table,
+                          const Conditions& conditions,
+                          const std::shared_ptr<const lazy_source>& lazySource = nullptr) {
+            bool partial = false;
+            iterate_tuple(conditions, [&object, stmt, &partial](auto& condition) {
+                call_if_constexpr<is_only<std::decay_t<decltype(condition)>>::value>(
+                    [&object, stmt, &partial](auto& only) {
+                        object_from_only_builder<O> builder{object, stmt};
+                        iterate_tuple(only.columns, builder);
+                        partial = true;
+                    },
+                    condition);
+            });
+            if(!partial) {
+                object_from_column_builder<O> builder{object, stmt, lazySource};
+                build_object_columns(builder, table);
+            }
+        }
+
+        template<class O, class Elements, size_t... Idx, size_t... Pos>
+        O make_object(sqlite3_stmt* stmt, std::index_sequence<Idx...>, std::index_sequence<Pos...>) {
+            return object_factory<O>{}(
+                row_extractor<typename std::tuple_element_t<Idx, Elements>::field_type>().extract(stmt, int(Pos))...);
+        }
+
+        /**
+         *  Makes an object of `table` from all its columns in the current row of `stmt` by `object_factory<O>`.
+         */
+        template<class O, class Table>
+        O make_object(sqlite3_stmt* stmt, const Table& table) {
+            using elements_type = typename Table::elements_type;
+            using col_index_sequence = filter_tuple_sequence_t<elements_type, is_column>;
+            O object = make_object<O, elements_type>(stmt,
+                                                     col_index_sequence{},
+                                                     std::make_index_sequence<col_index_sequence::size()>{});
+            if(table.rowid_member) {
+                object.*table.rowid_member = sqlite3_column_int64(stmt, int(col_index_sequence::size()));
+            }
+            return object;
+        }
+
+        /**
+         *  Same as `object_from_column_builder` but reads column values from `sqlite3_value`s, e.g. the ones
+         *  of the preupdate hook. `value_of` returns the value of a column by its index.
+         */
+        template<class O, class F>
+        struct object_from_value_builder {
+            using object_type = O;
+
+            object_type& object;
+            F value_of;
+            int index = 0;
+
+            object_from_value_builder(object_type& object_, F valueOf) :
+                object(object_), value_of(std::move(valueOf)) {}
+
             template<class G, class S>
             void operator()(const column_field<G, S>& column) {
-                auto value = row_extractor<member_field_type_t<G>>().extract(this->stmt, this->index++);
+                sqlite3_value* value = this->value_of(this->index++);
                 static_if<std::is_member_object_pointer<G>::value>(
-                    [&value, &object = this->object](const auto& column) {
-                        object.*column.member_pointer = std::move(value);
+                    [value, &object = this->object](const auto& column) {
+                        object.*column.member_pointer = row_extractor<member_field_type_t<G>>().extract(value);
                     },
-                    [&value, &object = this->object](const auto& column) {
-                        (object.*column.setter)(std::move(value));
+                    [value, &object = this->object](const auto& column) {
+                        static_if<is_read_only_field_v<G, S>>(
+                            [value, &object](const auto& column) {
+                                read_only_field(object, column.member_pointer) =
+                                    row_extractor<member_field_type_t<G>>().extract(value);
+                            },
+                            [value, &object](const auto& column) {
+                                (object.*column.setter)(row_extractor<member_field_type_t<G>>().extract(value));
+                            })(column);
                     })(column);
             }
         };
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace sqlite_orm {
+
+    /**
+     *  When a storage runs `PRAGMA optimize` on its own, set with `storage.auto_optimize`.
+     *  https://www.sqlite.org/pragma.html#pragma_optimize recommends running it before closing
+     *  a connection and after the schema changed, so that the query planner has current statistics.
+     */
+    struct optimize_options {
+
+        /**
+         *  Run `PRAGMA optimize = 0x10002` at the end of `sync_schema()`, which analyzes tables
+         *  that have no statistics yet, e.g. ones whose indexes were just created. SQLite before 3.46.0
+         *  would optimize only tables queried by the connection, so it runs `ANALYZE` instead.
+         */
+        bool after_sync_schema = false;
+
+        /**
+         *  Run `PRAGMA optimize` before a connection is closed. A storage that neither is in memory nor is
+         *  opened forever closes its connection after every call, so combine it with `open_forever()`.
+         */
+        bool on_close = false;
+
+        /**
+         *  `PRAGMA analysis_limit` set for the optimizations above, so they do not have to read whole
+         *  tables. 0 reads whole tables.
+         */
+        int analysis_limit = 400;
+    };
+}
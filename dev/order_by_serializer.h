@@ -1,7 +1,8 @@
 #pragma once
 
 #include <string>  //  std::string
-#include <sstream>  //  std::stringstream
+
+#include "pooled_stringstream.h"
 
 namespace sqlite_orm {
 
@@ -22,7 +23,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& orderBy, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto newContext = context;
                 newContext.skip_table_name = false;
 
@@ -46,31 +47,13 @@ namespace sqlite_orm {
         struct order_by_serializer<dynamic_order_by_t<C>, void> {
             using statement_type = dynamic_order_by_t<C>;
 
+            //  without terms there is no ORDER BY
             template<class Ctx>
             std::string operator()(const statement_type& orderBy, const Ctx&) const {
-                std::stringstream ss;
-                ss << static_cast<std::string>(orderBy) << " ";
-                int index = 0;
-                for(const dynamic_order_by_entry_t& entry: orderBy) {
-                    if(index > 0) {
-                        ss << ", ";
-                    }
-
-                    ss << entry.name;
-                    if(!entry._collate_argument.empty()) {
-                        ss << " COLLATE " << entry._collate_argument;
-                    }
-                    switch(entry.asc_desc) {
-                        case 1:
-                            ss << " ASC";
-                            break;
-                        case -1:
-                            ss << " DESC";
-                            break;
-                    }
-                    ++index;
-                };
-                return ss.str();
+                if(orderBy.terms().empty()) {
+                    return {};
+                }
+                return static_cast<std::string>(orderBy) + " " + orderBy.terms();
             }
         };
 
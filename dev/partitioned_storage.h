@@ -0,0 +1,345 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstdlib>  //  std::strtoll
+#include <functional>  //  std::function
+#include <iomanip>  //  std::setw, std::setfill
+#include <iterator>  //  std::make_move_iterator
+#include <map>  //  std::map
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <sstream>  //  std::stringstream
+#include <string>  //  std::string, std::to_string
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_functional_polyfill.h"
+#include "member_traits/member_traits.h"
+#include "ast/where.h"
+#include "conditions.h"
+#include "table_type_of.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  How the rows of a partitioned table are split: `number_of(key)` is the partition number of the rows with
+     *  the partition key `key` and must not decrease when the key grows. The partition with number `n` is the
+     *  table `<prefix>_<suffix_of(n)>`. `parse_suffix` is the inverse of `suffix_of` and is used to find the
+     *  partitions that already exist.
+     */
+    template<class K>
+    struct partition_scheme {
+        std::function<sqlite3_int64(const K&)> number_of;
+        std::function<std::string(sqlite3_int64)> suffix_of;
+        std::function<bool(const std::string&, sqlite3_int64&)> parse_suffix;
+    };
+
+    /**
+     *  Partitions named by their number, like `events_0`, `events_1`.
+     *  Example: numbered_partitions<int>([](const int& id) {
+     *               return id / 1000000;
+     *           })
+     */
+    template<class K>
+    partition_scheme<K> numbered_partitions(std::function<sqlite3_int64(const K&)> numberOf) {
+        return {std::move(numberOf),
+                [](sqlite3_int64 number) {
+                    return std::to_string(number);
+                },
+                [](const std::string& suffix, sqlite3_int64& number) {
+                    if(suffix.empty()) {
+                        return false;
+                    }
+                    char* end = nullptr;
+                    number = std::strtoll(suffix.c_str(), &end, 10);
+                    return *end == '\0';
+                }};
+    }
+
+    /**
+     *  One partition per UTC month of a key counting seconds since the Unix epoch, like `metrics_2026_10`.
+     */
+    inline partition_scheme<sqlite3_int64> monthly_partitions() {
+        return {[](const sqlite3_int64& seconds) -> sqlite3_int64 {
+                    //  civil date of a day count, see http://howardhinnant.github.io/date_algorithms.html
+                    auto days = seconds / 86400 - (seconds % 86400 < 0 ? 1 : 0);
+                    auto z = days + 719468;
+                    auto era = (z >= 0 ? z : z - 146096) / 146097;
+                    auto dayOfEra = z - era * 146097;
+                    auto yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+                    auto dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+                    auto shiftedMonth = (5 * dayOfYear + 2) / 153;
+                    auto month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+                    auto year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+                    return year * 12 + month - 1;
+                },
+                [](sqlite3_int64 number) {
+                    std::stringstream ss;
+                    ss << number / 12 << '_' << std::setw(2) << std::setfill('0') << number % 12 + 1;
+                    return ss.str();
+                },
+                [](const std::string& suffix, sqlite3_int64& number) {
+                    if(suffix.size() != 7 || suffix[4] != '_') {
+                        return false;
+                    }
+                    char* end = nullptr;
+                    auto year = std::strtoll(suffix.c_str(), &end, 10);
+                    if(end != suffix.c_str() + 4) {
+                        return false;
+                    }
+                    auto month = std::strtoll(suffix.c_str() + 5, &end, 10);
+                    if(*end != '\0' || month < 1 || month > 12) {
+                        return false;
+                    }
+                    number = year * 12 + month - 1;
+                    return true;
+                }};
+    }
+
+    namespace internal {
+
+        /**
+         *  One mapped type stored in several tables, one per partition of its partition key. Don't construct
+         *  it as is, call `make_partitioned_storage()` instead.
+         *  Every partition is a storage made by the partition factory for the name of the partition's table, so
+         *  partitions may live in one file, in files of their own or in attached databases. Writes go to the
+         *  partition of the object's key, creating it when needed. Range queries like `get_all_between()` read
+         *  only the partitions which can hold keys of the range, and old rows are dropped a partition at a time
+         *  by `drop_partitions_before()` instead of being deleted row by row.
+         */
+        template<class S, class M>
+        struct partitioned_storage {
+            using storage_type = S;
+            using object_type = table_type_of_t<M>;
+            using key_type = member_field_type_t<M>;
+            using partition_factory = std::function<storage_type(const std::string&)>;
+
+            partitioned_storage(std::string prefix_,
+                                M member_,
+                                partition_scheme<key_type> scheme_,
+                                partition_factory makePartition_) :
+                prefix(std::move(prefix_)),
+                member(std::move(member_)), scheme(std::move(scheme_)), makePartition(std::move(makePartition_)) {
+                this->refresh();
+            }
+
+            /**
+             *  Looks for the partitions which exist in the database of the partition factory, e.g. which were created
+             *  by another process.
+             */
+            void refresh() {
+                auto namePrefix = this->prefix + "_";
+                auto catalog = this->makePartition(this->prefix);
+                for(auto& tableName: catalog.table_names()) {
+                    sqlite3_int64 number = 0;
+                    if(tableName.compare(0, namePrefix.size(), namePrefix) == 0 &&
+                       this->scheme.parse_suffix(tableName.substr(namePrefix.size()), number) &&
+                       !this->partitions.count(number)) {
+                        this->partitions.emplace(number,
+                                                 std::make_unique<storage_type>(this->makePartition(tableName)));
+                    }
+                }
+            }
+
+            /**
+             *  @return name of the table which holds the rows with the partition key `key`.
+             */
+            std::string partition_name(const key_type& key) const {
+                return this->table_name(this->scheme.number_of(key));
+            }
+
+            /**
+             *  @return names of the existing partitions in key order.
+             */
+            std::vector<std::string> partition_names() const {
+                std::vector<std::string> res;
+                res.reserve(this->partitions.size());
+                for(auto& partition: this->partitions) {
+                    res.push_back(this->table_name(partition.first));
+                }
+                return res;
+            }
+
+            /**
+             *  @return storage of the partition of `key`, which is created with `sync_schema()` if it doesn't
+             *  exist yet.
+             */
+            storage_type& partition(const key_type& key) {
+                auto number = this->scheme.number_of(key);
+                auto it = this->partitions.find(number);
+                if(it == this->partitions.end()) {
+                    auto storage = std::make_unique<storage_type>(this->makePartition(this->table_name(number)));
+                    storage->sync_schema();
+                    it = this->partitions.emplace(number, std::move(storage)).first;
+                }
+                return *it->second;
+            }
+
+            int insert(const object_type& object) {
+                return this->partition(this->key_of(object)).insert(object);
+            }
+
+            void replace(const object_type& object) {
+                this->partition(this->key_of(object)).replace(object);
+            }
+
+            /**
+             *  Updates `object` in the partition of its key. An update can't move a row to another partition.
+             */
+            void update(const object_type& object) {
+                this->partition(this->key_of(object)).update(object);
+            }
+
+            /**
+             *  Replaces `[from, to)`, every partition replacing its objects with one statement.
+             */
+            template<class It>
+            void replace_range(It from, It to) {
+                std::map<sqlite3_int64, std::vector<object_type>> parts;
+                for(; from != to; ++from) {
+                    parts[this->scheme.number_of(this->key_of(*from))].push_back(*from);
+                }
+                for(auto& part: parts) {
+                    this->partition(this->key_of(part.second.front())).replace_range(part.second.begin(),
+                                                                                      part.second.end());
+                }
+            }
+
+            /**
+             *  `get_all(args...)` of every partition, in key order of the partitions.
+             */
+            template<class... Args>
+            std::vector<object_type> get_all(Args... args) {
+                std::vector<object_type> res;
+                for(auto& partition: this->partitions) {
+                    this->append(res, partition.second->template get_all<object_type>(args...));
+                }
+                return res;
+            }
+
+            /**
+             *  Rows with a partition key between `from` and `to` inclusive, reading only the partitions of these
+             *  keys. A `where()` passed first is combined with the key range.
+             *  Example: metrics.get_all_between(start, end, where(c(&Metric::name) == "cpu"), order_by(&Metric::time));
+             */
+            template<class... Args>
+            std::vector<object_type> get_all_between(const key_type& from, const key_type& to, Args... args) {
+                std::vector<object_type> res;
+                this->for_each_partition_between(from, to, [&](storage_type& storage) {
+                    this->append(res,
+                                 storage.template get_all<object_type>(
+                                     sqlite_orm::where(sqlite_orm::between(this->member, from, to)),
+                                     args...));
+                });
+                return res;
+            }
+
+            template<class C, class... Args>
+            std::vector<object_type>
+            get_all_between(const key_type& from, const key_type& to, where_t<C> condition, Args... args) {
+                std::vector<object_type> res;
+                this->for_each_partition_between(from, to, [&](storage_type& storage) {
+                    this->append(res,
+                                 storage.template get_all<object_type>(
+                                     sqlite_orm::where(condition.expression &&
+                                                       sqlite_orm::between(this->member, from, to)),
+                                     args...));
+                });
+                return res;
+            }
+
+            /**
+             *  @return sum of `count(args...)` of every partition.
+             */
+            template<class... Args>
+            int64 count(Args... args) {
+                int64 res = 0;
+                for(auto& partition: this->partitions) {
+                    res += partition.second->template count<object_type>(args...);
+                }
+                return res;
+            }
+
+            /**
+             *  @return count of rows with a partition key between `from` and `to` inclusive.
+             */
+            int64 count_between(const key_type& from, const key_type& to) {
+                int64 res = 0;
+                this->for_each_partition_between(from, to, [&](storage_type& storage) {
+                    res += storage.template count<object_type>(
+                        sqlite_orm::where(sqlite_orm::between(this->member, from, to)));
+                });
+                return res;
+            }
+
+            /**
+             *  Drops the tables of the partitions whose keys are all less than `key`, that is the partitions
+             *  before the partition of `key`.
+             *  @return count of dropped partitions.
+             */
+            size_t drop_partitions_before(const key_type& key) {
+                auto number = this->scheme.number_of(key);
+                size_t res = 0;
+                for(auto it = this->partitions.begin(); it != this->partitions.end() && it->first < number;) {
+                    it->second->drop_table(this->table_name(it->first));
+                    it = this->partitions.erase(it);
+                    ++res;
+                }
+                return res;
+            }
+
+          private:
+            std::string prefix;
+            M member;
+            partition_scheme<key_type> scheme;
+            partition_factory makePartition;
+            std::map<sqlite3_int64, std::unique_ptr<storage_type>> partitions;
+
+            std::string table_name(sqlite3_int64 number) const {
+                return this->prefix + "_" + this->scheme.suffix_of(number);
+            }
+
+            key_type key_of(const object_type& object) const {
+                return polyfill::invoke(this->member, object);
+            }
+
+            template<class L>
+            void for_each_partition_between(const key_type& from, const key_type& to, L lambda) {
+                auto begin = this->partitions.lower_bound(this->scheme.number_of(from));
+                auto end = this->partitions.upper_bound(this->scheme.number_of(to));
+                for(auto it = begin; it != end; ++it) {
+                    lambda(*it->second);
+                }
+            }
+
+            static void append(std::vector<object_type>& res, std::vector<object_type> rows) {
+                res.insert(res.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+            }
+        };
+    }
+
+    /**
+     *  Makes a partitioned table of the objects of the mapped type of `member`, `member` being the partition
+     *  key. `makePartition(tableName)` returns the storage of one partition, mapping the type to the table
+     *  `tableName`.
+     *  Example: auto metrics = make_partitioned_storage("metrics", &Metric::time, monthly_partitions(),
+     *                                                   [](const std::string& tableName) {
+     *               return make_storage("metrics.sqlite", make_table(tableName,
+     *                                                                make_column("time", &Metric::time),
+     *                                                                make_column("value", &Metric::value)));
+     *           });
+     *           metrics.insert(Metric{now, 0.5});  //  INSERT INTO "metrics_2026_10" ...
+     *           metrics.drop_partitions_before(now - 90 * 86400);
+     */
+    template<class M, class F>
+    auto make_partitioned_storage(std::string prefix,
+                                  M member,
+                                  partition_scheme<internal::member_field_type_t<M>> scheme,
+                                  F makePartition) {
+        using storage_type = decltype(makePartition(std::string{}));
+        return internal::partitioned_storage<storage_type, M>{std::move(prefix),
+                                                              std::move(member),
+                                                              std::move(scheme),
+                                                              std::move(makePartition)};
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <sqlite3.h>
+
+#include "journal_mode.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  A setting of `performance_profile` that is applied only if it was assigned.
+         */
+        template<class T>
+        struct profile_setting {
+            bool is_set = false;
+            T value{};
+
+            profile_setting& operator=(T value_) {
+                this->is_set = true;
+                this->value = value_;
+                return *this;
+            }
+
+            /**
+             *  Leaves the setting as SQLite or former profiles set it.
+             */
+            void reset() {
+                this->is_set = false;
+            }
+
+            explicit operator bool() const {
+                return this->is_set;
+            }
+        };
+    }
+
+    /**
+     *  A named set of pragmas passed to `make_storage` or `storage.apply_performance_profile()`.
+     *  Start from a preset and override single settings, e.g.
+     *  `auto profile = performance_profile::read_heavy(); profile.cache_size = -16000;`.
+     *  Settings are applied to every connection of the storage, including ones opened later.
+     */
+    struct performance_profile {
+        internal::profile_setting<sqlite_orm::journal_mode> journal_mode;
+
+        /**
+         *  0 is OFF, 1 is NORMAL, 2 is FULL and 3 is EXTRA.
+         */
+        internal::profile_setting<int> synchronous;
+
+        /**
+         *  Positive values are pages, negative values are KiB.
+         */
+        internal::profile_setting<int> cache_size;
+        internal::profile_setting<sqlite3_int64> mmap_size;
+
+        /**
+         *  Page size in bytes of databases created by the storage: it is set on every connection before
+         *  `sync_schema()` creates the first table. Existing databases keep theirs, see
+         *  `storage.migrate_page_size()`.
+         */
+        internal::profile_setting<int> page_size;
+
+        /**
+         *  0 is DEFAULT, 1 is FILE and 2 is MEMORY.
+         */
+        internal::profile_setting<int> temp_store;
+        internal::profile_setting<int> cache_spill;
+        internal::profile_setting<int> wal_autocheckpoint;
+        internal::profile_setting<sqlite3_int64> journal_size_limit;
+
+        /**
+         *  True for `locking_mode = EXCLUSIVE`: the connection keeps its locks instead of taking them
+         *  for every transaction, which only one connection of the database file can do.
+         */
+        internal::profile_setting<bool> exclusive_locking;
+
+        /**
+         *  `sqlite3_soft_heap_limit64` in bytes. It is a process-wide limit shared by all storages.
+         */
+        internal::profile_setting<sqlite3_int64> soft_heap_limit;
+
+        /**
+         *  Many readers: WAL with NORMAL sync, 256 MiB of memory mapped I/O, a 64 MiB page cache
+         *  and temporary tables in memory.
+         */
+        static performance_profile read_heavy() {
+            performance_profile profile;
+            profile.journal_mode = sqlite_orm::journal_mode::WAL;
+            profile.synchronous = 1;
+            profile.cache_size = -64 * 1024;
+            profile.mmap_size = 256 * 1024 * 1024;
+            profile.temp_store = 2;
+            profile.exclusive_locking = false;
+            return profile;
+        }
+
+        /**
+         *  Loading a lot of data by a single connection: no sync, the rollback journal in memory, a 256 MiB
+         *  page cache and exclusive locking. A crash during the load can corrupt the database file.
+         */
+        static performance_profile bulk_load() {
+            performance_profile profile;
+            profile.journal_mode = sqlite_orm::journal_mode::MEMORY;
+            profile.synchronous = 0;
+            profile.cache_size = -256 * 1024;
+            profile.temp_store = 2;
+            profile.exclusive_locking = true;
+            return profile;
+        }
+
+        /**
+         *  Small footprint: a 2 MiB page cache, no memory mapped I/O, temporary tables in files
+         *  and an 8 MiB soft heap limit.
+         */
+        static performance_profile low_memory() {
+            performance_profile profile;
+            profile.cache_size = -2 * 1024;
+            profile.mmap_size = 0;
+            profile.temp_store = 1;
+            profile.soft_heap_limit = 8 * 1024 * 1024;
+            return profile;
+        }
+
+        /**
+         *  FULL sync so that committed transactions survive a power loss.
+         */
+        static performance_profile durable() {
+            performance_profile profile;
+            profile.synchronous = 2;
+            profile.exclusive_locking = false;
+            return profile;
+        }
+    };
+}
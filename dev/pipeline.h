@@ -0,0 +1,97 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstddef>  //  size_t
+#include <tuple>  //  std::tuple, std::get
+#include <type_traits>  //  std::is_void, std::conditional_t
+#include <utility>  //  std::move, std::declval, std::index_sequence, std::index_sequence_for
+
+#include "functional/static_magic.h"
+#include "connection_holder.h"
+#include "prepared_statement.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  The result of a statement of a pipeline whose execution returns nothing.
+         */
+        struct no_result {};
+
+        template<class S, class Statement>
+        using execute_result_t =
+            decltype(std::declval<S&>().execute(std::declval<const prepared_statement_t<Statement>&>()));
+
+        template<class S, class Statement>
+        using pipeline_result_t = std::conditional_t<std::is_void<execute_result_t<S, Statement>>::value,
+                                                     no_result,
+                                                     execute_result_t<S, Statement>>;
+
+        /**
+         *  Prepared statements executed back to back by `execute()`, returned by `storage_t::pipeline()`. The
+         *  pipeline retains the connection of the storage once for all its executions, and runs them in one
+         *  transaction after `transaction()`. The statements have to outlive the pipeline.
+         */
+        template<class S, class... Statements>
+        class pipeline_t {
+          public:
+            using storage_type = S;
+            using result_type = std::tuple<pipeline_result_t<storage_type, Statements>...>;
+
+            pipeline_t(storage_type& storage_,
+                       connection_ref connection_,
+                       const prepared_statement_t<Statements>&... statements_) :
+                storage(storage_),
+                connection(std::move(connection_)), statements(statements_...) {}
+
+            /**
+             *  Makes `execute()` run the statements in one transaction unless one is open already, rolled back
+             *  if one of them throws.
+             */
+            pipeline_t& transaction() {
+                this->transactional = true;
+                return *this;
+            }
+
+            /**
+             *  Executes the statements in order.
+             *  @return the results of the executions, `no_result` for the statements which return nothing.
+             */
+            result_type execute() {
+                if(this->transactional && sqlite3_get_autocommit(this->connection.get())) {
+                    auto guard = this->storage.transaction_guard();
+                    auto res = this->execute_statements(std::index_sequence_for<Statements...>{});
+                    guard.commit();
+                    return res;
+                }
+                return this->execute_statements(std::index_sequence_for<Statements...>{});
+            }
+
+          private:
+            storage_type& storage;
+            connection_ref connection;
+            std::tuple<const prepared_statement_t<Statements>&...> statements;
+            bool transactional = false;
+
+            template<size_t... Is>
+            result_type execute_statements(std::index_sequence<Is...>) {
+                //  the elements of a braced initializer list are evaluated in order
+                return result_type{this->execute_statement(std::get<Is>(this->statements))...};
+            }
+
+            template<class Statement>
+            pipeline_result_t<storage_type, Statement>
+            execute_statement(const prepared_statement_t<Statement>& statement) {
+                return static_if<std::is_void<execute_result_t<storage_type, Statement>>::value>(
+                    [this](auto& statement) {
+                        this->storage.execute(statement);
+                        return no_result{};
+                    },
+                    [this](auto& statement) {
+                        return this->storage.execute(statement);
+                    })(statement);
+            }
+        };
+    }
+}
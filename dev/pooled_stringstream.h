@@ -0,0 +1,71 @@
+#pragma once
+
+#include <sstream>  //  std::stringstream
+#include <ostream>  //  std::ostream
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <utility>  //  std::move
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  A `std::stringstream` borrowed from a per-thread free list and given back on destruction.
+         *  Serializers create a stream for almost every AST node, so reusing them saves constructing a stream
+         *  (with its locale) and regrowing its buffer for every node of every statement.
+         *  Nested serializers simply borrow more streams, so the free list never holds more streams
+         *  than the deepest AST serialized on the thread.
+         */
+        struct pooled_stringstream {
+
+            pooled_stringstream() : stream{acquire()} {}
+
+            pooled_stringstream(const pooled_stringstream&) = delete;
+            pooled_stringstream& operator=(const pooled_stringstream&) = delete;
+
+            ~pooled_stringstream() {
+                free_streams().push_back(move(this->stream));
+            }
+
+            template<class T>
+            std::ostream& operator<<(const T& value) {
+                return *this->stream << value;
+            }
+
+            std::ostream& operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+                return *this->stream << manipulator;
+            }
+
+            operator std::ostream&() {
+                return *this->stream;
+            }
+
+            std::string str() const {
+                return this->stream->str();
+            }
+
+          private:
+            static std::vector<std::unique_ptr<std::stringstream>>& free_streams() {
+                thread_local std::vector<std::unique_ptr<std::stringstream>> streams;
+                return streams;
+            }
+
+            static std::unique_ptr<std::stringstream> acquire() {
+                auto& streams = free_streams();
+                if(streams.empty()) {
+                    return std::make_unique<std::stringstream>();
+                }
+                auto result = move(streams.back());
+                streams.pop_back();
+                //  keeps the capacity of the buffer
+                result->str(std::string{});
+                result->clear();
+                return result;
+            }
+
+            std::unique_ptr<std::stringstream> stream;
+        };
+    }
+}
@@ -6,6 +6,8 @@
 #include <memory>  // std::shared_ptr
 #include <vector>  //  std::vector
 #include <sstream>
+#include <utility>  //  std::pair
+#include <algorithm>  //  std::find_if
 
 #include "error_code.h"
 #include "row_extractor.h"
@@ -13,6 +15,8 @@
 #include "connection_holder.h"
 #include "util.h"
 #include "serializing_util.h"
+#include "statement_cache.h"
+#include "schema_snapshot.h"
 
 namespace sqlite_orm {
 
@@ -20,29 +24,24 @@ namespace sqlite_orm {
         struct storage_base;
 
         template<class T>
-        int getPragmaCallback(void* data, int argc, char** argv, char** x) {
-            return extract_single_value<T>(data, argc, argv, x);
+        void extract_pragma_row(T& result, sqlite3_stmt* stmt) {
+            result = row_extractor<T>().extract(stmt, 0);
         }
 
-        template<>
-        inline int getPragmaCallback<std::vector<std::string>>(void* data, int argc, char** argv, char**) {
-            auto& res = *(std::vector<std::string>*)data;
-            res.reserve(argc);
-            for(decltype(argc) i = 0; i < argc; ++i) {
-                auto rowString = row_extractor<std::string>().extract(argv[i]);
-                res.push_back(move(rowString));
+        inline void extract_pragma_row(std::vector<std::string>& result, sqlite3_stmt* stmt) {
+            for(int i = 0, n = sqlite3_column_count(stmt); i < n; ++i) {
+                result.push_back(row_extractor<std::string>().extract(stmt, i));
             }
-            return 0;
         }
 
         struct pragma_t {
-            using get_connection_t = std::function<internal::connection_ref()>;
+            explicit pragma_t(storage_base& storage_) : storage(&storage_) {}
 
-            pragma_t(get_connection_t get_connection_) : get_connection(move(get_connection_)) {}
-
-            void busy_timeout(int value) {
-                this->set_pragma("busy_timeout", value);
-            }
+            /**
+             *  Same as `storage.busy_timeout(value)`, which the busy handler of `enable_busy_statistics()` waits
+             *  for.
+             */
+            void busy_timeout(int value);
 
             int busy_timeout() {
                 return this->get_pragma<int>("busy_timeout");
@@ -82,6 +81,152 @@ namespace sqlite_orm {
                 this->_synchronous = value;
             }
 
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_wal_autocheckpoint
+             *  `storage.on_wal_commit()` and `storage.start_checkpoint_scheduler()` replace automatic
+             *  checkpoints with a WAL hook. Without the scheduler the hook still checkpoints at this size.
+             */
+            int wal_autocheckpoint() {
+                if(this->_wal_autocheckpoint != -1) {
+                    return this->_wal_autocheckpoint;
+                }
+                return this->get_pragma<int>("wal_autocheckpoint");
+            }
+
+            void wal_autocheckpoint(int value) {
+                this->_wal_autocheckpoint = -1;
+                this->set_pragma("wal_autocheckpoint", value);
+                this->_wal_autocheckpoint = value;
+                //  the pragma replaces the WAL hook of the storage
+                if(this->wal_autocheckpoint_changed) {
+                    this->wal_autocheckpoint_changed();
+                }
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_mmap_size
+             *  This and the other performance pragmas below are connection settings. They are applied to all
+             *  opened connections and remembered, so that they are applied again to every connection opened later.
+             */
+            sqlite3_int64 mmap_size() {
+                return this->get_pragma<sqlite3_int64>("mmap_size");
+            }
+
+            void mmap_size(sqlite3_int64 value) {
+                this->set_connection_pragma("mmap_size", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_query_only
+             *  True makes every statement that changes the database fail with SQLITE_READONLY.
+             */
+            bool query_only() {
+                return this->get_pragma<bool>("query_only");
+            }
+
+            void query_only(bool value) {
+                this->set_connection_pragma("query_only", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_cache_size
+             *  Positive values are pages, negative values are KiB.
+             */
+            int cache_size() {
+                return this->get_pragma<int>("cache_size");
+            }
+
+            void cache_size(int value) {
+                this->set_connection_pragma("cache_size", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_temp_store
+             *  0 is DEFAULT, 1 is FILE and 2 is MEMORY.
+             */
+            int temp_store() {
+                return this->get_pragma<int>("temp_store");
+            }
+
+            void temp_store(int value) {
+                this->set_connection_pragma("temp_store", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_page_size
+             *  Takes effect only before the database is created or by the next `vacuum()`,
+             *  and never for a database in WAL mode.
+             */
+            int page_size() {
+                return this->get_pragma<int>("page_size");
+            }
+
+            void page_size(int value) {
+                this->set_connection_pragma("page_size", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_cache_spill
+             *  0 disables spilling, 1 enables it and greater values are the minimum cache size in pages to spill.
+             */
+            int cache_spill() {
+                return this->get_pragma<int>("cache_spill");
+            }
+
+            void cache_spill(int value) {
+                this->set_connection_pragma("cache_spill", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_threads
+             */
+            int threads() {
+                return this->get_pragma<int>("threads");
+            }
+
+            void threads(int value) {
+                this->set_connection_pragma("threads", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_journal_size_limit
+             */
+            sqlite3_int64 journal_size_limit() {
+                return this->get_pragma<sqlite3_int64>("journal_size_limit");
+            }
+
+            void journal_size_limit(sqlite3_int64 value) {
+                this->set_connection_pragma("journal_size_limit", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_analysis_limit
+             */
+            int analysis_limit() {
+                return this->get_pragma<int>("analysis_limit");
+            }
+
+            void analysis_limit(int value) {
+                this->set_connection_pragma("analysis_limit", value);
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_optimize
+             *  Runs ANALYZE where it is likely to help. Is meant to be called before closing a connection
+             *  and periodically by long lived connections. It is a command, so it is not remembered.
+             */
+            void optimize() {
+                this->perform_pragma("PRAGMA optimize", nullptr);
+            }
+
+            /**
+             *  Same as `optimize()` with a bitmask of optimizations, e.g. 0x10002 for the ones of a newly
+             *  opened connection.
+             */
+            void optimize(int mask) {
+                this->set_pragma("optimize", mask);
+            }
+
             int user_version() {
                 return this->get_pragma<int>("user_version");
             }
@@ -90,6 +235,15 @@ namespace sqlite_orm {
                 this->set_pragma("user_version", value);
             }
 
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_data_version
+             *  Changes when another connection commits a change to the database, see `enable_cache_coherence()`.
+             *  Values of different connections can't be compared.
+             */
+            int data_version() {
+                return this->get_pragma<int>("data_version");
+            }
+
             int auto_vacuum() {
                 return this->get_pragma<int>("auto_vacuum");
             }
@@ -98,6 +252,21 @@ namespace sqlite_orm {
                 this->set_pragma("auto_vacuum", value);
             }
 
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_page_count
+             */
+            int page_count() {
+                return this->get_pragma<int>("page_count");
+            }
+
+            /**
+             *  https://www.sqlite.org/pragma.html#pragma_freelist_count
+             *  Number of unused pages, which `storage.incremental_vacuum()` can free.
+             */
+            int freelist_count() {
+                return this->get_pragma<int>("freelist_count");
+            }
+
             std::vector<std::string> integrity_check() {
                 return this->get_pragma<std::vector<std::string>>("integrity_check");
             }
@@ -116,64 +285,61 @@ namespace sqlite_orm {
             }
 
             // will include generated columns in response as opposed to table_info
-            std::vector<sqlite_orm::table_xinfo> table_xinfo(const std::string& tableName) const {
+            std::vector<sqlite_orm::table_xinfo> table_xinfo(const std::string& tableName,
+                                                             const std::string& schemaName = {}) const {
                 auto connection = this->get_connection();
+                if(schemaName.empty()) {
+                    auto snapshot = this->get_schema_snapshot(connection.get());
+                    auto it = snapshot->tables.find(tableName);
+                    if(it != snapshot->tables.end()) {
+                        return it->second.columns;
+                    }
+                }
 
                 std::vector<sqlite_orm::table_xinfo> result;
                 std::ostringstream ss;
-                ss << "PRAGMA "
-                      "table_xinfo("
-                   << streaming_identifier(tableName) << ")" << std::flush;
-                perform_exec(
-                    connection.get(),
-                    ss.str(),
-                    [](void* data, int argc, char** argv, char**) -> int {
-                        auto& res = *(std::vector<sqlite_orm::table_xinfo>*)data;
-                        if(argc) {
-                            auto index = 0;
-                            auto cid = std::atoi(argv[index++]);
-                            std::string name = argv[index++];
-                            std::string type = argv[index++];
-                            bool notnull = !!std::atoi(argv[index++]);
-                            std::string dflt_value = argv[index] ? argv[index] : "";
-                            ++index;
-                            auto pk = std::atoi(argv[index++]);
-                            auto hidden = std::atoi(argv[index++]);
-                            res.emplace_back(cid, move(name), move(type), notnull, move(dflt_value), pk, hidden);
-                        }
-                        return 0;
-                    },
-                    &result);
+                ss << "PRAGMA ";
+                if(!schemaName.empty()) {
+                    ss << streaming_identifier(schemaName) << ".";
+                }
+                ss << "table_xinfo(" << streaming_identifier(tableName) << ")" << std::flush;
+                this->for_each_row(connection.get(), ss.str(), [&result](sqlite3_stmt* stmt) {
+                    result.push_back(extract_table_xinfo(stmt, 0));
+                });
                 return result;
             }
 
             std::vector<sqlite_orm::table_info> table_info(const std::string& tableName) const {
                 auto connection = this->get_connection();
 
+                std::vector<sqlite_orm::table_info> result;
+                auto add = [&result](sqlite_orm::table_xinfo info) {
+                    result.emplace_back(info.cid,
+                                        move(info.name),
+                                        move(info.type),
+                                        info.notnull,
+                                        move(info.dflt_value),
+                                        info.pk);
+                };
+                auto snapshot = this->get_schema_snapshot(connection.get());
+                auto it = snapshot->tables.find(tableName);
+                if(it != snapshot->tables.end()) {
+                    //  table_info leaves out the hidden columns
+                    for(auto& info: it->second.columns) {
+                        if(!info.hidden) {
+                            add(info);
+                        }
+                    }
+                    return result;
+                }
+
                 std::ostringstream ss;
                 ss << "PRAGMA "
                       "table_info("
                    << streaming_identifier(tableName) << ")" << std::flush;
-                std::vector<sqlite_orm::table_info> result;
-                perform_exec(
-                    connection.get(),
-                    ss.str(),
-                    [](void* data, int argc, char** argv, char**) -> int {
-                        auto& res = *(std::vector<sqlite_orm::table_info>*)data;
-                        if(argc) {
-                            auto index = 0;
-                            auto cid = std::atoi(argv[index++]);
-                            std::string name = argv[index++];
-                            std::string type = argv[index++];
-                            bool notnull = !!std::atoi(argv[index++]);
-                            std::string dflt_value = argv[index] ? argv[index] : "";
-                            ++index;
-                            auto pk = std::atoi(argv[index++]);
-                            res.emplace_back(cid, move(name), move(type), notnull, move(dflt_value), pk);
-                        }
-                        return 0;
-                    },
-                    &result);
+                this->for_each_row(connection.get(), ss.str(), [&add](sqlite3_stmt* stmt) {
+                    add(extract_table_xinfo(stmt, 0, false));
+                });
                 return result;
             }
 
@@ -181,40 +347,134 @@ namespace sqlite_orm {
             friend struct storage_base;
 
             int _synchronous = -1;
+            int _wal_autocheckpoint = -1;
             signed char _journal_mode = -1;  //  if != -1 stores static_cast<sqlite_orm::journal_mode>(journal_mode)
-            get_connection_t get_connection;
+            storage_base* storage;
+            std::function<void()> wal_autocheckpoint_changed;
+            std::function<void(const std::function<void(sqlite3*)>&)> for_each_opened_connection;
+
+            /**
+             *  Pragmas set with `set_connection_pragma()` as name and value pairs in the order they were set.
+             */
+            std::vector<std::pair<std::string, std::string>> _connection_pragmas;
 
+            /**
+             *  Defined after `storage_base`, whose connection and statement cache they return.
+             */
+            connection_ref get_connection() const;
+            std::shared_ptr<statement_cache> get_statement_cache() const;
+
+            /**
+             *  The schema of the main database of `db` from the schema cache of the storage. Tables that aren't
+             *  in it, e.g. temporary ones, are looked up with a pragma.
+             */
+            std::shared_ptr<const schema_snapshot> get_schema_snapshot(sqlite3* db) const;
+
+            /**
+             *  A pragma statement taken from the statement cache of the storage if it has one, or prepared, and put
+             *  back or finalized when it goes out of scope.
+             */
+            struct pragma_statement {
+                pragma_statement(std::shared_ptr<statement_cache> cache, sqlite3* db, const std::string& sql);
+                pragma_statement(const pragma_statement&) = delete;
+                ~pragma_statement();
+
+                sqlite3_stmt* stmt = nullptr;
+                std::shared_ptr<statement_cache> cache;
+            };
+
+            /**
+             *  Reads a pragma with a prepared statement, extracting the columns as T from the row it returns.
+             *  With the statement cache of the storage enabled, polling a pragma doesn't compile its statement again.
+             */
             template<class T>
             T get_pragma(const std::string& name) {
                 auto connection = this->get_connection();
-                T result;
-                perform_exec(connection.get(), "PRAGMA " + name, getPragmaCallback<T>, &result);
+                pragma_statement statement{this->get_statement_cache(), connection.get(), "PRAGMA " + name};
+                T result{};
+                int rc;
+                while((rc = sqlite3_step(statement.stmt)) == SQLITE_ROW) {
+                    extract_pragma_row(result, statement.stmt);
+                }
+                if(rc != SQLITE_DONE) {
+                    throw_translated_sqlite_error(statement.stmt);
+                }
                 return result;
             }
 
+            /**
+             *  Runs `sql` with a prepared statement and calls `onRow` with the statement for every row, whose
+             *  columns are read with their types instead of being parsed from text. Unlike `get_pragma()` it
+             *  leaves the statement cache alone, the schema queries it runs are rarely repeated.
+             */
+            template<class F>
+            void for_each_row(sqlite3* db, const std::string& sql, const F& onRow) const {
+                pragma_statement statement{nullptr, db, sql};
+                int rc;
+                while((rc = sqlite3_step(statement.stmt)) == SQLITE_ROW) {
+                    onRow(statement.stmt);
+                }
+                if(rc != SQLITE_DONE) {
+                    throw_translated_sqlite_error(statement.stmt);
+                }
+            }
+
             /**
              *  Yevgeniy Zakharov: I wanted to refactor this function with statements and value bindings
              *  but it turns out that bindings in pragma statements are not supported.
              */
             template<class T>
             void set_pragma(const std::string& name, const T& value, sqlite3* db = nullptr) {
-                auto con = this->get_connection();
-                if(!db) {
-                    db = con.get();
-                }
                 std::stringstream ss;
                 ss << "PRAGMA " << name << " = " << value << std::flush;
-                perform_void_exec(db, ss.str());
+                this->perform_pragma(ss.str(), db);
             }
 
             void set_pragma(const std::string& name, const sqlite_orm::journal_mode& value, sqlite3* db = nullptr) {
-                auto con = this->get_connection();
-                if(!db) {
-                    db = con.get();
-                }
                 std::stringstream ss;
                 ss << "PRAGMA " << name << " = " << to_string(value) << std::flush;
-                perform_void_exec(db, ss.str());
+                this->perform_pragma(ss.str(), db);
+            }
+
+            /**
+             *  Sets the pragma on every opened connection and remembers it for connections opened later.
+             *  A storage that has no opened connection only remembers it.
+             */
+            template<class T>
+            void set_connection_pragma(const std::string& name, const T& value) {
+                std::stringstream ss;
+                ss << value << std::flush;
+                auto valueString = ss.str();
+                if(this->for_each_opened_connection) {
+                    this->for_each_opened_connection([this, &name, &valueString](sqlite3* db) {
+                        this->set_pragma(name, valueString, db);
+                    });
+                } else {
+                    this->set_pragma(name, valueString);
+                }
+                auto it = std::find_if(this->_connection_pragmas.begin(),
+                                       this->_connection_pragmas.end(),
+                                       [&name](auto& pair) {
+                                           return pair.first == name;
+                                       });
+                if(it != this->_connection_pragmas.end()) {
+                    it->second = move(valueString);
+                } else {
+                    this->_connection_pragmas.emplace_back(name, move(valueString));
+                }
+            }
+
+            /**
+             *  Executes the query with `db` if it is passed (e.g. during `on_open`) without
+             *  borrowing a connection from the storage.
+             */
+            void perform_pragma(const std::string& query, sqlite3* db) {
+                if(db) {
+                    perform_void_exec(db, query);
+                } else {
+                    auto con = this->get_connection();
+                    perform_void_exec(con.get(), query);
+                }
             }
         };
     }
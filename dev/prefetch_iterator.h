@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>  //  std::max
+#include <atomic>  //  std::atomic
+#include <condition_variable>  //  std::condition_variable
+#include <exception>  //  std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <iterator>  //  std::input_iterator_tag
+#include <memory>  //  std::shared_ptr, std::make_shared
+#include <mutex>  //  std::mutex, std::unique_lock, std::lock_guard
+#include <system_error>  //  std::system_error
+#include <thread>  //  std::thread, std::this_thread
+#include <utility>  //  std::move, std::swap
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "error_code.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Ring of rows that a producer thread fills ahead of one consumer. The rows are handed over through
+         *  the atomic read and write counts; a side that finds the ring empty or full spins briefly and then
+         *  sleeps until the other side moves. Rows are swapped out of their slots, so the producer reuses the
+         *  objects, and their strings and vectors, the consumer is done with.
+         */
+        template<class T>
+        class prefetch_buffer {
+          public:
+            explicit prefetch_buffer(size_t capacity) : slots(std::max(capacity, size_t(1))) {}
+
+            prefetch_buffer(const prefetch_buffer&) = delete;
+            prefetch_buffer& operator=(const prefetch_buffer&) = delete;
+
+            /**
+             *  Stops the producer after the row it is reading and waits for it.
+             */
+            ~prefetch_buffer() {
+                this->cancelled = true;
+                this->wake();
+                if(this->producer.joinable()) {
+                    this->producer.join();
+                }
+            }
+
+            /**
+             *  Runs `produce(*this)` on the producer thread. An exception it throws is rethrown by `pop()`
+             *  after the rows published before it.
+             */
+            template<class F>
+            void start(F produce) {
+                this->producer = std::thread{[this, produce] {
+                    try {
+                        produce(*this);
+                    } catch(...) {
+                        this->error = std::current_exception();
+                    }
+                    this->finished = true;
+                    this->wake();
+                }};
+            }
+
+            /**
+             *  Producer: waits for a free slot and returns it, or returns nullptr if the consumer is gone.
+             */
+            T* slot_to_fill() {
+                const size_t written = this->written.load();
+                this->wait([this, written] {
+                    return written - this->read.load() < this->slots.size() || this->cancelled.load();
+                });
+                if(this->cancelled) {
+                    return nullptr;
+                }
+                return &this->slots[written % this->slots.size()];
+            }
+
+            /**
+             *  Producer: hands the slot returned by `slot_to_fill()` over to the consumer.
+             */
+            void publish() {
+                ++this->written;
+                this->wake();
+            }
+
+            /**
+             *  Consumer: swaps the next row into `object`.
+             *  @return false after the last row.
+             */
+            bool pop(T& object) {
+                const size_t read = this->read.load();
+                this->wait([this, read] {
+                    return this->written.load() != read || this->finished.load();
+                });
+                //  the producer publishes its last row before it finishes
+                if(this->written.load() == read) {
+                    if(this->error) {
+                        std::rethrow_exception(this->error);
+                    }
+                    return false;
+                }
+                using std::swap;
+                swap(object, this->slots[read % this->slots.size()]);
+                this->read = read + 1;
+                this->wake();
+                return true;
+            }
+
+          private:
+            template<class P>
+            void wait(const P& ready) {
+                for(int spin = 0; spin < 64; ++spin) {
+                    if(ready()) {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+                std::unique_lock<std::mutex> lock{this->mutex};
+                ++this->sleepers;
+                this->condition.wait(lock, ready);
+                --this->sleepers;
+            }
+
+            //  a sleeper counts itself before it checks the counts, so either it sees the change or it is woken
+            void wake() {
+                if(this->sleepers.load()) {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->condition.notify_all();
+                }
+            }
+
+            std::vector<T> slots;
+            std::atomic<size_t> read{0};
+            std::atomic<size_t> written{0};
+            std::atomic<bool> finished{false};
+            std::atomic<bool> cancelled{false};
+            std::exception_ptr error;
+            std::atomic<int> sleepers{0};
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::thread producer;
+        };
+
+        /**
+         *  Iterator of a view with a `prefetch()` hint, taking the rows from the `prefetch_buffer` its producer
+         *  thread fills.
+         */
+        template<class V>
+        struct prefetch_iterator_t {
+            using view_type = V;
+            using value_type = typename view_type::mapped_type;
+
+          protected:
+            //  only null for the default constructed iterator and at the end
+            std::shared_ptr<prefetch_buffer<value_type>> buffer;
+
+            /**
+             *  Reused for every row as long as no copy of the iterator refers to it, see `iterator_t`.
+             */
+            std::shared_ptr<value_type> current;
+
+            void next() {
+                if(!this->buffer) {
+                    this->current.reset();
+                    return;
+                }
+                if(!this->current || this->current.use_count() > 1) {
+                    this->current = std::make_shared<value_type>();
+                }
+                if(!this->buffer->pop(*this->current)) {
+                    this->current.reset();
+                    this->buffer.reset();
+                }
+            }
+
+          public:
+            using difference_type = ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type&;
+            using iterator_category = std::input_iterator_tag;
+
+            prefetch_iterator_t(){};
+
+            prefetch_iterator_t(std::shared_ptr<prefetch_buffer<value_type>> buffer_) : buffer{std::move(buffer_)} {
+                next();
+            }
+
+            const value_type& operator*() const {
+                if(!this->buffer || !this->current) {
+                    throw std::system_error{orm_error_code::trying_to_dereference_null_iterator};
+                }
+                return *this->current;
+            }
+
+            const value_type* operator->() const {
+                return &(this->operator*());
+            }
+
+            prefetch_iterator_t<V>& operator++() {
+                next();
+                return *this;
+            }
+
+            void operator++(int) {
+                this->operator++();
+            }
+
+            bool operator==(const prefetch_iterator_t& other) const {
+                return this->current == other.current;
+            }
+
+            bool operator!=(const prefetch_iterator_t& other) const {
+                return !(*this == other);
+            }
+        };
+    }
+}
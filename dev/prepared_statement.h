@@ -1,35 +1,100 @@
 #pragma once
 
 #include <sqlite3.h>
-#include <memory>  //  std::unique_ptr
+#include <atomic>  //  std::atomic
+#include <cstdint>  //  uint64_t
+#include <memory>  //  std::unique_ptr, std::shared_ptr
+#include <mutex>  //  std::mutex
 #include <iterator>  //  std::iterator_traits
 #include <string>  //  std::string
 #include <type_traits>  //  std::integral_constant, std::declval
-#include <utility>  //  std::pair
+#include <utility>  //  std::pair, std::move
+#include <vector>  //  std::vector
 
 #include "functional/cxx_universal.h"
 #include "functional/cxx_type_traits_polyfill.h"
 #include "functional/cxx_functional_polyfill.h"
 #include "tuple_helper/tuple_filter.h"
 #include "connection_holder.h"
+#include "statement_cache.h"
+#include "statement_stats.h"
+#include "statement_binder.h"
 #include "select_constraints.h"
 #include "values.h"
 #include "ast/upsert_clause.h"
+#include "ast/with.h"
 
 namespace sqlite_orm {
 
     namespace internal {
 
+        /**
+         *  Parameters of a prepared statement in binding order, parameter N being `steps[N - 1]`, see
+         *  `bind_changed_parameters()`.
+         */
+        struct binding_plan {
+            struct step {
+                const void* value;
+
+                /**
+                 *  `bind_if_changed()` for the type of the value.
+                 */
+                int (*bind)(sqlite3_stmt*, int, const void*, bound_parameter&);
+            };
+
+            /**
+             *  Nodes of the expression the plan was made for and `statement_type_key()` of their type, null if
+             *  it wasn't made yet.
+             */
+            const void* nodes = nullptr;
+            const void* nodesType = nullptr;
+
+            /**
+             *  The plan is made when the statement is executed the second time, one-off statements don't need one.
+             */
+            bool made = false;
+
+            /**
+             *  False if a parameter isn't a value stored in the expression, e.g. a `std::ref()` or a value
+             *  computed while iterating the nodes: the parameters are found by iterating the nodes every time then.
+             */
+            bool usable = false;
+            std::vector<step> steps;
+        };
+
         struct prepared_statement_base {
             sqlite3_stmt* stmt = nullptr;
             connection_ref con;
 
-#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
-            prepared_statement_base(sqlite3_stmt* stmt, connection_ref con) : stmt{stmt}, con{std::move(con)} {}
-#endif
+            /**
+             *  If set `stmt` is put back into this cache instead of being finalized. Shared with the storage, so
+             *  disabling or re-enabling the statement cache while this statement is in use doesn't free it.
+             */
+            std::shared_ptr<statement_cache> cache;
+
+            /**
+             *  The values the parameters were bound with last, parameter N being `boundParameters[N - 1]`.
+             *  Executing the statement binds only the parameters whose value differs, however it was changed.
+             *  Parameters that don't bind a value of their own, like `std::ref()`, are always bound.
+             */
+            mutable std::vector<bound_parameter> boundParameters;
+
+            /**
+             *  Points into the expression, so a moved statement starts over with an empty plan.
+             */
+            mutable binding_plan bindingPlan;
+
+            prepared_statement_base(sqlite3_stmt* stmt,
+                                    connection_ref con,
+                                    std::shared_ptr<statement_cache> cache = nullptr) :
+                stmt{stmt}, con{std::move(con)}, cache{std::move(cache)} {}
 
             ~prepared_statement_base() {
-                sqlite3_finalize(this->stmt);
+                if(this->cache) {
+                    this->cache->put(this->stmt);
+                } else {
+                    sqlite3_finalize(this->stmt);
+                }
             }
 
             std::string sql() const {
@@ -63,6 +128,14 @@ namespace sqlite_orm {
             }
 #endif
 
+            /**
+             *  Returns `sqlite3_stmt_status` counters of this statement.
+             *  @param reset resets the counters after reading them if true.
+             */
+            statement_stats stats(bool reset = false) const {
+                return get_statement_stats(this->stmt, reset);
+            }
+
 #ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
             std::string_view column_name(int index) const {
                 return sqlite3_column_name(stmt, index);
@@ -76,16 +149,118 @@ namespace sqlite_orm {
 
             expression_type expression;
 
-            prepared_statement_t(T expression_, sqlite3_stmt* stmt_, connection_ref con_) :
-                prepared_statement_base{stmt_, std::move(con_)}, expression(std::move(expression_)) {}
+            prepared_statement_t(T expression_,
+                                 sqlite3_stmt* stmt_,
+                                 connection_ref con_,
+                                 std::shared_ptr<statement_cache> cache_ = nullptr) :
+                prepared_statement_base{stmt_, std::move(con_), std::move(cache_)},
+                expression(std::move(expression_)) {}
 
             prepared_statement_t(prepared_statement_t&& prepared_stmt) :
-                prepared_statement_base{prepared_stmt.stmt, std::move(prepared_stmt.con)},
+                prepared_statement_base{prepared_stmt.stmt,
+                                        std::move(prepared_stmt.con),
+                                        std::move(prepared_stmt.cache)},
                 expression(std::move(prepared_stmt.expression)) {
+                this->boundParameters = std::move(prepared_stmt.boundParameters);
                 prepared_stmt.stmt = nullptr;
             }
         };
 
+        /**
+         *  The statement of type S that `storage_t::statement<S>()` prepared on a connection.
+         */
+        template<class S>
+        struct statement_slot : connection_statement_slot {
+            prepared_statement_t<S> statement;
+
+            statement_slot(prepared_statement_t<S>&& prepared) :
+                statement{std::move(prepared.expression), prepared.stmt, prepared.con.unretained()} {
+                prepared.stmt = nullptr;
+            }
+        };
+
+        inline size_t next_statement_slot_index() {
+            static std::atomic<size_t> counter{0};
+            return counter++;
+        }
+
+        /**
+         *  Index of the slot of statement type S in `connection_holder::statementSlots`. Indices are handed out
+         *  on first use, so connections only get slots for the statement types used.
+         */
+        template<class S>
+        size_t statement_slot_index() {
+            static const size_t index = next_statement_slot_index();
+            return index;
+        }
+
+        /**
+         *  A prepared statement of type S owned by a connection, see `storage_t::statement()`. The handle keeps
+         *  the connection open and, for pooled storages, assigned to the calling thread.
+         */
+        template<class S>
+        class statement_handle {
+          public:
+            statement_handle(connection_ref con_, prepared_statement_t<S>& statement_) :
+                con(std::move(con_)), statement(&statement_) {}
+
+            prepared_statement_t<S>& operator*() const {
+                return *this->statement;
+            }
+
+            prepared_statement_t<S>* operator->() const {
+                return this->statement;
+            }
+
+          private:
+            connection_ref con;
+            prepared_statement_t<S>* statement;
+        };
+
+        inline uint64_t next_shared_statement_id() {
+            static std::atomic<uint64_t> lastId{0};
+            return ++lastId;
+        }
+
+        /**
+         *  A statement defined once and executed from any thread by `storage_t::execute()`, which prepares it
+         *  lazily on the connection of the calling thread and keeps it with that connection. Returned by
+         *  `make_shared_statement()`.
+         */
+        template<class S>
+        class shared_statement_t {
+          public:
+            using expression_type = S;
+
+            shared_statement_t(expression_type expression_) : expression(std::move(expression_)) {}
+
+            const expression_type& get_expression() const {
+                return this->expression;
+            }
+
+            /**
+             *  Key of the statements prepared for this shared statement on the connections. Copies share it.
+             */
+            uint64_t id() const {
+                return this->_id;
+            }
+
+          private:
+            expression_type expression;
+            uint64_t _id = next_shared_statement_id();
+        };
+
+        /**
+         *  The statement a connection prepared for a `shared_statement_t`. Threads sharing the connection
+         *  execute it one at a time.
+         */
+        template<class S>
+        struct shared_statement_slot : statement_slot<S> {
+            std::mutex mutex;
+
+            using statement_slot<S>::statement_slot;
+        };
+
         template<class T>
         SQLITE_ORM_INLINE_VAR constexpr bool is_prepared_statement_v =
             polyfill::is_specialization_of_v<T, prepared_statement_t>;
@@ -174,6 +349,24 @@ namespace sqlite_orm {
         };
 #endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
 
+        /**
+         *  Whether statement `T` only reads data, so it can run on a read-only connection.
+         */
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_reading_statement_v =
+            polyfill::disjunction_v<is_select<T>,
+                                    polyfill::is_specialization_of<T, with_t>,
+                                    polyfill::is_specialization_of<T, get_all_t>,
+                                    polyfill::is_specialization_of<T, get_all_pointer_t>,
+                                    polyfill::is_specialization_of<T, get_t>,
+                                    polyfill::is_specialization_of<T, get_pointer_t>
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+                                    ,
+                                    polyfill::is_specialization_of<T, get_all_optional_t>,
+                                    polyfill::is_specialization_of<T, get_optional_t>
+#endif
+                                    >;
+
         template<class T>
         struct update_t {
             using type = T;
@@ -224,6 +417,40 @@ namespace sqlite_orm {
         template<class T>
         using is_replace = polyfill::bool_constant<is_replace_v<T>>;
 
+        /**
+         *  Whether the SQL of statement `T` is fully determined by its type, i.e. all its values are bound.
+         */
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_sql_static_v =
+            polyfill::disjunction_v<polyfill::is_specialization_of<T, get_t>,
+                                    polyfill::is_specialization_of<T, get_pointer_t>,
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+                                    polyfill::is_specialization_of<T, get_optional_t>,
+#endif
+                                    polyfill::is_specialization_of<T, update_t>,
+                                    polyfill::is_specialization_of<T, remove_t>,
+                                    polyfill::is_specialization_of<T, insert_t>,
+                                    polyfill::is_specialization_of<T, replace_t>>;
+
+        template<class T, class R>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_sql_static_v<get_all_t<T, R>> = true;
+
+        template<class T, class R>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_sql_static_v<get_all_pointer_t<T, R>> = true;
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        template<class T, class R>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_sql_static_v<get_all_optional_t<T, R>> = true;
+#endif
+
+        enum class conflict_action {
+            abort,
+            fail,
+            ignore,
+            replace,
+            rollback,
+        };
+
         template<class It, class Projection, class O>
         struct insert_range_t {
             using iterator_type = It;
@@ -232,6 +459,18 @@ namespace sqlite_orm {
 
             std::pair<iterator_type, iterator_type> range;
             transformer_type transformer;
+
+            /**
+             *  `INSERT OR <action>`, abort being the default of INSERT which is serialized as plain `INSERT`.
+             */
+            conflict_action action = conflict_action::abort;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+            insert_range_t(std::pair<iterator_type, iterator_type> range,
+                           transformer_type transformer,
+                           conflict_action action = conflict_action::abort) :
+                range{std::move(range)}, transformer{std::move(transformer)}, action{action} {}
+#endif
         };
 
         template<class T>
@@ -256,6 +495,29 @@ namespace sqlite_orm {
         template<class T>
         using is_replace_range = polyfill::bool_constant<is_replace_range_v<T>>;
 
+#if SQLITE_VERSION_NUMBER >= 3024000
+        /**
+         *  INSERT of a range of objects with an upsert clause, e.g. `ON CONFLICT (id) DO UPDATE SET ...`.
+         */
+        template<class It, class Projection, class O, class U>
+        struct upsert_range_t {
+            using iterator_type = It;
+            using transformer_type = Projection;
+            using object_type = O;
+            using upsert_type = U;
+
+            std::pair<iterator_type, iterator_type> range;
+            transformer_type transformer;
+            upsert_type upsert;
+        };
+
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_upsert_range_v = polyfill::is_specialization_of_v<T, upsert_range_t>;
+
+        template<class T>
+        using is_upsert_range = polyfill::bool_constant<is_upsert_range_v<T>>;
+#endif
+
         template<class... Args>
         struct insert_raw_t {
             using args_tuple = std::tuple<Args...>;
@@ -287,14 +549,6 @@ namespace sqlite_orm {
         template<class T>
         using is_default_values = std::is_same<T, default_values_t>;
 
-        enum class conflict_action {
-            abort,
-            fail,
-            ignore,
-            replace,
-            rollback,
-        };
-
         struct insert_constraint {
             conflict_action action = conflict_action::abort;
 
@@ -514,6 +768,43 @@ namespace sqlite_orm {
         return {{std::move(from), std::move(to)}, std::move(project)};
     }
 
+#if SQLITE_VERSION_NUMBER >= 3024000
+    /**
+     *  Create an upsert range statement: INSERT of all the columns of the objects in the range, the primary key
+     *  included, followed by `upsert`. Unlike `replace_range` a conflicting row is updated in place instead of
+     *  being deleted and inserted again, so the indexes on unchanged columns are not rewritten and no delete
+     *  triggers fire.
+     *  The objects in the range are transformed using the specified projection, which defaults to identity projection.
+     *
+     *  @example
+     *  ```
+     *  auto statement = storage.prepare(upsert_range(users.begin(),
+     *                                                users.end(),
+     *                                                on_conflict(&User::id).do_update(
+     *                                                    set(c(&User::name) = excluded(&User::name)))));
+     *  storage.execute(statement);
+     *  ```
+     */
+    template<class It, class U, class Projection = polyfill::identity>
+    auto upsert_range(It from, It to, U upsert, Projection project = {}) {
+        static_assert(internal::is_upsert_clause<U>::value, "upsert_range needs an on_conflict() clause");
+        using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+        return internal::upsert_range_t<It, Projection, O, U>{{std::move(from), std::move(to)},
+                                                              std::move(project),
+                                                              std::move(upsert)};
+    }
+
+    /*
+     *  Create an upsert range statement.
+     *  Overload of `upsert_range(It, It, U, Projection)` with explicit object type template parameter.
+     */
+    template<class O, class It, class U, class Projection = polyfill::identity>
+    internal::upsert_range_t<It, Projection, O, U> upsert_range(It from, It to, U upsert, Projection project = {}) {
+        static_assert(internal::is_upsert_clause<U>::value, "upsert_range needs an on_conflict() clause");
+        return {{std::move(from), std::move(to)}, std::move(project), std::move(upsert)};
+    }
+#endif
+
     /**
      *  Create an insert range statement.
      *  The objects in the range are transformed using the specified projection, which defaults to identity projection.
@@ -548,12 +839,44 @@ namespace sqlite_orm {
         return {{std::move(from), std::move(to)}, std::move(project)};
     }
 
+    /**
+     *  Create an insert range statement with a conflict resolution, e.g. `INSERT OR IGNORE` by `or_ignore()`
+     *  which skips the objects whose primary key or unique columns are taken instead of failing.
+     *
+     *  @example
+     *  ```
+     *  auto statement = storage.prepare(insert_range(events.begin(), events.end(), or_ignore()));
+     *  storage.execute(statement);
+     *  auto inserted = storage.changes();
+     *  ```
+     */
+    template<class It, class Projection = polyfill::identity>
+    auto insert_range(It from, It to, internal::insert_constraint constraint, Projection project = {}) {
+        using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+        return internal::insert_range_t<It, Projection, O>{{std::move(from), std::move(to)},
+                                                           std::move(project),
+                                                           constraint.action};
+    }
+
+    /*
+     *  Create an insert range statement with a conflict resolution.
+     *  Overload of `insert_range(It, It, insert_constraint, Projection)` with explicit object type template
+     *  parameter.
+     */
+    template<class O, class It, class Projection = polyfill::identity>
+    internal::insert_range_t<It, Projection, O>
+    insert_range(It from, It to, internal::insert_constraint constraint, Projection project = {}) {
+        return {{std::move(from), std::move(to)}, std::move(project), constraint.action};
+    }
+
     /**
      *  Create a replace statement.
      *  T is an object type mapped to a storage.
      *  Usage: storage.replace(myUserInstance);
-     *  Parameter obj is accepted by value. If you want to accept it by ref
-     *  please use std::ref function: storage.replace(std::ref(myUserInstance));
+     *  Parameter obj is accepted by value, so a temporary or `std::move(myUserInstance)` is moved into the
+     *  statement. If you want to accept it by ref please use std::ref function:
+     *  storage.replace(std::ref(myUserInstance)); the prepared statement then binds the current values of the
+     *  instance every time it's executed, without copying them.
      */
     template<class T>
     internal::replace_t<T> replace(T obj) {
@@ -564,8 +887,10 @@ namespace sqlite_orm {
      *  Create an insert statement.
      *  T is an object type mapped to a storage.
      *  Usage: storage.insert(myUserInstance);
-     *  Parameter obj is accepted by value. If you want to accept it by ref
-     *  please use std::ref function: storage.insert(std::ref(myUserInstance));
+     *  Parameter obj is accepted by value, so a temporary or `std::move(myUserInstance)` is moved into the
+     *  statement. If you want to accept it by ref please use std::ref function:
+     *  storage.insert(std::ref(myUserInstance)); the prepared statement then binds the current values of the
+     *  instance every time it's executed, without copying them.
      */
     template<class T>
     internal::insert_t<T> insert(T obj) {
@@ -683,9 +1008,41 @@ namespace sqlite_orm {
         return {move(conditions)};
     }
 
+    /**
+     *  Defines a statement once to be executed from many threads, e.g. by the workers of a pooled storage.
+     *  Every connection prepares it on its first execution there and keeps it until it is closed, so the
+     *  statements of a destroyed shared statement live as long as their connections.
+     *  Usage: static const auto getUser = make_shared_statement(get<User>(0));
+     *         auto user = storage.execute(getUser, [id](auto& statement) {
+     *             get<0>(statement) = id;
+     *         });
+     */
+    template<class S>
+    internal::shared_statement_t<S> make_shared_statement(S expression) {
+        return {std::move(expression)};
+    }
+
+    /**
+     *  Create a get all statement to be prepared and iterated over by `storage.iterate(statement)`, which
+     *  reuses the prepared statement every time the iteration starts over instead of preparing a new one.
+     *  Usage: auto statement = storage.prepare(iterate<User>(where(c(&User::id) > 10)));
+     *         for(auto& user: storage.iterate(statement)) { ... }
+     */
+    template<class T, class... Args>
+    internal::get_all_t<T, std::vector<T>, Args...> iterate(Args... args) {
+        return get_all<T>(std::forward<Args>(args)...);
+    }
+
     /**
      *  Create an update all statement.
      *  Usage: storage.update_all(set(...), ...);
+     *  With `from()` it is an UPDATE ... FROM (SQLite 3.33.0), which updates the rows from the rows of other
+     *  tables they are joined with by `where()`:
+     *  storage.update_all(set(c(&Product::price) = &PriceUpdate::price),
+     *                     from<PriceUpdate>(),
+     *                     where(c(&PriceUpdate::productId) == &Product::id));
+     *  - UPDATE "products" SET "price" = "price_updates"."price" FROM "price_updates"
+     *    WHERE ("price_updates"."product_id" = "products"."id")
      */
     template<class... Args, class... Wargs>
     internal::update_all_t<internal::set_t<Args...>, Wargs...> update_all(internal::set_t<Args...> set, Wargs... wh) {
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>  //  std::atomic
+#include <chrono>  //  std::chrono::steady_clock, std::chrono::milliseconds
+#include <functional>  //  std::less
+#include <list>  //  std::list
+#include <map>  //  std::map
+#include <memory>  //  std::shared_ptr
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <set>  //  std::set
+#include <string>  //  std::string
+#include <unordered_map>  //  std::unordered_map
+#include <utility>  //  std::move, std::pair
+#include <vector>  //  std::vector
+
+#include "change_hooks.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Settings of `storage.enable_query_cache()`.
+     */
+    struct query_cache_options {
+
+        /**
+         *  Number of results kept. The least recently used one is dropped when a new one doesn't fit.
+         */
+        size_t max_entries = 256;
+
+        /**
+         *  How long a result is used if `cached()` doesn't tell. Zero keeps results until a table they depend on
+         *  changes.
+         */
+        std::chrono::milliseconds ttl{0};
+    };
+
+    /**
+     *  Counters returned by `storage.query_cache_stats()`.
+     */
+    struct query_cache_stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t size = 0;
+    };
+
+    namespace internal {
+
+        /**
+         *  Results of `select(..., cached())` by their SQL with bound values expanded. Every result remembers
+         *  the versions of the tables it was read from. A change of a table seen by the change hooks bumps its
+         *  version, which makes the results read from it stale. Nothing is cached from a table while
+         *  a transaction that changed it is open.
+         */
+        struct query_cache : change_listener {
+            using clock = std::chrono::steady_clock;
+            using dependencies = std::vector<std::pair<std::string, size_t>>;
+
+            query_cache() = default;
+            query_cache(const query_cache&) = delete;
+            query_cache& operator=(const query_cache&) = delete;
+
+            bool enabled() const {
+                return this->isEnabled;
+            }
+
+            void enable(query_cache_options options_) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->options = std::move(options_);
+                this->isEnabled = true;
+                this->evict();
+            }
+
+            void disable() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->isEnabled = false;
+                this->clear_entries();
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->clear_entries();
+            }
+
+            query_cache_stats stats() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto result = this->statistics;
+                result.size = this->entries.size();
+                return result;
+            }
+
+            std::shared_ptr<const void> find(const std::string& key) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->index.find(key);
+                if(it != this->index.end()) {
+                    auto& entry = *it->second;
+                    if(this->is_fresh(entry)) {
+                        ++this->statistics.hits;
+                        this->entries.splice(this->entries.begin(), this->entries, it->second);
+                        return entry.value;
+                    }
+                    this->entries.erase(it->second);
+                    this->index.erase(it);
+                }
+                ++this->statistics.misses;
+                return nullptr;
+            }
+
+            /**
+             *  Returns the current versions of `tables`. Is called before the query so that a change made
+             *  meanwhile keeps its result out of the cache.
+             */
+            dependencies snapshot(const std::set<std::string>& tables) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                dependencies result;
+                result.reserve(tables.size());
+                for(auto& table: tables) {
+                    result.emplace_back(table, this->tables[table].version);
+                }
+                return result;
+            }
+
+            void insert(std::string key,
+                        std::shared_ptr<const void> value,
+                        dependencies tables_,
+                        std::chrono::milliseconds ttl) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if(!this->isEnabled || this->options.max_entries == 0) {
+                    return;
+                }
+                if(ttl.count() == 0) {
+                    ttl = this->options.ttl;
+                }
+                entry newEntry;
+                newEntry.key = key;
+                newEntry.value = std::move(value);
+                newEntry.tables = std::move(tables_);
+                newEntry.expires = ttl.count() > 0 ? clock::now() + ttl : clock::time_point::max();
+                if(!this->is_fresh(newEntry)) {
+                    return;
+                }
+                auto it = this->index.find(key);
+                if(it != this->index.end()) {
+                    this->entries.erase(it->second);
+                    this->index.erase(it);
+                }
+                this->entries.push_front(std::move(newEntry));
+                this->index.emplace(std::move(key), this->entries.begin());
+                this->evict();
+            }
+
+            /**
+             *  Called for changes the hooks don't see, e.g. `remove_all` which empties a table without
+             *  invoking the update hook.
+             */
+            void table_changed(const std::string& table) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->tables[table].version;
+            }
+
+            /**
+             *  Called after a COMMIT of `db` has finished, see `object_cache_registry::committed`.
+             */
+            void committed(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it != this->connections.end()) {
+                    for(auto table: it->second.committed) {
+                        ++table->version;
+                    }
+                    it->second.committed.clear();
+                }
+            }
+
+            bool listening() const override {
+                return this->isEnabled;
+            }
+
+            void changed(sqlite3* db, int /*operation*/, const char* table, sqlite3_int64 /*rowid*/) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->tables.find(table);
+                if(it == this->tables.end()) {
+                    it = this->tables.emplace(table, table_state{}).first;
+                }
+                auto& state = it->second;
+                ++state.version;
+                if(this->connections[db].pending.insert(&state).second) {
+                    ++state.writers;
+                }
+            }
+
+            void commit(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it == this->connections.end()) {
+                    return;
+                }
+                auto& changes = it->second;
+                for(auto table: changes.pending) {
+                    ++table->version;
+                    --table->writers;
+                }
+                changes.committed = std::move(changes.pending);
+                changes.pending.clear();
+            }
+
+            void rollback(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it != this->connections.end()) {
+                    it->second.end_writes();
+                }
+            }
+
+            void closed(sqlite3* db) override {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->connections.find(db);
+                if(it != this->connections.end()) {
+                    it->second.end_writes();
+                    this->connections.erase(it);
+                }
+            }
+
+          protected:
+            struct table_state {
+                size_t version = 0;
+                int writers = 0;
+            };
+
+            struct entry {
+                std::string key;
+                std::shared_ptr<const void> value;
+                dependencies tables;
+                clock::time_point expires;
+            };
+
+            /**
+             *  Tables a connection changed in its current transaction and in its last committed one.
+             */
+            struct connection_changes {
+                std::set<table_state*> pending;
+                std::set<table_state*> committed;
+
+                void end_writes() {
+                    for(auto table: this->pending) {
+                        ++table->version;
+                        --table->writers;
+                    }
+                    this->pending.clear();
+                    this->committed.clear();
+                }
+            };
+
+            bool is_fresh(const entry& entry) {
+                if(clock::now() >= entry.expires) {
+                    return false;
+                }
+                for(auto& table: entry.tables) {
+                    auto& state = this->tables[table.first];
+                    if(state.version != table.second || state.writers > 0) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void evict() {
+                while(this->entries.size() > this->options.max_entries) {
+                    this->index.erase(this->entries.back().key);
+                    this->entries.pop_back();
+                }
+            }
+
+            void clear_entries() {
+                this->index.clear();
+                this->entries.clear();
+            }
+
+            std::atomic<bool> isEnabled{false};
+            std::mutex mutex;
+            query_cache_options options;
+            std::list<entry> entries;
+            std::unordered_map<std::string, std::list<entry>::iterator> index;
+            std::map<std::string, table_state, std::less<>> tables;
+            std::map<sqlite3*, connection_changes> connections;
+            query_cache_stats statistics;
+        };
+    }
+}
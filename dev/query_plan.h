@@ -0,0 +1,110 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+#include <sstream>  //  std::stringstream
+#include <algorithm>  //  std::any_of
+#include <utility>  //  std::move
+
+#include "statement_finalizer.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  One row of `EXPLAIN QUERY PLAN` output. https://sqlite.org/eqp.html
+     */
+    struct query_plan_node {
+        int id = 0;
+        int parent = 0;
+        std::string detail;
+    };
+
+    /**
+     *  Result of `storage.explain_query_plan()`. Nodes are kept in the order SQLite reports them,
+     *  so every node comes after its parent. Top level nodes have `parent` equal to 0.
+     */
+    struct query_plan {
+        std::vector<query_plan_node> nodes;
+
+        /**
+         *  Returns child nodes of the node with `id` in the order SQLite reports them. Pass 0 to get top level nodes.
+         */
+        std::vector<const query_plan_node*> children(int id) const {
+            std::vector<const query_plan_node*> result;
+            for(auto& node: this->nodes) {
+                if(node.parent == id) {
+                    result.push_back(&node);
+                }
+            }
+            return result;
+        }
+
+        /**
+         *  Returns true if a detail of any node contains `text`, e.g. `plan.contains("USING INDEX")`.
+         */
+        bool contains(const std::string& text) const {
+            return std::any_of(this->nodes.begin(), this->nodes.end(), [&text](auto& node) {
+                return node.detail.find(text) != std::string::npos;
+            });
+        }
+
+        /**
+         *  Returns true if the plan scans the table `tableName` instead of searching it. Scans using
+         *  a covering index are scans as well. Use it to assert that a query uses an index:
+         *  `REQUIRE_FALSE(storage.explain_query_plan(statement).scans("users"))`.
+         */
+        bool scans(const std::string& tableName) const {
+            return std::any_of(this->nodes.begin(), this->nodes.end(), [&tableName](auto& node) {
+                //  SQLite before 3.36.0 reports `SCAN TABLE users`, newer versions `SCAN users`
+                for(const char* prefix: {"SCAN ", "SCAN TABLE "}) {
+                    const std::string scan = prefix + tableName;
+                    if(node.detail.compare(0, scan.size(), scan) == 0 &&
+                       (node.detail.size() == scan.size() || node.detail[scan.size()] == ' ')) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+        }
+
+        /**
+         *  Returns the plan as an indented tree like the sqlite3 shell prints it.
+         */
+        std::string str() const {
+            std::stringstream ss;
+            this->print(ss, 0, 0);
+            return ss.str();
+        }
+
+      protected:
+        void print(std::stringstream& ss, int parent, int depth) const {
+            for(auto node: this->children(parent)) {
+                ss << std::string(size_t(depth * 2), ' ') << node->detail << '\n';
+                this->print(ss, node->id, depth + 1);
+            }
+        }
+    };
+
+    namespace internal {
+
+        /**
+         *  Runs `EXPLAIN QUERY PLAN` for `sql` on `db`. Unbound parameters are NULL.
+         */
+        inline query_plan explain_query_plan(sqlite3* db, const std::string& sql) {
+            statement_finalizer stmt{prepare_stmt(db, "EXPLAIN QUERY PLAN " + sql)};
+            query_plan result;
+            perform_steps(stmt.get(), [&result](sqlite3_stmt* stmt) {
+                query_plan_node node;
+                node.id = sqlite3_column_int(stmt, 0);
+                node.parent = sqlite3_column_int(stmt, 1);
+                if(auto detail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3))) {
+                    node.detail = detail;
+                }
+                result.nodes.push_back(std::move(node));
+            });
+            return result;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <memory>  //  std::unique_ptr
+#include <system_error>  //  std::system_error
+#include <utility>  //  std::move
+
+#include "error_code.h"
+#include "connection_holder.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+#ifdef SQLITE_ENABLE_SNAPSHOT
+    namespace internal {
+
+        /**
+         *  Opens a read transaction on `db` reading the database state of `snapshot` and ends it when destroyed.
+         */
+        struct snapshot_read_guard {
+            snapshot_read_guard(sqlite3* db_, sqlite3_snapshot* snapshot) : db(db_) {
+                perform_void_exec(this->db, "BEGIN");
+                auto rc = sqlite3_snapshot_open(this->db, "main", snapshot);
+                if(rc != SQLITE_OK) {
+                    perform_void_exec(this->db, "ROLLBACK");
+                    throw_translated_sqlite_error(rc);
+                }
+            }
+
+            snapshot_read_guard(const snapshot_read_guard&) = delete;
+
+            ~snapshot_read_guard() {
+                sqlite3_exec(this->db, "COMMIT", nullptr, nullptr, nullptr);
+            }
+
+          private:
+            sqlite3* db;
+        };
+    }
+
+    /**
+     *  A state of the database that reads on other connections can be pinned to, see `storage.snapshot()` and
+     *  `storage.with_snapshot()`. The connection which took the snapshot stays in a read transaction until the
+     *  snapshot is destroyed, so the snapshot can't be checkpointed away and reads on the thread which took it
+     *  see the same state.
+     */
+    class read_snapshot {
+      public:
+        read_snapshot(internal::connection_ref connection_, sqlite3_snapshot* snapshot_) :
+            connection(std::move(connection_)), snapshot(snapshot_, sqlite3_snapshot_free) {}
+
+        read_snapshot(read_snapshot&&) = default;
+
+        ~read_snapshot() {
+            if(this->snapshot) {
+                this->snapshot.reset();
+                sqlite3_exec(this->connection.get(), "COMMIT", nullptr, nullptr, nullptr);
+            }
+        }
+
+        sqlite3_snapshot* get() const {
+            return this->snapshot.get();
+        }
+
+      private:
+        internal::connection_ref connection;
+        std::unique_ptr<sqlite3_snapshot, void (*)(sqlite3_snapshot*)> snapshot;
+    };
+#endif
+}
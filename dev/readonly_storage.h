@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>  //  std::max
+#include <fstream>  //  std::ifstream
+#include <string>  //  std::string
+#include <thread>  //  std::thread::hardware_concurrency
+#include <type_traits>  //  std::false_type, std::true_type, std::enable_if_t
+#include <utility>  //  std::move, std::forward
+
+#include "functional/cxx_universal.h"
+#include "connection_holder.h"
+#include "prepared_statement.h"
+#include "select_constraints.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        template<class T>
+        struct is_read_statement : std::false_type {};
+
+        template<class T, class... Args>
+        struct is_read_statement<select_t<T, Args...>> : std::true_type {};
+
+        template<class T, class R, class... Args>
+        struct is_read_statement<get_all_t<T, R, Args...>> : std::true_type {};
+
+        template<class T, class R, class... Args>
+        struct is_read_statement<get_all_pointer_t<T, R, Args...>> : std::true_type {};
+
+        template<class T, class... Ids>
+        struct is_read_statement<get_t<T, Ids...>> : std::true_type {};
+
+        template<class T, class... Ids>
+        struct is_read_statement<get_pointer_t<T, Ids...>> : std::true_type {};
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        template<class T, class R, class... Args>
+        struct is_read_statement<get_all_optional_t<T, R, Args...>> : std::true_type {};
+
+        template<class T, class... Ids>
+        struct is_read_statement<get_optional_t<T, Ids...>> : std::true_type {};
+#endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
+
+        /**
+         *  A storage of a database file that is never written, shipped with the application. Only the reading
+         *  functions of `storage_t` are available, so a call of `insert()`, `update()`, `sync_schema()` and
+         *  the like doesn't compile. Don't construct it as is, call `make_readonly_storage()` instead.
+         */
+        template<class... DBO>
+        struct readonly_storage_t : private storage_t<DBO...> {
+            using storage_type = storage_t<DBO...>;
+            using db_objects_type = typename storage_type::db_objects_type;
+
+            readonly_storage_t(const pool_options& poolOptions, std::string filename, db_objects_type dbObjects) :
+                storage_type{poolOptions, readonly_open_options(), filename, std::move(dbObjects)} {
+                this->pragma.query_only(true);
+                auto size = file_size(filename);
+                if(size > 0) {
+                    this->pragma.mmap_size(size);
+                }
+            }
+
+            using storage_type::avg;
+            using storage_type::count;
+            using storage_type::dump;
+            using storage_type::explain_query_plan;
+            using storage_type::filename;
+            using storage_type::for_each_row;
+            using storage_type::get;
+            using storage_type::get_all;
+            using storage_type::get_all_pointer;
+            using storage_type::get_pointer;
+            using storage_type::group_concat;
+            using storage_type::iterate;
+            using storage_type::max;
+            using storage_type::min;
+            using storage_type::pragma;
+            using storage_type::select;
+            using storage_type::select_each;
+            using storage_type::sum;
+            using storage_type::total;
+#if SQLITE_VERSION_NUMBER >= 3010000
+            using storage_type::status;
+#endif
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+            using storage_type::get_optional;
+#endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
+
+            /**
+             *  Prepares SELECT and get statements, others don't compile.
+             */
+            template<class T, std::enable_if_t<is_read_statement<T>::value, bool> = true>
+            auto prepare(T expression) {
+                return storage_type::prepare(std::move(expression));
+            }
+
+            template<class T, std::enable_if_t<is_read_statement<T>::value, bool> = true>
+            decltype(auto) execute(const prepared_statement_t<T>& statement) {
+                return storage_type::execute(statement);
+            }
+
+          private:
+            static open_options readonly_open_options() {
+                open_options options;
+                options.readonly = true;
+                options.immutable = true;
+                //  pooled connections are used by one thread at a time
+                options.no_mutex = true;
+                return options;
+            }
+
+            static sqlite3_int64 file_size(const std::string& filename) {
+                std::ifstream stream{filename, std::ios::binary | std::ios::ate};
+                return stream ? sqlite3_int64(stream.tellg()) : 0;
+            }
+        };
+    }
+
+    /**
+     *  Opens the database file `filename` that nothing ever changes, e.g. a catalogue shipped with the
+     *  application, for reading only: connections are opened read-only with `immutable=1`, so they take no
+     *  locks, with `query_only` and with the whole file memory mapped (`mmap_size`, at most SQLITE_MAX_MMAP_SIZE)
+     *  so that reads are memory reads. Every thread reading at the same time gets its own connection from a pool
+     *  of `poolOptions.size` connections. The returned storage only has the reading functions.
+     *  Example: auto catalogue = make_readonly_storage("catalogue.sqlite", make_table(...));
+     *           auto products = catalogue.get_all<Product>(where(c(&Product::category) == 3));
+     */
+    template<class... DBO>
+    internal::readonly_storage_t<DBO...>
+    make_readonly_storage(const pool_options& poolOptions, std::string filename, DBO... dbObjects) {
+        return {poolOptions, move(filename), internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...}};
+    }
+
+    template<class... DBO>
+    internal::readonly_storage_t<DBO...> make_readonly_storage(std::string filename, DBO... dbObjects) {
+        pool_options poolOptions;
+        poolOptions.size = int(std::max(std::thread::hardware_concurrency(), 4u));
+        return make_readonly_storage(poolOptions, move(filename), std::forward<DBO>(dbObjects)...);
+    }
+}
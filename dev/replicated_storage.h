@@ -0,0 +1,298 @@
+#pragma once
+
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::steady_clock, std::chrono::duration_cast
+#include <condition_variable>  //  std::condition_variable
+#include <cstdio>  //  std::remove
+#include <exception>  //  std::exception_ptr, std::current_exception
+#include <functional>  //  std::function
+#include <memory>  //  std::shared_ptr, std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::lock_guard, std::unique_lock
+#include <string>  //  std::string
+#include <thread>  //  std::thread
+#include <utility>  //  std::move, std::declval
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "backup.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Settings of a `replicated_storage`.
+     */
+    struct replica_options {
+
+        /**
+         *  Reads go to the primary instead of the replica if the replica is older than this. A per-read bound is
+         *  passed to `read()`.
+         */
+        std::chrono::milliseconds max_staleness = std::chrono::milliseconds::max();
+
+        /**
+         *  The replica is refreshed this often on a thread of the replicated storage. Zero refreshes it only by
+         *  `refresh()`.
+         */
+        std::chrono::milliseconds refresh_interval{0};
+
+        /**
+         *  How the primary is copied into a new replica. The default steps leave the primary to its writers
+         *  between the steps.
+         */
+        backup_options backup;
+
+        /**
+         *  Called on the refreshing thread with the exception of a failed refresh. The current replica stays.
+         */
+        std::function<void(std::exception_ptr)> on_refresh_error;
+    };
+
+    namespace internal {
+
+        /**
+         *  A storage whose reads are served by a local copy of its database, the replica, and whose writes go to
+         *  the primary database. Don't construct it as is, call `make_replicated_storage()` instead.
+         *  A refresh copies the primary into a new replica with an incremental backup and swaps it in, so reads
+         *  never wait for a refresh and see the whole database as it was when the copy was taken. Reads that
+         *  started on the former replica finish on it, its file is deleted after them.
+         *  Writes are not visible to the reads of the replica until the next refresh, a read that must see them
+         *  passes a smaller staleness bound or goes to `primary()`.
+         */
+        template<class S>
+        struct replicated_storage {
+            using storage_type = S;
+            using replica_factory = std::function<storage_type(size_t generation)>;
+
+            replicated_storage(storage_type primary_, replica_factory makeReplica_, replica_options options_) :
+                state(std::make_unique<shared_state>(std::move(primary_),
+                                                     std::move(makeReplica_),
+                                                     std::move(options_))) {
+                if(this->state->options.refresh_interval.count() > 0) {
+                    auto state_ = this->state.get();
+                    this->state->thread = std::thread{[state_] {
+                        state_->run();
+                    }};
+                }
+            }
+
+            storage_type& primary() {
+                return this->state->primary;
+            }
+
+            /**
+             *  Copies the primary into a new replica and swaps it in. Concurrent refreshes run one after another.
+             *  @return false if the copy took longer than `options.backup.max_duration`, the replica stays as it was.
+             */
+            bool refresh() {
+                return this->state->refresh();
+            }
+
+            /**
+             *  Number of refreshes that swapped in a replica.
+             */
+            size_t generation() const {
+                std::lock_guard<std::mutex> lock{this->state->mutex};
+                return this->state->generation;
+            }
+
+            /**
+             *  Age of the replica since the copy was started, `milliseconds::max()` before the first refresh.
+             */
+            std::chrono::milliseconds staleness() const {
+                auto replica = this->state->current();
+                return replica ? age_of(*replica) : std::chrono::milliseconds::max();
+            }
+
+            /**
+             *  Calls `f(storage)` with the replica if it is at most `maxStaleness` old, otherwise with the primary.
+             *  The replica stays alive until `f` returns, even if a refresh swaps in a new one meanwhile.
+             *  Example: auto orders = replicated.read([](auto& storage) {
+             *               return storage.template get_all<Order>(where(c(&Order::userId) == 1));
+             *           }, std::chrono::seconds{5});
+             */
+            template<class F>
+            auto read(F f, std::chrono::milliseconds maxStaleness) -> decltype(f(std::declval<storage_type&>())) {
+                auto replica = this->state->current();
+                if(replica && age_of(*replica) <= maxStaleness) {
+                    return f(replica->storage);
+                }
+                return f(this->state->primary);
+            }
+
+            template<class F>
+            auto read(F f) -> decltype(f(std::declval<storage_type&>())) {
+                return this->read(std::move(f), this->state->options.max_staleness);
+            }
+
+            template<class O, class Id, class... Ids>
+            O get(const Id& id, Ids... ids) {
+                return this->read([&id, &ids...](storage_type& storage) {
+                    return storage.template get<O>(id, ids...);
+                });
+            }
+
+            template<class O, class Id, class... Ids>
+            std::unique_ptr<O> get_pointer(const Id& id, Ids... ids) {
+                return this->read([&id, &ids...](storage_type& storage) {
+                    return storage.template get_pointer<O>(id, ids...);
+                });
+            }
+
+            template<class O, class... Args>
+            std::vector<O> get_all(Args... args) {
+                return this->read([&args...](storage_type& storage) {
+                    return storage.template get_all<O>(args...);
+                });
+            }
+
+            template<class T, class... Args>
+            auto select(T expression, Args... args) {
+                return this->read([&expression, &args...](storage_type& storage) {
+                    return storage.select(expression, args...);
+                });
+            }
+
+            template<class O, class... Args>
+            int64 count(Args... args) {
+                return this->read([&args...](storage_type& storage) {
+                    return storage.template count<O>(args...);
+                });
+            }
+
+            template<class O>
+            int insert(const O& object) {
+                return this->state->primary.insert(object);
+            }
+
+            template<class O>
+            void replace(const O& object) {
+                this->state->primary.replace(object);
+            }
+
+            template<class O>
+            void update(const O& object) {
+                this->state->primary.update(object);
+            }
+
+            template<class O, class Id, class... Ids>
+            void remove(const Id& id, Ids... ids) {
+                this->state->primary.template remove<O>(id, std::move(ids)...);
+            }
+
+            template<class O, class... Args>
+            void remove_all(Args... args) {
+                this->state->primary.template remove_all<O>(std::move(args)...);
+            }
+
+          private:
+            struct replica {
+                storage_type storage;
+                std::chrono::steady_clock::time_point copied;
+            };
+
+            /**
+             *  Everything the refreshing thread uses, so that the replicated storage can be moved.
+             */
+            struct shared_state {
+                shared_state(storage_type primary_, replica_factory makeReplica_, replica_options options_) :
+                    primary(std::move(primary_)), makeReplica(std::move(makeReplica_)), options(std::move(options_)) {}
+
+                ~shared_state() {
+                    if(this->thread.joinable()) {
+                        {
+                            std::lock_guard<std::mutex> lock{this->mutex};
+                            this->stopping = true;
+                        }
+                        this->stopped.notify_one();
+                        this->thread.join();
+                    }
+                }
+
+                std::shared_ptr<replica> current() {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    return this->replica_;
+                }
+
+                bool refresh() {
+                    std::lock_guard<std::mutex> refreshLock{this->refreshMutex};
+                    size_t next;
+                    {
+                        std::lock_guard<std::mutex> lock{this->mutex};
+                        next = this->generation + 1;
+                    }
+                    const auto copied = std::chrono::steady_clock::now();
+                    std::shared_ptr<replica> created{new replica{this->makeReplica(next), copied}, retire};
+                    created->storage.open_forever();
+                    if(!this->primary.backup_to(created->storage, this->options.backup)) {
+                        return false;
+                    }
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->replica_ = std::move(created);
+                    this->generation = next;
+                    return true;
+                }
+
+                void run() {
+                    std::unique_lock<std::mutex> lock{this->mutex};
+                    while(!this->stopped.wait_for(lock, this->options.refresh_interval, [this] {
+                        return this->stopping;
+                    })) {
+                        lock.unlock();
+                        try {
+                            this->refresh();
+                        } catch(...) {
+                            if(this->options.on_refresh_error) {
+                                this->options.on_refresh_error(std::current_exception());
+                            }
+                        }
+                        lock.lock();
+                    }
+                }
+
+                /**
+                 *  Deletes a replica nobody reads any more together with its file.
+                 */
+                static void retire(replica* retired) {
+                    auto filename = retired->storage.filename();
+                    delete retired;
+                    if(!filename.empty() && filename != ":memory:") {
+                        std::remove(filename.c_str());
+                    }
+                }
+
+                storage_type primary;
+                replica_factory makeReplica;
+                replica_options options;
+                mutable std::mutex mutex;
+                std::mutex refreshMutex;
+                std::condition_variable stopped;
+                bool stopping = false;
+                size_t generation = 0;
+                std::shared_ptr<replica> replica_;
+                std::thread thread;
+            };
+
+            static std::chrono::milliseconds age_of(const replica& replica_) {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                             replica_.copied);
+            }
+
+            std::unique_ptr<shared_state> state;
+        };
+    }
+
+    /**
+     *  Makes a `replicated_storage` writing to `primary` and reading from replicas made by
+     *  `makeReplica(generation)`, a storage with the same schema in a local file of its own for every
+     *  generation, or in memory. Reads go to the primary until the first `refresh()`.
+     *  Example: auto replicated = make_replicated_storage(
+     *               make_storage("/mnt/shared/orders.sqlite", make_table(...)),
+     *               [](size_t generation) {
+     *                   return make_storage("/tmp/orders." + std::to_string(generation) + ".sqlite", make_table(...));
+     *               },
+     *               options);
+     */
+    template<class S, class F>
+    internal::replicated_storage<S> make_replicated_storage(S primary, F makeReplica, replica_options options = {}) {
+        return {std::move(primary), std::move(makeReplica), std::move(options)};
+    }
+}
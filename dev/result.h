@@ -0,0 +1,116 @@
+#pragma once
+
+#include <system_error>  //  std::error_code, std::system_error
+#include <utility>  //  std::move
+
+namespace sqlite_orm {
+
+    /**
+     *  The value of an operation or the error it failed with, returned by the `try_` functions of the storage
+     *  instead of throwing. Only `error().message()` formats the message of the error.
+     *  T has to be default constructible, like mapped objects are.
+     */
+    template<class T>
+    class result {
+      public:
+        using value_type = T;
+
+        result(value_type value_) : storedValue(std::move(value_)) {}
+
+        result(std::error_code code_) : code(code_) {}
+
+        bool has_value() const noexcept {
+            return !this->code;
+        }
+
+        explicit operator bool() const noexcept {
+            return this->has_value();
+        }
+
+        /**
+         *  @throws `std::system_error` with the error if there is no value.
+         */
+        value_type& value() & {
+            this->check();
+            return this->storedValue;
+        }
+
+        const value_type& value() const& {
+            this->check();
+            return this->storedValue;
+        }
+
+        value_type&& value() && {
+            this->check();
+            return std::move(this->storedValue);
+        }
+
+        value_type& operator*() & noexcept {
+            return this->storedValue;
+        }
+
+        const value_type& operator*() const& noexcept {
+            return this->storedValue;
+        }
+
+        value_type&& operator*() && noexcept {
+            return std::move(this->storedValue);
+        }
+
+        value_type* operator->() noexcept {
+            return &this->storedValue;
+        }
+
+        const value_type* operator->() const noexcept {
+            return &this->storedValue;
+        }
+
+        const std::error_code& error() const noexcept {
+            return this->code;
+        }
+
+      private:
+        value_type storedValue{};
+        std::error_code code;
+
+        void check() const {
+            if(this->code) {
+                throw std::system_error{this->code};
+            }
+        }
+    };
+
+    template<>
+    class result<void> {
+      public:
+        using value_type = void;
+
+        result() = default;
+
+        result(std::error_code code_) : code(code_) {}
+
+        bool has_value() const noexcept {
+            return !this->code;
+        }
+
+        explicit operator bool() const noexcept {
+            return this->has_value();
+        }
+
+        /**
+         *  @throws `std::system_error` with the error if the operation failed.
+         */
+        void value() const {
+            if(this->code) {
+                throw std::system_error{this->code};
+            }
+        }
+
+        const std::error_code& error() const noexcept {
+            return this->code;
+        }
+
+      private:
+        std::error_code code;
+    };
+}
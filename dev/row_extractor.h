@@ -5,22 +5,27 @@
 #include <stdlib.h>  //  atof, atoi, atoll
 #include <system_error>  //  std::system_error
 #include <string>  //  std::string, std::wstring
-#ifndef SQLITE_ORM_OMITS_CODECVT
-#include <codecvt>  //  std::wstring_convert, std::codecvt_utf8_utf16
-#endif  //  SQLITE_ORM_OMITS_CODECVT
 #include <vector>  //  std::vector
 #include <cstring>  //  strlen
-#include <locale>
 #include <algorithm>  //  std::copy
 #include <iterator>  //  std::back_inserter
 #include <tuple>  //  std::tuple, std::tuple_size, std::tuple_element
+#include "functional/cxx_string_view.h"
+#include "functional/cxx_memory_resource.h"
+#if SQLITE_ORM_HAS_INCLUDE(<span>)
+#include <span>  //  std::span
+#endif
 
 #include "functional/cxx_universal.h"
+#include "wide_string.h"
 #include "arithmetic_tag.h"
 #include "pointer_value.h"
 #include "journal_mode.h"
 #include "error_code.h"
 #include "is_std_ptr.h"
+#include "memory_resource_scope.h"
+#include "byte_vector.h"
+#include "stored_value.h"
 
 namespace sqlite_orm {
 
@@ -143,7 +148,7 @@ namespace sqlite_orm {
 
         std::string extract(sqlite3_stmt* stmt, int columnIndex) const {
             if(auto cStr = (const char*)sqlite3_column_text(stmt, columnIndex)) {
-                return cStr;
+                return {cStr, size_t(sqlite3_column_bytes(stmt, columnIndex))};
             } else {
                 return {};
             }
@@ -151,43 +156,141 @@ namespace sqlite_orm {
 
         std::string extract(sqlite3_value* value) const {
             if(auto cStr = (const char*)sqlite3_value_text(value)) {
-                return cStr;
+                return {cStr, size_t(sqlite3_value_bytes(value))};
             } else {
                 return {};
             }
         }
     };
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+    /**
+     *  Specialization for std::pmr::string. Allocates from the memory resource passed to
+     *  `get_all<O>(arena, ...)` or from the default one.
+     */
+    template<>
+    struct row_extractor<std::pmr::string, void> {
+        std::pmr::string extract(const char* row_value) const {
+            std::pmr::string result{internal::extraction_memory_resource()};
+            if(row_value) {
+                result = row_value;
+            }
+            return result;
+        }
+
+        std::pmr::string extract(sqlite3_stmt* stmt, int columnIndex) const {
+            std::pmr::string result{internal::extraction_memory_resource()};
+            if(auto cStr = (const char*)sqlite3_column_text(stmt, columnIndex)) {
+                result.assign(cStr, size_t(sqlite3_column_bytes(stmt, columnIndex)));
+            }
+            return result;
+        }
+
+        std::pmr::string extract(sqlite3_value* value) const {
+            std::pmr::string result{internal::extraction_memory_resource()};
+            if(auto cStr = (const char*)sqlite3_value_text(value)) {
+                result.assign(cStr, size_t(sqlite3_value_bytes(value)));
+            }
+            return result;
+        }
+    };
+#endif  //  SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+    /**
+     *  Specialization for std::string_view.
+     *  The view points straight into the buffer of sqlite and is valid only until the statement is stepped,
+     *  reset or finalized, e.g. while the current row of `iterate()` or a `for_each_row()` callback is being processed.
+     */
+    template<>
+    struct row_extractor<std::string_view, void> {
+        std::string_view extract(const char* row_value) const {
+            if(row_value) {
+                return row_value;
+            } else {
+                return {};
+            }
+        }
+
+        std::string_view extract(sqlite3_stmt* stmt, int columnIndex) const {
+            if(auto cStr = (const char*)sqlite3_column_text(stmt, columnIndex)) {
+                return {cStr, size_t(sqlite3_column_bytes(stmt, columnIndex))};
+            } else {
+                return {};
+            }
+        }
+
+        std::string_view extract(sqlite3_value* value) const {
+            if(auto cStr = (const char*)sqlite3_value_text(value)) {
+                return {cStr, size_t(sqlite3_value_bytes(value))};
+            } else {
+                return {};
+            }
+        }
+    };
+#endif  //  SQLITE_ORM_STRING_VIEW_SUPPORTED
+
+#if __cpp_lib_span >= 202002L
+    /**
+     *  Specialization for std::span<const std::byte>. Points into the buffer of sqlite just like
+     *  the std::string_view specialization and has the same lifetime.
+     */
+    template<>
+    struct row_extractor<std::span<const std::byte>, void> {
+        std::span<const std::byte> extract(const char* row_value) const {
+            if(row_value) {
+                return {reinterpret_cast<const std::byte*>(row_value), ::strlen(row_value)};
+            } else {
+                return {};
+            }
+        }
+
+        std::span<const std::byte> extract(sqlite3_stmt* stmt, int columnIndex) const {
+            auto bytes = static_cast<const std::byte*>(sqlite3_column_blob(stmt, columnIndex));
+            return {bytes, size_t(sqlite3_column_bytes(stmt, columnIndex))};
+        }
+
+        std::span<const std::byte> extract(sqlite3_value* value) const {
+            auto bytes = static_cast<const std::byte*>(sqlite3_value_blob(value));
+            return {bytes, size_t(sqlite3_value_bytes(value))};
+        }
+    };
+#endif
+
 #ifndef SQLITE_ORM_OMITS_CODECVT
     /**
-     *  Specialization for std::wstring.
+     *  Specialization for std::wstring. Where `wchar_t` is 16 bits wide SQLite returns the text as UTF-16,
+     *  otherwise UTF-8 is decoded to UTF-32.
      */
     template<>
     struct row_extractor<std::wstring, void> {
         std::wstring extract(const char* row_value) const {
             if(row_value) {
-                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-                return converter.from_bytes(row_value);
+                return internal::from_utf8(row_value, ::strlen(row_value));
             } else {
                 return {};
             }
         }
 
         std::wstring extract(sqlite3_stmt* stmt, int columnIndex) const {
-            auto cStr = (const char*)sqlite3_column_text(stmt, columnIndex);
-            if(cStr) {
-                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-                return converter.from_bytes(cStr);
-            } else {
-                return {};
+            if(internal::is_wchar_utf16_v) {
+                if(auto cStr = (const wchar_t*)sqlite3_column_text16(stmt, columnIndex)) {
+                    return {cStr, size_t(sqlite3_column_bytes16(stmt, columnIndex)) / sizeof(wchar_t)};
+                }
+            } else if(auto cStr = (const char*)sqlite3_column_text(stmt, columnIndex)) {
+                return internal::from_utf8(cStr, size_t(sqlite3_column_bytes(stmt, columnIndex)));
             }
+            return {};
         }
 
         std::wstring extract(sqlite3_value* value) const {
-            if(auto cStr = (const wchar_t*)sqlite3_value_text16(value)) {
-                return cStr;
-            } else {
-                return {};
+            if(internal::is_wchar_utf16_v) {
+                if(auto cStr = (const wchar_t*)sqlite3_value_text16(value)) {
+                    return {cStr, size_t(sqlite3_value_bytes16(value)) / sizeof(wchar_t)};
+                }
+            } else if(auto cStr = (const char*)sqlite3_value_text(value)) {
+                return internal::from_utf8(cStr, size_t(sqlite3_value_bytes(value)));
             }
+            return {};
         }
     };
 #endif  //  SQLITE_ORM_OMITS_CODECVT
@@ -292,6 +395,108 @@ namespace sqlite_orm {
         }
     };
 
+    /**
+     *  Specialization for std::vector<unsigned char> (std::vector<uint8_t>) and std::vector<std::byte>.
+     */
+    template<class V>
+    struct row_extractor<V, std::enable_if_t<internal::is_byte_vector_v<V>>> {
+        using byte_type = typename V::value_type;
+
+        V extract(const char* row_value) const {
+            auto bytes = reinterpret_cast<const byte_type*>(row_value);
+            return {bytes, bytes + (row_value ? ::strlen(row_value) : 0)};
+        }
+
+        V extract(sqlite3_stmt* stmt, int columnIndex) const {
+            auto bytes = static_cast<const byte_type*>(sqlite3_column_blob(stmt, columnIndex));
+            auto len = static_cast<size_t>(sqlite3_column_bytes(stmt, columnIndex));
+            return {bytes, bytes + len};
+        }
+
+        V extract(sqlite3_value* value) const {
+            auto bytes = static_cast<const byte_type*>(sqlite3_value_blob(value));
+            auto len = static_cast<size_t>(sqlite3_value_bytes(value));
+            return {bytes, bytes + len};
+        }
+    };
+
+    /**
+     *  Specialization for fixed size BLOBs, std::array<unsigned char, N> and std::array<std::byte, N>, such as
+     *  16 byte UUIDs. A shorter BLOB or NULL leaves the remaining bytes zero, a longer BLOB throws.
+     */
+    template<class A>
+    struct row_extractor<A, std::enable_if_t<internal::is_byte_array_v<A>>> {
+        A extract(const char* row_value) const {
+            return this->extract(row_value, row_value ? ::strlen(row_value) : 0);
+        }
+
+        A extract(sqlite3_stmt* stmt, int columnIndex) const {
+            return this->extract(sqlite3_column_blob(stmt, columnIndex),
+                                 static_cast<size_t>(sqlite3_column_bytes(stmt, columnIndex)));
+        }
+
+        A extract(sqlite3_value* value) const {
+            return this->extract(sqlite3_value_blob(value), static_cast<size_t>(sqlite3_value_bytes(value)));
+        }
+
+      private:
+        A extract(const void* data, size_t len) const {
+            A result{};
+            if(len > result.size()) {
+                throw std::system_error{orm_error_code::blob_exceeds_buffer};
+            }
+            auto bytes = static_cast<const typename A::value_type*>(data);
+            std::copy(bytes, bytes + len, result.begin());
+            return result;
+        }
+    };
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+    /**
+     *  Specialization for std::pmr::vector<char>, allocating like the std::pmr::string one.
+     */
+    template<>
+    struct row_extractor<std::pmr::vector<char>> {
+        std::pmr::vector<char> extract(const char* row_value) const {
+            auto len = row_value ? ::strlen(row_value) : 0;
+            return {row_value, row_value + len, internal::extraction_memory_resource()};
+        }
+
+        std::pmr::vector<char> extract(sqlite3_stmt* stmt, int columnIndex) const {
+            auto bytes = static_cast<const char*>(sqlite3_column_blob(stmt, columnIndex));
+            auto len = static_cast<size_t>(sqlite3_column_bytes(stmt, columnIndex));
+            return {bytes, bytes + len, internal::extraction_memory_resource()};
+        }
+
+        std::pmr::vector<char> extract(sqlite3_value* value) const {
+            auto bytes = static_cast<const char*>(sqlite3_value_blob(value));
+            auto len = static_cast<size_t>(sqlite3_value_bytes(value));
+            return {bytes, bytes + len, internal::extraction_memory_resource()};
+        }
+    };
+#endif  //  SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+
+    /**
+     *  Specialization for scoped enums and std::chrono types, extracted from the value they are stored as.
+     */
+    template<class V>
+    struct row_extractor<V, std::enable_if_t<internal::is_stored_value_v<V>>> {
+        using stored_value = internal::stored_value<V>;
+        using stored_extractor = row_extractor<typename stored_value::stored_type>;
+
+        V extract(const char* row_value) const {
+            return stored_value::from_stored(stored_extractor().extract(row_value));
+        }
+
+        V extract(sqlite3_stmt* stmt, int columnIndex) const {
+            return stored_value::from_stored(stored_extractor().extract(stmt, columnIndex));
+        }
+
+        V extract(sqlite3_value* value) const {
+            return stored_value::from_stored(stored_extractor().extract(value));
+        }
+    };
+
     template<class... Args>
     struct row_extractor<std::tuple<Args...>> {
 
@@ -299,14 +504,17 @@ namespace sqlite_orm {
             return this->extract(argv, std::make_index_sequence<sizeof...(Args)>{});
         }
 
-        std::tuple<Args...> extract(sqlite3_stmt* stmt, int /*columnIndex*/) const {
-            return this->extract(stmt, std::make_index_sequence<sizeof...(Args)>{});
+        /**
+         *  Element I is read from column `columnIndex + I`.
+         */
+        std::tuple<Args...> extract(sqlite3_stmt* stmt, int columnIndex) const {
+            return this->extract(stmt, columnIndex, std::make_index_sequence<sizeof...(Args)>{});
         }
 
       protected:
         template<size_t... Idx>
-        std::tuple<Args...> extract(sqlite3_stmt* stmt, std::index_sequence<Idx...>) const {
-            return std::tuple<Args...>{row_extractor<Args>{}.extract(stmt, Idx)...};
+        std::tuple<Args...> extract(sqlite3_stmt* stmt, int columnIndex, std::index_sequence<Idx...>) const {
+            return std::tuple<Args...>{row_extractor<Args>{}.extract(stmt, columnIndex + int(Idx))...};
         }
 
         template<size_t... Idx>
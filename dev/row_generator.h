@@ -0,0 +1,149 @@
+#pragma once
+
+#include "functional/cxx_coroutine.h"
+
+#ifdef SQLITE_ORM_COROUTINES_SUPPORTED
+#include <cstddef>  //  std::ptrdiff_t
+#include <exception>  //  std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <iterator>  //  std::input_iterator_tag, std::default_sentinel_t
+#include <memory>  //  std::addressof
+#include <utility>  //  std::exchange
+#endif
+
+namespace sqlite_orm {
+#ifdef SQLITE_ORM_COROUTINES_SUPPORTED
+    namespace internal {
+
+        /**
+         *  Input range of the rows a coroutine yields, for C++20 builds without `std::generator`. The coroutine
+         *  runs until the next `co_yield` every time the iterator is incremented, and is destroyed with the
+         *  generator. A yielded row is valid until the iterator is incremented.
+         */
+        template<class T>
+        class row_generator : public std::ranges::view_base {
+          public:
+            struct promise_type {
+                const T* row = nullptr;
+                std::exception_ptr exception;
+
+                row_generator get_return_object() noexcept {
+                    return row_generator{handle_type::from_promise(*this)};
+                }
+
+                std::suspend_always initial_suspend() const noexcept {
+                    return {};
+                }
+
+                std::suspend_always final_suspend() const noexcept {
+                    return {};
+                }
+
+                std::suspend_always yield_value(const T& row_) noexcept {
+                    this->row = std::addressof(row_);
+                    return {};
+                }
+
+                void return_void() const noexcept {}
+
+                void unhandled_exception() noexcept {
+                    this->exception = std::current_exception();
+                }
+            };
+
+            using handle_type = std::coroutine_handle<promise_type>;
+
+            class iterator {
+              public:
+                using iterator_concept = std::input_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using reference = const T&;
+
+                iterator() = default;
+
+                const T& operator*() const {
+                    return *this->coroutine.promise().row;
+                }
+
+                iterator& operator++() {
+                    resume(this->coroutine);
+                    return *this;
+                }
+
+                void operator++(int) {
+                    ++*this;
+                }
+
+                friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+                    return !it.coroutine || it.coroutine.done();
+                }
+
+              private:
+                friend class row_generator;
+
+                explicit iterator(handle_type coroutine_) : coroutine(coroutine_) {}
+
+                handle_type coroutine;
+            };
+
+            row_generator() = default;
+
+            row_generator(row_generator&& other) noexcept : coroutine(std::exchange(other.coroutine, {})) {}
+
+            row_generator& operator=(row_generator&& other) noexcept {
+                if(this != &other) {
+                    this->destroy();
+                    this->coroutine = std::exchange(other.coroutine, {});
+                }
+                return *this;
+            }
+
+            ~row_generator() {
+                this->destroy();
+            }
+
+            /**
+             *  Runs the coroutine until the first row. Can be called once.
+             */
+            iterator begin() {
+                resume(this->coroutine);
+                return iterator{this->coroutine};
+            }
+
+            std::default_sentinel_t end() const noexcept {
+                return {};
+            }
+
+          private:
+            explicit row_generator(handle_type coroutine_) : coroutine(coroutine_) {}
+
+            static void resume(handle_type coroutine) {
+                coroutine.resume();
+                if(auto exception = std::exchange(coroutine.promise().exception, nullptr)) {
+                    std::rethrow_exception(exception);
+                }
+            }
+
+            void destroy() {
+                if(this->coroutine) {
+                    this->coroutine.destroy();
+                }
+            }
+
+            handle_type coroutine;
+        };
+    }
+
+    /**
+     *  Result of `storage.stream()`: `std::generator<const T&>` if the standard library has it, an input range
+     *  alike otherwise.
+     */
+#ifdef SQLITE_ORM_GENERATOR_SUPPORTED
+    template<class T>
+    using row_stream = std::generator<const T&>;
+#else
+    template<class T>
+    using row_stream = internal::row_generator<T>;
+#endif
+#endif  //  SQLITE_ORM_COROUTINES_SUPPORTED
+}
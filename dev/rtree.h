@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>  //  std::make_shared
+#include <string>  //  std::string
+#include <tuple>  //  std::tuple
+#include <type_traits>  //  std::tuple_element_t
+#include <utility>  //  std::move, std::forward
+
+#include "functional/cxx_universal.h"
+#include "serialize_result_type.h"
+#include "rtree_options.h"
+#include "core_functions.h"
+#include "table.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        template<class F>
+        struct rtree_query_string {
+            serialize_result_type serialize() const {
+                return F::name();
+            }
+        };
+    }
+
+    /**
+     *  Maps an R*Tree virtual table, which `sync_schema()` creates by `CREATE VIRTUAL TABLE ... USING rtree(...)`.
+     *  The first column is the integer id, followed by the minimum and maximum of 1 to 5 dimensions and, last,
+     *  the auxiliary columns (see `rtree_options`). A range query on the coordinates, e.g.
+     *  `where(c(&Box::maxX) >= x1 and c(&Box::minX) <= x2 and c(&Box::maxY) >= y1 and c(&Box::minY) <= y2)`,
+     *  searches the tree instead of scanning an index range of one coordinate. Join it to an ordinary table by
+     *  its id, e.g. `inner_join<Box>(on(c(&Box::id) == &Place::id))`.
+     *  An existing R*Tree table is dropped and created again if its columns differ from the mapped ones.
+     *  Example: make_rtree_table("places_index", {}, make_column("id", &Box::id, primary_key()),
+     *                            make_column("minX", &Box::minX), make_column("maxX", &Box::maxX),
+     *                            make_column("minY", &Box::minY), make_column("maxY", &Box::maxY))
+     */
+    template<class... Cs, class T = typename std::tuple_element_t<0, std::tuple<Cs...>>::object_type>
+    internal::table_t<T, false, Cs...> make_rtree_table(std::string name, rtree_options options, Cs... args) {
+        static_assert(sizeof...(Cs) >= 3, "An R*Tree table has an id and at least one pair of coordinates");
+        auto res = make_table<T>(move(name), std::forward<Cs>(args)...);
+        res.rtree = std::make_shared<const rtree_options>(std::move(options));
+        return res;
+    }
+
+    /**
+     *  `make_rtree_table()` with the mapped object type being explicitly specified.
+     */
+    template<class T, class... Cs>
+    internal::table_t<T, false, Cs...> make_rtree_table(std::string name, rtree_options options, Cs... args) {
+        static_assert(sizeof...(Cs) >= 3, "An R*Tree table has an id and at least one pair of coordinates");
+        auto res = make_table<T>(move(name), std::forward<Cs>(args)...);
+        res.rtree = std::make_shared<const rtree_options>(std::move(options));
+        return res;
+    }
+
+    /**
+     *  The custom geometry F, created by `storage.create_rtree_query_function<F>()`, called with `args`. It is
+     *  the right side of `match()` on a column of an R*Tree table.
+     *  Example: storage.select(&Box::id, where(match(&Box::id, rtree_query<Circle>(x, y, radius))))
+     */
+    template<class F, class... Args>
+    internal::built_in_function_t<bool, internal::rtree_query_string<F>, Args...> rtree_query(Args... args) {
+        return {std::tuple<Args...>{std::forward<Args>(args)...}};
+    }
+}
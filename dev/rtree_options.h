@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+
+namespace sqlite_orm {
+
+    /**
+     *  The options of an R*Tree virtual table made by `make_rtree_table()`.
+     */
+    struct rtree_options {
+
+        /**
+         *  Store the coordinates as 32-bit integers (`rtree_i32`) instead of 32-bit floats, which R*Tree rounds
+         *  outwards so that a stored box contains the mapped one.
+         */
+        bool integer_coordinates = false;
+
+        /**
+         *  Names of the columns after the coordinates which hold other values of the rows, e.g. an object name,
+         *  and can't be used to search. Requires SQLite 3.24.0.
+         */
+        std::vector<std::string> auxiliary;
+    };
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <map>  //  std::map
+#include <memory>  //  std::shared_ptr
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <string>  //  std::string
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+#include "table_info.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Schema of a database as `sync_schema()` sees it: the tables with their CREATE statements and
+         *  columns and the CREATE statements of the indexes. It is read with two queries instead of one
+         *  `sqlite_master` lookup and one `PRAGMA table_xinfo` per mapped table.
+         */
+        struct schema_snapshot {
+            struct table {
+                std::string sql;
+                std::vector<table_xinfo> columns;
+            };
+
+            /**
+             *  False if the snapshot couldn't be read, e.g. because SQLite is older than 3.26.0. Then the
+             *  schema is inspected table by table.
+             */
+            bool loaded = false;
+            std::map<std::string, table> tables;
+            std::map<std::string, std::string> indexes;
+        };
+
+        /**
+         *  Text of the column `index` of the row of `stmt`, empty if it is NULL.
+         */
+        inline std::string schema_text(sqlite3_stmt* stmt, int index) {
+            auto text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, index));
+            return text ? text : "";
+        }
+
+        /**
+         *  The columns of a `PRAGMA table_xinfo` row beginning at the column `index` of the row of `stmt`.
+         *  `hidden` is 0 for a row of `PRAGMA table_info`, pass `withHidden` false.
+         */
+        inline table_xinfo extract_table_xinfo(sqlite3_stmt* stmt, int index, bool withHidden = true) {
+            return {sqlite3_column_int(stmt, index),
+                    schema_text(stmt, index + 1),
+                    schema_text(stmt, index + 2),
+                    sqlite3_column_int(stmt, index + 3) != 0,
+                    schema_text(stmt, index + 4),
+                    sqlite3_column_int(stmt, index + 5),
+                    withHidden ? sqlite3_column_int(stmt, index + 6) : 0};
+        }
+
+        /**
+         *  The `schema_snapshot` of the main database a storage keeps for `table_exists()`, `table_names()`,
+         *  `pragma.table_xinfo()`, `pragma.table_info()` and `sync_schema()`. It is valid while
+         *  `PRAGMA schema_version`, which every schema change of any connection increments, is `version`, and
+         *  the storage drops it after its own DDL statements. Thread safe.
+         */
+        struct schema_cache {
+            /**
+             *  The snapshot read at `version`, nullptr if there is none.
+             */
+            std::shared_ptr<const schema_snapshot> find(int version_) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->version == version_ ? this->snapshot : nullptr;
+            }
+
+            void store(int version_, std::shared_ptr<const schema_snapshot> snapshot_) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->version = version_;
+                this->snapshot = std::move(snapshot_);
+            }
+
+            void invalidate() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->snapshot.reset();
+            }
+
+          protected:
+            std::mutex mutex;
+            int version = 0;
+            std::shared_ptr<const schema_snapshot> snapshot;
+        };
+    }
+}
@@ -3,6 +3,7 @@
 #include <string>  //  std::string
 #include <utility>  //  std::declval
 #include <tuple>  //  std::tuple, std::get, std::tuple_size
+#include <vector>  //  std::vector
 #include "functional/cxx_optional.h"
 
 #include "functional/cxx_universal.h"
@@ -270,6 +271,32 @@ namespace sqlite_orm {
 #endif
         };
 
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        /**
+         *  `object_t` of the optional side of an outer join.
+         */
+        template<class T>
+        struct optional_object_t : object_t<T> {};
+#endif
+
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_object_column_v = polyfill::is_specialization_of_v<T, object_t>;
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_object_column_v<optional_object_t<T>> = true;
+#endif
+
+        /**
+         *  Whether a result column expression has objects among its columns, see `object<T>()`.
+         */
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool has_object_columns_v = false;
+
+        template<class... Args>
+        SQLITE_ORM_INLINE_VAR constexpr bool has_object_columns_v<columns_t<Args...>> =
+            polyfill::disjunction_v<polyfill::bool_constant<is_object_column_v<Args>>...>;
+
         template<class T>
         struct then_t {
             using expression_type = T;
@@ -289,6 +316,20 @@ namespace sqlite_orm {
             optional_container<else_expression_type> else_expression;
         };
 
+        /**
+         *  CASE with WHEN ... THEN pairs known only at runtime, made by `case_map()`. Every key and value is
+         *  bound.
+         */
+        template<class R, class T, class K, class V>
+        struct dynamic_case_t {
+            using return_type = R;
+            using case_expression_type = T;
+            using args_type = std::vector<std::pair<K, V>>;
+
+            case_expression_type case_expression;
+            args_type args;
+        };
+
         /**
          *  T is a case expression type
          *  E is else type (void is ELSE is omitted)
@@ -331,6 +372,12 @@ namespace sqlite_orm {
             static_assert(count_tuple<T, is_order_by>::value <= 1, "a single query cannot contain > 1 ORDER BY blocks");
             static_assert(count_tuple<T, is_limit>::value <= 1, "a single query cannot contain > 1 LIMIT blocks");
             static_assert(count_tuple<T, is_from>::value <= 1, "a single query cannot contain > 1 FROM blocks");
+            static_assert(count_tuple<T, is_reserve>::value <= 1, "a single query cannot contain > 1 reserve hints");
+            static_assert(count_tuple<T, is_cached>::value <= 1, "a single query cannot contain > 1 cached hints");
+            static_assert(count_tuple<T, is_prefetch>::value <= 1, "a single query cannot contain > 1 prefetch hints");
+            static_assert(count_tuple<T, is_exec_options>::value <= 1,
+                          "a single query cannot contain > 1 exec_options");
+            static_assert(count_tuple<T, is_only>::value <= 1, "a single query cannot contain > 1 only() lists");
         }
     }
 
@@ -355,6 +402,23 @@ namespace sqlite_orm {
         return {};
     }
 
+    /**
+     *  CASE `expression` WHEN key THEN value ... END with a WHEN for every element of `values`, a map like
+     *  `std::map`. With `update_all()` it sets a different value for every row in one statement instead of
+     *  one `update()` per row. Rows whose key isn't in `values` get NULL, so limit the update to the keys.
+     *  Without `values` the expression is NULL.
+     *
+     *  Example:
+     *  std::map<int, std::string> states{{1, "done"}, {2, "failed"}};
+     *  std::vector<int> ids{1, 2};
+     *  storage.update_all(set(c(&Job::state) = case_map(&Job::id, states)), where(in(&Job::id, ids)));
+     */
+    template<class T, class M>
+    internal::dynamic_case_t<typename M::mapped_type, T, typename M::key_type, typename M::mapped_type>
+    case_map(T expression, const M& values) {
+        return {std::move(expression), {values.begin(), values.end()}};
+    }
+
     template<class T>
     internal::distinct_t<T> distinct(T t) {
         return {std::move(t)};
@@ -477,10 +541,31 @@ namespace sqlite_orm {
      *   Example: auto rows = storage.select(object<User>(true));
      *   // decltype(rows) is std::vector<User>, where the User objects are constructed from columns in declared make_table order
      *
+     *   Objects of several tables joined together are selected as tuples, each object being read from the columns
+     *   of its table:
+     *   Example: auto rows = storage.select(columns(object<Order>(), object<Customer>()),
+     *                                       inner_join<Customer>(on(c(&Order::customerId) == &Customer::id)));
+     *   // decltype(rows) is std::vector<std::tuple<Order, Customer>>
+     *
      *   If you need to fetch results as tuples instead of objects please use `asterisk<T>()`.
      */
     template<class T>
     internal::object_t<T> object(bool definedOrder = false) {
         return {definedOrder};
     }
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+    /**
+     *   `object<T>()` column of the side of a `left_join` which may be missing. It is `std::nullopt` in the
+     *   rows without a match, i.e. when all its columns are NULL.
+     *
+     *   Example: auto rows = storage.select(columns(object<Customer>(), optional_object<Order>()),
+     *                                       left_join<Order>(on(c(&Order::customerId) == &Customer::id)));
+     *   // decltype(rows) is std::vector<std::tuple<Customer, std::optional<Order>>>
+     */
+    template<class T>
+    internal::optional_object_t<T> optional_object(bool definedOrder = false) {
+        return {{definedOrder}};
+    }
+#endif
 }
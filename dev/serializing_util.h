@@ -118,6 +118,7 @@ namespace sqlite_orm {
             field_values_excluding,
             mapped_columns_expressions,
             column_constraints,
+            table_identifier,
         };
 
         template<stream_as mode>
@@ -132,19 +133,22 @@ namespace sqlite_orm {
                 return {};
             }
         };
-        constexpr streaming<stream_as::conditions_tuple> streaming_conditions_tuple{};
-        constexpr streaming<stream_as::actions_tuple> streaming_actions_tuple{};
-        constexpr streaming<stream_as::expressions_tuple> streaming_expressions_tuple{};
-        constexpr streaming<stream_as::dynamic_expressions> streaming_dynamic_expressions{};
-        constexpr streaming<stream_as::serialized> streaming_serialized{};
-        constexpr streaming<stream_as::identifier> streaming_identifier{};
-        constexpr streaming<stream_as::identifiers> streaming_identifiers{};
-        constexpr streaming<stream_as::values_placeholders> streaming_values_placeholders{};
-        constexpr streaming<stream_as::table_columns> streaming_table_column_names{};
-        constexpr streaming<stream_as::non_generated_columns> streaming_non_generated_column_names{};
-        constexpr streaming<stream_as::field_values_excluding> streaming_field_values_excluding{};
-        constexpr streaming<stream_as::mapped_columns_expressions> streaming_mapped_columns_expressions{};
-        constexpr streaming<stream_as::column_constraints> streaming_column_constraints{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::conditions_tuple> streaming_conditions_tuple{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::actions_tuple> streaming_actions_tuple{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::expressions_tuple> streaming_expressions_tuple{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::dynamic_expressions> streaming_dynamic_expressions{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::serialized> streaming_serialized{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::identifier> streaming_identifier{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::identifiers> streaming_identifiers{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::values_placeholders> streaming_values_placeholders{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::table_columns> streaming_table_column_names{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::non_generated_columns>
+            streaming_non_generated_column_names{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::field_values_excluding> streaming_field_values_excluding{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::mapped_columns_expressions>
+            streaming_mapped_columns_expressions{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::column_constraints> streaming_column_constraints{};
+        SQLITE_ORM_INLINE_VAR constexpr streaming<stream_as::table_identifier> streaming_table_identifier{};
 
         // serialize and stream a tuple of condition expressions;
         // space + space-separated
@@ -155,7 +159,11 @@ namespace sqlite_orm {
             auto& context = get<2>(tpl);
 
             iterate_tuple(conditions, [&ss, &context](auto& c) {
-                ss << " " << serialize(c, context);
+                //  hints like `reserve_t`, `cached_t` and `exec_options` are not a part of the SQL
+                auto sql = serialize(c, context);
+                if(!sql.empty()) {
+                    ss << " " << sql;
+                }
             });
             return ss;
         }
@@ -244,6 +252,15 @@ namespace sqlite_orm {
             return ss;
         }
 
+        // stream the name of a table, qualified with its schema if it is in an attached database
+        template<class Table>
+        std::ostream& operator<<(std::ostream& ss,
+                                 std::tuple<const streaming<stream_as::table_identifier>&, const Table&> tpl) {
+            const auto& table = get<1>(tpl);
+            stream_identifier(ss, table.schema_name, table.name, std::string{});
+            return ss;
+        }
+
         // stream a container of identifiers described by a string or a tuple, which is one of:
         // 1. identifier
         // 1. tuple(identifier)
@@ -300,15 +317,57 @@ namespace sqlite_orm {
             const auto& table = get<1>(tpl);
             const bool& qualified = get<2>(tpl);
 
-            table.for_each_column([&ss, &tableName = qualified ? table.name : std::string{}, first = true](
-                                      const column_identifier& column) mutable {
+            const std::string& tableName = qualified ? table.name : std::string{};
+            table.for_each_column([&ss, &tableName, first = true](const column_identifier& column) mutable {
                 constexpr std::array<const char*, 2> sep = {", ", ""};
                 ss << sep[std::exchange(first, false)];
                 stream_identifier(ss, tableName, column.name, std::string{});
             });
+            //  read after the columns by `build_object_columns()`
+            if(table.rowid_member) {
+                ss << ", ";
+                stream_identifier(ss, tableName, "rowid", std::string{});
+            }
             return ss;
         }
 
+        /**
+         *  Streams the condition finding the row of an object by its rowid member if the table has one, by its
+         *  primary key columns otherwise, with `?` for the values.
+         */
+        template<class Table>
+        void stream_row_key(std::ostream& ss, const Table& table) {
+            if(table.rowid_member) {
+                stream_identifier(ss, "rowid");
+                ss << " = ?";
+                return;
+            }
+            table.for_each_column([&table, &ss, first = true](auto& column) mutable {
+                if(!column.template is<is_primary_key>() && !table.exists_in_composite_primary_key(column)) {
+                    return;
+                }
+                constexpr std::array<const char*, 2> sep = {" AND ", ""};
+                ss << sep[std::exchange(first, false)];
+                stream_identifier(ss, column.name);
+                ss << " = ?";
+            });
+        }
+
+        /**
+         *  Streams the condition on the version column of the table if it has one, see `version_column()`,
+         *  with `?` for the value. Follows `stream_row_key()`.
+         */
+        template<class Table>
+        void stream_version_condition(std::ostream& ss, const Table& table) {
+            table.for_each_column([&table, &ss](auto& column) {
+                if(table.is_version_column(column)) {
+                    ss << " AND ";
+                    stream_identifier(ss, column.name);
+                    ss << " = ?";
+                }
+            });
+        }
+
         // stream a table's non-generated column identifiers, unqualified;
         // comma-separated
         template<class Table>
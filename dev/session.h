@@ -0,0 +1,73 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <memory>  //  std::unique_ptr
+#include <utility>  //  std::move
+
+#include "connection_holder.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  The connection a `storage_base::session()` pins on the thread which started it. The sessions of a
+         *  thread form a list from the innermost one.
+         */
+        struct session_state {
+            const void* storage;
+            connection_ref connection;
+            session_state* previous;
+
+            static session_state*& thread_innermost() {
+                thread_local session_state* innermost = nullptr;
+                return innermost;
+            }
+
+            /**
+             *  The innermost session of `storage` on this thread or null.
+             */
+            static session_state* find(const void* storage) {
+                for(auto session = thread_innermost(); session; session = session->previous) {
+                    if(session->storage == storage) {
+                        return session;
+                    }
+                }
+                return nullptr;
+            }
+        };
+
+        /**
+         *  Returned by `storage_base::session()`. Keeps the connection open and, with a pool, borrowed until it is
+         *  destroyed, which has to happen on the thread that started it.
+         */
+        class session_t {
+          public:
+            session_t(const void* storage, connection_ref connection) :
+                state(new session_state{storage, std::move(connection), session_state::thread_innermost()}) {
+                session_state::thread_innermost() = this->state.get();
+            }
+
+            session_t(session_t&&) = default;
+
+            ~session_t() {
+                if(!this->state) {
+                    return;
+                }
+                for(auto session = &session_state::thread_innermost(); *session; session = &(*session)->previous) {
+                    if(*session == this->state.get()) {
+                        *session = this->state->previous;
+                        break;
+                    }
+                }
+            }
+
+            sqlite3* get() const {
+                return this->state->connection.get();
+            }
+
+          private:
+            std::unique_ptr<session_state> state;
+        };
+    }
+}
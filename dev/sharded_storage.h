@@ -0,0 +1,442 @@
+#pragma once
+
+#include <algorithm>  //  std::min, std::make_heap, std::pop_heap, std::push_heap
+#include <functional>  //  std::function, std::hash
+#include <future>  //  std::future, std::async, std::launch
+#include <iterator>  //  std::make_move_iterator
+#include <map>  //  std::map
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <system_error>  //  std::system_error
+#include <string>  //  std::string
+#include <type_traits>  //  std::enable_if_t, std::is_integral, std::is_member_pointer, std::decay_t
+#include <utility>  //  std::move, std::declval, std::pair
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
+#include "functional/cxx_functional_polyfill.h"
+#include "tuple_helper/tuple_iteration.h"
+#include "error_code.h"
+#include "conditions.h"
+#include "prepared_statement.h"
+#include "sync_schema_result.h"
+#include "storage_lookup.h"
+#include "table_type_of.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  How `sharded_storage` merges the rows of its shards: the first `order_by()` of a mapped member and
+         *  the row count of `limit()`.
+         */
+        template<class O>
+        struct shard_merge {
+            std::function<bool(const O&, const O&)> less;
+            size_t limit = 0;
+            bool limited = false;
+        };
+
+        template<class O, class T>
+        void collect_shard_merge(shard_merge<O>&, const T&) {}
+
+        template<class O, class M, std::enable_if_t<std::is_member_pointer<M>::value, bool> = true>
+        void collect_shard_merge(shard_merge<O>& merge, const order_by_t<M>& orderBy) {
+            static_assert(std::is_same<table_type_of_t<M>, O>::value,
+                          "sharded_storage merges only on an ORDER BY of a member of the selected type");
+            if(merge.less) {
+                return;
+            }
+            auto memberPointer = orderBy.expression;
+            if(orderBy.asc_desc < 0) {
+                merge.less = [memberPointer](const O& lhs, const O& rhs) {
+                    return polyfill::invoke(memberPointer, rhs) < polyfill::invoke(memberPointer, lhs);
+                };
+            } else {
+                merge.less = [memberPointer](const O& lhs, const O& rhs) {
+                    return polyfill::invoke(memberPointer, lhs) < polyfill::invoke(memberPointer, rhs);
+                };
+            }
+        }
+
+        template<class M, class T>
+        void collect_shard_limit(M&, const T&) {}
+
+        template<class M, class T, bool has_offset, bool offset_is_implicit, class Off>
+        void collect_shard_limit(M& merge, const limit_t<T, has_offset, offset_is_implicit, Off>& limit) {
+            static_assert(!has_offset, "sharded_storage can't apply OFFSET across shards");
+            static_assert(std::is_integral<T>::value, "sharded_storage needs a constant LIMIT");
+            merge.limit = size_t(limit.lim);
+            merge.limited = true;
+        }
+
+        /**
+         *  Moves the rows of `parts` into one container. If `less` is set, every part is sorted by it and the
+         *  parts are merged k-way, rows that compare equal keeping the order of their parts. If `limited`, only the
+         *  first `limit` rows are moved.
+         */
+        template<class R, class L>
+        R merge_shard_rows(std::vector<R> parts, const L& less, bool limited, size_t limit) {
+            size_t count = 0;
+            for(auto& part: parts) {
+                count += part.size();
+            }
+            if(limited && count > limit) {
+                count = limit;
+            }
+            R res;
+            res.reserve(count);
+            if(!less) {
+                for(auto it = parts.begin(); it != parts.end() && res.size() < count; ++it) {
+                    const size_t taken = std::min(it->size(), count - res.size());
+                    res.insert(res.end(),
+                               std::make_move_iterator(it->begin()),
+                               std::make_move_iterator(it->begin() + taken));
+                }
+                return res;
+            }
+            //  heap of the next row of every part, part index breaking ties
+            using head_type = std::pair<typename R::iterator, size_t>;
+            std::vector<head_type> heads;
+            heads.reserve(parts.size());
+            for(size_t index = 0; index < parts.size(); ++index) {
+                if(!parts[index].empty()) {
+                    heads.emplace_back(parts[index].begin(), index);
+                }
+            }
+            auto after = [&less](const head_type& lhs, const head_type& rhs) {
+                if(less(*rhs.first, *lhs.first)) {
+                    return true;
+                }
+                return !less(*lhs.first, *rhs.first) && rhs.second < lhs.second;
+            };
+            std::make_heap(heads.begin(), heads.end(), after);
+            while(res.size() < count) {
+                std::pop_heap(heads.begin(), heads.end(), after);
+                auto& head = heads.back();
+                res.push_back(std::move(*head.first));
+                if(++head.first != parts[head.second].end()) {
+                    std::push_heap(heads.begin(), heads.end(), after);
+                } else {
+                    heads.pop_back();
+                }
+            }
+            return res;
+        }
+
+        /**
+         *  A statement prepared on every shard by `sharded_storage::prepare()`, `statements[i]` on shard i.
+         *  Parameters are changed on each of them, e.g. `get<0>(statement.statements[i]) = 10`.
+         */
+        template<class S>
+        struct sharded_prepared_statement {
+            std::vector<S> statements;
+        };
+
+        /**
+         *  Storages with identical schema, each holding a part of the rows of the mapped types. Don't construct it
+         *  as is, call `make_sharded_storage()` instead.
+         *  Writes and lookups by primary key go to the one shard chosen by the shard function on the key value,
+         *  which is the first primary key column of an object or the first id passed to `get()`/`remove()`.
+         *  Every shard has its own file, connection and writer lock, so writes to different shards don't wait for
+         *  each other. Queries over all rows like `get_all()`, `select()` and `count()` run on every shard in
+         *  parallel and merge the results. Primary keys must be assigned by the application: rowids generated by
+         *  the shards are unique only within their shard.
+         */
+        template<class S, class K>
+        struct sharded_storage {
+            using storage_type = S;
+            using key_type = K;
+            using shard_function = std::function<size_t(const key_type&)>;
+
+            sharded_storage(std::vector<storage_type> shards_, shard_function shardFunction_) :
+                shards(std::move(shards_)), shardFunction(std::move(shardFunction_)) {
+                if(this->shards.empty()) {
+                    throw std::system_error{orm_error_code::no_shards};
+                }
+                if(!this->shardFunction) {
+                    this->shardFunction = [](const key_type& key) {
+                        return std::hash<key_type>{}(key);
+                    };
+                }
+            }
+
+            size_t shard_count() const {
+                return this->shards.size();
+            }
+
+            storage_type& shard(size_t index) {
+                return this->shards.at(index);
+            }
+
+            /**
+             *  @return index of the shard which holds the rows with the key value `key`.
+             */
+            size_t shard_of(const key_type& key) const {
+                return this->shardFunction(key) % this->shards.size();
+            }
+
+            /**
+             *  Calls `f(shard)` for every shard in parallel.
+             *  @return results of `f` in shard order.
+             */
+            template<class F>
+            auto for_each_shard(F f) -> std::vector<decltype(f(std::declval<storage_type&>()))> {
+                using result_type = decltype(f(std::declval<storage_type&>()));
+                std::vector<std::future<result_type>> futures;
+                futures.reserve(this->shards.size());
+                for(auto& shard: this->shards) {
+                    futures.push_back(std::async(std::launch::async, [&f, &shard] {
+                        return f(shard);
+                    }));
+                }
+                std::vector<result_type> res;
+                res.reserve(futures.size());
+                for(auto& future: futures) {
+                    res.push_back(future.get());
+                }
+                return res;
+            }
+
+            std::vector<std::map<std::string, sync_schema_result>> sync_schema(bool preserve = false) {
+                return this->for_each_shard([preserve](storage_type& shard) {
+                    return shard.sync_schema(preserve);
+                });
+            }
+
+            template<class O>
+            int insert(const O& object) {
+                return this->shard_for_object(object).insert(object);
+            }
+
+            template<class O>
+            void replace(const O& object) {
+                this->shard_for_object(object).replace(object);
+            }
+
+            template<class O>
+            void update(const O& object) {
+                this->shard_for_object(object).update(object);
+            }
+
+            /**
+             *  Replaces `[from, to)`, each shard replacing its part in one transaction in parallel.
+             */
+            template<class It>
+            void replace_range(It from, It to) {
+                using object_type = std::decay_t<decltype(*from)>;
+                std::vector<std::vector<object_type>> parts(this->shards.size());
+                for(; from != to; ++from) {
+                    parts[this->shard_index_of_object(*from)].push_back(*from);
+                }
+                this->for_each_shard([this, &parts](storage_type& shard) {
+                    auto& part = parts[size_t(&shard - this->shards.data())];
+                    if(!part.empty()) {
+                        shard.replace_range(part.begin(), part.end());
+                    }
+                    return 0;
+                });
+            }
+
+            template<class O, class Id, class... Ids>
+            O get(const Id& id, Ids... ids) {
+                return this->shard_for_key(id).template get<O>(id, std::move(ids)...);
+            }
+
+            template<class O, class Id, class... Ids>
+            std::unique_ptr<O> get_pointer(const Id& id, Ids... ids) {
+                return this->shard_for_key(id).template get_pointer<O>(id, std::move(ids)...);
+            }
+
+            template<class O, class Id, class... Ids>
+            void remove(const Id& id, Ids... ids) {
+                this->shard_for_key(id).template remove<O>(id, std::move(ids)...);
+            }
+
+            template<class O, class... Args>
+            void remove_all(Args... args) {
+                this->for_each_shard([&args...](storage_type& shard) {
+                    shard.template remove_all<O>(args...);
+                    return 0;
+                });
+            }
+
+            /**
+             *  `get_all<O>(args...)` of every shard. With `order_by()` of a member of `O` the rows of the shards
+             *  are merged in that order, with `limit()` the merged rows are truncated to the limit.
+             */
+            template<class O, class... Args>
+            std::vector<O> get_all(Args... args) {
+                shard_merge<O> merge;
+                iterate_tuple(std::tie(args...), [&merge](auto& arg) {
+                    collect_shard_merge(merge, arg);
+                    collect_shard_limit(merge, arg);
+                });
+                auto parts = this->for_each_shard([&args...](storage_type& shard) {
+                    return shard.template get_all<O>(args...);
+                });
+                return merge_shard_rows(std::move(parts), merge.less, merge.limited, merge.limit);
+            }
+
+            /**
+             *  `select(expression, args...)` of every shard, the rows of the shards one after another.
+             *  With `limit()` the rows are truncated to the limit.
+             */
+            template<class T, class... Args>
+            auto select(T expression, Args... args) {
+                return this->select_ordered(nullptr, std::move(expression), std::move(args)...);
+            }
+
+            /**
+             *  Like `select()`, the rows of every shard being sorted by `less` as the ORDER BY of `args` sorts
+             *  them, so that the merged rows are sorted too.
+             *  Example: storage.select_ordered([](auto& lhs, auto& rhs) {
+             *               return std::get<1>(lhs) < std::get<1>(rhs);
+             *           }, columns(&User::id, &User::name), order_by(&User::name), limit(10));
+             */
+            template<class L, class T, class... Args>
+            auto select_ordered(const L& less, T expression, Args... args) {
+                shard_merge<int> merge;
+                iterate_tuple(std::tie(args...), [&merge](auto& arg) {
+                    collect_shard_limit(merge, arg);
+                });
+                auto parts = this->for_each_shard([&expression, &args...](storage_type& shard) {
+                    return shard.select(expression, args...);
+                });
+                using row_type = typename decltype(parts)::value_type::value_type;
+                std::function<bool(const row_type&, const row_type&)> rowLess{less};
+                return merge_shard_rows(std::move(parts), rowLess, merge.limited, merge.limit);
+            }
+
+            /**
+             *  Prepares `expression`, a `get_all` or `select`, on every shard for `execute()`.
+             */
+            template<class T>
+            auto prepare(T expression) {
+                using statement_type = decltype(std::declval<storage_type&>().prepare(std::move(expression)));
+                sharded_prepared_statement<statement_type> res;
+                res.statements.reserve(this->shards.size());
+                for(auto& shard: this->shards) {
+                    res.statements.push_back(shard.prepare(expression));
+                }
+                return res;
+            }
+
+            /**
+             *  Executes a prepared `get_all<O>(args...)` on every shard in parallel, each on the connection it was
+             *  prepared on, and merges the rows like `get_all()`. A `limit()` is a part of the statement of every
+             *  shard, so the top N rows cost N rows per shard and a merge of them instead of sorting all rows.
+             *  Example: auto statement = sharded.prepare(get_all<User>(order_by(&User::score).desc(), limit(10)));
+             *           auto top = sharded.execute(statement);
+             */
+            template<class O, class R, class... Args>
+            R execute(sharded_prepared_statement<prepared_statement_t<get_all_t<O, R, Args...>>>& statement) {
+                shard_merge<O> merge;
+                iterate_tuple(statement.statements.front().expression.conditions, [&merge](auto& arg) {
+                    collect_shard_merge(merge, arg);
+                    collect_shard_limit(merge, arg);
+                });
+                auto parts = this->execute_on_shards(statement);
+                return merge_shard_rows(std::move(parts), merge.less, merge.limited, merge.limit);
+            }
+
+            /**
+             *  Executes a prepared `select()` on every shard in parallel, the rows of the shards one after another.
+             */
+            template<class T, class... Args>
+            auto execute(sharded_prepared_statement<prepared_statement_t<select_t<T, Args...>>>& statement) {
+                return this->execute_ordered(nullptr, statement);
+            }
+
+            /**
+             *  Like `execute()` of a prepared `select()`, the rows of every shard being sorted by `less` as its
+             *  ORDER BY sorts them, so that the rows are merged in that order.
+             */
+            template<class L, class T, class... Args>
+            auto execute_ordered(const L& less,
+                                 sharded_prepared_statement<prepared_statement_t<select_t<T, Args...>>>& statement) {
+                shard_merge<int> merge;
+                iterate_tuple(statement.statements.front().expression.conditions, [&merge](auto& arg) {
+                    collect_shard_limit(merge, arg);
+                });
+                auto parts = this->execute_on_shards(statement);
+                using row_type = typename decltype(parts)::value_type::value_type;
+                std::function<bool(const row_type&, const row_type&)> rowLess{less};
+                return merge_shard_rows(std::move(parts), rowLess, merge.limited, merge.limit);
+            }
+
+            /**
+             *  @return sum of `count<O>(args...)` of every shard.
+             */
+            template<class O, class... Args>
+            int64 count(Args... args) {
+                auto counts = this->for_each_shard([&args...](storage_type& shard) {
+                    return shard.template count<O>(args...);
+                });
+                int64 res = 0;
+                for(auto count: counts) {
+                    res += count;
+                }
+                return res;
+            }
+
+          private:
+            std::vector<storage_type> shards;
+            shard_function shardFunction;
+
+            template<class P>
+            auto execute_on_shards(sharded_prepared_statement<P>& statement) {
+                return this->for_each_shard([this, &statement](storage_type& shard) {
+                    return shard.execute(statement.statements.at(size_t(&shard - this->shards.data())));
+                });
+            }
+
+            storage_type& shard_for_key(const key_type& key) {
+                return this->shards[this->shard_of(key)];
+            }
+
+            template<class O>
+            size_t shard_index_of_object(const O& object) {
+                auto& table = pick_table<O>(obtain_db_objects(this->shards.front()));
+                std::unique_ptr<key_type> key;
+                table.for_each_primary_key_column([&object, &key](auto& memberPointer) {
+                    if(!key) {
+                        key = std::make_unique<key_type>(polyfill::invoke(memberPointer, object));
+                    }
+                });
+                if(!key) {
+                    throw std::system_error{orm_error_code::table_has_no_primary_key_column};
+                }
+                return this->shard_of(*key);
+            }
+
+            template<class O>
+            storage_type& shard_for_object(const O& object) {
+                return this->shards[this->shard_index_of_object(object)];
+            }
+        };
+    }
+
+    /**
+     *  Makes `count` shards with `makeShard(index)`, which returns storages with identical schema, usually
+     *  in files of their own. The rows of a mapped type go to the shard `shardFunction(key) % count`, `key` being
+     *  the value of the first primary key column. `shardFunction` defaults to `std::hash<K>`.
+     *  Example: auto sharded = make_sharded_storage<int>(4, [](size_t index) {
+     *               return make_storage("users" + std::to_string(index) + ".sqlite", make_table(...));
+     *           });
+     *           sharded.sync_schema();
+     *           sharded.replace(User{5, "Ann"});
+     *           auto users = sharded.get_all<User>(order_by(&User::name), limit(10));
+     */
+    template<class K, class F>
+    auto make_sharded_storage(size_t count, F makeShard, std::function<size_t(const K&)> shardFunction = {}) {
+        using storage_type = decltype(makeShard(size_t(0)));
+        std::vector<storage_type> shards;
+        shards.reserve(count);
+        for(size_t index = 0; index < count; ++index) {
+            shards.push_back(makeShard(index));
+        }
+        return internal::sharded_storage<storage_type, K>{std::move(shards), std::move(shardFunction)};
+    }
+}
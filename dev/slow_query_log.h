@@ -0,0 +1,239 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <chrono>  //  std::chrono::nanoseconds, std::chrono::milliseconds
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+#include <map>  //  std::map
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <atomic>  //  std::atomic
+#include <random>  //  std::minstd_rand, std::uniform_real_distribution
+#include <algorithm>  //  std::upper_bound, std::sort
+#include <system_error>  //  std::system_error
+#include <utility>  //  std::move
+
+#include "statement_profile.h"
+#include "query_plan.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Settings of `storage.enable_slow_query_log()`.
+     */
+    struct slow_query_log_options {
+
+        /**
+         *  Executions that take at least this long are slow.
+         */
+        std::chrono::nanoseconds threshold = std::chrono::milliseconds{100};
+
+        /**
+         *  Fraction of slow executions that get recorded, from 0 to 1.
+         */
+        double sample_rate = 1;
+
+        /**
+         *  Number of the slowest executions kept for every statement shape.
+         */
+        size_t top_k = 5;
+
+        /**
+         *  Number of statement shapes kept. Slow executions of new shapes are dropped once it is reached.
+         */
+        size_t max_shapes = 256;
+    };
+
+    /**
+     *  One recorded slow execution.
+     */
+    struct slow_query {
+
+        /**
+         *  SQL text with bound parameters expanded (`sqlite3_expanded_sql`).
+         */
+        std::string expanded_sql;
+
+        std::chrono::nanoseconds duration{0};
+
+        sqlite3_int64 rows = 0;
+    };
+
+    /**
+     *  Slow executions of one statement shape returned by `storage.slow_queries()`.
+     */
+    struct slow_query_shape {
+
+        /**
+         *  SQL text with placeholders instead of bound values. Statements made by sqlite_orm are serialized
+         *  with placeholders, so all executions of the same query share one shape.
+         */
+        std::string sql;
+
+        /**
+         *  Number of slow executions recorded for this shape, including the ones not kept in `slowest`.
+         */
+        size_t count = 0;
+
+        /**
+         *  The slowest executions, slowest first. At most `slow_query_log_options::top_k` of them.
+         */
+        std::vector<slow_query> slowest;
+
+        /**
+         *  `EXPLAIN QUERY PLAN` of `sql`. Empty if the statement cannot be explained.
+         */
+        query_plan plan;
+    };
+
+    namespace internal {
+
+        /**
+         *  Storage of slow query log entries. Recording happens from trace callbacks of all connections,
+         *  so every member function is thread safe.
+         */
+        struct slow_query_recorder {
+
+            bool enabled() const {
+                return this->isEnabled;
+            }
+
+            void enable(slow_query_log_options options_) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->options = std::move(options_);
+                this->isEnabled = true;
+            }
+
+            void disable() {
+                this->isEnabled = false;
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                this->shapes.clear();
+            }
+
+            /**
+             *  Returns true if an execution that took `duration` is slow and passed sampling.
+             *  Is called before `record()` so that SQL texts are made only for recorded executions.
+             */
+            bool should_record(std::chrono::nanoseconds duration) {
+                if(!this->isEnabled || explaining()) {
+                    return false;
+                }
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if(duration < this->options.threshold) {
+                    return false;
+                }
+                if(this->options.sample_rate >= 1) {
+                    return true;
+                }
+                return std::uniform_real_distribution<double>{0, 1}(this->random) < this->options.sample_rate;
+            }
+
+            void record(const statement_profile& profile) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                auto it = this->shapes.find(profile.normalized_sql);
+                if(it == this->shapes.end()) {
+                    if(this->shapes.size() >= this->options.max_shapes) {
+                        return;
+                    }
+                    it = this->shapes.emplace(profile.normalized_sql, entry{}).first;
+                    it->second.shape.sql = profile.normalized_sql;
+                }
+                auto& shape = it->second.shape;
+                ++shape.count;
+                auto position = std::upper_bound(shape.slowest.begin(),
+                                                 shape.slowest.end(),
+                                                 profile.duration,
+                                                 [](std::chrono::nanoseconds duration, const slow_query& query) {
+                                                     return duration > query.duration;
+                                                 });
+                if(static_cast<size_t>(position - shape.slowest.begin()) >= this->options.top_k) {
+                    return;
+                }
+                slow_query query;
+                query.expanded_sql = profile.expanded_sql;
+                query.duration = profile.duration;
+                query.rows = profile.rows;
+                shape.slowest.insert(position, std::move(query));
+                if(shape.slowest.size() > this->options.top_k) {
+                    shape.slowest.pop_back();
+                }
+            }
+
+            /**
+             *  Returns recorded shapes, the one with the slowest execution first. Query plans of shapes
+             *  that got no plan yet are computed here on `db` rather than in the trace callback.
+             */
+            std::vector<slow_query_shape> get(sqlite3* db) {
+                std::vector<std::string> unexplained;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    for(auto& pair: this->shapes) {
+                        if(!pair.second.explained) {
+                            unexplained.push_back(pair.first);
+                        }
+                    }
+                }
+                std::vector<std::pair<std::string, query_plan>> plans;
+                for(auto& sql: unexplained) {
+                    query_plan plan;
+#if SQLITE_VERSION_NUMBER >= 3024000
+                    explaining() = true;
+                    try {
+                        plan = explain_query_plan(db, sql);
+                    } catch(const std::system_error&) {
+                        //  statements like PRAGMA or ones referring to dropped tables have no plan
+                    }
+                    explaining() = false;
+#else
+                    (void)db;
+#endif
+                    plans.emplace_back(sql, std::move(plan));
+                }
+                std::vector<slow_query_shape> result;
+                std::lock_guard<std::mutex> lock{this->mutex};
+                for(auto& plan: plans) {
+                    auto it = this->shapes.find(plan.first);
+                    if(it != this->shapes.end()) {
+                        it->second.shape.plan = std::move(plan.second);
+                        it->second.explained = true;
+                    }
+                }
+                result.reserve(this->shapes.size());
+                for(auto& pair: this->shapes) {
+                    result.push_back(pair.second.shape);
+                }
+                auto slowestDuration = [](const slow_query_shape& shape) {
+                    return shape.slowest.empty() ? std::chrono::nanoseconds{0} : shape.slowest.front().duration;
+                };
+                std::sort(result.begin(),
+                          result.end(),
+                          [&slowestDuration](const slow_query_shape& lhs, const slow_query_shape& rhs) {
+                              return slowestDuration(lhs) > slowestDuration(rhs);
+                          });
+                return result;
+            }
+
+          protected:
+            /**
+             *  Set while the recorder runs its own `EXPLAIN QUERY PLAN` so that it is not recorded.
+             */
+            static bool& explaining() {
+                thread_local bool value = false;
+                return value;
+            }
+
+            struct entry {
+                slow_query_shape shape;
+                bool explained = false;
+            };
+
+            std::atomic<bool> isEnabled{false};
+            std::mutex mutex;
+            slow_query_log_options options;
+            std::minstd_rand random;
+            std::map<std::string, entry> shapes;
+        };
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstdlib>  //  std::atoll
+#include <cstring>  //  std::strcmp
+#include <map>  //  std::map
+#include <string>  //  std::string
+#include <utility>  //  std::move, std::pair
+#include <vector>  //  std::vector
+
+#include "util.h"
+
+namespace sqlite_orm {
+#ifdef SQLITE_ENABLE_DBSTAT_VTAB
+
+    /**
+     *  Space a table or an index occupies in the database file according to the `dbstat` virtual table,
+     *  one element of the result of `storage.space_report()`. https://sqlite.org/dbstat.html
+     */
+    struct btree_space {
+        std::string name;
+
+        /**
+         *  The table of an index, the name itself for a table.
+         */
+        std::string table_name;
+        bool is_index = false;
+        sqlite3_int64 pages = 0;
+        sqlite3_int64 overflow_pages = 0;
+
+        /**
+         *  Bytes of all pages, of the stored records and of free space within the pages.
+         */
+        sqlite3_int64 total_bytes = 0;
+        sqlite3_int64 payload_bytes = 0;
+        sqlite3_int64 unused_bytes = 0;
+
+        /**
+         *  Share of the leaf pages which don't directly follow the previous leaf page in key order, i.e. the
+         *  share of the seeks a full scan does. VACUUM brings it down to 0.
+         */
+        double fragmentation = 0;
+
+        /**
+         *  Share of the bytes of the pages which is free space.
+         */
+        double unused_ratio() const {
+            return this->total_bytes ? double(this->unused_bytes) / double(this->total_bytes) : 0;
+        }
+    };
+
+    namespace internal {
+
+        /**
+         *  Reads the btrees of schema `schemaName` of `db` from `dbstat` in one pass over all its pages, ordered
+         *  by name. It needs SQLite to be compiled with SQLITE_ENABLE_DBSTAT_VTAB.
+         */
+        inline std::vector<btree_space> read_space_report(sqlite3* db, const std::string& schemaName) {
+            struct page_walk {
+                std::map<std::string, btree_space> btrees;
+                std::map<std::string, sqlite3_int64> leaves;
+                std::map<std::string, sqlite3_int64> gaps;
+                std::map<std::string, sqlite3_int64> previousLeaf;
+            } walk;
+            //  dbstat visits the pages of a btree in key order, leaf pages included
+            perform_exec(
+                db,
+                "SELECT name, pagetype, pageno, payload, unused, pgsize FROM dbstat(" +
+                    quote_string_literal(schemaName) + ")",
+                [](void* data, int argc, char** argv, char**) -> int {
+                    auto& walk_ = *(page_walk*)data;
+                    if(argc == 6 && argv[0] && argv[1]) {
+                        auto& btree = walk_.btrees[argv[0]];
+                        auto pageNumber = std::atoll(argv[2]);
+                        ++btree.pages;
+                        btree.payload_bytes += argv[3] ? std::atoll(argv[3]) : 0;
+                        btree.unused_bytes += argv[4] ? std::atoll(argv[4]) : 0;
+                        btree.total_bytes += argv[5] ? std::atoll(argv[5]) : 0;
+                        if(std::strcmp(argv[1], "overflow") == 0) {
+                            ++btree.overflow_pages;
+                        } else if(std::strcmp(argv[1], "leaf") == 0) {
+                            ++walk_.leaves[argv[0]];
+                            auto& previous = walk_.previousLeaf[argv[0]];
+                            if(previous && pageNumber != previous + 1) {
+                                ++walk_.gaps[argv[0]];
+                            }
+                            previous = pageNumber;
+                        }
+                    }
+                    return 0;
+                },
+                &walk);
+
+            std::map<std::string, std::pair<std::string, std::string>> schema;
+            perform_exec(
+                db,
+                "SELECT name, type, tbl_name FROM " + quote_identifier(schemaName) + ".sqlite_master",
+                [](void* data, int argc, char** argv, char**) -> int {
+                    auto& schema_ = *(std::map<std::string, std::pair<std::string, std::string>>*)data;
+                    if(argc == 3 && argv[0]) {
+                        schema_[argv[0]] = {argv[1] ? argv[1] : "", argv[2] ? argv[2] : ""};
+                    }
+                    return 0;
+                },
+                &schema);
+
+            std::vector<btree_space> result;
+            result.reserve(walk.btrees.size());
+            for(auto& p: walk.btrees) {
+                auto& btree = p.second;
+                btree.name = p.first;
+                auto it = schema.find(p.first);
+                if(it != schema.end()) {
+                    btree.is_index = it->second.first == "index";
+                    btree.table_name = it->second.second;
+                } else {
+                    //  sqlite_master itself
+                    btree.table_name = p.first;
+                }
+                auto leaves = walk.leaves[p.first];
+                if(leaves > 1) {
+                    btree.fragmentation = double(walk.gaps[p.first]) / double(leaves - 1);
+                }
+                result.push_back(std::move(btree));
+            }
+            return result;
+        }
+    }
+#endif  //  SQLITE_ENABLE_DBSTAT_VTAB
+}
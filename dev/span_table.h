@@ -0,0 +1,100 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <functional>  //  std::function
+#include <memory>  //  std::shared_ptr, std::make_shared
+#include <string>  //  std::string
+#include <type_traits>  //  std::decay_t
+#include <utility>  //  std::move, std::forward
+#include <vector>  //  std::vector
+
+#include "functional/cxx_functional_polyfill.h"
+#include "statement_binder.h"
+#include "table.h"
+#include "virtual_table.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Scans the elements of a vector of the caller, reading the mapped members of the current element
+         *  when SQLite asks for them.
+         */
+        template<class T>
+        struct span_module {
+            using column_reader = std::function<void(sqlite3_context*, const T&)>;
+
+            const std::vector<T>* rows = nullptr;
+            std::shared_ptr<const std::vector<column_reader>> columns;
+
+            struct cursor_type {
+                const std::vector<T>* rows;
+                const std::vector<column_reader>* columns;
+                size_t index = 0;
+
+                void filter(int, const char*, int, sqlite3_value**) {
+                    this->index = 0;
+                }
+
+                bool eof() const {
+                    return this->index >= this->rows->size();
+                }
+
+                void next() {
+                    ++this->index;
+                }
+
+                void column(sqlite3_context* context, int columnIndex) const {
+                    (*this->columns)[columnIndex](context, (*this->rows)[this->index]);
+                }
+
+                sqlite3_int64 rowid() const {
+                    return sqlite3_int64(this->index);
+                }
+            };
+
+            cursor_type open() const {
+                return {this->rows, this->columns.get()};
+            }
+
+            int best_index(sqlite3_index_info& info) const {
+                info.estimatedCost = double(this->rows->size());
+                info.estimatedRows = sqlite3_int64(this->rows->size());
+                return SQLITE_OK;
+            }
+        };
+
+        template<class T, class... Cs>
+        std::shared_ptr<const std::vector<typename span_module<T>::column_reader>>
+        make_span_column_readers(const Cs&... columns) {
+            using column_reader = typename span_module<T>::column_reader;
+            auto res = std::make_shared<std::vector<column_reader>>();
+            auto add = [&res](auto& column) {
+                using field_type = typename std::decay_t<decltype(column)>::field_type;
+                res->push_back([getter = column.member_pointer](sqlite3_context* context, const T& object) {
+                    statement_binder<field_type>().result(context, polyfill::invoke(getter, object));
+                });
+            };
+            //  mimics a fold expression
+            int dummy[] = {0, (add(columns), 0)...};
+            (void)dummy;
+            return res;
+        }
+    }
+
+    /**
+     *  Maps an eponymous virtual table over the elements of `rows`, e.g. to join a query against ids held by the
+     *  process instead of inserting them into a temporary table first. Members are read from the elements when a
+     *  statement reads them, nothing is copied in advance. The vector is referred to, it has to outlive the
+     *  storage and mustn't be resized while a statement reads it. T mustn't be mapped by another table.
+     *  Example: make_span_table("wanted", wantedIds, make_column("id", &WantedId::id))
+     */
+    template<class... Cs, class T = typename std::tuple_element_t<0, std::tuple<Cs...>>::object_type>
+    internal::table_t<T, false, Cs...> make_span_table(std::string name, const std::vector<T>& rows, Cs... args) {
+        internal::span_module<T> module;
+        module.rows = &rows;
+        module.columns = internal::make_span_column_readers<T>(args...);
+        return make_virtual_table(move(name), std::move(module), std::forward<Cs>(args)...);
+    }
+}
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <functional>  //  std::reference_wrapper
+#include <string>  //  std::string, std::to_string
+#include <tuple>  //  std::tuple
+#include <type_traits>  //  std::is_member_pointer, std::is_void, std::enable_if_t
+#include <vector>  //  std::vector
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
+#include "is_base_of_template.h"
+#include "tuple_helper/tuple_iteration.h"
+#include "statement_binder.h"
+#include "bound_array.h"
+#include "conditions.h"
+#include "operators.h"
+#include "select_constraints.h"
+#include "prepared_statement.h"
+#include "ast/where.h"
+#include "ast/row_value.h"
+#include "dynamic_where.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  How the SQL of expression `T` with its bindable values replaced by `?` varies between expressions of
+         *  the same type. The SQL of a `memoizable` expression is determined by its type and the runtime parts
+         *  `append_key()` adds to a key, e.g. the length of a dynamic IN list or the direction of an ORDER BY,
+         *  so it needs to be serialized only once per key. Any other expression is serialized on every prepare.
+         */
+        template<class T, class SFINAE = void>
+        struct sql_shape {
+            static constexpr bool memoizable = false;
+
+            static void append_key(const T& /*expression*/, std::string& /*key*/) {}
+        };
+
+        template<class T>
+        struct is_sql_memoizable : polyfill::bool_constant<sql_shape<T>::memoizable> {};
+
+        template<class... Ts>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_sql_memoizable_v = polyfill::conjunction_v<is_sql_memoizable<Ts>...>;
+
+        template<class T>
+        void append_sql_shape_key(const T& expression, std::string& key) {
+            sql_shape<T>::append_key(expression, key);
+        }
+
+        template<class... Args>
+        void append_sql_shape_key(const std::tuple<Args...>& expressions, std::string& key) {
+            iterate_tuple(expressions, [&key](auto& expression) {
+                append_sql_shape_key(expression, key);
+            });
+        }
+
+        /**
+         *  Bound values.
+         */
+        template<class T>
+        struct sql_shape<T, std::enable_if_t<is_bindable<T>::value>> {
+            static constexpr bool memoizable = true;
+
+            static void append_key(const T& /*expression*/, std::string& /*key*/) {}
+        };
+
+        /**
+         *  Columns. Members of the same type are told apart by the bytes of their member pointer.
+         */
+        template<class T>
+        struct sql_shape<T, std::enable_if_t<std::is_member_pointer<T>::value>> {
+            static constexpr bool memoizable = true;
+
+            static void append_key(const T& expression, std::string& key) {
+                key.append(reinterpret_cast<const char*>(&expression), sizeof(T));
+            }
+        };
+
+        template<class T, class F>
+        struct sql_shape<column_pointer<T, F>, void> {
+            static constexpr bool memoizable = true;
+
+            static void append_key(const column_pointer<T, F>& expression, std::string& key) {
+                append_sql_shape_key(expression.field, key);
+            }
+        };
+
+        template<class T>
+        struct sql_shape<std::reference_wrapper<T>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<T>;
+
+            static void append_key(const std::reference_wrapper<T>& expression, std::string& key) {
+                append_sql_shape_key(expression.get(), key);
+            }
+        };
+
+        template<class C>
+        struct sql_shape<where_t<C>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<C>;
+
+            static void append_key(const where_t<C>& expression, std::string& key) {
+                append_sql_shape_key(expression.expression, key);
+            }
+        };
+
+        /**
+         *  The SQL of the conditions is the key.
+         */
+        template<class C>
+        struct sql_shape<dynamic_where_t<C>, void> {
+            static constexpr bool memoizable = true;
+
+            static void append_key(const dynamic_where_t<C>& expression, std::string& key) {
+                for(auto& entry: expression) {
+                    key += std::to_string(entry.sql.size());
+                    key += ':';
+                    key += entry.sql;
+                }
+                key += ',';
+            }
+        };
+
+        template<class T>
+        struct sql_shape<T, std::enable_if_t<is_base_of_template_v<T, binary_condition>>> {
+            static constexpr bool memoizable = is_sql_memoizable_v<typename T::left_type, typename T::right_type>;
+
+            static void append_key(const T& expression, std::string& key) {
+                append_sql_shape_key(expression.l, key);
+                append_sql_shape_key(expression.r, key);
+            }
+        };
+
+        template<class L, class R, class... Ds>
+        struct sql_shape<binary_operator<L, R, Ds...>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<L, R>;
+
+            static void append_key(const binary_operator<L, R, Ds...>& expression, std::string& key) {
+                append_sql_shape_key(expression.lhs, key);
+                append_sql_shape_key(expression.rhs, key);
+            }
+        };
+
+        template<class C>
+        struct sql_shape<negated_condition_t<C>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<C>;
+
+            static void append_key(const negated_condition_t<C>& expression, std::string& key) {
+                append_sql_shape_key(expression.c, key);
+            }
+        };
+
+        template<class T>
+        struct sql_shape<T,
+                         std::enable_if_t<polyfill::disjunction_v<polyfill::is_specialization_of<T, is_null_t>,
+                                                                  polyfill::is_specialization_of<T, is_not_null_t>>>> {
+            static constexpr bool memoizable = is_sql_memoizable_v<decltype(T::t)>;
+
+            static void append_key(const T& expression, std::string& key) {
+                append_sql_shape_key(expression.t, key);
+            }
+        };
+
+        template<class A, class T>
+        struct sql_shape<between_t<A, T>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<A, T>;
+
+            static void append_key(const between_t<A, T>& expression, std::string& key) {
+                append_sql_shape_key(expression.expr, key);
+                append_sql_shape_key(expression.b1, key);
+                append_sql_shape_key(expression.b2, key);
+            }
+        };
+
+        template<class A, class T, class E>
+        struct sql_shape<like_t<A, T, E>, void> {
+            //  the presence of ESCAPE is part of the type
+            static constexpr bool memoizable =
+                is_sql_memoizable_v<A, T> && polyfill::disjunction_v<std::is_void<E>, is_sql_memoizable<E>>;
+
+            static void append_key(const like_t<A, T, E>& expression, std::string& key) {
+                append_sql_shape_key(expression.arg, key);
+                append_sql_shape_key(expression.pattern, key);
+                expression.arg3.apply([&key](auto& value) {
+                    append_sql_shape_key(value, key);
+                });
+            }
+        };
+
+        template<class L, class... Args>
+        struct sql_shape<in_t<L, Args...>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<L, Args...>;
+
+            static void append_key(const in_t<L, Args...>& expression, std::string& key) {
+                key += expression.negative ? 'N' : 'I';
+                append_sql_shape_key(expression.left, key);
+                append_sql_shape_key(expression.argument, key);
+            }
+        };
+
+        template<class L, class E>
+        struct sql_shape<dynamic_in_t<L, std::vector<E>>, void> {
+            //  the values are bindables or tuples of bindables for row values
+            static constexpr bool memoizable = is_sql_memoizable_v<L, E>;
+
+            static void append_key(const dynamic_in_t<L, std::vector<E>>& expression, std::string& key) {
+                key += expression.negative ? 'N' : 'I';
+                key += std::to_string(expression.argument.size());
+                key += ',';
+                append_sql_shape_key(expression.left, key);
+            }
+        };
+
+        template<class L, class E>
+        struct sql_shape<dynamic_in_t<L, bound_array_t<E>>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<L>;
+
+            static void append_key(const dynamic_in_t<L, bound_array_t<E>>& expression, std::string& key) {
+                key += expression.negative ? 'N' : 'I';
+                append_sql_shape_key(expression.left, key);
+            }
+        };
+
+        template<class O>
+        struct sql_shape<order_by_t<O>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<O>;
+
+            static void append_key(const order_by_t<O>& expression, std::string& key) {
+                key += std::to_string(expression.asc_desc);
+                key += ',';
+                key += expression._collate_argument;
+                key += ',';
+                append_sql_shape_key(expression.expression, key);
+            }
+        };
+
+        template<class C>
+        struct sql_shape<dynamic_order_by_t<C>, void> {
+            static constexpr bool memoizable = true;
+
+            static void append_key(const dynamic_order_by_t<C>& expression, std::string& key) {
+                key += std::to_string(expression.terms().size());
+                key += ':';
+                key += expression.terms();
+            }
+        };
+
+        template<class T, bool HO, bool OI, class O>
+        struct sql_shape<limit_t<T, HO, OI, O>, void> {
+            static constexpr bool memoizable =
+                is_sql_memoizable_v<T> && polyfill::disjunction_v<std::is_void<O>, is_sql_memoizable<O>>;
+
+            static void append_key(const limit_t<T, HO, OI, O>& expression, std::string& key) {
+                append_sql_shape_key(expression.lim, key);
+                expression.off.apply([&key](auto& value) {
+                    append_sql_shape_key(value, key);
+                });
+            }
+        };
+
+        /**
+         *  Statements with conditions.
+         */
+        template<class S>
+        struct sql_shape<
+            S,
+            std::enable_if_t<polyfill::disjunction_v<polyfill::is_specialization_of<S, get_all_t>,
+                                                     polyfill::is_specialization_of<S, get_all_pointer_t>,
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+                                                     polyfill::is_specialization_of<S, get_all_optional_t>,
+#endif
+                                                     polyfill::is_specialization_of<S, remove_all_t>>>> {
+            static constexpr bool memoizable = sql_shape<typename S::conditions_type>::memoizable;
+
+            static void append_key(const S& statement, std::string& key) {
+                append_sql_shape_key(statement.conditions, key);
+            }
+        };
+
+        /**
+         *  The column list is made of runtime member pointers.
+         */
+        template<class T, class... Cols>
+        struct sql_shape<insert_explicit<T, Cols...>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<Cols...>;
+
+            static void append_key(const insert_explicit<T, Cols...>& statement, std::string& key) {
+                append_sql_shape_key(statement.columns.columns, key);
+            }
+        };
+
+        template<class... Args>
+        struct sql_shape<row_value_t<Args...>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<Args...>;
+
+            static void append_key(const row_value_t<Args...>& expression, std::string& key) {
+                append_sql_shape_key(expression.args, key);
+            }
+        };
+
+        template<class... Args>
+        struct sql_shape<std::tuple<Args...>, void> {
+            static constexpr bool memoizable = is_sql_memoizable_v<Args...>;
+
+            static void append_key(const std::tuple<Args...>& expressions, std::string& key) {
+                append_sql_shape_key(expressions, key);
+            }
+        };
+    }
+}
@@ -3,10 +3,12 @@
 #include <sqlite3.h>
 #include <type_traits>  //  std::enable_if_t, std::is_arithmetic, std::is_same, std::true_type, std::false_type, std::make_index_sequence, std::index_sequence
 #include <memory>  //  std::default_delete
+#include <functional>  //  std::less, std::less_equal
 #include <string>  //  std::string, std::wstring
 #include <vector>  //  std::vector
-#include <cstring>  //  ::strncpy, ::strlen
+#include <cstring>  //  ::strncpy, ::strlen, std::memcmp
 #include "functional/cxx_string_view.h"
+#include "functional/cxx_memory_resource.h"
 #ifndef SQLITE_ORM_STRING_VIEW_SUPPORTED
 #include <cwchar>  //  ::wcsncpy, ::wcslen
 #endif
@@ -18,8 +20,12 @@
 #include "tuple_helper/tuple_filter.h"
 #include "error_code.h"
 #include "arithmetic_tag.h"
+#include "bound_array.h"
 #include "xdestroy_handling.h"
 #include "pointer_value.h"
+#include "wide_string.h"
+#include "byte_vector.h"
+#include "stored_value.h"
 
 namespace sqlite_orm {
 
@@ -117,6 +123,10 @@ namespace sqlite_orm {
 #ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
                                                                      ,
                                                                      std::is_same<V, std::string_view>
+#endif
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+                                                                     ,
+                                                                     std::is_same<V, std::pmr::string>
 #endif
                                                                      >>> {
 
@@ -160,16 +170,52 @@ namespace sqlite_orm {
 #endif
                                                                      >>> {
 
+        /**
+         *  Binds UTF-16 as it is where `wchar_t` is 16 bits wide. UTF-32 is encoded to UTF-8 in a buffer which
+         *  SQLite takes over, so it isn't copied again.
+         */
         int bind(sqlite3_stmt* stmt, int index, const V& value) const {
             auto stringData = this->string_data(value);
-            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-            std::string utf8Str = converter.to_bytes(stringData.first, stringData.first + stringData.second);
-            return statement_binder<decltype(utf8Str)>().bind(stmt, index, utf8Str);
+            if(internal::is_wchar_utf16_v) {
+                return sqlite3_bind_text16(stmt,
+                                           index,
+                                           stringData.first,
+                                           stringData.second * int(sizeof(wchar_t)),
+                                           SQLITE_TRANSIENT);
+            }
+            const size_t length = internal::utf8_length(stringData.first, size_t(stringData.second));
+            if(!length) {
+                return sqlite3_bind_text(stmt, index, "", 0, SQLITE_STATIC);
+            }
+            auto utf8 = static_cast<char*>(sqlite3_malloc64(length));
+            if(!utf8) {
+                return SQLITE_NOMEM;
+            }
+            internal::encode_utf8(stringData.first, size_t(stringData.second), utf8);
+            return sqlite3_bind_text64(stmt, index, utf8, length, sqlite3_free, SQLITE_UTF8);
         }
 
         void result(sqlite3_context* context, const V& value) const {
             auto stringData = this->string_data(value);
-            sqlite3_result_text16(context, stringData.first, stringData.second, nullptr);
+            if(internal::is_wchar_utf16_v) {
+                sqlite3_result_text16(context,
+                                      stringData.first,
+                                      stringData.second * int(sizeof(wchar_t)),
+                                      SQLITE_TRANSIENT);
+                return;
+            }
+            const size_t length = internal::utf8_length(stringData.first, size_t(stringData.second));
+            if(!length) {
+                sqlite3_result_text(context, "", 0, SQLITE_STATIC);
+                return;
+            }
+            auto utf8 = static_cast<char*>(sqlite3_malloc64(length));
+            if(!utf8) {
+                sqlite3_result_error_nomem(context);
+                return;
+            }
+            internal::encode_utf8(stringData.first, size_t(stringData.second), utf8);
+            sqlite3_result_text64(context, utf8, length, sqlite3_free, SQLITE_UTF8);
         }
 
       private:
@@ -256,6 +302,85 @@ namespace sqlite_orm {
         }
     };
 
+    /**
+     *  Specialization for binary data (std::vector<unsigned char> and std::vector<std::byte>).
+     */
+    template<class V>
+    struct statement_binder<V, std::enable_if_t<internal::is_byte_vector_v<V>>> {
+        int bind(sqlite3_stmt* stmt, int index, const V& value) const {
+            auto bytes = value.empty() ? "" : (const void*)value.data();
+            return sqlite3_bind_blob(stmt, index, bytes, int(value.size()), SQLITE_TRANSIENT);
+        }
+
+        void result(sqlite3_context* context, const V& value) const {
+            auto bytes = value.empty() ? "" : (const void*)value.data();
+            sqlite3_result_blob(context, bytes, int(value.size()), SQLITE_TRANSIENT);
+        }
+    };
+
+    /**
+     *  Specialization for fixed size binary data (std::array<unsigned char, N> and std::array<std::byte, N>).
+     */
+    template<class A>
+    struct statement_binder<A, std::enable_if_t<internal::is_byte_array_v<A>>> {
+        int bind(sqlite3_stmt* stmt, int index, const A& value) const {
+            return sqlite3_bind_blob(stmt, index, (const void*)value.data(), int(value.size()), SQLITE_TRANSIENT);
+        }
+
+        void result(sqlite3_context* context, const A& value) const {
+            sqlite3_result_blob(context, (const void*)value.data(), int(value.size()), SQLITE_TRANSIENT);
+        }
+    };
+
+    /**
+     *  Specialization for scoped enums and std::chrono types, bound as the value they are stored as.
+     */
+    template<class V>
+    struct statement_binder<V, std::enable_if_t<internal::is_stored_value_v<V>>> {
+        using stored_value = internal::stored_value<V>;
+        using stored_binder = statement_binder<typename stored_value::stored_type>;
+
+        int bind(sqlite3_stmt* stmt, int index, const V& value) const {
+            return stored_binder().bind(stmt, index, stored_value::to_stored(value));
+        }
+
+        void result(sqlite3_context* context, const V& value) const {
+            stored_binder().result(context, stored_value::to_stored(value));
+        }
+    };
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+    /**
+     *  Specialization for binary data (std::pmr::vector<char>).
+     */
+    template<>
+    struct statement_binder<std::pmr::vector<char>, void> {
+        int bind(sqlite3_stmt* stmt, int index, const std::pmr::vector<char>& value) const {
+            auto bytes = value.empty() ? "" : value.data();
+            return sqlite3_bind_blob(stmt, index, bytes, int(value.size()), SQLITE_TRANSIENT);
+        }
+
+        void result(sqlite3_context* context, const std::pmr::vector<char>& value) const {
+            sqlite3_result_blob(context, value.empty() ? "" : value.data(), int(value.size()), SQLITE_TRANSIENT);
+        }
+    };
+#endif
+
+    /**
+     *  Specialization for the values of `as_array()`: a carray if it can be bound, a JSON array otherwise.
+     */
+    template<class E>
+    struct statement_binder<internal::bound_array_t<E>, void> {
+        int bind(sqlite3_stmt* stmt, int index, const internal::bound_array_t<E>& value) const {
+#ifdef SQLITE_ORM_CARRAY_BIND_SUPPORTED
+            return internal::bind_carray(stmt, index, value.values);
+#else
+            auto json = internal::make_json_array(value.values);
+            return sqlite3_bind_text(stmt, index, json.c_str(), int(json.size()), SQLITE_TRANSIENT);
+#endif
+        }
+    };
+
 #ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
     template<class V>
     struct statement_binder<V,
@@ -293,65 +418,201 @@ namespace sqlite_orm {
             void operator()(const T&) const {}
         };
 
-        struct field_value_binder : conditional_binder {
-            using conditional_binder::conditional_binder;
-            using conditional_binder::operator();
+        /**
+         *  Whether a parameter of type T binds a value which only changes with it. Strings and blobs are bound
+         *  with SQLITE_TRANSIENT, so SQLite keeps a copy of its own, while pointers and views refer to values
+         *  which may change behind the back of the statement.
+         */
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool binds_owned_value_v =
+            polyfill::disjunction_v<std::is_arithmetic<T>,
+                                    std::is_same<T, std::string>,
+                                    std::is_same<T, std::wstring>,
+                                    std::is_same<T, std::vector<char>>,
+                                    is_byte_vector<T>,
+                                    is_byte_array<T>,
+                                    is_stored_value<T>,
+                                    std::is_same<T, nullptr_t>>;
+
+        /**
+         *  Calls `f(bytes, size)` with the bytes of a value of a type `binds_owned_value_v` is true for. Equal
+         *  bytes mean the value is the same one.
+         */
+        template<class T, class F, std::enable_if_t<std::is_arithmetic<T>::value, bool> = true>
+        void with_value_bytes(const T& value, const F& f) {
+            f(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
 
-            template<class T, satisfies_not<is_bindable, T> = true>
-            void operator()(const T&) const = delete;
+        template<class F>
+        void with_value_bytes(nullptr_t, const F& f) {
+            f("", 0);
+        }
 
-            template<class T>
-            void operator()(const T* value) {
-                if(!value) {
-                    throw std::system_error{orm_error_code::value_is_null};
+        template<class T,
+                 class F,
+                 std::enable_if_t<polyfill::disjunction_v<std::is_same<T, std::string>,
+                                                          std::is_same<T, std::wstring>,
+                                                          std::is_same<T, std::vector<char>>,
+                                                          is_byte_vector<T>,
+                                                          is_byte_array<T>>,
+                                  bool> = true>
+        void with_value_bytes(const T& value, const F& f) {
+            f(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(typename T::value_type));
+        }
+
+        template<class T, class F, std::enable_if_t<is_stored_value_v<T>, bool> = true>
+        void with_value_bytes(const T& value, const F& f) {
+            with_value_bytes(stored_value<T>::to_stored(value), f);
+        }
+
+        /**
+         *  The value a parameter of a prepared statement was bound with last, see `bind_if_changed()`.
+         */
+        struct bound_parameter {
+            bool bound = false;
+            std::string bytes;
+        };
+
+        /**
+         *  Binds `value` to the parameter `index` of `stmt` unless `bound` says the parameter is bound with an
+         *  equal value already: SQLite keeps bindings across `sqlite3_reset()`. The value is compared, not
+         *  tracked, so it may be changed through any reference.
+         */
+        template<class T, std::enable_if_t<binds_owned_value_v<T>, bool> = true>
+        int bind_if_changed(sqlite3_stmt* stmt, int index, const T& value, bound_parameter& bound) {
+            bool same = false;
+            with_value_bytes(value, [&bound, &same](const char* bytes, size_t size) {
+                same = bound.bound && bound.bytes.size() == size &&
+                       (size == 0 || std::memcmp(bound.bytes.data(), bytes, size) == 0);
+            });
+            if(same) {
+                return SQLITE_OK;
+            }
+            bound.bound = false;
+            int rc = statement_binder<T>{}.bind(stmt, index, value);
+            if(rc == SQLITE_OK) {
+                with_value_bytes(value, [&bound](const char* bytes, size_t size) {
+                    bound.bytes.assign(bytes, size);
+                });
+                bound.bound = true;
+            }
+            return rc;
+        }
+
+        template<class T, std::enable_if_t<!binds_owned_value_v<T>, bool> = true>
+        int bind_if_changed(sqlite3_stmt* stmt, int index, const T& value, bound_parameter& bound) {
+            bound.bound = false;
+            return statement_binder<T>{}.bind(stmt, index, value);
+        }
+
+        /**
+         *  Binds the parameters whose value differs from the one they were bound with, `bound[N - 1]` for
+         *  parameter N. The others keep their binding. Only values stored in the expression
+         *  [expressionBegin, expressionEnd) itself are compared: the AST iteration unwraps `std::ref()`, and
+         *  a parameter bound behind the back of the statement is restored from what it refers to.
+         */
+        struct changed_parameters_binder : conditional_binder {
+            std::vector<bound_parameter>& bound;
+            const char* const expressionBegin;
+            const char* const expressionEnd;
+
+            template<class E>
+            changed_parameters_binder(sqlite3_stmt* stmt, std::vector<bound_parameter>& bound, const E& expression) :
+                conditional_binder{stmt}, bound{bound}, expressionBegin{reinterpret_cast<const char*>(&expression)},
+                expressionEnd{reinterpret_cast<const char*>(&expression) + sizeof(E)} {}
+
+            template<class T, satisfies<is_bindable, T> = true>
+            void operator()(const T& t) {
+                const auto address = reinterpret_cast<const char*>(&t);
+                if(size_t(this->index) > this->bound.size()) {
+                    this->bound.resize(size_t(this->index));
+                }
+                auto& parameter = this->bound[size_t(this->index - 1)];
+                int rc;
+                if(std::less_equal<const char*>{}(this->expressionBegin, address) &&
+                   std::less<const char*>{}(address, this->expressionEnd)) {
+                    rc = bind_if_changed(this->stmt, this->index, t, parameter);
+                } else {
+                    parameter.bound = false;
+                    rc = statement_binder<T>{}.bind(this->stmt, this->index, t);
+                }
+                ++this->index;
+                if(SQLITE_OK != rc) {
+                    throw_translated_sqlite_error(this->stmt);
                 }
-                (*this)(*value);
             }
+
+            template<class T, satisfies_not<is_bindable, T> = true>
+            void operator()(const T&) const {}
         };
 
-        struct tuple_value_binder {
-            sqlite3_stmt* stmt = nullptr;
+        /**
+         *  Binds the fields of objects. If the objects outlive the step of the statement, `std::string` and
+         *  byte vector fields such as `std::vector<char>` are bound with SQLITE_STATIC, so SQLite doesn't copy them.
+         *  Values a getter returns by value are temporaries and are copied anyway.
+         */
+        struct field_value_binder : conditional_binder {
+            using conditional_binder::operator();
+
+            explicit field_value_binder(sqlite3_stmt* stmt, bool objectsOutliveStep = false) :
+                conditional_binder{stmt}, objectsOutliveStep{objectsOutliveStep} {}
 
-            explicit tuple_value_binder(sqlite3_stmt* stmt) : stmt{stmt} {}
+            template<class T, satisfies_not<is_bindable, T> = true>
+            void operator()(const T&) const = delete;
 
-            template<class Tpl, class Projection>
-            void operator()(const Tpl& tpl, Projection project) const {
-                (*this)(tpl,
-                        std::make_index_sequence<std::tuple_size<Tpl>::value>{},
-                        std::forward<Projection>(project));
+            void operator()(const std::string& value) {
+                this->check(sqlite3_bind_text(this->stmt,
+                                              this->index++,
+                                              value.c_str(),
+                                              int(value.size()),
+                                              this->objectsOutliveStep ? SQLITE_STATIC : SQLITE_TRANSIENT));
             }
 
-          private:
-#ifdef SQLITE_ORM_FOLD_EXPRESSIONS_SUPPORTED
-            template<class Tpl, size_t... Idx, class Projection>
-            void operator()(const Tpl& tpl, std::index_sequence<Idx...>, Projection project) const {
-                (this->bind(polyfill::invoke(project, std::get<Idx>(tpl)), Idx), ...);
+            void operator()(const std::string&& value) {
+                conditional_binder::operator()(value);
             }
-#else
-            template<class Tpl, size_t I, size_t... Idx, class Projection>
-            void operator()(const Tpl& tpl, std::index_sequence<I, Idx...>, Projection project) const {
-                this->bind(polyfill::invoke(project, std::get<I>(tpl)), I);
-                (*this)(tpl, std::index_sequence<Idx...>{}, std::forward<Projection>(project));
+
+            void operator()(const std::vector<char>& value) {
+                this->check(sqlite3_bind_blob(this->stmt,
+                                              this->index++,
+                                              value.empty() ? "" : (const void*)value.data(),
+                                              int(value.size()),
+                                              this->objectsOutliveStep ? SQLITE_STATIC : SQLITE_TRANSIENT));
             }
 
-            template<class Tpl, class Projection>
-            void operator()(const Tpl&, std::index_sequence<>, Projection) const {}
-#endif
+            void operator()(const std::vector<char>&& value) {
+                conditional_binder::operator()(value);
+            }
 
-            template<class T>
-            void bind(const T& t, size_t idx) const {
-                int rc = statement_binder<T>{}.bind(this->stmt, int(idx + 1), t);
-                if(SQLITE_OK != rc) {
-                    throw_translated_sqlite_error(stmt);
-                }
+            template<class B, std::enable_if_t<is_blob_byte_v<B>, bool> = true>
+            void operator()(const std::vector<B>& value) {
+                this->check(sqlite3_bind_blob(this->stmt,
+                                              this->index++,
+                                              value.empty() ? "" : (const void*)value.data(),
+                                              int(value.size()),
+                                              this->objectsOutliveStep ? SQLITE_STATIC : SQLITE_TRANSIENT));
+            }
+
+            template<class B, std::enable_if_t<is_blob_byte_v<B>, bool> = true>
+            void operator()(const std::vector<B>&& value) {
+                conditional_binder::operator()(value);
             }
 
             template<class T>
-            void bind(const T* value, size_t idx) const {
+            void operator()(const T* value) {
                 if(!value) {
                     throw std::system_error{orm_error_code::value_is_null};
                 }
-                (*this)(*value, idx);
+                (*this)(*value);
+            }
+
+          private:
+            bool objectsOutliveStep;
+
+            void check(int rc) const {
+                if(SQLITE_OK != rc) {
+                    throw_translated_sqlite_error(this->stmt);
+                }
             }
         };
 
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>  //  std::atomic
+#include <cstdint>  //  uint64_t
+#include <string>  //  std::string
+#include <map>  //  std::map
+#include <unordered_map>  //  std::unordered_map
+#include <utility>  //  std::move
+#include <mutex>  //  std::mutex, std::lock_guard
+
+#include "statement_stats.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Unique key of statement type `S` that doesn't need RTTI.
+         */
+        template<class S>
+        const void* statement_type_key() {
+            static const char key = 0;
+            return &key;
+        }
+
+        /**
+         *  Keeps prepared statements of the non-prepared CRUD API alive between calls.
+         *  Statements are keyed by their connection and SQL text. A statement is taken out of the cache
+         *  while it is in use and put back (reset, with cleared bindings) once its `prepared_statement_t` is destroyed,
+         *  so every cached statement is used by one caller at a time.
+         */
+        struct statement_cache {
+
+            statement_cache(size_t capacity_) : capacity(capacity_) {}
+
+            statement_cache(const statement_cache&) = delete;
+            statement_cache& operator=(const statement_cache&) = delete;
+
+            ~statement_cache() {
+                this->clear();
+            }
+
+            /**
+             *  Returns a cached statement prepared from `sql` for `db` or nullptr.
+             */
+            sqlite3_stmt* take(sqlite3* db, const std::string& sql) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->take_impl(db, sql);
+            }
+
+            /**
+             *  Puts a statement back into the cache. The statement is finalized if the cache is full
+             *  or already has a statement with the same SQL for the same connection.
+             *  Counters of the statement are added to the statistics of its SQL text.
+             */
+            void put(sqlite3_stmt* stmt) {
+                if(!stmt) {
+                    return;
+                }
+                sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
+                const statement_stats runStats = get_statement_stats(stmt, true);
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->sqlStats[sqlite3_sql(stmt)] += runStats;
+                    if(this->count < this->capacity) {
+                        auto& connectionStatements = this->statements[sqlite3_db_handle(stmt)];
+                        if(connectionStatements.emplace(sqlite3_sql(stmt), stmt).second) {
+                            ++this->count;
+                            return;
+                        }
+                    }
+                }
+                sqlite3_finalize(stmt);
+            }
+
+            /**
+             *  Finalizes all cached statements. Must be called before the cached connections are closed.
+             */
+            void clear() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                for(auto& connectionStatements: this->statements) {
+                    for(auto& p: connectionStatements.second) {
+                        sqlite3_finalize(p.second);
+                    }
+                }
+                this->statements.clear();
+                this->count = 0;
+            }
+
+            size_t size() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->count;
+            }
+
+            /**
+             *  Returns statistics accumulated per SQL text of all statements put back into the cache.
+             */
+            std::map<std::string, statement_stats> stats() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->sqlStats;
+            }
+
+            const size_t capacity;
+
+          protected:
+            sqlite3_stmt* take_impl(sqlite3* db, const std::string& sql) {
+                auto connectionIt = this->statements.find(db);
+                if(connectionIt == this->statements.end()) {
+                    return nullptr;
+                }
+                auto it = connectionIt->second.find(sql);
+                if(it == connectionIt->second.end()) {
+                    return nullptr;
+                }
+                sqlite3_stmt* stmt = it->second;
+                connectionIt->second.erase(it);
+                --this->count;
+                return stmt;
+            }
+
+            std::map<sqlite3*, std::map<std::string, sqlite3_stmt*>> statements;
+            std::map<std::string, statement_stats> sqlStats;
+            size_t count = 0;
+            std::mutex mutex;
+        };
+
+        /**
+         *  SQL text of statement types whose SQL is fully determined by the type (see `is_sql_static_v`), or by the
+         *  type and a few runtime parts (see `sql_shape`).
+         *  Table and column names are runtime values of a storage, so the text can't be produced at compile time,
+         *  but it has to be serialized only once per storage and statement type.
+         */
+        struct static_sql_cache {
+
+            static_sql_cache() = default;
+            static_sql_cache(const static_sql_cache&) = delete;
+            static_sql_cache& operator=(const static_sql_cache&) = delete;
+
+            /**
+             *  Returns the SQL text of a statement type serializing it with `serialize()` on the first call.
+             *  The returned reference stays valid for the lifetime of the cache.
+             *  @param statementType key of the statement type obtained with `statement_type_key()`.
+             */
+            template<class F>
+            const std::string& get(const void* statementType, F&& serialize) {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    auto it = this->sqls.find(statementType);
+                    if(it != this->sqls.end()) {
+                        return it->second;
+                    }
+                }
+                std::string sql = serialize();
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->sqls.emplace(statementType, move(sql)).first->second;
+            }
+
+            /**
+             *  Returns the SQL text of a statement type whose SQL also depends on the runtime parts in `shapeKey`
+             *  (see `sql_shape`), serializing it with `serialize()` on the first call for this key and thread. The
+             *  texts are memoized per thread so that a hit takes no lock. The returned reference stays valid until
+             *  the next call on the same thread.
+             */
+            template<class F>
+            const std::string& get(const void* statementType, std::string shapeKey, F&& serialize) {
+                //  the id rather than the address of the cache, which can be reused by a later storage
+                shapeKey.append(reinterpret_cast<const char*>(&this->id), sizeof(this->id));
+                shapeKey.append(reinterpret_cast<const char*>(&statementType), sizeof(statementType));
+                auto& sqls = thread_shaped_sqls();
+                auto it = sqls.find(shapeKey);
+                if(it != sqls.end()) {
+                    return it->second;
+                }
+                std::string sql = serialize();
+                //  entries of destroyed storages are never hit again, clearing from time to time bounds them
+                if(sqls.size() >= maxShapedSqls) {
+                    sqls.clear();
+                }
+                return sqls.emplace(move(shapeKey), move(sql)).first->second;
+            }
+
+          protected:
+            static constexpr size_t maxShapedSqls = 1024;
+
+            std::map<const void*, std::string> sqls;
+            std::mutex mutex;
+            const uint64_t id = next_id();
+
+            static uint64_t next_id() {
+                static std::atomic<uint64_t> lastId{0};
+                return ++lastId;
+            }
+
+            static std::unordered_map<std::string, std::string>& thread_shaped_sqls() {
+                thread_local std::unordered_map<std::string, std::string> sqls;
+                return sqls;
+            }
+        };
+    }
+}
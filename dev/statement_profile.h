@@ -0,0 +1,50 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <chrono>  //  std::chrono::nanoseconds
+#include <string>  //  std::string
+
+#include "io_statistics.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  Statistics of one finished statement passed to the callback set with `storage.on_profile()`.
+     */
+    struct statement_profile {
+
+        /**
+         *  SQL text with bound parameters expanded (`sqlite3_expanded_sql`).
+         */
+        std::string expanded_sql;
+
+        /**
+         *  SQL text with literals replaced by placeholders (`sqlite3_normalized_sql`) if SQLite is built
+         *  with SQLITE_ENABLE_NORMALIZE, otherwise the SQL text as it was prepared (`sqlite3_sql`).
+         *  Statements generated by sqlite_orm bind their values, so both are good keys to group statements by.
+         */
+        std::string normalized_sql;
+
+        /**
+         *  Wall time of the statement from its first step until it got reset or finalized.
+         */
+        std::chrono::nanoseconds duration{0};
+
+        /**
+         *  Number of result rows stepped.
+         */
+        sqlite3_int64 rows = 0;
+
+        /**
+         *  File I/O of the statement if the storage opens its database through an `io_accounting_shim`.
+         */
+        io_counters io;
+
+        /**
+         *  Calls of the busy handler while the statement waited for locks held by other connections, and the time
+         *  spent in them, if `storage.enable_busy_statistics()` is called.
+         */
+        size_t busy_callbacks = 0;
+        std::chrono::nanoseconds busy_wait{0};
+    };
+}
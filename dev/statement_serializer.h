@@ -1,16 +1,14 @@
 #pragma once
 
-#include <sstream>  //  std::stringstream
 #include <string>  //  std::string
 #include <type_traits>  //  std::enable_if, std::remove_pointer
 #include <vector>  //  std::vector
 #include <algorithm>  //  std::iter_swap
-#ifndef SQLITE_ORM_OMITS_CODECVT
-#include <codecvt>  //  std::codecvt_utf8_utf16
-#endif  //  SQLITE_ORM_OMITS_CODECVT
 #include <memory>
 #include <array>
+#include <cwchar>  //  wcslen
 #include "functional/cxx_string_view.h"
+#include "functional/cxx_memory_resource.h"
 
 #include "functional/cxx_universal.h"
 #include "functional/cxx_functional_polyfill.h"
@@ -20,6 +18,11 @@
 #include "ast/excluded.h"
 #include "ast/group_by.h"
 #include "ast/into.h"
+#include "ast/with.h"
+#include "ast/row_value.h"
+#include "ast/returning.h"
+#include "ast/time_bucket.h"
+#include "dynamic_where.h"
 #include "core_functions.h"
 #include "constraints.h"
 #include "conditions.h"
@@ -28,7 +31,9 @@
 #include "function.h"
 #include "prepared_statement.h"
 #include "rowid.h"
+#include "fts5.h"
 #include "pointer_value.h"
+#include "wide_string.h"
 #include "type_printer.h"
 #include "field_printer.h"
 #include "literal.h"
@@ -36,6 +41,7 @@
 #include "column_names_getter.h"
 #include "order_by_serializer.h"
 #include "serializing_util.h"
+#include "pooled_stringstream.h"
 #include "statement_binder.h"
 #include "values.h"
 #include "triggers.h"
@@ -74,9 +80,13 @@ namespace sqlite_orm {
 
           private:
             template<class X,
-                     std::enable_if_t<is_printable_v<X> && !std::is_base_of<std::string, X>::value
+                     std::enable_if_t<is_printable_v<X> && !std::is_base_of<std::string, X>::value &&
+                                          !is_byte_vector_v<X> && !is_byte_array_v<X>
 #ifndef SQLITE_ORM_OMITS_CODECVT
                                           && !std::is_base_of<std::wstring, X>::value
+#endif
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+                                          && !std::is_same<X, std::pmr::string>::value
 #endif
                                       ,
                                       bool> = true>
@@ -102,8 +112,7 @@ namespace sqlite_orm {
             }
 
             std::string do_serialize(const wchar_t* c) const {
-                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-                return quote_string_literal(converter.to_bytes(c));
+                return quote_string_literal(to_utf8(c, ::wcslen(c)));
             }
 #endif
 #ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
@@ -112,8 +121,7 @@ namespace sqlite_orm {
             }
 #ifndef SQLITE_ORM_OMITS_CODECVT
             std::string do_serialize(const std::wstring_view& c) const {
-                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-                return quote_string_literal(converter.to_bytes(c.data(), c.data() + c.size()));
+                return quote_string_literal(to_utf8(c.data(), c.size()));
             }
 #endif
 #endif
@@ -124,6 +132,20 @@ namespace sqlite_orm {
                 return quote_blob_literal(field_printer<std::vector<char>>{}(t));
             }
 
+            template<class X, std::enable_if_t<is_byte_vector_v<X> || is_byte_array_v<X>, bool> = true>
+            std::string do_serialize(const X& t) const {
+                return quote_blob_literal(field_printer<X>{}(t));
+            }
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+            std::string do_serialize(const std::pmr::string& c) const {
+                return quote_string_literal(field_printer<std::pmr::string>{}(c));
+            }
+
+            std::string do_serialize(const std::pmr::vector<char>& t) const {
+                return quote_blob_literal(field_printer<std::pmr::vector<char>>{}(t));
+            }
+#endif
+
             template<class P, class PT, class D>
             std::string do_serialize(const pointer_binding<P, PT, D>&) const {
                 // always serialize null (security reasons)
@@ -155,20 +177,135 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) {
-                std::stringstream ss;
-                ss << serialize(statement.function, context);
+                //  FILTER has to follow the call directly, a parenthesized call would be a syntax error
+                auto functionContext = context;
+                functionContext.use_parentheses = false;
+                pooled_stringstream ss;
+                ss << serialize(statement.function, functionContext);
                 ss << " FILTER (WHERE " << serialize(statement.where, context) << ")";
                 return ss.str();
             }
         };
 
+        template<class F, class... Args>
+        struct statement_serializer<over_t<F, Args...>, void> {
+            using statement_type = over_t<F, Args...>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                pooled_stringstream ss;
+                if(context.use_parentheses) {
+                    ss << '(';
+                }
+                //  OVER has to follow the function call immediately
+                auto functionContext = context;
+                functionContext.use_parentheses = false;
+                ss << serialize(statement.function, functionContext) << " OVER ";
+                if(!statement.window_name.empty()) {
+                    ss << streaming_identifier(statement.window_name);
+                } else {
+                    auto newContext = context;
+                    newContext.skip_table_name = false;
+                    ss << "(" << streaming_actions_tuple(statement.definition, newContext) << ")";
+                }
+                if(context.use_parentheses) {
+                    ss << ')';
+                }
+                return ss.str();
+            }
+        };
+
+        template<class... Args>
+        struct statement_serializer<partition_by_t<Args...>, void> {
+            using statement_type = partition_by_t<Args...>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << "PARTITION BY " << streaming_expressions_tuple(statement.args, context);
+                return ss.str();
+            }
+        };
+
+        template<>
+        struct statement_serializer<frame_bound_t, void> {
+            using statement_type = frame_bound_t;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& bound, const Ctx&) const {
+                switch(bound.type) {
+                    case frame_bound_t::kind::unbounded_preceding:
+                        return "UNBOUNDED PRECEDING";
+                    case frame_bound_t::kind::preceding:
+                        return std::to_string(bound.offset) + " PRECEDING";
+                    case frame_bound_t::kind::current_row:
+                        return "CURRENT ROW";
+                    case frame_bound_t::kind::following:
+                        return std::to_string(bound.offset) + " FOLLOWING";
+                    case frame_bound_t::kind::unbounded_following:
+                        return "UNBOUNDED FOLLOWING";
+                }
+                return {};
+            }
+        };
+
+        template<>
+        struct statement_serializer<frame_spec_t, void> {
+            using statement_type = frame_spec_t;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& frame, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << frame.units << " BETWEEN " << serialize(frame.start, context) << " AND "
+                   << serialize(frame.end, context);
+                return ss.str();
+            }
+        };
+
+        template<class... Args>
+        struct statement_serializer<named_window_t<Args...>, void> {
+            using statement_type = named_window_t<Args...>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& window, const Ctx& context) const {
+                pooled_stringstream ss;
+                auto newContext = context;
+                newContext.skip_table_name = false;
+                ss << streaming_identifier(window.name) << " AS ("
+                   << streaming_actions_tuple(window.definition, newContext) << ")";
+                return ss.str();
+            }
+        };
+
+        template<class... Windows>
+        struct statement_serializer<window_t<Windows...>, void> {
+            using statement_type = window_t<Windows...>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << "WINDOW " << streaming_expressions_tuple(statement.windows, context);
+                return ss.str();
+            }
+        };
+
+        template<class O, class F>
+        struct statement_serializer<time_bucket_t<O, F>, void> {
+            using statement_type = time_bucket_t<O, F>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                return time_bucket_sql(serialize(statement.field, context), statement.seconds, statement_type::kind);
+            }
+        };
+
         template<class T>
         struct statement_serializer<excluded_t<T>, void> {
             using statement_type = excluded_t<T>;
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "excluded.";
                 if(auto* columnName = find_column_name(context.db_objects, statement.expression)) {
                     ss << streaming_identifier(*columnName);
@@ -205,7 +342,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type&, const Ctx&) {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << streaming_identifier(T::get());
                 return ss.str();
             }
@@ -217,7 +354,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "ON CONFLICT";
                 iterate_tuple(statement.target_args, [&ss, &context](auto& value) {
                     using value_type = std::decay_t<decltype(value)>;
@@ -249,7 +386,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(context.use_parentheses) {
                     ss << '(';
                 }
@@ -265,13 +402,17 @@ namespace sqlite_orm {
         struct statement_serializer<built_in_aggregate_function_t<R, S, Args...>, void>
             : statement_serializer<built_in_function_t<R, S, Args...>, void> {};
 
+        template<class R, class S, class... Args>
+        struct statement_serializer<built_in_window_function_t<R, S, Args...>, void>
+            : statement_serializer<built_in_function_t<R, S, Args...>, void> {};
+
         template<class F, class... Args>
         struct statement_serializer<function_call<F, Args...>, void> {
             using statement_type = function_call<F, Args...>;
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << F::name() << "(" << streaming_expressions_tuple(statement.args, context) << ")";
                 return ss.str();
             }
@@ -283,7 +424,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << serialize(c.expression, context) + " AS " << streaming_identifier(alias_extractor<T>::get());
                 return ss.str();
             }
@@ -295,7 +436,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(!context.skip_table_name) {
                     ss << streaming_identifier(alias_extractor<T>::get()) << ".";
                 }
@@ -312,7 +453,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& m, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(!context.skip_table_name) {
                     ss << streaming_identifier(lookup_table_name<O>(context.db_objects)) << ".";
                 }
@@ -361,7 +502,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& s, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(!context.skip_table_name) {
                     ss << streaming_identifier(lookup_table_name<O>(context.db_objects)) << ".";
                 }
@@ -370,13 +511,25 @@ namespace sqlite_orm {
             }
         };
 
+        template<class T>
+        struct statement_serializer<fts5_table_t<T>, void> {
+            using statement_type = fts5_table_t<T>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << streaming_identifier(lookup_table_name<T>(context.db_objects));
+                return ss.str();
+            }
+        };
+
         template<class O>
         struct statement_serializer<table_oid_t<O>, void> {
             using statement_type = table_oid_t<O>;
 
             template<class Ctx>
             std::string operator()(const statement_type& s, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(!context.skip_table_name) {
                     ss << streaming_identifier(lookup_table_name<O>(context.db_objects)) << ".";
                 }
@@ -391,7 +544,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& s, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(!context.skip_table_name) {
                     ss << streaming_identifier(lookup_table_name<O>(context.db_objects)) << ".";
                 }
@@ -408,7 +561,7 @@ namespace sqlite_orm {
             std::string operator()(const statement_type& statement, const Ctx& context) const {
                 auto lhs = serialize(statement.lhs, context);
                 auto rhs = serialize(statement.rhs, context);
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(context.use_parentheses) {
                     ss << '(';
                 }
@@ -436,7 +589,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx&) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto functionName = c.serialize();
                 ss << functionName << "(*)";
                 return ss.str();
@@ -449,7 +602,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto expr = serialize(c.value, context);
                 ss << static_cast<std::string>(c) << "(" << expr << ")";
                 return ss.str();
@@ -462,7 +615,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto expr = serialize(c.value, context);
                 ss << static_cast<std::string>(c) << "(" << expr << ")";
                 return ss.str();
@@ -475,7 +628,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(!context.skip_table_name) {
                     ss << streaming_identifier(lookup_table_name<T>(context.db_objects)) << ".";
                 }
@@ -494,7 +647,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(c) << " (";
                 ss << serialize(c.expression, context) << " AS " << type_printer<T>().print() << ")";
                 return ss.str();
@@ -507,7 +660,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << serialize(c.left, context) << " ";
                 ss << static_cast<std::string>(c) << " ";
                 ss << serialize(c.right, context);
@@ -521,7 +674,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "CASE ";
                 c.case_expression.apply([&ss, context](auto& c_) {
                     ss << serialize(c_, context) << " ";
@@ -538,13 +691,34 @@ namespace sqlite_orm {
             }
         };
 
+        template<class R, class T, class K, class V>
+        struct statement_serializer<dynamic_case_t<R, T, K, V>, void> {
+            using statement_type = dynamic_case_t<R, T, K, V>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& c, const Ctx& context) const {
+                //  CASE needs at least one WHEN
+                if(c.args.empty()) {
+                    return "NULL";
+                }
+                pooled_stringstream ss;
+                ss << "CASE " << serialize(c.case_expression, context) << " ";
+                for(auto& pair: c.args) {
+                    ss << "WHEN " << serialize(pair.first, context) << " ";
+                    ss << "THEN " << serialize(pair.second, context) << " ";
+                }
+                ss << "END";
+                return ss.str();
+            }
+        };
+
         template<class T>
         struct statement_serializer<is_null_t<T>, void> {
             using statement_type = is_null_t<T>;
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << serialize(c.t, context) << " " << static_cast<std::string>(c);
                 return ss.str();
             }
@@ -556,7 +730,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << serialize(c.t, context) << " " << static_cast<std::string>(c);
                 return ss.str();
             }
@@ -568,7 +742,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << statement.serialize() << " ";
                 auto cString = serialize(statement.argument, context);
                 ss << " (" << cString << " )";
@@ -582,7 +756,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(c) << " ";
                 auto cString = serialize(c.c, context);
                 ss << " (" << cString << " )";
@@ -598,7 +772,7 @@ namespace sqlite_orm {
             std::string operator()(const statement_type& c, const Ctx& context) const {
                 auto leftString = serialize(c.l, context);
                 auto rightString = serialize(c.r, context);
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(context.use_parentheses) {
                     ss << "(";
                 }
@@ -642,7 +816,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto leftString = serialize(statement.left, context);
                 ss << leftString << " ";
                 if(!statement.negative) {
@@ -671,7 +845,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto leftString = serialize(statement.left, context);
                 ss << leftString << " ";
                 if(!statement.negative) {
@@ -684,13 +858,83 @@ namespace sqlite_orm {
             }
         };
 
+        /**
+         *  A list of row values is a VALUES table, SQLite doesn't take them in parentheses. An empty list is
+         *  a query without rows of as many columns.
+         */
+        template<class... Args, class E>
+        struct statement_serializer<dynamic_in_t<row_value_t<Args...>, std::vector<E>>, void> {
+            using statement_type = dynamic_in_t<row_value_t<Args...>, std::vector<E>>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << serialize(statement.left, context) << " ";
+                if(!statement.negative) {
+                    ss << "IN";
+                } else {
+                    ss << "NOT IN";
+                }
+                if(statement.argument.empty()) {
+                    ss << " (SELECT ";
+                    for(size_t i = 0; i < sizeof...(Args); ++i) {
+                        ss << (i ? ", NULL" : "NULL");
+                    }
+                    ss << " LIMIT 0)";
+                    return ss.str();
+                }
+                ss << " (VALUES ";
+                bool first = true;
+                for(auto& row: statement.argument) {
+                    if(!first) {
+                        ss << ", ";
+                    }
+                    first = false;
+                    ss << serialize(row, context);
+                }
+                ss << ")";
+                return ss.str();
+            }
+        };
+
+        template<class L, class E>
+        struct statement_serializer<dynamic_in_t<L, bound_array_t<E>>, void> {
+            using statement_type = dynamic_in_t<L, bound_array_t<E>>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                pooled_stringstream ss;
+                auto leftString = serialize(statement.left, context);
+                ss << leftString << " ";
+                if(!statement.negative) {
+                    ss << "IN";
+                } else {
+                    ss << "NOT IN";
+                }
+#ifdef SQLITE_ORM_CARRAY_BIND_SUPPORTED
+                if(context.replace_bindable_with_question) {
+                    ss << " carray(?)";
+                    return ss.str();
+                }
+#endif
+                ss << " (SELECT value FROM json_each(";
+                if(context.replace_bindable_with_question) {
+                    ss << "?";
+                } else {
+                    ss << quote_string_literal(make_json_array(statement.argument.values));
+                }
+                ss << "))";
+                return ss.str();
+            }
+        };
+
         template<class L, class... Args>
         struct statement_serializer<in_t<L, Args...>, void> {
             using statement_type = in_t<L, Args...>;
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto leftString = serialize(statement.left, context);
                 ss << leftString << " ";
                 if(!statement.negative) {
@@ -719,7 +963,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << serialize(c.arg, context) << " ";
                 ss << static_cast<std::string>(c) << " ";
                 ss << serialize(c.pattern, context);
@@ -736,7 +980,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << serialize(c.arg, context) << " ";
                 ss << static_cast<std::string>(c) << " ";
                 ss << serialize(c.pattern, context);
@@ -750,7 +994,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto expr = serialize(c.expr, context);
                 ss << expr << " " << static_cast<std::string>(c) << " ";
                 ss << serialize(c.b1, context);
@@ -766,13 +1010,66 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "EXISTS ";
                 ss << serialize(statement.expression, context);
                 return ss.str();
             }
         };
 
+        template<class T, class S>
+        struct statement_serializer<common_table_expression<T, S>, void> {
+            using statement_type = common_table_expression<T, S>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& cte, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << streaming_identifier(cte.table.name) << "("
+                   << streaming_table_column_names(cte.table, false) << ") AS ";
+                switch(cte.materialization) {
+                    case cte_materialization::unspecified:
+                        break;
+                    case cte_materialization::materialized:
+                        ss << "MATERIALIZED ";
+                        break;
+                    case cte_materialization::not_materialized:
+                        ss << "NOT MATERIALIZED ";
+                        break;
+                }
+                ss << "(" << serialize(cte.expression, context) << ")";
+                return ss.str();
+            }
+        };
+
+        /**
+         *  The common table expressions and the statement are serialized with the tables of the CTEs added
+         *  to the database objects, so that the row types of the CTEs resolve to their names like mapped
+         *  types do.
+         */
+        template<class CTEs, class E>
+        struct statement_serializer<with_t<CTEs, E>, void> {
+            using statement_type = with_t<CTEs, E>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                auto dbObjects = std::tuple_cat(context.db_objects, get_cte_tables(statement.cte));
+                serializer_context<decltype(dbObjects)> cteContext{dbObjects};
+                static_cast<serializer_context_base&>(cteContext) = context;
+
+                pooled_stringstream ss;
+                ss << "WITH ";
+                if(statement.recursive) {
+                    ss << "RECURSIVE ";
+                }
+                iterate_tuple(statement.cte, [&ss, &cteContext, first = true](auto& cte) mutable {
+                    constexpr std::array<const char*, 2> sep = {", ", ""};
+                    ss << sep[std::exchange(first, false)] << serialize(cte, cteContext);
+                });
+                ss << " " << serialize(statement.expression, cteContext);
+                return ss.str();
+            }
+        };
+
         template<>
         struct statement_serializer<autoincrement_t, void> {
             using statement_type = autoincrement_t;
@@ -821,7 +1118,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "PRIMARY KEY";
                 switch(statement.options.asc_option) {
                     case statement_type::order_by::ascending:
@@ -851,7 +1148,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(c);
                 using columns_tuple = typename statement_type::columns_tuple;
                 const size_t columnsCount = std::tuple_size<columns_tuple>::value;
@@ -888,7 +1185,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& fk, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "FOREIGN KEY(" << streaming_mapped_columns_expressions(fk.columns, context) << ") REFERENCES ";
                 {
                     using references_type_t = typename std::decay_t<decltype(fk)>::references_type;
@@ -914,7 +1211,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "CHECK (" << serialize(statement.expression, context) << ")";
                 return ss.str();
             }
@@ -926,7 +1223,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(statement.full) {
                     ss << "GENERATED ALWAYS ";
                 }
@@ -955,7 +1252,7 @@ namespace sqlite_orm {
             std::string operator()(const statement_type& column, const Ctx& context) const {
                 using column_type = statement_type;
 
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << streaming_identifier(column.name) << " " << type_printer<field_type_t<column_type>>().print()
                    << " "
                    << streaming_column_constraints(
@@ -974,8 +1271,8 @@ namespace sqlite_orm {
             std::string operator()(const statement_type& rem, const Ctx& context) const {
                 auto& table = pick_table<T>(context.db_objects);
 
-                std::stringstream ss;
-                ss << "DELETE FROM " << streaming_identifier(table.name)
+                pooled_stringstream ss;
+                ss << "DELETE FROM " << streaming_table_identifier(table)
                    << streaming_conditions_tuple(rem.conditions, context);
                 return ss.str();
             }
@@ -990,8 +1287,8 @@ namespace sqlite_orm {
                 using expression_type = std::decay_t<decltype(statement)>;
                 using object_type = typename expression_object_type<expression_type>::type;
                 auto& table = pick_table<object_type>(context.db_objects);
-                std::stringstream ss;
-                ss << "REPLACE INTO " << streaming_identifier(table.name) << " ("
+                pooled_stringstream ss;
+                ss << "REPLACE INTO " << streaming_table_identifier(table) << " ("
                    << streaming_non_generated_column_names(table) << ")"
                    << " VALUES ("
                    << streaming_field_values_excluding(check_if<is_generated_always>{},
@@ -1014,8 +1311,8 @@ namespace sqlite_orm {
                 using expression_type = std::decay_t<decltype(ins)>;
                 using object_type = typename expression_object_type<expression_type>::type;
                 auto& table = pick_table<object_type>(context.db_objects);
-                std::stringstream ss;
-                ss << "INSERT INTO " << streaming_identifier(table.name) << " ";
+                pooled_stringstream ss;
+                ss << "INSERT INTO " << streaming_table_identifier(table) << " ";
                 ss << "(" << streaming_mapped_columns_expressions(ins.columns.columns, context) << ") "
                    << "VALUES (";
                 iterate_tuple(ins.columns.columns,
@@ -1043,8 +1340,8 @@ namespace sqlite_orm {
                 using object_type = typename expression_object_type<expression_type>::type;
                 auto& table = pick_table<object_type>(context.db_objects);
 
-                std::stringstream ss;
-                ss << "UPDATE " << streaming_identifier(table.name) << " SET ";
+                pooled_stringstream ss;
+                ss << "UPDATE " << streaming_table_identifier(table) << " SET ";
                 table.template for_each_column_excluding<mpl::disjunction_fn<is_primary_key, is_generated_always>>(
                     [&table, &ss, &context, &object = get_ref(statement.object), first = true](auto& column) mutable {
                         if(table.exists_in_composite_primary_key(column)) {
@@ -1052,12 +1349,20 @@ namespace sqlite_orm {
                         }
 
                         constexpr std::array<const char*, 2> sep = {", ", ""};
-                        ss << sep[std::exchange(first, false)] << streaming_identifier(column.name) << " = "
-                           << serialize(polyfill::invoke(column.member_pointer, object), context);
+                        ss << sep[std::exchange(first, false)] << streaming_identifier(column.name) << " = ";
+                        if(table.is_version_column(column)) {
+                            ss << streaming_identifier(column.name) << " + 1";
+                        } else {
+                            ss << serialize(polyfill::invoke(column.member_pointer, object), context);
+                        }
                     });
                 ss << " WHERE ";
-                table.for_each_column(
-                    [&table, &context, &ss, &object = get_ref(statement.object), first = true](auto& column) mutable {
+                if(table.rowid_member) {
+                    ss << streaming_identifier("rowid") << " = "
+                       << serialize(get_ref(statement.object).*table.rowid_member, context);
+                } else {
+                    table.for_each_column([&table, &context, &ss, &object = get_ref(statement.object), first = true](
+                                              auto& column) mutable {
                         if(!column.template is<is_primary_key>() && !table.exists_in_composite_primary_key(column)) {
                             return;
                         }
@@ -1066,6 +1371,26 @@ namespace sqlite_orm {
                         ss << sep[std::exchange(first, false)] << streaming_identifier(column.name) << " = "
                            << serialize(polyfill::invoke(column.member_pointer, object), context);
                     });
+                }
+                table.for_each_column([&table, &context, &ss, &object = get_ref(statement.object)](auto& column) {
+                    if(table.is_version_column(column)) {
+                        ss << " AND " << streaming_identifier(column.name) << " = "
+                           << serialize(object.*table.version_member, context);
+                    }
+                });
+                return ss.str();
+            }
+        };
+
+        template<class S, class T>
+        struct statement_serializer<returning_t<S, T>, void> {
+            using statement_type = returning_t<S, T>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << serialize(statement.statement, context) << " RETURNING "
+                   << streaming_serialized(get_column_names(statement.columns, context));
                 return ss.str();
             }
         };
@@ -1076,7 +1401,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "SET ";
                 auto leftContext = context;
                 leftContext.skip_table_name = true;
@@ -1098,21 +1423,30 @@ namespace sqlite_orm {
                 table_name_collector collector([&context](const std::type_index& ti) {
                     return find_table_name(context.db_objects, ti);
                 });
-                iterate_ast(upd.set.assigns, collector);
+                //  the updated table is the one of the assigned columns, the right sides may read other tables,
+                //  e.g. the ones of `from()` in UPDATE ... FROM
+                iterate_tuple(upd.set.assigns, [&collector](auto& asgn) {
+                    iterate_ast(asgn.lhs, collector);
+                });
 
                 if(collector.table_names.empty()) {
                     throw std::system_error{orm_error_code::no_tables_specified};
                 }
 
-                std::stringstream ss;
-                ss << "UPDATE " << streaming_identifier(collector.table_names.begin()->first) << " SET ";
+                pooled_stringstream ss;
+                const std::string& tableName = collector.table_names.begin()->first;
+                ss << "UPDATE "
+                   << streaming_identifier(find_table_schema_name(context.db_objects, tableName),
+                                           tableName,
+                                           std::string{})
+                   << " SET ";
                 {
                     std::vector<std::string> setPairs;
                     setPairs.reserve(std::tuple_size<typename set_t<Args...>::assigns_type>::value);
                     auto leftContext = context;
                     leftContext.skip_table_name = true;
                     iterate_tuple(upd.set.assigns, [&context, &leftContext, &setPairs](auto& asgn) {
-                        std::stringstream sss;
+                        pooled_stringstream sss;
                         sss << serialize(asgn.lhs, leftContext);
                         sss << ' ' << asgn.serialize() << ' ';
                         sss << serialize(asgn.rhs, context);
@@ -1147,8 +1481,8 @@ namespace sqlite_orm {
                     });
                 const size_t columnNamesCount = columnNames.size();
 
-                std::stringstream ss;
-                ss << "INSERT INTO " << streaming_identifier(table.name) << " ";
+                pooled_stringstream ss;
+                ss << "INSERT INTO " << streaming_table_identifier(table) << " ";
                 if(columnNamesCount) {
                     ss << "(" << streaming_identifiers(columnNames) << ")";
                 } else {
@@ -1180,8 +1514,8 @@ namespace sqlite_orm {
             std::string operator()(const statement_type&, const Ctx& context) const {
                 auto& table = pick_table<T>(context.db_objects);
 
-                std::stringstream ss;
-                ss << "INTO " << streaming_identifier(table.name);
+                pooled_stringstream ss;
+                ss << "INTO " << streaming_table_identifier(table);
                 return ss.str();
             }
         };
@@ -1192,7 +1526,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(context.use_parentheses) {
                     ss << '(';
                 }
@@ -1204,13 +1538,28 @@ namespace sqlite_orm {
             }
         };
 
+        /**
+         *  `object<T>()` among `columns()`: all the columns of the table, qualified, in the order they are read.
+         */
+        template<class T>
+        struct statement_serializer<T, std::enable_if_t<is_object_column_v<T>>> {
+            using statement_type = T;
+
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << streaming_table_column_names(pick_table<typename T::type>(context.db_objects), true);
+                return ss.str();
+            }
+        };
+
         template<class T>
         struct statement_serializer<T, std::enable_if_t<polyfill::disjunction_v<is_insert_raw<T>, is_replace_raw<T>>>> {
             using statement_type = T;
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(is_insert_raw_v<T>) {
                     ss << "INSERT";
                 } else {
@@ -1243,8 +1592,8 @@ namespace sqlite_orm {
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
                 auto& table = pick_table<T>(context.db_objects);
-                std::stringstream ss;
-                ss << "DELETE FROM " << streaming_identifier(table.name) << " "
+                pooled_stringstream ss;
+                ss << "DELETE FROM " << streaming_table_identifier(table) << " "
                    << "WHERE ";
                 std::vector<std::string> idsStrings;
                 idsStrings.reserve(std::tuple_size<typename statement_type::ids_type>::value);
@@ -1275,8 +1624,8 @@ namespace sqlite_orm {
                 using object_type = typename expression_object_type<expression_type>::type;
                 auto& table = pick_table<object_type>(context.db_objects);
 
-                std::stringstream ss;
-                ss << "REPLACE INTO " << streaming_identifier(table.name) << " ("
+                pooled_stringstream ss;
+                ss << "REPLACE INTO " << streaming_table_identifier(table) << " ("
                    << streaming_non_generated_column_names(table) << ")";
                 const auto valuesCount = std::distance(rep.range.first, rep.range.second);
                 const auto columnsCount = table.non_generated_columns_count();
@@ -1285,6 +1634,27 @@ namespace sqlite_orm {
             }
         };
 
+#if SQLITE_VERSION_NUMBER >= 3024000
+        template<class It, class L, class O, class U>
+        struct statement_serializer<upsert_range_t<It, L, O, U>, void> {
+            using statement_type = upsert_range_t<It, L, O, U>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                auto& table = pick_table<O>(context.db_objects);
+
+                pooled_stringstream ss;
+                ss << "INSERT INTO " << streaming_table_identifier(table) << " ("
+                   << streaming_non_generated_column_names(table) << ")";
+                const auto valuesCount = std::distance(statement.range.first, statement.range.second);
+                const auto columnsCount = table.non_generated_columns_count();
+                ss << " VALUES " << streaming_values_placeholders(columnsCount, valuesCount) << " "
+                   << serialize(statement.upsert, context);
+                return ss.str();
+            }
+        };
+#endif
+
         template<class It, class L, class O>
         struct statement_serializer<insert_range_t<It, L, O>, void> {
             using statement_type = insert_range_t<It, L, O>;
@@ -1309,8 +1679,12 @@ namespace sqlite_orm {
                 const size_t valuesCount = std::distance(statement.range.first, statement.range.second);
                 const size_t columnNamesCount = columnNames.size();
 
-                std::stringstream ss;
-                ss << "INSERT INTO " << streaming_identifier(table.name) << " ";
+                pooled_stringstream ss;
+                ss << "INSERT ";
+                if(statement.action != conflict_action::abort) {
+                    ss << "OR " << serialize(statement.action, context) << " ";
+                }
+                ss << "INTO " << streaming_table_identifier(table) << " ";
                 if(columnNamesCount) {
                     ss << "(" << streaming_identifiers(columnNames) << ")";
                 } else {
@@ -1326,6 +1700,41 @@ namespace sqlite_orm {
             }
         };
 
+        /**
+         *  Streams the tables of a FROM clause made by a select or get_all, each followed by its
+         *  INDEXED BY or NOT INDEXED hint from `conditions`.
+         */
+        template<class Conditions, class Ctx>
+        void stream_from_tables(std::ostream& ss,
+                                const table_name_collector::table_name_set& tableNames,
+                                const Conditions& conditions,
+                                const Ctx& context) {
+            constexpr std::array<const char*, 2> sep = {", ", ""};
+            bool first = true;
+            for(auto& tableName: tableNames) {
+                ss << sep[std::exchange(first, false)];
+                stream_identifier(ss,
+                                  find_table_schema_name(context.db_objects, tableName.first),
+                                  tableName.first,
+                                  tableName.second);
+                iterate_tuple(conditions, [&ss, &context, &tableName](auto& condition) {
+                    call_if_constexpr<is_indexed_by<std::decay_t<decltype(condition)>>::value>(
+                        [&ss, &context, &tableName](auto& hint) {
+                            using hint_type = std::decay_t<decltype(hint)>;
+                            if(tableName.second.empty() &&
+                               lookup_table_name<typename hint_type::type>(context.db_objects) == tableName.first) {
+                                if(hint.index_name.empty()) {
+                                    ss << " NOT INDEXED";
+                                } else {
+                                    ss << " INDEXED BY " << streaming_identifier(hint.index_name);
+                                }
+                            }
+                        },
+                        condition);
+                });
+            }
+        }
+
         template<class T, class Ctx>
         std::string serialize_get_all_impl(const T& get, const Ctx& context) {
             using primary_type = type_t<T>;
@@ -1335,10 +1744,25 @@ namespace sqlite_orm {
             // note: not collecting table names from get.conditions;
 
             auto& table = pick_table<primary_type>(context.db_objects);
-            std::stringstream ss;
-            ss << "SELECT " << streaming_table_column_names(table, true);
+            pooled_stringstream ss;
+            ss << "SELECT ";
+            bool partial = false;
+            iterate_tuple(get.conditions, [&ss, &context, &partial](auto& condition) {
+                call_if_constexpr<is_only<std::decay_t<decltype(condition)>>::value>(
+                    [&ss, &context, &partial](auto& only) {
+                        auto newContext = context;
+                        newContext.skip_table_name = false;
+                        ss << streaming_expressions_tuple(only.columns, newContext);
+                        partial = true;
+                    },
+                    condition);
+            });
+            if(!partial) {
+                ss << streaming_table_column_names(table, true);
+            }
             if(!collector.table_names.empty()) {
-                ss << " FROM " << streaming_identifiers(collector.table_names);
+                ss << " FROM ";
+                stream_from_tables(ss, collector.table_names, get.conditions, context);
             }
             ss << streaming_conditions_tuple(get.conditions, context);
             return ss.str();
@@ -1380,9 +1804,9 @@ namespace sqlite_orm {
         std::string serialize_get_impl(const T&, const Ctx& context) {
             using primary_type = type_t<T>;
             auto& table = pick_table<primary_type>(context.db_objects);
-            std::stringstream ss;
+            pooled_stringstream ss;
             ss << "SELECT " << streaming_table_column_names(table, false) << " FROM "
-               << streaming_identifier(table.name) << " WHERE ";
+               << streaming_table_identifier(table) << " WHERE ";
 
             auto primaryKeyColumnNames = table.primary_key_column_names();
             if(primaryKeyColumnNames.empty()) {
@@ -1467,7 +1891,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& sel, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 constexpr bool isCompoundOperator = is_base_of_template_v<T, compound_operator>;
                 if(!isCompoundOperator) {
                     if(!sel.highest_level && context.use_parentheses) {
@@ -1496,7 +1920,8 @@ namespace sqlite_orm {
                         collector.table_names.erase(tableNameWithAlias);
                     });
                     if(!collector.table_names.empty() && !isCompoundOperator) {
-                        ss << " FROM " << streaming_identifiers(collector.table_names);
+                        ss << " FROM ";
+                        stream_from_tables(ss, collector.table_names, sel.conditions, context);
                     }
                 }
                 ss << streaming_conditions_tuple(sel.conditions, context);
@@ -1515,7 +1940,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << serialize(statement.column_or_expression, context);
                 if(!statement._collation_name.empty()) {
                     ss << " COLLATE " << statement._collation_name;
@@ -1542,16 +1967,26 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "CREATE ";
                 if(statement.unique) {
                     ss << "UNIQUE ";
                 }
-                using elements_type = typename std::decay_t<decltype(statement)>::elements_type;
-                using head_t = typename std::tuple_element_t<0, elements_type>::column_type;
-                using indexed_type = table_type_of_t<head_t>;
-                ss << "INDEX IF NOT EXISTS " << streaming_identifier(statement.name) << " ON "
-                   << streaming_identifier(lookup_table_name<indexed_type>(context.db_objects));
+                //  the indexed table is the one of the columns, which can be a part of expressions
+                table_name_collector collector([&context](const std::type_index& ti) {
+                    return find_table_name(context.db_objects, ti);
+                });
+                iterate_ast(statement.elements, collector);
+                if(collector.table_names.empty()) {
+                    throw std::system_error{orm_error_code::no_tables_specified};
+                }
+                //  an index of a table in an attached database is qualified with its schema, the table isn't
+                const std::string& tableName = collector.table_names.begin()->first;
+                ss << "INDEX IF NOT EXISTS "
+                   << streaming_identifier(find_table_schema_name(context.db_objects, tableName),
+                                           statement.name,
+                                           std::string{})
+                   << " ON " << streaming_identifier(tableName);
                 std::vector<std::string> columnNames;
                 std::string whereString;
                 iterate_tuple(statement.elements, [&columnNames, &context, &whereString](auto& value) {
@@ -1582,14 +2017,17 @@ namespace sqlite_orm {
             std::string operator()(const statement_type&, const Ctx& context) const {
                 using tuple = std::tuple<Args...>;
 
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "FROM ";
                 iterate_tuple<tuple>([&context, &ss, first = true](auto* item) mutable {
                     using from_type = std::remove_pointer_t<decltype(item)>;
 
+                    using mapped_type = mapped_type_proxy_t<from_type>;
+
                     constexpr std::array<const char*, 2> sep = {", ", ""};
                     ss << sep[std::exchange(first, false)]
-                       << streaming_identifier(lookup_table_name<mapped_type_proxy_t<from_type>>(context.db_objects),
+                       << streaming_identifier(lookup_table_schema_name<mapped_type>(context.db_objects),
+                                               lookup_table_name<mapped_type>(context.db_objects),
                                                alias_extractor<from_type>::get());
                 });
                 return ss.str();
@@ -1602,7 +2040,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "OLD.";
                 auto newContext = context;
                 newContext.skip_table_name = true;
@@ -1617,7 +2055,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "NEW.";
                 auto newContext = context;
                 newContext.skip_table_name = true;
@@ -1691,7 +2129,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
 
                 ss << serialize(statement.timing, context) << " " << serialize(statement.type, context);
                 return ss.str();
@@ -1704,7 +2142,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
 
                 ss << serialize(statement.timing, context) << " UPDATE OF "
                    << streaming_mapped_columns_expressions(statement.columns, context);
@@ -1718,7 +2156,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
 
                 ss << serialize(statement.type_base, context);
                 ss << " ON " << streaming_identifier(lookup_table_name<T>(context.db_objects));
@@ -1738,7 +2176,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << "CREATE ";
 
                 ss << "TRIGGER IF NOT EXISTS " << streaming_identifier(statement.name) << " "
@@ -1767,7 +2205,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << statement.serialize() << " ";
                 auto whereString = serialize(statement.expression, context);
                 ss << '(' << whereString << ')';
@@ -1781,13 +2219,34 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& orderBy, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(orderBy) << " ";
                 ss << serialize_order_by(orderBy, context);
                 return ss.str();
             }
         };
 
+        template<class C>
+        struct statement_serializer<dynamic_where_t<C>, void> {
+            using statement_type = dynamic_where_t<C>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                if(statement.empty()) {
+                    return {};
+                }
+                pooled_stringstream ss;
+                ss << "WHERE ";
+                bool first = true;
+                for(auto& entry: statement) {
+                    constexpr std::array<const char*, 2> sep = {" AND ", ""};
+                    ss << sep[std::exchange(first, false)] << '('
+                       << (context.replace_bindable_with_question ? entry.sql : entry.literal_sql) << ')';
+                }
+                return ss.str();
+            }
+        };
+
         template<class C>
         struct statement_serializer<dynamic_order_by_t<C>, void> {
             using statement_type = dynamic_order_by_t<C>;
@@ -1804,7 +2263,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& orderBy, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(orderBy) << " " << streaming_expressions_tuple(orderBy.args, context);
                 return ss.str();
             }
@@ -1816,9 +2275,11 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(c) << " "
-                   << streaming_identifier(lookup_table_name<O>(context.db_objects));
+                   << streaming_identifier(lookup_table_schema_name<O>(context.db_objects),
+                                           lookup_table_name<O>(context.db_objects),
+                                           std::string{});
                 return ss.str();
             }
         };
@@ -1829,9 +2290,10 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& l, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(l) << " "
-                   << streaming_identifier(lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
+                   << streaming_identifier(lookup_table_schema_name<mapped_type_proxy_t<T>>(context.db_objects),
+                                           lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
                                            alias_extractor<T>::get())
                    << serialize(l.constraint, context);
                 return ss.str();
@@ -1844,7 +2306,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& t, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto newContext = context;
                 newContext.skip_table_name = false;
                 ss << static_cast<std::string>(t) << " " << serialize(t.arg, newContext) << " ";
@@ -1858,9 +2320,10 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& l, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(l) << " "
-                   << streaming_identifier(lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
+                   << streaming_identifier(lookup_table_schema_name<mapped_type_proxy_t<T>>(context.db_objects),
+                                           lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
                                            alias_extractor<T>::get())
                    << " " << serialize(l.constraint, context);
                 return ss.str();
@@ -1873,9 +2336,10 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& l, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(l) << " "
-                   << streaming_identifier(lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
+                   << streaming_identifier(lookup_table_schema_name<mapped_type_proxy_t<T>>(context.db_objects),
+                                           lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
                                            alias_extractor<T>::get())
                    << " " << serialize(l.constraint, context);
                 return ss.str();
@@ -1888,9 +2352,10 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& l, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(l) << " "
-                   << streaming_identifier(lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
+                   << streaming_identifier(lookup_table_schema_name<mapped_type_proxy_t<T>>(context.db_objects),
+                                           lookup_table_name<mapped_type_proxy_t<T>>(context.db_objects),
                                            alias_extractor<T>::get())
                    << " " << serialize(l.constraint, context);
                 return ss.str();
@@ -1903,9 +2368,11 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& c, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(c) << " "
-                   << streaming_identifier(lookup_table_name<O>(context.db_objects));
+                   << streaming_identifier(lookup_table_schema_name<O>(context.db_objects),
+                                           lookup_table_name<O>(context.db_objects),
+                                           std::string{});
                 return ss.str();
             }
         };
@@ -1916,7 +2383,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto newContext = context;
                 newContext.skip_table_name = false;
                 ss << "GROUP BY " << streaming_expressions_tuple(statement.args, newContext) << " HAVING "
@@ -1931,7 +2398,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto newContext = context;
                 newContext.skip_table_name = false;
                 ss << "GROUP BY " << streaming_expressions_tuple(statement.args, newContext);
@@ -1945,7 +2412,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 auto newContext = context;
                 newContext.skip_table_name = false;
                 ss << "HAVING " << serialize(statement.expression, newContext);
@@ -1953,6 +2420,68 @@ namespace sqlite_orm {
             }
         };
 
+        template<class T>
+        struct statement_serializer<indexed_by_t<T>, void> {
+            using statement_type = indexed_by_t<T>;
+
+            //  the hint is serialized by the FROM clause
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx&) const {
+                return {};
+            }
+        };
+
+        template<class... Cols>
+        struct statement_serializer<only_t<Cols...>, void> {
+            using statement_type = only_t<Cols...>;
+
+            //  the columns are serialized by the SELECT of `get_all`
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx&) const {
+                return {};
+            }
+        };
+
+        template<>
+        struct statement_serializer<reserve_t, void> {
+            using statement_type = reserve_t;
+
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx&) const {
+                return {};
+            }
+        };
+
+        template<>
+        struct statement_serializer<cached_t, void> {
+            using statement_type = cached_t;
+
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx&) const {
+                return {};
+            }
+        };
+
+        template<>
+        struct statement_serializer<prefetch_t, void> {
+            using statement_type = prefetch_t;
+
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx&) const {
+                return {};
+            }
+        };
+
+        template<>
+        struct statement_serializer<exec_options, void> {
+            using statement_type = exec_options;
+
+            template<class Ctx>
+            std::string operator()(const statement_type&, const Ctx&) const {
+                return {};
+            }
+        };
+
         /**
          *  HO - has offset
          *  OI - offset is implicit
@@ -1965,7 +2494,7 @@ namespace sqlite_orm {
             std::string operator()(const statement_type& limt, const Ctx& context) const {
                 auto newContext = context;
                 newContext.skip_table_name = false;
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << static_cast<std::string>(limt) << " ";
                 if(HO) {
                     if(OI) {
@@ -2009,13 +2538,25 @@ namespace sqlite_orm {
             }
         };
 
+        template<class... Args>
+        struct statement_serializer<row_value_t<Args...>, void> {
+            using statement_type = row_value_t<Args...>;
+
+            template<class Ctx>
+            std::string operator()(const statement_type& statement, const Ctx& context) const {
+                pooled_stringstream ss;
+                ss << '(' << streaming_expressions_tuple(statement.args, context) << ')';
+                return ss.str();
+            }
+        };
+
         template<class... Args>
         struct statement_serializer<std::tuple<Args...>, void> {
             using statement_type = std::tuple<Args...>;
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 ss << '(' << streaming_expressions_tuple(statement, context) << ')';
                 return ss.str();
             }
@@ -2027,7 +2568,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(context.use_parentheses) {
                     ss << '(';
                 }
@@ -2045,7 +2586,7 @@ namespace sqlite_orm {
 
             template<class Ctx>
             std::string operator()(const statement_type& statement, const Ctx& context) const {
-                std::stringstream ss;
+                pooled_stringstream ss;
                 if(context.use_parentheses) {
                     ss << '(';
                 }
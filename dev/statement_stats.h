@@ -0,0 +1,59 @@
+#pragma once
+
+#include <sqlite3.h>
+
+namespace sqlite_orm {
+
+    /**
+     *  Counters of a prepared statement read with `sqlite3_stmt_status`.
+     *  Counters that the linked SQLite version doesn't provide stay zero.
+     */
+    struct statement_stats {
+        int fullscan_steps = 0;
+        int sorts = 0;
+        int autoindexes = 0;
+        int vm_steps = 0;
+        int reprepares = 0;
+        int runs = 0;
+        int memory_used = 0;
+
+        /**
+         *  Accumulates counters of another run of the same statement. `memory_used` is not a counter
+         *  so the latest value is kept.
+         */
+        statement_stats& operator+=(const statement_stats& other) {
+            this->fullscan_steps += other.fullscan_steps;
+            this->sorts += other.sorts;
+            this->autoindexes += other.autoindexes;
+            this->vm_steps += other.vm_steps;
+            this->reprepares += other.reprepares;
+            this->runs += other.runs;
+            this->memory_used = other.memory_used;
+            return *this;
+        }
+    };
+
+    namespace internal {
+
+        /**
+         *  Reads counters of `stmt`. If `reset` is true the counters are reset to zero afterwards
+         *  (except `memory_used` which can't be reset).
+         */
+        inline statement_stats get_statement_stats(sqlite3_stmt* stmt, bool reset) {
+            const int resetFlag = reset ? 1 : 0;
+            statement_stats result;
+            result.fullscan_steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, resetFlag);
+            result.sorts = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, resetFlag);
+            result.autoindexes = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, resetFlag);
+#if SQLITE_VERSION_NUMBER >= 3010000
+            result.vm_steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, resetFlag);
+#endif
+#if SQLITE_VERSION_NUMBER >= 3020000
+            result.reprepares = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_REPREPARE, resetFlag);
+            result.runs = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_RUN, resetFlag);
+            result.memory_used = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_MEMUSED, 0);
+#endif
+            return result;
+        }
+    }
+}
@@ -5,14 +5,26 @@
 #include <system_error>  //  std::system_error
 #include <string>  //  std::string
 #include <type_traits>  //  std::remove_reference, std::is_base_of, std::decay, std::false_type, std::true_type
-#include <functional>  //   std::identity
+#include <functional>  //   std::identity, std::reference_wrapper, std::cref
 #include <sstream>  //  std::stringstream
 #include <map>  //  std::map
+#include <set>  //  std::set
+#include <unordered_map>  //  std::unordered_map
+#include <typeindex>  //  std::type_index
+#include <typeinfo>  //  typeid
 #include <vector>  //  std::vector
 #include <tuple>  //  std::tuple_size, std::tuple, std::make_tuple, std::tie
-#include <utility>  //  std::forward, std::pair
-#include <algorithm>  //  std::for_each, std::ranges::for_each
+#include <utility>  //  std::forward, std::pair, std::exchange
+#include <algorithm>  //  std::for_each, std::ranges::for_each, std::transform, std::find, std::stable_sort
+#include <cctype>  //  std::toupper
+#include <array>  //  std::array
+#include <chrono>  //  std::chrono::milliseconds
+#include <cstdint>  //  std::uint32_t
+#include <future>  //  std::async, std::future
+#include <limits>  //  std::numeric_limits
+#include <iterator>  //  std::iterator_traits, std::forward_iterator_tag, std::distance
 #include "functional/cxx_optional.h"
+#include "functional/cxx_memory_resource.h"
 
 #include "functional/cxx_universal.h"
 #include "functional/cxx_functional_polyfill.h"
@@ -24,6 +36,7 @@
 #include "type_traits.h"
 #include "alias.h"
 #include "row_extractor_builder.h"
+#include "object_columns_extractor.h"
 #include "error_code.h"
 #include "type_printer.h"
 #include "constraints.h"
@@ -52,7 +65,43 @@
 #include "column.h"
 #include "index.h"
 #include "util.h"
+#include "result.h"
 #include "serializing_util.h"
+#include "pooled_stringstream.h"
+#include "write_batcher.h"
+#include "write_behind.h"
+#include "blob.h"
+#include "query_plan.h"
+#include "materialized_view.h"
+#include "object_cache.h"
+#include "query_cache.h"
+#include "table_name_collector.h"
+#include "bulk_load_options.h"
+#include "join_iterator.h"
+#include "memory_resource_scope.h"
+#include "keyset_pager.h"
+#include "kv_store.h"
+#include "job_queue.h"
+#include "counter_table.h"
+#include "table_json.h"
+#include "pipeline.h"
+#include "sql_shape.h"
+#include "row_generator.h"
+#include "sharded_storage.h"
+#include "partitioned_storage.h"
+#include "replicated_storage.h"
+#include "tenant_storage_manager.h"
+#include "readonly_storage.h"
+#include "columnar.h"
+#include "arrow.h"
+#include "csv_reader.h"
+#include "compressed.h"
+#include "fts5.h"
+#include "rtree.h"
+#include "virtual_table.h"
+#include "generate_series.h"
+#include "span_table.h"
+#include "temp_table.h"
 
 namespace sqlite_orm {
 
@@ -65,6 +114,350 @@ namespace sqlite_orm {
         SQLITE_ORM_INLINE_VAR constexpr bool
             is_preparable_v<S, E, polyfill::void_t<decltype(std::declval<S>().prepare(std::declval<E>()))>> = true;
 
+        /**
+         *  Compares two field values. Smart pointers are compared by the values they point to.
+         */
+        template<class T>
+        bool is_field_equal(const T& lhs, const T& rhs) {
+            return lhs == rhs;
+        }
+
+        template<class T, class D>
+        bool is_field_equal(const std::unique_ptr<T, D>& lhs, const std::unique_ptr<T, D>& rhs) {
+            return lhs && rhs ? *lhs == *rhs : !lhs && !rhs;
+        }
+
+        template<class T>
+        bool is_field_equal(const std::shared_ptr<T>& lhs, const std::shared_ptr<T>& rhs) {
+            return lhs && rhs ? *lhs == *rhs : !lhs && !rhs;
+        }
+
+        /**
+         *  Whether the projection of the range statement E returns references to objects outliving the statement
+         *  rather than temporaries.
+         */
+        template<class E>
+        SQLITE_ORM_INLINE_VAR constexpr bool projects_lasting_objects_v = std::is_lvalue_reference<
+            decltype(polyfill::invoke(std::declval<const typename E::transformer_type&>(),
+                                      *std::declval<typename E::iterator_type>()))>::value;
+
+        /**
+         *  Calls `f` with every object of the range statement `expression`, in order, all of them alive until the
+         *  step of the statement so that strings and blobs bind without a copy.
+         *  Objects projected by reference are passed as they are. Temporaries are moved into a buffer first: this
+         *  costs a move per object instead of a copy of each of their strings and blobs by SQLite.
+         */
+        template<class E, class F, std::enable_if_t<projects_lasting_objects_v<E>, bool> = true>
+        void for_each_range_object(const E& expression, F& f) {
+#if __cpp_lib_ranges >= 201911L
+            std::ranges::for_each(expression.range.first,
+                                  expression.range.second,
+                                  std::ref(f),
+                                  std::ref(expression.transformer));
+#else
+            using object_type = typename expression_object_type<E>::type;
+            auto& transformer = expression.transformer;
+            std::for_each(expression.range.first, expression.range.second, [&f, &transformer](auto& item) {
+                const object_type& object = polyfill::invoke(transformer, item);
+                f(object);
+            });
+#endif
+        }
+
+        template<class E, class F, std::enable_if_t<!projects_lasting_objects_v<E>, bool> = true>
+        void for_each_range_object(const E& expression, F& f) {
+            using object_type = typename expression_object_type<E>::type;
+            using iterator_category = typename std::iterator_traits<typename E::iterator_type>::iterator_category;
+            std::vector<object_type> objects;
+            static_if<std::is_base_of<std::forward_iterator_tag, iterator_category>::value>([&objects, &expression] {
+                objects.reserve(size_t(std::distance(expression.range.first, expression.range.second)));
+            })();
+            for(auto it = expression.range.first; it != expression.range.second; ++it) {
+                objects.emplace_back(polyfill::invoke(expression.transformer, *it));
+            }
+            for(const object_type& object: objects) {
+                f(object);
+            }
+        }
+
+        template<class T>
+        int bind_planned_value(sqlite3_stmt* stmt, int index, const void* value, bound_parameter& bound) {
+            return bind_if_changed(stmt, index, *static_cast<const T*>(value), bound);
+        }
+
+        /**
+         *  Makes the `binding_plan` of the nodes of an expression stored in [expressionBegin, expressionEnd).
+         */
+        struct binding_plan_builder {
+            binding_plan& plan;
+            const char* const expressionBegin;
+            const char* const expressionEnd;
+
+            template<class E>
+            binding_plan_builder(binding_plan& plan, const E& expression) :
+                plan{plan}, expressionBegin{reinterpret_cast<const char*>(&expression)},
+                expressionEnd{reinterpret_cast<const char*>(&expression) + sizeof(E)} {}
+
+            template<class T, satisfies<is_bindable, T> = true>
+            void operator()(const T& t) {
+                const auto address = reinterpret_cast<const char*>(&t);
+                if(!std::less_equal<const char*>{}(this->expressionBegin, address) ||
+                   !std::less<const char*>{}(address, this->expressionEnd)) {
+                    this->plan.usable = false;
+                }
+                this->plan.steps.push_back({&t, bind_planned_value<T>});
+            }
+
+            template<class T, satisfies_not<is_bindable, T> = true>
+            void operator()(const T&) const {}
+        };
+
+        /**
+         *  Binds the parameters in `nodes` of `statement` except the ones that still have the value which they
+         *  were bound with, see `prepared_statement_base::boundParameters`.
+         *  The second time, the nodes are iterated to make the binding plan of the statement: afterwards binding
+         *  is a loop over the plan, however deep the expression is. Statements with parameters that aren't
+         *  stored in the expression iterate the nodes every time.
+         */
+        template<class S, class E>
+        void bind_changed_parameters(const prepared_statement_t<S>& statement, const E& nodes) {
+            auto& plan = statement.bindingPlan;
+            if(plan.nodes != &nodes || plan.nodesType != statement_type_key<E>()) {
+                plan.nodes = &nodes;
+                plan.nodesType = statement_type_key<E>();
+                plan.made = false;
+                plan.usable = false;
+                plan.steps.clear();
+            } else if(!plan.made) {
+                plan.made = true;
+                plan.usable = true;
+                iterate_ast(nodes, binding_plan_builder{plan, statement.expression});
+            }
+            auto& bound = statement.boundParameters;
+            if(!plan.usable) {
+                iterate_ast(nodes, changed_parameters_binder{statement.stmt, bound, statement.expression});
+                return;
+            }
+            if(bound.size() < plan.steps.size()) {
+                bound.resize(plan.steps.size());
+            }
+            for(size_t i = 0; i < plan.steps.size(); ++i) {
+                auto& step = plan.steps[i];
+                if(SQLITE_OK != step.bind(statement.stmt, int(i + 1), step.value, bound[i])) {
+                    throw_translated_sqlite_error(statement.stmt);
+                }
+            }
+        }
+
+        /**
+         *  Statements that `storage_t::execute_batch()` runs once per parameter set.
+         */
+        template<class S>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_batch_statement_v =
+            polyfill::disjunction_v<polyfill::is_specialization_of<S, update_all_t>,
+                                    polyfill::is_specialization_of<S, remove_all_t>,
+                                    polyfill::is_specialization_of<S, insert_raw_t>,
+                                    polyfill::is_specialization_of<S, replace_raw_t>>;
+
+        /**
+         *  Whether a statement of type S is executed by a single step, whose failure `try_execute()` returns.
+         */
+        template<class S>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_single_step_statement_v =
+            is_batch_statement_v<S> || polyfill::disjunction_v<polyfill::is_specialization_of<S, insert_t>,
+                                                               polyfill::is_specialization_of<S, insert_range_t>,
+                                                               polyfill::is_specialization_of<S, insert_explicit>,
+                                                               polyfill::is_specialization_of<S, replace_t>,
+                                                               polyfill::is_specialization_of<S, replace_range_t>,
+                                                               polyfill::is_specialization_of<S, update_t>,
+                                                               polyfill::is_specialization_of<S, remove_t>,
+                                                               polyfill::is_specialization_of<S, get_pointer_t>>;
+
+        template<class R, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_reservable_v = false;
+
+        template<class R>
+        SQLITE_ORM_INLINE_VAR constexpr bool
+            is_reservable_v<R, polyfill::void_t<decltype(std::declval<R&>().reserve(size_t{}))>> = true;
+
+        /**
+         *  Whether the result columns of T fit the rows Out of a `select_into()` buffer: a tuple-like row needs as
+         *  many elements as `columns()` has columns.
+         */
+        template<class T, class Out, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool fits_flat_row_v = true;
+
+        template<class... Cols, class Out>
+        SQLITE_ORM_INLINE_VAR constexpr bool
+            fits_flat_row_v<columns_t<Cols...>, Out, std::enable_if_t<is_tuple_like_v<Out>>> =
+                std::tuple_size<Out>::value == sizeof...(Cols);
+
+        template<class R, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_emplaceable_v = false;
+
+        template<class R>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_emplaceable_v<
+            R,
+            polyfill::void_t<decltype(std::declval<R&>().emplace_back()), decltype(std::declval<R&>().back())>> = true;
+
+        template<class C, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_map_container_v = false;
+
+        template<class C>
+        SQLITE_ORM_INLINE_VAR constexpr bool
+            is_map_container_v<C, polyfill::void_t<typename C::key_type, typename C::mapped_type>> = true;
+
+        template<class C, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_sequence_container_v = false;
+
+        template<class C>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_sequence_container_v<
+            C,
+            polyfill::void_t<decltype(std::declval<C&>().push_back(std::declval<typename C::value_type>()))>> = true;
+
+        /**
+         *  Type of the rows `select_into()` reads into a container C: a tuple of the key and the mapped value for
+         *  maps, the value type otherwise.
+         */
+        template<class C, class SFINAE = void>
+        struct container_row {
+            using type = typename C::value_type;
+        };
+
+        template<class C>
+        struct container_row<C, std::enable_if_t<is_map_container_v<C>>> {
+            using type = std::tuple<typename C::key_type, typename C::mapped_type>;
+        };
+
+        template<class C>
+        using container_row_t = typename container_row<C>::type;
+
+        /**
+         *  Adds a row to a container: at the end of sequences, by key into sets and maps, where a key already in
+         *  the container keeps its element like with `insert()`.
+         */
+        template<class C, class R, std::enable_if_t<is_map_container_v<C>, bool> = true>
+        void insert_row(C& container, R&& row) {
+            container.emplace(std::get<0>(std::move(row)), std::get<1>(std::move(row)));
+        }
+
+        template<class C, class R, std::enable_if_t<!is_map_container_v<C> && is_sequence_container_v<C>, bool> = true>
+        void insert_row(C& container, R&& row) {
+            container.push_back(std::forward<R>(row));
+        }
+
+        template<class C, class R, std::enable_if_t<!is_map_container_v<C> && !is_sequence_container_v<C>, bool> = true>
+        void insert_row(C& container, R&& row) {
+            container.insert(std::forward<R>(row));
+        }
+
+        /**
+         *  Appends the object of type O read from the current row of `stmt` to the `get_all` result `res` with
+         *  `conditions`. A default constructible object is emplaced at the end of containers having `emplace_back()`
+         *  and filled there, otherwise it is filled on the stack and moved in, e.g. into a set. Other objects are made by
+         *  `object_factory<O>` from all their columns, which means `only()` doesn't apply to them.
+         */
+        template<class O,
+                 class R,
+                 class Table,
+                 class Conditions,
+                 std::enable_if_t<std::is_default_constructible<O>::value && is_emplaceable_v<R>, bool> = true>
+        void append_object(R& res,
+                           sqlite3_stmt* stmt,
+                           const Table& table,
+                           const Conditions& conditions,
+                           const std::shared_ptr<const lazy_source>& lazySource) {
+            res.emplace_back();
+            try {
+                build_object(res.back(), stmt, table, conditions, lazySource);
+            } catch(...) {
+                res.pop_back();
+                throw;
+            }
+        }
+
+        template<class O,
+                 class R,
+                 class Table,
+                 class Conditions,
+                 std::enable_if_t<std::is_default_constructible<O>::value && !is_emplaceable_v<R>, bool> = true>
+        void append_object(R& res,
+                           sqlite3_stmt* stmt,
+                           const Table& table,
+                           const Conditions& conditions,
+                           const std::shared_ptr<const lazy_source>& lazySource) {
+            O obj;
+            build_object(obj, stmt, table, conditions, lazySource);
+            insert_row(res, std::move(obj));
+        }
+
+        template<class O,
+                 class R,
+                 class Table,
+                 class Conditions,
+                 std::enable_if_t<!std::is_default_constructible<O>::value, bool> = true>
+        void append_object(R& res,
+                           sqlite3_stmt* stmt,
+                           const Table& table,
+                           const Conditions&,
+                           const std::shared_ptr<const lazy_source>&) {
+            static_assert(!tuple_has<is_only, Conditions>::value,
+                          "only() needs objects which are default constructible");
+            insert_row(res, make_object<O>(stmt, table));
+        }
+
+        /**
+         *  The `exec_options` among the conditions of a query, null if there are none.
+         */
+        template<class Conditions>
+        const exec_options* find_exec_options(const Conditions& conditions) {
+            const exec_options* res = nullptr;
+            iterate_tuple(conditions, [&res](auto& condition) {
+                call_if_constexpr<is_exec_options<std::decay_t<decltype(condition)>>::value>(
+                    [&res](auto& options) {
+                        res = &options;
+                    },
+                    condition);
+            });
+            return res;
+        }
+
+        /**
+         *  Number of primary key columns a key of `remove_range()` and `get_range()` holds the values of.
+         */
+        template<class K>
+        struct key_columns_count : std::integral_constant<size_t, 1> {};
+
+        template<class... Ks>
+        struct key_columns_count<std::tuple<Ks...>> : std::integral_constant<size_t, sizeof...(Ks)> {};
+
+        template<class K>
+        void bind_key(conditional_binder& binder, const K& key) {
+            binder(key);
+        }
+
+        template<class... Ks>
+        void bind_key(conditional_binder& binder, const std::tuple<Ks...>& key) {
+            iterate_tuple(key, binder);
+        }
+
+        /**
+         *  Reserves capacity in a `get_all` result if the conditions contain a `reserve_t` hint
+         *  and the container supports it.
+         */
+        template<class R, class Conditions>
+        void reserve_result(R& res, const Conditions& conditions) {
+            iterate_tuple(conditions, [&res](auto& c) {
+                using condition_type = std::decay_t<decltype(c)>;
+                call_if_constexpr<is_reservable_v<R> && is_reserve<condition_type>::value>(
+                    [](auto& container, auto& hint) {
+                        container.reserve(hint.capacity);
+                    },
+                    res,
+                    c);
+            });
+        }
+
         /**
          *  Storage class itself. Create an instanse to use it as an interfacto to sqlite db by calling `make_storage`
          *  function.
@@ -79,10 +472,128 @@ namespace sqlite_orm {
              *  @param dbObjects db_objects_tuple
              */
             storage_t(std::string filename, db_objects_type dbObjects) :
-                storage_base{move(filename), foreign_keys_count(dbObjects)}, db_objects{std::move(dbObjects)} {}
+                storage_base{move(filename), foreign_keys_count(dbObjects)},
+                sharedDbObjects{std::make_shared<db_objects_type>(std::move(dbObjects))},
+                db_objects{*this->sharedDbObjects} {
+                this->create_virtual_table_modules();
+            }
+
+            /**
+             *  @param poolOptions options of the connection pool.
+             *  @param filename database filename.
+             *  @param dbObjects db_objects_tuple
+             */
+            storage_t(const pool_options& poolOptions, std::string filename, db_objects_type dbObjects) :
+                storage_base{poolOptions, move(filename), foreign_keys_count(dbObjects)},
+                sharedDbObjects{std::make_shared<db_objects_type>(std::move(dbObjects))},
+                db_objects{*this->sharedDbObjects} {
+                this->create_virtual_table_modules();
+            }
+
+            /**
+             *  @param openOptions flags and URI parameters every connection is opened with.
+             */
+            storage_t(const open_options& openOptions, std::string filename, db_objects_type dbObjects) :
+                storage_base{move(filename), foreign_keys_count(dbObjects), openOptions},
+                sharedDbObjects{std::make_shared<db_objects_type>(std::move(dbObjects))},
+                db_objects{*this->sharedDbObjects} {
+                this->create_virtual_table_modules();
+            }
+
+            storage_t(const pool_options& poolOptions,
+                      const open_options& openOptions,
+                      std::string filename,
+                      db_objects_type dbObjects) :
+                storage_base{poolOptions, move(filename), foreign_keys_count(dbObjects), openOptions},
+                sharedDbObjects{std::make_shared<db_objects_type>(std::move(dbObjects))},
+                db_objects{*this->sharedDbObjects} {
+                this->create_virtual_table_modules();
+            }
+
+            /**
+             *  @param profile pragmas applied to every connection, see `apply_performance_profile()`.
+             *  @param filename database filename.
+             *  @param dbObjects db_objects_tuple
+             */
+            storage_t(const performance_profile& profile, std::string filename, db_objects_type dbObjects) :
+                storage_t{move(filename), std::move(dbObjects)} {
+                this->apply_performance_profile(profile);
+            }
+
+            /**
+             *  @param poolOptions options of the connection pool.
+             *  @param profile pragmas applied to every connection, see `apply_performance_profile()`.
+             *  @param filename database filename.
+             *  @param dbObjects db_objects_tuple
+             */
+            storage_t(const pool_options& poolOptions,
+                      const performance_profile& profile,
+                      std::string filename,
+                      db_objects_type dbObjects) :
+                storage_t{poolOptions, move(filename), std::move(dbObjects)} {
+                this->apply_performance_profile(profile);
+            }
+
+            /**
+             *  A handle for another thread: a storage with a connection of its own, opened with `openOptions`,
+             *  e.g. with `no_mutex` because only that thread uses it. The schema and the registered functions,
+             *  collations and modules of this storage are shared instead of copied. The fork of a pooled storage
+             *  has a single connection, the fork of an in-memory storage opens a new empty database.
+             *  Let the fork register its own functions rather than registering them here while forks are made.
+             *  Example: std::thread worker{[fork = storage.fork()]() mutable {
+             *               fork.insert(User{...});
+             *           }};
+             */
+            self fork(const open_options& openOptions) const {
+                return self{*this, openOptions};
+            }
+
+            self fork() const {
+                return this->fork(this->connection->options);
+            }
+
+            /**
+             *  A fork on another database file with the same schema, e.g. of one tenant of many with identical
+             *  schema. See `make_tenant_storage_manager()`.
+             */
+            self fork(std::string filename, const open_options& openOptions) const {
+                return self{*this, move(filename), openOptions};
+            }
+
+            /**
+             *  A copy has a schema of its own, unlike a fork.
+             */
+            storage_t(const self& other) :
+                storage_base{other}, sharedDbObjects{std::make_shared<db_objects_type>(other.db_objects)},
+                db_objects{*this->sharedDbObjects} {}
+
+            ~storage_t() {
+                //  queued async calls use the schema, which is destroyed before `~storage_base()` runs
+                this->executor.reset();
+            }
 
           private:
-            db_objects_type db_objects;
+            template<class S>
+            friend struct tenant_storage_manager;
+
+            storage_t(const self& other, const open_options& openOptions) :
+                storage_t{other, other.connection->filename, openOptions} {}
+
+            storage_t(const self& other, std::string filename, const open_options& openOptions) :
+                storage_base{other, move(filename), openOptions}, sharedDbObjects{other.sharedDbObjects},
+                db_objects{other.db_objects} {}
+
+            //  shared with forks
+            std::shared_ptr<db_objects_type> sharedDbObjects;
+            db_objects_type& db_objects;
+
+            void create_virtual_table_modules() {
+                iterate_tuple<true>(this->db_objects, tables_index_sequence<db_objects_type>{}, [this](auto& table) {
+                    if(table.virtual_module) {
+                        this->create_module(table.name, table.virtual_module);
+                    }
+                });
+            }
 
             /**
              *  Obtain a storage_t's const db_objects_tuple.
@@ -101,19 +612,200 @@ namespace sqlite_orm {
             }
 
             template<class Table>
-            void create_table(sqlite3* db, const std::string& tableName, const Table& table) {
+            std::string create_table_sql(const std::string& tableName, const Table& table) const {
                 using table_type = std::decay_t<decltype(table)>;
                 using context_t = serializer_context<db_objects_type>;
 
                 std::stringstream ss;
+                if(table.fts5 || table.rtree) {
+                    ss << "CREATE VIRTUAL TABLE " << streaming_identifier(table.schema_name, tableName, std::string{})
+                       << " USING " << this->virtual_table_module_sql(table) << std::flush;
+                    return ss.str();
+                }
                 context_t context{this->db_objects};
-                ss << "CREATE TABLE " << streaming_identifier(tableName) << " ( "
+                ss << "CREATE TABLE " << streaming_identifier(table.schema_name, tableName, std::string{}) << " ( "
                    << streaming_expressions_tuple(table.elements, context) << ")";
+                if(table.is_strict) {
+                    ss << " STRICT";
+                }
                 if(table_type::is_without_rowid_v) {
-                    ss << " WITHOUT ROWID";
+                    ss << (table.is_strict ? ", WITHOUT ROWID" : " WITHOUT ROWID");
                 }
                 ss.flush();
-                perform_void_exec(db, ss.str());
+                return ss.str();
+            }
+
+            template<class Table>
+            void create_table(sqlite3* db, const std::string& tableName, const Table& table) {
+                perform_void_exec(db, this->create_table_sql(tableName, table));
+                this->schemaCache.invalidate();
+            }
+
+            /**
+             *  The module name and arguments of the FTS5 table `table`, which `CREATE VIRTUAL TABLE` ends with.
+             */
+            template<class Table>
+            std::string fts5_module_sql(const Table& table) const {
+                auto& options = *table.fts5;
+                std::stringstream ss;
+                ss << "fts5(";
+                bool first = true;
+                for(auto& columnName: fts5_column_names(table)) {
+                    ss << (first ? "" : ", ") << streaming_identifier(columnName);
+                    if(std::find(options.unindexed.begin(), options.unindexed.end(), columnName) !=
+                       options.unindexed.end()) {
+                        ss << " UNINDEXED";
+                    }
+                    first = false;
+                }
+                if(options.contentless) {
+                    ss << ", content=''";
+                } else if(!options.content.empty()) {
+                    ss << ", content=" << quote_string_literal(options.content);
+                }
+                if(!options.content_rowid.empty()) {
+                    ss << ", content_rowid=" << quote_string_literal(options.content_rowid);
+                }
+                if(!options.tokenize.empty()) {
+                    ss << ", tokenize=" << quote_string_literal(options.tokenize);
+                }
+                if(!options.prefix.empty()) {
+                    ss << ", prefix=" << quote_string_literal(options.prefix);
+                }
+                if(!options.detail.empty()) {
+                    ss << ", detail=" << quote_string_literal(options.detail);
+                }
+                ss << ")" << std::flush;
+                return ss.str();
+            }
+
+            /**
+             *  The module name and arguments of the R*Tree table `table`: the id, the coordinates and the
+             *  auxiliary columns.
+             */
+            template<class Table>
+            std::string rtree_module_sql(const Table& table) const {
+                auto& options = *table.rtree;
+                std::stringstream ss;
+                ss << (options.integer_coordinates ? "rtree_i32(" : "rtree(");
+                bool first = true;
+                table.for_each_column([&ss, &options, &first](auto& column) {
+                    ss << (first ? "" : ", ");
+                    if(std::find(options.auxiliary.begin(), options.auxiliary.end(), column.name) !=
+                       options.auxiliary.end()) {
+                        ss << "+";
+                    }
+                    ss << streaming_identifier(column.name);
+                    first = false;
+                });
+                ss << ")" << std::flush;
+                return ss.str();
+            }
+
+            template<class Table>
+            std::string virtual_table_module_sql(const Table& table) const {
+                return table.fts5 ? this->fts5_module_sql(table) : this->rtree_module_sql(table);
+            }
+
+            /**
+             *  A virtual table is in sync if the statement it was created by ends with the mapped module arguments,
+             *  otherwise it has to be created again since virtual tables can't be altered.
+             */
+            template<class Table>
+            sync_schema_result
+            virtual_table_status(sqlite3* db, const Table& table, const schema_snapshot& snapshot) {
+                auto sql = this->schema_sql(db, "table", table.name, table.schema_name, snapshot);
+                if(sql.empty()) {
+                    return sync_schema_result::new_table_created;
+                }
+                auto moduleSql = this->virtual_table_module_sql(table);
+                if(sql.size() < moduleSql.size() ||
+                   sql.compare(sql.size() - moduleSql.size(), moduleSql.size(), moduleSql) != 0) {
+                    return sync_schema_result::dropped_and_recreated;
+                }
+                return sync_schema_result::already_in_sync;
+            }
+
+            /**
+             *  Creates the triggers which update the index of the external content FTS5 table `table` after
+             *  the rows of its content table are inserted, deleted or updated, dropping existing ones first
+             *  if `recreate`.
+             */
+            template<class Table>
+            void create_fts5_triggers(sqlite3* db, const Table& table, bool recreate) {
+                auto& options = *table.fts5;
+                auto columnNames = fts5_column_names(table);
+                const std::string contentRowid = options.content_rowid.empty() ? "rowid" : options.content_rowid;
+                auto values = [&columnNames, &contentRowid](const char* row) {
+                    std::stringstream ss;
+                    ss << row << "." << streaming_identifier(contentRowid);
+                    for(auto& columnName: columnNames) {
+                        ss << ", " << row << "." << streaming_identifier(columnName);
+                    }
+                    ss.flush();
+                    return ss.str();
+                };
+                std::stringstream insertSs;
+                insertSs << " INSERT INTO " << streaming_identifier(table.name) << " (\"rowid\"";
+                for(auto& columnName: columnNames) {
+                    insertSs << ", " << streaming_identifier(columnName);
+                }
+                insertSs << ") VALUES (" << values("NEW") << ");" << std::flush;
+                std::stringstream deleteSs;
+                deleteSs << " INSERT INTO " << streaming_identifier(table.name) << " ("
+                         << streaming_identifier(table.name) << ", \"rowid\"";
+                for(auto& columnName: columnNames) {
+                    deleteSs << ", " << streaming_identifier(columnName);
+                }
+                deleteSs << ") VALUES ('delete', " << values("OLD") << ");" << std::flush;
+
+                const std::pair<const char*, const char*> events[] = {{"ai", "INSERT"},
+                                                                      {"ad", "DELETE"},
+                                                                      {"au", "UPDATE"}};
+                for(auto& event: events) {
+                    auto triggerName = table.name + "_" + event.first;
+                    if(recreate) {
+                        std::stringstream ss;
+                        ss << "DROP TRIGGER IF EXISTS "
+                           << streaming_identifier(table.schema_name, triggerName, std::string{}) << std::flush;
+                        perform_void_exec(db, ss.str());
+                    }
+                    std::stringstream ss;
+                    ss << "CREATE TRIGGER IF NOT EXISTS "
+                       << streaming_identifier(table.schema_name, triggerName, std::string{}) << " AFTER "
+                       << event.second << " ON " << streaming_identifier(options.content) << " BEGIN";
+                    if(event.second != events[0].second) {
+                        ss << deleteSs.str();
+                    }
+                    if(event.second != events[1].second) {
+                        ss << insertSs.str();
+                    }
+                    ss << " END" << std::flush;
+                    perform_void_exec(db, ss.str());
+                }
+            }
+
+            template<class Table>
+            sync_schema_result sync_virtual_table(sqlite3* db, const Table& table, const schema_snapshot& snapshot) {
+                auto res = this->virtual_table_status(db, table, snapshot);
+                if(res == sync_schema_result::dropped_and_recreated) {
+                    this->drop_table_internal(db, table.name, table.schema_name);
+                }
+                if(res != sync_schema_result::already_in_sync) {
+                    this->create_table(db, table.name, table);
+                }
+                if(is_fts5_external_content(table)) {
+                    if(table.fts5->sync_triggers) {
+                        this->create_fts5_triggers(db, table, res != sync_schema_result::already_in_sync);
+                    }
+                    if(res != sync_schema_result::already_in_sync) {
+                        std::stringstream ss;
+                        ss << "INSERT INTO " << streaming_identifier(table.schema_name, table.name, std::string{})
+                           << " (" << streaming_identifier(table.name) << ") VALUES ('rebuild')" << std::flush;
+                        perform_void_exec(db, ss.str());
+                    }
+                }
+                return res;
             }
 
             /**
@@ -128,9 +820,12 @@ namespace sqlite_orm {
                             const std::vector<const table_xinfo*>& columnsToIgnore) const;
 
 #if SQLITE_VERSION_NUMBER >= 3035000  //  DROP COLUMN feature exists (v3.35.0)
-            void drop_column(sqlite3* db, const std::string& tableName, const std::string& columnName) {
+            void drop_column(sqlite3* db,
+                             const std::string& schemaName,
+                             const std::string& tableName,
+                             const std::string& columnName) {
                 std::stringstream ss;
-                ss << "ALTER TABLE " << streaming_identifier(tableName) << " DROP COLUMN "
+                ss << "ALTER TABLE " << streaming_identifier(schemaName, tableName, std::string{}) << " DROP COLUMN "
                    << streaming_identifier(columnName) << std::flush;
                 perform_void_exec(db, ss.str());
             }
@@ -139,23 +834,41 @@ namespace sqlite_orm {
             template<class Table>
             void drop_create_with_loss(sqlite3* db, const Table& table) {
                 // eliminated all transaction handling
-                this->drop_table_internal(db, table.name);
+                this->drop_table_internal(db, table.name, table.schema_name);
                 this->create_table(db, table.name, table);
             }
 
+            /**
+             *  Whether the table in the database differs from `table` in being STRICT or WITHOUT ROWID, which
+             *  only a new table can change. The table options follow the closing parenthesis of the columns
+             *  in the CREATE TABLE statement kept in `sqlite_master`.
+             */
+            template<class Table>
+            bool table_options_differ(sqlite3* db, const Table& table, const schema_snapshot& snapshot) const {
+                auto sql = this->schema_sql(db, "table", table.name, table.schema_name, snapshot);
+                auto optionsPos = sql.rfind(')');
+                std::string options = optionsPos != sql.npos ? sql.substr(optionsPos + 1) : std::string{};
+                std::transform(options.begin(), options.end(), options.begin(), [](unsigned char c) {
+                    return char(std::toupper(c));
+                });
+                bool isWithoutRowid = options.find("ROWID") != options.npos;
+                bool isStrict = options.find("STRICT") != options.npos;
+                return isWithoutRowid != Table::is_without_rowid_v || isStrict != table.is_strict;
+            }
+
             template<class Table>
             void backup_table(sqlite3* db, const Table& table, const std::vector<const table_xinfo*>& columnsToIgnore) {
 
                 //  here we copy source table to another with a name with '_backup' suffix, but in case table with such
                 //  a name already exists we append suffix 1, then 2, etc until we find a free name..
                 auto backupTableName = table.name + "_backup";
-                if(this->table_exists(db, backupTableName)) {
+                if(this->table_exists(db, backupTableName, table.schema_name)) {
                     int suffix = 1;
                     do {
                         std::stringstream ss;
                         ss << suffix << std::flush;
                         auto anotherBackupTableName = backupTableName + ss.str();
-                        if(!this->table_exists(db, anotherBackupTableName)) {
+                        if(!this->table_exists(db, anotherBackupTableName, table.schema_name)) {
                             backupTableName = move(anotherBackupTableName);
                             break;
                         }
@@ -166,9 +879,9 @@ namespace sqlite_orm {
 
                 this->copy_table(db, table.name, backupTableName, table, columnsToIgnore);
 
-                this->drop_table_internal(db, table.name);
+                this->drop_table_internal(db, table.name, table.schema_name);
 
-                this->rename_table(db, backupTableName, table.name);
+                this->rename_table(db, backupTableName, table.name, table.schema_name);
             }
 
             template<class O>
@@ -202,85 +915,735 @@ namespace sqlite_orm {
                               "of 'insert', or you can use 'insert' with explicit column listing.");
             }
 
+            /**
+             *  Number of columns `insert` binds for an object of type `O`.
+             */
             template<class O>
-            auto& get_table() const {
-                return pick_table<O>(this->db_objects);
+            size_t insertable_columns_count() const {
+                auto& table = this->get_table<O>();
+                using is_without_rowid = typename std::decay_t<decltype(table)>::is_without_rowid;
+                size_t res = 0;
+                table.template for_each_column_excluding<
+                    mpl::conjunction<mpl::not_<mpl::always<is_without_rowid>>,
+                                     mpl::disjunction_fn<is_primary_key, is_generated_always>>>(
+                    [&table, &res](auto& column) {
+                        if(!table.exists_in_composite_primary_key(column)) {
+                            ++res;
+                        }
+                    });
+                return res;
             }
 
-            template<class O>
-            auto& get_table() {
-                return pick_table<O>(this->db_objects);
+            /**
+             *  Inserts or replaces the range [from, to) in chunks of as many rows as fit into
+             *  `limit.variable_number()` bound variables. All full chunks share one prepared statement and
+             *  the remainder gets a second one. If there is more than one chunk they run in one transaction
+             *  unless a transaction is already open.
+             *  @param columnsCount number of values bound per row.
+             *  @param makeExpression callable creating an `insert_range_t`, `replace_range_t` or `upsert_range_t`
+             *  from two iterators.
+             *  @param fixedVariablesCount number of values bound once per statement, e.g. by an upsert clause.
+             */
+            template<class It, class F>
+            void execute_range_in_chunks(It from,
+                                         It to,
+                                         size_t columnsCount,
+                                         const F& makeExpression,
+                                         size_t fixedVariablesCount = 0) {
+                this->for_each_range_chunk(
+                    std::move(from),
+                    std::move(to),
+                    columnsCount,
+                    makeExpression,
+                    [this](auto& statement) {
+                        this->execute(statement);
+                    },
+                    fixedVariablesCount);
             }
 
-          public:
-            template<class T, class... Args>
-            view_t<T, self, Args...> iterate(Args&&... args) {
-                this->assert_mapped_type<T>();
-
+            /**
+             *  Same as `execute_range_in_chunks()` but calls `executeChunk` with the prepared statement of every chunk
+             *  instead of executing it, e.g. to collect the rows of a RETURNING clause.
+             */
+            template<class It, class F, class G>
+            void for_each_range_chunk(It from,
+                                      It to,
+                                      size_t columnsCount,
+                                      const F& makeExpression,
+                                      const G& executeChunk,
+                                      size_t fixedVariablesCount) {
+                const size_t rowsCount = size_t(std::distance(from, to));
+                size_t chunkSize = rowsCount;
                 auto con = this->get_connection();
-                return {*this, std::move(con), std::forward<Args>(args)...};
+                if(columnsCount) {
+                    size_t variablesCount = size_t(sqlite3_limit(con.get(), SQLITE_LIMIT_VARIABLE_NUMBER, -1));
+                    variablesCount -= std::min(variablesCount, fixedVariablesCount);
+                    chunkSize = std::min(rowsCount, std::max<size_t>(variablesCount / columnsCount, 1));
+                }
+                const size_t fullChunksCount = rowsCount / chunkSize;
+                const size_t remainder = rowsCount % chunkSize;
+
+                auto insertChunks =
+                    [this, &from, &to, chunkSize, fullChunksCount, remainder, &makeExpression, &executeChunk] {
+                        It chunkEnd = std::next(from, chunkSize);
+                        auto statement = this->prepare(makeExpression(from, chunkEnd));
+                        executeChunk(statement);
+                        for(size_t i = 1; i < fullChunksCount; ++i) {
+                            from = chunkEnd;
+                            std::advance(chunkEnd, chunkSize);
+                            statement_range(statement.expression) = {from, chunkEnd};
+                            executeChunk(statement);
+                        }
+                        if(remainder) {
+                            auto remainderStatement = this->prepare(makeExpression(chunkEnd, to));
+                            executeChunk(remainderStatement);
+                        }
+                    };
+                if(fullChunksCount + (remainder ? 1 : 0) > 1 && sqlite3_get_autocommit(con.get())) {
+                    auto guard = this->transaction_guard();
+                    insertChunks();
+                    guard.commit();
+                } else {
+                    insertChunks();
+                }
             }
 
-            /**
-             * Delete from routine.
-             * O is an object's type. Must be specified explicitly.
-             * @param args optional conditions: `where`, `join` etc
-             * @example: storage.remove_all<User>(); - DELETE FROM users
-             * @example: storage.remove_all<User>(where(in(&User::id, {5, 6, 7}))); - DELETE FROM users WHERE id IN (5, 6, 7)
-             */
-            template<class O, class... Args>
-            void remove_all(Args&&... args) {
-                this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::remove_all<O>(std::forward<Args>(args)...));
-                this->execute(statement);
+            template<class S, class T, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> returning_in_chunks(S statement, T columns, size_t columnsCount) {
+                std::vector<R> res;
+                if(statement.range.first == statement.range.second) {
+                    return res;
+                }
+                auto from = statement.range.first;
+                auto to = statement.range.second;
+                this->for_each_range_chunk(
+                    std::move(from),
+                    std::move(to),
+                    columnsCount,
+                    [&statement, &columns](decltype(from) first, decltype(to) last) {
+                        auto chunk = statement;
+                        chunk.range = {std::move(first), std::move(last)};
+                        return sqlite_orm::returning(std::move(chunk), columns);
+                    },
+                    [this, &res](auto& chunkStatement) {
+                        auto rows = this->execute(chunkStatement);
+                        res.insert(res.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+                    },
+                    0);
+                return res;
+            }
+
+            template<class E>
+            static auto& statement_range(E& expression) {
+                return expression.range;
+            }
+
+            template<class S, class T>
+            static auto& statement_range(returning_t<S, T>& expression) {
+                return expression.statement.range;
             }
 
             /**
-             *  Delete routine.
-             *  O is an object's type. Must be specified explicitly.
-             *  @param ids ids of object to be removed.
+             *  Number of IN lists `for_each_key_chunk<O>()` splits [from, to) into.
              */
-            template<class O, class... Ids>
-            void remove(Ids... ids) {
-                this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::remove<O>(std::forward<Ids>(ids)...));
-                this->execute(statement);
+            template<class O, class It>
+            size_t key_chunks_count(sqlite3* db, const It& from, const It& to) {
+                using key_type = std::decay_t<decltype(*from)>;
+                const size_t keysCount = size_t(std::distance(from, to));
+                const size_t chunkSize = key_chunk_size(db, key_columns_count<key_type>::value);
+                return keysCount / chunkSize + (keysCount % chunkSize ? 1 : 0);
             }
 
-            /**
+            static size_t key_chunk_size(sqlite3* db, size_t keyColumnsCount) {
+                const size_t variablesCount = size_t(sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1));
+                return std::max<size_t>(variablesCount / keyColumnsCount, 1);
+            }
+
+            /**
+             *  Runs `sql` followed by a WHERE clause matching the primary key of O's table against the keys
+             *  [from, to), bound in chunks, calling `onRow` with every row. All full chunks share one prepared
+             *  statement and the remainder gets a second one.
+             */
+            template<class O, class It, class F>
+            void for_each_key_chunk(sqlite3* db, const std::string& sql, It from, It to, const F& onRow) {
+                using key_type = std::decay_t<decltype(*from)>;
+                const size_t keyColumnsCount = key_columns_count<key_type>::value;
+                const auto keyColumns = this->get_table<O>().primary_key_column_names();
+                if(keyColumns.empty()) {
+                    throw std::system_error{orm_error_code::table_has_no_primary_key_column};
+                }
+                if(keyColumns.size() != keyColumnsCount) {
+                    throw std::system_error{orm_error_code::arguments_count_does_not_match};
+                }
+                auto makeStatement = [db, &sql, &keyColumns, keyColumnsCount](size_t keysCount) {
+                    std::stringstream ss;
+                    ss << sql << " WHERE ";
+                    if(keyColumnsCount == 1) {
+                        ss << streaming_identifier(keyColumns.front()) << " IN (";
+                        for(size_t i = 0; i < keysCount; ++i) {
+                            ss << (i ? ", ?" : "?");
+                        }
+                        ss << ")";
+                    } else {
+                        //  row values, SQLite 3.15
+                        ss << "(" << streaming_identifiers(keyColumns) << ") IN (VALUES "
+                           << streaming_values_placeholders(keyColumnsCount, ptrdiff_t(keysCount)) << ")";
+                    }
+                    ss.flush();
+                    return statement_finalizer{prepare_stmt(db, ss.str())};
+                };
+                const size_t chunkSize = key_chunk_size(db, keyColumnsCount);
+                size_t keysCount = size_t(std::distance(from, to));
+                statement_finalizer fullStatement;
+                while(keysCount) {
+                    const size_t count = std::min(keysCount, chunkSize);
+                    statement_finalizer remainderStatement;
+                    sqlite3_stmt* stmt;
+                    if(count == chunkSize) {
+                        if(!fullStatement) {
+                            fullStatement = makeStatement(chunkSize);
+                        }
+                        stmt = reset_stmt(fullStatement.get());
+                    } else {
+                        remainderStatement = makeStatement(count);
+                        stmt = remainderStatement.get();
+                    }
+                    conditional_binder binder{stmt};
+                    for(size_t i = 0; i < count; ++i, ++from) {
+                        bind_key(binder, *from);
+                    }
+                    perform_steps(stmt, onRow);
+                    keysCount -= count;
+                }
+            }
+
+            /**
+             *  Applies `performance_profile::bulk_load()` without exclusive locking, which would keep other
+             *  connections out until the next transaction, and without leaving WAL mode.
+             *  @return profile restoring the former settings.
+             */
+            performance_profile apply_bulk_load_profile() {
+                auto profile = performance_profile::bulk_load();
+                profile.exclusive_locking.reset();
+                performance_profile former;
+                former.synchronous = this->pragma.synchronous();
+                former.cache_size = this->pragma.cache_size();
+                former.temp_store = this->pragma.temp_store();
+                const auto journalMode = this->pragma.journal_mode();
+                if(journalMode == journal_mode::WAL) {
+                    profile.journal_mode.reset();
+                } else {
+                    former.journal_mode = journalMode;
+                }
+                this->apply_performance_profile(profile);
+                return former;
+            }
+
+            /**
+             *  Implementation of `import_csv()`: inserts the records of `path` into the columns `names` of
+             *  `table`, binding the field i of a record with `binders[i]`.
+             */
+            template<class Table>
+            size_t import_csv_internal(const std::string& path,
+                                       const Table& table,
+                                       const std::vector<std::string>& names,
+                                       const std::vector<void (*)(sqlite3_stmt*, int, const csv_field&)>& binders,
+                                       const csv_options& options) {
+                csv_reader reader{path, options};
+                auto con = this->get_connection();
+                sqlite3* db = con.get();
+                const size_t columnsCount = names.size();
+                const size_t variablesCount = size_t(sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1));
+                size_t rowsPerStatement = std::max<size_t>(variablesCount / columnsCount, 1);
+                if(options.rows_per_statement) {
+                    rowsPerStatement = std::min(rowsPerStatement, options.rows_per_statement);
+                }
+                auto makeStatement = [db, &table, &names, columnsCount](size_t rowsCount) {
+                    const ptrdiff_t valuesCount = ptrdiff_t(rowsCount);
+                    std::stringstream ss;
+                    ss << "INSERT INTO " << streaming_table_identifier(table) << " ("
+                       << streaming_identifiers(names) << ") VALUES "
+                       << streaming_values_placeholders(columnsCount, valuesCount) << std::flush;
+                    return statement_finalizer{prepare_stmt(db, ss.str())};
+                };
+
+                const bool ownTransactions = !this->in_transaction();
+                performance_profile former;
+                if(options.bulk_load_profile && ownTransactions) {
+                    former = this->apply_bulk_load_profile();
+                }
+
+                size_t count = 0;
+                size_t rowsInTransaction = 0;
+                bool transactionOpen = false;
+                try {
+                    statement_finalizer fullStatement = makeStatement(rowsPerStatement);
+                    //  fields of the rows not inserted yet, they point into the read buffer until the next refill
+                    std::vector<csv_field> pending;
+                    pending.reserve(rowsPerStatement * columnsCount);
+                    auto insertPending = [&pending, &binders, columnsCount](sqlite3_stmt* stmt) {
+                        sqlite3_reset(stmt);
+                        for(size_t i = 0; i < pending.size(); ++i) {
+                            binders[i % columnsCount](stmt, int(i + 1), pending[i]);
+                        }
+                        perform_step(stmt);
+                        pending.clear();
+                    };
+                    auto insertPendingRows = [&] {
+                        const size_t rowsCount = pending.size() / columnsCount;
+                        if(!rowsCount) {
+                            return;
+                        }
+                        if(ownTransactions && !transactionOpen) {
+                            this->begin_transaction();
+                            transactionOpen = true;
+                        }
+                        if(rowsCount == rowsPerStatement) {
+                            insertPending(fullStatement.get());
+                        } else {
+                            insertPending(makeStatement(rowsCount).get());
+                        }
+                        count += rowsCount;
+                        rowsInTransaction += rowsCount;
+                        if(transactionOpen && options.rows_per_transaction &&
+                           rowsInTransaction >= options.rows_per_transaction) {
+                            transactionOpen = false;
+                            rowsInTransaction = 0;
+                            this->commit();
+                        }
+                    };
+
+                    std::vector<csv_field> fields;
+                    do {
+                        while(reader.next(fields)) {
+                            if(fields.size() != columnsCount) {
+                                throw std::system_error{orm_error_code::invalid_csv_record,
+                                                        "record " + std::to_string(reader.record_number()) + " has " +
+                                                            std::to_string(fields.size()) + " fields instead of " +
+                                                            std::to_string(columnsCount)};
+                            }
+                            pending.insert(pending.end(), fields.begin(), fields.end());
+                            if(pending.size() == rowsPerStatement * columnsCount) {
+                                insertPendingRows();
+                            }
+                        }
+                        insertPendingRows();
+                    } while(reader.refill());
+                    if(transactionOpen) {
+                        transactionOpen = false;
+                        this->commit();
+                    }
+                } catch(...) {
+                    if(transactionOpen) {
+                        this->rollback();
+                    }
+                    if(options.bulk_load_profile && ownTransactions) {
+                        this->apply_performance_profile(former);
+                    }
+                    throw;
+                }
+                if(options.bulk_load_profile && ownTransactions) {
+                    this->apply_performance_profile(former);
+                }
+                return count;
+            }
+
+            /**
+             *  Source of the `lazy` members of the objects of type O read by this storage, null if it has none.
+             */
+            template<class O>
+            std::shared_ptr<const lazy_source> lazy_source_of() {
+                return make_lazy_source(this->get_table<O>(), [this] {
+                    return this->get_read_connection();
+                });
+            }
+
+            template<class O>
+            auto& get_table() const {
+                return pick_table<O>(this->db_objects);
+            }
+
+            template<class O>
+            auto& get_table() {
+                return pick_table<O>(this->db_objects);
+            }
+
+          public:
+            template<class T, class... Args>
+            view_t<T, self, Args...> iterate(Args&&... args) {
+                this->assert_mapped_type<T>();
+
+                auto con = this->get_read_connection();
+                view_t<T, self, Args...> res{*this, std::move(con), std::forward<Args>(args)...};
+                res.reader = [this] {
+                    return this->get_read_connection();
+                };
+                return res;
+            }
+
+            /**
+             *  Iterates over the rows of the prepared `iterate<T>(...)` or `get_all<T>(...)` statement, reusing it
+             *  every time the iteration starts over. Arguments changed with `get<N>(statement)` take effect at the
+             *  next `begin()`.
+             *  @example: auto statement = storage.prepare(iterate<User>(where(c(&User::id) > 0)));
+             *            for(auto& user: storage.iterate(statement)) { ... }
+             */
+            template<class T, class R, class... Args>
+            prepared_view_t<T, self, R, Args...>
+            iterate(const prepared_statement_t<get_all_t<T, R, Args...>>& statement) {
+                return {*this, statement};
+            }
+
+            /**
+             * Delete from routine.
+             * O is an object's type. Must be specified explicitly.
+             * @param args optional conditions: `where`, `join` etc
+             * @example: storage.remove_all<User>(); - DELETE FROM users
+             * @example: storage.remove_all<User>(where(in(&User::id, {5, 6, 7}))); - DELETE FROM users WHERE id IN (5, 6, 7)
+             */
+            template<class O, class... Args>
+            void remove_all(Args&&... args) {
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::remove_all<O>(std::forward<Args>(args)...));
+                this->execute(statement);
+                //  the update hook isn't invoked when a table is emptied without a WHERE clause
+                this->forget_cached_rows<O>();
+            }
+
+            /**
+             *  Delete routine.
+             *  O is an object's type. Must be specified explicitly.
+             *  @param ids ids of object to be removed.
+             */
+            template<class O, class... Ids>
+            void remove(Ids... ids) {
+                this->assert_mapped_type<O>();
+                auto cache = this->find_object_cache<O>();
+                auto key = cache ? make_object_cache_key(ids...) : std::string{};
+                auto statement = this->prepare_cached(sqlite_orm::remove<O>(std::forward<Ids>(ids)...));
+                this->execute(statement);
+                if(cache) {
+                    cache->invalidate(key);
+                }
+            }
+
+            /**
+             *  Deletes the row of `o`, found by its rowid member if its table has one (see `with_rowid_member()`),
+             *  by its primary key otherwise.
+             */
+            template<class O>
+            void remove(const O& o) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                pooled_stringstream ss;
+                ss << "DELETE FROM " << streaming_table_identifier(table) << " WHERE ";
+                stream_row_key(ss, table);
+
+                auto con = this->get_connection();
+                std::string sql = ss.str();
+                auto cache = this->get_statement_cache();
+                sqlite3_stmt* stmt = cache ? cache->take(con.get(), sql) : nullptr;
+                if(!stmt) {
+                    stmt = prepare_stmt(con.get(), move(sql), cache ? prepare_flags::persistent : prepare_flags::none);
+                }
+                prepared_statement_base statement{stmt, std::move(con), std::move(cache)};
+
+                field_value_binder bind_value{stmt, true};
+                this->bind_row_key(bind_value, table, o);
+                perform_step(stmt);
+                this->invalidate_cached_object(o);
+            }
+
+            /**
+             *  Removes the objects of type O with the primary keys in [from, to): values of the primary key column, or
+             *  tuples of the values of the primary key columns in their order for a composite primary key. The keys
+             *  are bound to IN lists of as many keys as fit into `limit.variable_number()` bound variables, all
+             *  full lists sharing one prepared statement, in one transaction if there is more than one list.
+             *  @example: storage.remove_range<User>(expiredIds.begin(), expiredIds.end());
+             *  @example: std::vector<std::tuple<int, std::string>> keys = ...;
+             *            storage.remove_range<Setting>(keys.begin(), keys.end());
+             */
+            template<class O, class It>
+            void remove_range(It from, It to) {
+                this->assert_mapped_type<O>();
+                if(from == to) {
+                    return;
+                }
+                auto con = this->get_connection();
+                std::stringstream ss;
+                ss << "DELETE FROM " << streaming_table_identifier(this->get_table<O>()) << std::flush;
+                const std::string sql = ss.str();
+                auto removeChunks = [this, &con, &sql, &from, &to] {
+                    this->for_each_key_chunk<O>(con.get(), sql, std::move(from), std::move(to), [](sqlite3_stmt*) {});
+                };
+                if(this->key_chunks_count<O>(con.get(), from, to) > 1 && sqlite3_get_autocommit(con.get())) {
+                    auto guard = this->transaction_guard();
+                    removeChunks();
+                    guard.commit();
+                } else {
+                    removeChunks();
+                }
+                //  the update hook doesn't see deletes from WITHOUT ROWID tables
+                this->forget_cached_rows<O>();
+            }
+
+            /**
+             *  Reads the objects of type O with the primary keys in [from, to), see `remove_range()`, with a
+             *  statement per IN list instead of one per key.
+             *  @return the objects by their keys. Keys without an object have no entry.
+             *  @example: auto users = storage.get_range<User>(ids.begin(), ids.end());
+             */
+            template<class O, class It, class K = std::decay_t<decltype(*std::declval<It>())>>
+            std::map<K, O> get_range(It from, It to) {
+                this->assert_mapped_type<O>();
+                std::map<K, O> res;
+                if(from == to) {
+                    return res;
+                }
+                auto& table = this->get_table<O>();
+                auto con = this->get_read_connection();
+                std::stringstream ss;
+                ss << "SELECT " << streaming_identifiers(table.primary_key_column_names()) << ", "
+                   << streaming_table_column_names(table, false) << " FROM " << streaming_table_identifier(table)
+                   << std::flush;
+                auto lazySource = this->lazy_source_of<O>();
+                const int keyColumnsCount = int(key_columns_count<K>::value);
+                const std::string sql = ss.str();
+                auto readChunks = [this, &con, &sql, &from, &to, &res, &table, &lazySource, keyColumnsCount] {
+                    this->for_each_key_chunk<O>(
+                        con.get(),
+                        sql,
+                        std::move(from),
+                        std::move(to),
+                        [&res, &table, &lazySource, keyColumnsCount](sqlite3_stmt* stmt) {
+                            O object;
+                            object_from_column_builder<O> builder{object, stmt, lazySource};
+                            builder.index = keyColumnsCount;
+                            build_object_columns(builder, table);
+                            res[row_extractor<K>{}.extract(stmt, 0)] = std::move(object);
+                        });
+                };
+                //  the chunks are read from one snapshot
+                if(this->key_chunks_count<O>(con.get(), from, to) > 1 && sqlite3_get_autocommit(con.get())) {
+                    auto guard = this->read_transaction();
+                    readChunks();
+                    guard.commit();
+                } else {
+                    readChunks();
+                }
+                return res;
+            }
+
+            /**
              *  Update routine. Sets all non primary key fields where primary key is equal.
              *  O is an object type. May be not specified explicitly cause it can be deduced by
              *      compiler from first parameter.
+             *  With a version column (see `version_column()`) the version of the row is incremented, and
+             *  `orm_error_code::version_conflict` is thrown if the row doesn't have the version of `o` any more.
              *  @param o object to be updated.
              */
             template<class O>
             void update(const O& o) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::update(std::ref(o)));
+                auto statement = this->prepare_cached(sqlite_orm::update(std::ref(o)));
                 this->execute(statement);
+                this->invalidate_cached_object(o);
+            }
+
+            /**
+             *  Same as `update(o)` of a table with a version column, but returns false on a version conflict
+             *  instead of throwing. On success the version of `o` is incremented like the version of its row,
+             *  so that `o` can be updated again.
+             */
+            template<class O>
+            bool try_update(O& o) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                if(!table.version_member) {
+                    throw std::system_error{orm_error_code::column_not_found};
+                }
+                auto statement = this->prepare_cached(sqlite_orm::update(std::ref(o)));
+                const bool updated = this->execute_update(statement);
+                this->invalidate_cached_object(o);
+                if(updated) {
+                    ++(o.*table.version_member);
+                }
+                return updated;
+            }
+
+            /**
+             *  Reads the object with primary key `ids`, calls `mutate(object)` and updates it with `try_update()`,
+             *  reading and mutating it again on a version conflict, at most `maxAttempts` times. The write lock
+             *  is taken by the UPDATE only, not while `mutate` runs.
+             *  @return the updated object.
+             *  @example: auto account = storage.optimistic_update<Account>(5, [](Account& account) {
+             *                account.balance -= 10;
+             *            }, accountId);
+             */
+            template<class O, class F, class... Ids>
+            O optimistic_update(int maxAttempts, F mutate, Ids... ids) {
+                for(int attempt = 1;; ++attempt) {
+                    auto object = this->get<O>(ids...);
+                    mutate(object);
+                    if(this->try_update(object)) {
+                        return object;
+                    }
+                    if(attempt >= maxAttempts) {
+                        throw std::system_error{orm_error_code::version_conflict};
+                    }
+                }
+            }
+
+            /**
+             *  Same as `update(o)` but sets only the columns whose values differ between `old` and `o`,
+             *  e.g. the object as it was loaded and the object after it has been modified. Does nothing if no column
+             *  differs. Every combination of changed columns gets its own statement in the statement cache.
+             *  @param old previous state of the object. Its primary key is ignored.
+             *  @param o object to be updated.
+             */
+            template<class O>
+            void update_changed(const O& old, const O& o) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+
+                std::vector<bool> changed;
+                size_t changedCount = 0;
+                pooled_stringstream ss;
+                ss << "UPDATE " << streaming_table_identifier(table) << " SET ";
+                table.template for_each_column_excluding<mpl::disjunction_fn<is_primary_key, is_generated_always>>(
+                    [&table, &changed, &changedCount, &ss, &old, &o](auto& column) {
+                        if(table.exists_in_composite_primary_key(column)) {
+                            return;
+                        }
+                        const bool differs = !table.is_version_column(column) &&
+                                             !is_field_equal(polyfill::invoke(column.member_pointer, old),
+                                                             polyfill::invoke(column.member_pointer, o));
+                        if(differs) {
+                            constexpr std::array<const char*, 2> sep = {", ", ""};
+                            ss << sep[changedCount++ == 0] << streaming_identifier(column.name) << " = ?";
+                        }
+                        changed.push_back(differs);
+                    });
+                if(!changedCount) {
+                    return;
+                }
+                table.for_each_column([&table, &ss](auto& column) {
+                    if(table.is_version_column(column)) {
+                        ss << ", " << streaming_identifier(column.name) << " = " << streaming_identifier(column.name)
+                           << " + 1";
+                    }
+                });
+                ss << " WHERE ";
+                stream_row_key(ss, table);
+                stream_version_condition(ss, table);
+
+                auto con = this->get_connection();
+                std::string sql = ss.str();
+                auto cache = this->get_statement_cache();
+                sqlite3_stmt* stmt = cache ? cache->take(con.get(), sql) : nullptr;
+                if(!stmt) {
+                    stmt = prepare_stmt(con.get(), move(sql), cache ? prepare_flags::persistent : prepare_flags::none);
+                }
+                prepared_statement_base statement{stmt, std::move(con), std::move(cache)};
+
+                field_value_binder bind_value{stmt, true};
+                size_t index = 0;
+                table.template for_each_column_excluding<mpl::disjunction_fn<is_primary_key, is_generated_always>>(
+                    [&table, &changed, &index, &bind_value, &o](auto& column) {
+                        if(!table.exists_in_composite_primary_key(column) && changed[index++]) {
+                            bind_value(polyfill::invoke(column.member_pointer, o));
+                        }
+                    });
+                this->bind_row_key(bind_value, table, o);
+                if(table.version_member) {
+                    bind_value(o.*table.version_member);
+                }
+                perform_step(stmt);
+                this->invalidate_cached_object(o);
+                if(table.version_member && sqlite3_changes(sqlite3_db_handle(stmt)) == 0) {
+                    throw std::system_error{orm_error_code::version_conflict};
+                }
             }
 
             template<class... Args, class... Wargs>
             void update_all(internal::set_t<Args...> set, Wargs... wh) {
-                auto statement = this->prepare(sqlite_orm::update_all(std::move(set), std::forward<Wargs>(wh)...));
+                auto statement =
+                    this->prepare_cached(sqlite_orm::update_all(std::move(set), std::forward<Wargs>(wh)...));
                 this->execute(statement);
             }
 
+            /**
+             *  Opens the BLOB stored in column `m` of the row with `rowid` for incremental I/O.
+             *  Use it to read or write large BLOBs in chunks instead of loading the whole value into memory.
+             *  Example:
+             *      storage.insert(into<Artifact>(), columns(&Artifact::data), values(std::make_tuple(zeroblob(size))));
+             *      auto blob = storage.open_blob(&Artifact::data, storage.last_insert_rowid());
+             *      blob.write(0, chunk.data(), int(chunk.size()));
+             *  @param m member pointer of a BLOB column.
+             *  @param rowid rowid of the row. Tables created `WITHOUT ROWID` are not supported by SQLite.
+             *  @param readonly opens the BLOB for reading only if true.
+             */
+            template<class M, class O = member_object_type_t<M>>
+            blob_t open_blob(M m, int64 rowid, bool readonly = false) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                auto columnName = table.find_column_name(m);
+                if(!columnName) {
+                    throw std::system_error{orm_error_code::column_not_found};
+                }
+                return {this->get_connection(), table.schema_name, table.name, *columnName, rowid, readonly};
+            }
+
           protected:
             template<class F, class O, class... Args>
             std::string group_concat_internal(F O::*m, std::unique_ptr<std::string> y, Args&&... args) {
                 this->assert_mapped_type<O>();
-                std::vector<std::string> rows;
                 if(y) {
-                    rows = this->select(sqlite_orm::group_concat(m, move(*y)), std::forward<Args>(args)...);
+                    return this->select_scalar<std::string>(sqlite_orm::group_concat(m, move(*y)),
+                                                            std::forward<Args>(args)...);
                 } else {
-                    rows = this->select(sqlite_orm::group_concat(m), std::forward<Args>(args)...);
+                    return this->select_scalar<std::string>(sqlite_orm::group_concat(m), std::forward<Args>(args)...);
                 }
-                if(!rows.empty()) {
-                    return move(rows.front());
-                } else {
-                    return {};
+            }
+
+            /**
+             *  `select(expression, args...)` of an aggregate which returns one row, stepping once and extracting
+             *  the value right into the result instead of a vector of rows. Queries cached with `cached()` still
+             *  go through `select()`.
+             *  @return the value of the row, a value-initialized `R` if there is none.
+             */
+            template<class R, class E, class... Args>
+            R select_scalar(E expression, Args&&... args) {
+                auto statement =
+                    this->prepare_cached(sqlite_orm::select(std::move(expression), std::forward<Args>(args)...));
+                using is_cached_query =
+                    polyfill::bool_constant<count_tuple<std::tuple<std::decay_t<Args>...>, is_cached>::value != 0>;
+                return this->execute_scalar<R>(statement, is_cached_query{});
+            }
+
+            template<class R, class S>
+            R execute_scalar(const prepared_statement_t<S>& statement, std::false_type) {
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+
+                bind_changed_parameters(statement, statement.expression);
+
+                R res{};
+                auto rowExtractor = make_row_extractor<R>(lookup_table<R>(this->db_objects));
+                tracer.phase(execute_phase::step);
+                perform_step(stmt, tracer.extracting([&rowExtractor, &res](sqlite3_stmt* stmt) {
+                    res = rowExtractor.extract(stmt, 0);
+                }));
+                return res;
+            }
+
+            template<class R, class S>
+            R execute_scalar(const prepared_statement_t<S>& statement, std::true_type) {
+                auto rows = this->execute_select(statement, std::true_type{});
+                if(rows.empty()) {
+                    return R{};
                 }
+                return R(std::move(rows.front()));
             }
 
           public:
@@ -295,7 +1658,7 @@ namespace sqlite_orm {
             template<class O, class... Args>
             auto get_all(Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::get_all<O>(std::forward<Args>(args)...));
+                auto statement = this->prepare_cached(sqlite_orm::get_all<O>(std::forward<Args>(args)...));
                 return this->execute(statement);
             }
 
@@ -310,10 +1673,64 @@ namespace sqlite_orm {
             template<class O, class R, class... Args>
             auto get_all(Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::get_all<O, R>(std::forward<Args>(args)...));
+                auto statement = this->prepare_cached(sqlite_orm::get_all<O, R>(std::forward<Args>(args)...));
                 return this->execute(statement);
             }
 
+            /**
+             *  Same as `get_all<O, R>(args...)` but appends the objects to `container`, whose type R is deduced
+             *  and whose value type is O by default. A container reused across calls keeps its capacity, so once it
+             *  has grown the objects are read with no allocation but the one of their members.
+             *  @example: users.clear(); storage.get_all_into(users, where(c(&User::id) > 3));
+             */
+            template<class R, class O = typename R::value_type, class... Args>
+            void get_all_into(R& container, Args&&... args) {
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::get_all<O, R>(std::forward<Args>(args)...));
+                this->execute_into(statement, container);
+            }
+
+            /**
+             *  Same as `get_all<O>(args...)` but returns the objects by the key `key` gives them, moving every object
+             *  into the map as it is read. M is the type of the map, `std::unordered_map` by default. Objects with a
+             *  key already in the map are dropped.
+             *  @example: std::unordered_map<int, User> users = storage.get_all_map<User>(&User::id);
+             */
+            template<class O, class M = void, class K, class... Args>
+            auto get_all_map(K key, Args&&... args) {
+                this->assert_mapped_type<O>();
+                using key_type = std::decay_t<decltype(polyfill::invoke(key, std::declval<const O&>()))>;
+                using map_type = std::conditional_t<std::is_void<M>::value, std::unordered_map<key_type, O>, M>;
+                auto statement = this->prepare_cached(sqlite_orm::get_all<O>(std::forward<Args>(args)...));
+                map_type res;
+                reserve_result(res, statement.expression.conditions);
+                this->for_each(statement, [&res, &key](O object) {
+                    key_type objectKey = polyfill::invoke(key, object);
+                    res.emplace(std::move(objectKey), std::move(object));
+                });
+                return res;
+            }
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+            /**
+             *  SELECT * routine allocating from `arena`: the returned `std::pmr::vector` and the `std::pmr::string`
+             *  and `std::pmr::vector<char>` members of the objects use it. An arena scoped to a request, e.g.
+             *  a `std::pmr::monotonic_buffer_resource`, makes destroying the result free and keeps extracting
+             *  threads from contending for the global allocator. Members of other types allocate as usual.
+             *  @example: storage.get_all<User>(&arena, where(c(&User::id) > 3)); - SELECT * FROM users WHERE id > 3
+             */
+            template<class O,
+                     class M,
+                     class... Args,
+                     std::enable_if_t<std::is_base_of<std::pmr::memory_resource, M>::value, bool> = true>
+            std::pmr::vector<O> get_all(M* arena, Args&&... args) {
+                this->assert_mapped_type<O>();
+                auto statement =
+                    this->prepare_cached(sqlite_orm::get_all<O, std::pmr::vector<O>>(std::forward<Args>(args)...));
+                return this->execute(statement, static_cast<std::pmr::memory_resource*>(arena));
+            }
+#endif
+
             /**
              *  SELECT * routine.
              *  O is an object type to be extracted. Must be specified explicitly.
@@ -325,7 +1742,7 @@ namespace sqlite_orm {
             template<class O, class... Args>
             auto get_all_pointer(Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::get_all_pointer<O>(std::forward<Args>(args)...));
+                auto statement = this->prepare_cached(sqlite_orm::get_all_pointer<O>(std::forward<Args>(args)...));
                 return this->execute(statement);
             }
 
@@ -340,7 +1757,7 @@ namespace sqlite_orm {
             template<class O, class R, class... Args>
             auto get_all_pointer(Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::get_all_pointer<O, R>(std::forward<Args>(args)...));
+                auto statement = this->prepare_cached(sqlite_orm::get_all_pointer<O, R>(std::forward<Args>(args)...));
                 return this->execute(statement);
             }
 
@@ -355,7 +1772,14 @@ namespace sqlite_orm {
             template<class O, class... Ids>
             O get(Ids... ids) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::get<O>(std::forward<Ids>(ids)...));
+                if(auto cache = this->find_object_cache<O>()) {
+                    auto res = this->get_cached<O>(*cache, std::forward<Ids>(ids)...);
+                    if(!res) {
+                        throw std::system_error{orm_error_code::not_found};
+                    }
+                    return copy_cached_object(*res, std::is_copy_constructible<O>{});
+                }
+                auto statement = this->prepare_cached(sqlite_orm::get<O>(std::forward<Ids>(ids)...));
                 return this->execute(statement);
             }
 
@@ -366,7 +1790,14 @@ namespace sqlite_orm {
             template<class O, class... Ids>
             std::unique_ptr<O> get_pointer(Ids... ids) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::get_pointer<O>(std::forward<Ids>(ids)...));
+                if(auto cache = this->find_object_cache<O>()) {
+                    auto res = this->get_cached<O>(*cache, std::forward<Ids>(ids)...);
+                    if(!res) {
+                        return nullptr;
+                    }
+                    return std::make_unique<O>(copy_cached_object(*res, std::is_copy_constructible<O>{}));
+                }
+                auto statement = this->prepare_cached(sqlite_orm::get_pointer<O>(std::forward<Ids>(ids)...));
                 return this->execute(statement);
             }
 
@@ -388,48 +1819,211 @@ namespace sqlite_orm {
                 return std::shared_ptr<O>(this->get_pointer<O>(std::forward<Ids>(ids)...));
             }
 
-#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
             /**
-             *  The same as `get` function but doesn't throw an exception if noting found but
-             * returns an empty std::optional. throws std::system_error in case of db error.
+             *  The same as `get_pointer` but returns the object shared with the object cache
+             *  if `enable_object_cache<O>()` was called, so that a cached object is not copied.
              */
             template<class O, class... Ids>
-            std::optional<O> get_optional(Ids... ids) {
+            std::shared_ptr<const O> get_shared(Ids... ids) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::get_optional<O>(std::forward<Ids>(ids)...));
-                return this->execute(statement);
+                if(auto cache = this->find_object_cache<O>()) {
+                    return this->get_cached<O>(*cache, std::forward<Ids>(ids)...);
+                }
+                return this->get_pointer<O>(std::forward<Ids>(ids)...);
             }
-#endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
 
             /**
-             *  SELECT COUNT(*) https://www.sqlite.org/lang_aggfunc.html#count
-             *  @return Number of O object in table.
+             *  Caches objects of type O read by `get`, `get_pointer`, `get_optional` and `get_shared` by their
+             *  primary key, keeping the `capacity` least recently used ones. Changed rows are dropped from
+             *  the cache by the update hook of every connection of the storage, by `update`, `replace`, `remove`
+             *  and by `remove_all`. Changes made by other processes or other storages are not noticed
+             *  unless `enable_cache_coherence()` is called.
+             *  Objects aren't cached while a transaction that changed the table is open.
+             *  Call it before the storage is used by other threads.
              */
-            template<class O, class... Args, class R = mapped_type_proxy_t<O>>
-            int count(Args&&... args) {
-                this->assert_mapped_type<R>();
-                auto rows = this->select(sqlite_orm::count<R>(), std::forward<Args>(args)...);
-                if(!rows.empty()) {
-                    return rows.front();
-                } else {
-                    return 0;
-                }
+            template<class O>
+            void enable_object_cache(size_t capacity = 1024) {
+                this->assert_mapped_type<O>();
+                using table_type = std::decay_t<decltype(this->get_table<O>())>;
+                static_assert(!table_type::is_without_rowid_v,
+                              "The update hook isn't invoked for WITHOUT ROWID tables, they can't be cached");
+                static_assert(std::is_copy_constructible<O>::value,
+                              "Cached objects are copied by get, get_pointer and get_optional");
+                auto& table = this->get_table<O>();
+                size_t primaryKeyColumns = 0;
+                bool integerKey = true;
+                table.for_each_primary_key_column([&primaryKeyColumns, &integerKey](auto& memberPointer) {
+                    using field_type = member_field_type_t<std::decay_t<decltype(memberPointer)>>;
+                    ++primaryKeyColumns;
+                    integerKey = integerKey && std::is_integral<field_type>::value;
+                });
+                this->objectCaches.add(table.name, capacity, primaryKeyColumns == 1 && integerKey);
+                this->reset_change_hooks();
             }
 
-            /**
+            template<class O>
+            void disable_object_cache() {
+                this->assert_mapped_type<O>();
+                this->objectCaches.remove(this->get_table<O>().name);
+                this->reset_change_hooks();
+            }
+
+            /**
+             *  Calls `callback` with every insert, update and removal of a row of O, made by any connection
+             *  of the storage, after the transaction of the change commits. Changes of a transaction that rolls
+             *  back are never delivered. If sqlite_orm is compiled with SQLITE_ENABLE_PREUPDATE_HOOK
+             *  the events also carry the row before and after the change.
+             *  `callback` runs on the thread that committed, right after the statement that committed returned,
+             *  and must not throw. Changes made by other processes or other storages are not noticed.
+             *  A null `callback` unsubscribes. Call it before the storage is used by other threads.
+             */
+            template<class O>
+            void on_change(std::function<void(const change_event<O>&)> callback) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                std::unique_ptr<change_subscription_base> subscription;
+                if(callback) {
+                    subscription = std::make_unique<change_subscription<O>>(
+                        table.name,
+                        std::move(callback),
+                        [&table](sqlite3* db, bool old) -> std::shared_ptr<const O> {
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+                            auto object = std::make_shared<O>();
+                            auto valueOf = [db, old](int index) {
+                                sqlite3_value* value = nullptr;
+                                if(old) {
+                                    sqlite3_preupdate_old(db, index, &value);
+                                } else {
+                                    sqlite3_preupdate_new(db, index, &value);
+                                }
+                                return value;
+                            };
+                            table.for_each_column(object_from_value_builder<O, decltype(valueOf)>{*object, valueOf});
+                            return object;
+#else
+                            (void)table;
+                            (void)db;
+                            (void)old;
+                            return nullptr;
+#endif
+                        });
+                }
+                this->changeStreams.subscribe(table.name, std::move(subscription));
+                this->reset_change_hooks();
+            }
+
+#if defined(SQLITE_ENABLE_SESSION) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+            /**
+             *  Starts recording the changes of the tables of `Os` made on the connection of the calling thread,
+             *  or of all tables without `Os`, as a changeset for `apply_changeset()` on another database.
+             *
+             *  Example:
+             *  auto recorder = storage.record_changes<User, Order>();
+             *  storage.replace(User{1, "Carol"});
+             *  replica.apply_changeset(recorder.changeset());
+             */
+            template<class... Os>
+            change_recorder record_changes() {
+                (void)std::initializer_list<int>{(this->assert_mapped_type<Os>(), 0)...};
+                return {this->get_connection(), {this->get_table<Os>().name...}};
+            }
+#endif
+
+            /**
+             *  Counters of the object cache of O. All zero if it isn't enabled.
+             */
+            template<class O>
+            object_cache_stats cache_stats() {
+                auto cache = this->find_object_cache<O>();
+                return cache ? cache->stats() : object_cache_stats{};
+            }
+
+            /**
+             *  Keeps a Bloom filter of the primary keys of O in memory, which `get`, `get_pointer`,
+             *  `get_optional`, `get_shared`, `try_get` and their prepared statements consult before querying:
+             *  a key the filter doesn't have is answered as missing in nanoseconds, without a B-tree descent.
+             *  About 1% of the missing keys still query with the default 10 bits per key.
+             *  The filter is built from the table at the first lookup and rebuilt when it goes stale. The update
+             *  hook of every connection of the storage adds the rowid of every row written to a table whose
+             *  primary key is the rowid. For other keys, `insert`, `replace` and `update` of objects add the keys
+             *  of their objects, and any other write to the table makes the filter stale. Changes made by other
+             *  processes or other storages are noticed only with `enable_cache_coherence()`.
+             *  Lookups are consulted with keys of the types of the primary key columns only, integers or
+             *  `std::string`. Call it before the storage is used by other threads.
+             */
+            template<class O>
+            void enable_key_filter(size_t expectedKeys = 1 << 16, int bitsPerKey = 10) {
+                this->assert_mapped_type<O>();
+                using table_type = std::decay_t<decltype(this->get_table<O>())>;
+                static_assert(!table_type::is_without_rowid_v,
+                              "The update hook isn't invoked for WITHOUT ROWID tables, they can't be filtered");
+                auto& table = this->get_table<O>();
+                size_t primaryKeyColumns = 0;
+                bool integerKey = true;
+                table.for_each_primary_key_column([&primaryKeyColumns, &integerKey](auto& memberPointer) {
+                    using field_type = member_field_type_t<std::decay_t<decltype(memberPointer)>>;
+                    static_assert(std::is_integral<field_type>::value || std::is_same<field_type, std::string>::value,
+                                  "Key filters support primary key columns of integer or std::string type");
+                    ++primaryKeyColumns;
+                    integerKey = integerKey && std::is_integral<field_type>::value;
+                });
+                this->keyFilters.add(table.name, expectedKeys, bitsPerKey, primaryKeyColumns == 1 && integerKey);
+                this->reset_change_hooks();
+            }
+
+            template<class O>
+            void disable_key_filter() {
+                this->assert_mapped_type<O>();
+                this->keyFilters.remove(this->get_table<O>().name);
+                this->reset_change_hooks();
+            }
+
+            /**
+             *  Counters of the key filter of O. All zero if it isn't enabled.
+             */
+            template<class O>
+            key_filter_stats filter_stats() {
+                auto filter = this->find_key_filter<O>();
+                return filter ? filter->stats() : key_filter_stats{};
+            }
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+            /**
+             *  The same as `get` function but doesn't throw an exception if noting found but
+             * returns an empty std::optional. throws std::system_error in case of db error.
+             */
+            template<class O, class... Ids>
+            std::optional<O> get_optional(Ids... ids) {
+                this->assert_mapped_type<O>();
+                if(auto cache = this->find_object_cache<O>()) {
+                    auto res = this->get_cached<O>(*cache, std::forward<Ids>(ids)...);
+                    return res ? std::optional<O>{copy_cached_object(*res, std::is_copy_constructible<O>{})}
+                               : std::nullopt;
+                }
+                auto statement = this->prepare_cached(sqlite_orm::get_optional<O>(std::forward<Ids>(ids)...));
+                return this->execute(statement);
+            }
+#endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
+
+            /**
+             *  SELECT COUNT(*) https://www.sqlite.org/lang_aggfunc.html#count
+             *  @return Number of O object in table.
+             */
+            template<class O, class... Args, class R = mapped_type_proxy_t<O>>
+            int64 count(Args&&... args) {
+                this->assert_mapped_type<R>();
+                return this->select_scalar<int64>(sqlite_orm::count<R>(), std::forward<Args>(args)...);
+            }
+
+            /**
              *  SELECT COUNT(X) https://www.sqlite.org/lang_aggfunc.html#count
              *  @param m member pointer to class mapped to the storage.
              *  @return count of `m` values from database.
              */
             template<class F, class O, class... Args>
-            int count(F O::*m, Args&&... args) {
+            int64 count(F O::*m, Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto rows = this->select(sqlite_orm::count(m), std::forward<Args>(args)...);
-                if(!rows.empty()) {
-                    return rows.front();
-                } else {
-                    return 0;
-                }
+                return this->select_scalar<int64>(sqlite_orm::count(m), std::forward<Args>(args)...);
             }
 
             /**
@@ -440,12 +2034,7 @@ namespace sqlite_orm {
             template<class F, class O, class... Args>
             double avg(F O::*m, Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto rows = this->select(sqlite_orm::avg(m), std::forward<Args>(args)...);
-                if(!rows.empty()) {
-                    return rows.front();
-                } else {
-                    return 0;
-                }
+                return this->select_scalar<double>(sqlite_orm::avg(m), std::forward<Args>(args)...);
             }
 
             template<class F, class O>
@@ -498,12 +2087,7 @@ namespace sqlite_orm {
             template<class F, class O, class... Args, class Ret = column_result_of_t<db_objects_type, F O::*>>
             std::unique_ptr<Ret> max(F O::*m, Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto rows = this->select(sqlite_orm::max(m), std::forward<Args>(args)...);
-                if(!rows.empty()) {
-                    return std::move(rows.front());
-                } else {
-                    return {};
-                }
+                return this->select_scalar<std::unique_ptr<Ret>>(sqlite_orm::max(m), std::forward<Args>(args)...);
             }
 
             /**
@@ -514,12 +2098,7 @@ namespace sqlite_orm {
             template<class F, class O, class... Args, class Ret = column_result_of_t<db_objects_type, F O::*>>
             std::unique_ptr<Ret> min(F O::*m, Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto rows = this->select(sqlite_orm::min(m), std::forward<Args>(args)...);
-                if(!rows.empty()) {
-                    return std::move(rows.front());
-                } else {
-                    return {};
-                }
+                return this->select_scalar<std::unique_ptr<Ret>>(sqlite_orm::min(m), std::forward<Args>(args)...);
             }
 
             /**
@@ -530,17 +2109,12 @@ namespace sqlite_orm {
             template<class F, class O, class... Args, class Ret = column_result_of_t<db_objects_type, F O::*>>
             std::unique_ptr<Ret> sum(F O::*m, Args&&... args) {
                 this->assert_mapped_type<O>();
-                std::vector<std::unique_ptr<double>> rows =
-                    this->select(sqlite_orm::sum(m), std::forward<Args>(args)...);
-                if(!rows.empty()) {
-                    if(rows.front()) {
-                        return std::make_unique<Ret>(std::move(*rows.front()));
-                    } else {
-                        return {};
-                    }
-                } else {
+                auto res =
+                    this->select_scalar<std::unique_ptr<double>>(sqlite_orm::sum(m), std::forward<Args>(args)...);
+                if(!res) {
                     return {};
                 }
+                return std::make_unique<Ret>(std::move(*res));
             }
 
             /**
@@ -552,12 +2126,57 @@ namespace sqlite_orm {
             template<class F, class O, class... Args>
             double total(F O::*m, Args&&... args) {
                 this->assert_mapped_type<O>();
-                auto rows = this->select(sqlite_orm::total(m), std::forward<Args>(args)...);
-                if(!rows.empty()) {
-                    return std::move(rows.front());
-                } else {
-                    return {};
+                return this->select_scalar<double>(sqlite_orm::total(m), std::forward<Args>(args)...);
+            }
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+            /**
+             *  MAX(x) query like `max()` returning the value without a heap allocation.
+             *  @return std::optional with max value or std::nullopt if sqlite engine returned null.
+             */
+            template<class F, class O, class... Args, class Ret = column_result_of_t<db_objects_type, F O::*>>
+            std::optional<Ret> max_optional(F O::*m, Args&&... args) {
+                this->assert_mapped_type<O>();
+                return this->select_scalar<std::optional<Ret>>(sqlite_orm::max(m), std::forward<Args>(args)...);
+            }
+
+            /**
+             *  MIN(x) query like `min()` returning the value without a heap allocation.
+             *  @return std::optional with min value or std::nullopt if sqlite engine returned null.
+             */
+            template<class F, class O, class... Args, class Ret = column_result_of_t<db_objects_type, F O::*>>
+            std::optional<Ret> min_optional(F O::*m, Args&&... args) {
+                this->assert_mapped_type<O>();
+                return this->select_scalar<std::optional<Ret>>(sqlite_orm::min(m), std::forward<Args>(args)...);
+            }
+
+            /**
+             *  SUM(x) query like `sum()` returning the value without a heap allocation.
+             *  @return std::optional with sum value or std::nullopt if sqlite engine returned null.
+             */
+            template<class F, class O, class... Args, class Ret = column_result_of_t<db_objects_type, F O::*>>
+            std::optional<Ret> sum_optional(F O::*m, Args&&... args) {
+                this->assert_mapped_type<O>();
+                auto res = this->select_scalar<std::optional<double>>(sqlite_orm::sum(m), std::forward<Args>(args)...);
+                if(!res) {
+                    return std::nullopt;
                 }
+                return Ret(*res);
+            }
+#endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
+
+            /**
+             *  Computes several aggregates over the same rows in one query and returns them as one row, instead
+             *  of one query and scan per aggregate.
+             *  @example: auto stats = storage.aggregate(
+             *                columns(count<Order>(), sum(&Order::amount), avg(&Order::amount), max(&Order::time)),
+             *                where(c(&Order::userId) == userId));
+             *            auto ordersCount = std::get<0>(stats);
+             *  @return the tuple of the values, or value-initialized values if the query returns no row.
+             */
+            template<class... Cols, class... Args, class R = column_result_of_t<db_objects_type, columns_t<Cols...>>>
+            R aggregate(columns_t<Cols...> cols, Args&&... args) {
+                return this->select_scalar<R>(std::move(cols), std::forward<Args>(args)...);
             }
 
             /**
@@ -570,120 +2189,969 @@ namespace sqlite_orm {
                 static_assert(!is_base_of_template_v<T, compound_operator> ||
                                   std::tuple_size<std::tuple<Args...>>::value == 0,
                               "Cannot use args with a compound operator");
-                auto statement = this->prepare(sqlite_orm::select(std::move(m), std::forward<Args>(args)...));
-                return this->execute(statement);
+                auto statement = this->prepare_cached(sqlite_orm::select(std::move(m), std::forward<Args>(args)...));
+                using is_cached_query =
+                    polyfill::bool_constant<count_tuple<std::tuple<Args...>, is_cached>::value != 0>;
+                return this->execute_select(statement, is_cached_query{});
             }
 
-            template<class T, satisfies<is_prepared_statement, T> = true>
-            std::string dump(const T& preparedStatement, bool parametrized = true) const {
-                return this->dump(preparedStatement.expression, parametrized);
+            /**
+             *  Select with common table expressions: `ctes` is one `cte(...).as(...)` or a tuple of them, which
+             *  `sel` reads like tables through the member pointers of their row types.
+             *  @example: auto active = cte("active", make_column("id", &ActiveUser::id))
+             *                              .as(select(&User::id, where(c(&User::lastSeen) > since)))
+             *                              .materialized();
+             *            storage.with(active, select(count<ActiveUser>()));
+             */
+            template<class CTEs, class T, class... Args, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> with(CTEs ctes, select_t<T, Args...> sel) {
+                return this->execute(this->prepare_cached(sqlite_orm::with(std::move(ctes), std::move(sel))));
             }
 
-            template<class E,
-                     class Ex = polyfill::remove_cvref_t<E>,
-                     std::enable_if_t<!is_prepared_statement_v<Ex> && !is_mapped_v<db_objects_type, Ex>, bool> = true>
-            std::string dump(E&& expression, bool parametrized = false) const {
-                static_assert(is_preparable_v<self, Ex>, "Expression must be a high-level statement");
+            /**
+             *  Same as `with()` with WITH RECURSIVE, so that a CTE may read itself.
+             */
+            template<class CTEs, class T, class... Args, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> with_recursive(CTEs ctes, select_t<T, Args...> sel) {
+                return this->execute(
+                    this->prepare_cached(sqlite_orm::with_recursive(std::move(ctes), std::move(sel))));
+            }
 
-                decltype(auto) e2 = static_if<is_select_v<Ex>>(
-                    [](auto expression) -> auto{
-                        expression.highest_level = true;
-                        return expression;
-                    },
-                    [](const auto& expression) -> decltype(auto) {
-                        return (expression);
-                    })(std::forward<E>(expression));
-                using context_t = serializer_context<db_objects_type>;
-                context_t context{this->db_objects};
-                context.replace_bindable_with_question = parametrized;
-                // just like prepare_impl()
-                context.skip_table_name = false;
-                return serialize(e2, context);
+            /**
+             *  Runs `statement` with a RETURNING clause of `columns`, see `sqlite_orm::returning()`.
+             *  @return the result columns of the rows written by the statement.
+             */
+            template<class S, class T, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> returning(S statement, T columns) {
+                return this->execute(this->prepare_cached(sqlite_orm::returning(std::move(statement), std::move(columns))));
             }
 
             /**
-             *  Returns a string representation of object of a class mapped to the storage.
-             *  Type of string has json-like style.
+             *  Same as `returning()` for the objects of an `insert_range()`, which are inserted in chunks like by
+             *  `storage.insert_range()`. The rows are returned in the order of the objects.
              */
-            template<class O, satisfies<is_mapped, db_objects_type, O> = true>
-            std::string dump(const O& object) const {
-                auto& table = this->get_table<O>();
-                std::stringstream ss;
-                ss << "{ ";
-                table.for_each_column([&ss, &object, first = true](auto& column) mutable {
-                    using column_type = std::decay_t<decltype(column)>;
-                    using field_type = typename column_type::field_type;
-                    constexpr std::array<const char*, 2> sep = {", ", ""};
+            template<class It, class L, class O, class T, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> returning(insert_range_t<It, L, O> statement, T columns) {
+                this->assert_insertable_type<O>();
+                return this->returning_in_chunks(std::move(statement),
+                                                 std::move(columns),
+                                                 this->insertable_columns_count<O>());
+            }
 
-                    ss << sep[std::exchange(first, false)] << column.name << " : '"
-                       << field_printer<field_type>{}(polyfill::invoke(column.member_pointer, object)) << "'";
-                });
-                ss << " }";
-                return ss.str();
+            /**
+             *  Same as `returning()` for the objects of a `replace_range()`, which are replaced in chunks like by
+             *  `storage.replace_range()`.
+             */
+            template<class It, class L, class O, class T, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> returning(replace_range_t<It, L, O> statement, T columns) {
+                return this->returning_in_chunks(std::move(statement),
+                                                 std::move(columns),
+                                                 this->get_table<O>().non_generated_columns_count());
             }
 
             /**
-             *  This is REPLACE (INSERT OR REPLACE) function.
-             *  Also if you need to insert value with knows id you should
-             *  also you this function instead of insert cause inserts ignores
-             *  id and creates own one.
+             *  Same as `select` but doesn't collect rows: `callback` is called with every row as soon as it is stepped.
+             *  `callback` may return false to stop iterating.
+             *  R is the type every row is extracted as. It defaults to the result type of `select` but may be set
+             *  to non-owning types like `std::string_view`, `std::span<const std::byte>` or tuples of them
+             *  which point straight into the row buffer of sqlite and are valid only until `callback` returns.
+             *  @example: storage.for_each_row<std::string_view>(select(&Log::message), [](std::string_view message) {...});
              */
-            template<class O>
-            void replace(const O& o) {
+            template<class R = void, class T, class... Args, class F>
+            void for_each_row(select_t<T, Args...> expression, F&& callback) {
+                auto statement = this->prepare_cached(std::move(expression));
+                this->for_each_row<R>(statement, std::forward<F>(callback));
+            }
+
+            template<class R = void, class T, class... Args, class F>
+            void for_each_row(const prepared_statement_t<select_t<T, Args...>>& statement, F&& callback) {
+                using row_type =
+                    std::conditional_t<std::is_void<R>::value, column_result_of_t<db_objects_type, T>, R>;
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+
+                bind_changed_parameters(statement, statement.expression);
+
+                auto rowExtractor = make_select_row_extractor<row_type, T>(this->db_objects);
+                tracer.phase(execute_phase::step);
+                perform_steps_while(stmt, tracer.extracting([&rowExtractor, &callback](sqlite3_stmt* stmt) {
+                    return call_row_callback(callback, rowExtractor.extract(stmt, 0));
+                }));
+            }
+
+            /**
+             *  The objects `get_all<O>(args...)` would return as a JSON array of objects keyed by column name,
+             *  e.g. `[{"id":1,"name":"Ann"},{"id":2,"name":null}]`, ready to be sent as is. SQLite makes the
+             *  JSON object of every row with `json_object()` and its text is appended to the result: no object
+             *  is built and no field is formatted by C++. `order_by()` and `limit()` apply, unlike to a
+             *  `json_group_array()` aggregate which collects rows in scan order.
+             *  Numbers stay numbers, NULL becomes null and booleans become 0 or 1. BLOB columns can't be
+             *  converted, the statement fails then. Needs the JSON1 functions.
+             *  @example: auto json = storage.select_json<User>(where(c(&User::age) > 18), order_by(&User::id));
+             */
+#ifdef SQLITE_ENABLE_JSON1
+            template<class O, class... Args>
+            std::string select_json(Args... args) {
                 this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::replace(std::ref(o)));
-                this->execute(statement);
+                auto expression =
+                    sqlite_orm::select(make_table_json_object(this->get_table<O>()), std::move(args)...);
+                std::string res{"["};
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+                using row_type = std::string_view;
+#else
+                using row_type = std::string;
+#endif
+                this->for_each_row<row_type>(std::move(expression), [&res](const row_type& object) {
+                    if(res.size() > 1) {
+                        res += ',';
+                    }
+                    res.append(object.data(), object.size());
+                });
+                res += ']';
+                return res;
             }
+#endif  //  SQLITE_ENABLE_JSON1
 
-            template<class It, class Projection = polyfill::identity>
-            void replace_range(It from, It to, Projection project = {}) {
-                using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+#ifdef SQLITE_ORM_COROUTINES_SUPPORTED
+            /**
+             *  Same as `get_all<O>(args...)` but yields the objects one by one as they are stepped, into one object
+             *  reused for every row. The statement and its connection live as long as the stream, and rows stop
+             *  being stepped as soon as the consumer stops iterating, e.g. in a lazy pipeline:
+             *  @example: for(auto& user: storage.stream<User>(where(c(&User::age) > 18)) |
+             *                             std::views::filter(isActive) | std::views::take(10)) {...}
+             */
+            template<class O, class... Args>
+            row_stream<O> stream(Args... args) {
                 this->assert_mapped_type<O>();
-                if(from == to) {
-                    return;
+                auto statement = this->prepare(sqlite_orm::get_all<O>(std::move(args)...));
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                bind_changed_parameters(statement, statement.expression);
+                auto& table = this->get_table<O>();
+                auto& conditions = statement.expression.conditions;
+                auto lazySource = this->lazy_source_of<O>();
+                O object;
+                while(step_row(stmt)) {
+                    build_object(object, stmt, table, conditions, lazySource);
+                    co_yield object;
                 }
+            }
 
-                auto statement =
-                    this->prepare(sqlite_orm::replace_range(std::move(from), std::move(to), std::move(project)));
-                this->execute(statement);
+            /**
+             *  Same as `select(expression)` but yields the rows one by one as they are stepped, like
+             *  `stream<O>()`.
+             *  @example: for(auto& [id, name]: storage.stream(select(columns(&User::id, &User::name)))) {...}
+             */
+            template<class T, class... Args>
+            row_stream<column_result_of_t<db_objects_type, T>> stream(select_t<T, Args...> expression) {
+                using row_type = column_result_of_t<db_objects_type, T>;
+                auto statement = this->prepare(std::move(expression));
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                bind_changed_parameters(statement, statement.expression);
+                auto rowExtractor = make_select_row_extractor<row_type, T>(this->db_objects);
+                row_type row;
+                while(step_row(stmt)) {
+                    row = rowExtractor.extract(stmt, 0);
+                    co_yield row;
+                }
             }
+#endif
 
-            template<class O, class It, class Projection = polyfill::identity>
-            void replace_range(It from, It to, Projection project = {}) {
-                this->assert_mapped_type<O>();
-                if(from == to) {
-                    return;
+            /**
+             *  Same as `select(columns, conditions...)` but calls `callback` for every row instead of collecting them,
+             *  so only one row is kept in memory at a time. `callback` may return false to stop iterating.
+             *  @example: storage.select_each(columns(&User::id, &User::name), [](std::tuple<int, std::string> row) {...}, where(...));
+             */
+            template<class T, class F, class... Args>
+            void select_each(T m, F&& callback, Args... args) {
+                this->for_each_row(sqlite_orm::select(std::move(m), std::forward<Args>(args)...),
+                                   std::forward<F>(callback));
+            }
+
+            /**
+             *  Same as `select(m, args...)` but adds the rows to `container` as they are stepped, without a vector of
+             *  the rows in between: at the end of sequences, into sets, and into maps for a selection of two columns,
+             *  the key and the value. A key already in a set or a map keeps its element. The rows are read as the
+             *  value type of the container, or as a tuple of the key and the mapped type of a map.
+             *  @example: std::unordered_set<std::string> tags;
+             *            storage.select_into(tags, distinct(&Post::tag));
+             *            std::unordered_map<std::string, int> postsByTag;
+             *            storage.select_into(postsByTag, columns(&Post::tag, count<Post>()), group_by(&Post::tag));
+             */
+            template<class C, class T, class... Args, class = typename C::value_type>
+            void select_into(C& container, T m, Args... args) {
+                auto statement = this->prepare_cached(sqlite_orm::select(std::move(m), std::forward<Args>(args)...));
+                this->select_into(container, statement);
+            }
+
+            template<class C, class T, class... Args, class = typename C::value_type>
+            void select_into(C& container, const prepared_statement_t<select_t<T, Args...>>& statement) {
+                this->for_each_row<container_row_t<C>>(statement, [&container](container_row_t<C> row) {
+                    insert_row(container, std::move(row));
+                });
+            }
+
+            /**
+             *  Same as `select(columns(...), conditions...)` but returns the result column by column: a tuple of
+             *  one `column_data` per column, whose contiguous `values` are filled straight from the statement
+             *  without building row tuples. Nullable columns like `std::optional<double>` get a null flag per
+             *  row in `nulls` (see `column_data`). The columns must be of single-value types, not mapped objects.
+             *  @example: auto result = storage.select_columnar(columns(&Trade::price, &Trade::volume));
+             *            const std::vector<double>& prices = std::get<0>(result).values;
+             */
+            template<class... Cols, class... Args>
+            auto select_columnar(columns_t<Cols...> cols, Args... args) {
+                using row_type = column_result_of_t<db_objects_type, columns_t<Cols...>>;
+                auto statement = this->prepare_cached(sqlite_orm::select(std::move(cols), std::move(args)...));
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+
+                bind_changed_parameters(statement, statement.expression);
+
+                auto res = columnar_result<row_type>::make();
+                tracer.phase(execute_phase::step);
+                perform_steps(stmt, tracer.extracting([&res](sqlite3_stmt* stmt) {
+                    columnar_result<row_type>::append_row(res, stmt);
+                }));
+                return res;
+            }
+
+            /**
+             *  Reads the rows of `statement` into the caller-owned buffer [out, out + capacity) and returns how
+             *  many it wrote. Nothing is allocated and no row objects are built: column I of a row is extracted
+             *  straight into element I of Out as the type of that element, Out being tuple-like, e.g.
+             *  `std::pair<int64, double>`, `std::tuple` or `std::array`, or any single column type otherwise.
+             *  If the buffer fills up the statement stays where it is, so the next call continues with the rows
+             *  after it. A call returning less than `capacity` has read the last row; the call after it starts
+             *  over, rebinding the statement. Executing the statement otherwise starts it over as well.
+             *  @example: std::array<std::pair<int64, double>, 4096> buffer;
+             *            auto statement = storage.prepare(select(columns(&Sample::ts, &Sample::value)));
+             *            size_t count;
+             *            do {
+             *                count = storage.select_into(statement, buffer.data(), buffer.size());
+             *                upload(buffer.data(), count);
+             *            } while(count == buffer.size());
+             */
+            template<class T, class... Args, class Out>
+            size_t select_into(const prepared_statement_t<select_t<T, Args...>>& statement, Out* out, size_t capacity) {
+                static_assert(fits_flat_row_v<T, Out>, "The rows of the buffer must have one element per column");
+                sqlite3_stmt* stmt = statement.stmt;
+                auto tracer = this->make_execute_tracer(stmt);
+                if(!sqlite3_stmt_busy(stmt)) {
+                    reset_stmt(stmt);
+                    bind_changed_parameters(statement, statement.expression);
                 }
+                tracer.phase(execute_phase::step);
+                size_t count = 0;
+                while(count < capacity) {
+                    switch(step_stmt(stmt)) {
+                        case SQLITE_ROW:
+                            tracer.phase(execute_phase::extract);
+                            extract_flat_row(out[count++], stmt);
+                            tracer.phase(execute_phase::step);
+                            break;
+                        case SQLITE_DONE:
+                            return count;
+                        default:
+                            throw_translated_sqlite_error(stmt);
+                    }
+                }
+                return count;
+            }
 
-                auto statement =
-                    this->prepare(sqlite_orm::replace_range<O>(std::move(from), std::move(to), std::move(project)));
-                this->execute(statement);
+            /**
+             *  Same as `select(m, args...)` but reads at most `capacity` rows into [out, out + capacity) like the
+             *  prepared `select_into()`, and returns how many it wrote. The statement is reset afterwards: use a
+             *  prepared statement to continue with the rows which didn't fit.
+             */
+            template<class T, class Out, class... Args, satisfies_not<is_prepared_statement, T> = true>
+            size_t select_into(T m, Out* out, size_t capacity, Args... args) {
+                auto statement = this->prepare_cached(sqlite_orm::select(std::move(m), std::forward<Args>(args)...));
+                reset_stmt(statement.stmt);
+                size_t count = this->select_into(statement, out, capacity);
+                reset_stmt(statement.stmt);
+                return count;
             }
 
-            template<class O, class... Cols>
-            int insert(const O& o, columns_t<Cols...> cols) {
-                static_assert(cols.count > 0, "Use insert or replace with 1 argument instead");
-                this->assert_mapped_type<O>();
-                auto statement = this->prepare(sqlite_orm::insert(std::ref(o), std::move(cols)));
-                return int(this->execute(statement));
+#if __cpp_lib_span >= 202002L
+            template<class T, class... Args, class Out>
+            size_t select_into(const prepared_statement_t<select_t<T, Args...>>& statement, std::span<Out> out) {
+                return this->select_into(statement, out.data(), out.size());
+            }
+
+            template<class T, class Out, class... Args, satisfies_not<is_prepared_statement, T> = true>
+            size_t select_into(T m, std::span<Out> out, Args... args) {
+                return this->select_into(std::move(m), out.data(), out.size(), std::move(args)...);
+            }
+#endif
+
+#ifdef SQLITE_ORM_ARROW_ENABLED
+            /**
+             *  Exports the result of `expression` to `out` as an Arrow C stream (see the Arrow C data interface)
+             *  of struct batches of `batchSize` rows, one child array per column named like the result column.
+             *  The columns must be of arithmetic, `std::string` or `std::vector<char>` types, nullable ones
+             *  like `std::optional<double>` getting a validity bitmap. Rows are stepped lazily by the consumer's
+             *  `get_next()`; the stream keeps the statement and its connection until it is released.
+             *  @example: ArrowArrayStream stream;
+             *            storage.export_arrow(&stream, select(columns(&Trade::price, &Trade::volume)));
+             */
+            template<class T, class... Args>
+            void export_arrow(ArrowArrayStream* out, select_t<T, Args...> expression, size_t batchSize = 65536) {
+                using row_type = typename arrow_row<column_result_of_t<db_objects_type, T>>::type;
+                auto statement = this->prepare(std::move(expression));
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                bind_changed_parameters(statement, statement.expression);
+                make_arrow_stream<row_type>(out, std::move(statement), batchSize);
             }
 
             /**
-             *  Insert routine. Inserts object with all non primary key fields in passed object. Id of passed
-             *  object doesn't matter.
-             *  @return id of just created object.
+             *  Same as `export_arrow(out, select(asterisk<O>(true), conditions...), batchSize)`: exports all the
+             *  columns of the table of O in their declared order.
              */
-            template<class O>
-            int insert(const O& o) {
+            template<class O, class... Args>
+            void export_arrow(ArrowArrayStream* out, size_t batchSize, Args... conditions) {
                 this->assert_mapped_type<O>();
-                this->assert_insertable_type<O>();
-                auto statement = this->prepare(sqlite_orm::insert(std::ref(o)));
-                return int(this->execute(statement));
+                this->export_arrow(out, sqlite_orm::select(asterisk<O>(true), std::move(conditions)...), batchSize);
             }
 
             /**
-             *  Raw insert routine. Use this if `insert` with object does not fit you. This insert is designed to be able
-             *  to call any type of `INSERT` query with no limitations.
+             *  Stores the rows of the Arrow C stream `stream` of struct batches as objects of type O, child arrays
+             *  being matched to the columns of O by name, in one transaction. Columns without a child array keep
+             *  the value of a default-constructed O. The rows are replaced if the stream has all primary key
+             *  columns and inserted otherwise. Takes ownership of `stream` and releases it.
+             *  Throws `orm_error_code::incompatible_arrow_format` if a child's format can't be read into its field.
+             *  @return number of imported rows.
+             */
+            template<class O>
+            size_t import_arrow(ArrowArrayStream* stream) {
+                this->assert_mapped_type<O>();
+                arrow_stream_reader reader{stream};
+                auto& table = this->get_table<O>();
+                std::vector<int64_t> children;
+                table.for_each_column([&reader, &children](auto& column) {
+                    children.push_back(reader.child_index(column.name));
+                });
+                bool withPrimaryKey = true;
+                for(auto& name: table.primary_key_column_names()) {
+                    withPrimaryKey = withPrimaryKey && reader.child_index(name) != -1;
+                }
+
+                size_t count = 0;
+                std::vector<O> objects;
+                auto guard = this->transaction_guard();
+                while(reader.next()) {
+                    objects.clear();
+                    objects.resize(size_t(reader.batch.length));
+                    for(size_t row = 0; row < objects.size(); ++row) {
+                        size_t columnIndex = 0;
+                        table.for_each_column([&reader, &children, &objects, row, &columnIndex](auto& column) {
+                            const auto child = children[columnIndex++];
+                            if(child != -1) {
+                                arrow_value_view value{reader.schema.children[child]->format,
+                                                       reader.batch.children[child],
+                                                       int64_t(row)};
+                                read_arrow_field(objects[row], column, value);
+                            }
+                        });
+                    }
+                    if(objects.empty()) {
+                        continue;
+                    }
+                    if(withPrimaryKey) {
+                        this->replace_range(objects.begin(), objects.end());
+                    } else {
+                        this->insert_range(objects.begin(), objects.end());
+                    }
+                    count += objects.size();
+                }
+                guard.commit();
+                return count;
+            }
+#endif
+
+            /**
+             *  Inserts the records of the CSV file `path` into the table of O, the fields of a record being
+             *  the values of the columns `mapping` in order. Records are read block by block and their fields
+             *  are bound straight from the read buffer into one reused multi-row `INSERT` statement, see
+             *  `csv_options` for the statement and transaction sizes and the temporary bulk load profile.
+             *  An unquoted empty field of a nullable column is null.
+             *  Throws `orm_error_code::invalid_csv_record` if a record is malformed or has another number of
+             *  fields, rows inserted by former transactions then stay.
+             *  @return number of inserted rows.
+             *  @example: storage.import_csv<Trade>("trades.csv", columns(&Trade::symbol, &Trade::price));
+             */
+            template<class O, class... Cols>
+            size_t import_csv(const std::string& path, columns_t<Cols...> mapping, const csv_options& options = {}) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                std::vector<std::string> names;
+                std::vector<void (*)(sqlite3_stmt*, int, const csv_field&)> binders;
+                iterate_tuple(mapping.columns, [&table, &names, &binders](auto& memberPointer) {
+                    auto name = table.find_column_name(memberPointer);
+                    if(!name) {
+                        throw std::system_error{orm_error_code::column_not_found};
+                    }
+                    names.push_back(*name);
+                    binders.push_back(bind_csv_field<member_field_type_t<std::decay_t<decltype(memberPointer)>>>);
+                });
+                return this->import_csv_internal(path, table, names, binders, options);
+            }
+
+            /**
+             *  Same as `import_csv<O>(path, mapping, options)` with the fields of a record being the values of
+             *  all the columns of O in their declared order.
+             */
+            template<class O>
+            size_t import_csv(const std::string& path, const csv_options& options = {}) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                std::vector<std::string> names;
+                std::vector<void (*)(sqlite3_stmt*, int, const csv_field&)> binders;
+                table.for_each_column([&names, &binders](auto& column) {
+                    using column_type = std::decay_t<decltype(column)>;
+                    names.push_back(column.name);
+                    binders.push_back(bind_csv_field<typename column_type::field_type>);
+                });
+                return this->import_csv_internal(path, table, names, binders, options);
+            }
+
+            /**
+             *  Same as `get_all<O>(conditions...)` but calls `callback` with every object (as an rvalue)
+             *  instead of collecting them, so only one object is kept in memory at a time.
+             *  `callback` may return false to stop iterating.
+             *  @example: storage.for_each<User>([](const User& user) {...}, where(c(&User::id) > 10));
+             */
+            template<class O, class F, class... Args>
+            void for_each(F&& callback, Args&&... args) {
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::get_all<O>(std::forward<Args>(args)...));
+                this->for_each(statement, std::forward<F>(callback));
+            }
+
+            /**
+             *  Same as `for_each<O>(callback, conditions...)` with a prepared `get_all` statement.
+             */
+            template<class O, class R, class... Args, class F>
+            void for_each(const prepared_statement_t<get_all_t<O, R, Args...>>& statement, F&& callback) {
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+
+                bind_changed_parameters(statement, statement.expression);
+
+                auto& table = this->get_table<O>();
+                auto& conditions = statement.expression.conditions;
+                auto lazySource = this->lazy_source_of<O>();
+                tracer.phase(execute_phase::step);
+                auto extract = [&table, &conditions, &callback, &lazySource](sqlite3_stmt* stmt) {
+                    O obj;
+                    build_object(obj, stmt, table, conditions, lazySource);
+                    return call_row_callback(callback, std::move(obj));
+                };
+                perform_steps_while(stmt, tracer.extracting(extract));
+            }
+
+            /**
+             *  Returns a cursor reading the objects of type O page by page, `pageSize` objects a page, sorted by
+             *  the member pointers `keys` which have to identify an object. Every page is read with
+             *  `WHERE (keys) > (last keys) ORDER BY keys LIMIT pageSize` instead of an OFFSET growing with every
+             *  page. Pages are read with `pager.next()` or streamed with `pager.next(callback)`.
+             *  @example: auto pager = storage.paginate<User>(columns(&User::created, &User::id), 100);
+             *            for(auto page = pager.next(); !page.empty(); page = pager.next()) {...}
+             */
+            template<class O, class... Keys>
+            keyset_pager<self, object_page_query<O>, no_page_condition, Keys...> paginate(columns_t<Keys...> keys,
+                                                                                          int pageSize) {
+                this->assert_mapped_type<O>();
+                return {*this, {}, std::move(keys.columns), pageSize, {}};
+            }
+
+            /**
+             *  Same as `paginate<O>(keys, pageSize)` but only with the objects matching `condition`.
+             *  @example: storage.paginate<User>(columns(&User::id), 100, where(c(&User::active) == true));
+             */
+            template<class O, class... Keys, class W>
+            keyset_pager<self, object_page_query<O>, W, Keys...>
+            paginate(columns_t<Keys...> keys, int pageSize, where_t<W> condition) {
+                this->assert_mapped_type<O>();
+                return {*this, {}, std::move(keys.columns), pageSize, std::move(condition.expression)};
+            }
+
+            /**
+             *  Same as `paginate<O>(keys, pageSize)` for `select(columns(...))`: rows are tuples of `cols` followed by
+             *  the `keys`.
+             *  @example: storage.paginate(columns(&User::name), columns(&User::id), 100);
+             *            - SELECT name, id FROM users WHERE (id) > (?) ORDER BY id LIMIT 100
+             */
+            template<class... Cols, class... Keys>
+            keyset_pager<self, columns_page_query<columns_t<Cols...>, std::tuple<Keys...>>, no_page_condition, Keys...>
+            paginate(columns_t<Cols...> cols, columns_t<Keys...> keys, int pageSize) {
+                return {*this,
+                        make_columns_page_query(std::move(cols), keys.columns),
+                        std::move(keys.columns),
+                        pageSize,
+                        {}};
+            }
+
+            template<class... Cols, class... Keys, class W>
+            keyset_pager<self, columns_page_query<columns_t<Cols...>, std::tuple<Keys...>>, W, Keys...>
+            paginate(columns_t<Cols...> cols, columns_t<Keys...> keys, int pageSize, where_t<W> condition) {
+                return {*this,
+                        make_columns_page_query(std::move(cols), keys.columns),
+                        std::move(keys.columns),
+                        pageSize,
+                        std::move(condition.expression)};
+            }
+
+            /**
+             *  Reads the objects of type O that reference the objects of `parents` by the column `foreignKey`
+             *  of a `foreign_key()` of O's table, with one query instead of one per parent, and returns them
+             *  grouped by the value of `foreignKey`. Every parent has an entry, empty if no object references
+             *  it. The key values are bound as one array, see `as_array()`, so they are of arithmetic types
+             *  or std::string. `conditions` are more conditions of the query like `order_by()` but no `where()`.
+             *  throws std::system_error{orm_error_code::column_not_found} if O's table has no foreign key
+             *  `foreignKey` referencing the type of `parents`.
+             *  @example: auto items = storage.prefetch<LineItem>(orders, &LineItem::orderId, order_by(&LineItem::id));
+             *            for(auto& order: orders) {
+             *                const std::vector<LineItem>& orderItems = items[order.id];
+             *            }
+             */
+            template<class O,
+                     class R,
+                     class F,
+                     class... Args,
+                     std::enable_if_t<!polyfill::disjunction_v<std::is_member_object_pointer<Args>...>, bool> = true>
+            std::map<member_field_type_t<F>, std::vector<O>>
+            prefetch(const R& parents, F foreignKey, Args... conditions) {
+                this->assert_mapped_type<O>();
+                using parent_type = std::decay_t<decltype(*std::begin(parents))>;
+                std::vector<member_field_type_t<F>> keys;
+                bool found = false;
+                this->get_table<O>().template for_each_foreign_key_to<parent_type>(
+                    [&parents, &foreignKey, &keys, &found](auto& foreignKeyConstraint) {
+                        using columns_type = typename std::decay_t<decltype(foreignKeyConstraint)>::columns_type;
+                        call_if_constexpr<std::tuple_size<columns_type>::value == 1 &&
+                                          std::is_same<std::tuple_element_t<0, columns_type>, F>::value>(
+                            [&parents, &foreignKey, &keys, &found](auto& fk) {
+                                if(found || std::get<0>(fk.columns) != foreignKey) {
+                                    return;
+                                }
+                                found = true;
+                                auto& reference = std::get<0>(fk.references);
+                                for(auto& parent: parents) {
+                                    keys.push_back(polyfill::invoke(reference, parent));
+                                }
+                            },
+                            foreignKeyConstraint);
+                    });
+                if(!found) {
+                    throw std::system_error{orm_error_code::column_not_found};
+                }
+                return this->prefetch_keys<O>(std::move(keys), foreignKey, std::move(conditions)...);
+            }
+
+            /**
+             *  Same as `prefetch<O>(parents, foreignKey)` with the key of a parent given by `parentKey` instead of
+             *  a foreign key of the schema.
+             *  @example: auto children = storage.prefetch<Node>(nodes, &Node::id, &Node::parentId);
+             */
+            template<class O,
+                     class R,
+                     class K,
+                     class F,
+                     class... Args,
+                     std::enable_if_t<std::is_member_object_pointer<F>::value, bool> = true>
+            std::map<member_field_type_t<F>, std::vector<O>>
+            prefetch(const R& parents, K parentKey, F foreignKey, Args... conditions) {
+                this->assert_mapped_type<O>();
+                std::vector<member_field_type_t<F>> keys;
+                for(auto& parent: parents) {
+                    keys.push_back(polyfill::invoke(parentKey, parent));
+                }
+                return this->prefetch_keys<O>(std::move(keys), foreignKey, std::move(conditions)...);
+            }
+
+          protected:
+            template<class O, class K, class F, class... Args>
+            std::map<K, std::vector<O>> prefetch_keys(std::vector<K> keys, F foreignKey, Args... conditions) {
+                static_assert(count_tuple<std::tuple<Args...>, is_where>::value == 0,
+                              "prefetch() makes the WHERE clause itself");
+                std::map<K, std::vector<O>> res;
+                for(auto& key: keys) {
+                    res[std::move(key)];
+                }
+                if(res.empty()) {
+                    return res;
+                }
+                keys.clear();
+                for(auto& group: res) {
+                    keys.push_back(group.first);
+                }
+                auto statement = this->prepare_cached(
+                    sqlite_orm::get_all<O>(sqlite_orm::where(sqlite_orm::in(foreignKey, as_array(std::move(keys)))),
+                                           std::move(conditions)...));
+                this->for_each(statement, [&res, foreignKey](O object) {
+                    auto& group = res[object.*foreignKey];
+                    group.push_back(std::move(object));
+                });
+                return res;
+            }
+
+          public:
+            /**
+             *  `get_all<O>(args...)` read by up to `threads` threads at once: the rowid range of O's table is split
+             *  into as many sub-ranges, each being read on a pooled connection of its own. The rows of the
+             *  sub-ranges are concatenated in rowid order, or merged by the first `order_by()` of a member of O,
+             *  and truncated to `limit()`; OFFSET isn't supported.
+             *  If SQLite is built with SQLITE_ENABLE_SNAPSHOT and the database is in WAL mode, all sub-ranges read
+             *  the same snapshot of the database. Otherwise every sub-range reads the rows committed when it starts.
+             *  The calling thread keeps one connection for the rowid bounds, so the storage reads on at most
+             *  `pool_options::size - 1` threads. A storage without a pool reads on the calling thread.
+             *  @example: auto orders = storage.parallel_get_all<Order>(4, where(c(&Order::year) == 2026));
+             */
+            template<class O, class... Args>
+            std::vector<O> parallel_get_all(size_t threads, Args... args) {
+                shard_merge<O> merge;
+                iterate_tuple(std::tie(args...), [&merge](auto& arg) {
+                    collect_shard_merge(merge, arg);
+                    collect_shard_limit(merge, arg);
+                });
+                return this->parallel_get_all_ranges<O>(threads, merge, [&args...](auto range) {
+                    return sqlite_orm::get_all<O>(sqlite_orm::where(std::move(range)), args...);
+                });
+            }
+
+            /**
+             *  Same as `parallel_get_all<O>(threads, args...)` with `condition` combined with the rowid range of
+             *  every thread.
+             */
+            template<class O, class C, class... Args>
+            std::vector<O> parallel_get_all(size_t threads, where_t<C> condition, Args... args) {
+                shard_merge<O> merge;
+                iterate_tuple(std::tie(args...), [&merge](auto& arg) {
+                    collect_shard_merge(merge, arg);
+                    collect_shard_limit(merge, arg);
+                });
+                return this->parallel_get_all_ranges<O>(threads, merge, [&condition, &args...](auto range) {
+                    return sqlite_orm::get_all<O>(sqlite_orm::where(condition.expression && std::move(range)),
+                                                  args...);
+                });
+            }
+
+          protected:
+            template<class O, class F>
+            std::vector<O>
+            parallel_get_all_ranges(size_t threads, const shard_merge<O>& merge, const F& makeStatement) {
+                this->assert_mapped_type<O>();
+                static_assert(!storage_pick_table_t<O, db_objects_type>::is_without_rowid_v,
+                              "parallel_get_all() splits the rowid range, WITHOUT ROWID tables have none");
+                if(this->pool) {
+                    auto readers = size_t(this->pool->size()) - (this->pool->options.single_writer ? 1 : 0);
+                    threads = std::min(threads, readers - 1);
+                }
+                if(!this->pool || threads < 2) {
+                    return this->execute(this->prepare_cached(makeStatement(
+                        sqlite_orm::between(sqlite_orm::rowid<O>(),
+                                            std::numeric_limits<int64>::min(),
+                                            std::numeric_limits<int64>::max()))));
+                }
+
+#ifdef SQLITE_ENABLE_SNAPSHOT
+                //  the calling thread keeps the snapshot's read transaction, so the bounds are read from it too
+                std::unique_ptr<read_snapshot> snapshot;
+                try {
+                    snapshot = std::make_unique<read_snapshot>(this->snapshot());
+                } catch(const std::system_error&) {
+                    //  not in WAL mode: every range reads the rows committed when it starts
+                }
+#endif
+                auto bounds = this->select(
+                    columns(sqlite_orm::min(sqlite_orm::rowid<O>()), sqlite_orm::max(sqlite_orm::rowid<O>())));
+                auto& lowest = std::get<0>(bounds.front());
+                auto& highest = std::get<1>(bounds.front());
+                if(!lowest || !highest) {
+                    return {};
+                }
+                //  unsigned arithmetic doesn't overflow for any rowid range
+                const auto width = uint64(*highest) - uint64(*lowest) + 1;
+                const auto step = width / threads + (width % threads ? 1 : 0);
+                std::vector<std::future<std::vector<O>>> futures;
+                for(uint64 offset = 0; offset < width; offset += step) {
+                    const auto first = int64(uint64(*lowest) + offset);
+                    const auto last = int64(uint64(*lowest) + std::min(offset + step, width) - 1);
+                    futures.push_back(std::async(std::launch::async, [&, first, last] {
+                        auto read = [this, &makeStatement, first, last] {
+                            auto range = sqlite_orm::between(sqlite_orm::rowid<O>(), first, last);
+                            return this->execute(this->prepare_cached(makeStatement(std::move(range))));
+                        };
+#ifdef SQLITE_ENABLE_SNAPSHOT
+                        if(snapshot) {
+                            return this->with_snapshot(*snapshot, read);
+                        }
+#endif
+                        return read();
+                    }));
+                }
+                std::vector<std::vector<O>> parts;
+                for(auto& future: futures) {
+                    parts.push_back(future.get());
+                }
+                return merge_shard_rows(std::move(parts), merge.less, merge.limited, merge.limit);
+            }
+
+          public:
+            template<class T, satisfies<is_prepared_statement, T> = true>
+            std::string dump(const T& preparedStatement, bool parametrized = true) const {
+                return this->dump(preparedStatement.expression, parametrized);
+            }
+
+            template<class E,
+                     class Ex = polyfill::remove_cvref_t<E>,
+                     std::enable_if_t<!is_prepared_statement_v<Ex> && !is_mapped_v<db_objects_type, Ex>, bool> = true>
+            std::string dump(E&& expression, bool parametrized = false) const {
+                static_assert(is_preparable_v<self, Ex>, "Expression must be a high-level statement");
+
+                decltype(auto) e2 = static_if<is_select_v<Ex>>(
+                    [](auto expression) -> auto{
+                        expression.highest_level = true;
+                        return expression;
+                    },
+                    [](const auto& expression) -> decltype(auto) {
+                        return (expression);
+                    })(std::forward<E>(expression));
+                using context_t = serializer_context<db_objects_type>;
+                context_t context{this->db_objects};
+                context.replace_bindable_with_question = parametrized;
+                // just like prepare_impl()
+                context.skip_table_name = false;
+                return serialize(e2, context);
+            }
+
+#if SQLITE_VERSION_NUMBER >= 3024000
+            /**
+             *  Runs `EXPLAIN QUERY PLAN` for a prepared statement or a statement expression and returns the plan.
+             *  Bound values are passed as literals (like `dump(statement, false)`), so the plan is computed
+             *  for the values the statement currently holds.
+             */
+            template<class E>
+            query_plan explain_query_plan(const E& expression) {
+                auto con = this->get_connection();
+                return internal::explain_query_plan(con.get(), this->dump(expression, false));
+            }
+#endif
+
+            /**
+             *  Returns a string representation of object of a class mapped to the storage.
+             *  Type of string has json-like style.
+             */
+            template<class O, satisfies<is_mapped, db_objects_type, O> = true>
+            std::string dump(const O& object) const {
+                auto& table = this->get_table<O>();
+                std::stringstream ss;
+                ss << "{ ";
+                table.for_each_column([&ss, &object, first = true](auto& column) mutable {
+                    using column_type = std::decay_t<decltype(column)>;
+                    using field_type = typename column_type::field_type;
+                    constexpr std::array<const char*, 2> sep = {", ", ""};
+
+                    ss << sep[std::exchange(first, false)] << column.name << " : '"
+                       << field_printer<field_type>{}(polyfill::invoke(column.member_pointer, object)) << "'";
+                });
+                ss << " }";
+                return ss.str();
+            }
+
+            /**
+             *  This is REPLACE (INSERT OR REPLACE) function.
+             *  Also if you need to insert value with knows id you should
+             *  also you this function instead of insert cause inserts ignores
+             *  id and creates own one.
+             */
+            template<class O>
+            void replace(const O& o) {
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::replace(std::ref(o)));
+                this->execute(statement);
+                this->invalidate_cached_object(o);
+            }
+
+            /**
+             *  Same as `replace(const O&)` but also sets the rowid member of `o` if its table has one, see
+             *  `with_rowid_member()`.
+             */
+            template<class O>
+            void replace(O& o) {
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::replace(std::cref(o)));
+                this->execute(statement);
+                this->invalidate_cached_object(o);
+                auto& table = this->get_table<O>();
+                if(table.rowid_member) {
+                    o.*table.rowid_member = sqlite3_last_insert_rowid(sqlite3_db_handle(statement.stmt));
+                }
+            }
+
+            template<class It, class Projection = polyfill::identity>
+            void replace_range(It from, It to, Projection project = {}) {
+                using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+                this->assert_mapped_type<O>();
+                if(from == to) {
+                    return;
+                }
+
+                this->execute_range_in_chunks(
+                    std::move(from),
+                    std::move(to),
+                    this->get_table<O>().non_generated_columns_count(),
+                    [&project](It first, It last) {
+                        return sqlite_orm::replace_range(std::move(first), std::move(last), project);
+                    });
+            }
+
+            template<class O, class It, class Projection = polyfill::identity>
+            void replace_range(It from, It to, Projection project = {}) {
+                this->assert_mapped_type<O>();
+                if(from == to) {
+                    return;
+                }
+
+                this->execute_range_in_chunks(
+                    std::move(from),
+                    std::move(to),
+                    this->get_table<O>().non_generated_columns_count(),
+                    [&project](It first, It last) {
+                        return sqlite_orm::replace_range<O>(std::move(first), std::move(last), project);
+                    });
+            }
+
+            /**
+             *  Stages the objects of `range` in a TEMP table created from the mapping of T, runs `f(temp_table)`
+             *  with it and drops it, e.g. to join a large set of client side values in one statement:
+             *  `storage.with_temp_table<WantedId>(ids, [&](const temp_table&) { return storage.select(&User::name,
+             *  inner_join<WantedId>(on(c(&WantedId::id) == &User::id))); })`.
+             *  The temporary table is named like the table of T, so statements of `f` which refer to T use it even
+             *  if T is also mapped to a table in the main database; the table of T doesn't have to exist.
+             *  The objects are replaced in chunks like by `replace_range()`. Statements of `f` on the calling
+             *  thread run on the connection of the table, TEMP tables being private to their connection. The
+             *  table is kept in memory by `temp_store` = MEMORY, unless the connection has other temporary
+             *  objects, and it can't have foreign keys since they can't refer to tables of another schema.
+             *  @return the value returned by `f`.
+             */
+            template<class T, class R, class F>
+            decltype(auto) with_temp_table(const R& range, F&& f) {
+                this->assert_mapped_type<T>();
+                auto& table = this->get_table<T>();
+                internal::temp_table_guard guard{this->get_connection(), table.name};
+                auto tempTable = table;
+                tempTable.schema_name = "temp";
+                perform_void_exec(guard.get(), this->create_table_sql(table.name, tempTable));
+                this->forget_cached_rows<T>();
+                const sqlite_orm::temp_table info{table.name,
+                                                  size_t(std::distance(std::begin(range), std::end(range)))};
+                if(info.rows_count) {
+                    this->replace_range<T>(std::begin(range), std::end(range));
+                }
+                struct forgetter {
+                    self& storage;
+
+                    ~forgetter() {
+                        this->storage.template forget_cached_rows<T>();
+                    }
+                } forget{*this};
+                return f(info);
+            }
+
+#if SQLITE_VERSION_NUMBER >= 3024000
+            /**
+             *  Inserts the objects of the range [from, to) with all their columns and resolves conflicts with
+             *  `upsert`, e.g. `on_conflict(&User::id).do_update(set(c(&User::name) = excluded(&User::name)))`.
+             *  The range is inserted in chunks like `insert_range`, in one transaction if there is more than one.
+             */
+            template<class It, class U, class Projection = polyfill::identity>
+            void upsert_range(It from, It to, U upsert, Projection project = {}) {
+                using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+                this->upsert_range<O>(std::move(from), std::move(to), std::move(upsert), std::move(project));
+            }
+
+            template<class O, class It, class U, class Projection = polyfill::identity>
+            void upsert_range(It from, It to, U upsert, Projection project = {}) {
+                this->assert_mapped_type<O>();
+                if(from == to) {
+                    return;
+                }
+                size_t upsertVariablesCount = 0;
+                iterate_ast(upsert, [&upsertVariablesCount](auto& node) {
+                    if(is_bindable_v<std::decay_t<decltype(node)>>) {
+                        ++upsertVariablesCount;
+                    }
+                });
+                this->execute_range_in_chunks(
+                    std::move(from),
+                    std::move(to),
+                    this->get_table<O>().non_generated_columns_count(),
+                    [&project, &upsert](It first, It last) {
+                        return sqlite_orm::upsert_range<O>(std::move(first), std::move(last), upsert, project);
+                    },
+                    upsertVariablesCount);
+            }
+#endif
+
+            template<class O, class... Cols>
+            int insert(const O& o, columns_t<Cols...> cols) {
+                static_assert(cols.count > 0, "Use insert or replace with 1 argument instead");
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::insert(std::ref(o), std::move(cols)));
+                return int(this->execute(statement));
+            }
+
+            /**
+             *  Same as `insert(const O&, columns_t<Cols...>)` but also sets the rowid member of `o` if its table has
+             *  one, see `with_rowid_member()`.
+             */
+            template<class O, class... Cols>
+            int insert(O& o, columns_t<Cols...> cols) {
+                static_assert(cols.count > 0, "Use insert or replace with 1 argument instead");
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::insert(std::cref(o), std::move(cols)));
+                const int64 rowid = this->execute(statement);
+                auto& table = this->get_table<O>();
+                if(table.rowid_member) {
+                    o.*table.rowid_member = rowid;
+                }
+                return int(rowid);
+            }
+
+            /**
+             *  Insert routine. Inserts object with all non primary key fields in passed object. Id of passed
+             *  object doesn't matter.
+             *  @return id of just created object.
+             */
+            template<class O>
+            int insert(const O& o) {
+                this->assert_mapped_type<O>();
+                this->assert_insertable_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::insert(std::ref(o)));
+                return int(this->execute(statement));
+            }
+
+            /**
+             *  Same as `insert(const O&)` but also sets the rowid member of `o` if its table has one, see
+             *  `with_rowid_member()`.
+             */
+            template<class O>
+            int insert(O& o) {
+                this->assert_mapped_type<O>();
+                this->assert_insertable_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::insert(std::cref(o)));
+                const int64 rowid = this->execute(statement);
+                auto& table = this->get_table<O>();
+                if(table.rowid_member) {
+                    o.*table.rowid_member = rowid;
+                }
+                return int(rowid);
+            }
+
+            /**
+             *  Raw insert routine. Use this if `insert` with object does not fit you. This insert is designed to be able
+             *  to call any type of `INSERT` query with no limitations.
              *  @example
              *  ```sql
              *  INSERT INTO users (id, name) VALUES(5, 'Little Mix')
@@ -700,141 +3168,927 @@ namespace sqlite_orm {
              *  ```c++
              *  storage.insert(into<Singer>(), columns(&Singer::name), values(std::make_tuple("Sofia Reyes"), std::make_tuple("Kungs")));
              *  ```
-             *  One can use `default_values` to add `DEFAULT VALUES` modifier:
-             *  ```sql
-             *  INSERT INTO users DEFAULT VALUES
+             *  One can use `default_values` to add `DEFAULT VALUES` modifier:
+             *  ```sql
+             *  INSERT INTO users DEFAULT VALUES
+             *  ```
+             *  will be
+             *  ```c++
+             *  storage.insert(into<Singer>(), default_values());
+             *  ```
+             *  Also one can use `INSERT OR ABORT`/`INSERT OR FAIL`/`INSERT OR IGNORE`/`INSERT OR REPLACE`/`INSERT ROLLBACK`:
+             *  ```c++
+             *  storage.insert(or_ignore(), into<Singer>(), columns(&Singer::name), values(std::make_tuple("Sofia Reyes"), std::make_tuple("Kungs")));
+             *  storage.insert(or_rollback(), into<Singer>(), default_values());
+             *  storage.insert(or_abort(), into<User>, columns(&User::id, &User::name), values(std::make_tuple(5, "Little Mix")));
+             *  ```
+             */
+            template<class... Args>
+            void insert(Args... args) {
+                auto statement = this->prepare_cached(sqlite_orm::insert(std::forward<Args>(args)...));
+                this->execute(statement);
+            }
+
+            /**
+             *  Raw replace statement creation routine. Use this if `replace` with object does not fit you. This replace is designed to be able
+             *  to call any type of `REPLACE` query with no limitations. Actually this is the same query as raw insert except `OR...` option existance.
+             *  @example
+             *  ```sql
+             *  REPLACE INTO users (id, name) VALUES(5, 'Little Mix')
+             *  ```
+             *  will be
+             *  ```c++
+             *  storage.prepare(replace(into<User>, columns(&User::id, &User::name), values(std::make_tuple(5, "Little Mix"))));
+             *  ```
+             *  One more example:
+             *  ```sql
+             *  REPLACE INTO singers (name) VALUES ('Sofia Reyes')('Kungs')
+             *  ```
+             *  will be
+             *  ```c++
+             *  storage.prepare(replace(into<Singer>(), columns(&Singer::name), values(std::make_tuple("Sofia Reyes"), std::make_tuple("Kungs"))));
+             *  ```
+             *  One can use `default_values` to add `DEFAULT VALUES` modifier:
+             *  ```sql
+             *  REPLACE INTO users DEFAULT VALUES
+             *  ```
+             *  will be
+             *  ```c++
+             *  storage.prepare(replace(into<Singer>(), default_values()));
+             *  ```
+             */
+            template<class... Args>
+            void replace(Args... args) {
+                auto statement = this->prepare_cached(sqlite_orm::replace(std::forward<Args>(args)...));
+                this->execute(statement);
+            }
+
+            template<class It, class Projection = polyfill::identity>
+            void insert_range(It from, It to, Projection project = {}) {
+                using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+                this->assert_mapped_type<O>();
+                this->assert_insertable_type<O>();
+                if(from == to) {
+                    return;
+                }
+                this->execute_range_in_chunks(std::move(from),
+                                              std::move(to),
+                                              this->insertable_columns_count<O>(),
+                                              [&project](It first, It last) {
+                                                  return sqlite_orm::insert_range(std::move(first),
+                                                                                  std::move(last),
+                                                                                  project);
+                                              });
+            }
+
+            template<class O, class It, class Projection = polyfill::identity>
+            void insert_range(It from, It to, Projection project = {}) {
+                this->assert_mapped_type<O>();
+                this->assert_insertable_type<O>();
+                if(from == to) {
+                    return;
+                }
+                this->execute_range_in_chunks(std::move(from),
+                                              std::move(to),
+                                              this->insertable_columns_count<O>(),
+                                              [&project](It first, It last) {
+                                                  return sqlite_orm::insert_range<O>(std::move(first),
+                                                                                     std::move(last),
+                                                                                     project);
+                                              });
+            }
+
+            /**
+             *  Inserts the range [from, to) in chunks like `insert_range()` with a conflict resolution, e.g.
+             *  `or_ignore()` which skips the objects whose primary key or unique columns are taken inside SQLite
+             *  instead of failing the chunk, so ingesting duplicates throws no exceptions.
+             *  @return number of rows inserted, the sum of `changes()` of the chunks.
+             *  @example auto inserted = storage.insert_range(events.begin(), events.end(), or_ignore());
+             */
+            template<class It, class Projection = polyfill::identity>
+            int insert_range(It from, It to, insert_constraint constraint, Projection project = {}) {
+                using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+                return this->insert_range<O>(std::move(from), std::move(to), constraint, std::move(project));
+            }
+
+            template<class O, class It, class Projection = polyfill::identity>
+            int insert_range(It from, It to, insert_constraint constraint, Projection project = {}) {
+                this->assert_mapped_type<O>();
+                this->assert_insertable_type<O>();
+                if(from == to) {
+                    return 0;
+                }
+                int inserted = 0;
+                this->for_each_range_chunk(
+                    std::move(from),
+                    std::move(to),
+                    this->insertable_columns_count<O>(),
+                    [&project, constraint](It first, It last) {
+                        return sqlite_orm::insert_range<O>(std::move(first), std::move(last), constraint, project);
+                    },
+                    [this, &inserted](auto& statement) {
+                        this->execute(statement);
+                        inserted += sqlite3_changes(sqlite3_db_handle(statement.stmt));
+                    },
+                    0);
+                return inserted;
+            }
+
+            /**
+             *  Writes many objects of one mapped type faster than `replace_range()`: non-unique indexes are built
+             *  once at the end, foreign keys aren't enforced, rows are written in primary key order and in large
+             *  transactions with the bulk load profile, see `bulk_load_options`. The indexes are created again
+             *  even if the load fails.
+             *  Example: storage.bulk_load(events.begin(), events.end());
+             */
+            template<class It, class Projection = polyfill::identity>
+            void bulk_load(It from, It to, const bulk_load_options& options = {}, Projection project = {}) {
+                using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
+                this->assert_mapped_type<O>();
+                this->assert_insertable_type<O>();
+                std::vector<std::reference_wrapper<const O>> rows;
+                for(; from != to; ++from) {
+                    rows.push_back(std::cref(polyfill::invoke(project, *from)));
+                }
+                if(rows.empty()) {
+                    return;
+                }
+                if(options.sort_by_primary_key && !options.assign_primary_keys) {
+                    auto& table = this->get_table<O>();
+                    std::stable_sort(rows.begin(), rows.end(), [&table](const O& lhs, const O& rhs) {
+                        int order = 0;
+                        table.for_each_primary_key_column([&lhs, &rhs, &order](auto& memberPointer) {
+                            if(order == 0) {
+                                const auto& left = polyfill::invoke(memberPointer, lhs);
+                                const auto& right = polyfill::invoke(memberPointer, rhs);
+                                order = left < right ? -1 : (right < left ? 1 : 0);
+                            }
+                        });
+                        return order < 0;
+                    });
+                }
+
+                //  the connection stays with this thread until the end, so do the pragmas
+                auto con = this->get_connection();
+                sqlite3* db = con.get();
+                const bool ownTransactions = !this->in_transaction();
+                std::vector<std::string> deferredIndexes;
+                if(options.defer_indexes) {
+                    deferredIndexes = this->drop_deferrable_indexes<O>(db);
+                }
+                bool foreignKeysOff = false;
+                if(options.disable_foreign_keys && ownTransactions) {
+                    perform_exec(db, "PRAGMA foreign_keys", extract_single_value<bool>, &foreignKeysOff);
+                }
+                if(foreignKeysOff) {
+                    perform_void_exec(db, "PRAGMA foreign_keys = OFF");
+                }
+                performance_profile former;
+                if(options.bulk_load_profile && ownTransactions) {
+                    former = this->apply_bulk_load_profile();
+                }
+                auto restore = [this, db, &deferredIndexes, foreignKeysOff, &options, ownTransactions, &former] {
+                    for(auto& sql: deferredIndexes) {
+                        perform_void_exec(db, sql);
+                    }
+                    if(foreignKeysOff) {
+                        perform_void_exec(db, "PRAGMA foreign_keys = ON");
+                    }
+                    if(options.bulk_load_profile && ownTransactions) {
+                        this->apply_performance_profile(former);
+                    }
+                };
+
+                try {
+                    auto write = [this, &options](auto first, auto last) {
+                        auto get = [](const std::reference_wrapper<const O>& row) -> const O& {
+                            return row.get();
+                        };
+                        if(options.assign_primary_keys) {
+                            this->insert_range(first, last, get);
+                        } else {
+                            this->replace_range(first, last, get);
+                        }
+                    };
+                    const size_t batchSize = ownTransactions && options.rows_per_transaction
+                                                 ? options.rows_per_transaction
+                                                 : rows.size();
+                    for(size_t begin = 0; begin < rows.size(); begin += batchSize) {
+                        const size_t end = std::min(rows.size(), begin + batchSize);
+                        auto guard = this->transaction_guard();
+                        write(rows.begin() + begin, rows.begin() + end);
+                        guard.commit();
+                    }
+                } catch(...) {
+                    restore();
+                    throw;
+                }
+                restore();
+            }
+
+            /**
+             *  `get_all` run on a background thread of the storage (see `async()`).
+             */
+            template<class O, class R = std::vector<O>, class... Args>
+            std::future<R> async_get_all(Args... args) {
+                return this->async([this, args...] {
+                    return this->template get_all<O, R>(args...);
+                });
+            }
+
+            /**
+             *  Executes a prepared statement on a background thread of the storage (see `async()`).
+             *  The statement must stay alive until the returned future is ready.
+             */
+            template<class T>
+            auto async_execute(const prepared_statement_t<T>& statement) {
+                return this->async([this, &statement] {
+                    return this->execute(statement);
+                });
+            }
+
+            /**
+             *  Creates a group commit service that collects writes submitted from many threads
+             *  and commits up to `maxBatch` of them in one transaction:
+             *  ```
+             *  auto batcher = storage.make_write_batcher(100, std::chrono::milliseconds{5});
+             *  std::future<int> id = batcher->insert(User{0, "Alice"});
              *  ```
-             *  will be
-             *  ```c++
-             *  storage.insert(into<Singer>(), default_values());
+             *  See `write_batcher` for details. The storage must outlive the batcher.
+             */
+            std::unique_ptr<write_batcher<self>>
+            make_write_batcher(size_t maxBatch = 64,
+                               std::chrono::milliseconds maxDelay = std::chrono::milliseconds{5}) {
+                return std::make_unique<write_batcher<self>>(*this, maxBatch, maxDelay);
+            }
+
+            /**
+             *  Creates a write-behind buffer which collapses repeated `update()` calls of objects of type O
+             *  and writes the latest state per primary key in batches:
              *  ```
-             *  Also one can use `INSERT OR ABORT`/`INSERT OR FAIL`/`INSERT OR IGNORE`/`INSERT OR REPLACE`/`INSERT ROLLBACK`:
-             *  ```c++
-             *  storage.insert(or_ignore(), into<Singer>(), columns(&Singer::name), values(std::make_tuple("Sofia Reyes"), std::make_tuple("Kungs")));
-             *  storage.insert(or_rollback(), into<Singer>(), default_values());
-             *  storage.insert(or_abort(), into<User>, columns(&User::id, &User::name), values(std::make_tuple(5, "Little Mix")));
+             *  auto sessions = storage.make_write_behind<Session>(write_behind_options{std::chrono::seconds{1}});
+             *  sessions->update(Session{id, lastSeen});
              *  ```
+             *  See `write_behind` for details. The storage must outlive the buffer.
              */
-            template<class... Args>
-            void insert(Args... args) {
-                auto statement = this->prepare(sqlite_orm::insert(std::forward<Args>(args)...));
-                this->execute(statement);
+            template<class O>
+            std::unique_ptr<write_behind<self, O>> make_write_behind(write_behind_options options = {}) {
+                this->assert_mapped_type<O>();
+                return std::make_unique<write_behind<self, O>>(
+                    *this,
+                    [this](const O& object) {
+                        return this->object_cache_key_of(object);
+                    },
+                    options);
+            }
+
+            /**
+             *  Key-value store over the table of `kv_entry<K, V, Tag>`, see `make_kv_table()` and `kv_store`.
+             *  The storage must outlive the store.
+             */
+            template<class K, class V, class Tag = void>
+            kv_store<self, K, V, Tag> make_kv_store() {
+                this->assert_mapped_type<kv_entry<K, V, Tag>>();
+                return {*this};
+            }
+
+            /**
+             *  Job queue over the table of `queued_job<P, Tag>`, see `make_job_queue_table()` and `job_queue`.
+             *  A job claimed `maxAttempts` times without being acknowledged fails. The storage must outlive
+             *  the queue.
+             */
+            template<class P, class Tag = void>
+            job_queue<self, P, Tag> make_job_queue(int maxAttempts = 5) {
+                this->assert_mapped_type<queued_job<P, Tag>>();
+                return {*this, maxAttempts};
+            }
+
+            /**
+             *  Counters over the table of `counter_shard<Tag>`, see `make_counter_shards_table()` and
+             *  `counter_table`. The storage must outlive the counters.
+             */
+            template<class Tag = void>
+            counter_table<self, Tag> make_counter_table(counter_options options = {}) {
+                this->assert_mapped_type<counter_shard<Tag>>();
+                return {*this, options};
+            }
+
+            /**
+             * Change table name inside storage's schema info. This function does not
+             * affect database. The schema is shared with forks, so it is renamed in them too.
+             */
+            template<class O>
+            void rename_table(std::string name) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                table.name = move(name);
+            }
+
+            using storage_base::rename_table;
+
+            /**
+             * Get table's name stored in storage's schema info. This function does not call
+             * any SQLite queries
+             */
+            template<class O>
+            const std::string& tablename() const {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                return table.name;
+            }
+
+            template<class F, class O>
+            [[deprecated("Use the more accurately named function `find_column_name()`")]] const std::string*
+            column_name(F O::*memberPointer) const {
+                return internal::find_column_name(this->db_objects, memberPointer);
+            }
+
+            template<class F, class O>
+            const std::string* find_column_name(F O::*memberPointer) const {
+                return internal::find_column_name(this->db_objects, memberPointer);
+            }
+
+          protected:
+            template<class S>
+            auto execute_select(const prepared_statement_t<S>& statement, std::false_type) {
+                return this->execute(statement);
+            }
+
+            template<class T, class... Args, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> execute_select(const prepared_statement_t<select_t<T, Args...>>& statement, std::true_type) {
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(!this->queryResults.enabled()) {
+                    return this->execute(statement);
+                }
+                this->check_data_version();
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                bind_changed_parameters(statement, statement.expression);
+                //  the same SQL may be extracted differently
+                std::string key = typeid(R).name();
+                key += '\n';
+                if(char* expandedSql = sqlite3_expanded_sql(stmt)) {
+                    key += expandedSql;
+                    sqlite3_free(expandedSql);
+                } else {
+                    return this->execute(statement);
+                }
+                if(auto found = this->queryResults.find(key)) {
+                    return *std::static_pointer_cast<const std::vector<R>>(std::move(found));
+                }
+                auto tableNames = this->query_tables(statement.expression);
+                //  the update hook isn't invoked for WITHOUT ROWID tables, results read from them couldn't be dropped
+                if(this->any_without_rowid(tableNames)) {
+                    return this->execute(statement);
+                }
+                auto dependencies = this->queryResults.snapshot(tableNames);
+                auto res = this->execute(statement);
+                std::chrono::milliseconds ttl{0};
+                iterate_tuple(statement.expression.conditions, [&ttl](auto& condition) {
+                    call_if_constexpr<is_cached<std::decay_t<decltype(condition)>>::value>(
+                        [&ttl](auto& hint) {
+                            ttl = hint.ttl;
+                        },
+                        condition);
+                });
+                this->queryResults.insert(std::move(key),
+                                          std::make_shared<const std::vector<R>>(res),
+                                          std::move(dependencies),
+                                          ttl);
+                return res;
+#else
+                return this->execute(statement);
+#endif
+            }
+
+            /**
+             *  Names of the tables a select reads from.
+             */
+            template<class T, class... Args>
+            std::set<std::string> query_tables(const select_t<T, Args...>& expression) {
+                table_name_collector collector([this](const std::type_index& ti) {
+                    return find_table_name(this->db_objects, ti);
+                });
+                iterate_ast(expression.col, collector);
+                iterate_ast(expression.conditions, collector);
+                std::set<std::string> res;
+                for(auto& tableName: collector.table_names) {
+                    res.insert(tableName.first);
+                }
+                join_iterator<Args...>()([this, &res](const auto& join) {
+                    using join_type = typename std::decay_t<decltype(join)>::join_type::type;
+                    res.insert(lookup_table_name<mapped_type_proxy_t<join_type>>(this->db_objects));
+                });
+                iterate_tuple(expression.conditions, [this, &res](auto& condition) {
+                    this->add_from_tables(res, condition);
+                });
+                res.erase(std::string{});
+                return res;
+            }
+
+            bool any_without_rowid(const std::set<std::string>& tableNames) const {
+                using tables_sequence = tables_index_sequence<db_objects_type>;
+                bool res = false;
+                iterate_tuple(this->db_objects, tables_sequence{}, [&tableNames, &res](auto& table) {
+                    if(std::decay_t<decltype(table)>::is_without_rowid_v && tableNames.count(table.name)) {
+                        res = true;
+                    }
+                });
+                return res;
+            }
+
+            template<class C>
+            void add_from_tables(std::set<std::string>&, const C&) {}
+
+            template<class... Ts>
+            void add_from_tables(std::set<std::string>& res, const from_t<Ts...>&) {
+                iterate_tuple<std::tuple<Ts...>>([this, &res](auto* item) {
+                    using from_type = std::remove_pointer_t<decltype(item)>;
+                    res.insert(lookup_table_name<mapped_type_proxy_t<from_type>>(this->db_objects));
+                });
+            }
+
+            template<class O>
+            object_cache* find_object_cache() {
+                return this->objectCaches.empty() ? nullptr : this->objectCaches.find(this->get_table<O>().name);
+            }
+
+            /**
+             *  Forgets the cached objects and query results of the table of O, for changes the hooks don't see.
+             */
+            template<class O>
+            void forget_cached_rows() {
+                if(auto cache = this->find_object_cache<O>()) {
+                    cache->clear();
+                }
+                if(this->queryResults.enabled()) {
+                    this->queryResults.table_changed(this->get_table<O>().name);
+                }
+            }
+
+            template<class O>
+            static O copy_cached_object(const O& object, std::true_type) {
+                return object;
+            }
+
+            /**
+             *  Is never called, objects that can't be copied can't be cached. Keeps `get` compiling for them.
+             */
+            template<class O>
+            static O copy_cached_object(const O&, std::false_type) {
+                throw std::system_error{orm_error_code::not_found};
+            }
+
+            template<class O, class... Ids>
+            std::shared_ptr<const O> get_cached(object_cache& cache, Ids... ids) {
+                this->check_data_version();
+                auto key = make_object_cache_key(ids...);
+                if(auto found = cache.find(key)) {
+                    return std::static_pointer_cast<const O>(std::move(found));
+                }
+                //  before the query so that a change made meanwhile keeps the object out of the cache
+                const auto generation = cache.generation();
+                auto statement = this->prepare_cached(sqlite_orm::get_pointer<O>(std::forward<Ids>(ids)...));
+                std::shared_ptr<const O> res = this->execute(statement);
+                if(res) {
+                    cache.insert(std::move(key), res, generation);
+                }
+                return res;
+            }
+
+            template<class O>
+            key_filter* find_key_filter() {
+                return this->keyFilters.empty() ? nullptr : this->keyFilters.find(this->get_table<O>().name);
+            }
+
+            /**
+             *  Key of the primary key `ids` of O in its key filter.
+             *  @return false if the types of `ids` don't match the primary key columns, the filter can't be
+             *  consulted then: the text of a key of another type may differ from the one stored.
+             */
+            template<class O, class... Ids>
+            bool make_key_filter_key(std::string& key, const std::tuple<Ids...>& ids) {
+                bool matches = true;
+                size_t index = 0;
+                this->get_table<O>().for_each_primary_key_column([&key, &ids, &matches, &index](auto& memberPointer) {
+                    using field_type = member_field_type_t<std::decay_t<decltype(memberPointer)>>;
+                    size_t idIndex = 0;
+                    iterate_tuple(ids, [&key, &matches, index, &idIndex](auto& id) {
+                        if(idIndex++ != index) {
+                            return;
+                        }
+                        if(!is_key_filter_key_v<field_type, std::decay_t<decltype(id)>>) {
+                            matches = false;
+                            return;
+                        }
+                        if(index > 0) {
+                            key += '\x1f';
+                        }
+                        append_key_filter_key(key, id);
+                    });
+                    ++index;
+                });
+                return matches && index == sizeof...(Ids);
+            }
+
+            template<class O>
+            std::string object_key_filter_key(const O& object) {
+                std::string key;
+                bool first = true;
+                this->get_table<O>().for_each_primary_key_column([&key, &first, &object](auto& memberPointer) {
+                    if(!std::exchange(first, false)) {
+                        key += '\x1f';
+                    }
+                    append_key_filter_key(key, polyfill::invoke(memberPointer, object));
+                });
+                return key;
+            }
+
+            /**
+             *  @return true if the key filter of O tells that there is no row with primary key `ids`.
+             */
+            template<class O, class... Ids>
+            bool excluded_by_key_filter(const std::tuple<Ids...>& ids) {
+                auto filter = this->find_key_filter<O>();
+                if(!filter) {
+                    return false;
+                }
+                std::string key;
+                if(!this->make_key_filter_key<O>(key, ids)) {
+                    return false;
+                }
+                this->check_data_version();
+                if(filter->is_stale()) {
+                    this->rebuild_key_filter<O>(*filter);
+                }
+                return !filter->may_contain(key);
+            }
+
+            /**
+             *  A lookup by primary key found no row.
+             */
+            template<class O>
+            void key_filter_missed() {
+                if(auto filter = this->find_key_filter<O>()) {
+                    filter->false_positive();
+                }
+            }
+
+            /**
+             *  Reads the primary keys of O into its key filter.
+             */
+            template<class O>
+            void rebuild_key_filter(key_filter& filter) {
+                auto& table = this->get_table<O>();
+                auto con = this->get_connection();
+                sqlite3* db = con.get();
+                const auto count = this->select_scalar<int64>(sqlite_orm::count<O>());
+                std::stringstream ss;
+                ss << "SELECT " << streaming_identifiers(table.primary_key_column_names()) << " FROM "
+                   << streaming_table_identifier(table) << std::flush;
+                statement_finalizer stmt{prepare_stmt(db, ss.str())};
+                const int columnsCount = sqlite3_column_count(stmt.get());
+                if(!filter.begin_rebuild(size_t(count))) {
+                    return;
+                }
+                try {
+                    std::string key;
+                    perform_steps(stmt.get(), [&filter, &key, columnsCount](sqlite3_stmt* stmt) {
+                        key.clear();
+                        for(int i = 0; i < columnsCount; ++i) {
+                            if(i > 0) {
+                                key += '\x1f';
+                            }
+                            if(auto text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i))) {
+                                key.append(text, size_t(sqlite3_column_bytes(stmt, i)));
+                            }
+                        }
+                        filter.add(key);
+                    });
+                } catch(...) {
+                    filter.end_rebuild(false);
+                    throw;
+                }
+                filter.end_rebuild(true);
+            }
+
+            /**
+             *  Adds the primary keys of the objects `expression` writes to the key filter of their table, unless
+             *  the update hook adds them itself.
+             *  @return the filter, to be announced by a `key_filter_write_scope` while the statement steps.
+             */
+            template<class E>
+            key_filter* add_key_filter_keys(const E& expression) {
+                using object_type = typename expression_object_type<E>::type;
+                auto filter = this->find_key_filter<object_type>();
+                if(!filter || filter->keyedByRowid) {
+                    return nullptr;
+                }
+                auto addKey = [this, filter](const object_type& object) {
+                    filter->add(this->object_key_filter_key(object));
+                };
+                static_if<polyfill::disjunction_v<is_insert_range<E>, is_replace_range<E>>>(
+                    [&addKey](auto& expression) {
+                        for_each_range_object(expression, addKey);
+                    },
+                    [&addKey](auto& expression) {
+                        addKey(get_object(expression));
+                    })(expression);
+                return filter;
+            }
+
+            /**
+             *  Binds the objects of an insert statement, without the primary key columns SQLite assigns.
+             */
+            template<class E, std::enable_if_t<polyfill::disjunction_v<is_insert<E>, is_insert_range<E>>, bool> = true>
+            void bind_statement_values(field_value_binder& bind_value, const E& expression) {
+                using object_type = typename expression_object_type<E>::type;
+                auto processObject = [&table = this->get_table<object_type>(), &bind_value](const auto& object) {
+                    using is_without_rowid = typename std::decay_t<decltype(table)>::is_without_rowid;
+                    table.template for_each_column_excluding<
+                        mpl::conjunction<mpl::not_<mpl::always<is_without_rowid>>,
+                                         mpl::disjunction_fn<is_primary_key, is_generated_always>>>(
+                        call_as_template_base<column_field>([&table, &bind_value, &object](auto& column) {
+                            if(!table.exists_in_composite_primary_key(column)) {
+                                bind_value(polyfill::invoke(column.member_pointer, object));
+                            }
+                        }));
+                };
+                static_if<is_insert_range_v<E>>(
+                    [&processObject](auto& expression) {
+                        for_each_range_object(expression, processObject);
+                    },
+                    [&processObject](auto& expression) {
+                        const object_type& o = get_object(expression);
+                        processObject(o);
+                    })(expression);
+            }
+
+            /**
+             *  Binds all the stored columns of the objects of a replace statement.
+             */
+            template<class E, std::enable_if_t<polyfill::disjunction_v<is_replace<E>, is_replace_range<E>>, bool> = true>
+            void bind_statement_values(field_value_binder& bind_value, const E& expression) {
+                using object_type = typename expression_object_type<E>::type;
+                auto processObject = [&table = this->get_table<object_type>(), &bind_value](const auto& object) {
+                    table.template for_each_column_excluding<is_generated_always>(
+                        call_as_template_base<column_field>([&bind_value, &object](auto& column) {
+                            bind_value(polyfill::invoke(column.member_pointer, object));
+                        }));
+                };
+                static_if<is_replace_range_v<E>>(
+                    [&processObject](auto& expression) {
+                        for_each_range_object(expression, processObject);
+                    },
+                    [&processObject](auto& expression) {
+                        const object_type& o = get_object(expression);
+                        processObject(o);
+                    })(expression);
+            }
+
+            /**
+             *  Binds the values of statements which hold them in their AST, such as `update_all_t`.
+             */
+            template<class E,
+                     std::enable_if_t<!polyfill::disjunction_v<is_insert<E>,
+                                                               is_insert_range<E>,
+                                                               is_replace<E>,
+                                                               is_replace_range<E>>,
+                                      bool> = true>
+            void bind_statement_values(field_value_binder& bind_value, const E& expression) {
+                conditional_binder binder{bind_value.stmt};
+                binder.index = bind_value.index;
+                iterate_ast(expression, binder);
+                bind_value.index = binder.index;
+            }
+
+            /**
+             *  Executes a prepared `update(o)`.
+             *  @return false if the table has a version column and the row of `o` doesn't have its version.
+             */
+            template<class T>
+            bool execute_update(const prepared_statement_t<update_t<T>>& statement) {
+                using statement_type = std::decay_t<decltype(statement)>;
+                using expression_type = typename statement_type::expression_type;
+                using object_type = typename expression_object_type<expression_type>::type;
+
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+                auto& table = this->get_table<object_type>();
+
+                field_value_binder bind_value{stmt, true};
+                auto& object = get_object(statement.expression);
+                table.template for_each_column_excluding<mpl::disjunction_fn<is_primary_key, is_generated_always>>(
+                    call_as_template_base<column_field>([&table, &bind_value, &object](auto& column) {
+                        if(!table.exists_in_composite_primary_key(column) && !table.is_version_column(column)) {
+                            bind_value(polyfill::invoke(column.member_pointer, object));
+                        }
+                    }));
+                this->bind_row_key(bind_value, table, object);
+                if(table.version_member) {
+                    bind_value(object.*table.version_member);
+                }
+                key_filter_write_scope keyScope{this->add_key_filter_keys(statement.expression)};
+                tracer.phase(execute_phase::step);
+                perform_step(stmt);
+                return !table.version_member || sqlite3_changes(sqlite3_db_handle(stmt)) > 0;
             }
 
             /**
-             *  Raw replace statement creation routine. Use this if `replace` with object does not fit you. This replace is designed to be able
-             *  to call any type of `REPLACE` query with no limitations. Actually this is the same query as raw insert except `OR...` option existance.
-             *  @example
-             *  ```sql
-             *  REPLACE INTO users (id, name) VALUES(5, 'Little Mix')
-             *  ```
-             *  will be
-             *  ```c++
-             *  storage.prepare(replace(into<User>, columns(&User::id, &User::name), values(std::make_tuple(5, "Little Mix"))));
-             *  ```
-             *  One more example:
-             *  ```sql
-             *  REPLACE INTO singers (name) VALUES ('Sofia Reyes')('Kungs')
-             *  ```
-             *  will be
-             *  ```c++
-             *  storage.prepare(replace(into<Singer>(), columns(&Singer::name), values(std::make_tuple("Sofia Reyes"), std::make_tuple("Kungs"))));
-             *  ```
-             *  One can use `default_values` to add `DEFAULT VALUES` modifier:
-             *  ```sql
-             *  REPLACE INTO users DEFAULT VALUES
-             *  ```
-             *  will be
-             *  ```c++
-             *  storage.prepare(replace(into<Singer>(), default_values()));
-             *  ```
+             *  Binds what `stream_row_key()` compares: the rowid member of `o` or its primary key columns.
              */
-            template<class... Args>
-            void replace(Args... args) {
-                auto statement = this->prepare(sqlite_orm::replace(std::forward<Args>(args)...));
-                this->execute(statement);
-            }
-
-            template<class It, class Projection = polyfill::identity>
-            void insert_range(It from, It to, Projection project = {}) {
-                using O = std::decay_t<decltype(polyfill::invoke(std::declval<Projection>(), *std::declval<It>()))>;
-                this->assert_mapped_type<O>();
-                this->assert_insertable_type<O>();
-                if(from == to) {
+            template<class Table, class O>
+            static void bind_row_key(field_value_binder& bind_value, const Table& table, const O& o) {
+                if(table.rowid_member) {
+                    bind_value(o.*table.rowid_member);
                     return;
                 }
-                auto statement =
-                    this->prepare(sqlite_orm::insert_range(std::move(from), std::move(to), std::move(project)));
-                this->execute(statement);
+                table.for_each_column([&table, &bind_value, &o](auto& column) {
+                    if(column.template is<is_primary_key>() || table.exists_in_composite_primary_key(column)) {
+                        bind_value(polyfill::invoke(column.member_pointer, o));
+                    }
+                });
             }
 
-            template<class O, class It, class Projection = polyfill::identity>
-            void insert_range(It from, It to, Projection project = {}) {
-                this->assert_mapped_type<O>();
-                this->assert_insertable_type<O>();
-                if(from == to) {
+            template<class O>
+            void invalidate_cached_object(const O& o) {
+                auto cache = this->find_object_cache<O>();
+                if(!cache) {
                     return;
                 }
-                auto statement =
-                    this->prepare(sqlite_orm::insert_range<O>(std::move(from), std::move(to), std::move(project)));
-                this->execute(statement);
+                cache->invalidate(this->object_cache_key_of(o));
             }
 
             /**
-             * Change table name inside storage's schema info. This function does not
-             * affect database
+             *  Key of `o` in an object cache, the same as `make_object_cache_key()` of its primary key.
              */
             template<class O>
-            void rename_table(std::string name) {
-                this->assert_mapped_type<O>();
-                auto& table = this->get_table<O>();
-                table.name = move(name);
+            std::string object_cache_key_of(const O& o) {
+                std::string key;
+                bool first = true;
+                this->get_table<O>().for_each_primary_key_column([&key, &first, &o](auto& memberPointer) {
+                    if(!std::exchange(first, false)) {
+                        key += '\x1f';
+                    }
+                    append_object_cache_key(key, polyfill::invoke(memberPointer, o));
+                });
+                return key;
             }
 
-            using storage_base::rename_table;
-
             /**
-             * Get table's name stored in storage's schema info. This function does not call
-             * any SQLite queries
+             *  Drops the non-unique indexes of the table of `O` that exist in the database.
+             *  @return CREATE INDEX statements of the dropped indexes.
              */
             template<class O>
-            const std::string& tablename() const {
-                this->assert_mapped_type<O>();
-                auto& table = this->get_table<O>();
-                return table.name;
+            std::vector<std::string> drop_deferrable_indexes(sqlite3* db) {
+                std::vector<std::string> dropped;
+                const auto& tableName = this->get_table<O>().name;
+                iterate_tuple<true>(this->db_objects, [this, db, &tableName, &dropped](auto& schemaObject) {
+                    this->drop_deferrable_index(schemaObject, tableName, db, dropped);
+                });
+                return dropped;
             }
 
-            template<class F, class O>
-            [[deprecated("Use the more accurately named function `find_column_name()`")]] const std::string*
-            column_name(F O::*memberPointer) const {
-                return internal::find_column_name(this->db_objects, memberPointer);
+            template<class T>
+            void drop_deferrable_index(const T&, const std::string&, sqlite3*, std::vector<std::string>&) {}
+
+            template<class... Cols>
+            void drop_deferrable_index(const index_t<Cols...>& index,
+                                       const std::string& tableName,
+                                       sqlite3* db,
+                                       std::vector<std::string>& dropped) {
+                if(index.unique) {
+                    return;
+                }
+                table_name_collector collector([this](const std::type_index& ti) {
+                    return find_table_name(this->db_objects, ti);
+                });
+                iterate_ast(index.elements, collector);
+                if(collector.table_names.empty() || collector.table_names.begin()->first != tableName) {
+                    return;
+                }
+                auto schemaName = this->index_schema_name(index);
+                std::stringstream ss;
+                ss << "SELECT count(*) FROM " << quote_identifier(schemaName.empty() ? "main" : schemaName)
+                   << ".sqlite_master WHERE type = 'index' AND name = " << quote_string_literal(index.name)
+                   << std::flush;
+                int count = 0;
+                perform_exec(db, ss.str(), extract_single_value<int>, &count);
+                if(!count) {
+                    return;
+                }
+                ss.str({});
+                ss << "DROP INDEX " << streaming_identifier(schemaName, index.name, std::string{}) << std::flush;
+                perform_void_exec(db, ss.str());
+                using context_t = serializer_context<db_objects_type>;
+                context_t context{this->db_objects};
+                dropped.push_back(serialize(index, context));
             }
 
-            template<class F, class O>
-            const std::string* find_column_name(F O::*memberPointer) const {
-                return internal::find_column_name(this->db_objects, memberPointer);
+            /**
+             *  Schema of the table of `index`, empty for the main database.
+             */
+            template<class... Cols>
+            std::string index_schema_name(const index_t<Cols...>& index) const {
+                table_name_collector collector([this](const std::type_index& ti) {
+                    return find_table_name(this->db_objects, ti);
+                });
+                iterate_ast(index.elements, collector);
+                if(collector.table_names.empty()) {
+                    return {};
+                }
+                return find_table_schema_name(this->db_objects, collector.table_names.begin()->first);
+            }
+
+            /**
+             *  CREATE INDEX statement of `index` the way `sqlite_master` keeps it, i.e. without IF NOT EXISTS
+             *  and without the schema.
+             */
+            template<class... Cols>
+            std::string stored_index_sql(const index_t<Cols...>& index) const {
+                using context_t = serializer_context<db_objects_type>;
+                context_t context{this->db_objects};
+                auto query = serialize(index, context);
+                static const std::string ifNotExists = "IF NOT EXISTS ";
+                auto pos = query.find(ifNotExists);
+                if(pos != query.npos) {
+                    query.erase(pos, ifNotExists.size());
+                }
+                auto schemaName = this->index_schema_name(index);
+                if(!schemaName.empty()) {
+                    auto qualifier = quote_identifier(schemaName) + ".";
+                    pos = query.find(qualifier);
+                    if(pos != query.npos) {
+                        query.erase(pos, qualifier.size());
+                    }
+                }
+                return query;
             }
 
-          protected:
             template<class... Cols>
-            sync_schema_result schema_status(const index_t<Cols...>&, sqlite3*, bool, bool*) {
+            sync_schema_result
+            schema_status(const index_t<Cols...>& index, sqlite3* db, bool, bool*, const schema_snapshot& snapshot) {
+                auto dbIndexSql = this->schema_sql(db, "index", index.name, this->index_schema_name(index), snapshot);
+                if(!dbIndexSql.empty() && dbIndexSql != this->stored_index_sql(index)) {
+                    return sync_schema_result::dropped_and_recreated;
+                }
                 return sync_schema_result::already_in_sync;
             }
 
+            template<class O, class S>
+            sync_schema_result schema_status(const materialized_view_t<O, S>& view,
+                                             sqlite3* db,
+                                             bool,
+                                             bool*,
+                                             const schema_snapshot&) {
+                return this->materialized_view_status(view, make_materialized_view_sql(view, this->db_objects), db);
+            }
+
+            /**
+             *  `new_table_created` if no trigger of `view` exists, `already_in_sync` if all of them are the ones
+             *  of `sql` and `dropped_and_recreated` otherwise.
+             */
+            template<class O, class S>
+            sync_schema_result materialized_view_status(const materialized_view_t<O, S>& view,
+                                                        const materialized_view_sql& sql,
+                                                        sqlite3* db) const {
+                bool exists = false;
+                bool differs = false;
+                for(const char* suffix: {"_insert", "_update", "_delete"}) {
+                    auto name = view.name + suffix;
+                    auto dbSql = this->schema_sql(db, "trigger", name);
+                    auto it = std::find_if(sql.triggers.begin(), sql.triggers.end(), [&name](auto& trigger) {
+                        return trigger.first == name;
+                    });
+                    exists = exists || !dbSql.empty();
+                    differs = differs || dbSql != (it != sql.triggers.end() ? it->second : std::string{});
+                }
+                if(!exists) {
+                    return sync_schema_result::new_table_created;
+                }
+                return differs ? sync_schema_result::dropped_and_recreated : sync_schema_result::already_in_sync;
+            }
+
             template<class T, bool WithoutRowId, class... Cs>
             sync_schema_result schema_status(const table_t<T, WithoutRowId, Cs...>& table,
                                              sqlite3* db,
                                              bool preserve,
-                                             bool* attempt_to_preserve) {
+                                             bool* attempt_to_preserve,
+                                             const schema_snapshot& snapshot) {
                 if(attempt_to_preserve) {
                     *attempt_to_preserve = true;
                 }
+                if(table.virtual_module) {
+                    return sync_schema_result::already_in_sync;
+                }
+                if(table.fts5 || table.rtree) {
+                    return this->virtual_table_status(db, table, snapshot);
+                }
 
-                auto dbTableInfo = this->pragma.table_xinfo(table.name);
+                auto dbTableInfo = this->db_table_xinfo(table.name, table.schema_name, snapshot);
                 auto res = sync_schema_result::already_in_sync;
 
                 //  first let's see if table with such name exists..
-                auto gottaCreateTable = !this->table_exists(db, table.name);
+                auto gottaCreateTable = !this->table_exists(db, table.name, table.schema_name, snapshot);
                 if(!gottaCreateTable) {
 
                     //  get table info provided in `make_table` call..
@@ -847,6 +4101,10 @@ namespace sqlite_orm {
                         gottaCreateTable = true;
                     }
 
+                    if(this->table_options_differ(db, table, snapshot)) {
+                        gottaCreateTable = true;
+                    }
+
                     if(!gottaCreateTable) {  //  if all storage columns are equal to actual db columns but there are
                         //  excess columns at the db..
                         if(!dbTableInfo.empty()) {
@@ -909,8 +4167,47 @@ namespace sqlite_orm {
             }
 
             template<class... Cols>
-            sync_schema_result sync_table(const index_t<Cols...>& index, sqlite3* db, bool) {
+            std::string create_schema_object_sql(const index_t<Cols...>& index) const {
+                return this->stored_index_sql(index);
+            }
+
+            template<class... Cols>
+            std::string create_schema_object_sql(const trigger_t<Cols...>& trigger) const {
+                using context_t = serializer_context<db_objects_type>;
+                context_t context{this->db_objects};
+                return serialize(trigger, context);
+            }
+
+            template<class O, class S>
+            std::string create_schema_object_sql(const materialized_view_t<O, S>& view) const {
+                std::string result;
+                for(auto& trigger: make_materialized_view_sql(view, this->db_objects).triggers) {
+                    result += trigger.second + ";";
+                }
+                return result;
+            }
+
+            template<class Table, satisfies<is_table, Table> = true>
+            std::string create_schema_object_sql(const Table& table) const {
+                return this->create_table_sql(table.name, table);
+            }
+
+            /**
+             *  Creates the index if it doesn't exist. An index whose columns, expressions, collations or WHERE
+             *  clause differ from the ones in the database is dropped and created again.
+             */
+            template<class... Cols>
+            sync_schema_result
+            sync_table(const index_t<Cols...>& index, sqlite3* db, bool, const schema_snapshot& snapshot) {
                 auto res = sync_schema_result::already_in_sync;
+                auto schemaName = this->index_schema_name(index);
+                auto dbIndexSql = this->schema_sql(db, "index", index.name, schemaName, snapshot);
+                if(!dbIndexSql.empty() && dbIndexSql != this->stored_index_sql(index)) {
+                    std::stringstream ss;
+                    ss << "DROP INDEX " << streaming_identifier(schemaName, index.name, std::string{}) << std::flush;
+                    perform_void_exec(db, ss.str());
+                    res = sync_schema_result::dropped_and_recreated;
+                }
                 using context_t = serializer_context<db_objects_type>;
                 context_t context{this->db_objects};
                 auto query = serialize(index, context);
@@ -919,7 +4216,8 @@ namespace sqlite_orm {
             }
 
             template<class... Cols>
-            sync_schema_result sync_table(const trigger_t<Cols...>& trigger, sqlite3* db, bool) {
+            sync_schema_result
+            sync_table(const trigger_t<Cols...>& trigger, sqlite3* db, bool, const schema_snapshot&) {
                 auto res = sync_schema_result::already_in_sync;  // TODO Change accordingly
                 using context_t = serializer_context<db_objects_type>;
                 context_t context{this->db_objects};
@@ -927,33 +4225,191 @@ namespace sqlite_orm {
                 return res;
             }
 
+            /**
+             *  Creates the triggers of a materialized view and fills its table if they don't exist. Triggers that
+             *  differ from the ones in the database are dropped and created again, and the table is filled again.
+             */
+            template<class O, class S>
+            sync_schema_result
+            sync_table(const materialized_view_t<O, S>& view, sqlite3* db, bool, const schema_snapshot&) {
+                auto sql = make_materialized_view_sql(view, this->db_objects);
+                auto res = this->materialized_view_status(view, sql, db);
+                if(res == sync_schema_result::already_in_sync) {
+                    return res;
+                }
+                for(const char* suffix: {"_insert", "_update", "_delete"}) {
+                    perform_void_exec(db, "DROP TRIGGER IF EXISTS " + quote_identifier(view.name + suffix));
+                }
+                for(auto& trigger: sql.triggers) {
+                    perform_void_exec(db, trigger.second);
+                }
+                perform_void_exec(db, "DELETE FROM " + quote_identifier(pick_table<O>(this->db_objects).name));
+                perform_void_exec(db, sql.refill);
+                return res;
+            }
+
             template<class Table, satisfies<is_table, Table> = true>
-            sync_schema_result sync_table(const Table& table, sqlite3* db, bool preserve);
+            sync_schema_result
+            sync_table(const Table& table, sqlite3* db, bool preserve, const schema_snapshot& snapshot);
 
             template<class C>
-            void add_column(sqlite3* db, const std::string& tableName, const C& column) const {
+            void add_column(sqlite3* db,
+                            const std::string& schemaName,
+                            const std::string& tableName,
+                            const C& column) const {
                 using context_t = serializer_context<db_objects_type>;
 
                 context_t context{this->db_objects};
                 std::stringstream ss;
-                ss << "ALTER TABLE " << streaming_identifier(tableName) << " ADD COLUMN " << serialize(column, context)
-                   << std::flush;
+                ss << "ALTER TABLE " << streaming_identifier(schemaName, tableName, std::string{}) << " ADD COLUMN "
+                   << serialize(column, context) << std::flush;
                 perform_void_exec(db, ss.str());
             }
 
+            /**
+             *  @param cache if not null the statement is taken from this cache if possible
+             *  and put back there when the returned prepared statement is destroyed.
+             *  @param forCall whether the statement is dropped before the call it is prepared for returns, which
+             *  lets it use the connection of a `session()` without retaining it.
+             */
             template<typename S>
-            prepared_statement_t<S> prepare_impl(S statement) {
+            prepared_statement_t<S>
+            prepare_impl(S statement, std::shared_ptr<statement_cache> cache = nullptr, bool forCall = false) {
                 using context_t = serializer_context<db_objects_type>;
                 context_t context{this->db_objects};
                 context.skip_table_name = false;
                 context.replace_bindable_with_question = true;
 
-                auto con = this->get_connection();
-                sqlite3_stmt* stmt = prepare_stmt(con.get(), serialize(statement, context));
-                return prepared_statement_t<S>{std::forward<S>(statement), stmt, con};
+                auto con = forCall ? this->get_call_connection(is_reading_statement_v<S>)
+                                   : (is_reading_statement_v<S> ? this->get_read_connection() : this->get_connection());
+                //  statements of the cache and the ones returned by `prepare()` are kept, the others are finalized
+                //  after their call
+                const prepare_flags flags = forCall ? (cache ? prepare_flags::persistent : prepare_flags::none)
+                                                    : prepare_flags_scope::flags_or(prepare_flags::persistent);
+                sqlite3_stmt* stmt = this->prepare_stmt_impl(con.get(), statement, context, cache.get(), flags);
+                return prepared_statement_t<S>{std::forward<S>(statement), stmt, con, std::move(cache)};
+            }
+
+            template<class S, class Ctx>
+            sqlite3_stmt* prepare_stmt_impl(sqlite3* db,
+                                            const S& statement,
+                                            const Ctx& context,
+                                            statement_cache* cache,
+                                            prepare_flags flags) {
+                auto tracer = this->make_execute_tracer(nullptr, execute_phase::serialize);
+                sqlite3_stmt* stmt = nullptr;
+                if(is_sql_static_v<S>) {
+                    const std::string& sql = this->staticSqls.get(statement_type_key<S>(), [&statement, &context] {
+                        return serialize(statement, context);
+                    });
+                    tracer.phase(execute_phase::prepare);
+                    stmt = cache ? cache->take(db, sql) : nullptr;
+                    if(!stmt) {
+                        stmt = prepare_stmt(db, sql.c_str(), sql.size(), flags);
+                    }
+                } else if(sql_shape<S>::memoizable) {
+                    std::string shapeKey;
+                    append_sql_shape_key(statement, shapeKey);
+                    const std::string& sql =
+                        this->staticSqls.get(statement_type_key<S>(), move(shapeKey), [&statement, &context] {
+                            return serialize(statement, context);
+                        });
+                    tracer.phase(execute_phase::prepare);
+                    stmt = cache ? cache->take(db, sql) : nullptr;
+                    if(!stmt) {
+                        stmt = prepare_stmt(db, sql.c_str(), sql.size(), flags);
+                    }
+                } else {
+                    std::string sql = serialize(statement, context);
+                    tracer.phase(execute_phase::prepare);
+                    stmt = cache ? cache->take(db, sql) : nullptr;
+                    if(!stmt) {
+                        stmt = prepare_stmt(db, move(sql), flags);
+                    }
+                }
+                tracer.set_stmt(stmt);
+                return stmt;
+            }
+
+            /**
+             *  `prepare()` used by the non-prepared CRUD API. Goes through the statement cache if it is enabled.
+             */
+            template<class S>
+            prepared_statement_t<S> prepare_cached(S statement) {
+                return this->prepare_impl<S>(std::move(statement), this->get_statement_cache(), true);
+            }
+
+            template<class T, class... Args>
+            prepared_statement_t<select_t<T, Args...>> prepare_cached(select_t<T, Args...> sel) {
+                sel.highest_level = true;
+                return this->prepare_impl<select_t<T, Args...>>(std::move(sel), this->get_statement_cache(), true);
             }
 
           public:
+            /**
+             *  Registers the statement of `expression` to be prepared on every connection of the storage as soon
+             *  as the connection opens, and prepares it now. With the statement cache enabled, the calls of the
+             *  non-prepared API with the same shape, e.g. `get<User>(id)` for `prepare_on_open(get<User>(0))`,
+             *  find it prepared instead of preparing it on the first request; without the cache only the schema
+             *  is parsed in advance. Call it after `sync_schema()`.
+             */
+            template<class S>
+            void prepare_on_open(S expression) {
+                std::string sql;
+                {
+                    auto statement = this->prepare_cached(std::move(expression));
+                    sql = sqlite3_sql(statement.stmt);
+                }
+                this->openPreparedSqls.push_back(move(sql));
+            }
+
+            /**
+             *  Reads the pages of the table of O and of its indexes into the page cache of the connection of the
+             *  calling thread, and so into the OS cache or the memory map, e.g. right after opening a storage whose
+             *  first requests would otherwise wait for the disk. Every b-tree is read by a `SELECT count(*)` scan,
+             *  which leaves overflow pages of large values alone.
+             */
+            template<class O>
+            void warm_up() {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                auto con = this->get_read_connection();
+                sqlite3* db = con.get();
+
+                std::stringstream ss;
+                ss << "SELECT name FROM ";
+                if(!table.schema_name.empty()) {
+                    ss << streaming_identifier(table.schema_name) << ".";
+                }
+                ss << "sqlite_master WHERE type = 'index' AND tbl_name = " << quote_string_literal(table.name)
+                   << std::flush;
+                std::vector<std::string> indexNames;
+                perform_exec(
+                    db,
+                    ss.str(),
+                    [](void* data, int argc, char** argv, char**) -> int {
+                        if(argc && argv[0]) {
+                            static_cast<std::vector<std::string>*>(data)->emplace_back(argv[0]);
+                        }
+                        return 0;
+                    },
+                    &indexNames);
+
+                auto countQuery = [&table](const std::string& indexing) {
+                    std::stringstream ss;
+                    ss << "SELECT count(*) FROM " << streaming_table_identifier(table) << " " << indexing
+                       << std::flush;
+                    return ss.str();
+                };
+                perform_void_exec(db, countQuery("NOT INDEXED"));
+                for(auto& indexName: indexNames) {
+                    std::stringstream ss;
+                    ss << "INDEXED BY " << streaming_identifier(indexName) << std::flush;
+                    //  a partial index can't serve the scan, it is left cold
+                    sqlite3_exec(db, countQuery(ss.str()).c_str(), nullptr, nullptr, nullptr);
+                }
+            }
+
             /**
              *  This is a cute function used to replace migration up/down functionality.
              *  It performs check storage schema with actual db schema and:
@@ -980,33 +4436,299 @@ namespace sqlite_orm {
              *  @return std::map with std::string key equal table name and `sync_schema_result` as value.
              * `sync_schema_result` is a enum value that stores table state after syncing a schema. `sync_schema_result`
              * can be printed out on std::ostream with `operator<<`.
+             *  All changes are made in one IMMEDIATE transaction unless `sync_schema_in_transaction` is false.
+             */
+            std::map<std::string, sync_schema_result> sync_schema(bool preserve = false) {
+                auto con = this->get_connection();
+                std::map<std::string, sync_schema_result> result;
+                {
+                    std::unique_ptr<transaction_guard_t> guard;
+                    if(this->sync_schema_in_transaction) {
+                        guard = std::make_unique<transaction_guard_t>(this->immediate_transaction_guard());
+                    }
+                    auto snapshot = this->cached_schema_snapshot(con.get());
+                    iterate_tuple<true>(this->db_objects,
+                                        [this, db = con.get(), preserve, &snapshot, &result](auto& schemaObject) {
+                                            sync_schema_result status =
+                                                this->sync_table(schemaObject, db, preserve, *snapshot);
+                                            result.emplace(schemaObject.name, status);
+                                        });
+                    if(guard) {
+                        guard->commit();
+                    }
+                }
+                this->schemaCache.invalidate();
+                if(this->auto_optimize.after_sync_schema) {
+                    this->optimize_connection(con.get(), 0x10002);
+                }
+                return result;
+            }
+
+            /**
+             *  Does the same as `sync_schema()` but only if the mapped schema changed since the last call. A
+             *  fingerprint of the schema (a hash of the CREATE statements of all tables, indexes and triggers)
+             *  is kept in `PRAGMA user_version`. If it matches, the database isn't inspected at all and every
+             *  schema object is reported as `already_in_sync`.
+             *  The database must not be changed by other means since then and `user_version` must not be used
+             *  for anything else.
+             */
+            std::map<std::string, sync_schema_result> sync_schema_if_changed(bool preserve = false) {
+                auto fingerprint = this->schema_fingerprint();
+                if(this->pragma.user_version() == fingerprint) {
+                    std::map<std::string, sync_schema_result> result;
+                    iterate_tuple<true>(this->db_objects, [&result](auto& schemaObject) {
+                        result.emplace(schemaObject.name, sync_schema_result::already_in_sync);
+                    });
+                    return result;
+                }
+                auto result = this->sync_schema(preserve);
+                this->pragma.user_version(fingerprint);
+                return result;
+            }
+
+            /**
+             *  Fingerprint of the mapped schema that `sync_schema_if_changed()` keeps in `PRAGMA user_version`.
+             *  It is never 0, the `user_version` of a new database.
+             */
+            int schema_fingerprint() const {
+                //  32-bit FNV-1a
+                std::uint32_t hash = 2166136261u;
+                iterate_tuple<true>(this->db_objects, [this, &hash](auto& schemaObject) {
+                    auto sql = this->create_schema_object_sql(schemaObject);
+                    //  the terminating null character separates the statements
+                    for(size_t i = 0; i <= sql.size(); ++i) {
+                        hash = (hash ^ static_cast<unsigned char>(sql.c_str()[i])) * 16777619u;
+                    }
+                });
+                return hash ? int(hash) : 1;
+            }
+
+            /**
+             *  This function returns the same map that `sync_schema` returns but it
+             *  doesn't perform `sync_schema` actually - just simulates it in case you want to know
+             *  what will happen if you sync your schema.
+             */
+            std::map<std::string, sync_schema_result> sync_schema_simulate(bool preserve = false) {
+                auto con = this->get_connection();
+                std::map<std::string, sync_schema_result> result;
+                auto snapshot = this->cached_schema_snapshot(con.get());
+                iterate_tuple<true>(this->db_objects,
+                                    [this, db = con.get(), preserve, &snapshot, &result](auto& schemaObject) {
+                                        sync_schema_result status =
+                                            this->schema_status(schemaObject, db, preserve, nullptr, *snapshot);
+                                        result.emplace(schemaObject.name, status);
+                                    });
+                return result;
+            }
+
+            /**
+             *  Rebuilds the table of O with its mapped schema while other connections keep writing to it, which
+             *  is what `sync_schema(true)` does with one copy under one lock when it reports `dropped_and_recreated`.
+             *  The rows are copied by rowid into a new table in IMMEDIATE transactions of `chunkSize` rows.
+             *  Triggers record the rowids that are changed meanwhile in a delta table. A final short
+             *  transaction copies these rows again and replaces the table with the new one.
+             *  Columns that the database table doesn't have get their default values. The indexes of the table
+             *  are dropped with it, a following `sync_schema()` creates them again.
+             *  The database table must have rowids and this mustn't be called inside a transaction.
+             *  @param onChunk is called with the number of copied rows after every chunk.
+             */
+            template<class O>
+            void rebuild_table_online(size_t chunkSize = 10000, std::function<void(size_t)> onChunk = {}) {
+                this->assert_mapped_type<O>();
+                auto& table = this->get_table<O>();
+                using table_type = std::decay_t<decltype(table)>;
+                static_assert(!table_type::is_without_rowid_v, "The rebuilt table is copied by rowid");
+
+                auto con = this->get_connection();
+                sqlite3* db = con.get();
+                if(!this->table_exists(db, table.name)) {
+                    this->create_table(db, table.name, table);
+                    return;
+                }
+                const std::string newTableName = table.name + "_rebuild";
+                const std::string deltaTableName = table.name + "_rebuild_delta";
+                constexpr std::array<const char*, 3> triggerEvents = {"insert", "update", "delete"};
+
+                //  the columns a row is copied with: the mapped ones the table has except generated ones
+                auto dbTableInfo = this->pragma.table_xinfo(table.name);
+                std::vector<std::string> columnNames;
+                table.for_each_column([&table, &dbTableInfo, &columnNames](const column_identifier& column) {
+                    if(table.find_column_generated_storage_type(column.name)) {
+                        return;
+                    }
+                    auto it = std::find_if(dbTableInfo.begin(),
+                                           dbTableInfo.end(),
+                                           [&column](const sqlite_orm::table_xinfo& info) {
+                                               return info.name == column.name && !info.hidden;
+                                           });
+                    if(it != dbTableInfo.end()) {
+                        columnNames.push_back(column.name);
+                    }
+                });
+                auto copyRowsQuery = [&columnNames, &table, &newTableName](const std::string& where) {
+                    std::stringstream ss;
+                    ss << "INSERT INTO " << streaming_identifier(newTableName) << " (\"rowid\", "
+                       << streaming_identifiers(columnNames) << ") SELECT \"rowid\", "
+                       << streaming_identifiers(columnNames) << " FROM " << streaming_identifier(table.name) << " "
+                       << where << std::flush;
+                    return ss.str();
+                };
+
+                //  leftovers of a rebuild that didn't finish
+                for(const char* event: triggerEvents) {
+                    perform_void_exec(db, "DROP TRIGGER IF EXISTS " + quote_identifier(newTableName + "_" + event));
+                }
+                perform_void_exec(db, "DROP TABLE IF EXISTS " + quote_identifier(deltaTableName));
+                perform_void_exec(db, "DROP TABLE IF EXISTS " + quote_identifier(newTableName));
+
+                sqlite3_int64 maxRowid = 0;
+                {
+                    auto guard = this->immediate_transaction_guard();
+                    this->create_table(db, newTableName, table);
+                    perform_void_exec(
+                        db,
+                        "CREATE TABLE " + quote_identifier(deltaTableName) + " (\"id\" INTEGER PRIMARY KEY)");
+                    for(const char* event: triggerEvents) {
+                        std::stringstream ss;
+                        ss << "CREATE TRIGGER " << streaming_identifier(newTableName + "_" + event) << " AFTER "
+                           << event << " ON " << streaming_identifier(table.name) << " BEGIN";
+                        //  an update is recorded with both rowids since it can change the rowid
+                        if(event != triggerEvents[0]) {
+                            ss << " INSERT OR IGNORE INTO " << streaming_identifier(deltaTableName)
+                               << " VALUES (OLD.\"rowid\");";
+                        }
+                        if(event != triggerEvents[2]) {
+                            ss << " INSERT OR IGNORE INTO " << streaming_identifier(deltaTableName)
+                               << " VALUES (NEW.\"rowid\");";
+                        }
+                        ss << " END" << std::flush;
+                        perform_void_exec(db, ss.str());
+                    }
+                    perform_exec(db,
+                                 "SELECT IFNULL(MAX(\"rowid\"), 0) FROM " + quote_identifier(table.name),
+                                 extract_single_value<sqlite3_int64>,
+                                 &maxRowid);
+                    guard.commit();
+                }
+
+                //  rows that exist now are copied in chunks, later changes are recorded in the delta table
+                size_t copiedCount = 0;
+                bool first = true;
+                sqlite3_int64 lastRowid = 0;
+                while(first || lastRowid < maxRowid) {
+                    std::stringstream ss;
+                    if(!first) {
+                        ss << "WHERE \"rowid\" > " << lastRowid << " ";
+                    }
+                    ss << "ORDER BY \"rowid\" LIMIT " << chunkSize << std::flush;
+                    auto guard = this->immediate_transaction_guard();
+                    perform_void_exec(db, copyRowsQuery(ss.str()));
+                    auto changes = sqlite3_changes(db);
+                    perform_exec(db,
+                                 "SELECT IFNULL(MAX(\"rowid\"), 0) FROM " + quote_identifier(newTableName),
+                                 extract_single_value<sqlite3_int64>,
+                                 &lastRowid);
+                    guard.commit();
+                    first = false;
+                    copiedCount += size_t(changes);
+                    if(onChunk) {
+                        onChunk(copiedCount);
+                    }
+                    if(!changes) {
+                        break;
+                    }
+                }
+
+                auto guard = this->immediate_transaction_guard();
+                const std::string deltaRowids =
+                    "\"rowid\" IN (SELECT \"id\" FROM " + quote_identifier(deltaTableName) + ")";
+                perform_void_exec(db, "DELETE FROM " + quote_identifier(newTableName) + " WHERE " + deltaRowids);
+                perform_void_exec(db, copyRowsQuery("WHERE " + deltaRowids));
+                for(const char* event: triggerEvents) {
+                    perform_void_exec(db, "DROP TRIGGER " + quote_identifier(newTableName + "_" + event));
+                }
+                perform_void_exec(db, "DROP TABLE " + quote_identifier(deltaTableName));
+                this->drop_table_internal(db, table.name);
+                this->rename_table(db, newTableName, table.name);
+                guard.commit();
+            }
+
+            using storage_base::table_exists;  // now that it is in storage_base make it into overload set
+
+            using storage_base::analyze;
+
+            /**
+             *  Runs `ANALYZE` for the table mapped to `O`, refreshing the statistics of its indexes.
              */
-            std::map<std::string, sync_schema_result> sync_schema(bool preserve = false) {
-                auto con = this->get_connection();
-                std::map<std::string, sync_schema_result> result;
-                iterate_tuple<true>(this->db_objects, [this, db = con.get(), preserve, &result](auto& schemaObject) {
-                    sync_schema_result status = this->sync_table(schemaObject, db, preserve);
-                    result.emplace(schemaObject.name, status);
-                });
-                return result;
+            template<class O>
+            void analyze() {
+                this->assert_mapped_type<O>();
+                storage_base::analyze(this->get_table<O>().name);
             }
 
             /**
-             *  This function returns the same map that `sync_schema` returns but it
-             *  doesn't perform `sync_schema` actually - just simulates it in case you want to know
-             *  what will happen if you sync your schema.
+             *  Returns the statement of type S prepared on the connection of the calling thread, preparing it
+             *  from `expression` on first use. Every connection has a slot per statement type, so after the first
+             *  call reusing the statement costs an index into the slots of the connection and its execution just
+             *  binds, steps and resets. Later calls ignore `expression`: set the arguments by `get<N>()`.
+             *  @example: auto getUser = storage.statement<decltype(get<User>(0))>();
+             *            get<0>(*getUser) = id;
+             *            auto user = storage.execute(*getUser);
+             *  The statement lives as long as its connection: with a plain file storage it is prepared again
+             *  after the connection was closed, unless the storage is opened forever. Like every prepared
+             *  statement it is used by one thread at a time; pooled connections have their own slots.
              */
-            std::map<std::string, sync_schema_result> sync_schema_simulate(bool preserve = false) {
-                auto con = this->get_connection();
-                std::map<std::string, sync_schema_result> result;
-                iterate_tuple<true>(this->db_objects, [this, db = con.get(), preserve, &result](auto& schemaObject) {
-                    sync_schema_result status = this->schema_status(schemaObject, db, preserve, nullptr);
-                    result.emplace(schemaObject.name, status);
-                });
-                return result;
+            template<class S>
+            statement_handle<S> statement(S expression) {
+                auto con = is_reading_statement_v<S> ? this->get_read_connection() : this->get_connection();
+                auto& slots = con.statement_slots();
+                const size_t index = statement_slot_index<S>();
+                if(index >= slots.size()) {
+                    slots.resize(index + 1);
+                }
+                if(!slots[index]) {
+                    slots[index] = std::make_unique<statement_slot<S>>(this->prepare(std::move(expression)));
+                }
+                return {std::move(con), static_cast<statement_slot<S>&>(*slots[index]).statement};
             }
 
-            using storage_base::table_exists;  // now that it is in storage_base make it into overload set
+            /**
+             *  `statement(S{})` for statement types whose SQL doesn't depend on their values, like `get_t`.
+             */
+            template<class S>
+            statement_handle<S> statement() {
+                return this->statement(S{});
+            }
+
+            /**
+             *  Executes `statement` with the statement prepared for it on the connection of the calling thread,
+             *  preparing it there on first use. `setArguments` gets that prepared statement right before it runs,
+             *  to set the arguments of this execution by `get<N>()`. Threads sharing a connection run its
+             *  statement one at a time, so with a pool every worker runs on its own connection in parallel.
+             *  @example: static const auto getUser = make_shared_statement(get<User>(0));
+             *            auto user = storage.execute(getUser, [id](auto& statement) {
+             *                get<0>(statement) = id;
+             *            });
+             */
+            template<class S, class F>
+            decltype(auto) execute(const shared_statement_t<S>& statement, F&& setArguments) {
+                auto con = is_reading_statement_v<S> ? this->get_read_connection() : this->get_connection();
+                auto& slot = static_cast<shared_statement_slot<S>&>(
+                    con.shared_statement(statement.id(), [this, &statement] {
+                        return std::make_unique<shared_statement_slot<S>>(this->prepare(statement.get_expression()));
+                    }));
+                std::lock_guard<std::mutex> lock{slot.mutex};
+                setArguments(slot.statement);
+                return this->execute(static_cast<const prepared_statement_t<S>&>(slot.statement));
+            }
+
+            /**
+             *  `execute(statement, setArguments)` for shared statements whose arguments are never changed.
+             */
+            template<class S>
+            decltype(auto) execute(const shared_statement_t<S>& statement) {
+                return this->execute(statement, [](prepared_statement_t<S>&) {});
+            }
 
             template<class T, class... Args>
             prepared_statement_t<select_t<T, Args...>> prepare(select_t<T, Args...> sel) {
@@ -1014,6 +4736,14 @@ namespace sqlite_orm {
                 return prepare_impl<select_t<T, Args...>>(std::move(sel));
             }
 
+            template<class... CTEs, class E>
+            prepared_statement_t<with_t<std::tuple<CTEs...>, E>> prepare(with_t<std::tuple<CTEs...>, E> statement) {
+                static_assert(!polyfill::disjunction_v<
+                                  is_mapped<db_objects_type, object_type_t<typename CTEs::table_type>>...>,
+                              "The row type of a common table expression must not be mapped to the storage");
+                return prepare_impl<with_t<std::tuple<CTEs...>, E>>(std::move(statement));
+            }
+
             template<class T, class... Args>
             prepared_statement_t<get_all_t<T, Args...>> prepare(get_all_t<T, Args...> get_) {
                 return prepare_impl<get_all_t<T, Args...>>(std::move(get_));
@@ -1041,6 +4771,18 @@ namespace sqlite_orm {
             }
 #endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
 
+            template<class S, class T>
+            prepared_statement_t<returning_t<S, T>> prepare(returning_t<S, T> statement) {
+                static_assert(polyfill::disjunction_v<is_insert<S>,
+                                                      is_insert_range<S>,
+                                                      is_replace<S>,
+                                                      is_replace_range<S>,
+                                                      polyfill::is_specialization_of<S, update_all_t>,
+                                                      polyfill::is_specialization_of<S, remove_all_t>>,
+                              "RETURNING follows an INSERT, REPLACE, UPDATE or DELETE statement");
+                return this->prepare_impl<returning_t<S, T>>(std::move(statement));
+            }
+
             template<class... Args, class... Wargs>
             prepared_statement_t<update_all_t<set_t<Args...>, Wargs...>>
             prepare(update_all_t<set_t<Args...>, Wargs...> upd) {
@@ -1111,6 +4853,14 @@ namespace sqlite_orm {
                 return this->prepare_impl<replace_range_t<It, L, O>>(std::move(statement));
             }
 
+#if SQLITE_VERSION_NUMBER >= 3024000
+            template<class It, class L, class O, class U>
+            prepared_statement_t<upsert_range_t<It, L, O, U>> prepare(upsert_range_t<It, L, O, U> statement) {
+                this->assert_mapped_type<O>();
+                return this->prepare_impl<upsert_range_t<It, L, O, U>>(std::move(statement));
+            }
+#endif
+
             template<class T, class... Cols>
             prepared_statement_t<insert_explicit<T, Cols...>> prepare(insert_explicit<T, Cols...> ins) {
                 using object_type = typename expression_object_type<decltype(ins)>::type;
@@ -1118,17 +4868,32 @@ namespace sqlite_orm {
                 return this->prepare_impl<insert_explicit<T, Cols...>>(std::move(ins));
             }
 
+            /**
+             *  Same as `prepare(statement)` with the flags of `sqlite3_prepare_v3()` instead of
+             *  `prepare_flags::persistent`, e.g. `prepare_flags::persistent | prepare_flags::no_vtab` for statements
+             *  that must not run code of virtual tables, or `prepare_flags::none` for a statement used only once.
+             */
+            template<class S>
+            auto prepare(S statement, prepare_flags flags) -> decltype(this->prepare(std::move(statement))) {
+                prepare_flags_scope scope{flags};
+                return this->prepare(std::move(statement));
+            }
+
             template<class... Args>
             void execute(const prepared_statement_t<replace_raw_t<Args...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
-                iterate_ast(statement.expression.args, conditional_binder{statement.stmt});
+                auto tracer = this->make_execute_tracer(stmt);
+                bind_changed_parameters(statement, statement.expression.args);
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
             }
 
             template<class... Args>
             void execute(const prepared_statement_t<insert_raw_t<Args...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
-                iterate_ast(statement.expression.args, conditional_binder{stmt});
+                auto tracer = this->make_execute_tracer(stmt);
+                bind_changed_parameters(statement, statement.expression.args);
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
             }
 
@@ -1139,12 +4904,17 @@ namespace sqlite_orm {
                 using object_type = typename expression_object_type<expression_type>::type;
 
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                tuple_value_binder{stmt}(
-                    statement.expression.columns.columns,
-                    [&table = this->get_table<object_type>(), &object = statement.expression.obj](auto& memberPointer) {
-                        return table.object_field_value(object, memberPointer);
-                    });
+                auto& table = this->get_table<object_type>();
+                const object_type& object = get_ref(statement.expression.obj);
+                //  the object is held by the expression or by the caller, so it outlives the step
+                field_value_binder bind_value{stmt, true};
+                iterate_tuple(statement.expression.columns.columns,
+                              [&table, &object, &bind_value](auto& memberPointer) {
+                                  bind_value(table.object_field_value(object, memberPointer));
+                              });
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
                 return sqlite3_last_insert_rowid(sqlite3_db_handle(stmt));
             }
@@ -1152,182 +4922,177 @@ namespace sqlite_orm {
             template<class T,
                      std::enable_if_t<polyfill::disjunction_v<is_replace<T>, is_replace_range<T>>, bool> = true>
             void execute(const prepared_statement_t<T>& statement) {
-                using statement_type = std::decay_t<decltype(statement)>;
-                using expression_type = typename statement_type::expression_type;
-                using object_type = typename expression_object_type<expression_type>::type;
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+                field_value_binder bind_value{stmt, true};
+                this->bind_statement_values(bind_value, statement.expression);
+                key_filter_write_scope keyScope{this->add_key_filter_keys(statement.expression)};
+                tracer.phase(execute_phase::step);
+                perform_step(stmt);
+            }
 
+#if SQLITE_VERSION_NUMBER >= 3024000
+            template<class It, class L, class O, class U>
+            void execute(const prepared_statement_t<upsert_range_t<It, L, O, U>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                auto processObject = [&table = this->get_table<object_type>(),
-                                      bind_value = field_value_binder{stmt}](auto& object) mutable {
+                auto& table = this->get_table<O>();
+                field_value_binder bindValue{stmt, true};
+                auto processObject = [&table, &bindValue](const O& object) {
                     table.template for_each_column_excluding<is_generated_always>(
-                        call_as_template_base<column_field>([&bind_value, &object](auto& column) {
-                            bind_value(polyfill::invoke(column.member_pointer, object));
+                        call_as_template_base<column_field>([&bindValue, &object](auto& column) {
+                            bindValue(polyfill::invoke(column.member_pointer, object));
                         }));
                 };
+                for_each_range_object(statement.expression, processObject);
+                //  the values of the upsert clause follow the ones of the rows
+                conditional_binder bindUpsert{stmt};
+                bindUpsert.index = bindValue.index;
+                iterate_ast(statement.expression.upsert, bindUpsert);
 
-                static_if<is_replace_range_v<T>>(
-                    [&processObject](auto& expression) {
-#if __cpp_lib_ranges >= 201911L
-                        std::ranges::for_each(expression.range.first,
-                                              expression.range.second,
-                                              std::ref(processObject),
-                                              std::ref(expression.transformer));
-#else
-                        auto& transformer = expression.transformer;
-                        std::for_each(expression.range.first,
-                                      expression.range.second,
-                                      [&processObject, &transformer](auto& item) {
-                                          const object_type& object = polyfill::invoke(transformer, item);
-                                          processObject(object);
-                                      });
-#endif
-                    },
-                    [&processObject](auto& expression) {
-                        const object_type& o = get_object(expression);
-                        processObject(o);
-                    })(statement.expression);
-
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
             }
+#endif
 
             template<class T, std::enable_if_t<polyfill::disjunction_v<is_insert<T>, is_insert_range<T>>, bool> = true>
             int64 execute(const prepared_statement_t<T>& statement) {
-                using statement_type = std::decay_t<decltype(statement)>;
-                using expression_type = typename statement_type::expression_type;
-                using object_type = typename expression_object_type<expression_type>::type;
-
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
-
-                auto processObject = [&table = this->get_table<object_type>(),
-                                      bind_value = field_value_binder{stmt}](auto& object) mutable {
-                    using is_without_rowid = typename std::decay_t<decltype(table)>::is_without_rowid;
-                    table.template for_each_column_excluding<
-                        mpl::conjunction<mpl::not_<mpl::always<is_without_rowid>>,
-                                         mpl::disjunction_fn<is_primary_key, is_generated_always>>>(
-                        call_as_template_base<column_field>([&table, &bind_value, &object](auto& column) {
-                            if(!table.exists_in_composite_primary_key(column)) {
-                                bind_value(polyfill::invoke(column.member_pointer, object));
-                            }
-                        }));
-                };
-
-                static_if<is_insert_range_v<T>>(
-                    [&processObject](auto& expression) {
-#if __cpp_lib_ranges >= 201911L
-                        std::ranges::for_each(expression.range.first,
-                                              expression.range.second,
-                                              std::ref(processObject),
-                                              std::ref(expression.transformer));
-#else
-                        auto& transformer = expression.transformer;
-                        std::for_each(expression.range.first,
-                                      expression.range.second,
-                                      [&processObject, &transformer](auto& item) {
-                                          const object_type& object = polyfill::invoke(transformer, item);
-                                          processObject(object);
-                                      });
-#endif
-                    },
-                    [&processObject](auto& expression) {
-                        const object_type& o = get_object(expression);
-                        processObject(o);
-                    })(statement.expression);
-
+                auto tracer = this->make_execute_tracer(stmt);
+                field_value_binder bind_value{stmt, true};
+                this->bind_statement_values(bind_value, statement.expression);
+                key_filter_write_scope keyScope{this->add_key_filter_keys(statement.expression)};
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
                 return sqlite3_last_insert_rowid(sqlite3_db_handle(stmt));
             }
 
+            template<class S, class T, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> execute(const prepared_statement_t<returning_t<S, T>>& statement) {
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+                field_value_binder bind_value{stmt, true};
+                this->bind_statement_values(bind_value, statement.expression.statement);
+                //  the values of the RETURNING clause follow the ones of the statement
+                conditional_binder bindColumns{stmt};
+                bindColumns.index = bind_value.index;
+                iterate_ast(statement.expression.columns, bindColumns);
+
+                std::vector<R> res;
+                auto rowExtractor = make_select_row_extractor<R, T>(this->db_objects);
+                tracer.phase(execute_phase::step);
+                perform_steps(stmt, tracer.extracting([&rowExtractor, &res](sqlite3_stmt* stmt) {
+                    append_row(res, rowExtractor, stmt);
+                }));
+                return res;
+            }
+
             template<class T, class... Ids>
             void execute(const prepared_statement_t<remove_t<T, Ids...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
-                iterate_ast(statement.expression.ids, conditional_binder{stmt});
+                auto tracer = this->make_execute_tracer(stmt);
+                bind_changed_parameters(statement, statement.expression.ids);
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
             }
 
             template<class T>
             void execute(const prepared_statement_t<update_t<T>>& statement) {
-                using statement_type = std::decay_t<decltype(statement)>;
-                using expression_type = typename statement_type::expression_type;
-                using object_type = typename expression_object_type<expression_type>::type;
-
-                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
-                auto& table = this->get_table<object_type>();
-
-                field_value_binder bind_value{stmt};
-                auto& object = get_object(statement.expression);
-                table.template for_each_column_excluding<mpl::disjunction_fn<is_primary_key, is_generated_always>>(
-                    call_as_template_base<column_field>([&table, &bind_value, &object](auto& column) {
-                        if(!table.exists_in_composite_primary_key(column)) {
-                            bind_value(polyfill::invoke(column.member_pointer, object));
-                        }
-                    }));
-                table.for_each_column([&table, &bind_value, &object](auto& column) {
-                    if(column.template is<is_primary_key>() || table.exists_in_composite_primary_key(column)) {
-                        bind_value(polyfill::invoke(column.member_pointer, object));
-                    }
-                });
-                perform_step(stmt);
+                if(!this->execute_update(statement)) {
+                    throw std::system_error{orm_error_code::version_conflict};
+                }
             }
 
             template<class T, class... Ids>
             std::unique_ptr<T> execute(const prepared_statement_t<get_pointer_t<T, Ids...>>& statement) {
+                if(this->excluded_by_key_filter<T>(statement.expression.ids)) {
+                    return nullptr;
+                }
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                iterate_ast(statement.expression.ids, conditional_binder{stmt});
+                bind_changed_parameters(statement, statement.expression.ids);
 
                 std::unique_ptr<T> res;
-                perform_step(stmt, [&table = this->get_table<T>(), &res](sqlite3_stmt* stmt) {
-                    res = std::make_unique<T>();
-                    object_from_column_builder<T> builder{*res, stmt};
-                    table.for_each_column(builder);
-                });
+                auto lazySource = this->lazy_source_of<T>();
+                tracer.phase(execute_phase::step);
+                perform_step(stmt,
+                             tracer.extracting([&table = this->get_table<T>(), &res, &lazySource](sqlite3_stmt* stmt) {
+                                 res = std::make_unique<T>();
+                                 object_from_column_builder<T> builder{*res, stmt, lazySource};
+                                 build_object_columns(builder, table);
+                             }));
+                if(!res) {
+                    this->key_filter_missed<T>();
+                }
                 return res;
             }
 
 #ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
             template<class T, class... Ids>
             std::optional<T> execute(const prepared_statement_t<get_optional_t<T, Ids...>>& statement) {
+                if(this->excluded_by_key_filter<T>(statement.expression.ids)) {
+                    return std::nullopt;
+                }
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                iterate_ast(statement.expression.ids, conditional_binder{stmt});
+                bind_changed_parameters(statement, statement.expression.ids);
 
                 std::optional<T> res;
-                perform_step(stmt, [&table = this->get_table<T>(), &res](sqlite3_stmt* stmt) {
-                    object_from_column_builder<T> builder{res.emplace(), stmt};
-                    table.for_each_column(builder);
-                });
+                auto lazySource = this->lazy_source_of<T>();
+                tracer.phase(execute_phase::step);
+                perform_step(stmt,
+                             tracer.extracting([&table = this->get_table<T>(), &res, &lazySource](sqlite3_stmt* stmt) {
+                                 object_from_column_builder<T> builder{res.emplace(), stmt, lazySource};
+                                 build_object_columns(builder, table);
+                             }));
+                if(!res) {
+                    this->key_filter_missed<T>();
+                }
                 return res;
             }
 #endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
 
             template<class T, class... Ids>
             T execute(const prepared_statement_t<get_t<T, Ids...>>& statement) {
+                if(this->excluded_by_key_filter<T>(statement.expression.ids)) {
+                    throw std::system_error{orm_error_code::not_found};
+                }
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                iterate_ast(statement.expression.ids, conditional_binder{stmt});
+                bind_changed_parameters(statement, statement.expression.ids);
 
 #ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
                 std::optional<T> res;
-                perform_step(stmt, [&table = this->get_table<T>(), &res](sqlite3_stmt* stmt) {
-                    object_from_column_builder<T> builder{res.emplace(), stmt};
-                    table.for_each_column(builder);
-                });
+                auto lazySource = this->lazy_source_of<T>();
+                tracer.phase(execute_phase::step);
+                perform_step(stmt,
+                             tracer.extracting([&table = this->get_table<T>(), &res, &lazySource](sqlite3_stmt* stmt) {
+                                 object_from_column_builder<T> builder{res.emplace(), stmt, lazySource};
+                                 build_object_columns(builder, table);
+                             }));
                 if(!res.has_value()) {
+                    this->key_filter_missed<T>();
                     throw std::system_error{orm_error_code::not_found};
                 }
                 return move(res).value();
 #else
                 auto& table = this->get_table<T>();
-                auto stepRes = sqlite3_step(stmt);
+                tracer.phase(execute_phase::step);
+                auto stepRes = step_stmt(stmt);
                 switch(stepRes) {
                     case SQLITE_ROW: {
+                        tracer.phase(execute_phase::extract);
                         T res;
-                        object_from_column_builder<T> builder{res, stmt};
-                        table.for_each_column(builder);
+                        object_from_column_builder<T> builder{res, stmt, this->lazy_source_of<T>()};
+                        build_object_columns(builder, table);
                         return res;
                     } break;
                     case SQLITE_DONE: {
+                        this->key_filter_missed<T>();
                         throw std::system_error{orm_error_code::not_found};
                     } break;
                     default: {
@@ -1340,65 +5105,325 @@ namespace sqlite_orm {
             template<class T, class... Args>
             void execute(const prepared_statement_t<remove_all_t<T, Args...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
-                iterate_ast(statement.expression.conditions, conditional_binder{stmt});
+                auto tracer = this->make_execute_tracer(stmt);
+                bind_changed_parameters(statement, statement.expression.conditions);
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
             }
 
             template<class... Args, class... Wargs>
             void execute(const prepared_statement_t<update_all_t<set_t<Args...>, Wargs...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
                 conditional_binder bind_node{stmt};
                 iterate_tuple(statement.expression.set.assigns, [&bind_node](auto& setArg) {
                     iterate_ast(setArg, bind_node);
                 });
                 iterate_ast(statement.expression.conditions, bind_node);
+                tracer.phase(execute_phase::step);
                 perform_step(stmt);
             }
 
+            /**
+             *  Executes the prepared `update_all`, `remove_all` or raw `insert`/`replace` statement once for every
+             *  parameter set of `parameterSets`, in one transaction unless one is open already. A parameter set is
+             *  a tuple-like object whose element i is bound to the parameter `get<i>()` refers to. Throws
+             *  `orm_error_code::arguments_count_does_not_match` if the statement has another number of parameters.
+             *  The statement is executed right away, without going through the arguments of its expression:
+             *  bindings of the parameter sets replace them, so the next `execute()` binds them again.
+             *  @example: auto rename = storage.prepare(update_all(set(c(&User::name) = ""), where(c(&User::id) == 0)));
+             *            std::vector<std::tuple<std::string, int>> renames{{"Alice", 1}, {"Bob", 2}};
+             *            storage.execute_batch(rename, renames);
+             */
+            template<class S, class R>
+            void execute_batch(const prepared_statement_t<S>& statement, const R& parameterSets) {
+                static_assert(is_batch_statement_v<S>,
+                              "execute_batch() runs update_all, remove_all and raw insert or replace statements");
+                using parameter_set_type = std::decay_t<decltype(*std::begin(parameterSets))>;
+                sqlite3_stmt* stmt = statement.stmt;
+                if(int(std::tuple_size<parameter_set_type>::value) != sqlite3_bind_parameter_count(stmt)) {
+                    throw std::system_error{orm_error_code::arguments_count_does_not_match};
+                }
+                statement.boundParameters.clear();
+                auto executeAll = [this, stmt, &parameterSets] {
+                    auto tracer = this->make_execute_tracer(stmt);
+                    for(auto& parameters: parameterSets) {
+                        reset_stmt(stmt);
+                        tracer.phase(execute_phase::bind);
+                        conditional_binder binder{stmt};
+                        iterate_tuple(parameters, [&binder](auto& value) {
+                            static_assert(is_bindable_v<std::decay_t<decltype(value)>>,
+                                          "Parameter set values must be bindable");
+                            binder(value);
+                        });
+                        tracer.phase(execute_phase::step);
+                        perform_step(stmt);
+                    }
+                };
+                if(sqlite3_get_autocommit(statement.con.get())) {
+                    auto guard = this->transaction_guard();
+                    executeAll();
+                    guard.commit();
+                } else {
+                    executeAll();
+                }
+            }
+
+            /**
+             *  Makes a pipeline executing the prepared `statements` back to back with one retain of the connection,
+             *  e.g. the statements of a write path which inserts a row, its children and updates a counter.
+             *  @example: auto pipeline = storage.pipeline(insertOrder, insertItem, updateCount);
+             *            auto results = pipeline.transaction().execute();
+             *            auto orderId = std::get<0>(results);
+             */
+            template<class... Ss>
+            pipeline_t<self, Ss...> pipeline(const prepared_statement_t<Ss>&... statements) {
+                return {*this, this->get_connection(), statements...};
+            }
+
+            /**
+             *  Same as `execute(statement)` but returns the error a failed step ends with, e.g. a constraint
+             *  violation or `SQLITE_BUSY`, instead of throwing it. Supports the statements executed by a single step:
+             *  insert, replace, update, remove, get and get_pointer statements, `update_all`, `remove_all` and raw
+             *  insert or replace. Errors of binding still throw.
+             *  @example: auto statement = storage.prepare(insert(user));
+             *            if(auto id = storage.try_execute(statement)) {
+             *                ...
+             *            } else if(id.error() == std::error_code{sqlite_errc(SQLITE_CONSTRAINT)}) {
+             *                ...
+             *            }
+             */
+            template<class S>
+            auto try_execute(const prepared_statement_t<S>& statement) -> result<decltype(this->execute(statement))> {
+                static_assert(is_single_step_statement_v<S>, "try_execute() runs statements executed by a single step");
+                using value_type = decltype(this->execute(statement));
+                step_error_scope scope{statement.stmt};
+                return static_if<std::is_void<value_type>::value>(
+                    [this, &scope](auto& statement) -> result<value_type> {
+                        this->execute(statement);
+                        return scope.error();
+                    },
+                    [this, &scope](auto& statement) -> result<value_type> {
+                        auto res = this->execute(statement);
+                        if(auto error = scope.error()) {
+                            return error;
+                        }
+                        return result<value_type>{std::move(res)};
+                    })(statement);
+            }
+
+            /**
+             *  Same as `execute(statement)` but returns `orm_error_code::not_found` or the error of a failed step
+             *  instead of throwing it.
+             */
+            template<class T, class... Ids>
+            result<T> try_execute(const prepared_statement_t<get_t<T, Ids...>>& statement) {
+                if(this->excluded_by_key_filter<T>(statement.expression.ids)) {
+                    return std::error_code{orm_error_code::not_found};
+                }
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+
+                bind_changed_parameters(statement, statement.expression.ids);
+
+                tracer.phase(execute_phase::step);
+                switch(step_stmt(stmt)) {
+                    case SQLITE_ROW: {
+                        tracer.phase(execute_phase::extract);
+                        T res;
+                        object_from_column_builder<T> builder{res, stmt, this->lazy_source_of<T>()};
+                        build_object_columns(builder, this->get_table<T>());
+                        return result<T>{std::move(res)};
+                    }
+                    case SQLITE_DONE:
+                        this->key_filter_missed<T>();
+                        return std::error_code{orm_error_code::not_found};
+                    default:
+                        return std::error_code{sqlite_errc(sqlite3_errcode(sqlite3_db_handle(stmt)))};
+                }
+            }
+
+            /**
+             *  Same as `get<O>(ids...)` but returns `orm_error_code::not_found` or the error of a failed step
+             *  instead of throwing it, for lookups which often miss.
+             */
+            template<class O, class... Ids>
+            result<O> try_get(Ids... ids) {
+                this->assert_mapped_type<O>();
+                if(auto cache = this->find_object_cache<O>()) {
+                    auto key = make_object_cache_key(ids...);
+                    if(auto found = cache->find(key)) {
+                        return copy_cached_object(*std::static_pointer_cast<const O>(std::move(found)),
+                                                  std::is_copy_constructible<O>{});
+                    }
+                    const auto generation = cache->generation();
+                    auto statement = this->prepare_cached(sqlite_orm::get_pointer<O>(std::forward<Ids>(ids)...));
+                    auto res = this->try_execute(statement);
+                    if(!res) {
+                        return res.error();
+                    }
+                    if(!*res) {
+                        return std::error_code{orm_error_code::not_found};
+                    }
+                    std::shared_ptr<const O> object = std::move(*res);
+                    cache->insert(std::move(key), object, generation);
+                    return copy_cached_object(*object, std::is_copy_constructible<O>{});
+                }
+                auto statement = this->prepare_cached(sqlite_orm::get<O>(std::forward<Ids>(ids)...));
+                return this->try_execute(statement);
+            }
+
+            /**
+             *  Same as `insert(o)` but returns the error of a failed step, e.g. a constraint violation, instead of
+             *  throwing it.
+             */
+            template<class O>
+            result<int64> try_insert(const O& o) {
+                this->assert_mapped_type<O>();
+                this->assert_insertable_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::insert(std::ref(o)));
+                return this->try_execute(statement);
+            }
+
+            /**
+             *  Same as `replace(o)` but returns the error of a failed step instead of throwing it.
+             */
+            template<class O>
+            result<void> try_replace(const O& o) {
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::replace(std::ref(o)));
+                auto res = this->try_execute(statement);
+                this->invalidate_cached_object(o);
+                return res;
+            }
+
+            /**
+             *  Same as `update(o)` but returns the error of a failed step instead of throwing it.
+             */
+            template<class O>
+            result<void> try_update(const O& o) {
+                this->assert_mapped_type<O>();
+                auto statement = this->prepare_cached(sqlite_orm::update(std::ref(o)));
+                auto res = this->try_execute(statement);
+                this->invalidate_cached_object(o);
+                return res;
+            }
+
+            /**
+             *  Same as `remove<O>(ids...)` but returns the error of a failed step instead of throwing it.
+             */
+            template<class O, class... Ids>
+            result<void> try_remove(Ids... ids) {
+                this->assert_mapped_type<O>();
+                auto cache = this->find_object_cache<O>();
+                auto key = cache ? make_object_cache_key(ids...) : std::string{};
+                auto statement = this->prepare_cached(sqlite_orm::remove<O>(std::forward<Ids>(ids)...));
+                auto res = this->try_execute(statement);
+                if(cache) {
+                    cache->invalidate(key);
+                }
+                return res;
+            }
+
             template<class T, class... Args, class R = column_result_of_t<db_objects_type, T>>
             std::vector<R> execute(const prepared_statement_t<select_t<T, Args...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                iterate_ast(statement.expression, conditional_binder{stmt});
+                bind_changed_parameters(statement, statement.expression);
+                exec_options_scope execOptions{stmt, find_exec_options(statement.expression.conditions)};
 
                 std::vector<R> res;
-                perform_steps(stmt,
-                              [rowExtractor = make_row_extractor<R>(lookup_table<R>(this->db_objects)),
-                               &res](sqlite3_stmt* stmt) {
-                                  res.push_back(rowExtractor.extract(stmt, 0));
-                              });
+                auto rowExtractor = make_select_row_extractor<R, T>(this->db_objects);
+                tracer.phase(execute_phase::step);
+                perform_steps(stmt, tracer.extracting([&rowExtractor, &res](sqlite3_stmt* stmt) {
+                    append_row(res, rowExtractor, stmt);
+                }));
                 return res;
             }
 
-            template<class T, class R, class... Args>
-            R execute(const prepared_statement_t<get_all_t<T, R, Args...>>& statement) {
+            template<class CTEs, class T, class... Args, class R = column_result_of_t<db_objects_type, T>>
+            std::vector<R> execute(const prepared_statement_t<with_t<CTEs, select_t<T, Args...>>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
+
+                bind_changed_parameters(statement, statement.expression);
+                exec_options_scope execOptions{stmt, find_exec_options(statement.expression.expression.conditions)};
 
-                iterate_ast(statement.expression, conditional_binder{stmt});
+                std::vector<R> res;
+                auto rowExtractor = make_select_row_extractor<R, T>(this->db_objects);
+                tracer.phase(execute_phase::step);
+                perform_steps(stmt, tracer.extracting([&rowExtractor, &res](sqlite3_stmt* stmt) {
+                    append_row(res, rowExtractor, stmt);
+                }));
+                return res;
+            }
 
+            template<class T, class R, class... Args>
+            R execute(const prepared_statement_t<get_all_t<T, R, Args...>>& statement) {
                 R res;
-                perform_steps(stmt, [&table = this->get_table<T>(), &res](sqlite3_stmt* stmt) {
-                    T obj;
-                    object_from_column_builder<T> builder{obj, stmt};
-                    table.for_each_column(builder);
-                    res.push_back(std::move(obj));
-                });
+                this->execute_into(statement, res);
+                return res;
+            }
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+            /**
+             *  Executes a prepared `get_all<T, std::pmr::vector<T>>` allocating the result and the
+             *  `std::pmr::string` and `std::pmr::vector<char>` fields of the objects from `arena`.
+             */
+            template<class T, class... Args>
+            std::pmr::vector<T>
+            execute(const prepared_statement_t<get_all_t<T, std::pmr::vector<T>, Args...>>& statement,
+                    std::pmr::memory_resource* arena) {
+                memory_resource_scope scope{arena};
+                std::pmr::vector<T> res{arena};
+                this->execute_into(statement, res);
                 return res;
             }
+#endif
+
+            /**
+             *  Executes a prepared `get_all<T, R>` appending the objects to `res`, e.g. a container reused for
+             *  every execution which keeps its capacity.
+             */
+            template<class T, class R, class... Args>
+            void execute_into(const prepared_statement_t<get_all_t<T, R, Args...>>& statement, R& res) {
+                sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
+                bind_changed_parameters(statement, statement.expression);
+
+                auto& conditions = statement.expression.conditions;
+                exec_options_scope execOptions{stmt, find_exec_options(conditions)};
+                reserve_result(res, conditions);
+                auto lazySource = this->lazy_source_of<T>();
+                tracer.phase(execute_phase::step);
+                perform_steps(stmt,
+                              tracer.extracting([&table = this->get_table<T>(), &conditions, &res, &lazySource](
+                                                    sqlite3_stmt* stmt) {
+                                  append_object<T>(res, stmt, table, conditions, lazySource);
+                              }));
+            }
             template<class T, class R, class... Args>
             R execute(const prepared_statement_t<get_all_pointer_t<T, R, Args...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                iterate_ast(statement.expression, conditional_binder{stmt});
+                bind_changed_parameters(statement, statement.expression);
 
                 R res;
-                perform_steps(stmt, [&table = this->get_table<T>(), &res](sqlite3_stmt* stmt) {
-                    auto obj = std::make_unique<T>();
-                    object_from_column_builder<T> builder{*obj, stmt};
-                    table.for_each_column(builder);
-                    res.push_back(move(obj));
-                });
+                auto& conditions = statement.expression.conditions;
+                exec_options_scope execOptions{stmt, find_exec_options(conditions)};
+                reserve_result(res, conditions);
+                auto lazySource = this->lazy_source_of<T>();
+                tracer.phase(execute_phase::step);
+                perform_steps(stmt,
+                              tracer.extracting([&table = this->get_table<T>(), &conditions, &res, &lazySource](
+                                                    sqlite3_stmt* stmt) {
+                                  auto obj = std::make_unique<T>();
+                                  build_object(*obj, stmt, table, conditions, lazySource);
+                                  res.push_back(move(obj));
+                              }));
                 return res;
             }
 
@@ -1406,16 +5431,23 @@ namespace sqlite_orm {
             template<class T, class R, class... Args>
             R execute(const prepared_statement_t<get_all_optional_t<T, R, Args...>>& statement) {
                 sqlite3_stmt* stmt = reset_stmt(statement.stmt);
+                auto tracer = this->make_execute_tracer(stmt);
 
-                iterate_ast(statement.expression, conditional_binder{stmt});
+                bind_changed_parameters(statement, statement.expression);
 
                 R res;
-                perform_steps(stmt, [&table = this->get_table<T>(), &res](sqlite3_stmt* stmt) {
-                    auto obj = std::make_optional<T>();
-                    object_from_column_builder<T> builder{*obj, stmt};
-                    table.for_each_column(builder);
-                    res.push_back(move(obj));
-                });
+                auto& conditions = statement.expression.conditions;
+                exec_options_scope execOptions{stmt, find_exec_options(conditions)};
+                reserve_result(res, conditions);
+                auto lazySource = this->lazy_source_of<T>();
+                tracer.phase(execute_phase::step);
+                perform_steps(stmt,
+                              tracer.extracting([&table = this->get_table<T>(), &conditions, &res, &lazySource](
+                                                    sqlite3_stmt* stmt) {
+                                  auto obj = std::make_optional<T>();
+                                  build_object(*obj, stmt, table, conditions, lazySource);
+                                  res.push_back(move(obj));
+                              }));
                 return res;
             }
 #endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
@@ -1430,6 +5462,65 @@ namespace sqlite_orm {
         return {move(filename), internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...}};
     }
 
+    /*
+     *  Factory function for a storage with a pool of connections to a database file.
+     *  Every thread gets its own connection from the pool, which lets reads scale across threads
+     *  (best combined with `journal_mode::WAL`).
+     *  `on_open`, user defined functions and collations are applied to every pooled connection.
+     */
+    template<class... DBO>
+    internal::storage_t<DBO...> make_storage(const pool_options& poolOptions, std::string filename, DBO... dbObjects) {
+        return {poolOptions, move(filename), internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...}};
+    }
+
+    /**
+     *  Factory function for a storage whose connections are opened with `openOptions`,
+     *  e.g. read-only, without mutexes or with a custom VFS.
+     */
+    template<class... DBO>
+    internal::storage_t<DBO...>
+    make_storage(const open_options& openOptions, std::string filename, DBO... dbObjects) {
+        return {openOptions, move(filename), internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...}};
+    }
+
+    /*
+     *  Factory function for a storage with a pool of connections that are opened with `openOptions`.
+     */
+    template<class... DBO>
+    internal::storage_t<DBO...> make_storage(const pool_options& poolOptions,
+                                             const open_options& openOptions,
+                                             std::string filename,
+                                             DBO... dbObjects) {
+        return {poolOptions,
+                openOptions,
+                move(filename),
+                internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...}};
+    }
+
+    /**
+     *  Factory function for a storage whose connections are set up with a performance profile,
+     *  e.g. `make_storage(performance_profile::read_heavy(), "db.sqlite", make_table(...))`.
+     */
+    template<class... DBO>
+    internal::storage_t<DBO...>
+    make_storage(const performance_profile& profile, std::string filename, DBO... dbObjects) {
+        return {profile, move(filename), internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...}};
+    }
+
+    /*
+     *  Factory function for a storage with a pool of connections that are set up with a performance profile.
+     */
+    template<class... DBO>
+    internal::storage_t<DBO...> make_storage(const pool_options& poolOptions,
+                                             const performance_profile& profile,
+                                             std::string filename,
+                                             DBO... dbObjects) {
+        return {poolOptions,
+                profile,
+                move(filename),
+                internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...}};
+    }
+
     /**
      *  sqlite3_threadsafe() interface.
      */
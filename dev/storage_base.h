@@ -7,23 +7,63 @@
 #include <utility>  //  std::move
 #include <system_error>  //  std::system_error
 #include <vector>  //  std::vector
-#include <memory>  //  std::make_unique, std::unique_ptr
+#include <memory>  //  std::make_unique, std::unique_ptr, std::make_shared, std::shared_ptr
 #include <map>  //  std::map
+#include <unordered_map>  //  std::unordered_map
+#include <cstring>  //  strncmp, std::strcmp
 #include <type_traits>  //  std::decay, std::is_same
-#include <algorithm>  //  std::find_if
+#include <algorithm>  //  std::find_if, std::min
+#include <chrono>  //  std::chrono::steady_clock, std::chrono::milliseconds
+#include <random>  //  std::minstd_rand, std::random_device, std::uniform_int_distribution
+#include <thread>  //  std::this_thread::sleep_for
+#include <mutex>  //  std::mutex, std::unique_lock
+#include <future>  //  std::future
+#include <atomic>  //  std::atomic
 
 #include "functional/cxx_universal.h"
+#include "functional/cxx_string_view.h"
+#include "functional/cxx_type_traits_polyfill.h"
 #include "functional/static_magic.h"
 #include "tuple_helper/tuple_iteration.h"
 #include "pragma.h"
+#include "performance_profile.h"
+#include "optimize_options.h"
 #include "limit_accessor.h"
 #include "transaction_guard.h"
 #include "row_extractor.h"
 #include "connection_holder.h"
+#include "session.h"
+#include "statement_cache.h"
+#include "storage_executor.h"
+#include "wal_checkpoint.h"
 #include "backup.h"
+#include "statement_profile.h"
+#include "slow_query_log.h"
+#include "workload_replay.h"
+#include "index_advisor.h"
+#include "change_hooks.h"
+#include "object_cache.h"
+#include "key_filter.h"
+#include "schema_snapshot.h"
+#include "read_snapshot.h"
+#include "change_stream.h"
+#include "audit_log.h"
+#include "query_cache.h"
+#include "data_version.h"
+#include "storage_status.h"
+#include "busy_statistics.h"
+#include "space_report.h"
+#include "memory_config.h"
+#include "execute_tracer.h"
 #include "function.h"
+#include "math_functions.h"
+#include "vector_functions.h"
+#include "changeset.h"
+#include "vfs.h"
 #include "values_to_tuple.h"
 #include "arg_values.h"
+#include "virtual_table.h"
+#include "statement_finalizer.h"
 #include "util.h"
 #include "serializing_util.h"
 
@@ -34,33 +74,235 @@ namespace sqlite_orm {
         struct storage_base {
             using collating_function = std::function<int(int, const void*, int, const void*)>;
 
+            /**
+             *  A collation as registered with every connection: the comparison function and the object it is
+             *  called with, shared by all connections.
+             */
+            struct collation_entry {
+                std::shared_ptr<void> object;
+                int (*callback)(void*, int, const void*, int, const void*) = nullptr;
+            };
+#ifdef SQLITE_ENABLE_RTREE
+            using rtree_query_function = std::function<int(sqlite3_rtree_query_info*)>;
+#endif  //  SQLITE_ENABLE_RTREE
+
             std::function<void(sqlite3*)> on_open;
+#ifdef SQLITE_ORM_ENABLE_EXECUTE_TRACING
+            /**
+             *  Called with the time every phase of preparing and executing a statement took.
+             *  Exists only if `SQLITE_ORM_ENABLE_EXECUTE_TRACING` is defined, otherwise tracing costs nothing.
+             */
+            execute_event_sink on_execute_event;
+#endif
             pragma_t pragma;
             limit_accessor limit;
 
+            /**
+             *  Makes the storage run `PRAGMA optimize` after `sync_schema()` and before closing connections.
+             *  Off by default.
+             */
+            optimize_options auto_optimize;
+
+            /**
+             *  Makes `sync_schema()` make all its changes in one IMMEDIATE transaction, so that they are committed
+             *  at once, or none of them if it fails. On by default.
+             */
+            bool sync_schema_in_transaction = true;
+
+            /**
+             *  Begins a transaction and returns a guard for it. If the connection of the calling thread
+             *  is already inside a transaction a savepoint guard is returned instead (see `savepoint_guard`),
+             *  so guards and `transaction()` calls can be nested.
+             */
             transaction_guard_t transaction_guard() {
+                if(this->in_transaction()) {
+                    return this->savepoint_guard("sqlite_orm_transaction");
+                }
                 this->begin_transaction();
                 return {this->get_connection(),
                         std::bind(&storage_base::commit, this),
                         std::bind(&storage_base::rollback, this)};
             }
 
+            /**
+             *  Same as `transaction_guard()` but begins the transaction with `BEGIN IMMEDIATE` so that
+             *  the write lock is taken right away and `SQLITE_BUSY` can only happen here and not in the middle
+             *  of the transaction.
+             */
+            transaction_guard_t immediate_transaction_guard() {
+                if(this->in_transaction()) {
+                    return this->savepoint_guard("sqlite_orm_transaction");
+                }
+                this->begin_immediate_transaction();
+                return {this->get_connection(),
+                        std::bind(&storage_base::commit, this),
+                        std::bind(&storage_base::rollback, this)};
+            }
+
+            /**
+             *  Begins a read transaction, `BEGIN DEFERRED`, on the connection the calling thread reads with and
+             *  returns a guard for it. Until the guard ends the reads of the thread see one snapshot of the
+             *  database, and the read lock (the read mark in WAL mode) is taken once instead of by every statement.
+             *  The destructor commits too, a read transaction has nothing to roll back. Don't write in it: a pool
+             *  with a single writer runs the writes of the thread outside of the read transaction.
+             *  Inside a transaction of the calling thread the guard does nothing, its reads are consistent already.
+             *  @example: auto guard = storage.read_transaction();
+             *            auto users = storage.get_all<User>();
+             *            auto orders = storage.count<Order>();  //  same state as the users
+             */
+            transaction_guard_t read_transaction() {
+                if(this->in_transaction()) {
+                    return {this->get_read_connection(), [] {}, [] {}};
+                }
+                auto con = this->get_read_connection();
+                sqlite3* db = con.get();
+                perform_void_exec(db, "BEGIN DEFERRED TRANSACTION");
+                if(this->busyStatistics.enabled()) {
+                    this->busyStatistics.began(db, busy_transaction_kind::deferred);
+                }
+                this->check_data_version(db);
+                auto end = [this, db] {
+                    perform_void_exec(db, "COMMIT");
+                    this->transaction_ended(db);
+                };
+                transaction_guard_t guard{std::move(con), end, end};
+                guard.commit_on_destroy = true;
+                return guard;
+            }
+
+            /**
+             *  Opens a savepoint and returns a guard for it. `commit()` of the guard releases the savepoint,
+             *  `rollback()` and the destructor roll back to it and release it, which undoes only the changes made
+             *  since the savepoint. A savepoint opened outside of a transaction starts one.
+             */
+            transaction_guard_t savepoint_guard(const std::string& name) {
+                this->savepoint(name);
+                return {this->get_connection(),
+                        [this, name] {
+                            this->release_savepoint(name);
+                        },
+                        [this, name] {
+                            this->rollback_to_savepoint(name);
+                            this->release_savepoint(name);
+                        }};
+            }
+
             void drop_index(const std::string& indexName) {
                 std::stringstream ss;
                 ss << "DROP INDEX " << quote_identifier(indexName) << std::flush;
                 perform_void_exec(this->get_connection().get(), ss.str());
+                this->schemaCache.invalidate();
             }
 
             void drop_trigger(const std::string& triggerName) {
                 std::stringstream ss;
                 ss << "DROP TRIGGER " << quote_identifier(triggerName) << std::flush;
                 perform_void_exec(this->get_connection().get(), ss.str());
+                this->schemaCache.invalidate();
             }
 
             void vacuum() {
                 perform_void_exec(this->get_connection().get(), "VACUUM");
             }
 
+            /**
+             *  Rebuilds the database with pages of `pageSize` bytes, a power of two from 512 to 65536, by setting
+             *  `pragma.page_size()` and running VACUUM. A database in WAL mode, whose page size can't change, is
+             *  switched to DELETE for the VACUUM and back to WAL. Like `vacuum()` it needs exclusive access to the
+             *  database and temporary space for a copy of it. For an online migration set `pragma.page_size()`
+             *  and use `vacuum_into()`, which writes the copy with the new page size while the database stays
+             *  usable, then switch the application to the copy.
+             */
+            void migrate_page_size(int pageSize) {
+                auto con = this->get_connection();
+                auto db = con.get();
+                this->pragma.page_size(pageSize);
+                if(this->pragma.page_size() == pageSize) {
+                    return;
+                }
+                const bool wal = this->pragma.journal_mode() == journal_mode::WAL;
+                if(wal) {
+                    perform_void_exec(db, "PRAGMA journal_mode = DELETE");
+                }
+                perform_void_exec(db, "VACUUM");
+                if(wal) {
+                    perform_void_exec(db, "PRAGMA journal_mode = WAL");
+                }
+            }
+
+#if SQLITE_VERSION_NUMBER >= 3027000
+            /**
+             *  Runs `VACUUM INTO`, which writes a compacted copy of the database to the new file `filename`
+             *  while the database stays usable: it is read in one read transaction like a backup is.
+             *  Requires SQLite 3.27.0.
+             */
+            void vacuum_into(const std::string& filename) {
+                std::stringstream ss;
+                ss << "VACUUM INTO " << quote_string_literal(filename) << std::flush;
+                perform_void_exec(this->get_connection().get(), ss.str());
+            }
+#endif
+
+            /**
+             *  Runs `PRAGMA incremental_vacuum(pages)`, which moves up to `pages` free pages to the end of
+             *  the database file and truncates it. 0 frees all of them.
+             *  It does something only if `pragma.auto_vacuum()` is 2 (INCREMENTAL). For an existing database
+             *  setting this needs a `vacuum()` to take effect.
+             */
+            void incremental_vacuum(int pages = 0) {
+                std::stringstream ss;
+                ss << "PRAGMA incremental_vacuum(" << pages << ")" << std::flush;
+                perform_void_exec(this->get_connection().get(), ss.str());
+            }
+
+            /**
+             *  Attaches the database file `filename` as the schema `schemaName` to every connection of the storage,
+             *  the open ones and the ones opened later. Tables mapped with `make_table(...).in_schema(schemaName)`
+             *  are in it, `sync_schema()` creates them there and a query can join them with the tables of the
+             *  main database. Attach before `sync_schema()` and before the storage is used by several threads.
+             */
+            void attach_database(const std::string& filename, const std::string& schemaName) {
+                this->for_each_opened_connection([this, &filename, &schemaName](sqlite3* db) {
+                    this->attach_database(db, filename, schemaName);
+                });
+                this->attachedDatabases.emplace_back(schemaName, filename);
+            }
+
+            /**
+             *  Detaches the schema `schemaName` attached by `attach_database()` from every connection.
+             */
+            void detach_database(const std::string& schemaName) {
+                auto it = std::find_if(this->attachedDatabases.begin(),
+                                       this->attachedDatabases.end(),
+                                       [&schemaName](const std::pair<std::string, std::string>& attached) {
+                                           return attached.first == schemaName;
+                                       });
+                if(it == this->attachedDatabases.end()) {
+                    return;
+                }
+                this->attachedDatabases.erase(it);
+                this->for_each_opened_connection([&schemaName](sqlite3* db) {
+                    perform_void_exec(db, "DETACH DATABASE " + quote_identifier(schemaName));
+                });
+            }
+
+            /**
+             *  Runs `ANALYZE` for all attached databases, which refreshes the statistics in `sqlite_stat1`
+             *  the query planner chooses indexes by.
+             */
+            void analyze() {
+                perform_void_exec(this->get_connection().get(), "ANALYZE");
+            }
+
+            /**
+             *  Runs `ANALYZE` for one table or index.
+             */
+            void analyze(const std::string& name) {
+                std::stringstream ss;
+                ss << "ANALYZE " << streaming_identifier(name) << std::flush;
+                perform_void_exec(this->get_connection().get(), ss.str());
+            }
+
             /**
              *  Drops table with given name.
              */
@@ -76,42 +318,160 @@ namespace sqlite_orm {
             }
 
           protected:
-            void rename_table(sqlite3* db, const std::string& oldName, const std::string& newName) const {
+            void rename_table(sqlite3* db,
+                              const std::string& oldName,
+                              const std::string& newName,
+                              const std::string& schemaName = {}) {
                 std::stringstream ss;
-                ss << "ALTER TABLE " << streaming_identifier(oldName) << " RENAME TO " << streaming_identifier(newName)
-                   << std::flush;
+                ss << "ALTER TABLE " << streaming_identifier(schemaName, oldName, std::string{}) << " RENAME TO "
+                   << streaming_identifier(newName) << std::flush;
                 perform_void_exec(db, ss.str());
+                this->schemaCache.invalidate();
             }
 
             /**
              *  Checks whether table exists in db. Doesn't check storage itself - works only with actual database.
              *  Note: table can be not mapped to a storage
+             *  The schema is read once and kept until it changes, see `table_names()`.
              *  @return true if table with a given name exists in db, false otherwise.
              */
             bool table_exists(const std::string& tableName) {
                 auto con = this->get_connection();
+                auto snapshot = this->cached_schema_snapshot(con.get());
+                if(snapshot->loaded) {
+                    return snapshot->tables.count(tableName) > 0;
+                }
                 return this->table_exists(con.get(), tableName);
             }
 
-            bool table_exists(sqlite3* db, const std::string& tableName) const {
+            bool table_exists(sqlite3* db, const std::string& tableName, const std::string& schemaName = {}) const {
                 bool result = false;
                 std::stringstream ss;
-                ss << "SELECT COUNT(*) FROM sqlite_master WHERE type = " << streaming_identifier("table")
+                ss << "SELECT COUNT(*) FROM " << streaming_identifier(schemaName, "sqlite_master", std::string{})
+                   << " WHERE type = " << streaming_identifier("table")
                    << " AND name = " << quote_string_literal(tableName) << std::flush;
-                perform_exec(
-                    db,
-                    ss.str(),
-                    [](void* data, int argc, char** argv, char** /*azColName*/) -> int {
-                        auto& res = *(bool*)data;
-                        if(argc) {
-                            res = !!std::atoi(argv[0]);
-                        }
-                        return 0;
-                    },
-                    &result);
+                this->pragma.for_each_row(db, ss.str(), [&result](sqlite3_stmt* stmt) {
+                    result = sqlite3_column_int(stmt, 0) != 0;
+                });
                 return result;
             }
 
+            /**
+             *  @return `sql` of the schema object `name` of `type` ('table', 'index', ...) in `sqlite_master` or
+             *  an empty string if there is no such object.
+             */
+            std::string schema_sql(sqlite3* db,
+                                   const char* type,
+                                   const std::string& name,
+                                   const std::string& schemaName = {}) const {
+                std::string result;
+                std::stringstream ss;
+                ss << "SELECT sql FROM " << streaming_identifier(schemaName, "sqlite_master", std::string{})
+                   << " WHERE type = " << quote_string_literal(type)
+                   << " AND name = " << quote_string_literal(name) << std::flush;
+                this->pragma.for_each_row(db, ss.str(), [&result](sqlite3_stmt* stmt) {
+                    result = schema_text(stmt, 0);
+                });
+                return result;
+            }
+
+            /**
+             *  Reads the tables and indexes of `db` for `sync_schema()`. `loaded` of the result is false if the
+             *  tables couldn't be read at once, e.g. because of a virtual table whose module isn't registered.
+             */
+            schema_snapshot read_schema_snapshot(sqlite3* db) const {
+                schema_snapshot snapshot;
+#if SQLITE_VERSION_NUMBER >= 3026000  //  table_xinfo exists (v3.26.0)
+                try {
+                    this->pragma.for_each_row(
+                        db,
+                        "SELECT m.name, m.sql, p.cid, p.name, p.type, p.\"notnull\", p.dflt_value, p.pk, p.hidden "
+                        "FROM sqlite_master AS m JOIN pragma_table_xinfo(m.name) AS p WHERE m.type = 'table' "
+                        "ORDER BY m.name, p.cid",
+                        [&snapshot](sqlite3_stmt* stmt) {
+                            auto& table = snapshot.tables[schema_text(stmt, 0)];
+                            table.sql = schema_text(stmt, 1);
+                            table.columns.push_back(extract_table_xinfo(stmt, 2));
+                        });
+                    this->pragma.for_each_row(db,
+                                              "SELECT name, sql FROM sqlite_master WHERE type = 'index'",
+                                              [&snapshot](sqlite3_stmt* stmt) {
+                                                  snapshot.indexes[schema_text(stmt, 0)] = schema_text(stmt, 1);
+                                              });
+                    snapshot.loaded = true;
+                } catch(const std::system_error&) {
+                    snapshot.tables.clear();
+                    snapshot.indexes.clear();
+                }
+#else
+                (void)db;
+#endif
+                return snapshot;
+            }
+
+            int schema_version(sqlite3* db) const {
+                int result = 0;
+                this->pragma.for_each_row(db, "PRAGMA schema_version", [&result](sqlite3_stmt* stmt) {
+                    result = sqlite3_column_int(stmt, 0);
+                });
+                return result;
+            }
+
+            /**
+             *  The schema snapshot of `db` from `schemaCache`, read again if `PRAGMA schema_version` changed since.
+             *  A snapshot read inside a transaction isn't kept: the transaction may roll back its own schema
+             *  changes, which brings back the schema version of the snapshot kept before.
+             */
+            std::shared_ptr<const schema_snapshot> cached_schema_snapshot(sqlite3* db) {
+                const int version = this->schema_version(db);
+                if(auto snapshot = this->schemaCache.find(version)) {
+                    return snapshot;
+                }
+                auto snapshot = std::make_shared<const schema_snapshot>(this->read_schema_snapshot(db));
+                if(sqlite3_get_autocommit(db)) {
+                    this->schemaCache.store(version, snapshot);
+                }
+                return snapshot;
+            }
+
+            //  the snapshot has the main database only
+
+            bool table_exists(sqlite3* db,
+                              const std::string& tableName,
+                              const std::string& schemaName,
+                              const schema_snapshot& snapshot) const {
+                if(snapshot.loaded && schemaName.empty()) {
+                    return snapshot.tables.count(tableName) > 0;
+                }
+                return this->table_exists(db, tableName, schemaName);
+            }
+
+            std::vector<sqlite_orm::table_xinfo> db_table_xinfo(const std::string& tableName,
+                                                                const std::string& schemaName,
+                                                                const schema_snapshot& snapshot) const {
+                if(snapshot.loaded && schemaName.empty()) {
+                    auto it = snapshot.tables.find(tableName);
+                    return it != snapshot.tables.end() ? it->second.columns : std::vector<sqlite_orm::table_xinfo>{};
+                }
+                return this->pragma.table_xinfo(tableName, schemaName);
+            }
+
+            std::string schema_sql(sqlite3* db,
+                                   const char* type,
+                                   const std::string& name,
+                                   const std::string& schemaName,
+                                   const schema_snapshot& snapshot) const {
+                if(snapshot.loaded && schemaName.empty()) {
+                    if(std::strcmp(type, "table") == 0) {
+                        auto it = snapshot.tables.find(name);
+                        return it != snapshot.tables.end() ? it->second.sql : std::string{};
+                    }
+                    auto it = snapshot.indexes.find(name);
+                    return it != snapshot.indexes.end() ? it->second : std::string{};
+                }
+                return this->schema_sql(db, type, name, schemaName);
+            }
+
             void add_generated_cols(std::vector<const table_xinfo*>& columnsToAdd,
                                     const std::vector<table_xinfo>& storageTableInfo) {
                 //  iterate through storage columns
@@ -144,9 +504,166 @@ namespace sqlite_orm {
                 return sqlite3_last_insert_rowid(con.get());
             }
 
+            /**
+             *  Sets the busy timeout of the connection the calling thread writes with, `sqlite3_busy_timeout`.
+             *  With `enable_busy_statistics()` the counting busy handler waits as long instead.
+             */
             int busy_timeout(int ms) {
                 auto con = this->get_connection();
-                return sqlite3_busy_timeout(con.get(), ms);
+                //  remembered for the counting busy handler, also if it is enabled again later
+                if(this->busyStatistics.enabled() || this->busyStatistics.find(con.get())) {
+                    this->busyStatistics.set_timeout(this->busy_connection_of(con.get()), ms);
+                }
+                return this->busyStatistics.enabled() ? SQLITE_OK : sqlite3_busy_timeout(con.get(), ms);
+            }
+
+            /**
+             *  Applies every setting of `profile` that is set, to the opened connections and to the
+             *  connections opened later. Settings the profile leaves unset keep their values, so
+             *  profiles can be switched at runtime, e.g. from `bulk_load()` for a load phase to `read_heavy()`.
+             *  `journal_mode` and `synchronous` can't be changed inside a transaction.
+             */
+            void apply_performance_profile(const performance_profile& profile) {
+                bool opened = false;
+                this->for_each_opened_connection([&opened](sqlite3*) {
+                    opened = true;
+                });
+                //  without an opened connection the settings are only remembered, not to open one just for them
+                if(profile.journal_mode) {
+                    if(opened) {
+                        this->pragma.journal_mode(profile.journal_mode.value);
+                    } else {
+                        this->pragma._journal_mode = static_cast<signed char>(profile.journal_mode.value);
+                    }
+                }
+                if(profile.synchronous) {
+                    if(opened) {
+                        this->pragma.synchronous(profile.synchronous.value);
+                    } else {
+                        this->pragma._synchronous = profile.synchronous.value;
+                    }
+                }
+                if(profile.wal_autocheckpoint) {
+                    if(opened) {
+                        this->pragma.wal_autocheckpoint(profile.wal_autocheckpoint.value);
+                    } else {
+                        this->pragma._wal_autocheckpoint = profile.wal_autocheckpoint.value;
+                    }
+                }
+                if(profile.page_size) {
+                    this->pragma.page_size(profile.page_size.value);
+                }
+                if(profile.cache_size) {
+                    this->pragma.cache_size(profile.cache_size.value);
+                }
+                if(profile.mmap_size) {
+                    this->pragma.mmap_size(profile.mmap_size.value);
+                }
+                if(profile.temp_store) {
+                    this->pragma.temp_store(profile.temp_store.value);
+                }
+                if(profile.cache_spill) {
+                    this->pragma.cache_spill(profile.cache_spill.value);
+                }
+                if(profile.journal_size_limit) {
+                    this->pragma.journal_size_limit(profile.journal_size_limit.value);
+                }
+                if(profile.exclusive_locking) {
+                    this->pragma.set_connection_pragma("locking_mode",
+                                                       profile.exclusive_locking.value ? "EXCLUSIVE" : "NORMAL");
+                }
+                if(profile.soft_heap_limit) {
+                    sqlite3_soft_heap_limit64(profile.soft_heap_limit.value);
+                }
+            }
+
+            /**
+             *  Gives every connection `slotsCount` lookaside slots of `slotSize` bytes for small allocations
+             *  (SQLITE_DBCONFIG_LOOKASIDE), 0 disables lookaside. Connections opened later get it before anything
+             *  else is set up. Opened connections get it right away, which throws SQLITE_BUSY if lookaside memory
+             *  is in use, e.g. by cached statements, so call it before the first query.
+             *  `status().connections` shows how lookaside is used.
+             */
+            void lookaside(int slotSize, int slotsCount) {
+                this->lookasideSlotSize = slotSize;
+                this->lookasideSlotsCount = slotsCount;
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_lookaside(db);
+                });
+            }
+
+            /**
+             *  Runs `sqlite3_wal_checkpoint_v2` for `schema`, or for all attached databases if it is empty.
+             *  A checkpoint that could not finish because of other connections returns `busy` set to true,
+             *  other errors are thrown. A database that is not in WAL mode returns -1 frames.
+             */
+            checkpoint_result checkpoint(checkpoint_mode mode = checkpoint_mode::passive,
+                                         const std::string& schema = {}) {
+                auto con = this->get_connection();
+                checkpoint_result result;
+                auto rc = sqlite3_wal_checkpoint_v2(con.get(),
+                                                    schema.empty() ? nullptr : schema.c_str(),
+                                                    static_cast<int>(mode),
+                                                    &result.log_frames,
+                                                    &result.checkpointed_frames);
+                if(rc == SQLITE_BUSY) {
+                    result.busy = true;
+                } else if(rc != SQLITE_OK) {
+                    throw_translated_sqlite_error(con.get());
+                }
+                return result;
+            }
+
+            /**
+             *  Sets a callback called after every commit of a database in WAL mode with the name of the database
+             *  and the number of pages in its WAL (`sqlite3_wal_hook`). The hook replaces automatic checkpoints,
+             *  so unless the checkpoint scheduler runs, the hook checkpoints inline once the WAL reaches
+             *  `pragma.wal_autocheckpoint()` pages like SQLite does. Pass an empty function to remove it.
+             */
+            void on_wal_commit(std::function<void(const std::string&, int)> handler) {
+                this->_wal_commit_handler = move(handler);
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_wal_hook(db);
+                });
+            }
+
+            /**
+             *  Starts a thread that runs checkpoints instead of the thread that commits, so commits
+             *  do not pay for automatic checkpoints. A PASSIVE checkpoint is run once a commit leaves
+             *  `options.wal_pages` pages in the WAL or after `options.idle` without commits. Checkpoints
+             *  that are held back by readers escalate to RESTART and then TRUNCATE. Calling it again
+             *  restarts the scheduler with new options.
+             */
+            void start_checkpoint_scheduler(checkpoint_scheduler_options options = {}) {
+                auto scheduler =
+                    std::make_unique<checkpoint_scheduler>(std::move(options), [this](checkpoint_mode mode) {
+                        return this->checkpoint(mode);
+                    });
+                {
+                    std::lock_guard<std::mutex> lock{this->checkpointSchedulerMutex};
+                    swap(scheduler, this->checkpointScheduler);
+                }
+                //  the old scheduler is joined outside of the lock, it may be running a checkpoint
+                scheduler.reset();
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_wal_hook(db);
+                });
+            }
+
+            /**
+             *  Stops the thread started with `start_checkpoint_scheduler()` and brings back automatic checkpoints
+             *  unless `on_wal_commit()` is set.
+             */
+            void stop_checkpoint_scheduler() {
+                std::unique_ptr<checkpoint_scheduler> scheduler;
+                {
+                    std::lock_guard<std::mutex> lock{this->checkpointSchedulerMutex};
+                    swap(scheduler, this->checkpointScheduler);
+                }
+                scheduler.reset();
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_wal_hook(db);
+                });
             }
 
             /**
@@ -156,11 +673,165 @@ namespace sqlite_orm {
                 return sqlite3_libversion();
             }
 
+            /**
+             *  Runs `f()` on a background thread of the storage and returns a future of its result, so
+             *  the calling thread doesn't block on database I/O. A pooled storage runs as many calls at once
+             *  as it has connections, any other storage runs them one by one in submission order.
+             *  The threads are started by the first call and joined (after running all queued calls)
+             *  when the storage is destroyed.
+             */
+            template<class F>
+            auto async(F f) -> std::future<decltype(f())> {
+                std::unique_lock<std::mutex> lock{this->executorMutex};
+                if(!this->executor) {
+                    this->executor = std::make_unique<storage_executor>(this->pool ? this->pool->size() : 1);
+                }
+                lock.unlock();
+                return this->executor->submit(std::move(f));
+            }
+
+#ifdef SQLITE_ENABLE_SNAPSHOT
+            /**
+             *  Takes a snapshot of the current state of the database, which `with_snapshot()` pins reads on any
+             *  connection to. The connection of the calling thread stays in a read transaction of this state until
+             *  the snapshot is destroyed, so don't begin a transaction on this thread meanwhile.
+             *  The database has to be in WAL mode.
+             *  throws std::system_error if SQLite can't take the snapshot, e.g. in another journal mode.
+             *  @example: auto snapshot = storage.snapshot();
+             *            auto future = std::async(std::launch::async, [&storage, &snapshot] {
+             *                return storage.with_snapshot(snapshot, [&storage] {
+             *                    return storage.count<User>();
+             *                });
+             *            });
+             *            auto users = storage.get_all<User>();  //  same state as the count above
+             */
+            read_snapshot snapshot() {
+                auto con = this->get_read_connection();
+                perform_void_exec(con.get(), "BEGIN");
+                sqlite3_snapshot* snapshot = nullptr;
+                int rc = sqlite3_exec(con.get(), "SELECT 1 FROM sqlite_master LIMIT 1", nullptr, nullptr, nullptr);
+                if(rc == SQLITE_OK) {
+                    rc = sqlite3_snapshot_get(con.get(), "main", &snapshot);
+                }
+                if(rc != SQLITE_OK) {
+                    perform_void_exec(con.get(), "ROLLBACK");
+                    throw_translated_sqlite_error(rc);
+                }
+                return {std::move(con), snapshot};
+            }
+
+            /**
+             *  Runs `f()` in a read transaction of the calling thread's connection which reads the state of
+             *  `snapshot`, so that storage calls inside `f` on this thread see exactly that state.
+             *  @return result of `f()`.
+             */
+            template<class F>
+            auto with_snapshot(const read_snapshot& snapshot, F f) -> decltype(f()) {
+                auto con = this->get_read_connection();
+                snapshot_read_guard guard{con.get(), snapshot.get()};
+                return f();
+            }
+#endif
+
             bool transaction(const std::function<bool()>& f) {
                 auto guard = this->transaction_guard();
                 return guard.commit_on_destroy = f();
             }
 
+            /**
+             *  Runs `f` inside an immediate transaction (see `immediate_transaction_guard()`) and commits if `f` returns
+             *  true. If beginning, running or committing the transaction fails with `SQLITE_BUSY` (or
+             *  `SQLITE_BUSY_SNAPSHOT`) the transaction is rolled back and `f` is run again in a new one after a backoff
+             *  described by `policy`. `f` must not have side effects outside of the database.
+             *  Inside an already open transaction `f` runs once in a savepoint: only the outermost transaction can be
+             *  retried.
+             */
+            bool transaction(const std::function<bool()>& f, const retry_policy& policy) {
+                if(this->in_transaction()) {
+                    return this->transaction(f);
+                }
+                const auto start = std::chrono::steady_clock::now();
+                auto backoff = policy.initial_backoff;
+                std::minstd_rand random{std::random_device{}()};
+                for(int attempt = 1;; ++attempt) {
+                    try {
+                        auto guard = this->immediate_transaction_guard();
+                        if(!f()) {
+                            guard.rollback();
+                            return false;
+                        }
+                        try {
+                            guard.commit();
+                        } catch(const std::system_error&) {
+                            //  a failed COMMIT leaves the transaction open and the connection retained
+                            if(this->in_transaction()) {
+                                this->rollback();
+                            }
+                            throw;
+                        }
+                        return true;
+                    } catch(const std::system_error& e) {
+                        const bool busy = e.code().category() == get_sqlite_error_category() &&
+                                          (e.code().value() & 0xff) == SQLITE_BUSY;
+                        //  never retry inside a transaction that couldn't be ended
+                        if(!busy || attempt >= policy.max_attempts || this->in_transaction()) {
+                            throw;
+                        }
+                        using duration = std::chrono::milliseconds;
+                        const duration sleep{std::uniform_int_distribution<duration::rep>{0, backoff.count()}(random)};
+                        if(policy.deadline.count() && std::chrono::steady_clock::now() + sleep - start > policy.deadline) {
+                            throw;
+                        }
+                        std::this_thread::sleep_for(sleep);
+                        backoff = std::min(backoff * 2, policy.max_backoff);
+                    }
+                }
+            }
+
+            /**
+             *  Runs `f` aborting every statement it executes on this thread once `timeout` has elapsed.
+             *  An aborted statement throws `std::system_error` with `orm_error_code::deadline_exceeded`.
+             *  Nested calls can only shorten the deadline. The check is done by a progress handler
+             *  which this storage installs on all its connections once `with_deadline` is called for the first time,
+             *  so don't set your own progress handler with `sqlite3_progress_handler` if you use it.
+             *  @return the value returned by `f`.
+             */
+            template<class Rep, class Period, class F>
+            decltype(auto) with_deadline(std::chrono::duration<Rep, Period> timeout, F&& f) {
+                if(!this->deadlinesEnabled.exchange(true)) {
+                    this->for_each_opened_connection([](sqlite3* db) {
+                        set_deadline_handler(db);
+                    });
+                }
+                auto deadline = std::chrono::steady_clock::now() +
+                                std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+                auto& currentDeadline = thread_deadline();
+                const auto previousDeadline = currentDeadline;
+                if(deadline < previousDeadline) {
+                    currentDeadline = deadline;
+                }
+                deadline_restorer restorer{previousDeadline};
+                try {
+                    return f();
+                } catch(const std::system_error& e) {
+                    if(e.code() == std::error_code{sqlite_errc(SQLITE_INTERRUPT)} &&
+                       std::chrono::steady_clock::now() >= currentDeadline) {
+                        throw std::system_error{orm_error_code::deadline_exceeded};
+                    }
+                    throw;
+                }
+            }
+
+            /**
+             *  Aborts statements running on any connection of this storage right now by calling `sqlite3_interrupt`.
+             *  Can be called from any thread. Aborted statements throw `std::system_error` with `SQLITE_INTERRUPT`.
+             */
+            void interrupt() {
+                this->for_each_opened_connection([](sqlite3* db) {
+                    sqlite3_interrupt(db);
+                });
+            }
+
             std::string current_timestamp() {
                 auto con = this->get_connection();
                 return this->current_timestamp(con.get());
@@ -177,39 +848,212 @@ namespace sqlite_orm {
                 auto con = this->get_connection();
                 return sqlite3_db_release_memory(con.get());
             }
+
+            /**
+             *  Releases the page cache memory of the opened connections of this storage that no other thread
+             *  is using (`sqlite3_db_release_memory`, which is what `PRAGMA shrink_memory` runs): all idle
+             *  pooled connections, or the single connection. Nothing is opened for it.
+             *  Call it periodically, e.g. for an idle tenant, or let `notify_memory_pressure()` call it.
+             *  @return number of connections shrunk
+             */
+            int shrink_memory() {
+                int count = 0;
+                auto shrink = [&count](sqlite3* db) {
+                    sqlite3_db_release_memory(db);
+                    ++count;
+                };
+                if(this->pool) {
+                    this->pool->for_each_idle(shrink);
+                } else {
+                    this->for_each_opened_connection(shrink);
+                }
+                return count;
+            }
+
+            /**
+             *  Makes `notify_memory_pressure()` run `shrink_memory()` for this storage (true) or not (false,
+             *  the default). Call it before the storage is used by other threads.
+             */
+            void shrink_on_memory_pressure(bool enabled = true) {
+                if(!enabled) {
+                    this->memoryPressureListener.reset();
+                } else if(!this->memoryPressureListener) {
+                    this->memoryPressureListener = std::make_unique<memory_pressure_listener>([this] {
+                        this->shrink_memory();
+                    });
+                }
+            }
 #endif
 
+#if SQLITE_VERSION_NUMBER >= 3010000
+            /**
+             *  Returns memory and page cache statistics of all opened connections of this storage
+             *  together with the process-wide memory statistics of SQLite. Use it to size
+             *  `cache_size` and `mmap_size` or to see where the memory goes.
+             *  @param reset resets the counters and high water marks that can be reset after reading them.
+             */
+            storage_status status(bool reset = false) {
+                storage_status result;
+                this->for_each_opened_connection([this, &result, reset](sqlite3* db) {
+                    add_connection_status(result.connections, db, reset);
+                    this->busyStatistics.add_connection(result.busy, db, reset);
+                    ++result.connections_count;
+                });
+                result.process = get_process_status(reset);
+                this->busyStatistics.add_totals(result.busy, reset);
+                return result;
+            }
+#endif
+
+            /**
+             *  Returns how the connections of the pool were borrowed by every priority class, see
+             *  `pool_priority_scope`, and how long the threads of each class waited for them. All zero without
+             *  a pool.
+             *  @param reset resets the counters after reading them.
+             */
+            sqlite_orm::pool_stats pool_stats(bool reset = false) {
+                return this->pool ? this->pool->stats(reset) : sqlite_orm::pool_stats{};
+            }
+
+#ifdef SQLITE_ENABLE_DBSTAT_VTAB
+            /**
+             *  Returns the pages, payload, free space, overflow pages and fragmentation of every table and index
+             *  of schema `schemaName` ordered by name, read from the `dbstat` virtual table. It reads every page of
+             *  the database file, so it takes as long as a full scan of all tables.
+             *  Tables with a high `unused_ratio()` or `fragmentation` benefit from a VACUUM, tables with many
+             *  overflow pages have records too large for the page size.
+             */
+            std::vector<btree_space> space_report(const std::string& schemaName = "main") {
+                auto con = this->get_connection();
+                return read_space_report(con.get(), schemaName);
+            }
+#endif  //  SQLITE_ENABLE_DBSTAT_VTAB
+
+            /**
+             *  Returns the file I/O of the database file of this storage, its journal and WAL by all connections of
+             *  the process, counted since the file was first opened or since `reset`. Only files opened through
+             *  a VFS made with `register_vfs_shim()` from an `io_accounting_shim` are counted, other databases
+             *  return zeros. E.g. `syncs` per committed transaction tells the cost of `synchronous`.
+             */
+            io_statistics io_stats(bool reset = false) {
+                auto con = this->get_connection();
+                const char* path = sqlite3_db_filename(con.get(), "main");
+                auto entry = path ? internal::io_accounting_registry::instance().get(path, false) : nullptr;
+                if(!entry) {
+                    return {};
+                }
+                std::lock_guard<std::mutex> lock{entry->mutex};
+                auto result = entry->stats;
+                if(reset) {
+                    entry->stats = {};
+                }
+                return result;
+            }
+
             /**
              *  Returns existing permanent table names in database. Doesn't check storage itself - works only with
              * actual database.
-             *  @return Returns list of tables in database.
+             *  The tables and their columns are read with one query into a cache of the storage, which
+             *  `table_exists()`, `pragma.table_info()`, `pragma.table_xinfo()` and `sync_schema()` use too. It is
+             *  read again only after the schema changed, which `PRAGMA schema_version` tells, so that checking
+             *  the schema repeatedly, e.g. in health probes, costs a pragma read.
+             *  @return Returns list of tables in database, sorted by name.
              */
             std::vector<std::string> table_names() {
                 auto con = this->get_connection();
                 std::vector<std::string> tableNames;
-                using data_t = std::vector<std::string>;
-                perform_exec(
-                    con.get(),
-                    "SELECT name FROM sqlite_master WHERE type='table'",
-                    [](void* data, int argc, char** argv, char** /*columnName*/) -> int {
-                        auto& tableNames_ = *(data_t*)data;
-                        for(int i = 0; i < argc; ++i) {
-                            if(argv[i]) {
-                                tableNames_.emplace_back(argv[i]);
-                            }
-                        }
-                        return 0;
-                    },
-                    &tableNames);
+                auto snapshot = this->cached_schema_snapshot(con.get());
+                if(snapshot->loaded) {
+                    tableNames.reserve(snapshot->tables.size());
+                    for(auto& table: snapshot->tables) {
+                        tableNames.push_back(table.first);
+                    }
+                    return tableNames;
+                }
+                this->pragma.for_each_row(con.get(),
+                                          "SELECT name FROM sqlite_master WHERE type='table'",
+                                          [&tableNames](sqlite3_stmt* stmt) {
+                                              tableNames.push_back(schema_text(stmt, 0));
+                                          });
                 return tableNames;
             }
 
             void open_forever() {
+                //  pooled connections stay open until the storage is destroyed anyway
+                if(this->pool || this->isOpenedForever) {
+                    return;
+                }
                 this->isOpenedForever = true;
                 this->connection->retain();
-                if(1 == this->connection->retain_count()) {
-                    this->on_open_internal(this->connection->get());
+            }
+
+            /**
+             *  Keeps the connection of this thread open while the returned session exists, like `open_forever()`
+             *  for a scope, and with a pool keeps it borrowed. Meanwhile the CRUD calls of this thread, e.g.
+             *  `insert`, `get` or `update`, use it without retaining it again. Sessions may nest.
+             *  @example: {
+             *                auto session = storage.session();
+             *                for(auto& user: users) {
+             *                    storage.insert(user);
+             *                }
+             *            }
+             */
+            session_t session() {
+                return {this, this->get_connection()};
+            }
+
+            /**
+             *  Number of times a connection of this storage has been opened. A count growing with the number of
+             *  calls means that every call opens and closes the database file, see `open_forever()` and `session()`.
+             *  SQLite logs a `SQLITE_WARNING` every time the count of a storage that isn't opened forever reaches
+             *  a power of two from 64 on, see `SQLITE_CONFIG_LOG`.
+             */
+            size_t opened_connections_count() const {
+                return this->openedConnectionsCount;
+            }
+
+            /**
+             *  Enables caching of the statements prepared by the non-prepared CRUD API
+             *  (`get`, `get_all`, `insert`, `update`, `replace`, `remove`, `select`, `count`, ...).
+             *  A call whose statement has the same shape as a previous one just rebinds the cached `sqlite3_stmt`
+             *  instead of serializing and preparing it again. Statements are cached per connection,
+             *  so a plain file storage keeps its connection open after this call like with `open_forever()`.
+             *  @param capacity maximum number of cached statements.
+             */
+            void enable_statement_cache(size_t capacity = 64) {
+                if(!this->isOpenedForever) {
+                    this->open_forever();
                 }
+                auto cache = std::make_shared<statement_cache>(capacity);
+                std::lock_guard<std::mutex> lock{this->statementCacheMutex};
+                this->statementCache.swap(cache);
+            }
+
+            /**
+             *  Finalizes all cached statements and stops caching. Statements in use at the time, e.g. by a
+             *  `for_each()` or on another thread, are finalized once their call is done.
+             */
+            void disable_statement_cache() {
+                std::shared_ptr<statement_cache> cache;
+                std::lock_guard<std::mutex> lock{this->statementCacheMutex};
+                this->statementCache.swap(cache);
+            }
+
+            bool is_statement_cache_enabled() const {
+                return bool(this->get_statement_cache());
+            }
+
+            /**
+             *  Returns `sqlite3_stmt_status` counters accumulated per SQL text of the statements run through
+             *  the statement cache, e.g. to detect a query that started to use a full scan or an automatic index.
+             *  Returns an empty map if the statement cache is disabled.
+             */
+            std::map<std::string, statement_stats> cached_statements_stats() {
+                auto cache = this->get_statement_cache();
+                if(!cache) {
+                    return {};
+                }
+                return cache->stats();
             }
 
             /**
@@ -228,6 +1072,13 @@ namespace sqlite_orm {
              *  };
              * ```
              * 
+             * Add `static constexpr bool deterministic = true;` to T if it always returns the same result for the same
+             * arguments so it can be used in indexes; `direct_only` and `innocuous` members are forwarded the same way
+             * (see `user_defined_function_flags`).
+             * 
+             * If T has no data members or its operator() is const one T object is created here and shared by all calls
+             * on all connections. Otherwise a new T object is created for every call.
+             * 
              * Note: Currently, a function's name must not contain white-space characters, because it doesn't get quoted.
              */
             template<class F>
@@ -259,11 +1110,14 @@ namespace sqlite_orm {
                     delete_function_callback<F>,
                 });
 
-                if(this->connection->retain_count() > 0) {
-                    sqlite3* db = this->connection->get();
-                    try_to_create_function(db,
-                                           static_cast<user_defined_scalar_function_t&>(*this->scalarFunctions.back()));
+                auto& function = static_cast<user_defined_scalar_function_t&>(*this->scalarFunctions.back());
+                function.flags = user_defined_function_flags<F>();
+                if(is_reusable_scalar_function_v<F>) {
+                    function.instance = {function.create(), function.destroy};
                 }
+                this->for_each_opened_connection([this, &function](sqlite3* db) {
+                    this->try_to_create_function(db, function);
+                });
             }
 
             /**
@@ -288,6 +1142,9 @@ namespace sqlite_orm {
              *       }
              *   };
              * ```
+             * If T also has `inverse` member function taking the same arguments as `step` and `value` member function
+             * returning the current result, the function is registered with `sqlite3_create_window_function`, so
+             * SQLite can slide the window frame of `OVER (...)` instead of recomputing the aggregate for every frame.
              * 
              * Note: Currently, a function's name must not contain white-space characters, because it doesn't get quoted.
              */
@@ -326,12 +1183,12 @@ namespace sqlite_orm {
                     delete_function_callback<F>,
                 });
 
-                if(this->connection->retain_count() > 0) {
-                    sqlite3* db = this->connection->get();
-                    try_to_create_function(
-                        db,
-                        static_cast<user_defined_aggregate_function_t&>(*this->aggregateFunctions.back()));
-                }
+                auto& function = static_cast<user_defined_aggregate_function_t&>(*this->aggregateFunctions.back());
+                function.flags = user_defined_function_flags<F>();
+                this->set_window_function_calls<F>(function);
+                this->for_each_opened_connection([this, &function](sqlite3* db) {
+                    this->try_to_create_function(db, function);
+                });
             }
 
             /**
@@ -356,38 +1213,70 @@ namespace sqlite_orm {
                 this->delete_function_impl(ss.str(), this->aggregateFunctions);
             }
 
+            /**
+             *  Creates the collation C, a class with a static `name()` function and either an
+             *  `int operator()(int leftLength, const void* lhs, int rightLength, const void* rhs)` or, since C++17, an
+             *  `int operator()(std::string_view lhs, std::string_view rhs)`. One C is constructed here and called for
+             *  every comparison of every connection, so with a connection pool it has to be safe to call concurrently.
+             *  Can be called at any time no matter connection is open or no.
+             */
             template<class C>
             void create_collation() {
-                collating_function func = [](int leftLength, const void* lhs, int rightLength, const void* rhs) {
-                    C collatingObject;
-                    return collatingObject(leftLength, lhs, rightLength, rhs);
-                };
                 std::stringstream ss;
                 ss << C::name() << std::flush;
-                this->create_collation(ss.str(), move(func));
+                this->register_collation(ss.str(), collation_entry{std::make_shared<C>(), collate_trampoline<C>});
             }
 
             void create_collation(const std::string& name, collating_function f) {
-                collating_function* function = nullptr;
-                const auto functionExists = bool(f);
-                if(functionExists) {
-                    function = &(collatingFunctions[name] = std::move(f));
+                if(f) {
+                    this->register_collation(
+                        name,
+                        collation_entry{std::make_shared<collating_function>(std::move(f)), collate_callback});
                 } else {
-                    collatingFunctions.erase(name);
+                    this->register_collation(name, collation_entry{});
                 }
+            }
 
-                //  create collations if db is open
-                if(this->connection->retain_count() > 0) {
-                    sqlite3* db = this->connection->get();
-                    auto resultCode = sqlite3_create_collation(db,
-                                                               name.c_str(),
-                                                               SQLITE_UTF8,
-                                                               function,
-                                                               functionExists ? collate_callback : nullptr);
-                    if(resultCode != SQLITE_OK) {
-                        throw_translated_sqlite_error(db);
-                    }
-                }
+#ifdef SQLITE_ENABLE_RTREE
+            /**
+             *  Creates the custom R*Tree geometry F, called by `rtree_query<F>()`. F is a class with an
+             *  `int operator()(sqlite3_rtree_query_info* info)` and a static `name()` function, see
+             *  https://sqlite.org/rtree.html#custom_r_tree_queries. It sets `info->eWithin` and `info->rScore`
+             *  from the box `info->aCoord` and the arguments `info->aParam` and returns SQLITE_OK.
+             *  Can be called at any time no matter connection is open or no.
+             */
+            template<class F>
+            void create_rtree_query_function() {
+                std::stringstream ss;
+                ss << F::name() << std::flush;
+                this->create_rtree_query_function(ss.str(), F{});
+            }
+
+            void create_rtree_query_function(const std::string& name, rtree_query_function f) {
+                auto& function = this->rtreeQueryFunctions[name] = std::move(f);
+                this->for_each_opened_connection([&name, &function](sqlite3* db) {
+                    register_rtree_query_function(db, name, function);
+                });
+            }
+#endif  //  SQLITE_ENABLE_RTREE
+
+            /**
+             *  Registers the vector functions `vec_dot(a, b)`, `vec_l2(a, b)`, `vec_cosine(a, b)` and the
+             *  `top_k(value, score, k)` aggregate on every connection, replacing functions with the same names.
+             *  Vectors are BLOBs of float32 made by `vector_blob()`. The functions read the memory of the BLOB
+             *  arguments in place and run SIMD kernels picked once for the CPU: AVX2 and FMA when the CPU has
+             *  them, SSE otherwise on x86, NEON on ARM64.
+             *  Example: storage.enable_vector_functions();
+             *           auto nearest = storage.select(&Item::id,
+             *                                         order_by(vec_l2(&Item::embedding, vector_blob(query))),
+             *                                         limit(10));
+             *  Can be called at any time no matter connection is open or no.
+             */
+            void enable_vector_functions() {
+                this->vectorFunctions = true;
+                this->for_each_opened_connection([](sqlite3* db) {
+                    register_vector_functions(db);
+                });
             }
 
             template<class C>
@@ -413,22 +1302,39 @@ namespace sqlite_orm {
                 this->begin_transaction_internal("BEGIN EXCLUSIVE TRANSACTION");
             }
 
-            void commit() {
-                sqlite3* db = this->connection->get();
-                perform_void_exec(db, "COMMIT");
-                this->connection->release();
-                if(this->connection->retain_count() < 0) {
+            void savepoint(const std::string& name) {
+                this->begin_transaction_internal("SAVEPOINT " + quote_identifier(name));
+            }
+
+            void release_savepoint(const std::string& name) {
+                this->end_transaction_internal("RELEASE " + quote_identifier(name));
+            }
+
+            /**
+             *  Undoes the changes made since the savepoint `name`. The savepoint stays open.
+             */
+            void rollback_to_savepoint(const std::string& name) {
+                connection_holder* holder = this->pool ? this->pool->current() : this->connection.get();
+                if(!holder || !holder->get()) {
                     throw std::system_error{orm_error_code::no_active_transaction};
                 }
+                perform_void_exec(holder->get(), "ROLLBACK TO " + quote_identifier(name));
+            }
+
+            /**
+             *  Whether the connection of the calling thread is inside a transaction.
+             */
+            bool in_transaction() {
+                connection_holder* holder = this->pool ? this->pool->current() : this->connection.get();
+                return holder && holder->get() && !sqlite3_get_autocommit(holder->get());
+            }
+
+            void commit() {
+                this->end_transaction_internal("COMMIT");
             }
 
             void rollback() {
-                sqlite3* db = this->connection->get();
-                perform_void_exec(db, "ROLLBACK");
-                this->connection->release();
-                if(this->connection->retain_count() < 0) {
-                    throw std::system_error{orm_error_code::no_active_transaction};
-                }
+                this->end_transaction_internal("ROLLBACK");
             }
 
             void backup_to(const std::string& filename) {
@@ -441,6 +1347,21 @@ namespace sqlite_orm {
                 backup.step(-1);
             }
 
+            /**
+             *  Backs the database up to the file `filename` in steps, see `backup_options`. Run it with `async()`
+             *  to back up on a background thread.
+             *  @return true if the backup is complete, false if it took longer than `options.max_duration`.
+             */
+            bool backup_to(const std::string& filename, const backup_options& options) {
+                auto backup = this->make_backup_to(filename);
+                return backup.run(options);
+            }
+
+            bool backup_to(storage_base& other, const backup_options& options) {
+                auto backup = this->make_backup_to(other);
+                return backup.run(options);
+            }
+
             void backup_from(const std::string& filename) {
                 auto backup = this->make_backup_from(filename);
                 backup.step(-1);
@@ -451,6 +1372,89 @@ namespace sqlite_orm {
                 backup.step(-1);
             }
 
+#if SQLITE_VERSION_NUMBER >= 3036000 && !defined(SQLITE_OMIT_DESERIALIZE)
+            /**
+             *  The database file image of `schemaName`, the bytes a backup to a file would write, in one
+             *  contiguous buffer. https://sqlite.org/c3ref/serialize.html
+             */
+            std::vector<char> serialize_database(const std::string& schemaName = "main") {
+                auto con = this->get_connection();
+                sqlite3_int64 size = 0;
+                //  in-memory databases can be read in place
+                if(auto data = sqlite3_serialize(con.get(), schemaName.c_str(), &size, SQLITE_SERIALIZE_NOCOPY)) {
+                    return {data, data + size};
+                }
+                std::unique_ptr<unsigned char, void (*)(void*)> copy{
+                    sqlite3_serialize(con.get(), schemaName.c_str(), &size, 0),
+                    sqlite3_free};
+                if(!copy) {
+                    //  an empty database has no pages to allocate a copy for
+                    if(size == 0) {
+                        return {};
+                    }
+                    throw_translated_sqlite_error(SQLITE_NOMEM);
+                }
+                return {copy.get(), copy.get() + size};
+            }
+
+            /**
+             *  Replaces the database `schemaName` of the connection with the in-memory database of the file image
+             *  `data`, e.g. one made by `serialize_database()`. A `readonly` database uses `data` in place, so it
+             *  has to outlive the connection, which suits a memory mapped file. Otherwise the image is copied and
+             *  the database can be changed and grow. Either way the database lives as long as the connection, so
+             *  call it on in-memory storages or after `open_forever()`.
+             *  https://sqlite.org/c3ref/deserialize.html
+             */
+            void deserialize_database(const char* data,
+                                      size_t size,
+                                      bool readonly,
+                                      const std::string& schemaName = "main") {
+                auto con = this->get_connection();
+                unsigned char* buffer;
+                unsigned flags;
+                if(readonly) {
+                    buffer = (unsigned char*)data;
+                    flags = SQLITE_DESERIALIZE_READONLY;
+                } else {
+                    //  SQLite frees and resizes the copy with its own allocator
+                    buffer = (unsigned char*)sqlite3_malloc64(size ? size : 1);
+                    if(!buffer) {
+                        throw_translated_sqlite_error(SQLITE_NOMEM);
+                    }
+                    std::copy(data, data + size, buffer);
+                    flags = SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE;
+                }
+                auto rc = sqlite3_deserialize(con.get(),
+                                              schemaName.c_str(),
+                                              buffer,
+                                              sqlite3_int64(size),
+                                              sqlite3_int64(size),
+                                              flags);
+                //  SQLite frees a FREEONCLOSE buffer even if it fails
+                if(rc != SQLITE_OK) {
+                    throw_translated_sqlite_error(con.get());
+                }
+            }
+
+            void deserialize_database(const std::vector<char>& image,
+                                      bool readonly,
+                                      const std::string& schemaName = "main") {
+                this->deserialize_database(image.data(), image.size(), readonly, schemaName);
+            }
+#endif
+
+#if defined(SQLITE_ENABLE_SESSION) && defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+            /**
+             *  Applies a changeset or a patchset of `change_recorder` in one savepoint. Changes to tables that
+             *  don't exist or whose primary key differs are skipped, conflicts are handled by `policy`.
+             */
+            void apply_changeset(const std::vector<char>& changeset,
+                                 changeset_conflict_policy policy = changeset_conflict_policy::abort) {
+                auto con = this->get_connection();
+                internal::apply_changeset(con.get(), changeset, policy);
+            }
+#endif
+
             backup_t make_backup_to(const std::string& filename) {
                 auto holder = std::make_unique<connection_holder>(filename);
                 connection_ref conRef{*holder};
@@ -480,79 +1484,522 @@ namespace sqlite_orm {
              * Returns always `true` for in memory databases.
              */
             bool is_opened() const {
+                if(this->pool) {
+                    return this->pool->has_opened();
+                }
                 return this->connection->retain_count() > 0;
             }
 
-            /*
-             * returning false when there is a transaction in place
-             * otherwise true; function is not const because it has to call get_connection()
-             */
-            bool get_autocommit() {
-                auto con = this->get_connection();
-                return sqlite3_get_autocommit(con.get());
+            /**
+             *  Returns true if this storage was created with `pool_options`.
+             */
+            bool is_pooled() const {
+                return bool(this->pool);
+            }
+
+            /*
+             * returning false when there is a transaction in place
+             * otherwise true; function is not const because it has to call get_connection()
+             */
+            bool get_autocommit() {
+                auto con = this->get_connection();
+                return sqlite3_get_autocommit(con.get());
+            }
+
+            int busy_handler(std::function<int(int)> handler) {
+                _busy_handler = move(handler);
+                int rc = SQLITE_OK;
+                this->for_each_opened_connection([this, &rc](sqlite3* db) {
+                    rc = this->set_busy_handler(db);
+                });
+                return rc;
+            }
+
+            /**
+             *  Starts counting how often and how long the connections of this storage wait for locks held by
+             *  other connections, per connection, per statement and per kind of transaction, see
+             *  `status().busy`. The time a statement waited is also reported by `on_profile()`.
+             *  Every connection gets a busy handler that times the one set with `busy_handler()` or, if there
+             *  is none, waits like `sqlite3_busy_timeout()` for the timeout the connection had, so set the timeout
+             *  with `busy_timeout()` or `pragma.busy_timeout()` from now on: `PRAGMA busy_timeout` and
+             *  `sqlite3_busy_timeout()` run otherwise replace the counting handler, and the pragma reads 0.
+             */
+            void enable_busy_statistics() {
+                this->busyStatistics.enable();
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_busy_handler(db);
+                });
+            }
+
+            /**
+             *  Stops counting waits and gives the connections their busy handler or busy timeout back. The
+             *  counters are kept until `status(true)`.
+             */
+            void disable_busy_statistics() {
+                this->busyStatistics.disable();
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_busy_handler(db);
+                });
+            }
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+            /**
+             *  Sets a callback that is called with the statistics of every statement executed by this storage
+             *  once the statement finishes. It is registered with `sqlite3_trace_v2` on every opened connection,
+             *  including connections opened later. The callback is called from the thread that executed
+             *  the statement. Pass an empty function to stop profiling.
+             */
+            void on_profile(std::function<void(const statement_profile&)> handler) {
+                this->_profile_handler = move(handler);
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_profile_trace(db);
+                });
+            }
+
+            /**
+             *  Starts recording executions that take at least `options.threshold` into a slow query log.
+             *  Executions are grouped by their SQL text with placeholders, and for every group only
+             *  the `options.top_k` slowest ones are kept together with their bound values. Calling it again
+             *  changes the options and keeps the recorded executions. Works together with `on_profile()`.
+             */
+            void enable_slow_query_log(slow_query_log_options options = {}) {
+                this->slowQueries.enable(std::move(options));
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_profile_trace(db);
+                });
+            }
+
+            /**
+             *  Stops recording slow executions. Already recorded ones are kept until `clear_slow_queries()`.
+             */
+            void disable_slow_query_log() {
+                this->slowQueries.disable();
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_profile_trace(db);
+                });
+            }
+
+            /**
+             *  Returns the slow query log, the statement shape with the slowest execution first.
+             *  `EXPLAIN QUERY PLAN` of every shape is run once, by the first call that returns the shape.
+             */
+            std::vector<slow_query_shape> slow_queries() {
+                auto con = this->get_connection();
+                return this->slowQueries.get(con.get());
+            }
+
+            void clear_slow_queries() {
+                this->slowQueries.clear();
+            }
+
+            /**
+             *  Starts counting the executions of every statement shape, the SQL text with placeholders, for
+             *  `suggest_indexes()`. Calling it again changes the options and keeps the counted executions.
+             *  Works together with `on_profile()` and the slow query log.
+             */
+            void enable_index_advisor(index_advisor_options options = {}) {
+                this->indexAdvisor.enable(std::move(options));
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_profile_trace(db);
+                });
+            }
+
+            /**
+             *  Stops counting executions. Already counted ones are kept until `clear_index_advisor()`.
+             */
+            void disable_index_advisor() {
+                this->indexAdvisor.disable();
+                this->for_each_opened_connection([this](sqlite3* db) {
+                    this->set_profile_trace(db);
+                });
+            }
+
+            /**
+             *  Suggests indexes for the statement shapes counted since `enable_index_advisor()` whose
+             *  `EXPLAIN QUERY PLAN` scans a table while filtering it by columns or sorts it in a
+             *  temporary b-tree, the index helping the most executions first. The indexed columns are the
+             *  ones compared for equality followed by one compared by range or else the ORDER BY columns,
+             *  found in the SQL text sqlite_orm generates. A join SQLite answers with an automatic index,
+             *  built for every execution, gets the columns of that index, and `automatic_index_executions`
+             *  counts the executions that built it. It is a heuristic: check the suggestions with
+             *  `explain_query_plan()` after adding them, e.g. with the `cpp()` snippet to `make_storage()`.
+             */
+            std::vector<index_suggestion> suggest_indexes() {
+                auto con = this->get_connection();
+                return this->indexAdvisor.get(con.get());
+            }
+
+            void clear_index_advisor() {
+                this->indexAdvisor.clear();
+            }
+#endif
+
+            /**
+             *  Prepares `sql`, a single statement, and steps it to the end on a connection of this storage like
+             *  any other call. Result rows are discarded, their number is returned. Meant for replaying captured
+             *  SQL texts, see `replay_workload()`, not for queries the typed API can express.
+             */
+            int64 replay_sql(const std::string& sql) {
+                auto con = this->get_call_connection(false);
+                statement_finalizer stmt{prepare_stmt(con.get(), sql)};
+                int64 rows = 0;
+                perform_steps(stmt.get(), [&rows](sqlite3_stmt*) {
+                    ++rows;
+                });
+                return rows;
+            }
+
+            /**
+             *  Replays the statements of `trace`, captured by a `workload_recorder`, on this storage with
+             *  `options.threads` threads and reports throughput and latency percentiles. Every replaying thread
+             *  runs in a `session()`, so a transaction of the capture stays on one connection; give a pooled
+             *  storage at least as many connections as threads. Failing statements are counted, not thrown.
+             */
+            workload_replay_report replay_workload(const workload_trace& trace, workload_replay_options options = {}) {
+                return internal::replay_workload(
+                    trace,
+                    options,
+                    [this] {
+                        return this->session();
+                    },
+                    [this](const std::string& sql) {
+                        this->replay_sql(sql);
+                    });
+            }
+
+            /**
+             *  Lets `select(..., cached())` keep results in memory, see `cached()`. Results are dropped when
+             *  a table they are read from changes through a connection of the storage. Changes made by other
+             *  processes or other storages are noticed only with `enable_cache_coherence()`. Selects reading
+             *  WITHOUT ROWID tables, whose changes the update hook doesn't see, are not cached.
+             */
+            void enable_query_cache(query_cache_options options = {}) {
+                this->queryResults.enable(std::move(options));
+                this->reset_change_hooks();
+            }
+
+            void disable_query_cache() {
+                this->queryResults.disable();
+                this->reset_change_hooks();
+            }
+
+            void clear_query_cache() {
+                this->queryResults.clear();
+            }
+
+            sqlite_orm::query_cache_stats query_cache_stats() {
+                return this->queryResults.stats();
+            }
+
+            /**
+             *  `PRAGMA data_version` of the connection of this call, see `pragma_t::data_version()`.
+             */
+            int data_version() {
+                return this->pragma.data_version();
+            }
+
+            /**
+             *  Lets the object caches, the query cache and the key filters notice changes made by other processes
+             *  and other storages: before a cached object or result is looked up and when a transaction begins,
+             *  the `PRAGMA data_version` of the connection is compared with the one it had the last time, and
+             *  every cache is cleared and every key filter rebuilt if another connection committed a change
+             *  meanwhile. It costs a pragma call per
+             *  lookup, cheap next to a query. The first check of a connection clears the caches, as there is
+             *  nothing to compare with, so keep the connections open with `open_forever()` or a pool.
+             *  Within a transaction the cached objects stay those of its snapshot.
+             */
+            void enable_cache_coherence() {
+                this->dataVersions.enable();
+            }
+
+            void disable_cache_coherence() {
+                this->dataVersions.disable();
+            }
+
+            /**
+             *  Records every insert, update and removal of a row made through a connection of the storage into
+             *  the audit table `options.table`, without writing it in the audited transaction: the hooks keep
+             *  the changes in memory, and once their transaction commits a thread writes them in batches through
+             *  a connection of its own, at the latest `options.flush_interval` later. Records of the last window
+             *  are lost if the process dies. An audit table in the database of the storage competes with its
+             *  writers for the write lock, one in another file (`options.path`) doesn't.
+             *  Changes made by other processes or other storages are not recorded. Calling it again flushes the
+             *  records and restarts the log with new options. See `audit_record` for the columns.
+             */
+            void enable_audit_log(audit_log_options options = {}) {
+                if(options.path.empty()) {
+                    if(this->inMemory) {
+                        throw std::system_error{orm_error_code::no_audit_database};
+                    }
+                    options.path = this->filename();
+                }
+                this->auditLog.enable(std::move(options));
+                this->reset_change_hooks();
+            }
+
+            /**
+             *  Stops recording changes and writes the buffered records.
+             */
+            void disable_audit_log() {
+                this->auditLog.disable();
+                this->reset_change_hooks();
+            }
+
+            /**
+             *  Writes the records of committed changes now instead of waiting for the flush interval, e.g. before
+             *  a shutdown or a backup.
+             *  @return number of records written.
+             */
+            size_t flush_audit_log() {
+                return this->auditLog.flush();
+            }
+
+          protected:
+            /**
+             *  Registers `module` as eponymous virtual table `name`, now on the opened connections and later on
+             *  every connection that opens.
+             */
+            void create_module(const std::string& name, std::shared_ptr<const virtual_table_module_base> module) {
+                this->virtualTableModules.emplace_back(name, module);
+                this->for_each_opened_connection([&name, &module](sqlite3* db) {
+                    module->create_module(db, name);
+                });
+            }
+
+            storage_base(std::string filename, int foreignKeysCount, const open_options& openOptions = {}) :
+                pragma(*this), limit(*this),
+                inMemory(filename.empty() || filename == ":memory:"),
+                connection(std::make_unique<connection_holder>(move(filename), nullptr, false, openOptions)),
+                cachedForeignKeysCount(foreignKeysCount) {
+                this->set_internal_hooks();
+                if(this->inMemory) {
+                    this->connection->retain();
+                }
+            }
+
+            /**
+             *  Pooled storage. In-memory databases can't be shared between connections,
+             *  so for them the pool options are ignored and a single connection is used.
+             */
+            storage_base(const pool_options& poolOptions,
+                         std::string filename,
+                         int foreignKeysCount,
+                         const open_options& openOptions = {}) :
+                storage_base{move(filename), foreignKeysCount, openOptions} {
+                if(!this->inMemory && !openOptions.single_process) {
+                    this->pool = this->make_pool(poolOptions);
+                }
+            }
+
+            storage_base(const storage_base& other) :
+                on_open(other.on_open), pragma(*this), limit(*this), auto_optimize(other.auto_optimize),
+                sync_schema_in_transaction(other.sync_schema_in_transaction),
+                inMemory(other.inMemory),
+                connection(std::make_unique<connection_holder>(
+                    other.connection->filename, nullptr, false, other.connection->options)),
+                pool(other.pool ? this->make_pool(other.pool->options) : nullptr),
+                virtualTableModules(other.virtualTableModules), openPreparedSqls(other.openPreparedSqls),
+                cachedForeignKeysCount(other.cachedForeignKeysCount) {
+                this->set_internal_hooks();
+                this->attachedDatabases = other.attachedDatabases;
+                if(this->inMemory) {
+                    this->connection->retain();
+                }
+            }
+
+            /**
+             *  A fork of `other`, see `storage_t::fork()`: a single connection to `filename` opened with
+             *  `openOptions`, and the registered functions and collations of `other`, shared with it.
+             */
+            storage_base(const storage_base& other, std::string filename, const open_options& openOptions) :
+                on_open(other.on_open), pragma(*this), limit(*this), auto_optimize(other.auto_optimize),
+                sync_schema_in_transaction(other.sync_schema_in_transaction),
+                inMemory(filename.empty() || filename == ":memory:"),
+                connection(std::make_unique<connection_holder>(move(filename), nullptr, false, openOptions)),
+                collatingFunctions(other.collatingFunctions),
+#ifdef SQLITE_ENABLE_RTREE
+                rtreeQueryFunctions(other.rtreeQueryFunctions),
+#endif  //  SQLITE_ENABLE_RTREE
+                vectorFunctions(other.vectorFunctions),
+                virtualTableModules(other.virtualTableModules), openPreparedSqls(other.openPreparedSqls),
+                attachedDatabases(other.attachedDatabases), cachedForeignKeysCount(other.cachedForeignKeysCount),
+                scalarFunctions(other.scalarFunctions), aggregateFunctions(other.aggregateFunctions) {
+                this->set_internal_hooks();
+                if(this->inMemory) {
+                    this->connection->retain();
+                }
+            }
+
+            ~storage_base() {
+                //  a running `notify_memory_pressure()` is waited for
+                this->memoryPressureListener.reset();
+                //  the scheduler runs checkpoints with connections of the storage
+                this->stop_checkpoint_scheduler();
+                //  queued async calls still use the storage
+                this->executor.reset();
+                //  pooled connections are closed by the pool which knows nothing about optimizing
+                if(this->pool) {
+                    this->for_each_opened_connection([this](sqlite3* db) {
+                        this->optimize_before_close(db);
+                    });
+                }
+                //  cached statements have to be finalized before connections get closed
+                this->statementCache.reset();
+                if(this->isOpenedForever) {
+                    this->connection->release();
+                }
+                if(this->inMemory) {
+                    this->connection->release();
+                }
+            }
+
+            void begin_transaction_internal(const std::string& query) {
+                auto con = this->get_connection();
+                //  keeps the connection open (and assigned to this thread) until the transaction ends
+                connection_holder* holder = this->pool ? this->pool->current() : this->connection.get();
+                holder->retain();
+                try {
+                    const bool beginning = sqlite3_get_autocommit(con.get()) != 0;
+                    perform_void_exec(con.get(), query);
+                    if(beginning && this->busyStatistics.enabled()) {
+                        this->busyStatistics.began(con.get(), busy_transaction_kind_of(query));
+                    }
+                    this->check_data_version(con.get());
+                } catch(...) {
+                    holder->release();
+                    throw;
+                }
+            }
+
+            /**
+             *  Clears the caches if coherence is enabled and another connection changed the database since
+             *  the last check of `db`, see `enable_cache_coherence()`.
+             */
+            void check_data_version(sqlite3* db) {
+                if(this->dataVersions.enabled() && this->dataVersions.changed(db)) {
+                    this->objectCaches.clear();
+                    this->queryResults.clear();
+                    this->keyFilters.mark_all_stale();
+                }
+            }
+
+            void check_data_version() {
+                if(this->dataVersions.enabled()) {
+                    auto con = this->get_call_connection(true);
+                    this->check_data_version(con.get());
+                }
+            }
+
+            void transaction_ended(sqlite3* db) {
+                //  a transaction begun later by SQL is deferred unless told otherwise
+                if(this->busyStatistics.enabled() && sqlite3_get_autocommit(db)) {
+                    this->busyStatistics.began(db, busy_transaction_kind::deferred);
+                }
+            }
+
+            void end_transaction_internal(const std::string& query) {
+                connection_holder* holder = this->pool ? this->pool->current() : this->connection.get();
+                if(!holder) {
+                    throw std::system_error{orm_error_code::no_active_transaction};
+                }
+                perform_void_exec(holder->get(), query);
+                this->transaction_ended(holder->get());
+                holder->release();
+                if(holder->retain_count() < 0) {
+                    throw std::system_error{orm_error_code::no_active_transaction};
+                }
+            }
+
+            void set_internal_hooks() {
+                this->connection->after_open = [this](sqlite3* db) {
+                    this->on_connection_opened(db);
+                };
+                this->connection->before_close = [this](sqlite3* db) {
+                    this->optimize_before_close(db);
+                    this->changeHooks.closed(db);
+                    this->dataVersions.closed(db);
+                    this->busyStatistics.closed(db);
+                };
+                this->changeHooks.listeners = {&this->objectCaches,
+                                               &this->keyFilters,
+                                               &this->changeStreams,
+                                               &this->queryResults,
+                                               &this->auditLog};
+                this->pragma.wal_autocheckpoint_changed = std::bind(&storage_base::reset_wal_hooks, this);
+                this->pragma.for_each_opened_connection = [this](const std::function<void(sqlite3*)>& lambda) {
+                    this->for_each_opened_connection(lambda);
+                };
             }
 
-            int busy_handler(std::function<int(int)> handler) {
-                _busy_handler = move(handler);
-                if(this->is_opened()) {
-                    if(_busy_handler) {
-                        return sqlite3_busy_handler(this->connection->get(), busy_handler_callback, this);
-                    } else {
-                        return sqlite3_busy_handler(this->connection->get(), nullptr, nullptr);
-                    }
-                } else {
-                    return SQLITE_OK;
+            connection_ref get_connection() {
+                if(this->pool) {
+                    return this->pool->acquire();
                 }
+                return connection_ref{*this->connection};
             }
 
-          protected:
-            storage_base(std::string filename, int foreignKeysCount) :
-                pragma(std::bind(&storage_base::get_connection, this)),
-                limit(std::bind(&storage_base::get_connection, this)),
-                inMemory(filename.empty() || filename == ":memory:"),
-                connection(std::make_unique<connection_holder>(move(filename))),
-                cachedForeignKeysCount(foreignKeysCount) {
-                if(this->inMemory) {
+            /**
+             *  Sets up the single connection when it opens, while other threads retaining it wait.
+             */
+            void on_connection_opened(sqlite3* db) {
+                this->on_open_internal(db);
+                //  closing would give up the exclusive lock
+                if(this->connection->options.single_process && !this->isOpenedForever) {
+                    this->isOpenedForever = true;
                     this->connection->retain();
-                    this->on_open_internal(this->connection->get());
+                }
+                const size_t count = this->openedConnectionsCount;
+                if(count >= 64 && (count & (count - 1)) == 0) {
+                    sqlite3_log(SQLITE_WARNING,
+                                "sqlite_orm: %s has been opened %llu times, consider open_forever()",
+                                this->connection->filename.c_str(),
+                                (unsigned long long)count);
                 }
             }
 
-            storage_base(const storage_base& other) :
-                on_open(other.on_open), pragma(std::bind(&storage_base::get_connection, this)),
-                limit(std::bind(&storage_base::get_connection, this)), inMemory(other.inMemory),
-                connection(std::make_unique<connection_holder>(other.connection->filename)),
-                cachedForeignKeysCount(other.cachedForeignKeysCount) {
-                if(this->inMemory) {
-                    this->connection->retain();
-                    this->on_open_internal(this->connection->get());
+            /**
+             *  Same as `get_connection()`, or `get_read_connection()` if `reading`, for a reference which doesn't
+             *  outlive the call it is made for: inside a `session()` of this thread it is the connection of the
+             *  session, which isn't retained again.
+             */
+            connection_ref get_call_connection(bool reading) {
+                if(auto session = session_state::find(this)) {
+                    return session->connection.unretained();
                 }
+                return reading ? this->get_read_connection() : this->get_connection();
             }
 
-            ~storage_base() {
-                if(this->isOpenedForever) {
-                    this->connection->release();
-                }
-                if(this->inMemory) {
-                    this->connection->release();
+            /**
+             *  Same as `get_connection()` but for statements that only read data:
+             *  returns a read-only connection if the pool has a dedicated writer.
+             */
+            connection_ref get_read_connection() {
+                if(this->pool) {
+                    return this->pool->acquire_reader();
                 }
+                return this->get_connection();
             }
 
-            void begin_transaction_internal(const std::string& query) {
-                this->connection->retain();
-                if(1 == this->connection->retain_count()) {
-                    this->on_open_internal(this->connection->get());
-                }
-                sqlite3* db = this->connection->get();
-                perform_void_exec(db, query);
+            std::unique_ptr<connection_pool> make_pool(const pool_options& poolOptions) {
+                return std::make_unique<connection_pool>(this->connection->filename,
+                                                         poolOptions,
+                                                         this->connection->options,
+                                                         [this](sqlite3* db) {
+                                                             this->on_open_internal(db);
+                                                         });
             }
 
-            connection_ref get_connection() {
-                connection_ref res{*this->connection};
-                if(1 == this->connection->retain_count()) {
-                    this->on_open_internal(this->connection->get());
+            /**
+             *  Calls `lambda` with every currently open database handle: the single connection
+             *  if it is open or every opened connection of the pool.
+             */
+            template<class L>
+            void for_each_opened_connection(L&& lambda) {
+                if(this->pool) {
+                    this->pool->for_each_opened(lambda);
+                } else if(this->connection->retain_count() > 0) {
+                    lambda(this->connection->get());
                 }
-                return res;
             }
 
 #if SQLITE_VERSION_NUMBER >= 3006019
@@ -570,7 +2017,27 @@ namespace sqlite_orm {
             }
 
 #endif
+            /**
+             *  Installs the change hooks on opened connections once a feature needs them
+             *  and removes them once none does.
+             */
+            void reset_change_hooks() {
+                const bool needed = this->changeHooks.needed();
+                this->for_each_opened_connection([this, needed](sqlite3* db) {
+                    if(needed) {
+                        this->changeHooks.install(db);
+                    } else {
+                        this->changeHooks.uninstall(db);
+                    }
+                });
+            }
+
             void on_open_internal(sqlite3* db) {
+                ++this->openedConnectionsCount;
+                //  first, lookaside can't be changed once it is in use
+                if(this->lookasideSlotSize != -1) {
+                    this->set_lookaside(db);
+                }
 
 #if SQLITE_VERSION_NUMBER >= 3006019
                 if(this->cachedForeignKeysCount) {
@@ -578,27 +2045,80 @@ namespace sqlite_orm {
                 }
 #endif
                 if(this->pragma._synchronous != -1) {
-                    this->pragma.synchronous(this->pragma._synchronous);
+                    this->pragma.set_pragma("synchronous", this->pragma._synchronous, db);
                 }
 
-                if(this->pragma._journal_mode != -1) {
+                //  before journal mode, page size can't be changed in WAL mode
+                for(auto& p: this->pragma._connection_pragmas) {
+                    this->pragma.set_pragma(p.first, p.second, db);
+                }
+
+                //  journal mode can't be changed by read-only connections
+                if(this->pragma._journal_mode != -1 && sqlite3_db_readonly(db, "main") != 1) {
                     this->pragma.set_pragma("journal_mode", static_cast<journal_mode>(this->pragma._journal_mode), db);
                 }
 
+                if(this->pragma._wal_autocheckpoint != -1) {
+                    this->pragma.set_pragma("wal_autocheckpoint", this->pragma._wal_autocheckpoint, db);
+                }
+
+#ifdef SQLITE_ENABLE_MATH_FUNCTIONS
+                //  the math functions of the DSL work with SQLite libraries built without them too
+                if(!has_builtin_math_functions(db)) {
+                    register_math_functions(db);
+                }
+#endif  //  SQLITE_ENABLE_MATH_FUNCTIONS
+
                 for(auto& p: this->collatingFunctions) {
-                    auto resultCode =
-                        sqlite3_create_collation(db, p.first.c_str(), SQLITE_UTF8, &p.second, collate_callback);
+                    auto resultCode = sqlite3_create_collation(db,
+                                                               p.first.c_str(),
+                                                               SQLITE_UTF8,
+                                                               p.second.object.get(),
+                                                               p.second.callback);
                     if(resultCode != SQLITE_OK) {
                         throw_translated_sqlite_error(db);
                     }
                 }
 
+#ifdef SQLITE_ENABLE_RTREE
+                for(auto& p: this->rtreeQueryFunctions) {
+                    register_rtree_query_function(db, p.first, p.second);
+                }
+#endif  //  SQLITE_ENABLE_RTREE
+
+                if(this->vectorFunctions) {
+                    register_vector_functions(db);
+                }
+
+                for(auto& p: this->virtualTableModules) {
+                    p.second->create_module(db, p.first);
+                }
+
                 for(auto& p: this->limit.limits) {
                     sqlite3_limit(db, p.first, p.second);
                 }
 
-                if(_busy_handler) {
-                    sqlite3_busy_handler(this->connection->get(), busy_handler_callback, this);
+                if(_busy_handler || this->busyStatistics.enabled()) {
+                    this->set_busy_handler(db);
+                }
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(this->_profile_handler || this->slowQueries.enabled() || this->indexAdvisor.enabled()) {
+                    this->set_profile_trace(db);
+                }
+#endif
+
+                if(this->deadlinesEnabled) {
+                    set_deadline_handler(db);
+                }
+
+                if(this->changeHooks.needed()) {
+                    this->changeHooks.install(db);
+                }
+
+                //  after `wal_autocheckpoint` which replaces the hook
+                if(this->wal_hook_needed()) {
+                    this->set_wal_hook(db);
                 }
 
                 for(auto& functionPointer: this->scalarFunctions) {
@@ -609,13 +2129,49 @@ namespace sqlite_orm {
                     try_to_create_function(db, static_cast<user_defined_aggregate_function_t&>(*functionPointer));
                 }
 
+                for(auto& attached: this->attachedDatabases) {
+                    this->attach_database(db, attached.second, attached.first);
+                }
+
                 if(this->on_open) {
                     this->on_open(db);
                 }
+
+                //  last, the statements may use functions and collations
+                this->prepare_registered_statements(db);
+            }
+
+            /**
+             *  Prepares the statements registered by `prepare_on_open()` on `db` and puts them into the statement
+             *  cache. Statements that don't compile yet, e.g. before `sync_schema()` created their tables, are
+             *  skipped.
+             */
+            void prepare_registered_statements(sqlite3* db) {
+                auto cache = this->get_statement_cache();
+                for(auto& sql: this->openPreparedSqls) {
+                    sqlite3_stmt* stmt = nullptr;
+                    if(prepare_sqlite_stmt(db, sql.c_str(), int(sql.size()), prepare_flags::persistent, &stmt) !=
+                       SQLITE_OK) {
+                        continue;
+                    }
+                    if(cache) {
+                        cache->put(stmt);
+                    } else {
+                        sqlite3_finalize(stmt);
+                    }
+                }
+            }
+
+            /**
+             *  The statement cache or nullptr. Statements keep the returned one, it may be replaced meanwhile.
+             */
+            std::shared_ptr<statement_cache> get_statement_cache() const {
+                std::lock_guard<std::mutex> lock{this->statementCacheMutex};
+                return this->statementCache;
             }
 
             void delete_function_impl(const std::string& name,
-                                      std::vector<std::unique_ptr<user_defined_function_base>>& functionsVector) const {
+                                      std::vector<std::shared_ptr<user_defined_function_base>>& functionsVector) {
                 auto it = find_if(functionsVector.begin(), functionsVector.end(), [&name](auto& functionPointer) {
                     return functionPointer->name == name;
                 });
@@ -623,8 +2179,7 @@ namespace sqlite_orm {
                     functionsVector.erase(it);
                     it = functionsVector.end();
 
-                    if(this->connection->retain_count() > 0) {
-                        sqlite3* db = this->connection->get();
+                    this->for_each_opened_connection([&name](sqlite3* db) {
                         auto resultCode = sqlite3_create_function_v2(db,
                                                                      name.c_str(),
                                                                      0,
@@ -637,7 +2192,7 @@ namespace sqlite_orm {
                         if(resultCode != SQLITE_OK) {
                             throw_translated_sqlite_error(db);
                         }
-                    }
+                    });
                 } else {
                     throw std::system_error{orm_error_code::function_not_found};
                 }
@@ -647,7 +2202,7 @@ namespace sqlite_orm {
                 auto resultCode = sqlite3_create_function_v2(db,
                                                              function.name.c_str(),
                                                              function.argumentsCount,
-                                                             SQLITE_UTF8,
+                                                             SQLITE_UTF8 | function.flags,
                                                              &function,
                                                              scalar_function_callback,
                                                              nullptr,
@@ -659,10 +2214,28 @@ namespace sqlite_orm {
             }
 
             void try_to_create_function(sqlite3* db, user_defined_aggregate_function_t& function) {
+#if SQLITE_VERSION_NUMBER >= 3025000
+                if(function.inverse) {
+                    auto resultCode = sqlite3_create_window_function(db,
+                                                                     function.name.c_str(),
+                                                                     function.argumentsCount,
+                                                                     SQLITE_UTF8 | function.flags,
+                                                                     &function,
+                                                                     aggregate_function_step_callback,
+                                                                     aggregate_function_final_callback,
+                                                                     aggregate_function_value_callback,
+                                                                     aggregate_function_inverse_callback,
+                                                                     nullptr);
+                    if(resultCode != SQLITE_OK) {
+                        throw_translated_sqlite_error(resultCode);
+                    }
+                    return;
+                }
+#endif
                 auto resultCode = sqlite3_create_function(db,
                                                           function.name.c_str(),
                                                           function.argumentsCount,
-                                                          SQLITE_UTF8,
+                                                          SQLITE_UTF8 | function.flags,
                                                           &function,
                                                           nullptr,
                                                           aggregate_function_step_callback,
@@ -684,6 +2257,46 @@ namespace sqlite_orm {
                 functionPointer->step(context, *aggregateContextIntPointer, argsCount, values);
             }
 
+            template<class F, std::enable_if_t<is_window_function_v<F>, bool> = true>
+            static void set_window_function_calls(user_defined_aggregate_function_t& function) {
+                using args_tuple = typename callable_arguments<F>::args_tuple;
+                function.inverse = [](sqlite3_context*, void* functionVoidPointer, int argsCount, sqlite3_value** values) {
+                    auto& function = *static_cast<F*>(functionVoidPointer);
+                    args_tuple argsTuple;
+                    values_to_tuple{}(values, argsTuple, argsCount);
+                    call(function, &F::inverse, move(argsTuple));
+                };
+                function.valueCall = [](sqlite3_context* context, void* functionVoidPointer) {
+                    auto& function = *static_cast<F*>(functionVoidPointer);
+                    auto result = function.value();
+                    statement_binder<decltype(result)>().result(context, result);
+                };
+            }
+
+            template<class F, std::enable_if_t<!is_window_function_v<F>, bool> = true>
+            static void set_window_function_calls(user_defined_aggregate_function_t&) {}
+
+            static void
+            aggregate_function_inverse_callback(sqlite3_context* context, int argsCount, sqlite3_value** values) {
+                auto functionVoidPointer = sqlite3_user_data(context);
+                auto functionPointer = static_cast<user_defined_aggregate_function_t*>(functionVoidPointer);
+                auto aggregateContextVoidPointer = sqlite3_aggregate_context(context, sizeof(int**));
+                auto aggregateContextIntPointer = static_cast<int**>(aggregateContextVoidPointer);
+                functionPointer->inverse(context, *aggregateContextIntPointer, argsCount, values);
+            }
+
+            static void aggregate_function_value_callback(sqlite3_context* context) {
+                auto functionVoidPointer = sqlite3_user_data(context);
+                auto functionPointer = static_cast<user_defined_aggregate_function_t*>(functionVoidPointer);
+                auto aggregateContextVoidPointer = sqlite3_aggregate_context(context, sizeof(int**));
+                auto aggregateContextIntPointer = static_cast<int**>(aggregateContextVoidPointer);
+                //  the frame may be empty before any row has been added to it
+                if(*aggregateContextIntPointer == nullptr) {
+                    *aggregateContextIntPointer = functionPointer->create();
+                }
+                functionPointer->valueCall(context, *aggregateContextIntPointer);
+            }
+
             static void aggregate_function_final_callback(sqlite3_context* context) {
                 auto functionVoidPointer = sqlite3_user_data(context);
                 auto functionPointer = static_cast<user_defined_aggregate_function_t*>(functionVoidPointer);
@@ -696,12 +2309,16 @@ namespace sqlite_orm {
             static void scalar_function_callback(sqlite3_context* context, int argsCount, sqlite3_value** values) {
                 auto functionVoidPointer = sqlite3_user_data(context);
                 auto functionPointer = static_cast<user_defined_scalar_function_t*>(functionVoidPointer);
-                std::unique_ptr<int, void (*)(int*)> callablePointer(functionPointer->create(),
-                                                                     functionPointer->destroy);
                 if(functionPointer->argumentsCount != -1 && functionPointer->argumentsCount != argsCount) {
                     throw std::system_error{orm_error_code::arguments_count_does_not_match};
                 }
-                functionPointer->run(context, functionPointer, argsCount, values);
+                if(functionPointer->instance) {
+                    functionPointer->run(context, functionPointer->instance.get(), argsCount, values);
+                    return;
+                }
+                std::unique_ptr<int, void (*)(int*)> callablePointer(functionPointer->create(),
+                                                                     functionPointer->destroy);
+                functionPointer->run(context, callablePointer.get(), argsCount, values);
             }
 
             template<class F>
@@ -717,17 +2334,166 @@ namespace sqlite_orm {
                 return result;
             }
 
-            void drop_table_internal(sqlite3* db, const std::string& tableName) {
+            /**
+             *  Runs `PRAGMA optimize` with `auto_optimize.analysis_limit` and restores the former limit.
+             *  Optimizing is best effort, so errors (e.g. SQLITE_BUSY) are ignored. Read-only connections
+             *  can't store statistics.
+             */
+            void optimize_connection(sqlite3* db, int mask) {
+                if(sqlite3_db_readonly(db, "main") == 1) {
+                    return;
+                }
+                try {
+                    int analysisLimit = 0;
+                    perform_exec(db, "PRAGMA analysis_limit", extract_single_value<int>, &analysisLimit);
+                    this->pragma.set_pragma("analysis_limit", this->auto_optimize.analysis_limit, db);
+                    if(!mask) {
+                        perform_void_exec(db, "PRAGMA optimize");
+                    } else if(sqlite3_libversion_number() >= 3046000) {
+                        this->pragma.set_pragma("optimize", mask, db);
+                    } else {
+                        //  older versions ignore 0x10000 and optimize only tables this connection queried
+                        perform_void_exec(db, "ANALYZE");
+                    }
+                    this->pragma.set_pragma("analysis_limit", analysisLimit, db);
+                } catch(const std::system_error&) {
+                    //  statistics stay as they are
+                }
+            }
+
+            void optimize_before_close(sqlite3* db) {
+                if(this->auto_optimize.on_close && !this->inMemory) {
+                    this->optimize_connection(db, 0);
+                }
+            }
+
+            void attach_database(sqlite3* db, const std::string& filename, const std::string& schemaName) {
+                std::stringstream ss;
+                ss << "ATTACH DATABASE " << quote_string_literal(filename) << " AS " << streaming_identifier(schemaName)
+                   << std::flush;
+                perform_void_exec(db, ss.str());
+            }
+
+            void drop_table_internal(sqlite3* db, const std::string& tableName, const std::string& schemaName = {}) {
                 std::stringstream ss;
-                ss << "DROP TABLE " << streaming_identifier(tableName) << std::flush;
+                ss << "DROP TABLE " << streaming_identifier(schemaName, tableName, std::string{}) << std::flush;
                 perform_void_exec(db, ss.str());
+                this->schemaCache.invalidate();
             }
 
+#ifdef SQLITE_ENABLE_RTREE
+            static int rtree_query_callback(sqlite3_rtree_query_info* info) {
+                auto& function = *static_cast<rtree_query_function*>(info->pContext);
+                try {
+                    return function(info);
+                } catch(...) {
+                    return SQLITE_ERROR;
+                }
+            }
+
+            static void
+            register_rtree_query_function(sqlite3* db, const std::string& name, rtree_query_function& function) {
+                if(sqlite3_rtree_query_callback(db, name.c_str(), rtree_query_callback, &function, nullptr) !=
+                   SQLITE_OK) {
+                    throw_translated_sqlite_error(db);
+                }
+            }
+#endif  //  SQLITE_ENABLE_RTREE
+
             static int collate_callback(void* arg, int leftLen, const void* lhs, int rightLen, const void* rhs) {
                 auto& f = *(collating_function*)arg;
                 return f(leftLen, lhs, rightLen, rhs);
             }
 
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+            template<class C>
+            using string_view_collation_t =
+                decltype(std::declval<C&>()(std::declval<std::string_view>(), std::declval<std::string_view>()));
+#endif
+
+            /**
+             *  The comparison function of `create_collation<C>()`, called with the C it created as `arg`.
+             */
+            template<class C>
+            static int collate_trampoline(void* arg, int leftLen, const void* lhs, int rightLen, const void* rhs) {
+                auto& collatingObject = *static_cast<C*>(arg);
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+                return static_if<polyfill::is_detected_v<string_view_collation_t, C>>(
+                    [leftLen, lhs, rightLen, rhs](auto& object) {
+                        return int(object(std::string_view{static_cast<const char*>(lhs), size_t(leftLen)},
+                                                   std::string_view{static_cast<const char*>(rhs), size_t(rightLen)}));
+                    },
+                    [leftLen, lhs, rightLen, rhs](auto& object) {
+                        return int(object(leftLen, lhs, rightLen, rhs));
+                    })(collatingObject);
+#else
+                return collatingObject(leftLen, lhs, rightLen, rhs);
+#endif
+            }
+
+            /**
+             *  Stores the collation `entry` as `name`, or removes the collation if it has no object, and
+             *  (un)registers it with every open connection.
+             */
+            void register_collation(const std::string& name, collation_entry entry) {
+                collation_entry* registered = nullptr;
+                if(entry.object) {
+                    registered = &(this->collatingFunctions[name] = std::move(entry));
+                } else {
+                    this->collatingFunctions.erase(name);
+                }
+
+                //  create collations if db is open
+                this->for_each_opened_connection([&name, registered](sqlite3* db) {
+                    auto resultCode = sqlite3_create_collation(db,
+                                                               name.c_str(),
+                                                               SQLITE_UTF8,
+                                                               registered ? registered->object.get() : nullptr,
+                                                               registered ? registered->callback : nullptr);
+                    if(resultCode != SQLITE_OK) {
+                        throw_translated_sqlite_error(db);
+                    }
+                });
+            }
+
+            using deadline_type = std::chrono::steady_clock::time_point;
+
+            /**
+             *  Deadline of the innermost `with_deadline` call running on this thread.
+             */
+            static deadline_type& thread_deadline() {
+                thread_local deadline_type deadline = deadline_type::max();
+                return deadline;
+            }
+
+            struct deadline_restorer {
+                deadline_type previous;
+
+                ~deadline_restorer() {
+                    thread_deadline() = this->previous;
+                }
+            };
+
+            static void set_deadline_handler(sqlite3* db) {
+                //  the number of virtual machine instructions between two checks, the check itself is cheap
+                sqlite3_progress_handler(db, 100, deadline_callback, nullptr);
+            }
+
+            static int deadline_callback(void*) {
+                const auto deadline = thread_deadline();
+                return deadline != deadline_type::max() && std::chrono::steady_clock::now() >= deadline;
+            }
+
+            execute_tracer make_execute_tracer(sqlite3_stmt* stmt, execute_phase first = execute_phase::bind) {
+#ifdef SQLITE_ORM_ENABLE_EXECUTE_TRACING
+                return {this->on_execute_event, stmt, first};
+#else
+                (void)stmt;
+                (void)first;
+                return {};
+#endif
+            }
+
             static int busy_handler_callback(void* selfPointer, int triesCount) {
                 auto& storage = *static_cast<storage_base*>(selfPointer);
                 if(storage._busy_handler) {
@@ -737,6 +2503,200 @@ namespace sqlite_orm {
                 }
             }
 
+            /**
+             *  Busy handler of `enable_busy_statistics()`, called with the entry of its connection.
+             */
+            static int busy_statistics_callback(void* connectionPointer, int triesCount) {
+                auto& connection = *static_cast<busy_recorder::busy_connection*>(connectionPointer);
+                auto& storage = *static_cast<storage_base*>(connection.owner);
+                const auto start = std::chrono::steady_clock::now();
+                const int retry =
+                    storage._busy_handler
+                        ? storage._busy_handler(triesCount)
+                        : sleep_for_busy_timeout(storage.busyStatistics.timeout(connection), triesCount);
+                const auto elapsed =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                sqlite3_stmt* stmt = busy_statement(connection.db);
+                storage.busyStatistics.record(connection, stmt, triesCount, retry, elapsed);
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(stmt) {
+                    std::lock_guard<std::mutex> lock{storage.profileMutex};
+                    auto it = storage.runningStatements.find(stmt);
+                    if(it != storage.runningStatements.end()) {
+                        ++it->second.busyCallbacks;
+                        it->second.busyWait += elapsed;
+                    }
+                }
+#endif
+                return retry;
+            }
+
+            /**
+             *  The entry of `db` in the busy statistics, made with the busy timeout `db` has the first time.
+             */
+            busy_recorder::busy_connection& busy_connection_of(sqlite3* db) {
+                if(auto connection = this->busyStatistics.find(db)) {
+                    return *connection;
+                }
+                int timeout = 0;
+                perform_exec(db, "PRAGMA busy_timeout", extract_single_value<int>, &timeout);
+                return this->busyStatistics.connection(db, this, timeout);
+            }
+
+            /**
+             *  Installs the busy handler `db` needs: the counting one, the one of `busy_handler()`, the busy
+             *  timeout the counting one waited for, or none.
+             */
+            int set_busy_handler(sqlite3* db) {
+                if(this->busyStatistics.enabled()) {
+                    return sqlite3_busy_handler(db, busy_statistics_callback, &this->busy_connection_of(db));
+                }
+                if(this->_busy_handler) {
+                    return sqlite3_busy_handler(db, busy_handler_callback, this);
+                }
+                if(auto connection = this->busyStatistics.find(db)) {
+                    return sqlite3_busy_timeout(db, this->busyStatistics.timeout(*connection));
+                }
+                return sqlite3_busy_handler(db, nullptr, nullptr);
+            }
+
+            void set_lookaside(sqlite3* db) {
+                auto rc = sqlite3_db_config(db,
+                                            SQLITE_DBCONFIG_LOOKASIDE,
+                                            nullptr,
+                                            this->lookasideSlotSize,
+                                            this->lookasideSlotsCount);
+                if(rc != SQLITE_OK) {
+                    throw_translated_sqlite_error(rc);
+                }
+            }
+
+            bool wal_hook_needed() {
+                std::lock_guard<std::mutex> lock{this->checkpointSchedulerMutex};
+                return this->_wal_commit_handler || this->checkpointScheduler;
+            }
+
+            void set_wal_hook(sqlite3* db) {
+                if(this->wal_hook_needed()) {
+                    sqlite3_wal_hook(db, wal_hook_callback, this);
+                } else {
+                    sqlite3_wal_autocheckpoint(db, this->autocheckpoint_pages());
+                }
+            }
+
+            void reset_wal_hooks() {
+                if(this->wal_hook_needed()) {
+                    this->for_each_opened_connection([this](sqlite3* db) {
+                        this->set_wal_hook(db);
+                    });
+                }
+            }
+
+            int autocheckpoint_pages() const {
+                //  SQLITE_DEFAULT_WAL_AUTOCHECKPOINT
+                return this->pragma._wal_autocheckpoint != -1 ? this->pragma._wal_autocheckpoint : 1000;
+            }
+
+            static int wal_hook_callback(void* selfPointer, sqlite3* db, const char* schema, int pages) {
+                auto& storage = *static_cast<storage_base*>(selfPointer);
+                if(storage._wal_commit_handler) {
+                    storage._wal_commit_handler(schema, pages);
+                }
+                {
+                    std::lock_guard<std::mutex> lock{storage.checkpointSchedulerMutex};
+                    if(storage.checkpointScheduler) {
+                        storage.checkpointScheduler->committed(pages);
+                        return SQLITE_OK;
+                    }
+                }
+                //  what the default hook of automatic checkpoints does
+                const int autocheckpoint = storage.autocheckpoint_pages();
+                if(autocheckpoint > 0 && pages >= autocheckpoint) {
+                    sqlite3_wal_checkpoint(db, schema);
+                }
+                return SQLITE_OK;
+            }
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+            void set_profile_trace(sqlite3* db) {
+                if(this->_profile_handler || this->slowQueries.enabled() || this->indexAdvisor.enabled()) {
+                    sqlite3_trace_v2(db,
+                                     SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE,
+                                     profile_callback,
+                                     this);
+                } else {
+                    sqlite3_trace_v2(db, 0, nullptr, nullptr);
+                }
+            }
+
+            static int profile_callback(unsigned eventType, void* selfPointer, void* p, void* x) {
+                auto& storage = *static_cast<storage_base*>(selfPointer);
+                auto stmt = static_cast<sqlite3_stmt*>(p);
+                switch(eventType) {
+                    case SQLITE_TRACE_STMT: {
+                        //  trigger programs are reported with their SQL as a comment, they belong to the statement
+                        if(strncmp(static_cast<const char*>(x), "--", 2) != 0) {
+                            std::lock_guard<std::mutex> lock{storage.profileMutex};
+                            storage.runningStatements[stmt] = {0, internal::thread_io_counters()};
+                        }
+                    } break;
+                    case SQLITE_TRACE_ROW: {
+                        std::lock_guard<std::mutex> lock{storage.profileMutex};
+                        ++storage.runningStatements[stmt].rows;
+                    } break;
+                    case SQLITE_TRACE_PROFILE: {
+                        statement_profile profile;
+                        {
+                            std::lock_guard<std::mutex> lock{storage.profileMutex};
+                            auto it = storage.runningStatements.find(stmt);
+                            if(it != storage.runningStatements.end()) {
+                                profile.rows = it->second.rows;
+                                profile.io = internal::thread_io_counters();
+                                profile.io -= it->second.io;
+                                profile.busy_callbacks = it->second.busyCallbacks;
+                                profile.busy_wait = it->second.busyWait;
+                                storage.runningStatements.erase(it);
+                            }
+                        }
+                        profile.duration = std::chrono::nanoseconds{*static_cast<sqlite3_int64*>(x)};
+                        const bool slow = storage.slowQueries.should_record(profile.duration);
+                        const bool advising = storage.indexAdvisor.enabled();
+                        if(!storage._profile_handler && !slow && !advising) {
+                            break;
+                        }
+                        if(char* expandedSql = sqlite3_expanded_sql(stmt)) {
+                            profile.expanded_sql = expandedSql;
+                            sqlite3_free(expandedSql);
+                        }
+#if SQLITE_VERSION_NUMBER >= 3026000 and defined(SQLITE_ENABLE_NORMALIZE)
+                        if(const char* normalizedSql = sqlite3_normalized_sql(stmt)) {
+                            profile.normalized_sql = normalizedSql;
+                        }
+#else
+                        if(const char* sql = sqlite3_sql(stmt)) {
+                            profile.normalized_sql = sql;
+                        }
+#endif
+                        if(storage._profile_handler) {
+                            storage._profile_handler(profile);
+                        }
+                        if(slow) {
+                            storage.slowQueries.record(profile);
+                        }
+                        //  the SQL text as prepared, which stays valid SQL to explain
+                        if(advising) {
+                            if(const char* sql = sqlite3_sql(stmt)) {
+                                //  statements of the cache have their counters reset after every run
+                                storage.indexAdvisor.record(sql,
+                                                            sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 0));
+                            }
+                        }
+                    } break;
+                }
+                return 0;
+            }
+#endif
+
             bool calculate_remove_add_columns(std::vector<const table_xinfo*>& columnsToAdd,
                                               std::vector<table_xinfo>& storageTableInfo,
                                               std::vector<table_xinfo>& dbTableInfo) const {
@@ -777,14 +2737,105 @@ namespace sqlite_orm {
                 return notEqual;
             }
 
+            //  before the connections whose hooks refer to them
+            object_cache_registry objectCaches;
+            key_filter_registry keyFilters;
+            change_streams changeStreams;
+            query_cache queryResults;
+            audit_log auditLog;
+            data_version_watch dataVersions;
+            change_hooks changeHooks;
             const bool inMemory;
             bool isOpenedForever = false;
+            std::atomic<size_t> openedConnectionsCount{0};
             std::unique_ptr<connection_holder> connection;
-            std::map<std::string, collating_function> collatingFunctions;
+            std::unique_ptr<connection_pool> pool;
+            std::shared_ptr<statement_cache> statementCache;
+            mutable std::mutex statementCacheMutex;
+            static_sql_cache staticSqls;
+            std::unique_ptr<storage_executor> executor;
+            std::mutex executorMutex;
+            std::map<std::string, collation_entry> collatingFunctions;
+#ifdef SQLITE_ENABLE_RTREE
+            std::map<std::string, rtree_query_function> rtreeQueryFunctions;
+#endif  //  SQLITE_ENABLE_RTREE
+            bool vectorFunctions = false;
+            std::vector<std::pair<std::string, std::shared_ptr<const virtual_table_module_base>>> virtualTableModules;
+            std::vector<std::string> openPreparedSqls;  //  SQL of the statements registered by prepare_on_open()
+            std::vector<std::pair<std::string, std::string>> attachedDatabases;  //  schema name, filename
             const int cachedForeignKeysCount;
             std::function<int(int)> _busy_handler;
-            std::vector<std::unique_ptr<user_defined_function_base>> scalarFunctions;
-            std::vector<std::unique_ptr<user_defined_function_base>> aggregateFunctions;
+            busy_recorder busyStatistics;
+            schema_cache schemaCache;
+            int lookasideSlotSize = -1;
+            int lookasideSlotsCount = 0;
+            std::function<void(const std::string&, int)> _wal_commit_handler;
+            std::unique_ptr<checkpoint_scheduler> checkpointScheduler;
+            std::mutex checkpointSchedulerMutex;
+            std::atomic<bool> deadlinesEnabled{false};
+            std::function<void(const statement_profile&)> _profile_handler;
+            struct running_statement {
+                sqlite3_int64 rows = 0;
+                io_counters io;
+                size_t busyCallbacks = 0;
+                std::chrono::nanoseconds busyWait{0};
+            };
+            std::unordered_map<sqlite3_stmt*, running_statement> runningStatements;
+            std::mutex profileMutex;
+            slow_query_recorder slowQueries;
+            index_advisor_recorder indexAdvisor;
+            //  shared with forks
+            std::vector<std::shared_ptr<user_defined_function_base>> scalarFunctions;
+            std::vector<std::shared_ptr<user_defined_function_base>> aggregateFunctions;
+            std::unique_ptr<memory_pressure_listener> memoryPressureListener;
+
+            friend struct pragma_t;
+            friend struct limit_accessor;
         };
+
+        inline connection_ref pragma_t::get_connection() const {
+            return this->storage->get_connection();
+        }
+
+        inline std::shared_ptr<const schema_snapshot> pragma_t::get_schema_snapshot(sqlite3* db) const {
+            return this->storage->cached_schema_snapshot(db);
+        }
+
+        inline void pragma_t::busy_timeout(int value) {
+            this->storage->busy_timeout(value);
+        }
+
+        inline std::shared_ptr<statement_cache> pragma_t::get_statement_cache() const {
+            return this->storage->get_statement_cache();
+        }
+
+        inline pragma_t::pragma_statement::pragma_statement(std::shared_ptr<statement_cache> cache_,
+                                                            sqlite3* db,
+                                                            const std::string& sql) :
+            cache{std::move(cache_)} {
+            if(this->cache) {
+                this->stmt = this->cache->take(db, sql);
+            }
+            if(!this->stmt &&
+               prepare_sqlite_stmt(db,
+                                   sql.c_str(),
+                                   int(sql.size()),
+                                   this->cache ? prepare_flags::persistent : prepare_flags::none,
+                                   &this->stmt) != SQLITE_OK) {
+                throw_translated_sqlite_error(db);
+            }
+        }
+
+        inline pragma_t::pragma_statement::~pragma_statement() {
+            if(this->cache) {
+                this->cache->put(this->stmt);
+            } else {
+                sqlite3_finalize(this->stmt);
+            }
+        }
+
+        inline connection_ref limit_accessor::get_connection() const {
+            return this->storage->get_connection();
+        }
     }
 }
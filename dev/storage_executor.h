@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>  //  std::condition_variable
+#include <deque>  //  std::deque
+#include <functional>  //  std::function
+#include <future>  //  std::packaged_task, std::future
+#include <memory>  //  std::make_shared
+#include <mutex>  //  std::mutex, std::unique_lock, std::lock_guard
+#include <thread>  //  std::thread
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  A fixed set of threads running database calls submitted with `storage.async()`,
+         *  so threads that must not block (e.g. event loops) never wait for `sqlite3_step`.
+         *  Tasks are run in the order they were submitted. The destructor runs all queued tasks.
+         */
+        struct storage_executor {
+
+            storage_executor(int threadsCount) {
+                for(int i = 0; i < (threadsCount > 0 ? threadsCount : 1); ++i) {
+                    this->threads.emplace_back([this] {
+                        this->run();
+                    });
+                }
+            }
+
+            storage_executor(const storage_executor&) = delete;
+            storage_executor& operator=(const storage_executor&) = delete;
+
+            ~storage_executor() {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->stopping = true;
+                }
+                this->changed.notify_all();
+                for(auto& thread: this->threads) {
+                    thread.join();
+                }
+            }
+
+            template<class F>
+            auto submit(F f) -> std::future<decltype(f())> {
+                auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::move(f));
+                auto future = task->get_future();
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->tasks.emplace_back([task] {
+                        (*task)();
+                    });
+                }
+                this->changed.notify_one();
+                return future;
+            }
+
+            int threads_count() const {
+                return int(this->threads.size());
+            }
+
+          protected:
+            void run() {
+                for(;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock{this->mutex};
+                        this->changed.wait(lock, [this] {
+                            return this->stopping || !this->tasks.empty();
+                        });
+                        if(this->tasks.empty()) {
+                            return;
+                        }
+                        task = std::move(this->tasks.front());
+                        this->tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            std::vector<std::thread> threads;
+            std::deque<std::function<void()>> tasks;
+            bool stopping = false;
+            std::mutex mutex;
+            std::condition_variable changed;
+        };
+    }
+}
@@ -58,6 +58,32 @@ namespace sqlite_orm {
                 empty_callable<std::string>())(dbObjects);
         }
 
+        /**
+         *  Schema of the mapped table of type Lookup, empty if it is in the main database or not a table.
+         */
+        template<class Lookup, class DBOs, satisfies<is_db_objects, DBOs> = true>
+        std::string lookup_table_schema_name(const DBOs& dbObjects) {
+            return static_if<is_mapped_v<DBOs, Lookup>>(
+                [](const auto& dbObjects) {
+                    return pick_table<Lookup>(dbObjects).schema_name;
+                },
+                empty_callable<std::string>())(dbObjects);
+        }
+
+        /**
+         *  Schema of the mapped table named `tableName`, empty if it is in the main database.
+         */
+        template<class DBOs, satisfies<is_db_objects, DBOs> = true>
+        std::string find_table_schema_name(const DBOs& dbObjects, const std::string& tableName) {
+            std::string res;
+            iterate_tuple<true>(dbObjects, tables_index_sequence<DBOs>{}, [&tableName, &res](const auto& table) {
+                if(table.name == tableName) {
+                    res = table.schema_name;
+                }
+            });
+            return res;
+        }
+
         /**
          *  Find column name by its type and member pointer.
          */
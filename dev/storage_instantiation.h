@@ -0,0 +1,113 @@
+#pragma once
+
+#include <type_traits>  //  std::is_same
+#include <tuple>  //  std::tuple_element_t
+
+#include "storage.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Type of the I-th database object, i.e. table, index or trigger, of the storage S.
+         */
+        template<class S, size_t I>
+        using storage_db_object_t = std::tuple_element_t<I, typename S::db_objects_type>;
+    }
+}
+
+/**
+ *  `storage_t<...>` spelled out as a template-id, as explicit instantiations require, from the storage type S
+ *  having N database objects.
+ */
+#define SQLITE_ORM_STORAGE_TEMPLATE_ID(S, N) ::sqlite_orm::internal::storage_t<SQLITE_ORM_STORAGE_DB_OBJECTS_##N(S)>
+
+/**
+ *  Declares that the storage type S with N database objects, up to 64, is explicitly instantiated in another
+ *  translation unit by `SQLITE_ORM_INSTANTIATE_STORAGE(S, N)`, so that this one doesn't instantiate its
+ *  non-template member functions like `sync_schema()` again. Member function templates like `get_all<O>()`
+ *  are still instantiated where they are used. Use it at global scope after the definition of S, typically in
+ *  the header defining the storage type:
+ *  @example: inline auto make_app_storage(const std::string& path) { return make_storage(path, ...); }
+ *            using AppStorage = decltype(make_app_storage(""));
+ *            SQLITE_ORM_EXTERN_STORAGE(AppStorage, 3);
+ *  and in exactly one source file:
+ *            SQLITE_ORM_INSTANTIATE_STORAGE(AppStorage, 3);
+ *  Compilers may still instantiate inline member functions they want to inline in optimized builds.
+ */
+#define SQLITE_ORM_EXTERN_STORAGE(S, N)                                                                                \
+    static_assert(std::is_same<S, SQLITE_ORM_STORAGE_TEMPLATE_ID(S, N)>::value,                                       \
+                  #S " doesn't have " #N " database objects");                                                         \
+    extern template class SQLITE_ORM_STORAGE_TEMPLATE_ID(S, N)
+
+/**
+ *  Explicitly instantiates the storage type S with N database objects, see `SQLITE_ORM_EXTERN_STORAGE`.
+ */
+#define SQLITE_ORM_INSTANTIATE_STORAGE(S, N) template class SQLITE_ORM_STORAGE_TEMPLATE_ID(S, N)
+
+#define SQLITE_ORM_STORAGE_DB_OBJECT(S, I) ::sqlite_orm::internal::storage_db_object_t<S, I>
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_1(S) SQLITE_ORM_STORAGE_DB_OBJECT(S, 0)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_2(S) SQLITE_ORM_STORAGE_DB_OBJECTS_1(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 1)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_3(S) SQLITE_ORM_STORAGE_DB_OBJECTS_2(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 2)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_4(S) SQLITE_ORM_STORAGE_DB_OBJECTS_3(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 3)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_5(S) SQLITE_ORM_STORAGE_DB_OBJECTS_4(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 4)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_6(S) SQLITE_ORM_STORAGE_DB_OBJECTS_5(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 5)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_7(S) SQLITE_ORM_STORAGE_DB_OBJECTS_6(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 6)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_8(S) SQLITE_ORM_STORAGE_DB_OBJECTS_7(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 7)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_9(S) SQLITE_ORM_STORAGE_DB_OBJECTS_8(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 8)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_10(S) SQLITE_ORM_STORAGE_DB_OBJECTS_9(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 9)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_11(S) SQLITE_ORM_STORAGE_DB_OBJECTS_10(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 10)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_12(S) SQLITE_ORM_STORAGE_DB_OBJECTS_11(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 11)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_13(S) SQLITE_ORM_STORAGE_DB_OBJECTS_12(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 12)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_14(S) SQLITE_ORM_STORAGE_DB_OBJECTS_13(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 13)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_15(S) SQLITE_ORM_STORAGE_DB_OBJECTS_14(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 14)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_16(S) SQLITE_ORM_STORAGE_DB_OBJECTS_15(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 15)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_17(S) SQLITE_ORM_STORAGE_DB_OBJECTS_16(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 16)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_18(S) SQLITE_ORM_STORAGE_DB_OBJECTS_17(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 17)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_19(S) SQLITE_ORM_STORAGE_DB_OBJECTS_18(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 18)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_20(S) SQLITE_ORM_STORAGE_DB_OBJECTS_19(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 19)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_21(S) SQLITE_ORM_STORAGE_DB_OBJECTS_20(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 20)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_22(S) SQLITE_ORM_STORAGE_DB_OBJECTS_21(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 21)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_23(S) SQLITE_ORM_STORAGE_DB_OBJECTS_22(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 22)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_24(S) SQLITE_ORM_STORAGE_DB_OBJECTS_23(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 23)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_25(S) SQLITE_ORM_STORAGE_DB_OBJECTS_24(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 24)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_26(S) SQLITE_ORM_STORAGE_DB_OBJECTS_25(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 25)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_27(S) SQLITE_ORM_STORAGE_DB_OBJECTS_26(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 26)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_28(S) SQLITE_ORM_STORAGE_DB_OBJECTS_27(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 27)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_29(S) SQLITE_ORM_STORAGE_DB_OBJECTS_28(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 28)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_30(S) SQLITE_ORM_STORAGE_DB_OBJECTS_29(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 29)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_31(S) SQLITE_ORM_STORAGE_DB_OBJECTS_30(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 30)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_32(S) SQLITE_ORM_STORAGE_DB_OBJECTS_31(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 31)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_33(S) SQLITE_ORM_STORAGE_DB_OBJECTS_32(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 32)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_34(S) SQLITE_ORM_STORAGE_DB_OBJECTS_33(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 33)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_35(S) SQLITE_ORM_STORAGE_DB_OBJECTS_34(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 34)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_36(S) SQLITE_ORM_STORAGE_DB_OBJECTS_35(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 35)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_37(S) SQLITE_ORM_STORAGE_DB_OBJECTS_36(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 36)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_38(S) SQLITE_ORM_STORAGE_DB_OBJECTS_37(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 37)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_39(S) SQLITE_ORM_STORAGE_DB_OBJECTS_38(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 38)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_40(S) SQLITE_ORM_STORAGE_DB_OBJECTS_39(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 39)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_41(S) SQLITE_ORM_STORAGE_DB_OBJECTS_40(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 40)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_42(S) SQLITE_ORM_STORAGE_DB_OBJECTS_41(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 41)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_43(S) SQLITE_ORM_STORAGE_DB_OBJECTS_42(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 42)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_44(S) SQLITE_ORM_STORAGE_DB_OBJECTS_43(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 43)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_45(S) SQLITE_ORM_STORAGE_DB_OBJECTS_44(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 44)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_46(S) SQLITE_ORM_STORAGE_DB_OBJECTS_45(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 45)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_47(S) SQLITE_ORM_STORAGE_DB_OBJECTS_46(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 46)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_48(S) SQLITE_ORM_STORAGE_DB_OBJECTS_47(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 47)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_49(S) SQLITE_ORM_STORAGE_DB_OBJECTS_48(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 48)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_50(S) SQLITE_ORM_STORAGE_DB_OBJECTS_49(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 49)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_51(S) SQLITE_ORM_STORAGE_DB_OBJECTS_50(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 50)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_52(S) SQLITE_ORM_STORAGE_DB_OBJECTS_51(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 51)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_53(S) SQLITE_ORM_STORAGE_DB_OBJECTS_52(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 52)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_54(S) SQLITE_ORM_STORAGE_DB_OBJECTS_53(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 53)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_55(S) SQLITE_ORM_STORAGE_DB_OBJECTS_54(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 54)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_56(S) SQLITE_ORM_STORAGE_DB_OBJECTS_55(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 55)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_57(S) SQLITE_ORM_STORAGE_DB_OBJECTS_56(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 56)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_58(S) SQLITE_ORM_STORAGE_DB_OBJECTS_57(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 57)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_59(S) SQLITE_ORM_STORAGE_DB_OBJECTS_58(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 58)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_60(S) SQLITE_ORM_STORAGE_DB_OBJECTS_59(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 59)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_61(S) SQLITE_ORM_STORAGE_DB_OBJECTS_60(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 60)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_62(S) SQLITE_ORM_STORAGE_DB_OBJECTS_61(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 61)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_63(S) SQLITE_ORM_STORAGE_DB_OBJECTS_62(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 62)
+#define SQLITE_ORM_STORAGE_DB_OBJECTS_64(S) SQLITE_ORM_STORAGE_DB_OBJECTS_63(S), SQLITE_ORM_STORAGE_DB_OBJECT(S, 63)
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <algorithm>  //  std::max
+
+#include "busy_statistics.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  `sqlite3_db_status` values of the connections of a storage. Values of pooled connections are summed up
+     *  except high water marks for which the maximum is taken. https://sqlite.org/c3ref/c_dbstatus_options.html
+     */
+    struct connection_status {
+        int cache_used = 0;
+        int cache_hit = 0;
+        int cache_miss = 0;
+        int cache_write = 0;
+        int lookaside_used = 0;
+        int lookaside_used_highwater = 0;
+        int lookaside_hit = 0;
+        int lookaside_miss_size = 0;
+        int lookaside_miss_full = 0;
+        int schema_used = 0;
+        int stmt_used = 0;
+    };
+
+    /**
+     *  Process-wide `sqlite3_status64` values shared by all connections.
+     *  https://sqlite.org/c3ref/c_status_malloc_count.html
+     */
+    struct process_status {
+        sqlite3_int64 memory_used = 0;
+        sqlite3_int64 memory_used_highwater = 0;
+        sqlite3_int64 malloc_count = 0;
+        sqlite3_int64 malloc_size_highwater = 0;
+        sqlite3_int64 pagecache_used = 0;
+        sqlite3_int64 pagecache_overflow = 0;
+    };
+
+    /**
+     *  Result of `storage.status()`.
+     */
+    struct storage_status {
+        int connections_count = 0;
+        connection_status connections;
+        process_status process;
+
+        /**
+         *  Lock contention, all zero unless `enable_busy_statistics()` is called.
+         */
+        busy_status busy;
+    };
+
+    namespace internal {
+
+        inline void add_connection_status(connection_status& status, sqlite3* db, bool reset) {
+            const int resetFlag = reset ? 1 : 0;
+            int current = 0;
+            int highwater = 0;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0);
+            status.cache_used += current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_HIT, &current, &highwater, resetFlag);
+            status.cache_hit += current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater, resetFlag);
+            status.cache_miss += current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_WRITE, &current, &highwater, resetFlag);
+            status.cache_write += current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_USED, &current, &highwater, resetFlag);
+            status.lookaside_used += current;
+            status.lookaside_used_highwater = std::max(status.lookaside_used_highwater, highwater);
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_HIT, &current, &highwater, resetFlag);
+            status.lookaside_hit += highwater;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, &current, &highwater, resetFlag);
+            status.lookaside_miss_size += highwater;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, &current, &highwater, resetFlag);
+            status.lookaside_miss_full += highwater;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_SCHEMA_USED, &current, &highwater, 0);
+            status.schema_used += current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_STMT_USED, &current, &highwater, 0);
+            status.stmt_used += current;
+        }
+
+        inline process_status get_process_status(bool reset) {
+            const int resetFlag = reset ? 1 : 0;
+            process_status status;
+            sqlite3_int64 highwater = 0;
+            sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &status.memory_used, &status.memory_used_highwater, resetFlag);
+            sqlite3_status64(SQLITE_STATUS_MALLOC_COUNT, &status.malloc_count, &highwater, resetFlag);
+            sqlite3_status64(SQLITE_STATUS_MALLOC_SIZE, &highwater, &status.malloc_size_highwater, resetFlag);
+            sqlite3_status64(SQLITE_STATUS_PAGECACHE_USED, &status.pagecache_used, &highwater, resetFlag);
+            sqlite3_status64(SQLITE_STATUS_PAGECACHE_OVERFLOW, &status.pagecache_overflow, &highwater, resetFlag);
+            return status;
+        }
+    }
+}
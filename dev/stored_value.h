@@ -0,0 +1,81 @@
+#pragma once
+
+#include <type_traits>  //  std::is_enum, std::is_convertible, std::underlying_type_t, std::enable_if_t
+#include <chrono>  //  std::chrono::duration, std::chrono::time_point
+
+#include "functional/cxx_universal.h"
+#include "functional/cxx_type_traits_polyfill.h"
+
+namespace sqlite_orm {
+    namespace internal {
+
+        template<class E, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_scoped_enum_v = false;
+
+        template<class E>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_scoped_enum_v<E, std::enable_if_t<std::is_enum<E>::value>> =
+            !std::is_convertible<E, std::underlying_type_t<E>>::value;
+
+        /**
+         *  How a value of type T is stored as a value of a type SQLite stores natively, `stored_type`, without
+         *  any parsing or formatting. Specialized for:
+         *  - scoped enums, stored as their underlying integer;
+         *  - `std::chrono::duration`, stored as its count, INTEGER or REAL depending on its representation;
+         *  - `std::chrono::time_point`, stored as the count of its duration since the epoch of its clock, e.g.
+         *    the microseconds since the unix epoch for `time_point<system_clock, microseconds>`.
+         */
+        template<class T, class SFINAE = void>
+        struct stored_value {};
+
+        template<class E>
+        struct stored_value<E, std::enable_if_t<is_scoped_enum_v<E>>> {
+            using stored_type = std::underlying_type_t<E>;
+
+            static stored_type to_stored(E value) {
+                return stored_type(value);
+            }
+
+            static E from_stored(stored_type value) {
+                return E(value);
+            }
+        };
+
+        template<class Rep, class Period>
+        struct stored_value<std::chrono::duration<Rep, Period>, void> {
+            using value_type = std::chrono::duration<Rep, Period>;
+            using stored_type = Rep;
+
+            static stored_type to_stored(const value_type& value) {
+                return value.count();
+            }
+
+            static value_type from_stored(stored_type value) {
+                return value_type{value};
+            }
+        };
+
+        template<class Clock, class Duration>
+        struct stored_value<std::chrono::time_point<Clock, Duration>, void> {
+            using value_type = std::chrono::time_point<Clock, Duration>;
+            using stored_type = typename Duration::rep;
+
+            static stored_type to_stored(const value_type& value) {
+                return value.time_since_epoch().count();
+            }
+
+            static value_type from_stored(stored_type value) {
+                return value_type{Duration{value}};
+            }
+        };
+
+        template<class T, class SFINAE = void>
+        SQLITE_ORM_INLINE_VAR constexpr bool is_stored_value_v = false;
+
+        template<class T>
+        SQLITE_ORM_INLINE_VAR constexpr bool
+            is_stored_value_v<T, polyfill::void_t<typename stored_value<T>::stored_type>> = true;
+
+        template<class T>
+        using is_stored_value = polyfill::bool_constant<is_stored_value_v<T>>;
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <sqlite3.h>
+#include <memory>  //  std::shared_ptr
 #include <string>  //  std::string
 #include <type_traits>  //  std::remove_reference, std::is_same, std::decay
 #include <vector>  //  std::vector
@@ -21,11 +23,15 @@
 #include "constraints.h"
 #include "table_info.h"
 #include "column.h"
+#include "fts5_options.h"
+#include "rtree_options.h"
 
 namespace sqlite_orm {
 
     namespace internal {
 
+        struct virtual_table_module_base;
+
         struct basic_table {
 
             /**
@@ -47,12 +53,118 @@ namespace sqlite_orm {
 
             elements_type elements;
 
+            /**
+             *  Whether the table is created STRICT.
+             */
+            bool is_strict = false;
+
+            /**
+             *  Name of the attached database the table is in, empty for the main database.
+             */
+            std::string schema_name = {};
+
+            /**
+             *  Options of an FTS5 virtual table made by `make_fts5_table()`, null for an ordinary table.
+             */
+            std::shared_ptr<const fts5_options> fts5 = {};
+
+            /**
+             *  Options of an R*Tree virtual table made by `make_rtree_table()`, null for an ordinary table.
+             */
+            std::shared_ptr<const rtree_options> rtree = {};
+
+            /**
+             *  Module of an eponymous virtual table made by `make_virtual_table()`, null for an ordinary table.
+             */
+            std::shared_ptr<const virtual_table_module_base> virtual_module = {};
+
+            /**
+             *  Member of the object holding the rowid of its row, set by `with_rowid_member()`, null without one.
+             */
+            sqlite_int64 object_type::*rowid_member = nullptr;
+
+            /**
+             *  Member mapped to the version column of the table, set by `version_column()`, null without one.
+             */
+            sqlite_int64 object_type::*version_member = nullptr;
+
 #ifndef SQLITE_ORM_AGGREGATE_BASES_SUPPORTED
             table_t(std::string name_, elements_type elements_) : basic_table{move(name_)}, elements{move(elements_)} {}
 #endif
 
             table_t<T, true, Cs...> without_rowid() const {
-                return {this->name, this->elements};
+                table_t<T, true, Cs...> res{this->name, this->elements};
+                res.is_strict = this->is_strict;
+                res.schema_name = this->schema_name;
+                res.fts5 = this->fts5;
+                res.rtree = this->rtree;
+                res.virtual_module = this->virtual_module;
+                res.version_member = this->version_member;
+                return res;
+            }
+
+            /**
+             *  Maps the table to the attached database `schemaName` (see `storage.attach_database()`).
+             *  Statements refer to it as "schemaName"."name" and `sync_schema()` creates it there.
+             *  Table names must be unique across the databases of a storage.
+             */
+            table_t in_schema(std::string schemaName) const {
+                auto res = *this;
+                res.schema_name = move(schemaName);
+                return res;
+            }
+
+            /**
+             *  Makes the table STRICT: SQLite rejects values that can't be converted to the types of the columns
+             *  instead of storing them as they are. Requires SQLite 3.37.0.
+             *  `sync_schema()` recreates an existing table which differs from the mapping in being STRICT or
+             *  WITHOUT ROWID, keeping its rows when called with `preserve = true`.
+             */
+            table_t strict() const {
+                auto res = *this;
+                res.is_strict = true;
+                return res;
+            }
+
+            /**
+             *  Keeps the rowid of the rows in `member`, which isn't a column of the table: reading an object reads
+             *  its rowid too, `insert()` of a non-const object sets it, and `update()`, `update_changed()` and
+             *  `remove()` of an object find its row by rowid, the fastest lookup SQLite has, instead of by primary
+             *  key. Useful for tables whose primary key isn't an INTEGER PRIMARY KEY, e.g. a text key:
+             *  make_table("files", make_column("path", &File::path, primary_key()), make_column("size", &File::size))
+             *      .with_rowid_member(&File::rowid)
+             */
+            table_t with_rowid_member(sqlite_int64 object_type::*member) const {
+                static_assert(!WithoutRowId, "a table WITHOUT ROWID has no rowid");
+                auto res = *this;
+                res.rowid_member = member;
+                return res;
+            }
+
+            /**
+             *  Makes the column mapped to `member` the version of the rows, for optimistic concurrency control:
+             *  `update()` of an object increments the version of its row and updates it only if the version still
+             *  is the one the object was read with, otherwise it throws `orm_error_code::version_conflict` because
+             *  somebody else updated the row meanwhile. See `storage.try_update()` and
+             *  `storage.optimistic_update()`.
+             *  make_table("accounts",
+             *             make_column("id", &Account::id, primary_key()),
+             *             make_column("balance", &Account::balance),
+             *             make_column("version", &Account::version, default_value(0)))
+             *      .version_column(&Account::version)
+             */
+            table_t version_column(sqlite_int64 object_type::*member) const {
+                auto res = *this;
+                res.version_member = member;
+                return res;
+            }
+
+            /**
+             *  Whether `column` is the version column, see `version_column()`.
+             */
+            template<class G, class S>
+            bool is_version_column(const column_field<G, S>& column) const {
+                return this->version_member && compare_any(column.member_pointer, this->version_member);
             }
 
             /**
@@ -83,12 +195,14 @@ namespace sqlite_orm {
             const member_field_type_t<M>* object_field_value(const object_type& object, M memberPointer) const {
                 using field_type = member_field_type_t<M>;
                 const field_type* res = nullptr;
-                iterate_tuple(this->elements,
+                find_in_tuple(this->elements,
                               col_index_sequence_with_field_type<elements_type, field_type>{},
                               call_as_template_base<column_field>([&res, &memberPointer, &object](const auto& column) {
                                   if(compare_any(column.setter, memberPointer)) {
                                       res = &polyfill::invoke(column.member_pointer, object);
+                                      return true;
                                   }
+                                  return false;
                               }));
                 return res;
             }
@@ -188,18 +302,22 @@ namespace sqlite_orm {
 
             /**
              *  Searches column name by class member pointer passed as the first argument.
-             *  @return column name or empty string if nothing found.
+             *  Only the columns of the field type of `m` are compared, which is resolved at compile time, and the
+             *  search stops at the first match.
+             *  @return column name or nullptr if nothing found.
              */
             template<class M, satisfies<std::is_member_pointer, M> = true>
             const std::string* find_column_name(M m) const {
                 const std::string* res = nullptr;
                 using field_type = member_field_type_t<M>;
-                iterate_tuple(this->elements,
+                find_in_tuple(this->elements,
                               col_index_sequence_with_field_type<elements_type, field_type>{},
                               [&res, m](auto& c) {
                                   if(compare_any(c.member_pointer, m) || compare_any(c.setter, m)) {
                                       res = &c.name;
+                                      return true;
                                   }
+                                  return false;
                               });
                 return res;
             }
@@ -304,4 +422,32 @@ namespace sqlite_orm {
         SQLITE_ORM_CLANG_SUPPRESS_MISSING_BRACES(
             return {move(name), std::make_tuple<Cs...>(std::forward<Cs>(args)...)});
     }
+
+#ifdef SQLITE_ORM_CLASSTYPE_TEMPLATE_ARGS_SUPPORTED
+    /**
+     *  Factory function for a table definition with the name as a template argument, checked at compile time:
+     *  `make_table<"users">(make_column<"id">(&User::id, primary_key()), ...)`.
+     *
+     *  The mapped object type is determined implicitly from the first column definition.
+     */
+    template<internal::fixed_name name,
+             class... Cs,
+             class T = typename std::tuple_element_t<0, std::tuple<Cs...>>::object_type>
+    internal::table_t<T, false, Cs...> make_table(Cs... args) {
+        static_assert(name.size() > 0, "Table names can't be empty");
+        return make_table<T>(name.str(), std::move(args)...);
+    }
+
+    /**
+     *  Factory function for a table definition with the name as a template argument, checked at compile time:
+     *  `make_table<"users", User>(...)`.
+     *
+     *  The mapped object type is explicitly specified.
+     */
+    template<internal::fixed_name name, class T, class... Cs>
+    internal::table_t<T, false, Cs...> make_table(Cs... args) {
+        static_assert(name.size() > 0, "Table names can't be empty");
+        return make_table<T>(name.str(), std::move(args)...);
+    }
+#endif
 }
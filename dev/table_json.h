@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>  //  std::string
+#include <tuple>  //  std::tuple, std::tuple_cat, std::make_tuple, std::get
+#include <utility>  //  std::index_sequence, std::move
+
+#include "functional/cxx_universal.h"
+#include "tuple_helper/tuple_filter.h"
+#include "core_functions.h"
+#include "column.h"
+
+#ifdef SQLITE_ENABLE_JSON1
+namespace sqlite_orm {
+
+    namespace internal {
+
+        template<class... Args>
+        built_in_function_t<std::string, json_object_string, Args...> make_json_object(std::tuple<Args...> args) {
+            return {std::move(args)};
+        }
+
+        template<class Table, size_t... Idx>
+        auto make_table_json_object(const Table& table, std::index_sequence<Idx...>) {
+            return make_json_object(std::tuple_cat(
+                std::make_tuple(std::get<Idx>(table.elements).name, std::get<Idx>(table.elements).member_pointer)...));
+        }
+
+        /**
+         *  `json_object('name', "name", ...)` of every column of `table`, in the order they are mapped, the JSON
+         *  object SQLite makes of a row of the table.
+         */
+        template<class Table>
+        auto make_table_json_object(const Table& table) {
+            using columns_index_sequence = filter_tuple_sequence_t<typename Table::elements_type, is_column>;
+            return make_table_json_object(table, columns_index_sequence{});
+        }
+    }
+}
+#endif  //  SQLITE_ENABLE_JSON1
@@ -10,6 +10,7 @@
 #include "select_constraints.h"
 #include "alias.h"
 #include "core_functions.h"
+#include "fts5.h"
 
 namespace sqlite_orm {
 
@@ -73,11 +74,23 @@ namespace sqlite_orm {
                 table_names.emplace(this->find_table_name(typeid(T)), "");
             }
 
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+            template<class T>
+            void operator()(const optional_object_t<T>&) const {
+                table_names.emplace(this->find_table_name(typeid(T)), "");
+            }
+#endif
+
             template<class T>
             void operator()(const table_rowid_t<T>&) const {
                 table_names.emplace(this->find_table_name(typeid(T)), "");
             }
 
+            template<class T>
+            void operator()(const fts5_table_t<T>&) const {
+                table_names.emplace(this->find_table_name(typeid(T)), "");
+            }
+
             template<class T>
             void operator()(const table_oid_t<T>&) const {
                 table_names.emplace(this->find_table_name(typeid(T)), "");
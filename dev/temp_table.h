@@ -0,0 +1,92 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstdlib>  //  std::atoi
+#include <sstream>  //  std::stringstream
+#include <string>  //  std::string
+#include <utility>  //  std::move
+
+#include "connection_holder.h"
+#include "util.h"
+#include "serializing_util.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  The TEMP table `storage.with_temp_table()` staged its rows in.
+     */
+    struct temp_table {
+        std::string name;
+        size_t rows_count = 0;
+    };
+
+    namespace internal {
+
+        inline int query_int(sqlite3* db, const std::string& query) {
+            int res = 0;
+            perform_exec(
+                db,
+                query,
+                [](void* data, int argc, char** argv, char** /*azColName*/) -> int {
+                    if(argc && argv[0]) {
+                        *(int*)data = std::atoi(argv[0]);
+                    }
+                    return 0;
+                },
+                &res);
+            return res;
+        }
+
+        /**
+         *  Keeps a connection for the TEMP table `name` and drops the table when destroyed. Switches
+         *  `temp_store` to MEMORY while it lives unless the connection has other temporary objects, which
+         *  changing `temp_store` would delete.
+         */
+        struct temp_table_guard {
+            temp_table_guard(connection_ref connection_, std::string name_) :
+                connection(std::move(connection_)), name(move(name_)) {
+                sqlite3* db = this->connection.get();
+                const int tempStore = query_int(db, "PRAGMA temp_store");
+                if(tempStore != 2 && !has_temp_objects(db)) {
+                    perform_void_exec(db, "PRAGMA temp_store = MEMORY");
+                    this->previousTempStore = tempStore;
+                }
+            }
+
+            temp_table_guard(const temp_table_guard&) = delete;
+
+            ~temp_table_guard() {
+                sqlite3* db = this->connection.get();
+                std::stringstream ss;
+                ss << "DROP TABLE IF EXISTS " << streaming_identifier("temp", this->name, std::string{}) << std::flush;
+                sqlite3_exec(db, ss.str().c_str(), nullptr, nullptr, nullptr);
+                if(this->previousTempStore != -1 && !has_temp_objects(db)) {
+                    ss.str({});
+                    ss << "PRAGMA temp_store = " << this->previousTempStore << std::flush;
+                    sqlite3_exec(db, ss.str().c_str(), nullptr, nullptr, nullptr);
+                }
+            }
+
+            sqlite3* get() {
+                return this->connection.get();
+            }
+
+          private:
+            connection_ref connection;
+            std::string name;
+            int previousTempStore = -1;
+
+            static bool has_temp_objects(sqlite3* db) {
+                int res = 0;
+                sqlite3_stmt* stmt = nullptr;
+                //  an error, e.g. of a temp schema that doesn't exist yet, means there are none
+                const char* query = "SELECT COUNT(*) FROM temp.sqlite_master";
+                if(sqlite3_prepare_v2(db, query, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+                    res = sqlite3_column_int(stmt, 0);
+                }
+                sqlite3_finalize(stmt);
+                return res > 0;
+            }
+        };
+    }
+}
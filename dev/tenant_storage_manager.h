@@ -0,0 +1,279 @@
+#pragma once
+
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::steady_clock
+#include <cstddef>  //  size_t
+#include <functional>  //  std::function
+#include <list>  //  std::list
+#include <map>  //  std::map
+#include <memory>  //  std::shared_ptr, std::make_shared, std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <string>  //  std::string
+#include <unordered_map>  //  std::unordered_map
+#include <utility>  //  std::move
+
+#include "functional/cxx_universal.h"
+#include "connection_holder.h"
+#include "storage_lookup.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  How `tenant_storage_manager` keeps the storages of its tenants.
+     */
+    struct tenant_options {
+
+        /**
+         *  Storages kept open at most. Opening one more closes the least recently used one. A storage still
+         *  held by a caller stays open until it is released.
+         */
+        size_t max_open = 64;
+
+        /**
+         *  Storages not used for this long are closed, 0 keeps them open until they are evicted.
+         */
+        std::chrono::milliseconds idle_timeout{0};
+
+        /**
+         *  Run `sync_schema()` when the file of a tenant is opened for the first time, unless the schema
+         *  fingerprint in its `PRAGMA user_version` shows that it is already in sync, see
+         *  `sync_schema_if_changed()`.
+         */
+        bool sync_schema = true;
+
+        /**
+         *  `preserve` argument of `sync_schema()`.
+         */
+        bool preserve = false;
+
+        /**
+         *  Flags every tenant connection is opened with.
+         */
+        open_options open;
+    };
+
+    /**
+     *  Counters of one tenant of a `tenant_storage_manager`.
+     */
+    struct tenant_stats {
+
+        /**
+         *  Calls of `storage()` that found the storage open.
+         */
+        size_t hits = 0;
+
+        /**
+         *  Number of times the file was opened.
+         */
+        size_t opens = 0;
+
+        /**
+         *  Number of times the manager closed the storage, to stay within `max_open`, because it was idle or
+         *  by `close()`.
+         */
+        size_t evictions = 0;
+
+        /**
+         *  True once the schema of the file was checked, it isn't checked again when the file is reopened.
+         */
+        bool schema_synced = false;
+
+        /**
+         *  True if `sync_schema()` actually ran because the fingerprint didn't match.
+         */
+        bool schema_changed = false;
+
+        bool open = false;
+    };
+
+    namespace internal {
+
+        /**
+         *  Storages of many database files with identical schema, one per tenant. Don't construct it as is, call
+         *  `make_tenant_storage_manager()` instead.
+         *  Every tenant storage is a fork of one schema storage: the mapped schema and the registered functions
+         *  and collations are shared, not copied. At most `max_open` of them are open, the least recently used
+         *  one being closed when another tenant is opened, so thousands of tenants don't exhaust file
+         *  descriptors while the busy ones don't pay for opening their file and parsing its schema per request.
+         *  The schema of a file is synced once, the first time it is opened.
+         *  Managers can be used by many threads. Opening a tenant, including the sync of its schema, holds a
+         *  lock of the manager.
+         */
+        template<class S>
+        struct tenant_storage_manager {
+            using storage_type = S;
+            using file_function = std::function<std::string(const std::string&)>;
+
+            tenant_storage_manager(std::shared_ptr<storage_type> schema_,
+                                   file_function fileOf_,
+                                   tenant_options options_) :
+                options(std::move(options_)), schemaStorage(std::move(schema_)), fileOf(std::move(fileOf_)),
+                mutex(std::make_unique<std::mutex>()) {}
+
+            /**
+             *  The storage all tenant storages are forked from. Register functions and collations and set
+             *  `on_open` here before the first tenant is opened.
+             */
+            storage_type& schema() {
+                return *this->schemaStorage;
+            }
+
+            /**
+             *  @return the open storage of `tenant`, opening the file of the tenant if needed. The storage stays
+             *  open while the returned pointer is held, even if the manager closes it meanwhile.
+             */
+            std::shared_ptr<storage_type> storage(const std::string& tenant) {
+                const auto now = std::chrono::steady_clock::now();
+                std::lock_guard<std::mutex> lock{*this->mutex};
+                this->close_idle(now);
+                auto& stats = this->tenants[tenant];
+                auto it = this->opened.find(tenant);
+                if(it != this->opened.end()) {
+                    ++stats.hits;
+                    it->second.lastUsed = now;
+                    this->recent.splice(this->recent.begin(), this->recent, it->second.position);
+                    return it->second.storage;
+                }
+                std::shared_ptr<storage_type> storage{
+                    new storage_type{*this->schemaStorage, this->fileOf(tenant), this->options.open}};
+                storage->open_forever();
+                if(this->options.sync_schema && !stats.schema_synced) {
+                    stats.schema_changed = this->sync(*storage);
+                    stats.schema_synced = true;
+                }
+                ++stats.opens;
+                stats.open = true;
+                this->recent.push_front(tenant);
+                this->opened.emplace(tenant, opened_tenant{storage, this->recent.begin(), now});
+                while(this->opened.size() > this->options.max_open) {
+                    this->close_locked(this->recent.back());
+                }
+                return storage;
+            }
+
+            /**
+             *  Closes the storages not used for `idle_timeout`.
+             */
+            void close_idle() {
+                std::lock_guard<std::mutex> lock{*this->mutex};
+                this->close_idle(std::chrono::steady_clock::now());
+            }
+
+            void close(const std::string& tenant) {
+                std::lock_guard<std::mutex> lock{*this->mutex};
+                if(this->opened.count(tenant)) {
+                    this->close_locked(tenant);
+                }
+            }
+
+            void close_all() {
+                std::lock_guard<std::mutex> lock{*this->mutex};
+                while(!this->recent.empty()) {
+                    this->close_locked(this->recent.back());
+                }
+            }
+
+            size_t open_count() {
+                std::lock_guard<std::mutex> lock{*this->mutex};
+                return this->opened.size();
+            }
+
+            /**
+             *  @return counters of `tenant`, all zero if it was never opened.
+             */
+            tenant_stats stats(const std::string& tenant) {
+                std::lock_guard<std::mutex> lock{*this->mutex};
+                auto it = this->tenants.find(tenant);
+                return it != this->tenants.end() ? it->second : tenant_stats{};
+            }
+
+            const tenant_options options;
+
+          protected:
+            struct opened_tenant {
+                std::shared_ptr<storage_type> storage;
+                std::list<std::string>::iterator position;
+                std::chrono::steady_clock::time_point lastUsed;
+            };
+
+            /**
+             *  Same as `sync_schema_if_changed()` with the fingerprint of the schema computed once.
+             *  @return true if the schema was synced.
+             */
+            bool sync(storage_type& storage) {
+                if(!this->fingerprint) {
+                    this->fingerprint = this->schemaStorage->schema_fingerprint();
+                }
+                if(storage.pragma.user_version() == this->fingerprint) {
+                    return false;
+                }
+                storage.sync_schema(this->options.preserve);
+                storage.pragma.user_version(this->fingerprint);
+                return true;
+            }
+
+            void close_idle(std::chrono::steady_clock::time_point now) {
+                if(this->options.idle_timeout.count() == 0) {
+                    return;
+                }
+                while(!this->recent.empty()) {
+                    auto& tenant = this->recent.back();
+                    if(now - this->opened.at(tenant).lastUsed < this->options.idle_timeout) {
+                        break;
+                    }
+                    this->close_locked(tenant);
+                }
+            }
+
+            void close_locked(std::string tenant) {
+                auto it = this->opened.find(tenant);
+                this->recent.erase(it->second.position);
+                this->opened.erase(it);
+                auto& stats = this->tenants[tenant];
+                ++stats.evictions;
+                stats.open = false;
+            }
+
+            std::shared_ptr<storage_type> schemaStorage;
+            file_function fileOf;
+
+            /**
+             *  Allocated so that the manager can be moved.
+             */
+            std::unique_ptr<std::mutex> mutex;
+            int fingerprint = 0;
+
+            /**
+             *  Open tenants, the most recently used first.
+             */
+            std::list<std::string> recent;
+            std::unordered_map<std::string, opened_tenant> opened;
+            std::map<std::string, tenant_stats> tenants;
+        };
+    }
+
+    /**
+     *  Makes a manager of tenant storages with the schema `dbObjects`, the file of a tenant being
+     *  `fileOf(tenant)`.
+     *  Example: auto tenants = make_tenant_storage_manager(
+     *               [](const std::string& tenant) {
+     *                   return "tenants/" + tenant + ".sqlite";
+     *               },
+     *               tenant_options{},
+     *               make_table("users", make_column("id", &User::id, primary_key()), ...));
+     *           auto storage = tenants.storage("acme");
+     *           storage->insert(User{...});
+     *  The schema storage itself is an in-memory database that is never used for queries.
+     */
+    template<class... DBO>
+    auto make_tenant_storage_manager(std::function<std::string(const std::string&)> fileOf,
+                                     tenant_options options,
+                                     DBO... dbObjects) {
+        using storage_type = internal::storage_t<DBO...>;
+        auto schema = std::make_shared<storage_type>(
+            std::string{},
+            internal::db_objects_tuple<DBO...>{std::forward<DBO>(dbObjects)...});
+        return internal::tenant_storage_manager<storage_type>{std::move(schema),
+                                                              std::move(fileOf),
+                                                              std::move(options)};
+    }
+}
@@ -2,11 +2,41 @@
 
 #include <functional>  //  std::function
 #include <utility>  //  std::move
+#include <chrono>  //  std::chrono::milliseconds
 
+#include "functional/cxx_universal.h"
 #include "connection_holder.h"
 
 namespace sqlite_orm {
 
+    /**
+     *  How `storage.transaction(f, retry_policy{...})` retries a transaction that failed with `SQLITE_BUSY`.
+     *  The n-th retry waits a random time between zero and `min(initial_backoff * 2^(n-1), max_backoff)`.
+     */
+    struct retry_policy {
+        /**
+         *  Maximum number of times the transaction is run, including the first attempt.
+         */
+        int max_attempts = 5;
+
+        std::chrono::milliseconds initial_backoff{1};
+        std::chrono::milliseconds max_backoff{100};
+
+        /**
+         *  Time after the first attempt after which no retry is started. Zero means no deadline.
+         */
+        std::chrono::milliseconds deadline{0};
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        retry_policy(int max_attempts = 5,
+                     std::chrono::milliseconds initial_backoff = std::chrono::milliseconds{1},
+                     std::chrono::milliseconds max_backoff = std::chrono::milliseconds{100},
+                     std::chrono::milliseconds deadline = std::chrono::milliseconds{0}) :
+            max_attempts{max_attempts},
+            initial_backoff{initial_backoff}, max_backoff{max_backoff}, deadline{deadline} {}
+#endif
+    };
+
     namespace internal {
 
         /**
@@ -84,6 +84,28 @@ namespace sqlite_orm {
             iterate_tuple<Tpl>(std::make_index_sequence<std::tuple_size<Tpl>::value>{}, std::forward<L>(lambda));
         }
 
+        /**
+         *  Calls `predicate` with the elements of `tpl` at `Idx...` in order until it returns true.
+         *  @return whether `predicate` returned true.
+         */
+#ifdef SQLITE_ORM_FOLD_EXPRESSIONS_SUPPORTED
+        template<class Tpl, size_t... Idx, class P>
+        bool find_in_tuple(const Tpl& tpl, std::index_sequence<Idx...>, P&& predicate) {
+            return (predicate(std::get<Idx>(tpl)) || ...);
+        }
+#else
+        template<class Tpl, class P>
+        bool find_in_tuple(const Tpl& /*tpl*/, std::index_sequence<>, P&& /*predicate*/) {
+            return false;
+        }
+
+        template<class Tpl, size_t I, size_t... Idx, class P>
+        bool find_in_tuple(const Tpl& tpl, std::index_sequence<I, Idx...>, P&& predicate) {
+            return predicate(std::get<I>(tpl)) ||
+                   find_in_tuple(tpl, std::index_sequence<Idx...>{}, std::forward<P>(predicate));
+        }
+#endif
+
         template<class R, class Tpl, size_t... Idx, class Projection = polyfill::identity>
         R create_from_tuple(Tpl&& tpl, std::index_sequence<Idx...>, Projection project = {}) {
             return R{polyfill::invoke(project, std::get<Idx>(std::forward<Tpl>(tpl)))...};
@@ -4,10 +4,13 @@
 #include <memory>  //  std::shared_ptr, std::unique_ptr
 #include <vector>  //  std::vector
 #include "functional/cxx_optional.h"
+#include "functional/cxx_memory_resource.h"
 
 #include "functional/cxx_type_traits_polyfill.h"
 #include "type_traits.h"
 #include "is_std_ptr.h"
+#include "byte_vector.h"
+#include "stored_value.h"
 
 namespace sqlite_orm {
 
@@ -78,4 +81,20 @@ namespace sqlite_orm {
 
     template<>
     struct type_printer<std::vector<char>, void> : blob_printer {};
+
+    template<class T>
+    struct type_printer<T, std::enable_if_t<internal::is_byte_vector_v<T> || internal::is_byte_array_v<T>>>
+        : blob_printer {};
+
+    template<class T>
+    struct type_printer<T, std::enable_if_t<internal::is_stored_value_v<T>>>
+        : type_printer<typename internal::stored_value<T>::stored_type> {};
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+    template<>
+    struct type_printer<std::pmr::string, void> : text_printer {};
+
+    template<>
+    struct type_printer<std::pmr::vector<char>, void> : blob_printer {};
+#endif
 }
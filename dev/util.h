@@ -1,13 +1,43 @@
 #pragma once
 
 #include <sqlite3.h>
+#ifdef SQLITE_ENABLE_UNLOCK_NOTIFY
+#include <condition_variable>  //  std::condition_variable
+#include <mutex>  //  std::mutex, std::lock_guard, std::unique_lock
+#endif
 #include <string>  //  std::string
-#include <utility>  //  std::move
+#include <system_error>  //  std::error_code
+#include <utility>  //  std::move, std::forward
+#include <type_traits>  //  std::is_void, std::integral_constant
 
 #include "error_code.h"
+#include "change_hooks.h"
 
 namespace sqlite_orm {
 
+    /**
+     *  Flags of `sqlite3_prepare_v3()` for `storage.prepare(statement, flags)`, ignored before SQLite 3.20.0.
+     */
+    enum class prepare_flags : unsigned int {
+        none = 0,
+
+        /**
+         *  SQLITE_PREPARE_PERSISTENT: the statement is kept for long, SQLite doesn't use lookaside memory for it,
+         *  which leaves lookaside to the short-lived allocations it is meant for. The default of
+         *  `storage.prepare()` and of the statements of the statement cache.
+         */
+        persistent = 0x01,
+
+        /**
+         *  SQLITE_PREPARE_NO_VTAB: preparing fails if the statement uses a virtual table, from SQLite 3.28.0.
+         */
+        no_vtab = 0x04,
+    };
+
+    inline prepare_flags operator|(prepare_flags lhs, prepare_flags rhs) {
+        return prepare_flags(static_cast<unsigned int>(lhs) | static_cast<unsigned int>(rhs));
+    }
+
     /** 
      *  Escape the provided character in the given string by doubling it.
      *  @param str A copy of the original string
@@ -55,17 +85,148 @@ namespace sqlite_orm {
             return stmt;
         }
 
-        // note: query is deliberately taken by value, such that it is thrown away early
-        inline sqlite3_stmt* prepare_stmt(sqlite3* db, std::string query) {
+#ifdef SQLITE_ENABLE_UNLOCK_NOTIFY
+        struct unlock_notification {
+            bool fired = false;
+            std::mutex mutex;
+            std::condition_variable condition;
+        };
+
+        inline void unlock_notify_callback(void** notifications, int count) {
+            for(int i = 0; i < count; ++i) {
+                auto& notification = *static_cast<unlock_notification*>(notifications[i]);
+                std::lock_guard<std::mutex> lock{notification.mutex};
+                notification.fired = true;
+                notification.condition.notify_one();
+            }
+        }
+
+        /**
+         *  Blocks until the connection holding the shared-cache lock that `db` failed to get with
+         *  SQLITE_LOCKED_SHAREDCACHE ends its transaction.
+         *  @return SQLITE_OK or SQLITE_LOCKED if waiting would deadlock.
+         */
+        inline int wait_for_unlock_notify(sqlite3* db) {
+            unlock_notification notification;
+            int rc = sqlite3_unlock_notify(db, unlock_notify_callback, &notification);
+            if(rc == SQLITE_OK) {
+                std::unique_lock<std::mutex> lock{notification.mutex};
+                notification.condition.wait(lock, [&notification] {
+                    return notification.fired;
+                });
+            }
+            return rc;
+        }
+#endif
+
+        /**
+         *  Whether a call failing with SQLITE_LOCKED on `db` can wait for the shared-cache lock and try again.
+         *  Only with SQLITE_ENABLE_UNLOCK_NOTIFY, otherwise SQLITE_LOCKED fails right away.
+         */
+        inline bool wait_for_shared_cache_lock(sqlite3* db, int rc) {
+#ifdef SQLITE_ENABLE_UNLOCK_NOTIFY
+            return (rc & 0xFF) == SQLITE_LOCKED && sqlite3_extended_errcode(db) == SQLITE_LOCKED_SHAREDCACHE &&
+                   wait_for_unlock_notify(db) == SQLITE_OK;
+#else
+            (void)db;
+            (void)rc;
+            return false;
+#endif
+        }
+
+        /**
+         *  `sqlite3_step()` that waits for a shared-cache lock held by another connection and steps again
+         *  if the statement hasn't returned a row yet, see `wait_for_shared_cache_lock()`.
+         *  A transaction the step commits is reported to the change listeners once it returned.
+         */
+        inline int step_stmt(sqlite3_stmt* stmt) {
+            commit_scope commits;
+#ifdef SQLITE_ENABLE_UNLOCK_NOTIFY
+            //  a statement which returned rows already would return them again after the reset
+            const bool started = sqlite3_stmt_busy(stmt);
+            int rc;
+            while((rc = sqlite3_step(stmt)) != SQLITE_ROW && rc != SQLITE_DONE && !started &&
+                  wait_for_shared_cache_lock(sqlite3_db_handle(stmt), rc)) {
+                sqlite3_reset(stmt);
+            }
+            return rc;
+#else
+            return sqlite3_step(stmt);
+#endif
+        }
+
+        /**
+         *  `sqlite3_prepare_v3()` with `flags`, or `sqlite3_prepare_v2()` before SQLite 3.20.0.
+         *  @param size length of `query` including its terminating null character or -1.
+         */
+        inline int
+        prepare_sqlite_stmt(sqlite3* db, const char* query, int size, prepare_flags flags, sqlite3_stmt** stmt) {
+#if SQLITE_VERSION_NUMBER >= 3020000
+            return sqlite3_prepare_v3(db, query, size, static_cast<unsigned int>(flags), stmt, nullptr);
+#else
+            (void)flags;
+            return sqlite3_prepare_v2(db, query, size, stmt, nullptr);
+#endif
+        }
+
+        /**
+         *  @param size length of the null-terminated `query`, saves sqlite from scanning it.
+         */
+        inline sqlite3_stmt*
+        prepare_stmt(sqlite3* db, const char* query, size_t size, prepare_flags flags = prepare_flags::none) {
             sqlite3_stmt* stmt;
-            if(sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-                throw_translated_sqlite_error(db);
+            int rc;
+            while((rc = prepare_sqlite_stmt(db, query, int(size + 1), flags, &stmt)) != SQLITE_OK) {
+                if(!wait_for_shared_cache_lock(db, rc)) {
+                    throw_translated_sqlite_error(db);
+                }
             }
             return stmt;
         }
 
+        // note: query is deliberately taken by value, such that it is thrown away early
+        inline sqlite3_stmt* prepare_stmt(sqlite3* db, std::string query, prepare_flags flags = prepare_flags::none) {
+            return prepare_stmt(db, query.c_str(), query.size(), flags);
+        }
+
+        /**
+         *  While it exists, `storage.prepare()` on this thread prepares with `flags` instead of
+         *  `prepare_flags::persistent`, see `storage.prepare(statement, flags)`.
+         */
+        class prepare_flags_scope {
+          public:
+            prepare_flags_scope(prepare_flags flags_) : flags(flags_), previous(current()) {
+                current() = this;
+            }
+
+            prepare_flags_scope(const prepare_flags_scope&) = delete;
+            prepare_flags_scope& operator=(const prepare_flags_scope&) = delete;
+
+            ~prepare_flags_scope() {
+                current() = this->previous;
+            }
+
+            static prepare_flags flags_or(prepare_flags defaultFlags) {
+                auto scope = current();
+                return scope ? scope->flags : defaultFlags;
+            }
+
+          private:
+            prepare_flags flags;
+            prepare_flags_scope* previous;
+
+            static prepare_flags_scope*& current() {
+                thread_local prepare_flags_scope* scope = nullptr;
+                return scope;
+            }
+        };
+
         inline void perform_void_exec(sqlite3* db, const std::string& query) {
-            int rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
+            int rc;
+            {
+                commit_scope commits;
+                rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
+            }
             if(rc != SQLITE_OK) {
                 throw_translated_sqlite_error(db);
             }
@@ -75,7 +236,11 @@ namespace sqlite_orm {
                                  const char* query,
                                  int (*callback)(void* data, int argc, char** argv, char**),
                                  void* user_data) {
-            int rc = sqlite3_exec(db, query, callback, user_data, nullptr);
+            int rc;
+            {
+                commit_scope commits;
+                rc = sqlite3_exec(db, query, callback, user_data, nullptr);
+            }
             if(rc != SQLITE_OK) {
                 throw_translated_sqlite_error(db);
             }
@@ -88,24 +253,72 @@ namespace sqlite_orm {
             return perform_exec(db, query.c_str(), callback, user_data);
         }
 
+        /**
+         *  While it exists, `perform_step()` on this thread keeps the code of a failed step of `stmt` instead of
+         *  throwing, for the `try_` functions of the storage. Steps of other statements, e.g. of a query run by a
+         *  function the statement calls, still throw.
+         */
+        class step_error_scope {
+          public:
+            step_error_scope(sqlite3_stmt* stmt_) : stmt(stmt_), previous(current()) {
+                current() = this;
+            }
+
+            step_error_scope(const step_error_scope&) = delete;
+            step_error_scope& operator=(const step_error_scope&) = delete;
+
+            ~step_error_scope() {
+                current() = this->previous;
+            }
+
+            std::error_code error() const {
+                return this->rc == SQLITE_OK ? std::error_code{} : std::error_code{sqlite_errc(this->rc)};
+            }
+
+            /**
+             *  Keeps the error of the failed step of `stmt` if a scope of `stmt` exists.
+             *  @return whether the error is kept.
+             */
+            static bool keep(sqlite3_stmt* stmt) {
+                auto scope = current();
+                if(!scope || scope->stmt != stmt) {
+                    return false;
+                }
+                scope->rc = sqlite3_errcode(sqlite3_db_handle(stmt));
+                return true;
+            }
+
+          private:
+            sqlite3_stmt* stmt;
+            step_error_scope* previous;
+            int rc = SQLITE_OK;
+
+            static step_error_scope*& current() {
+                thread_local step_error_scope* scope = nullptr;
+                return scope;
+            }
+        };
+
         template<int expected = SQLITE_DONE>
         void perform_step(sqlite3_stmt* stmt) {
-            int rc = sqlite3_step(stmt);
-            if(rc != expected) {
+            int rc = step_stmt(stmt);
+            if(rc != expected && !step_error_scope::keep(stmt)) {
                 throw_translated_sqlite_error(stmt);
             }
         }
 
         template<class L>
         void perform_step(sqlite3_stmt* stmt, L&& lambda) {
-            switch(int rc = sqlite3_step(stmt)) {
+            switch(int rc = step_stmt(stmt)) {
                 case SQLITE_ROW: {
                     lambda(stmt);
                 } break;
                 case SQLITE_DONE:
                     break;
                 default: {
-                    throw_translated_sqlite_error(stmt);
+                    if(!step_error_scope::keep(stmt)) {
+                        throw_translated_sqlite_error(stmt);
+                    }
                 }
             }
         }
@@ -114,7 +327,7 @@ namespace sqlite_orm {
         void perform_steps(sqlite3_stmt* stmt, L&& lambda) {
             int rc;
             do {
-                switch(rc = sqlite3_step(stmt)) {
+                switch(rc = step_stmt(stmt)) {
                     case SQLITE_ROW: {
                         lambda(stmt);
                     } break;
@@ -126,5 +339,64 @@ namespace sqlite_orm {
                 }
             } while(rc != SQLITE_DONE);
         }
+
+        /**
+         *  Same as `perform_steps` but stops as soon as `lambda` returns false.
+         *  A statement stopped early is reset so that it doesn't keep its read transaction open.
+         */
+        template<class L>
+        void perform_steps_while(sqlite3_stmt* stmt, L&& lambda) {
+            for(;;) {
+                switch(step_stmt(stmt)) {
+                    case SQLITE_ROW: {
+                        if(!lambda(stmt)) {
+                            sqlite3_reset(stmt);
+                            return;
+                        }
+                    } break;
+                    case SQLITE_DONE:
+                        return;
+                    default: {
+                        throw_translated_sqlite_error(stmt);
+                    }
+                }
+            }
+        }
+
+        /**
+         *  Steps `stmt` once, for loops that can't pass the row to a lambda, e.g. coroutines.
+         *  @return true if it returned a row, false if it is done.
+         */
+        inline bool step_row(sqlite3_stmt* stmt) {
+            switch(step_stmt(stmt)) {
+                case SQLITE_ROW:
+                    return true;
+                case SQLITE_DONE:
+                    return false;
+                default:
+                    throw_translated_sqlite_error(stmt);
+            }
+        }
+
+        template<class F, class... Args>
+        bool call_row_callback(std::true_type /*returnsVoid*/, F& callback, Args&&... args) {
+            callback(std::forward<Args>(args)...);
+            return true;
+        }
+
+        template<class F, class... Args>
+        bool call_row_callback(std::false_type /*returnsVoid*/, F& callback, Args&&... args) {
+            return bool(callback(std::forward<Args>(args)...));
+        }
+
+        /**
+         *  Calls a row callback. Returns false if the callback wants to stop: callbacks either return nothing
+         *  (visit all rows) or something convertible to bool (false to stop).
+         */
+        template<class F, class... Args>
+        bool call_row_callback(F& callback, Args&&... args) {
+            using returns_void = std::is_void<decltype(callback(std::forward<Args>(args)...))>;
+            return call_row_callback(returns_void{}, callback, std::forward<Args>(args)...);
+        }
     }
 }
@@ -0,0 +1,588 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cmath>  //  std::sqrt
+#include <cstring>  //  std::memcpy
+#include <functional>  //  std::less
+#include <queue>  //  std::priority_queue
+#include <string>  //  std::string, std::to_string
+#include <tuple>  //  std::tuple
+#include <utility>  //  std::pair
+#include <vector>  //  std::vector
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SQLITE_ORM_VECTOR_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define SQLITE_ORM_VECTOR_SSE
+#if defined(__GNUC__) || defined(__clang__)
+//  AVX2 kernels are compiled for their functions only and picked if the CPU has AVX2 and FMA
+#define SQLITE_ORM_VECTOR_AVX2
+#endif
+#endif
+
+#include "functional/cxx_universal.h"
+#include "error_code.h"
+#include "serialize_result_type.h"
+#include "core_functions.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Kernels of the vector functions over two arrays of `count` float32, possibly unaligned: the memory
+         *  of BLOB arguments is read as is, without copying it.
+         */
+        struct vector_kernels {
+            const char* isa;
+            float (*dot)(const unsigned char* a, const unsigned char* b, size_t count);
+            float (*squared_l2)(const unsigned char* a, const unsigned char* b, size_t count);
+
+            /**
+             *  Dot product and squared norms of `a` and `b` in one pass.
+             */
+            void (*cosine_sums)(const unsigned char* a,
+                                const unsigned char* b,
+                                size_t count,
+                                float& dot,
+                                float& aa,
+                                float& bb);
+        };
+
+        inline float vector_load(const unsigned char* p, size_t i) {
+            float value;
+            std::memcpy(&value, p + i * sizeof(float), sizeof(float));
+            return value;
+        }
+
+        inline float vector_dot_scalar(const unsigned char* a, const unsigned char* b, size_t count) {
+            float sum = 0;
+            for(size_t i = 0; i < count; ++i) {
+                sum += vector_load(a, i) * vector_load(b, i);
+            }
+            return sum;
+        }
+
+        inline float vector_squared_l2_scalar(const unsigned char* a, const unsigned char* b, size_t count) {
+            float sum = 0;
+            for(size_t i = 0; i < count; ++i) {
+                const float d = vector_load(a, i) - vector_load(b, i);
+                sum += d * d;
+            }
+            return sum;
+        }
+
+        inline void vector_cosine_sums_scalar(const unsigned char* a,
+                                              const unsigned char* b,
+                                              size_t count,
+                                              float& dot,
+                                              float& aa,
+                                              float& bb) {
+            dot = aa = bb = 0;
+            for(size_t i = 0; i < count; ++i) {
+                const float x = vector_load(a, i);
+                const float y = vector_load(b, i);
+                dot += x * y;
+                aa += x * x;
+                bb += y * y;
+            }
+        }
+
+#ifdef SQLITE_ORM_VECTOR_SSE
+        inline float vector_sum_sse(__m128 v) {
+            __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 sums = _mm_add_ps(v, shuffled);
+            shuffled = _mm_movehl_ps(shuffled, sums);
+            return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+        }
+
+        inline __m128 vector_load_sse(const unsigned char* p, size_t i) {
+            return _mm_loadu_ps(reinterpret_cast<const float*>(p + i * sizeof(float)));
+        }
+
+        inline float vector_dot_sse(const unsigned char* a, const unsigned char* b, size_t count) {
+            __m128 sum = _mm_setzero_ps();
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(vector_load_sse(a, i), vector_load_sse(b, i)));
+            }
+            float res = vector_sum_sse(sum);
+            for(; i < count; ++i) {
+                res += vector_load(a, i) * vector_load(b, i);
+            }
+            return res;
+        }
+
+        inline float vector_squared_l2_sse(const unsigned char* a, const unsigned char* b, size_t count) {
+            __m128 sum = _mm_setzero_ps();
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4) {
+                const __m128 d = _mm_sub_ps(vector_load_sse(a, i), vector_load_sse(b, i));
+                sum = _mm_add_ps(sum, _mm_mul_ps(d, d));
+            }
+            float res = vector_sum_sse(sum);
+            for(; i < count; ++i) {
+                const float d = vector_load(a, i) - vector_load(b, i);
+                res += d * d;
+            }
+            return res;
+        }
+
+        inline void vector_cosine_sums_sse(const unsigned char* a,
+                                           const unsigned char* b,
+                                           size_t count,
+                                           float& dot,
+                                           float& aa,
+                                           float& bb) {
+            __m128 dots = _mm_setzero_ps();
+            __m128 as = _mm_setzero_ps();
+            __m128 bs = _mm_setzero_ps();
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4) {
+                const __m128 x = vector_load_sse(a, i);
+                const __m128 y = vector_load_sse(b, i);
+                dots = _mm_add_ps(dots, _mm_mul_ps(x, y));
+                as = _mm_add_ps(as, _mm_mul_ps(x, x));
+                bs = _mm_add_ps(bs, _mm_mul_ps(y, y));
+            }
+            dot = vector_sum_sse(dots);
+            aa = vector_sum_sse(as);
+            bb = vector_sum_sse(bs);
+            for(; i < count; ++i) {
+                const float x = vector_load(a, i);
+                const float y = vector_load(b, i);
+                dot += x * y;
+                aa += x * x;
+                bb += y * y;
+            }
+        }
+#endif  //  SQLITE_ORM_VECTOR_SSE
+
+#ifdef SQLITE_ORM_VECTOR_AVX2
+        __attribute__((target("avx2,fma"))) inline float vector_sum_avx2(__m256 v) {
+            const __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            __m128 shuffled = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 sums = _mm_add_ps(sum, shuffled);
+            shuffled = _mm_movehl_ps(shuffled, sums);
+            return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+        }
+
+        __attribute__((target("avx2,fma"))) inline __m256 vector_load_avx2(const unsigned char* p, size_t i) {
+            return _mm256_loadu_ps(reinterpret_cast<const float*>(p + i * sizeof(float)));
+        }
+
+        __attribute__((target("avx2,fma"))) inline float
+        vector_dot_avx2(const unsigned char* a, const unsigned char* b, size_t count) {
+            __m256 sum = _mm256_setzero_ps();
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8) {
+                sum = _mm256_fmadd_ps(vector_load_avx2(a, i), vector_load_avx2(b, i), sum);
+            }
+            float res = vector_sum_avx2(sum);
+            for(; i < count; ++i) {
+                res += vector_load(a, i) * vector_load(b, i);
+            }
+            return res;
+        }
+
+        __attribute__((target("avx2,fma"))) inline float
+        vector_squared_l2_avx2(const unsigned char* a, const unsigned char* b, size_t count) {
+            __m256 sum = _mm256_setzero_ps();
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8) {
+                const __m256 d = _mm256_sub_ps(vector_load_avx2(a, i), vector_load_avx2(b, i));
+                sum = _mm256_fmadd_ps(d, d, sum);
+            }
+            float res = vector_sum_avx2(sum);
+            for(; i < count; ++i) {
+                const float d = vector_load(a, i) - vector_load(b, i);
+                res += d * d;
+            }
+            return res;
+        }
+
+        __attribute__((target("avx2,fma"))) inline void vector_cosine_sums_avx2(const unsigned char* a,
+                                                                                const unsigned char* b,
+                                                                                size_t count,
+                                                                                float& dot,
+                                                                                float& aa,
+                                                                                float& bb) {
+            __m256 dots = _mm256_setzero_ps();
+            __m256 as = _mm256_setzero_ps();
+            __m256 bs = _mm256_setzero_ps();
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8) {
+                const __m256 x = vector_load_avx2(a, i);
+                const __m256 y = vector_load_avx2(b, i);
+                dots = _mm256_fmadd_ps(x, y, dots);
+                as = _mm256_fmadd_ps(x, x, as);
+                bs = _mm256_fmadd_ps(y, y, bs);
+            }
+            dot = vector_sum_avx2(dots);
+            aa = vector_sum_avx2(as);
+            bb = vector_sum_avx2(bs);
+            for(; i < count; ++i) {
+                const float x = vector_load(a, i);
+                const float y = vector_load(b, i);
+                dot += x * y;
+                aa += x * x;
+                bb += y * y;
+            }
+        }
+#endif  //  SQLITE_ORM_VECTOR_AVX2
+
+#ifdef SQLITE_ORM_VECTOR_NEON
+        inline float32x4_t vector_load_neon(const unsigned char* p, size_t i) {
+            return vld1q_f32(reinterpret_cast<const float*>(p + i * sizeof(float)));
+        }
+
+        inline float vector_dot_neon(const unsigned char* a, const unsigned char* b, size_t count) {
+            float32x4_t sum = vdupq_n_f32(0);
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4) {
+                sum = vfmaq_f32(sum, vector_load_neon(a, i), vector_load_neon(b, i));
+            }
+            float res = vaddvq_f32(sum);
+            for(; i < count; ++i) {
+                res += vector_load(a, i) * vector_load(b, i);
+            }
+            return res;
+        }
+
+        inline float vector_squared_l2_neon(const unsigned char* a, const unsigned char* b, size_t count) {
+            float32x4_t sum = vdupq_n_f32(0);
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4) {
+                const float32x4_t d = vsubq_f32(vector_load_neon(a, i), vector_load_neon(b, i));
+                sum = vfmaq_f32(sum, d, d);
+            }
+            float res = vaddvq_f32(sum);
+            for(; i < count; ++i) {
+                const float d = vector_load(a, i) - vector_load(b, i);
+                res += d * d;
+            }
+            return res;
+        }
+
+        inline void vector_cosine_sums_neon(const unsigned char* a,
+                                            const unsigned char* b,
+                                            size_t count,
+                                            float& dot,
+                                            float& aa,
+                                            float& bb) {
+            float32x4_t dots = vdupq_n_f32(0);
+            float32x4_t as = vdupq_n_f32(0);
+            float32x4_t bs = vdupq_n_f32(0);
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4) {
+                const float32x4_t x = vector_load_neon(a, i);
+                const float32x4_t y = vector_load_neon(b, i);
+                dots = vfmaq_f32(dots, x, y);
+                as = vfmaq_f32(as, x, x);
+                bs = vfmaq_f32(bs, y, y);
+            }
+            dot = vaddvq_f32(dots);
+            aa = vaddvq_f32(as);
+            bb = vaddvq_f32(bs);
+            for(; i < count; ++i) {
+                const float x = vector_load(a, i);
+                const float y = vector_load(b, i);
+                dot += x * y;
+                aa += x * x;
+                bb += y * y;
+            }
+        }
+#endif  //  SQLITE_ORM_VECTOR_NEON
+
+        inline const vector_kernels& scalar_vector_kernels() {
+            static const vector_kernels kernels{"scalar",
+                                                vector_dot_scalar,
+                                                vector_squared_l2_scalar,
+                                                vector_cosine_sums_scalar};
+            return kernels;
+        }
+
+        /**
+         *  The fastest kernels the CPU runs, picked once.
+         */
+        inline const vector_kernels& cpu_vector_kernels() {
+            static const vector_kernels kernels = []() -> vector_kernels {
+#if defined(SQLITE_ORM_VECTOR_NEON)
+                return {"neon", vector_dot_neon, vector_squared_l2_neon, vector_cosine_sums_neon};
+#elif defined(SQLITE_ORM_VECTOR_SSE)
+#ifdef SQLITE_ORM_VECTOR_AVX2
+                if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                    return {"avx2", vector_dot_avx2, vector_squared_l2_avx2, vector_cosine_sums_avx2};
+                }
+#endif  //  SQLITE_ORM_VECTOR_AVX2
+                return {"sse", vector_dot_sse, vector_squared_l2_sse, vector_cosine_sums_sse};
+#else
+                return scalar_vector_kernels();
+#endif
+            }();
+            return kernels;
+        }
+
+        /**
+         *  Reads the two vector arguments of `name`.
+         *  @return false if the result is set already: NULL if an argument is NULL, an error if the arguments
+         *  aren't float32 vectors of the same dimension.
+         */
+        inline bool vector_arguments(sqlite3_context* context,
+                                     sqlite3_value** argv,
+                                     const char* name,
+                                     const unsigned char*& a,
+                                     const unsigned char*& b,
+                                     size_t& count) {
+            if(sqlite3_value_type(argv[0]) == SQLITE_NULL || sqlite3_value_type(argv[1]) == SQLITE_NULL) {
+                return false;
+            }
+            if(sqlite3_value_type(argv[0]) != SQLITE_BLOB || sqlite3_value_type(argv[1]) != SQLITE_BLOB) {
+                sqlite3_result_error(context, (std::string{name} + ": arguments must be BLOBs").c_str(), -1);
+                return false;
+            }
+            a = static_cast<const unsigned char*>(sqlite3_value_blob(argv[0]));
+            b = static_cast<const unsigned char*>(sqlite3_value_blob(argv[1]));
+            const int bytes = sqlite3_value_bytes(argv[0]);
+            if(bytes != sqlite3_value_bytes(argv[1]) || bytes % sizeof(float) != 0) {
+                const auto message = std::string{name} + ": arguments must be float32 vectors of one dimension";
+                sqlite3_result_error(context, message.c_str(), -1);
+                return false;
+            }
+            count = size_t(bytes) / sizeof(float);
+            return true;
+        }
+
+        inline void vec_dot_function(sqlite3_context* context, int, sqlite3_value** argv) {
+            const unsigned char* a;
+            const unsigned char* b;
+            size_t count;
+            if(vector_arguments(context, argv, "vec_dot", a, b, count)) {
+                sqlite3_result_double(context, cpu_vector_kernels().dot(a, b, count));
+            }
+        }
+
+        inline void vec_l2_function(sqlite3_context* context, int, sqlite3_value** argv) {
+            const unsigned char* a;
+            const unsigned char* b;
+            size_t count;
+            if(vector_arguments(context, argv, "vec_l2", a, b, count)) {
+                sqlite3_result_double(context, std::sqrt(double(cpu_vector_kernels().squared_l2(a, b, count))));
+            }
+        }
+
+        /**
+         *  NULL if a vector is zero, its direction is undefined.
+         */
+        inline void vec_cosine_function(sqlite3_context* context, int, sqlite3_value** argv) {
+            const unsigned char* a;
+            const unsigned char* b;
+            size_t count;
+            if(vector_arguments(context, argv, "vec_cosine", a, b, count)) {
+                float dot;
+                float aa;
+                float bb;
+                cpu_vector_kernels().cosine_sums(a, b, count, dot, aa, bb);
+                if(aa > 0 && bb > 0) {
+                    sqlite3_result_double(context, double(dot) / std::sqrt(double(aa) * double(bb)));
+                }
+            }
+        }
+
+        /**
+         *  State of a `top_k` aggregate: the k values with the smallest scores so far, the greatest on top.
+         *  Equal scores are ordered by arrival, so the result doesn't depend on the heap.
+         */
+        struct top_k_state {
+            using entry_type = std::pair<std::pair<double, sqlite3_int64>, sqlite3_int64>;
+
+            sqlite3_int64 k = 0;
+            sqlite3_int64 arrivals = 0;
+            std::priority_queue<entry_type, std::vector<entry_type>, std::less<entry_type>> heap;
+        };
+
+        inline void top_k_step(sqlite3_context* context, int, sqlite3_value** argv) {
+            auto slot = static_cast<top_k_state**>(sqlite3_aggregate_context(context, sizeof(top_k_state*)));
+            if(!slot) {
+                sqlite3_result_error_nomem(context);
+                return;
+            }
+            if(!*slot) {
+                const auto k = sqlite3_value_int64(argv[2]);
+                if(k <= 0) {
+                    sqlite3_result_error(context, "top_k: k must be positive", -1);
+                    return;
+                }
+                *slot = new top_k_state{};
+                (*slot)->k = k;
+            }
+            if(sqlite3_value_type(argv[1]) == SQLITE_NULL) {
+                return;
+            }
+            if(sqlite3_value_type(argv[0]) != SQLITE_INTEGER) {
+                sqlite3_result_error(context, "top_k: values must be integers", -1);
+                return;
+            }
+            auto& state = **slot;
+            top_k_state::entry_type entry{{sqlite3_value_double(argv[1]), state.arrivals++},
+                                          sqlite3_value_int64(argv[0])};
+            if(sqlite3_int64(state.heap.size()) < state.k) {
+                state.heap.push(entry);
+            } else if(entry.first < state.heap.top().first) {
+                state.heap.pop();
+                state.heap.push(entry);
+            }
+        }
+
+        /**
+         *  The values as a JSON array, the smallest score first.
+         */
+        inline void top_k_final(sqlite3_context* context) {
+            auto slot = static_cast<top_k_state**>(sqlite3_aggregate_context(context, 0));
+            if(!slot || !*slot) {
+                sqlite3_result_text(context, "[]", -1, SQLITE_STATIC);
+                return;
+            }
+            auto& heap = (*slot)->heap;
+            std::vector<sqlite3_int64> values(heap.size());
+            for(auto i = values.size(); i > 0; --i) {
+                values[i - 1] = heap.top().second;
+                heap.pop();
+            }
+            delete *slot;
+            *slot = nullptr;
+            std::string res{"["};
+            for(auto& value: values) {
+                if(res.size() > 1) {
+                    res += ',';
+                }
+                res += std::to_string(value);
+            }
+            res += ']';
+            sqlite3_result_text(context, res.c_str(), int(res.size()), SQLITE_TRANSIENT);
+        }
+
+        /**
+         *  Registers `vec_dot`, `vec_l2`, `vec_cosine` and `top_k` on `db`, replacing any with the same names.
+         */
+        inline void register_vector_functions(sqlite3* db) {
+            struct vector_function {
+                const char* name;
+                int argumentsCount;
+                void (*callback)(sqlite3_context*, int, sqlite3_value**);
+                void (*final)(sqlite3_context*);
+            };
+            static const vector_function functions[] = {
+                {"vec_dot", 2, vec_dot_function, nullptr},
+                {"vec_l2", 2, vec_l2_function, nullptr},
+                {"vec_cosine", 2, vec_cosine_function, nullptr},
+                {"top_k", 3, nullptr, top_k_final},
+            };
+#if SQLITE_VERSION_NUMBER >= 3008003
+            constexpr int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+#else
+            constexpr int flags = SQLITE_UTF8;
+#endif
+            for(auto& function: functions) {
+                auto resultCode = sqlite3_create_function_v2(db,
+                                                             function.name,
+                                                             function.argumentsCount,
+                                                             flags,
+                                                             nullptr,
+                                                             function.final ? nullptr : function.callback,
+                                                             function.final ? top_k_step : nullptr,
+                                                             function.final,
+                                                             nullptr);
+                if(resultCode != SQLITE_OK) {
+                    throw_translated_sqlite_error(db);
+                }
+            }
+        }
+
+        struct vec_dot_string {
+            serialize_result_type serialize() const {
+                return "vec_dot";
+            }
+        };
+
+        struct vec_l2_string {
+            serialize_result_type serialize() const {
+                return "vec_l2";
+            }
+        };
+
+        struct vec_cosine_string {
+            serialize_result_type serialize() const {
+                return "vec_cosine";
+            }
+        };
+
+        struct top_k_string {
+            serialize_result_type serialize() const {
+                return "top_k";
+            }
+        };
+    }
+
+    /**
+     *  The BLOB the vector functions read: the float32 values of `values` in the byte order of the CPU.
+     *  Store embeddings as `std::vector<char>` columns of such blobs.
+     */
+    inline std::vector<char> vector_blob(const std::vector<float>& values) {
+        std::vector<char> res(values.size() * sizeof(float));
+        if(!values.empty()) {
+            std::memcpy(res.data(), values.data(), res.size());
+        }
+        return res;
+    }
+
+    /**
+     *  The float32 values of a BLOB made by `vector_blob()`.
+     */
+    inline std::vector<float> vector_values(const std::vector<char>& blob) {
+        std::vector<float> res(blob.size() / sizeof(float));
+        if(!res.empty()) {
+            std::memcpy(res.data(), blob.data(), res.size() * sizeof(float));
+        }
+        return res;
+    }
+
+    /**
+     *  vec_dot(X, Y), the dot product of two float32 vectors, see `storage.enable_vector_functions()`.
+     */
+    template<class X, class Y>
+    internal::built_in_function_t<double, internal::vec_dot_string, X, Y> vec_dot(X x, Y y) {
+        return {std::tuple<X, Y>{std::forward<X>(x), std::forward<Y>(y)}};
+    }
+
+    /**
+     *  vec_l2(X, Y), the Euclidean distance of two float32 vectors, see `storage.enable_vector_functions()`.
+     */
+    template<class X, class Y>
+    internal::built_in_function_t<double, internal::vec_l2_string, X, Y> vec_l2(X x, Y y) {
+        return {std::tuple<X, Y>{std::forward<X>(x), std::forward<Y>(y)}};
+    }
+
+    /**
+     *  vec_cosine(X, Y), the cosine similarity of two float32 vectors, from -1 to 1, NULL if one is zero. See
+     *  `storage.enable_vector_functions()`.
+     */
+    template<class X, class Y>
+    internal::built_in_function_t<double, internal::vec_cosine_string, X, Y> vec_cosine(X x, Y y) {
+        return {std::tuple<X, Y>{std::forward<X>(x), std::forward<Y>(y)}};
+    }
+
+    /**
+     *  top_k(X, S, K) aggregate function, the K integer values X with the smallest scores S as a JSON array,
+     *  the smallest score first. Rows with a NULL score are skipped. Use a negated similarity as the score
+     *  to get the most similar first. See `storage.enable_vector_functions()`.
+     *  Example: storage.select(top_k(&Item::id, vec_l2(&Item::embedding, query), 10), group_by(&Item::category));
+     */
+    template<class X, class S>
+    internal::built_in_aggregate_function_t<std::string, internal::top_k_string, X, S, int>
+    top_k(X x, S score, int k) {
+        return {std::tuple<X, S, int>{std::forward<X>(x), std::forward<S>(score), k}};
+    }
+}
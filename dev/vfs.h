@@ -0,0 +1,663 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <algorithm>  //  std::max, std::min
+#include <atomic>  //  std::atomic
+#include <chrono>  //  std::chrono::steady_clock
+#include <cstdint>  //  uint64_t
+#include <cstring>  //  std::memcpy, std::memset
+#include <list>  //  std::list
+#include <map>  //  std::map
+#include <functional>  //  std::hash
+#include <memory>  //  std::shared_ptr, std::unique_ptr
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <new>  //  placement new
+#include <string>  //  std::string
+#include <system_error>  //  std::system_error
+#include <unordered_map>  //  std::unordered_map
+#include <utility>  //  std::move, std::pair
+#include <vector>  //  std::vector
+
+#include "error_code.h"
+#include "io_statistics.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+        struct vfs_shim_registration;
+    }
+
+    /**
+     *  A file opened through a VFS registered with `register_vfs_shim()`, handed to the calls of `vfs_shim`.
+     *  Its I/O functions go to the file of the underlying VFS.
+     */
+    class vfs_file {
+      public:
+        /**
+         *  Full path of the file, empty for temporary files without a name.
+         */
+        const std::string& name() const {
+            return this->fileName;
+        }
+
+        /**
+         *  SQLITE_OPEN_* flags the file is opened with, e.g. SQLITE_OPEN_MAIN_DB for a database file.
+         */
+        int flags() const {
+            return this->openFlags;
+        }
+
+        bool is_main_db() const {
+            return (this->openFlags & SQLITE_OPEN_MAIN_DB) != 0;
+        }
+
+        int read(void* buffer, int amount, sqlite3_int64 offset) {
+            return this->file->pMethods->xRead(this->file, buffer, amount, offset);
+        }
+
+        int write(const void* buffer, int amount, sqlite3_int64 offset) {
+            return this->file->pMethods->xWrite(this->file, buffer, amount, offset);
+        }
+
+        int truncate(sqlite3_int64 size) {
+            return this->file->pMethods->xTruncate(this->file, size);
+        }
+
+        int sync(int flags) {
+            return this->file->pMethods->xSync(this->file, flags);
+        }
+
+        int size(sqlite3_int64& result) {
+            return this->file->pMethods->xFileSize(this->file, &result);
+        }
+
+        int lock(int level) {
+            return this->file->pMethods->xLock(this->file, level);
+        }
+
+        /**
+         *  Whatever the shim keeps for the file, released when the file is closed.
+         */
+        std::shared_ptr<void> state;
+
+      protected:
+        friend struct internal::vfs_shim_registration;
+
+        vfs_file(std::string fileName_, int openFlags_, sqlite3_file* file_) :
+            fileName(std::move(fileName_)), openFlags(openFlags_), file(file_) {}
+
+        std::string fileName;
+        int openFlags;
+        sqlite3_file* file;
+    };
+
+    /**
+     *  The I/O of a VFS made by `register_vfs_shim()` from an existing VFS. Every call is forwarded to the
+     *  underlying file unless overridden. The calls come from all connections using the VFS at once, so
+     *  overrides have to be thread safe.
+     */
+    class vfs_shim {
+      public:
+        virtual ~vfs_shim() = default;
+
+        virtual void opened(vfs_file& /*file*/) {}
+
+        virtual void closing(vfs_file& /*file*/) {}
+
+        virtual int read(vfs_file& file, void* buffer, int amount, sqlite3_int64 offset) {
+            return file.read(buffer, amount, offset);
+        }
+
+        virtual int write(vfs_file& file, const void* buffer, int amount, sqlite3_int64 offset) {
+            return file.write(buffer, amount, offset);
+        }
+
+        virtual int truncate(vfs_file& file, sqlite3_int64 size) {
+            return file.truncate(size);
+        }
+
+        virtual int sync(vfs_file& file, int flags) {
+            return file.sync(flags);
+        }
+
+        virtual int lock(vfs_file& file, int level) {
+            return file.lock(level);
+        }
+    };
+
+    namespace internal {
+
+        /**
+         *  A registered shim: a copy of the underlying VFS whose functions forward to it and whose files wrap
+         *  the files of the underlying VFS.
+         */
+        struct vfs_shim_registration {
+            sqlite3_vfs vfs;
+            sqlite3_vfs* base;
+            std::string name;
+            std::shared_ptr<vfs_shim> shim;
+
+            /**
+             *  The memory SQLite allocates for a file: this struct followed by the file of the underlying VFS.
+             */
+            struct file_type {
+                sqlite3_file base;
+                vfs_shim_registration* registration;
+                vfs_file* file;
+            };
+
+            static constexpr size_t real_file_offset = (sizeof(file_type) + 7) / 8 * 8;
+
+            vfs_shim_registration(std::string name_, sqlite3_vfs* base_, std::shared_ptr<vfs_shim> shim_) :
+                vfs(*base_), base(base_), name(std::move(name_)), shim(std::move(shim_)) {
+                this->vfs.pNext = nullptr;
+                this->vfs.zName = this->name.c_str();
+                this->vfs.pAppData = this;
+                this->vfs.szOsFile = int(real_file_offset) + base_->szOsFile;
+                this->vfs.xOpen = open;
+                this->vfs.xDelete = [](sqlite3_vfs* vfs, const char* name, int syncDir) {
+                    return of(vfs)->xDelete(of(vfs), name, syncDir);
+                };
+                this->vfs.xAccess = [](sqlite3_vfs* vfs, const char* name, int flags, int* result) {
+                    return of(vfs)->xAccess(of(vfs), name, flags, result);
+                };
+                this->vfs.xFullPathname = [](sqlite3_vfs* vfs, const char* name, int size, char* result) {
+                    return of(vfs)->xFullPathname(of(vfs), name, size, result);
+                };
+                this->vfs.xDlOpen = [](sqlite3_vfs* vfs, const char* name) {
+                    return of(vfs)->xDlOpen(of(vfs), name);
+                };
+                this->vfs.xDlError = [](sqlite3_vfs* vfs, int size, char* message) {
+                    of(vfs)->xDlError(of(vfs), size, message);
+                };
+                this->vfs.xDlSym = [](sqlite3_vfs* vfs, void* handle, const char* symbol) {
+                    return of(vfs)->xDlSym(of(vfs), handle, symbol);
+                };
+                this->vfs.xDlClose = [](sqlite3_vfs* vfs, void* handle) {
+                    of(vfs)->xDlClose(of(vfs), handle);
+                };
+                this->vfs.xRandomness = [](sqlite3_vfs* vfs, int size, char* result) {
+                    return of(vfs)->xRandomness(of(vfs), size, result);
+                };
+                this->vfs.xSleep = [](sqlite3_vfs* vfs, int microseconds) {
+                    return of(vfs)->xSleep(of(vfs), microseconds);
+                };
+                this->vfs.xCurrentTime = [](sqlite3_vfs* vfs, double* result) {
+                    return of(vfs)->xCurrentTime(of(vfs), result);
+                };
+                this->vfs.xGetLastError = [](sqlite3_vfs* vfs, int size, char* message) {
+                    return of(vfs)->xGetLastError(of(vfs), size, message);
+                };
+                if(this->vfs.iVersion >= 2 && base_->xCurrentTimeInt64) {
+                    this->vfs.xCurrentTimeInt64 = [](sqlite3_vfs* vfs, sqlite3_int64* result) {
+                        return of(vfs)->xCurrentTimeInt64(of(vfs), result);
+                    };
+                }
+                if(this->vfs.iVersion >= 3) {
+                    this->vfs.xSetSystemCall = [](sqlite3_vfs* vfs, const char* name, sqlite3_syscall_ptr call) {
+                        return of(vfs)->xSetSystemCall(of(vfs), name, call);
+                    };
+                    this->vfs.xGetSystemCall = [](sqlite3_vfs* vfs, const char* name) {
+                        return of(vfs)->xGetSystemCall(of(vfs), name);
+                    };
+                    this->vfs.xNextSystemCall = [](sqlite3_vfs* vfs, const char* name) {
+                        return of(vfs)->xNextSystemCall(of(vfs), name);
+                    };
+                }
+            }
+
+            static sqlite3_vfs* of(sqlite3_vfs* vfs) {
+                return static_cast<vfs_shim_registration*>(vfs->pAppData)->base;
+            }
+
+            static file_type& file_of(sqlite3_file* file) {
+                return *reinterpret_cast<file_type*>(file);
+            }
+
+            static sqlite3_file* real_of(sqlite3_file* file) {
+                return reinterpret_cast<sqlite3_file*>(reinterpret_cast<char*>(file) + real_file_offset);
+            }
+
+            static int open(sqlite3_vfs* vfs, const char* name, sqlite3_file* file, int flags, int* outFlags) {
+                auto registration = static_cast<vfs_shim_registration*>(vfs->pAppData);
+                auto real = real_of(file);
+                auto& wrapper = file_of(file);
+                wrapper.base.pMethods = nullptr;
+                auto rc = registration->base->xOpen(registration->base, name, real, flags, outFlags);
+                if(rc != SQLITE_OK) {
+                    return rc;
+                }
+                try {
+                    wrapper.file = new vfs_file{name ? name : "", flags, real};
+                } catch(...) {
+                    real->pMethods->xClose(real);
+                    return SQLITE_NOMEM;
+                }
+                wrapper.registration = registration;
+                wrapper.base.pMethods = methods_of_version(real->pMethods->iVersion);
+                registration->shim->opened(*wrapper.file);
+                return SQLITE_OK;
+            }
+
+            static const sqlite3_io_methods* methods_of_version(int version) {
+                static const sqlite3_io_methods methods[] = {make_methods(1), make_methods(2), make_methods(3)};
+                return &methods[(version < 1 ? 1 : version > 3 ? 3 : version) - 1];
+            }
+
+            static sqlite3_io_methods make_methods(int version) {
+                sqlite3_io_methods result;
+                std::memset(&result, 0, sizeof(result));
+                result.iVersion = version;
+                result.xClose = [](sqlite3_file* file) {
+                    auto& wrapper = file_of(file);
+                    wrapper.registration->shim->closing(*wrapper.file);
+                    delete wrapper.file;
+                    auto real = real_of(file);
+                    return real->pMethods->xClose(real);
+                };
+                result.xRead = [](sqlite3_file* file, void* buffer, int amount, sqlite3_int64 offset) {
+                    auto& wrapper = file_of(file);
+                    return wrapper.registration->shim->read(*wrapper.file, buffer, amount, offset);
+                };
+                result.xWrite = [](sqlite3_file* file, const void* buffer, int amount, sqlite3_int64 offset) {
+                    auto& wrapper = file_of(file);
+                    return wrapper.registration->shim->write(*wrapper.file, buffer, amount, offset);
+                };
+                result.xTruncate = [](sqlite3_file* file, sqlite3_int64 size) {
+                    auto& wrapper = file_of(file);
+                    return wrapper.registration->shim->truncate(*wrapper.file, size);
+                };
+                result.xSync = [](sqlite3_file* file, int flags) {
+                    auto& wrapper = file_of(file);
+                    return wrapper.registration->shim->sync(*wrapper.file, flags);
+                };
+                result.xFileSize = [](sqlite3_file* file, sqlite3_int64* size) {
+                    auto real = real_of(file);
+                    return real->pMethods->xFileSize(real, size);
+                };
+                result.xLock = [](sqlite3_file* file, int level) {
+                    auto& wrapper = file_of(file);
+                    return wrapper.registration->shim->lock(*wrapper.file, level);
+                };
+                result.xUnlock = [](sqlite3_file* file, int lock) {
+                    auto real = real_of(file);
+                    return real->pMethods->xUnlock(real, lock);
+                };
+                result.xCheckReservedLock = [](sqlite3_file* file, int* result) {
+                    auto real = real_of(file);
+                    return real->pMethods->xCheckReservedLock(real, result);
+                };
+                result.xFileControl = [](sqlite3_file* file, int op, void* argument) {
+                    auto real = real_of(file);
+                    return real->pMethods->xFileControl(real, op, argument);
+                };
+                result.xSectorSize = [](sqlite3_file* file) {
+                    auto real = real_of(file);
+                    return real->pMethods->xSectorSize(real);
+                };
+                result.xDeviceCharacteristics = [](sqlite3_file* file) {
+                    auto real = real_of(file);
+                    return real->pMethods->xDeviceCharacteristics(real);
+                };
+                if(version >= 2) {
+                    result.xShmMap = [](sqlite3_file* file, int page, int size, int extend, void volatile** result) {
+                        auto real = real_of(file);
+                        return real->pMethods->xShmMap(real, page, size, extend, result);
+                    };
+                    result.xShmLock = [](sqlite3_file* file, int offset, int n, int flags) {
+                        auto real = real_of(file);
+                        return real->pMethods->xShmLock(real, offset, n, flags);
+                    };
+                    result.xShmBarrier = [](sqlite3_file* file) {
+                        auto real = real_of(file);
+                        real->pMethods->xShmBarrier(real);
+                    };
+                    result.xShmUnmap = [](sqlite3_file* file, int deleteFlag) {
+                        auto real = real_of(file);
+                        return real->pMethods->xShmUnmap(real, deleteFlag);
+                    };
+                }
+                if(version >= 3) {
+                    //  no memory mapped reads, they would go around the shim
+                    result.xFetch = [](sqlite3_file*, sqlite3_int64, int, void** result) {
+                        *result = nullptr;
+                        return SQLITE_OK;
+                    };
+                    result.xUnfetch = [](sqlite3_file*, sqlite3_int64, void*) {
+                        return SQLITE_OK;
+                    };
+                }
+                return result;
+            }
+        };
+
+        struct vfs_shim_registry {
+            std::mutex mutex;
+            std::map<std::string, std::unique_ptr<vfs_shim_registration>> registrations;
+
+            static vfs_shim_registry& instance() {
+                static vfs_shim_registry registry;
+                return registry;
+            }
+        };
+    }
+
+    /**
+     *  Registers the VFS `name` which does the I/O of `baseVfs`, the default VFS if empty, through `shim`.
+     *  Storages use it with `open_options::vfs`, or all connections opened afterwards if `makeDefault`. It
+     *  replaces a shim registered with the same name, which must not be in use any more.
+     *  https://sqlite.org/vfs.html
+     */
+    inline void register_vfs_shim(const std::string& name,
+                                  std::shared_ptr<vfs_shim> shim,
+                                  const std::string& baseVfs = {},
+                                  bool makeDefault = false) {
+        auto base = sqlite3_vfs_find(baseVfs.empty() ? nullptr : baseVfs.c_str());
+        if(!base) {
+            throw std::system_error{orm_error_code::vfs_not_found};
+        }
+        auto& registry = internal::vfs_shim_registry::instance();
+        std::lock_guard<std::mutex> lock{registry.mutex};
+        auto& registration = registry.registrations[name];
+        if(registration) {
+            sqlite3_vfs_unregister(&registration->vfs);
+        }
+        registration = std::make_unique<internal::vfs_shim_registration>(name, base, std::move(shim));
+        auto rc = sqlite3_vfs_register(&registration->vfs, makeDefault ? 1 : 0);
+        if(rc != SQLITE_OK) {
+            registry.registrations.erase(name);
+            throw_translated_sqlite_error(rc);
+        }
+    }
+
+    /**
+     *  Unregisters a VFS registered with `register_vfs_shim()`. No connection may use it any more.
+     */
+    inline void unregister_vfs_shim(const std::string& name) {
+        auto& registry = internal::vfs_shim_registry::instance();
+        std::lock_guard<std::mutex> lock{registry.mutex};
+        auto it = registry.registrations.find(name);
+        if(it != registry.registrations.end()) {
+            sqlite3_vfs_unregister(&it->second->vfs);
+            registry.registrations.erase(it);
+        }
+    }
+
+    /**
+     *  Counters of a `page_cache_shim`.
+     */
+    struct page_cache_stats {
+
+        /**
+         *  Calls of the files of all kinds, journals and WAL files included.
+         */
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t syncs = 0;
+
+        /**
+         *  Reads of database files served by the cache and the ones that went to the file.
+         */
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        size_t cached_bytes = 0;
+    };
+
+    /**
+     *  A `vfs_shim` keeping blocks of database files in a cache shared by all connections of all storages
+     *  using the VFS, in addition to the private page cache of every connection. Reads that cover whole
+     *  blocks are served from the cache, writes go to the file and replace the cached blocks they touch.
+     *  The least recently used blocks are dropped when `capacity` bytes are exceeded.
+     *  The cache doesn't see changes by other processes, so only use it for databases nothing outside of
+     *  this process writes. `block_size` should be the page size of the databases.
+     *
+     *  Example:
+     *  auto cache = std::make_shared<page_cache_shim>(64 << 20);
+     *  register_vfs_shim("cached", cache);
+     *  open_options options;
+     *  options.vfs = "cached";
+     *  auto storage = make_storage("tenant.sqlite", options, make_table(...));
+     */
+    class page_cache_shim : public vfs_shim {
+      public:
+        explicit page_cache_shim(size_t capacity_, int blockSize_ = 4096) :
+            capacity(capacity_), blockSize(blockSize_) {}
+
+        page_cache_stats stats() {
+            page_cache_stats result;
+            result.reads = this->reads;
+            result.writes = this->writes;
+            result.syncs = this->syncs;
+            result.hits = this->hits;
+            result.misses = this->misses;
+            std::lock_guard<std::mutex> lock{this->mutex};
+            result.cached_bytes = this->lru.size() * size_t(this->blockSize);
+            return result;
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->blocks.clear();
+            this->lru.clear();
+        }
+
+        int read(vfs_file& file, void* buffer, int amount, sqlite3_int64 offset) override {
+            ++this->reads;
+            if(!file.is_main_db() || file.name().empty()) {
+                return file.read(buffer, amount, offset);
+            }
+            auto output = static_cast<char*>(buffer);
+            auto first = offset / this->blockSize;
+            auto last = (offset + amount - 1) / this->blockSize;
+            for(auto index = first; index <= last; ++index) {
+                const auto blockOffset = index * this->blockSize;
+                const auto begin = std::max(offset, blockOffset);
+                const auto end = std::min(offset + amount, blockOffset + this->blockSize);
+                if(!this->copy_cached(file.name(), index, output + (begin - offset), begin - blockOffset,
+                                      end - begin)) {
+                    ++this->misses;
+                    std::vector<char> block(size_t(this->blockSize));
+                    auto rc = file.read(block.data(), this->blockSize, blockOffset);
+                    if(rc != SQLITE_OK) {
+                        //  a block at the end of the file is read as requested and not cached
+                        return rc == SQLITE_IOERR_SHORT_READ ? file.read(buffer, amount, offset) : rc;
+                    }
+                    std::memcpy(output + (begin - offset), block.data() + (begin - blockOffset), size_t(end - begin));
+                    this->store(file.name(), index, std::move(block));
+                } else {
+                    ++this->hits;
+                }
+            }
+            return SQLITE_OK;
+        }
+
+        int write(vfs_file& file, const void* buffer, int amount, sqlite3_int64 offset) override {
+            ++this->writes;
+            if(file.is_main_db()) {
+                this->invalidate(file.name(), offset, offset + amount);
+            }
+            return file.write(buffer, amount, offset);
+        }
+
+        int truncate(vfs_file& file, sqlite3_int64 size) override {
+            if(file.is_main_db()) {
+                this->invalidate(file.name(), size, -1);
+            }
+            return file.truncate(size);
+        }
+
+        int sync(vfs_file& file, int flags) override {
+            ++this->syncs;
+            return file.sync(flags);
+        }
+
+      protected:
+        using key_type = std::pair<std::string, sqlite3_int64>;
+
+        struct key_hash {
+            size_t operator()(const key_type& key) const {
+                return std::hash<std::string>{}(key.first) ^ (std::hash<sqlite3_int64>{}(key.second) << 1);
+            }
+        };
+
+        struct cached_block {
+            std::vector<char> data;
+            std::list<key_type>::iterator position;
+        };
+
+        bool copy_cached(const std::string& name,
+                         sqlite3_int64 index,
+                         char* output,
+                         sqlite3_int64 offset,
+                         sqlite3_int64 size) {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            auto it = this->blocks.find(key_type{name, index});
+            if(it == this->blocks.end()) {
+                return false;
+            }
+            this->lru.splice(this->lru.begin(), this->lru, it->second.position);
+            std::memcpy(output, it->second.data.data() + offset, size_t(size));
+            return true;
+        }
+
+        void store(const std::string& name, sqlite3_int64 index, std::vector<char> data) {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            key_type key{name, index};
+            auto it = this->blocks.find(key);
+            if(it != this->blocks.end()) {
+                it->second.data = std::move(data);
+                this->lru.splice(this->lru.begin(), this->lru, it->second.position);
+                return;
+            }
+            this->lru.push_front(key);
+            this->blocks.emplace(std::move(key), cached_block{std::move(data), this->lru.begin()});
+            while(!this->lru.empty() && this->lru.size() * size_t(this->blockSize) > this->capacity) {
+                this->blocks.erase(this->lru.back());
+                this->lru.pop_back();
+            }
+        }
+
+        /**
+         *  Drops the cached blocks of `name` overlapping [begin, end), up to the end of the file if `end` is -1.
+         */
+        void invalidate(const std::string& name, sqlite3_int64 begin, sqlite3_int64 end) {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            for(auto it = this->lru.begin(); it != this->lru.end();) {
+                const auto blockBegin = it->second * this->blockSize;
+                const bool overlaps = blockBegin + this->blockSize > begin && (end == -1 || blockBegin < end);
+                if(it->first == name && overlaps) {
+                    this->blocks.erase(*it);
+                    it = this->lru.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        const size_t capacity;
+        const sqlite3_int64 blockSize;
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> writes{0};
+        std::atomic<uint64_t> syncs{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::mutex mutex;
+        std::list<key_type> lru;
+        std::unordered_map<key_type, cached_block, key_hash> blocks;
+    };
+
+    /**
+     *  A `vfs_shim` counting the I/O of every database file, including its journal and WAL, for
+     *  `storage.io_stats()` and the `io` counters of `statement_profile`. It measures every call, which costs
+     *  two clock reads per call. Memory mapped reads can't be counted, they are disabled for files opened
+     *  through a shim.
+     *
+     *  Example:
+     *  register_vfs_shim("accounted", std::make_shared<io_accounting_shim>());
+     *  open_options options;
+     *  options.vfs = "accounted";
+     *  auto storage = make_storage(options, "app.sqlite", make_table(...));
+     *  auto fsyncsPerCommit = double(storage.io_stats().syncs) / commits;
+     */
+    class io_accounting_shim : public vfs_shim {
+      public:
+        void opened(vfs_file& file) override {
+            auto path = file.name();
+            if(file.flags() & (SQLITE_OPEN_MAIN_JOURNAL | SQLITE_OPEN_WAL)) {
+                const std::string suffix = file.flags() & SQLITE_OPEN_WAL ? "-wal" : "-journal";
+                const auto stem = path.size() - suffix.size();
+                if(path.size() > suffix.size() && path.compare(stem, suffix.size(), suffix) == 0) {
+                    path.resize(stem);
+                }
+            } else if(!file.is_main_db()) {
+                return;
+            }
+            if(!path.empty()) {
+                file.state = internal::io_accounting_registry::instance().get(path, true);
+            }
+        }
+
+        int read(vfs_file& file, void* buffer, int amount, sqlite3_int64 offset) override {
+            const auto start = std::chrono::steady_clock::now();
+            auto rc = file.read(buffer, amount, offset);
+            const auto duration = std::chrono::steady_clock::now() - start;
+            this->account(file, [amount, duration](io_counters& counters, io_statistics* stats) {
+                ++counters.reads;
+                counters.bytes_read += uint64_t(amount);
+                if(stats) {
+                    stats->read_latency.record(duration);
+                }
+            });
+            return rc;
+        }
+
+        int write(vfs_file& file, const void* buffer, int amount, sqlite3_int64 offset) override {
+            const auto start = std::chrono::steady_clock::now();
+            auto rc = file.write(buffer, amount, offset);
+            const auto duration = std::chrono::steady_clock::now() - start;
+            this->account(file, [amount, duration](io_counters& counters, io_statistics* stats) {
+                ++counters.writes;
+                counters.bytes_written += uint64_t(amount);
+                if(stats) {
+                    stats->write_latency.record(duration);
+                }
+            });
+            return rc;
+        }
+
+        int sync(vfs_file& file, int flags) override {
+            const auto start = std::chrono::steady_clock::now();
+            auto rc = file.sync(flags);
+            const auto duration = std::chrono::steady_clock::now() - start;
+            this->account(file, [duration](io_counters& counters, io_statistics* stats) {
+                ++counters.syncs;
+                counters.sync_time += duration;
+                if(stats) {
+                    stats->sync_latency.record(duration);
+                }
+            });
+            return rc;
+        }
+
+        int lock(vfs_file& file, int level) override {
+            auto rc = file.lock(level);
+            if(rc == SQLITE_BUSY) {
+                this->account(file, [](io_counters& counters, io_statistics*) {
+                    ++counters.busy_locks;
+                });
+            }
+            return rc;
+        }
+
+      protected:
+        template<class F>
+        void account(vfs_file& file, const F& update) {
+            update(internal::thread_io_counters(), nullptr);
+            if(auto entry = static_cast<internal::io_accounting_registry::entry*>(file.state.get())) {
+                std::lock_guard<std::mutex> lock{entry->mutex};
+                update(entry->stats, &entry->stats);
+            }
+        }
+    };
+}
@@ -1,13 +1,21 @@
 #pragma once
 
 #include <sqlite3.h>
+#include <functional>  //  std::function
+#include <memory>  //  std::shared_ptr, std::make_shared
 #include <string>  //  std::string
+#include <type_traits>  //  std::conditional_t, std::decay_t
 #include <utility>  //  std::forward, std::move
 #include <tuple>  //  std::tuple, std::make_tuple
 
+#include "functional/cxx_type_traits_polyfill.h"
+#include "functional/static_magic.h"
+#include "tuple_helper/tuple_filter.h"
+#include "tuple_helper/tuple_iteration.h"
 #include "row_extractor.h"
 #include "error_code.h"
 #include "iterator.h"
+#include "prefetch_iterator.h"
 #include "ast_iterator.h"
 #include "prepared_statement.h"
 #include "connection_holder.h"
@@ -25,6 +33,9 @@ namespace sqlite_orm {
          *  -   iterator end()
          *  -   iterator begin()
          *  All these functions are not right const cause all of them may open SQLite connections.
+         *  With a `prefetch()` hint the iterators take the rows from a thread reading them ahead.
+         *  Every call runs its own query: call `size()` and `begin()` inside one `storage.read_transaction()`
+         *  for them to agree.
          */
         template<class T, class S, class... Args>
         struct view_t {
@@ -32,35 +43,155 @@ namespace sqlite_orm {
             using storage_type = S;
             using self = view_t<T, S, Args...>;
 
+            static constexpr bool prefetching = count_tuple<std::tuple<std::decay_t<Args>...>, is_prefetch>::value > 0;
+
+            using iterator = std::conditional_t<prefetching, prefetch_iterator_t<self>, iterator_t<self>>;
+
             storage_type& storage;
             connection_ref connection;
             get_all_t<T, std::vector<T>, Args...> args;
 
+            /**
+             *  Acquires the connection the thread of `prefetch()` reads with, `connection` if not set.
+             */
+            std::function<connection_ref()> reader;
+
             view_t(storage_type& stor, decltype(connection) conn, Args&&... args_) :
                 storage(stor), connection(std::move(conn)), args{std::make_tuple(std::forward<Args>(args_)...)} {}
 
+            /**
+             *  Number of rows the view iterates over, with respect to its conditions.
+             */
             size_t size() {
-                return this->storage.template count<T>();
+                return size_t(this->query_over_rows("SELECT COUNT(*) FROM (", ")"));
             }
 
             bool empty() {
-                return !this->size();
+                return this->query_over_rows("SELECT EXISTS (", ")") == 0;
             }
 
-            iterator_t<self> begin() {
+            iterator begin() {
+                return this->begin(polyfill::bool_constant<prefetching>{});
+            }
+
+            iterator end() {
+                return {};
+            }
+
+          protected:
+            iterator_t<self> begin(std::false_type) {
+                statement_finalizer stmt{prepare_stmt(this->connection.get(), this->serialize_args())};
+                iterate_ast(this->args.conditions, conditional_binder{stmt.get()});
+                return {move(stmt), *this};
+            }
+
+            prefetch_iterator_t<self> begin(std::true_type) {
+                size_t rows = 0;
+                iterate_tuple(this->args.conditions, [&rows](auto& condition) {
+                    call_if_constexpr<is_prefetch<std::decay_t<decltype(condition)>>::value>(
+                        [&rows](const prefetch_t& hint) {
+                            rows = hint.rows;
+                        },
+                        condition);
+                });
+                auto buffer = std::make_shared<prefetch_buffer<T>>(rows);
+                buffer->start([this](prefetch_buffer<T>& buffer) {
+                    connection_ref con = this->reader ? this->reader() : this->connection;
+                    statement_finalizer stmt{prepare_stmt(con.get(), this->serialize_args())};
+                    iterate_ast(this->args.conditions, conditional_binder{stmt.get()});
+                    auto& table = pick_table<T>(obtain_db_objects(this->storage));
+                    while(T* object = buffer.slot_to_fill()) {
+                        bool hasRow = false;
+                        perform_step(stmt.get(), [this, object, &table, &hasRow](sqlite3_stmt* stmt) {
+                            build_object(*object, stmt, table, this->args.conditions);
+                            hasRow = true;
+                        });
+                        if(!hasRow) {
+                            break;
+                        }
+                        buffer.publish();
+                    }
+                });
+                return {std::move(buffer)};
+            }
+
+            std::string serialize_args() {
                 using context_t = serializer_context<typename storage_type::db_objects_type>;
                 context_t context{obtain_db_objects(this->storage)};
                 context.skip_table_name = false;
                 context.replace_bindable_with_question = true;
+                return serialize(this->args, context);
+            }
 
-                statement_finalizer stmt{prepare_stmt(this->connection.get(), serialize(this->args, context))};
+            /**
+             *  Runs a scalar query wrapped around the SELECT of the view on the connection of the view.
+             */
+            sqlite3_int64 query_over_rows(const char* prefix, const char* suffix) {
+                statement_finalizer stmt{
+                    prepare_stmt(this->connection.get(), prefix + this->serialize_args() + suffix)};
                 iterate_ast(this->args.conditions, conditional_binder{stmt.get()});
-                return {move(stmt), *this};
+                sqlite3_int64 res = 0;
+                perform_steps(stmt.get(), [&res](sqlite3_stmt* stmt) {
+                    res = sqlite3_column_int64(stmt, 0);
+                });
+                return res;
+            }
+        };
+
+        /**
+         *  The view returned by `storage_t::iterate(statement)`, iterating over the rows of the prepared get all
+         *  statement `statement`. `begin()` resets and binds the statement instead of preparing a new one, and
+         *  `size()` and `empty()` step through it, so only one iteration over the statement can be under way at a
+         *  time. The statement has to outlive the view and its iterators.
+         */
+        template<class T, class S, class R, class... Args>
+        struct prepared_view_t {
+            using mapped_type = T;
+            using storage_type = S;
+            using self = prepared_view_t<T, S, R, Args...>;
+            using expression_type = get_all_t<T, R, Args...>;
+
+            storage_type& storage;
+            const prepared_statement_t<expression_type>& statement;
+            const expression_type& args;
+
+            prepared_view_t(storage_type& stor, const prepared_statement_t<expression_type>& statement_) :
+                storage(stor), statement(statement_), args(statement_.expression) {}
+
+            size_t size() {
+                size_t res = 0;
+                perform_steps(this->bind(), [&res](sqlite3_stmt*) {
+                    ++res;
+                });
+                return res;
+            }
+
+            bool empty() {
+                bool res = true;
+                perform_step(this->bind(), [&res](sqlite3_stmt*) {
+                    res = false;
+                });
+                sqlite3_reset(this->statement.stmt);
+                return res;
+            }
+
+            /**
+             *  The iterator resets the statement when it reaches the end or the last copy of it is destroyed.
+             */
+            iterator_t<self> begin() {
+                return {std::shared_ptr<sqlite3_stmt>{this->bind(), sqlite3_reset}, *this};
             }
 
             iterator_t<self> end() {
                 return {};
             }
+
+          private:
+            sqlite3_stmt* bind() {
+                sqlite3_stmt* stmt = reset_stmt(this->statement.stmt);
+                iterate_ast(this->args.conditions, conditional_binder{stmt});
+                return stmt;
+            }
         };
     }
 }
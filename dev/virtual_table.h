@@ -0,0 +1,215 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <exception>  //  std::exception
+#include <memory>  //  std::shared_ptr, std::make_shared, std::enable_shared_from_this
+#include <new>  //  std::nothrow
+#include <sstream>  //  std::stringstream
+#include <string>  //  std::string
+#include <tuple>  //  std::tuple
+#include <type_traits>  //  std::tuple_element_t
+#include <utility>  //  std::move, std::forward
+
+#include "functional/cxx_universal.h"
+#include "type_printer.h"
+#include "table.h"
+#include "util.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  A virtual table module implemented by a C++ class, registered on every connection of a storage.
+         */
+        struct virtual_table_module_base {
+            virtual ~virtual_table_module_base() = default;
+
+            /**
+             *  Registers the module `name` on `db`, which makes it an eponymous table of that name.
+             */
+            virtual void create_module(sqlite3* db, const std::string& name) const = 0;
+        };
+
+        /**
+         *  The `sqlite3_module` calling the hooks of a module class M and of its cursors.
+         */
+        template<class M>
+        struct virtual_table_module : virtual_table_module_base,
+                                      std::enable_shared_from_this<virtual_table_module<M>> {
+            using module_type = M;
+            using cursor_type = typename M::cursor_type;
+
+            module_type module;
+
+            /**
+             *  The `CREATE TABLE` statement declaring the columns of the table to SQLite.
+             */
+            std::string schema;
+
+            virtual_table_module(module_type module_, std::string schema_) :
+                module(std::move(module_)), schema(move(schema_)) {}
+
+            void create_module(sqlite3* db, const std::string& name) const override {
+                static const sqlite3_module sqliteModule = make_sqlite_module();
+                auto aux = const_cast<virtual_table_module*>(this);
+                if(sqlite3_create_module_v2(db, name.c_str(), &sqliteModule, aux, nullptr) != SQLITE_OK) {
+                    throw_translated_sqlite_error(db);
+                }
+            }
+
+          private:
+            struct vtab : sqlite3_vtab {
+                std::shared_ptr<const virtual_table_module> owner;
+            };
+
+            struct cursor : sqlite3_vtab_cursor {
+                cursor_type impl;
+
+                cursor(cursor_type impl_) : impl(std::move(impl_)) {}
+            };
+
+            static sqlite3_module make_sqlite_module() {
+                sqlite3_module res{};
+                //  no xCreate makes the table eponymous-only: it exists without CREATE VIRTUAL TABLE
+                res.xConnect = connect;
+                res.xBestIndex = best_index;
+                res.xDisconnect = disconnect;
+                res.xOpen = open;
+                res.xClose = close;
+                res.xFilter = filter;
+                res.xNext = next;
+                res.xEof = eof;
+                res.xColumn = column;
+                res.xRowid = rowid;
+                return res;
+            }
+
+            static int set_error(sqlite3_vtab* table, const std::exception& exception) {
+                sqlite3_free(table->zErrMsg);
+                table->zErrMsg = sqlite3_mprintf("%s", exception.what());
+                return SQLITE_ERROR;
+            }
+
+            static int connect(sqlite3* db, void* aux, int, const char* const*, sqlite3_vtab** table, char**) {
+                auto& self = *static_cast<const virtual_table_module*>(aux);
+                auto rc = sqlite3_declare_vtab(db, self.schema.c_str());
+                if(rc != SQLITE_OK) {
+                    return rc;
+                }
+                auto res = new(std::nothrow) vtab{};
+                if(!res) {
+                    return SQLITE_NOMEM;
+                }
+                res->owner = self.shared_from_this();
+                *table = res;
+                return SQLITE_OK;
+            }
+
+            static int disconnect(sqlite3_vtab* table) {
+                delete static_cast<vtab*>(table);
+                return SQLITE_OK;
+            }
+
+            static int best_index(sqlite3_vtab* table, sqlite3_index_info* info) {
+                try {
+                    return static_cast<vtab*>(table)->owner->module.best_index(*info);
+                } catch(const std::exception& e) {
+                    return set_error(table, e);
+                }
+            }
+
+            static int open(sqlite3_vtab* table, sqlite3_vtab_cursor** result) {
+                try {
+                    *result = new cursor{static_cast<vtab*>(table)->owner->module.open()};
+                    return SQLITE_OK;
+                } catch(const std::exception& e) {
+                    return set_error(table, e);
+                }
+            }
+
+            static int close(sqlite3_vtab_cursor* cur) {
+                delete static_cast<cursor*>(cur);
+                return SQLITE_OK;
+            }
+
+            static int
+            filter(sqlite3_vtab_cursor* cur, int idxNum, const char* idxStr, int argc, sqlite3_value** argv) {
+                try {
+                    static_cast<cursor*>(cur)->impl.filter(idxNum, idxStr, argc, argv);
+                    return SQLITE_OK;
+                } catch(const std::exception& e) {
+                    return set_error(cur->pVtab, e);
+                }
+            }
+
+            static int next(sqlite3_vtab_cursor* cur) {
+                try {
+                    static_cast<cursor*>(cur)->impl.next();
+                    return SQLITE_OK;
+                } catch(const std::exception& e) {
+                    return set_error(cur->pVtab, e);
+                }
+            }
+
+            static int eof(sqlite3_vtab_cursor* cur) {
+                return static_cast<cursor*>(cur)->impl.eof() ? 1 : 0;
+            }
+
+            static int column(sqlite3_vtab_cursor* cur, sqlite3_context* context, int index) {
+                try {
+                    static_cast<cursor*>(cur)->impl.column(context, index);
+                    return SQLITE_OK;
+                } catch(const std::exception& e) {
+                    return set_error(cur->pVtab, e);
+                }
+            }
+
+            static int rowid(sqlite3_vtab_cursor* cur, sqlite3_int64* result) {
+                *result = static_cast<cursor*>(cur)->impl.rowid();
+                return SQLITE_OK;
+            }
+        };
+
+        /**
+         *  `CREATE TABLE x(...)` declaring the columns of `table` with the types they are mapped to.
+         */
+        template<class Table>
+        std::string virtual_table_schema(const Table& table) {
+            std::stringstream ss;
+            ss << "CREATE TABLE x(";
+            bool first = true;
+            table.for_each_column([&ss, &first](auto& column) {
+                using field_type = typename std::decay_t<decltype(column)>::field_type;
+                ss << (first ? "" : ", ") << streaming_identifier(column.name) << " "
+                   << type_printer<field_type>().print();
+                first = false;
+            });
+            ss << ")" << std::flush;
+            return ss.str();
+        }
+    }
+
+    /**
+     *  Maps an eponymous virtual table implemented by `module`, an object of a class M with
+     *  - `using cursor_type = ...;` and `cursor_type open() const` making a cursor for every scan of the table,
+     *  - `int best_index(sqlite3_index_info& info) const`, choosing the constraints and order the cursors use,
+     *    see https://sqlite.org/vtab.html#xbestindex, and returning SQLITE_OK or SQLITE_CONSTRAINT.
+     *  A cursor has the member functions
+     *  - `void filter(int idxNum, const char* idxStr, int argc, sqlite3_value** argv)` starting the scan with
+     *    the arguments chosen by `best_index()`,
+     *  - `bool eof() const` and `void next()`,
+     *  - `void column(sqlite3_context* context, int columnIndex) const` setting the result to the value of the
+     *    column, e.g. by `statement_binder<T>().result()`, and `sqlite3_int64 rowid() const`.
+     *  Hooks may throw, the message becomes the error of the statement.
+     *  The storage registers the module on every connection, so the table is queried like any other mapped
+     *  table, without `CREATE VIRTUAL TABLE`; `sync_schema()` leaves it alone. It is read-only.
+     */
+    template<class M, class... Cs, class T = typename std::tuple_element_t<0, std::tuple<Cs...>>::object_type>
+    internal::table_t<T, false, Cs...> make_virtual_table(std::string name, M module, Cs... args) {
+        auto res = make_table<T>(move(name), std::forward<Cs>(args)...);
+        res.virtual_module =
+            std::make_shared<internal::virtual_table_module<M>>(std::move(module), internal::virtual_table_schema(res));
+        return res;
+    }
+}
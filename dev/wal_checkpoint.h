@@ -0,0 +1,189 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::steady_clock
+#include <condition_variable>  //  std::condition_variable
+#include <functional>  //  std::function
+#include <mutex>  //  std::mutex, std::unique_lock, std::lock_guard
+#include <system_error>  //  std::system_error
+#include <thread>  //  std::thread
+#include <utility>  //  std::move
+
+namespace sqlite_orm {
+
+    /**
+     *  Checkpoint modes of `sqlite3_wal_checkpoint_v2`. https://sqlite.org/c3ref/wal_checkpoint_v2.html
+     */
+    enum class checkpoint_mode {
+        passive = SQLITE_CHECKPOINT_PASSIVE,
+        full = SQLITE_CHECKPOINT_FULL,
+        restart = SQLITE_CHECKPOINT_RESTART,
+        truncate = SQLITE_CHECKPOINT_TRUNCATE,
+    };
+
+    /**
+     *  Result of `storage.checkpoint()`.
+     */
+    struct checkpoint_result {
+
+        /**
+         *  Number of frames in the WAL file, -1 if the checkpoint could not run.
+         */
+        int log_frames = 0;
+
+        /**
+         *  Number of frames that got copied into the database file, -1 if the checkpoint could not run.
+         */
+        int checkpointed_frames = 0;
+
+        /**
+         *  True if a FULL, RESTART or TRUNCATE checkpoint could not finish because of other connections
+         *  (SQLITE_BUSY).
+         */
+        bool busy = false;
+
+        /**
+         *  Returns true if every frame of the WAL got copied. A PASSIVE checkpoint is never busy
+         *  but leaves frames behind that readers still use.
+         */
+        bool completed() const {
+            return !this->busy && this->log_frames >= 0 && this->checkpointed_frames == this->log_frames;
+        }
+    };
+
+    /**
+     *  Settings of `storage.start_checkpoint_scheduler()`.
+     */
+    struct checkpoint_scheduler_options {
+
+        /**
+         *  A PASSIVE checkpoint is run when a commit leaves at least this many pages in the WAL.
+         */
+        int wal_pages = 1000;
+
+        /**
+         *  A PASSIVE checkpoint is also run when there were no commits for this long and the WAL has
+         *  frames that are not checkpointed yet. Zero disables idle checkpoints.
+         */
+        std::chrono::milliseconds idle{1000};
+
+        /**
+         *  Number of checkpoints in a row that do not complete before the next one is a RESTART.
+         *  The same number of incomplete RESTART checkpoints escalates to TRUNCATE.
+         */
+        int escalate_after = 3;
+
+        /**
+         *  Called on the scheduler thread after every checkpoint it ran.
+         */
+        std::function<void(checkpoint_mode, const checkpoint_result&)> on_checkpoint;
+    };
+
+    namespace internal {
+
+        /**
+         *  Thread started by `storage.start_checkpoint_scheduler()`. It is woken up by the WAL hook
+         *  after every commit, so checkpoints run on it instead of inline in the committing thread.
+         */
+        struct checkpoint_scheduler {
+            using checkpoint_t = std::function<checkpoint_result(checkpoint_mode)>;
+
+            checkpoint_scheduler(checkpoint_scheduler_options options_, checkpoint_t checkpoint_) :
+                options(std::move(options_)), checkpoint(std::move(checkpoint_)) {
+                this->thread = std::thread{[this] {
+                    this->run();
+                }};
+            }
+
+            checkpoint_scheduler(const checkpoint_scheduler&) = delete;
+            checkpoint_scheduler& operator=(const checkpoint_scheduler&) = delete;
+
+            ~checkpoint_scheduler() {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->stopping = true;
+                }
+                this->changed.notify_one();
+                this->thread.join();
+            }
+
+            /**
+             *  Called from the WAL hook with the number of pages in the WAL after a commit.
+             */
+            void committed(int pages) {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->walPages = pages;
+                    this->lastCommit = std::chrono::steady_clock::now();
+                }
+                if(pages >= this->options.wal_pages) {
+                    this->changed.notify_one();
+                }
+            }
+
+          protected:
+            void run() {
+                std::unique_lock<std::mutex> lock{this->mutex};
+                for(;;) {
+                    auto due = [this] {
+                        return this->stopping || this->walPages >= this->options.wal_pages;
+                    };
+                    if(this->walPages > 0 && this->options.idle.count() > 0) {
+                        //  `lastCommit` moves forward while waiting, so wait again until it stays the same
+                        auto commit = this->lastCommit;
+                        if(!this->changed.wait_until(lock, commit + this->options.idle, due) &&
+                           commit != this->lastCommit) {
+                            continue;
+                        }
+                    } else {
+                        this->changed.wait(lock, [this, &due] {
+                            return due() || (this->walPages > 0 && this->options.idle.count() > 0);
+                        });
+                        if(!due()) {
+                            continue;
+                        }
+                    }
+                    if(this->stopping) {
+                        return;
+                    }
+                    this->walPages = 0;
+                    const auto mode = this->next_mode();
+                    lock.unlock();
+                    checkpoint_result result;
+                    try {
+                        result = this->checkpoint(mode);
+                    } catch(const std::system_error&) {
+                        //  e.g. SQLITE_LOCKED while another thread uses the connection, retried after next commit
+                        result.log_frames = result.checkpointed_frames = -1;
+                        result.busy = true;
+                    }
+                    if(this->options.on_checkpoint) {
+                        this->options.on_checkpoint(mode, result);
+                    }
+                    lock.lock();
+                    this->incompleteCount = result.completed() ? 0 : this->incompleteCount + 1;
+                }
+            }
+
+            checkpoint_mode next_mode() const {
+                if(this->incompleteCount < this->options.escalate_after) {
+                    return checkpoint_mode::passive;
+                } else if(this->incompleteCount < this->options.escalate_after * 2) {
+                    return checkpoint_mode::restart;
+                } else {
+                    return checkpoint_mode::truncate;
+                }
+            }
+
+            const checkpoint_scheduler_options options;
+            const checkpoint_t checkpoint;
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable changed;
+            bool stopping = false;
+            int walPages = 0;
+            int incompleteCount = 0;
+            std::chrono::steady_clock::time_point lastCommit;
+        };
+    }
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>  //  uint64_t
+#include <cstring>  //  std::memcpy
+#include <string>  //  std::string, std::wstring
+
+#include "functional/cxx_universal.h"
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Whether `std::wstring` holds UTF-16, like on Windows, rather than UTF-32.
+         */
+        SQLITE_ORM_INLINE_VAR constexpr bool is_wchar_utf16_v = sizeof(wchar_t) == 2;
+
+        SQLITE_ORM_INLINE_VAR constexpr char32_t replacement_character = 0xFFFD;
+
+        /**
+         *  Number of leading bytes of [data, data + size) which are ASCII, checked 8 bytes at a time.
+         */
+        inline size_t ascii_prefix_length(const char* data, size_t size) {
+            size_t i = 0;
+            for(; i + 8 <= size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                if(word & 0x8080808080808080ull) {
+                    break;
+                }
+            }
+            while(i < size && !(data[i] & 0x80)) {
+                ++i;
+            }
+            return i;
+        }
+
+        /**
+         *  Reads the code point at `it` and advances `it` past it. Unpaired surrogates and values which aren't
+         *  code points read as U+FFFD.
+         */
+        inline char32_t next_code_point(const wchar_t*& it, const wchar_t* end) {
+            const char32_t unit = char32_t(*it++);
+            if(unit < 0xD800 || (unit > 0xDFFF && unit < 0x110000)) {
+                return unit;
+            }
+            if(is_wchar_utf16_v && unit < 0xDC00 && it != end && char32_t(*it) >= 0xDC00 &&
+               char32_t(*it) <= 0xDFFF) {
+                return 0x10000 + ((unit - 0xD800) << 10) + (char32_t(*it++) - 0xDC00);
+            }
+            return replacement_character;
+        }
+
+        inline size_t utf8_length(char32_t codePoint) {
+            return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+        }
+
+        inline char* encode_utf8(char32_t codePoint, char* out) {
+            if(codePoint < 0x80) {
+                *out++ = char(codePoint);
+            } else if(codePoint < 0x800) {
+                *out++ = char(0xC0 | (codePoint >> 6));
+                *out++ = char(0x80 | (codePoint & 0x3F));
+            } else if(codePoint < 0x10000) {
+                *out++ = char(0xE0 | (codePoint >> 12));
+                *out++ = char(0x80 | ((codePoint >> 6) & 0x3F));
+                *out++ = char(0x80 | (codePoint & 0x3F));
+            } else {
+                *out++ = char(0xF0 | (codePoint >> 18));
+                *out++ = char(0x80 | ((codePoint >> 12) & 0x3F));
+                *out++ = char(0x80 | ((codePoint >> 6) & 0x3F));
+                *out++ = char(0x80 | (codePoint & 0x3F));
+            }
+            return out;
+        }
+
+        /**
+         *  Length of the UTF-8 encoding of the wide string [data, data + size).
+         */
+        inline size_t utf8_length(const wchar_t* data, size_t size) {
+            size_t res = 0;
+            for(const wchar_t *it = data, *end = data + size; it != end;) {
+                res += utf8_length(next_code_point(it, end));
+            }
+            return res;
+        }
+
+        /**
+         *  Writes the UTF-8 encoding of [data, data + size) to `out`, which has room for `utf8_length()` bytes.
+         *  @return end of the written bytes.
+         */
+        inline char* encode_utf8(const wchar_t* data, size_t size, char* out) {
+            for(const wchar_t *it = data, *end = data + size; it != end;) {
+                if(char32_t(*it) < 0x80) {
+                    *out++ = char(*it++);
+                } else {
+                    out = encode_utf8(next_code_point(it, end), out);
+                }
+            }
+            return out;
+        }
+
+        inline std::string to_utf8(const wchar_t* data, size_t size) {
+            std::string res(utf8_length(data, size), '\0');
+            if(!res.empty()) {
+                encode_utf8(data, size, &res[0]);
+            }
+            return res;
+        }
+
+        inline std::string to_utf8(const std::wstring& value) {
+            return to_utf8(value.data(), value.size());
+        }
+
+        /**
+         *  Decodes the UTF-8 string [data, data + size) into UTF-16 or UTF-32 depending on `wchar_t`. Runs of
+         *  ASCII are widened without decoding. Invalid, overlong and truncated sequences decode as U+FFFD,
+         *  one for every byte that can't start a valid sequence.
+         */
+        inline std::wstring from_utf8(const char* data, size_t size) {
+            //  a UTF-8 byte never decodes to more than one code unit
+            std::wstring res(size, L'\0');
+            wchar_t* out = &res[0];
+            const unsigned char* it = reinterpret_cast<const unsigned char*>(data);
+            const unsigned char* end = it + size;
+            while(it != end) {
+                const size_t asciiLength = ascii_prefix_length(reinterpret_cast<const char*>(it), size_t(end - it));
+                for(size_t i = 0; i < asciiLength; ++i) {
+                    *out++ = wchar_t(it[i]);
+                }
+                it += asciiLength;
+                if(it == end) {
+                    break;
+                }
+                const unsigned char lead = *it;
+                size_t length = 0;
+                char32_t codePoint = 0;
+                char32_t minimum = 0;
+                if(lead >= 0xC2 && lead <= 0xDF) {
+                    length = 2;
+                    codePoint = lead & 0x1F;
+                    minimum = 0x80;
+                } else if(lead >= 0xE0 && lead <= 0xEF) {
+                    length = 3;
+                    codePoint = lead & 0x0F;
+                    minimum = 0x800;
+                } else if(lead >= 0xF0 && lead <= 0xF4) {
+                    length = 4;
+                    codePoint = lead & 0x07;
+                    minimum = 0x10000;
+                }
+                bool valid = length != 0 && size_t(end - it) >= length;
+                for(size_t i = 1; valid && i < length; ++i) {
+                    valid = (it[i] & 0xC0) == 0x80;
+                    codePoint = (codePoint << 6) | (it[i] & 0x3F);
+                }
+                valid = valid && codePoint >= minimum && codePoint < 0x110000 &&
+                        (codePoint < 0xD800 || codePoint > 0xDFFF);
+                if(!valid) {
+                    *out++ = wchar_t(replacement_character);
+                    ++it;
+                    continue;
+                }
+                it += length;
+                if(is_wchar_utf16_v && codePoint >= 0x10000) {
+                    codePoint -= 0x10000;
+                    *out++ = wchar_t(0xD800 + (codePoint >> 10));
+                    *out++ = wchar_t(0xDC00 + (codePoint & 0x3FF));
+                } else {
+                    *out++ = wchar_t(codePoint);
+                }
+            }
+            res.resize(size_t(out - res.data()));
+            return res;
+        }
+    }
+}
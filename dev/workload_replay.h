@@ -0,0 +1,329 @@
+#pragma once
+
+#include <chrono>  //  std::chrono::nanoseconds, std::chrono::steady_clock
+#include <string>  //  std::string, std::to_string, std::stoll, std::stoull
+#include <vector>  //  std::vector
+#include <map>  //  std::map
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <thread>  //  std::thread, std::this_thread
+#include <istream>  //  std::istream, std::getline
+#include <ostream>  //  std::ostream
+#include <algorithm>  //  std::sort, std::max
+#include <system_error>  //  std::system_error
+#include <exception>  //  std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <utility>  //  std::move
+
+#include "error_code.h"
+#include "statement_profile.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  One statement of a `workload_trace`.
+     */
+    struct workload_statement {
+
+        /**
+         *  Time from the start of the capture until the statement started, as precise as `duration`.
+         */
+        std::chrono::nanoseconds start{0};
+
+        std::chrono::nanoseconds duration{0};
+
+        /**
+         *  Ordinal of the thread which executed the statement, 0 for the first thread seen by the recorder.
+         *  The statements of one thread, e.g. of one transaction, are replayed in order by one thread.
+         */
+        size_t thread = 0;
+
+        /**
+         *  SQL text with placeholders, see `statement_profile::normalized_sql`.
+         */
+        std::string normalized_sql;
+
+        /**
+         *  SQL text with bound parameters expanded. This is what gets replayed.
+         */
+        std::string expanded_sql;
+    };
+
+    /**
+     *  Statements captured by a `workload_recorder` in the order they finished, for `storage.replay_workload()`.
+     *  `save()` writes one statement per line as tab separated start and duration in nanoseconds, thread,
+     *  normalized and expanded SQL, with backslashes, tabs and line breaks of the SQL texts escaped.
+     */
+    struct workload_trace {
+        std::vector<workload_statement> statements;
+
+        void save(std::ostream& stream) const {
+            for(auto& statement: this->statements) {
+                stream << statement.start.count() << '\t' << statement.duration.count() << '\t' << statement.thread
+                       << '\t';
+                write_escaped(stream, statement.normalized_sql);
+                stream << '\t';
+                write_escaped(stream, statement.expanded_sql);
+                stream << '\n';
+            }
+        }
+
+        /**
+         *  Reads a trace written by `save()`. Throws `orm_error_code::invalid_workload_trace` if a line is malformed.
+         */
+        static workload_trace load(std::istream& stream) {
+            workload_trace trace;
+            std::string line;
+            size_t lineNumber = 0;
+            while(std::getline(stream, line)) {
+                ++lineNumber;
+                if(line.empty()) {
+                    continue;
+                }
+                std::vector<std::string> fields;
+                std::string field;
+                for(size_t i = 0; i < line.size(); ++i) {
+                    const char c = line[i];
+                    if(c == '\t') {
+                        fields.push_back(std::move(field));
+                        field.clear();
+                    } else if(c == '\\' && i + 1 < line.size()) {
+                        switch(line[++i]) {
+                            case 't':
+                                field += '\t';
+                                break;
+                            case 'n':
+                                field += '\n';
+                                break;
+                            case 'r':
+                                field += '\r';
+                                break;
+                            default:
+                                field += line[i];
+                        }
+                    } else {
+                        field += c;
+                    }
+                }
+                fields.push_back(std::move(field));
+                if(fields.size() != 5) {
+                    throw std::system_error{orm_error_code::invalid_workload_trace,
+                                            "expected 5 fields in line " + std::to_string(lineNumber)};
+                }
+                workload_statement statement;
+                try {
+                    statement.start = std::chrono::nanoseconds{std::stoll(fields[0])};
+                    statement.duration = std::chrono::nanoseconds{std::stoll(fields[1])};
+                    statement.thread = size_t(std::stoull(fields[2]));
+                } catch(const std::exception&) {
+                    throw std::system_error{orm_error_code::invalid_workload_trace,
+                                            "invalid number in line " + std::to_string(lineNumber)};
+                }
+                statement.normalized_sql = std::move(fields[3]);
+                statement.expanded_sql = std::move(fields[4]);
+                trace.statements.push_back(std::move(statement));
+            }
+            return trace;
+        }
+
+      private:
+        static void write_escaped(std::ostream& stream, const std::string& text) {
+            for(const char c: text) {
+                switch(c) {
+                    case '\\':
+                        stream << "\\\\";
+                        break;
+                    case '\t':
+                        stream << "\\t";
+                        break;
+                    case '\n':
+                        stream << "\\n";
+                        break;
+                    case '\r':
+                        stream << "\\r";
+                        break;
+                    default:
+                        stream << c;
+                }
+            }
+        }
+    };
+
+    /**
+     *  Captures the statements of a storage into a `workload_trace` when set as its profile callback.
+     *  It is called from every thread executing statements, so it is thread safe.
+     *  @example: auto recorder = std::make_shared<workload_recorder>();
+     *            storage.on_profile([recorder](const statement_profile& profile) {
+     *                recorder->record(profile);
+     *            });
+     *            ...
+     *            std::ofstream file{"workload.trace"};
+     *            recorder->trace().save(file);
+     */
+    class workload_recorder {
+      public:
+        workload_recorder() : startTime(std::chrono::steady_clock::now()) {}
+
+        void record(const statement_profile& profile) {
+            const auto now = std::chrono::steady_clock::now();
+            workload_statement statement;
+            //  SQLite may measure durations in whole milliseconds
+            statement.start = std::max(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - this->startTime) - profile.duration,
+                std::chrono::nanoseconds{0});
+            statement.duration = profile.duration;
+            statement.normalized_sql = profile.normalized_sql;
+            statement.expanded_sql = profile.expanded_sql;
+            std::lock_guard<std::mutex> lock{this->mutex};
+            auto it = this->threads.emplace(std::this_thread::get_id(), this->threads.size()).first;
+            statement.thread = it->second;
+            this->captured.statements.push_back(std::move(statement));
+        }
+
+        /**
+         *  Returns the statements captured so far.
+         */
+        workload_trace trace() const {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            return this->captured;
+        }
+
+      private:
+        const std::chrono::steady_clock::time_point startTime;
+        mutable std::mutex mutex;
+        std::map<std::thread::id, size_t> threads;
+        workload_trace captured;
+    };
+
+    /**
+     *  Settings of `storage.replay_workload()`.
+     */
+    struct workload_replay_options {
+
+        /**
+         *  Number of replaying threads. The statements of a captured thread are replayed by replaying thread
+         *  `thread % threads`.
+         */
+        int threads = 1;
+
+        /**
+         *  Pace of the replay relative to the capture: 1 starts every statement no earlier than it started in
+         *  the capture, 2 twice as fast. 0 replays without waiting.
+         */
+        double speed = 0;
+    };
+
+    /**
+     *  Result of `storage.replay_workload()`. Latencies are measured per replayed statement.
+     */
+    struct workload_replay_report {
+        size_t statements = 0;
+
+        /**
+         *  Number of statements that failed, e.g. with a constraint violation. They count as replayed.
+         */
+        size_t errors = 0;
+
+        std::chrono::nanoseconds elapsed{0};
+
+        /**
+         *  Statements per second.
+         */
+        double throughput = 0;
+
+        std::chrono::nanoseconds p50{0};
+        std::chrono::nanoseconds p90{0};
+        std::chrono::nanoseconds p99{0};
+        std::chrono::nanoseconds max{0};
+    };
+
+    namespace internal {
+
+        /**
+         *  Replays `trace` on `options.threads` threads, calling `run` with the SQL text of every statement.
+         *  `start` is called on every replaying thread before its first statement and the object it returns
+         *  lives until the thread is done. An exception thrown by `start` is rethrown once all threads are done.
+         */
+        template<class Start, class Run>
+        workload_replay_report
+        replay_workload(const workload_trace& trace, const workload_replay_options& options, Start start, Run run) {
+            const size_t threadsCount = size_t(std::max(options.threads, 1));
+            std::vector<std::vector<const workload_statement*>> queues(threadsCount);
+            for(auto& statement: trace.statements) {
+                queues[statement.thread % threadsCount].push_back(&statement);
+            }
+            std::vector<std::vector<std::chrono::nanoseconds>> latencies(threadsCount);
+            std::vector<size_t> errors(threadsCount, 0);
+            const auto replayStart = std::chrono::steady_clock::now();
+            auto replayQueue = [&](size_t index) {
+                auto context = start();
+                (void)context;
+                //  the order a thread finished its statements in is the order it ran them in
+                auto& queue = queues[index];
+                latencies[index].reserve(queue.size());
+                for(auto statement: queue) {
+                    if(options.speed > 0) {
+                        std::this_thread::sleep_until(replayStart + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                                        statement->start / options.speed));
+                    }
+                    const auto statementStart = std::chrono::steady_clock::now();
+                    try {
+                        run(statement->expanded_sql.empty() ? statement->normalized_sql : statement->expanded_sql);
+                    } catch(const std::system_error&) {
+                        ++errors[index];
+                    }
+                    latencies[index].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - statementStart));
+                }
+            };
+            //  a thread which cannot start, e.g. because its connection cannot be opened, fails the replay
+            std::vector<std::exception_ptr> failures(threadsCount);
+            auto replay = [&](size_t index) {
+                try {
+                    replayQueue(index);
+                } catch(...) {
+                    failures[index] = std::current_exception();
+                }
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(threadsCount - 1);
+            for(size_t index = 1; index < threadsCount; ++index) {
+                threads.emplace_back(replay, index);
+            }
+            replay(0);
+            for(auto& thread: threads) {
+                thread.join();
+            }
+            for(auto& failure: failures) {
+                if(failure) {
+                    std::rethrow_exception(failure);
+                }
+            }
+
+            workload_replay_report report;
+            report.elapsed =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - replayStart);
+            std::vector<std::chrono::nanoseconds> all;
+            all.reserve(trace.statements.size());
+            for(size_t index = 0; index < threadsCount; ++index) {
+                all.insert(all.end(), latencies[index].begin(), latencies[index].end());
+                report.errors += errors[index];
+            }
+            report.statements = all.size();
+            if(report.elapsed.count() > 0) {
+                report.throughput = double(report.statements) * 1e9 / double(report.elapsed.count());
+            }
+            if(!all.empty()) {
+                std::sort(all.begin(), all.end());
+                //  nearest rank
+                auto percentile = [&all](size_t percent) {
+                    const size_t rank = (all.size() * percent + 99) / 100;
+                    return all[rank ? rank - 1 : 0];
+                };
+                report.p50 = percentile(50);
+                report.p90 = percentile(90);
+                report.p99 = percentile(99);
+                report.max = all.back();
+            }
+            return report;
+        }
+    }
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::steady_clock
+#include <condition_variable>  //  std::condition_variable
+#include <deque>  //  std::deque
+#include <exception>  //  std::exception_ptr, std::current_exception
+#include <functional>  //  std::function
+#include <future>  //  std::promise, std::future
+#include <memory>  //  std::shared_ptr, std::make_shared, std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::unique_lock, std::lock_guard
+#include <thread>  //  std::thread
+#include <utility>  //  std::move
+#include <vector>  //  std::vector
+
+namespace sqlite_orm {
+
+    namespace internal {
+
+        /**
+         *  Result of a batched write kept until the batch is committed.
+         */
+        template<class R>
+        struct batched_write_result {
+            std::promise<R> promise;
+            std::unique_ptr<R> value;
+
+            template<class F, class S>
+            void run(F& f, S& storage) {
+                this->value = std::make_unique<R>(f(storage));
+            }
+
+            void fulfill() {
+                this->promise.set_value(std::move(*this->value));
+            }
+        };
+
+        template<>
+        struct batched_write_result<void> {
+            std::promise<void> promise;
+
+            template<class F, class S>
+            void run(F& f, S& storage) {
+                f(storage);
+            }
+
+            void fulfill() {
+                this->promise.set_value();
+            }
+        };
+
+        /**
+         *  Group commit service. Don't construct it as is, call `storage.make_write_batcher()` instead.
+         *  Writes submitted from any thread are queued and executed by a background thread which runs
+         *  up to `maxBatch` of them in one transaction, waiting at most `maxDelay` for a batch to fill up.
+         *  Every write runs in its own savepoint, so a failing write fails only its own future while the rest of
+         *  the batch is committed. Futures become ready once the transaction of their batch is committed.
+         *  The destructor executes all writes that are still queued.
+         */
+        template<class S>
+        struct write_batcher {
+            using storage_type = S;
+
+            write_batcher(storage_type& storage_, size_t maxBatch_, std::chrono::milliseconds maxDelay_) :
+                maxBatch(maxBatch_ ? maxBatch_ : 1), maxDelay(maxDelay_), storage(storage_) {
+                this->worker = std::thread{[this] {
+                    this->run();
+                }};
+            }
+
+            write_batcher(const write_batcher&) = delete;
+            write_batcher& operator=(const write_batcher&) = delete;
+
+            ~write_batcher() {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->stopping = true;
+                }
+                this->changed.notify_one();
+                this->worker.join();
+            }
+
+            /**
+             *  Queues `f(storage)` to be executed in the next batch.
+             *  @return future of the value returned by `f` that becomes ready when the batch is committed.
+             */
+            template<class F>
+            auto submit(F f) -> std::future<decltype(f(std::declval<storage_type&>()))> {
+                using result_type = decltype(f(std::declval<storage_type&>()));
+                auto result = std::make_shared<batched_write_result<result_type>>();
+                auto future = result->promise.get_future();
+                write_request request{[result, f = std::move(f)](storage_type& storage) mutable {
+                                          result->run(f, storage);
+                                      },
+                                      [result] {
+                                          result->fulfill();
+                                      },
+                                      [result](std::exception_ptr exception) {
+                                          result->promise.set_exception(std::move(exception));
+                                      }};
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->requests.push_back(std::move(request));
+                }
+                this->changed.notify_one();
+                return future;
+            }
+
+            /**
+             *  @return future of the id of the inserted row.
+             */
+            template<class O>
+            std::future<int> insert(O object) {
+                return this->submit([object = std::move(object)](storage_type& storage) {
+                    return storage.insert(object);
+                });
+            }
+
+            template<class O>
+            std::future<void> replace(O object) {
+                return this->submit([object = std::move(object)](storage_type& storage) {
+                    storage.replace(object);
+                });
+            }
+
+            template<class O>
+            std::future<void> update(O object) {
+                return this->submit([object = std::move(object)](storage_type& storage) {
+                    storage.update(object);
+                });
+            }
+
+            template<class O, class... Ids>
+            std::future<void> remove(Ids... ids) {
+                return this->submit([ids...](storage_type& storage) {
+                    storage.template remove<O>(ids...);
+                });
+            }
+
+            const size_t maxBatch;
+            const std::chrono::milliseconds maxDelay;
+
+          protected:
+            struct write_request {
+                std::function<void(storage_type&)> run;
+                std::function<void()> fulfill;
+                std::function<void(std::exception_ptr)> fail;
+            };
+
+            void run() {
+                for(;;) {
+                    std::vector<write_request> batch;
+                    {
+                        std::unique_lock<std::mutex> lock{this->mutex};
+                        this->changed.wait(lock, [this] {
+                            return this->stopping || !this->requests.empty();
+                        });
+                        if(this->requests.empty()) {
+                            return;
+                        }
+                        const auto deadline = std::chrono::steady_clock::now() + this->maxDelay;
+                        this->changed.wait_until(lock, deadline, [this] {
+                            return this->stopping || this->requests.size() >= this->maxBatch;
+                        });
+                        while(!this->requests.empty() && batch.size() < this->maxBatch) {
+                            batch.push_back(std::move(this->requests.front()));
+                            this->requests.pop_front();
+                        }
+                    }
+                    this->execute(batch);
+                }
+            }
+
+            void execute(std::vector<write_request>& batch) {
+                std::vector<write_request*> succeeded;
+                succeeded.reserve(batch.size());
+                try {
+                    auto guard = this->storage.transaction_guard();
+                    for(auto& request: batch) {
+                        try {
+                            auto savepoint = this->storage.savepoint_guard("sqlite_orm_write_batch");
+                            request.run(this->storage);
+                            savepoint.commit();
+                            succeeded.push_back(&request);
+                        } catch(...) {
+                            request.fail(std::current_exception());
+                        }
+                    }
+                    guard.commit();
+                } catch(...) {
+                    auto exception = std::current_exception();
+                    for(auto request: succeeded) {
+                        request->fail(exception);
+                    }
+                    return;
+                }
+                for(auto request: succeeded) {
+                    request->fulfill();
+                }
+            }
+
+            storage_type& storage;
+            std::deque<write_request> requests;
+            bool stopping = false;
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::thread worker;
+        };
+    }
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::steady_clock
+#include <condition_variable>  //  std::condition_variable
+#include <functional>  //  std::function
+#include <map>  //  std::map
+#include <memory>  //  std::unique_ptr, std::make_unique
+#include <mutex>  //  std::mutex, std::unique_lock, std::lock_guard
+#include <string>  //  std::string
+#include <system_error>  //  std::system_error
+#include <thread>  //  std::thread
+#include <utility>  //  std::move, std::swap
+
+#include "functional/cxx_optional.h"
+#include "functional/cxx_universal.h"
+#include "error_code.h"
+#include "object_cache.h"
+
+namespace sqlite_orm {
+
+    /**
+     *  When `storage.make_write_behind<T>()` writes the objects it holds.
+     */
+    struct write_behind_options {
+
+        /**
+         *  The objects are written at most this long after the first update that is still pending.
+         */
+        std::chrono::milliseconds flush_interval{100};
+
+        /**
+         *  The objects are written as soon as this many primary keys are pending.
+         */
+        size_t max_pending = 1000;
+    };
+
+    /**
+     *  Counters of a `write_behind` buffer.
+     */
+    struct write_behind_stats {
+
+        /**
+         *  Calls of `update()`.
+         */
+        size_t updates = 0;
+
+        /**
+         *  Updates replaced by a later update of the same object before they were written.
+         */
+        size_t coalesced = 0;
+
+        /**
+         *  Transactions that wrote pending objects.
+         */
+        size_t flushes = 0;
+
+        /**
+         *  Transactions that failed, their objects are written by the next flush unless updated meanwhile.
+         */
+        size_t failed_flushes = 0;
+
+        /**
+         *  UPDATE statements executed, one per object and flush.
+         */
+        size_t rows_written = 0;
+    };
+
+    namespace internal {
+
+        /**
+         *  Write-behind buffer of objects of type T. Don't construct it as is, call
+         *  `storage.make_write_behind<T>()` instead.
+         *  `update(object)` keeps the object in memory by primary key, replacing a pending update of the
+         *  same object, and a background thread writes the latest state of every pending object with
+         *  `storage.update()` in one transaction, `flush_interval` after the oldest pending update or as soon
+         *  as `max_pending` objects are pending. Rows updated many times per second, such as last-seen
+         *  timestamps, are written once per interval then.
+         *  `get()`, `get_pointer()` and `get_optional()` return the pending state of an object, read the
+         *  table otherwise. Pending updates are lost if the process dies, and an object removed from the table
+         *  while its update is pending isn't inserted again. The destructor writes the pending objects.
+         *  Buffers can be used by many threads.
+         */
+        template<class S, class T>
+        struct write_behind {
+            using storage_type = S;
+            using object_type = T;
+            using key_function = std::function<std::string(const T&)>;
+
+            write_behind(storage_type& storage_, key_function keyOf_, write_behind_options options_) :
+                options(options_), storage(storage_), keyOf(std::move(keyOf_)) {
+                this->worker = std::thread{[this] {
+                    this->run();
+                }};
+            }
+
+            write_behind(const write_behind&) = delete;
+            write_behind& operator=(const write_behind&) = delete;
+
+            ~write_behind() {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    this->stopping = true;
+                }
+                this->changed.notify_one();
+                this->worker.join();
+                try {
+                    this->flush();
+                } catch(...) {
+                }
+            }
+
+            /**
+             *  Makes `object` the state the row with its primary key is updated to by the next flush.
+             */
+            void update(T object) {
+                auto key = this->keyOf(object);
+                bool full;
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    ++this->statistics.updates;
+                    if(this->pending.empty()) {
+                        this->pendingSince = std::chrono::steady_clock::now();
+                    }
+                    auto it = this->pending.find(key);
+                    if(it != this->pending.end()) {
+                        it->second = std::move(object);
+                        ++this->statistics.coalesced;
+                    } else {
+                        this->pending.emplace(std::move(key), std::move(object));
+                    }
+                    full = this->pending.size() >= this->options.max_pending;
+                }
+                if(full) {
+                    this->changed.notify_one();
+                }
+            }
+
+            /**
+             *  @return the pending state of the object with primary key `ids`, or the row of the table.
+             */
+            template<class... Ids>
+            std::unique_ptr<T> get_pointer(Ids... ids) {
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    if(auto object = this->find_pending(make_object_cache_key(ids...))) {
+                        return std::make_unique<T>(*object);
+                    }
+                }
+                return this->storage.template get_pointer<T>(std::move(ids)...);
+            }
+
+            /**
+             *  Same as `get_pointer()` but throws `orm_error_code::not_found` if there is no such object.
+             */
+            template<class... Ids>
+            T get(Ids... ids) {
+                auto object = this->get_pointer(std::move(ids)...);
+                if(!object) {
+                    throw std::system_error{orm_error_code::not_found};
+                }
+                return std::move(*object);
+            }
+
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+            template<class... Ids>
+            std::optional<T> get_optional(Ids... ids) {
+                auto object = this->get_pointer(std::move(ids)...);
+                if(!object) {
+                    return std::nullopt;
+                }
+                return std::move(*object);
+            }
+#endif  //  SQLITE_ORM_OPTIONAL_SUPPORTED
+
+            /**
+             *  Writes the pending objects now, in one transaction. If it fails the objects stay pending and the
+             *  error is thrown.
+             */
+            void flush() {
+                std::lock_guard<std::mutex> flushLock{this->flushMutex};
+                {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    if(this->pending.empty()) {
+                        return;
+                    }
+                    std::swap(this->inFlight, this->pending);
+                }
+                try {
+                    auto guard = this->storage.transaction_guard();
+                    for(auto& pair: this->inFlight) {
+                        this->storage.update(pair.second);
+                    }
+                    guard.commit();
+                } catch(...) {
+                    std::lock_guard<std::mutex> lock{this->mutex};
+                    ++this->statistics.failed_flushes;
+                    //  later updates of the same objects win
+                    for(auto& pair: this->inFlight) {
+                        this->pending.emplace(pair.first, std::move(pair.second));
+                    }
+                    this->inFlight.clear();
+                    this->pendingSince = std::chrono::steady_clock::now();
+                    throw;
+                }
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->statistics.flushes;
+                this->statistics.rows_written += this->inFlight.size();
+                this->inFlight.clear();
+            }
+
+            size_t pending_count() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->pending.size();
+            }
+
+            write_behind_stats stats() {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                return this->statistics;
+            }
+
+            const write_behind_options options;
+
+          protected:
+            /**
+             *  The latest state of the object with key `key` not written yet, nullptr if there is none.
+             */
+            const T* find_pending(const std::string& key) const {
+                auto it = this->pending.find(key);
+                if(it != this->pending.end()) {
+                    return &it->second;
+                }
+                it = this->inFlight.find(key);
+                return it != this->inFlight.end() ? &it->second : nullptr;
+            }
+
+            void run() {
+                std::unique_lock<std::mutex> lock{this->mutex};
+                for(;;) {
+                    this->changed.wait(lock, [this] {
+                        return this->stopping || !this->pending.empty();
+                    });
+                    if(this->stopping) {
+                        return;
+                    }
+                    const auto deadline = this->pendingSince + this->options.flush_interval;
+                    this->changed.wait_until(lock, deadline, [this] {
+                        return this->stopping || this->pending.size() >= this->options.max_pending;
+                    });
+                    if(this->stopping) {
+                        return;
+                    }
+                    lock.unlock();
+                    try {
+                        this->flush();
+                    } catch(...) {
+                        //  counted, retried after another interval
+                    }
+                    lock.lock();
+                }
+            }
+
+            storage_type& storage;
+            key_function keyOf;
+            std::map<std::string, T> pending;
+
+            /**
+             *  Objects taken by the running flush, read through until they are committed.
+             */
+            std::map<std::string, T> inFlight;
+            std::chrono::steady_clock::time_point pendingSince;
+            write_behind_stats statistics;
+            bool stopping = false;
+            std::mutex mutex;
+            std::mutex flushMutex;
+            std::condition_variable changed;
+            std::thread worker;
+        };
+    }
+}
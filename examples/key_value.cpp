@@ -4,13 +4,12 @@
  NSUserDefaults on iOS or SharedPreferences on Android.
  Here is the deal: we need to have `setValueForKey` and `getValueByKey` interface. All data must ba saved in sqlite
  database.
- To perform this we create schema with table `key_value` and two columns: key:string and value:string.
- Key column has PRIMARY KEY constraint cause keys must be unique. `setValue` function takes two string arguments: key
- and value. It creates a KeyValue object (KeyValue is a class mapped to the storage) with arguments and calls REPLACE.
- REPLACE (shorter version of INSERT OR REPLACE) removes row with a given primary key if it exists and inserts a given
- value in the table. After this there is a row in the `key_value` table with key and value passed into `setValue`
- function. `getValue` performs `get_pointer` by id and returns its value or returns empty string if nothing obtained
- from db.
+ To perform this we create schema with table `key_value` made by `make_kv_table`: a WITHOUT ROWID table with two
+ columns, key:string which is the PRIMARY KEY cause keys must be unique and value:string. Its rows are
+ `kv_entry<std::string, std::string>` objects, the user doesn't have to interact with them directly.
+ `setValue` puts the value with a `kv_store`: an UPSERT which changes the value of an existing key in place or inserts
+ a new row. `getValue` reads the value of the key or returns empty string if nothing obtained from db.
+ The store prepares each of its statements once and executes them again for every call.
  ******/
 
 #include <sqlite_orm/sqlite_orm.h>
@@ -21,36 +20,28 @@ using std::cerr;
 using std::cout;
 using std::endl;
 
-/**
- *  This is just a mapped type. User doesn't have to interact with it directly.
- */
-struct KeyValue {
-    std::string key;
-    std::string value;
-};
+using KeyValue = sqlite_orm::kv_entry<std::string, std::string>;
 
 auto& getStorage() {
     using namespace sqlite_orm;
-    static auto storage = make_storage("key_value_example.sqlite",
-                                       make_table("key_value",
-                                                  make_column("key", &KeyValue::key, primary_key()),
-                                                  make_column("value", &KeyValue::value)));
+    static auto storage =
+        make_storage("key_value_example.sqlite", make_kv_table<std::string, std::string>("key_value"));
     return storage;
 }
 
+auto& getStore() {
+    static auto store = getStorage().make_kv_store<std::string, std::string>();
+    return store;
+}
+
 void setValue(const std::string& key, const std::string& value) {
-    using namespace sqlite_orm;
-    KeyValue kv{key, value};
-    getStorage().replace(kv);
+    getStore().put(key, value);
 }
 
 std::string getValue(const std::string& key) {
-    using namespace sqlite_orm;
-    if(auto kv = getStorage().get_pointer<KeyValue>(key)) {
-        return kv->value;
-    } else {
-        return {};
-    }
+    std::string value;
+    getStore().get(key, value);
+    return value;
 }
 
 int storedKeysCount() {
@@ -0,0 +1,73 @@
+/**
+ *  The C++20 module `sqlite_orm`, built by the `sqlite_orm::module` CMake target:
+ *  @example: import sqlite_orm;
+ *            auto storage = sqlite_orm::make_storage("db.sqlite", sqlite_orm::make_table(...));
+ *  It exports everything `sqlite_orm/sqlite_orm.h` declares but none of its macros.
+ *  The standard library and SQLite are included in the global module fragment, so they aren't owned by the
+ *  module and can be included by its importers as well. Keep this list in sync with the includes of the amalgamation.
+ */
+module;
+
+#include <sqlite3.h>
+#include <iso646.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <locale>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <set>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#ifdef SQLITE_ORM_ZLIB_ENABLED
+#include <zlib.h>
+#endif
+#ifdef SQLITE_ORM_ZSTD_ENABLED
+#include <zstd.h>
+#endif
+
+export module sqlite_orm;
+
+export {
+#include <sqlite_orm/sqlite_orm.h>
+}
@@ -14,6 +14,7 @@
 #include "../../dev/alias.h"
 #include "../../dev/join_iterator.h"
 #include "../../dev/core_functions.h"
+#include "../../dev/typed_comparator.h"
 #include "../../dev/select_constraints.h"
 #include "../../dev/table_info.h"
 #include "../../dev/triggers.h"
@@ -22,6 +23,8 @@
 #include "../../dev/pointer_value.h"
 #include "../../dev/statement_binder.h"
 #include "../../dev/row_extractor.h"
+#include "../../dev/util.h"
+#include "../../dev/result.h"
 #include "../../dev/sync_schema_result.h"
 #include "../../dev/index.h"
 #include "../../dev/mapped_type_proxy.h"
@@ -36,4 +39,5 @@
 #include "../../dev/carray.h"
 #include "../../dev/dbstat.h"
 #include "../../dev/interface_definitions.h"
+#include "../../dev/storage_instantiation.h"
 #include "../../dev/functional/finish_macros.h"
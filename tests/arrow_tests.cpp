@@ -0,0 +1,128 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+#ifdef SQLITE_ORM_ARROW_ENABLED
+#include <cstring>  //  std::strcmp
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Trade {
+        int id = 0;
+        std::string symbol;
+        double price = 0;
+        bool settled = false;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Trade() = default;
+        Trade(int id, std::string symbol, double price, bool settled) :
+            id{id}, symbol{move(symbol)}, price{price}, settled{settled} {}
+#endif
+    };
+
+    bool operator==(const Trade& lhs, const Trade& rhs) {
+        return lhs.id == rhs.id && lhs.symbol == rhs.symbol && lhs.price == rhs.price && lhs.settled == rhs.settled;
+    }
+
+    struct Quote {
+        int id = 0;
+        std::string price;
+    };
+
+    auto make_trades_storage() {
+        return make_storage("",
+                            make_table("trades",
+                                       make_column("id", &Trade::id, primary_key()),
+                                       make_column("symbol", &Trade::symbol),
+                                       make_column("price", &Trade::price),
+                                       make_column("settled", &Trade::settled)));
+    }
+}
+
+TEST_CASE("arrow") {
+    auto storage = make_trades_storage();
+    storage.sync_schema();
+    const std::vector<Trade> trades{{1, "ACME", 10.5, true}, {2, "INIT", 20.25, false}, {3, "ACME", 11, true}};
+    storage.replace_range(trades.begin(), trades.end());
+
+    SECTION("export table") {
+        ArrowArrayStream stream;
+        storage.export_arrow<Trade>(&stream, 2);
+
+        ArrowSchema schema;
+        REQUIRE(stream.get_schema(&stream, &schema) == 0);
+        REQUIRE(std::strcmp(schema.format, "+s") == 0);
+        REQUIRE(schema.n_children == 4);
+        REQUIRE(std::strcmp(schema.children[0]->name, "id") == 0);
+        REQUIRE(std::strcmp(schema.children[0]->format, "i") == 0);
+        REQUIRE(std::strcmp(schema.children[1]->name, "symbol") == 0);
+        REQUIRE(std::strcmp(schema.children[1]->format, "u") == 0);
+        REQUIRE(std::strcmp(schema.children[2]->format, "g") == 0);
+        REQUIRE(std::strcmp(schema.children[3]->format, "b") == 0);
+        schema.release(&schema);
+
+        std::vector<int64_t> lengths;
+        ArrowArray batch;
+        REQUIRE(stream.get_next(&stream, &batch) == 0);
+        REQUIRE(batch.release);
+        REQUIRE(batch.length == 2);
+        auto offsets = static_cast<const int32_t*>(batch.children[1]->buffers[1]);
+        auto symbols = static_cast<const char*>(batch.children[1]->buffers[2]);
+        REQUIRE(std::string(symbols + offsets[1], symbols + offsets[2]) == "INIT");
+        REQUIRE(static_cast<const double*>(batch.children[2]->buffers[1])[1] == 20.25);
+        REQUIRE(static_cast<const uint8_t*>(batch.children[3]->buffers[1])[0] == 1);
+        batch.release(&batch);
+
+        REQUIRE(stream.get_next(&stream, &batch) == 0);
+        REQUIRE(batch.length == 1);
+        REQUIRE(static_cast<const int32_t*>(batch.children[0]->buffers[1])[0] == 3);
+        batch.release(&batch);
+
+        REQUIRE(stream.get_next(&stream, &batch) == 0);
+        REQUIRE_FALSE(batch.release);
+        stream.release(&stream);
+    }
+    SECTION("export nullable column") {
+        ArrowArrayStream stream;
+        storage.export_arrow(&stream, select(columns(max(&Trade::price)), where(c(&Trade::id) > 5)));
+        ArrowArray batch;
+        REQUIRE(stream.get_next(&stream, &batch) == 0);
+        REQUIRE(batch.length == 1);
+        REQUIRE(batch.children[0]->null_count == 1);
+        batch.release(&batch);
+        stream.release(&stream);
+    }
+    SECTION("round trip") {
+        auto other = make_trades_storage();
+        other.sync_schema();
+        ArrowArrayStream stream;
+        storage.export_arrow<Trade>(&stream, 2);
+        REQUIRE(other.import_arrow<Trade>(&stream) == 3);
+        REQUIRE_FALSE(stream.release);
+        REQUIRE(other.get_all<Trade>(order_by(&Trade::id)) == trades);
+    }
+    SECTION("import without primary key") {
+        auto other = make_trades_storage();
+        other.sync_schema();
+        other.replace(Trade{1, "OLD", 1, false});
+        ArrowArrayStream stream;
+        storage.export_arrow(&stream,
+                             select(columns(&Trade::symbol, &Trade::price), where(c(&Trade::symbol) == "ACME")));
+        REQUIRE(other.import_arrow<Trade>(&stream) == 2);
+        REQUIRE(other.count<Trade>() == 3);
+        REQUIRE(other.get<Trade>(1).symbol == "OLD");
+    }
+    SECTION("incompatible format") {
+        auto other = make_storage(
+            "",
+            make_table("quotes", make_column("id", &Quote::id, primary_key()), make_column("price", &Quote::price)));
+        other.sync_schema();
+        ArrowArrayStream stream;
+        storage.export_arrow(&stream, select(columns(&Trade::id, &Trade::price)));
+        REQUIRE_THROWS_WITH(other.import_arrow<Quote>(&stream),
+                            Catch::Matchers::ContainsSubstring("Arrow format is incompatible"));
+        REQUIRE_FALSE(stream.release);
+        REQUIRE(other.count<Quote>() == 0);
+    }
+}
+#endif
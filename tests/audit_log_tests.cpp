@@ -0,0 +1,109 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <cstdio>  //  remove
+#include <system_error>  //  std::system_error
+
+using namespace sqlite_orm;
+
+namespace {
+    struct AuditedUser {
+        int id = 0;
+        std::string name;
+    };
+
+    struct AuditRow {
+        int id = 0;
+        int64 time = 0;
+        std::string tableName;
+        std::string operation;
+        int64 rowId = 0;
+    };
+
+    auto make_audit_storage(const std::string& path) {
+        return make_storage(path,
+                            make_table("audit_log",
+                                       make_column("id", &AuditRow::id, primary_key()),
+                                       make_column("time", &AuditRow::time),
+                                       make_column("table_name", &AuditRow::tableName),
+                                       make_column("operation", &AuditRow::operation),
+                                       make_column("row_id", &AuditRow::rowId)));
+    }
+}
+
+TEST_CASE("audit log") {
+    ::remove("audited.sqlite");
+    ::remove("audit.sqlite");
+    auto storage = make_storage("audited.sqlite",
+                                make_table("users",
+                                           make_column("id", &AuditedUser::id, primary_key()),
+                                           make_column("name", &AuditedUser::name)));
+    storage.sync_schema();
+    storage.replace(AuditedUser{1, "Alice"});
+
+    audit_log_options options;
+    options.path = "audit.sqlite";
+    options.flush_interval = std::chrono::milliseconds{60000};
+    storage.enable_audit_log(options);
+    auto audit = make_audit_storage("audit.sqlite");
+    //  reads while the flushing thread writes
+    audit.open_forever();
+    audit.busy_timeout(5000);
+    SECTION("committed changes are written in a batch") {
+        storage.replace(AuditedUser{2, "Bob"});
+        storage.update_all(set(c(&AuditedUser::name) = "Alicia"), where(c(&AuditedUser::id) == 1));
+        storage.remove<AuditedUser>(2);
+        //  written by the flush, not by the audited transactions
+        REQUIRE(audit.count<AuditRow>() == 0);
+
+        REQUIRE(storage.flush_audit_log() == 3);
+        auto rows = audit.get_all<AuditRow>(order_by(&AuditRow::id));
+        REQUIRE(rows.size() == 3);
+        REQUIRE(rows[0].tableName == "users");
+        REQUIRE(rows[0].operation == "INSERT");
+        REQUIRE(rows[0].rowId == 2);
+        REQUIRE(rows[1].operation == "UPDATE");
+        REQUIRE(rows[1].rowId == 1);
+        REQUIRE(rows[2].operation == "DELETE");
+        REQUIRE(rows[2].time > 0);
+        REQUIRE(storage.flush_audit_log() == 0);
+    }
+    SECTION("rolled back changes are not recorded") {
+        storage.transaction([&storage] {
+            storage.replace(AuditedUser{3, "Carol"});
+            return false;
+        });
+        REQUIRE(storage.flush_audit_log() == 0);
+    }
+    SECTION("flush interval") {
+        options.flush_interval = std::chrono::milliseconds{10};
+        storage.enable_audit_log(options);
+        storage.replace(AuditedUser{4, "Dave"});
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while(audit.count<AuditRow>() == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        }
+        REQUIRE(audit.count<AuditRow>() == 1);
+    }
+    SECTION("disable writes the buffered records") {
+        storage.replace(AuditedUser{5, "Eve"});
+        storage.disable_audit_log();
+        REQUIRE(audit.count<AuditRow>() == 1);
+        storage.replace(AuditedUser{6, "Frank"});
+        REQUIRE(storage.flush_audit_log() == 0);
+    }
+    SECTION("audited tables") {
+        options.tables = {"orders"};
+        storage.enable_audit_log(options);
+        storage.replace(AuditedUser{7, "Grace"});
+        REQUIRE(storage.flush_audit_log() == 0);
+    }
+    storage.disable_audit_log();
+}
+
+TEST_CASE("audit log of an in-memory database") {
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &AuditedUser::id, primary_key()), make_column("name", &AuditedUser::name)));
+    storage.sync_schema();
+    REQUIRE_THROWS_AS(storage.enable_audit_log(), std::system_error);
+}
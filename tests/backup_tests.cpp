@@ -81,6 +81,34 @@ TEST_CASE("backup") {
                 backup.step(1);
             } while(backup.remaining() > 0);
         }
+        SECTION("filename with options") {
+            std::vector<int> remainingPages;
+            backup_options options;
+            options.pages_per_step = 1;
+            options.sleep_between = std::chrono::milliseconds{1};
+            options.on_progress = [&remainingPages](int remaining, int pagecount) {
+                REQUIRE(remaining < pagecount);
+                remainingPages.push_back(remaining);
+            };
+            REQUIRE(storage.backup_to(backupFilename, options));
+            REQUIRE(remainingPages.size() > 1);
+            REQUIRE(remainingPages.back() == 0);
+        }
+        SECTION("storage with max_duration") {
+            for(int id = 4; id < 100; ++id) {
+                storage.replace(User{id, std::string(100, 'x')});
+            }
+            backup_options options;
+            options.pages_per_step = 1;
+            options.sleep_between = std::chrono::milliseconds{20};
+            options.max_duration = std::chrono::milliseconds{1};
+            auto backup = storage.make_backup_to(storage2);
+            REQUIRE_FALSE(backup.run(options));
+            REQUIRE(backup.remaining() > 0);
+            options.max_duration = {};
+            options.sleep_between = {};
+            REQUIRE(backup.run(options));
+        }
         REQUIRE(storage2.table_exists(usersTableName));
         auto rowsFromBackup = storage2.get_all<User>();
         auto expectedRows = storage.get_all<User>();
@@ -157,3 +185,46 @@ TEST_CASE("Backup crash") {
     auto backup = storage.make_backup_to(backupFilename);
     backup.step(-1);
 }
+
+#if SQLITE_VERSION_NUMBER >= 3036000 && !defined(SQLITE_OMIT_DESERIALIZE)
+TEST_CASE("serialize database") {
+    auto makeStorage = [](const std::string& filename) {
+        return make_storage(
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    };
+    auto storage = makeStorage("");
+    REQUIRE(storage.serialize_database().empty());
+    storage.sync_schema();
+    storage.replace(User{1, "Sharon"});
+    storage.replace(User{2, "Maitre"});
+    auto image = storage.serialize_database();
+    REQUIRE(image.size() > 0);
+    REQUIRE(std::string(image.data(), 15) == "SQLite format 3");
+
+    auto copy = makeStorage("");
+    SECTION("writable") {
+        copy.deserialize_database(image, false);
+        REQUIRE(copy.get_all<User>() == storage.get_all<User>());
+        copy.replace(User{3, "Rita"});
+        REQUIRE(copy.count<User>() == 3);
+        REQUIRE(storage.count<User>() == 2);
+
+        //  an in-memory database is serialized in place
+        auto grown = copy.serialize_database();
+        auto again = makeStorage("");
+        again.deserialize_database(grown, true);
+        REQUIRE(again.count<User>() == 3);
+    }
+    SECTION("readonly") {
+        copy.deserialize_database(image.data(), image.size(), true);
+        REQUIRE(copy.get_all<User>() == storage.get_all<User>());
+        REQUIRE_THROWS_AS(copy.replace(User{3, "Rita"}), std::system_error);
+    }
+    SECTION("invalid image") {
+        std::vector<char> garbage(4096, 'x');
+        copy.deserialize_database(garbage, true);
+        REQUIRE_THROWS_AS(copy.count<User>(), std::system_error);
+    }
+}
+#endif
@@ -0,0 +1,197 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <numeric>  //  std::iota
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Artifact {
+        int id = 0;
+        std::string name;
+        std::vector<char> data;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Artifact() = default;
+        Artifact(int id, std::string name, std::vector<char> data) : id{id}, name{move(name)}, data{move(data)} {}
+#endif
+    };
+
+    class Document {
+      public:
+        int getId() const {
+            return this->id;
+        }
+
+        void setId(int value) {
+            this->id = value;
+        }
+
+        //  returns temporaries, which have to be copied by SQLite
+        std::string getTitle() const {
+            return this->title;
+        }
+
+        void setTitle(std::string value) {
+            this->title = move(value);
+        }
+
+      private:
+        int id = 0;
+        std::string title;
+    };
+}
+
+TEST_CASE("Incremental blob I/O") {
+    auto storage = make_storage({},
+                                make_table("artifacts",
+                                           make_column("id", &Artifact::id, primary_key()),
+                                           make_column("name", &Artifact::name),
+                                           make_column("data", &Artifact::data)));
+    storage.sync_schema();
+    const int size = 1000;
+    storage.insert(into<Artifact>(),
+                   columns(&Artifact::name, &Artifact::data),
+                   values(std::make_tuple("first", zeroblob(size))));
+    auto id = storage.last_insert_rowid();
+
+    std::vector<char> expected(size);
+    std::iota(expected.begin(), expected.end(), char(0));
+    {
+        auto blob = storage.open_blob(&Artifact::data, id);
+        REQUIRE(blob.size() == size);
+        for(int offset = 0; offset < size; offset += 100) {
+            blob.write(offset, expected.data() + offset, 100);
+        }
+        REQUIRE_THROWS_AS(blob.write(size - 10, expected.data(), 20), std::system_error);
+    }
+    REQUIRE(storage.get<Artifact>(id).data == expected);
+
+    auto blob = storage.open_blob(&Artifact::data, id, true);
+    REQUIRE(blob.read(100, 10) == std::vector<char>(expected.begin() + 100, expected.begin() + 110));
+    char chunk[4] = {};
+    blob.read(size - 4, chunk, 4);
+    REQUIRE(std::equal(std::begin(chunk), std::end(chunk), expected.end() - 4));
+    REQUIRE_THROWS_AS(blob.write(0, chunk, 4), std::system_error);
+#if __cpp_lib_span >= 202002L
+    std::vector<char> buffer(10);
+    blob.read(0, std::span{buffer});
+    REQUIRE(std::equal(buffer.begin(), buffer.end(), expected.begin()));
+#endif
+
+    SECTION("reopen") {
+        auto secondId = storage.insert(Artifact{0, "second", {'a', 'b', 'c'}});
+        blob.reopen(secondId);
+        REQUIRE(blob.size() == 3);
+        REQUIRE(blob.read(0, 3) == std::vector<char>{'a', 'b', 'c'});
+    }
+    SECTION("missing row") {
+        REQUIRE_THROWS_AS(storage.open_blob(&Artifact::data, id + 100), std::system_error);
+    }
+}
+
+TEST_CASE("Binding strings and blobs of objects") {
+    auto storage = make_storage({},
+                                make_table("artifacts",
+                                           make_column("id", &Artifact::id, primary_key()),
+                                           make_column("name", &Artifact::name),
+                                           make_column("data", &Artifact::data)),
+                                make_table("documents",
+                                           make_column("id", &Document::getId, &Document::setId, primary_key()),
+                                           make_column("title", &Document::getTitle, &Document::setTitle)));
+    storage.sync_schema();
+    const std::vector<char> payload(100000, 'x');
+
+    SECTION("insert, update and replace") {
+        auto id = storage.insert(Artifact{0, "first", payload});
+        REQUIRE(storage.get<Artifact>(id).data == payload);
+        storage.update(Artifact{id, "renamed", {}});
+        auto artifact = storage.get<Artifact>(id);
+        REQUIRE(artifact.name == "renamed");
+        REQUIRE(artifact.data.empty());
+        storage.replace(Artifact{id, "", payload});
+        REQUIRE(storage.get<Artifact>(id).data == payload);
+    }
+    SECTION("ranges") {
+        std::vector<Artifact> artifacts;
+        for(int i = 1; i <= 3; ++i) {
+            artifacts.push_back({i, std::to_string(i), std::vector<char>(size_t(i), char('0' + i))});
+        }
+        storage.replace_range(artifacts.begin(), artifacts.end());
+        auto rows = storage.get_all<Artifact>(order_by(&Artifact::id));
+        REQUIRE(rows.size() == 3);
+        REQUIRE(rows[2].name == "3");
+        REQUIRE(rows[2].data == std::vector<char>{'3', '3', '3'});
+
+        //  the projection makes temporaries
+        storage.insert_range<Artifact>(artifacts.begin(), artifacts.end(), [](const Artifact& artifact) {
+            return Artifact{0, artifact.name + "!", artifact.data};
+        });
+        auto names = storage.select(&Artifact::name, where(c(&Artifact::id) > 3), order_by(&Artifact::id));
+        REQUIRE(names == std::vector<std::string>{"1!", "2!", "3!"});
+    }
+    SECTION("getters returning values") {
+        Document document;
+        document.setId(1);
+        document.setTitle(std::string(1000, 't'));
+        storage.replace(document);
+        document.setTitle("short");
+        storage.insert(document);
+        auto titles = storage.select(&Document::getTitle, order_by(&Document::getId));
+        REQUIRE(titles == std::vector<std::string>{std::string(1000, 't'), "short"});
+    }
+}
+
+TEST_CASE("Byte vector blobs") {
+    struct Thumbnail {
+        int id = 0;
+        std::vector<uint8_t> pixels;
+    };
+    auto storage = make_storage({},
+                                make_table("thumbnails",
+                                           make_column("id", &Thumbnail::id, primary_key()),
+                                           make_column("pixels", &Thumbnail::pixels)));
+    storage.sync_schema();
+    REQUIRE(storage.pragma.table_info("thumbnails")[1].type == "BLOB");
+    const std::vector<uint8_t> pixels{0, 1, 0x7f, 0x80, 0xff};
+    storage.replace(Thumbnail{1, pixels});
+    storage.replace(Thumbnail{2, {}});
+    REQUIRE(storage.get<Thumbnail>(1).pixels == pixels);
+    REQUIRE(storage.get<Thumbnail>(2).pixels.empty());
+    REQUIRE(storage.count<Thumbnail>(where(c(&Thumbnail::pixels) == pixels)) == 1);
+
+    SECTION("reused buffer keeps its capacity") {
+        auto statement = storage.prepare(select(&Thumbnail::pixels, order_by(&Thumbnail::id)));
+        std::vector<uint8_t> rows[2];
+        rows[1].reserve(1000);
+        const auto buffer = rows[1].data();
+        REQUIRE(storage.select_into(statement, rows, 2) == 2);
+        REQUIRE(rows[0] == pixels);
+        REQUIRE(rows[1].empty());
+        REQUIRE(rows[1].data() == buffer);
+    }
+#ifdef SQLITE_ORM_BYTE_SUPPORTED
+    SECTION("std::byte") {
+        auto bytes = storage.select(cast<std::vector<std::byte>>(&Thumbnail::pixels), where(c(&Thumbnail::id) == 1));
+        REQUIRE(bytes.size() == 1);
+        REQUIRE(bytes[0].size() == pixels.size());
+        REQUIRE(bytes[0][4] == std::byte{0xff});
+        REQUIRE(storage.count<Thumbnail>(where(c(&Thumbnail::pixels) == bytes[0])) == 1);
+    }
+#endif
+#if __cpp_lib_span >= 202002L
+    SECTION("caller buffers") {
+        std::array<std::byte, 4> small{};
+        std::array<std::byte, 16> large{};
+        std::span<std::byte> rows[1] = {large};
+        REQUIRE(storage.select_into(columns(&Thumbnail::pixels), rows, 1, where(c(&Thumbnail::id) == 1)) == 1);
+        REQUIRE(rows[0].data() == large.data());
+        REQUIRE(rows[0].size() == pixels.size());
+        REQUIRE(large[3] == std::byte{0x80});
+
+        rows[0] = small;
+        REQUIRE_THROWS_AS(storage.select_into(columns(&Thumbnail::pixels), rows, 1, where(c(&Thumbnail::id) == 1)),
+                          std::system_error);
+        REQUIRE(rows[0].size() == small.size());
+    }
+#endif
+}
@@ -463,4 +463,28 @@ SECTION("trunc") {
 }
 }
 
+TEST_CASE("math function fallbacks") {
+    //  the fallbacks replace the built-in functions on this connection
+    auto storage = make_storage("math_fallbacks.sqlite");
+    storage.on_open = [](sqlite3* db) {
+        internal::register_math_functions(db);
+    };
+    storage.open_forever();
+    REQUIRE(storage.select(sqlite_orm::sqrt(16)).at(0) == 4);
+    REQUIRE(is_double_eq(storage.select(sqlite_orm::log(2, 8)).at(0), 3, Epsilon));
+    REQUIRE(is_double_eq(storage.select(sqlite_orm::log(100)).at(0), 2, Epsilon));
+    REQUIRE(is_double_eq(storage.select(sqlite_orm::degrees(pi())).at(0), 180, Epsilon));
+    REQUIRE(storage.select(sqlite_orm::ceil(1.2)).at(0) == 2);
+    REQUIRE(storage.select(sqlite_orm::trunc(-1.5)).at(0) == -1);
+    REQUIRE(storage.select(sqlite_orm::mod(7, 3)).at(0) == 1);
+    REQUIRE(storage.select(sqlite_orm::pow(2, 10)).at(0) == 1024);
+    REQUIRE(storage.select(typeof_(sqlite_orm::floor(3))).at(0) == "integer");
+    REQUIRE(storage.select(typeof_(sqlite_orm::floor("3"))).at(0) == "integer");
+    REQUIRE(storage.select(typeof_(sqlite_orm::sqrt(-1))).at(0) == "null");
+    REQUIRE(storage.select(typeof_(sqlite_orm::sqrt("abc"))).at(0) == "null");
+    REQUIRE(storage.select(typeof_(sqlite_orm::ln(0))).at(0) == "null");
+    REQUIRE(storage.select(typeof_(sqlite_orm::log(1, 8))).at(0) == "null");
+    REQUIRE(storage.select(typeof_(sqlite_orm::mod(7.5, 0))).at(0) == "null");
+}
+
 #endif  //  SQLITE_ENABLE_MATH_FUNCTIONS
@@ -0,0 +1,86 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Account {
+        int id = 0;
+        std::string name;
+    };
+
+    struct Event {
+        int id = 0;
+        int accountId = 0;
+        std::string key;
+    };
+}
+
+TEST_CASE("bulk_load") {
+    auto storage = make_storage(
+        "",
+        make_index("idx_events_account", &Event::accountId),
+        make_unique_index("idx_events_key", &Event::key),
+        make_table("accounts", make_column("id", &Account::id, primary_key()), make_column("name", &Account::name)),
+        make_table("events",
+                   make_column("id", &Event::id, primary_key()),
+                   make_column("account_id", &Event::accountId),
+                   make_column("key", &Event::key),
+                   foreign_key(&Event::accountId).references(&Account::id)));
+    storage.sync_schema();
+    storage.replace(Account{1, "first"});
+    const auto byAccount = select(&Event::id, where(c(&Event::accountId) == 1));
+    REQUIRE(storage.explain_query_plan(byAccount).contains("idx_events_account"));
+
+    //  ids in descending order, every tenth event of an account that doesn't exist
+    std::vector<Event> events;
+    for(int id = 1000; id > 0; --id) {
+        events.push_back(Event{id, id % 10 ? 1 : 2, "key" + std::to_string(id)});
+    }
+
+    SECTION("load") {
+        storage.bulk_load(events.begin(), events.end());
+        REQUIRE(storage.count<Event>() == 1000);
+        REQUIRE(storage.get<Event>(10).accountId == 2);
+        REQUIRE(events.front().id == 1000);
+        REQUIRE(storage.explain_query_plan(byAccount).contains("idx_events_account"));
+        REQUIRE(storage.count<Event>(where(c(&Event::accountId) == 1)) == 900);
+        //  foreign keys are enforced again
+        REQUIRE_THROWS_AS(storage.replace(Event{2000, 3, "orphan"}), std::system_error);
+    }
+    SECTION("small transactions with new ids") {
+        bulk_load_options options;
+        options.rows_per_transaction = 300;
+        options.assign_primary_keys = true;
+        options.disable_foreign_keys = false;
+        std::vector<Event> valid;
+        for(auto& event: events) {
+            if(event.accountId == 1) {
+                valid.push_back(event);
+            }
+        }
+        storage.bulk_load(valid.begin(), valid.end(), options);
+        REQUIRE(storage.count<Event>() == 900);
+        REQUIRE(storage.get<Event>(1).key == "key999");
+    }
+    SECTION("failed load keeps the indexes") {
+        events.push_back(Event{5000, 1, "key1"});
+        bulk_load_options options;
+        options.assign_primary_keys = true;
+        REQUIRE_THROWS_AS(storage.bulk_load(events.begin(), events.end(), options), std::system_error);
+        REQUIRE(storage.count<Event>() == 0);
+        REQUIRE(storage.explain_query_plan(byAccount).contains("idx_events_account"));
+    }
+    SECTION("projection") {
+        std::vector<std::unique_ptr<Event>> pointers;
+        pointers.push_back(std::make_unique<Event>(Event{2, 1, "b"}));
+        pointers.push_back(std::make_unique<Event>(Event{1, 1, "a"}));
+        storage.bulk_load(pointers.begin(),
+                          pointers.end(),
+                          {},
+                          [](const std::unique_ptr<Event>& pointer) -> const Event& {
+                              return *pointer;
+                          });
+        REQUIRE(storage.get<Event>(1).key == "a");
+    }
+}
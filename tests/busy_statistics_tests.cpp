@@ -0,0 +1,163 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <chrono>  //  std::chrono::milliseconds
+#include <cstdio>  //  ::remove
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <thread>  //  std::thread, std::this_thread::sleep_for
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Item {
+        int id = 0;
+        std::string name;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Item() = default;
+        Item(int id, std::string name) : id{id}, name{move(name)} {}
+#endif
+    };
+
+    /**
+     *  A connection of its own holding the write lock of `filename` until `unlock()`.
+     */
+    struct write_locker {
+        explicit write_locker(const char* filename) {
+            sqlite3_open(filename, &this->db);
+            REQUIRE(sqlite3_exec(this->db, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr) == SQLITE_OK);
+        }
+
+        ~write_locker() {
+            this->unlock();
+            sqlite3_close(this->db);
+        }
+
+        void unlock() {
+            if(!sqlite3_get_autocommit(this->db)) {
+                sqlite3_exec(this->db, "COMMIT", nullptr, nullptr, nullptr);
+            }
+        }
+
+        sqlite3* db = nullptr;
+    };
+}
+
+TEST_CASE("busy statistics") {
+    const char* filename = "busy_statistics.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("items", make_column("id", &Item::id, primary_key()), make_column("name", &Item::name)));
+    storage.sync_schema();
+    storage.open_forever();
+    storage.busy_timeout(20);
+
+    SECTION("nothing counted unless enabled") {
+        write_locker locker{filename};
+        REQUIRE_THROWS(storage.replace(Item{1, "a"}));
+        auto status = storage.status();
+        REQUIRE(status.busy.total.callbacks == 0);
+        REQUIRE(status.busy.statements.empty());
+    }
+    SECTION("timeout") {
+        storage.enable_busy_statistics();
+        write_locker locker{filename};
+        REQUIRE_THROWS(storage.replace(Item{1, "a"}));
+
+        auto status = storage.status();
+        REQUIRE(status.busy.total.waits == 1);
+        REQUIRE(status.busy.total.timeouts == 1);
+        REQUIRE(status.busy.total.callbacks > 1);
+        //  the timeout set before enabling is kept
+        REQUIRE(status.busy.total.wait_time >= std::chrono::milliseconds{15});
+        REQUIRE(status.busy.connections.size() == size_t(status.connections_count));
+        REQUIRE(status.busy.connections[0].waits == 1);
+        REQUIRE(status.busy.transactions.autocommit.waits == 1);
+        REQUIRE(status.busy.transactions.deferred.waits == 0);
+        REQUIRE(status.busy.statements.size() == 1);
+        REQUIRE(status.busy.statements.begin()->first.find("REPLACE") != std::string::npos);
+        REQUIRE(status.busy.statements.begin()->second.waits == 1);
+
+        storage.busy_timeout(0);
+        REQUIRE_THROWS(storage.replace(Item{1, "a"}));
+        status = storage.status(true);
+        REQUIRE(status.busy.total.waits == 2);
+        REQUIRE(status.busy.total.timeouts == 2);
+
+        status = storage.status();
+        REQUIRE(status.busy.total.callbacks == 0);
+        REQUIRE(status.busy.connections[0].callbacks == 0);
+        REQUIRE(status.busy.statements.empty());
+    }
+    SECTION("transaction kinds") {
+        storage.enable_busy_statistics();
+        storage.busy_timeout(0);
+        write_locker locker{filename};
+
+        REQUIRE_THROWS(storage.begin_immediate_transaction());
+        REQUIRE_THROWS(storage.begin_exclusive_transaction());
+        storage.begin_transaction();
+        REQUIRE_THROWS(storage.replace(Item{1, "a"}));
+        storage.rollback();
+
+        auto status = storage.status();
+        REQUIRE(status.busy.total.waits == 3);
+        REQUIRE(status.busy.transactions.immediate.waits == 1);
+        REQUIRE(status.busy.transactions.exclusive.waits == 1);
+        REQUIRE(status.busy.transactions.deferred.waits == 1);
+        REQUIRE(status.busy.transactions.autocommit.waits == 0);
+        REQUIRE(status.busy.statements.count("BEGIN IMMEDIATE TRANSACTION") == 1);
+    }
+    SECTION("busy handler") {
+        int calls = 0;
+        storage.busy_handler([&calls](int) {
+            ++calls;
+            return 0;
+        });
+        storage.enable_busy_statistics();
+        write_locker locker{filename};
+        REQUIRE_THROWS(storage.replace(Item{1, "a"}));
+        REQUIRE(calls == 1);
+        auto status = storage.status();
+        REQUIRE(status.busy.total.callbacks == 1);
+        REQUIRE(status.busy.total.timeouts == 1);
+    }
+    SECTION("disabling gives the timeout back") {
+        storage.enable_busy_statistics();
+        storage.busy_timeout(5000);
+        storage.disable_busy_statistics();
+        REQUIRE(storage.pragma.busy_timeout() == 5000);
+    }
+#if SQLITE_VERSION_NUMBER >= 3014000
+    SECTION("profile") {
+        std::mutex mutex;
+        std::vector<statement_profile> profiles;
+        storage.on_profile([&mutex, &profiles](const statement_profile& profile) {
+            std::lock_guard<std::mutex> lock{mutex};
+            profiles.push_back(profile);
+        });
+        storage.enable_busy_statistics();
+        storage.busy_timeout(5000);
+        write_locker locker{filename};
+        std::thread unlocker{[&locker] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{30});
+            locker.unlock();
+        }};
+        storage.replace(Item{1, "a"});
+        unlocker.join();
+        storage.on_profile({});
+
+        auto status = storage.status();
+        REQUIRE(status.busy.total.waits == 1);
+        REQUIRE(status.busy.total.timeouts == 0);
+        REQUIRE(status.busy.total.wait_time >= std::chrono::milliseconds{10});
+        REQUIRE_FALSE(profiles.empty());
+        auto& profile = profiles.back();
+        REQUIRE(profile.normalized_sql.find("REPLACE") != std::string::npos);
+        REQUIRE(profile.busy_callbacks == status.busy.total.callbacks);
+        REQUIRE(profile.busy_wait == status.busy.total.wait_time);
+    }
+#endif
+    storage.disable_busy_statistics();
+    ::remove(filename);
+}
@@ -0,0 +1,122 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <atomic>  //  std::atomic
+#include <vector>  //  std::vector
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+
+    struct Visit {
+        int id = 0;
+        int userId = 0;
+    };
+
+    struct failing_writes_shim : vfs_shim {
+        std::atomic<bool> failing{false};
+
+        int write(vfs_file& file, const void* buffer, int amount, sqlite3_int64 offset) override {
+            if(this->failing && file.is_main_db()) {
+                return SQLITE_IOERR_WRITE;
+            }
+            return vfs_shim::write(file, buffer, amount, offset);
+        }
+    };
+}
+
+TEST_CASE("on_change") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)),
+        make_table("visits", make_column("id", &Visit::id, primary_key()), make_column("user_id", &Visit::userId)));
+    storage.sync_schema();
+
+    std::vector<change_event<User>> events;
+    storage.on_change<User>([&events](const change_event<User>& event) {
+        events.push_back(event);
+    });
+
+    SECTION("autocommit") {
+        storage.replace(User{1, "Alice"});
+        storage.update(User{1, "Alicia"});
+        storage.insert(Visit{0, 1});
+        storage.remove<User>(1);
+        REQUIRE(events.size() == 3);
+        REQUIRE(events[0].operation == change_operation::insert);
+        REQUIRE(events[1].operation == change_operation::update);
+        REQUIRE(events[2].operation == change_operation::remove);
+        for(auto& event: events) {
+            REQUIRE(event.rowid == 1);
+        }
+    }
+    SECTION("commit") {
+        storage.transaction([&storage, &events] {
+            storage.replace(User{1, "Alice"});
+            storage.replace(User{2, "Bob"});
+            REQUIRE(events.empty());
+            return true;
+        });
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[1].rowid == 2);
+    }
+    SECTION("rollback") {
+        storage.transaction([&storage] {
+            storage.replace(User{1, "Alice"});
+            return false;
+        });
+        REQUIRE(events.empty());
+        storage.replace(User{2, "Bob"});
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].rowid == 2);
+    }
+    SECTION("unsubscribe") {
+        storage.on_change<User>(nullptr);
+        storage.replace(User{1, "Alice"});
+        REQUIRE(events.empty());
+    }
+    SECTION("with object cache") {
+        storage.enable_object_cache<User>();
+        storage.replace(User{1, "Alice"});
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        storage.update_all(set(c(&User::name) = "Carol"));
+        REQUIRE(storage.get<User>(1).name == "Carol");
+        REQUIRE(events.size() == 2);
+    }
+}
+
+TEST_CASE("on_change with a failing COMMIT") {
+    auto filename = "change_stream_failing_commit.sqlite";
+    ::remove(filename);
+    auto shim = std::make_shared<failing_writes_shim>();
+    register_vfs_shim("failing_writes", shim);
+    open_options options;
+    options.vfs = "failing_writes";
+    {
+        auto storage = make_storage(
+            options,
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+        storage.sync_schema();
+
+        std::vector<change_event<User>> events;
+        storage.on_change<User>([&events](const change_event<User>& event) {
+            events.push_back(event);
+        });
+
+        //  the pages of the database file are written after the commit hook ran
+        shim->failing = true;
+        REQUIRE_THROWS_AS(storage.replace(User{1, "Alice"}), std::system_error);
+        shim->failing = false;
+        REQUIRE(events.empty());
+
+        storage.replace(User{2, "Bob"});
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].rowid == 2);
+        REQUIRE(storage.count<User>() == 1);
+    }
+    unregister_vfs_shim("failing_writes");
+}
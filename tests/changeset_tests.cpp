@@ -0,0 +1,96 @@
+/**
+ *  Built as a separate executable: the session extension needs `SQLITE_ENABLE_SESSION` and
+ *  `SQLITE_ENABLE_PREUPDATE_HOOK`, which must not be mixed with the translation units of `unit_tests`.
+ */
+#define SQLITE_ENABLE_SESSION
+#define SQLITE_ENABLE_PREUPDATE_HOOK
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Item {
+        int id = 0;
+        std::string name;
+        int stock = 0;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Item() = default;
+        Item(int id, std::string name, int stock) : id{id}, name{std::move(name)}, stock{stock} {}
+#endif
+    };
+
+    bool operator==(const Item& lhs, const Item& rhs) {
+        return lhs.id == rhs.id && lhs.name == rhs.name && lhs.stock == rhs.stock;
+    }
+
+    struct Note {
+        int id = 0;
+        std::string text;
+    };
+
+    auto make_items_storage() {
+        return make_storage("",
+                            make_table("items",
+                                       make_column("id", &Item::id, primary_key()),
+                                       make_column("name", &Item::name),
+                                       make_column("stock", &Item::stock)),
+                            make_table("notes",
+                                       make_column("id", &Note::id, primary_key()),
+                                       make_column("text", &Note::text)));
+    }
+}
+
+TEST_CASE("changeset") {
+    auto primary = make_items_storage();
+    auto replica = make_items_storage();
+    primary.sync_schema();
+    replica.sync_schema();
+    primary.replace(Item{1, "bolt", 10});
+    replica.replace(Item{1, "bolt", 10});
+
+    auto recorder = primary.record_changes<Item>();
+    REQUIRE(recorder.empty());
+    primary.replace(Item{2, "nut", 5});
+    primary.update_all(set(c(&Item::stock) = 7), where(c(&Item::id) == 1));
+    primary.replace(Note{1, "not recorded"});
+    REQUIRE_FALSE(recorder.empty());
+
+    SECTION("changeset") {
+        replica.apply_changeset(recorder.changeset());
+        REQUIRE(replica.get_all<Item>() == primary.get_all<Item>());
+        REQUIRE(replica.count<Note>() == 0);
+    }
+    SECTION("patchset") {
+        auto patchset = recorder.patchset();
+        REQUIRE(patchset.size() < recorder.changeset().size());
+        replica.apply_changeset(patchset);
+        REQUIRE(replica.get_all<Item>() == primary.get_all<Item>());
+    }
+    SECTION("conflicts") {
+        replica.replace(Item{2, "washer", 1});
+        SECTION("abort") {
+            REQUIRE_THROWS_AS(replica.apply_changeset(recorder.changeset()), std::system_error);
+            REQUIRE(replica.get<Item>(1).stock == 10);
+        }
+        SECTION("omit") {
+            replica.apply_changeset(recorder.changeset(), changeset_conflict_policy::omit);
+            REQUIRE(replica.get<Item>(1).stock == 7);
+            REQUIRE(replica.get<Item>(2).name == "washer");
+        }
+        SECTION("replace") {
+            replica.apply_changeset(recorder.changeset(), changeset_conflict_policy::replace);
+            REQUIRE(replica.get_all<Item>() == primary.get_all<Item>());
+        }
+    }
+    SECTION("all tables") {
+        replica.apply_changeset(recorder.changeset());
+        auto all = primary.record_changes<>();
+        primary.replace(Note{2, "recorded"});
+        primary.remove<Item>(2);
+        replica.apply_changeset(all.changeset());
+        REQUIRE(replica.count<Note>() == 1);
+        REQUIRE(replica.count<Item>() == 1);
+    }
+}
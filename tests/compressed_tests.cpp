@@ -0,0 +1,106 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    /**
+     *  Stores 'x' and a byte per run of equal characters with the run length.
+     */
+    struct run_length_codec {
+        static int decompressions;
+
+        static void compress(const char* data, size_t size, std::vector<char>& out) {
+            out.push_back('x');
+            for(size_t i = 0; i < size;) {
+                size_t run = 1;
+                while(i + run < size && data[i + run] == data[i] && run < 127) {
+                    ++run;
+                }
+                out.push_back(char(run));
+                out.push_back(data[i]);
+                i += run;
+            }
+        }
+
+        template<class Buffer>
+        static void decompress(const char* data, size_t size, Buffer& out) {
+            ++decompressions;
+            if(size == 0 || data[0] != 'x') {
+                throw std::system_error{orm_error_code::invalid_compressed_value};
+            }
+            out.clear();
+            for(size_t i = 1; i + 1 < size; i += 2) {
+                out.insert(out.end(), size_t(data[i]), data[i + 1]);
+            }
+        }
+    };
+    int run_length_codec::decompressions = 0;
+
+    struct Document {
+        int id = 0;
+        std::string title;
+        compressed<std::string, run_length_codec> body;
+    };
+}
+
+TEST_CASE("compressed") {
+    auto storage = make_storage("",
+                                make_table("documents",
+                                           make_column("id", &Document::id, primary_key()),
+                                           make_column("title", &Document::title),
+                                           make_column("body", &Document::body)));
+    storage.sync_schema();
+    REQUIRE(storage.pragma.table_info("documents")[2].type == "BLOB");
+
+    const std::string body(1000, 'a');
+    Document document;
+    document.id = 1;
+    document.title = "long";
+    document.body = body;
+    storage.replace(document);
+    Document empty;
+    empty.id = 2;
+    storage.replace(empty);
+
+    REQUIRE(storage.select(length(&Document::body), where(c(&Document::id) == 1)) == std::vector<int>{17});
+    REQUIRE(storage.select(length(&Document::body), where(c(&Document::id) == 2)) == std::vector<int>{0});
+
+    run_length_codec::decompressions = 0;
+    auto documents = storage.get_all<Document>(order_by(&Document::id));
+    REQUIRE(documents.size() == 2);
+    REQUIRE_FALSE(documents[0].body.is_decoded());
+    REQUIRE(run_length_codec::decompressions == 0);
+    REQUIRE(documents[0].body.get() == body);
+    REQUIRE(documents[0].body.get() == body);
+    REQUIRE(run_length_codec::decompressions == 1);
+    REQUIRE(documents[1].body.get().empty());
+
+    SECTION("update keeps the compressed bytes") {
+        documents[0].title = "renamed";
+        storage.update(documents[0]);
+        REQUIRE(storage.get<Document>(1).body == document.body);
+        REQUIRE(run_length_codec::decompressions == 2);
+    }
+    SECTION("invalid bytes") {
+        storage.update_all(set(c(&Document::body) = std::vector<char>{'?'}));
+        REQUIRE_THROWS_WITH(storage.get<Document>(1).body.get(),
+                            Catch::Matchers::ContainsSubstring("Compressed value is invalid"));
+    }
+#ifdef SQLITE_ORM_ZLIB_ENABLED
+    SECTION("zlib") {
+        compressed<std::vector<char>, zlib_codec<>> value{std::vector<char>(4096, 'z')};
+        REQUIRE(value.bytes().size() < 100);
+        auto copy = decltype(value)::from_bytes(value.bytes());
+        REQUIRE(copy.get() == std::vector<char>(4096, 'z'));
+    }
+#endif
+#ifdef SQLITE_ORM_ZSTD_ENABLED
+    SECTION("zstd") {
+        compressed<std::string, zstd_codec<>> value{std::string(4096, 'z')};
+        REQUIRE(value.bytes().size() < 100);
+        auto copy = decltype(value)::from_bytes(value.bytes());
+        REQUIRE(copy.get() == std::string(4096, 'z'));
+    }
+#endif
+}
@@ -0,0 +1,301 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <atomic>  //  std::atomic_int
+#include <future>  //  std::promise, std::future
+#include <thread>  //  std::thread
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        User() = default;
+        User(int id, std::string name) : id{id}, name{move(name)} {}
+#endif
+    };
+
+    struct MultiplyFunction {
+        int operator()(int a, int b) const {
+            return a * b;
+        }
+
+        static const char* name() {
+            return "MULTIPLY";
+        }
+    };
+
+    auto make_pooled_storage(const std::string& filename, int poolSize) {
+        return make_storage(
+            pool_options{poolSize},
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    }
+}
+
+TEST_CASE("connection pool") {
+    auto filename = "connection_pool.sqlite";
+    ::remove(filename);
+    auto storage = make_pooled_storage(filename, 3);
+    REQUIRE(storage.is_pooled());
+    REQUIRE_FALSE(storage.is_opened());
+
+    std::atomic_int openedCount{0};
+    storage.on_open = [&openedCount](sqlite3*) {
+        ++openedCount;
+    };
+    storage.create_scalar_function<MultiplyFunction>();
+
+    storage.sync_schema();
+    REQUIRE(storage.is_opened());
+    REQUIRE(openedCount == 1);
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    REQUIRE(storage.count<User>() == 2);
+
+    SECTION("connections are reused by the same thread") {
+        auto users = storage.get_all<User>();
+        REQUIRE(users.size() == 2);
+        REQUIRE(openedCount == 1);
+    }
+    SECTION("every thread holding a connection gets its own one") {
+        std::promise<void> firstHolds;
+        std::promise<void> secondDone;
+        auto secondDoneFuture = secondDone.get_future();
+        std::vector<int> firstRows;
+        std::thread first{[&storage, &firstHolds, &secondDoneFuture, &firstRows] {
+            auto view = storage.iterate<User>();
+            auto it = view.begin();
+            firstHolds.set_value();
+            secondDoneFuture.wait();
+            for(; it != view.end(); ++it) {
+                firstRows.push_back(it->id);
+            }
+        }};
+        firstHolds.get_future().wait();
+        std::vector<int> secondRows;
+        std::thread second{[&storage, &secondRows] {
+            secondRows = storage.select(func<MultiplyFunction>(&User::id, 10));
+        }};
+        second.join();
+        secondDone.set_value();
+        first.join();
+
+        REQUIRE(openedCount == 2);
+        REQUIRE(firstRows == std::vector<int>{1, 2});
+        REQUIRE(secondRows == std::vector<int>{10, 20});
+    }
+    SECTION("transaction stays on the connection of its thread") {
+        int countInsideTransaction = 0;
+        std::thread worker{[&storage, &countInsideTransaction] {
+            storage.begin_transaction();
+            storage.replace(User{3, "Carol"});
+            countInsideTransaction = storage.count<User>();
+            storage.rollback();
+        }};
+        worker.join();
+        REQUIRE(countInsideTransaction == 3);
+        REQUIRE(storage.count<User>() == 2);
+    }
+    SECTION("commit without transaction") {
+        bool thrown = false;
+        std::thread worker{[&storage, &thrown] {
+            try {
+                storage.commit();
+            } catch(const std::system_error&) {
+                thrown = true;
+            }
+        }};
+        worker.join();
+        REQUIRE(thrown);
+    }
+}
+
+TEST_CASE("connection pool with a single writer") {
+    auto filename = "connection_pool_single_writer.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        pool_options{2, true},
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    int readonlyOpened = 0;
+    storage.on_open = [&readonlyOpened](sqlite3* db) {
+        readonlyOpened += sqlite3_db_readonly(db, "main");
+    };
+
+    //  nothing has been written yet so the database file doesn't exist and reading happens on the writer
+    REQUIRE(storage.table_exists("users") == false);
+    storage.sync_schema();
+    storage.pragma.journal_mode(journal_mode::WAL);
+    storage.replace(User{1, "Alice"});
+
+    SECTION("reads run on a read-only connection") {
+        auto statement = storage.prepare(select(&User::id));
+        REQUIRE(sqlite3_db_readonly(statement.con.get(), "main") == 1);
+        REQUIRE(storage.execute(statement) == std::vector<int>{1});
+        REQUIRE(readonlyOpened == 1);
+
+        auto insertStatement = storage.prepare(replace(User{2, "Bob"}));
+        REQUIRE(sqlite3_db_readonly(insertStatement.con.get(), "main") == 0);
+        storage.execute(insertStatement);
+        REQUIRE(storage.count<User>() == 2);
+    }
+    SECTION("reads inside a transaction see its changes") {
+        storage.begin_transaction();
+        storage.replace(User{2, "Bob"});
+        {
+            auto statement = storage.prepare(select(&User::id));
+            REQUIRE(sqlite3_db_readonly(statement.con.get(), "main") == 0);
+        }
+        REQUIRE(storage.count<User>() == 2);
+        storage.rollback();
+        REQUIRE(storage.count<User>() == 1);
+    }
+    SECTION("readers see committed data while the writer is busy") {
+        std::promise<void> writerHolds;
+        std::promise<void> readerDone;
+        auto readerDoneFuture = readerDone.get_future();
+        std::thread writer{[&storage, &writerHolds, &readerDoneFuture] {
+            storage.begin_transaction();
+            storage.replace(User{2, "Bob"});
+            writerHolds.set_value();
+            readerDoneFuture.wait();
+            storage.commit();
+        }};
+        writerHolds.get_future().wait();
+        auto countWhileWriting = storage.count<User>();
+        readerDone.set_value();
+        writer.join();
+        REQUIRE(countWhileWriting == 1);
+        REQUIRE(storage.count<User>() == 2);
+    }
+}
+
+TEST_CASE("connection pool priorities") {
+    auto filename = "connection_pool_priorities.sqlite";
+    ::remove(filename);
+    pool_options options{3};
+    options.batch_limit = 1;
+    options.acquire_timeout = std::chrono::milliseconds{50};
+    auto storage = make_storage(
+        options,
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.pool_stats(true);
+
+    pool_priority_scope batch{pool_priority::batch};
+    auto view = storage.iterate<User>();
+    auto it = view.begin();
+    REQUIRE(storage.pool_stats().batch.borrowed == 1);
+
+    bool timedOut = false;
+    std::thread otherBatch{[&storage, &timedOut] {
+        pool_priority_scope batch{pool_priority::batch};
+        try {
+            storage.count<User>();
+        } catch(const std::system_error& e) {
+            timedOut = e.code() == orm_error_code::pool_timeout;
+        }
+    }};
+    otherBatch.join();
+    REQUIRE(timedOut);
+
+    int count = 0;
+    std::thread interactive{[&storage, &count] {
+        pool_priority_scope interactive{pool_priority::interactive};
+        count = storage.count<User>();
+    }};
+    interactive.join();
+    REQUIRE(count == 1);
+    REQUIRE(it->id == 1);
+
+    auto stats = storage.pool_stats();
+    REQUIRE(stats.batch.acquisitions == 1);
+    REQUIRE(stats.batch.waits == 1);
+    REQUIRE(stats.batch.timeouts == 1);
+    REQUIRE(stats.batch.wait_time >= std::chrono::milliseconds{50});
+    REQUIRE(stats.interactive.acquisitions == 1);
+    REQUIRE(stats.interactive.waits == 0);
+    REQUIRE(stats.interactive.borrowed == 0);
+}
+
+TEST_CASE("connection pool with in-memory database") {
+    auto storage = make_pooled_storage(":memory:", 3);
+    REQUIRE_FALSE(storage.is_pooled());
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    REQUIRE(storage.count<User>() == 1);
+}
+
+TEST_CASE("parallel_get_all") {
+    auto filename = "parallel_get_all.sqlite";
+    ::remove(filename);
+    auto storage = make_pooled_storage(filename, 4);
+    storage.sync_schema();
+    std::vector<User> users;
+    for(int id = 1; id <= 100; ++id) {
+        users.push_back(User{id * 3, "user" + std::to_string(id % 10)});
+    }
+    storage.replace_range(users.begin(), users.end());
+
+    auto idsOf = [](const std::vector<User>& users) {
+        std::vector<int> ids;
+        for(auto& user: users) {
+            ids.push_back(user.id);
+        }
+        return ids;
+    };
+    SECTION("all rows in rowid order") {
+        REQUIRE(idsOf(storage.parallel_get_all<User>(3)) == idsOf(users));
+    }
+    SECTION("where") {
+        auto rows = storage.parallel_get_all<User>(8, where(c(&User::name) == "user5"));
+        REQUIRE(rows.size() == 10);
+        REQUIRE(rows.front().id == 15);
+    }
+    SECTION("order_by and limit") {
+        auto rows = storage.parallel_get_all<User>(3, order_by(&User::id).desc(), limit(4));
+        REQUIRE(idsOf(rows) == std::vector<int>{300, 297, 294, 291});
+    }
+    SECTION("empty table") {
+        storage.remove_all<User>();
+        REQUIRE(storage.parallel_get_all<User>(3).empty());
+    }
+    SECTION("without a pool") {
+        auto single = make_storage(
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+        REQUIRE(single.parallel_get_all<User>(4, where(c(&User::id) > 297)).size() == 1);
+    }
+}
+
+#ifdef SQLITE_ENABLE_SNAPSHOT
+TEST_CASE("read snapshot") {
+    auto filename = "read_snapshot.sqlite";
+    ::remove(filename);
+    auto storage = make_pooled_storage(filename, 3);
+    storage.sync_schema();
+    storage.pragma.journal_mode(journal_mode::WAL);
+    storage.replace(User{1, "Alice"});
+
+    auto snapshot = storage.snapshot();
+    std::async(std::launch::async, [&storage] {
+        storage.replace(User{2, "Bob"});
+    }).get();
+    auto countInSnapshot = std::async(std::launch::async, [&storage, &snapshot] {
+                               return storage.with_snapshot(snapshot, [&storage] {
+                                   return storage.count<User>();
+                               });
+                           }).get();
+    auto countNow = std::async(std::launch::async, [&storage] {
+                        return storage.count<User>();
+                    }).get();
+    REQUIRE(countInSnapshot == 1);
+    REQUIRE(storage.count<User>() == 1);
+    REQUIRE(countNow == 2);
+}
+#endif
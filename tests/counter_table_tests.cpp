@@ -0,0 +1,72 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <thread>  //  std::thread
+#include <vector>  //  std::vector
+
+using namespace sqlite_orm;
+
+#if SQLITE_VERSION_NUMBER >= 3024000
+TEST_CASE("counter table") {
+    auto filename = "counter_table.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(filename, make_counter_shards_table("counters"));
+    storage.sync_schema();
+    storage.open_forever();
+
+    SECTION("increments go to the shard of the thread") {
+        auto counters = storage.make_counter_table(counter_options{4});
+        std::vector<std::thread> threads;
+        for(int i = 0; i < 4; ++i) {
+            threads.emplace_back([&counters] {
+                for(int n = 0; n < 25; ++n) {
+                    counters.add("views");
+                }
+            });
+        }
+        for(auto& thread: threads) {
+            thread.join();
+        }
+        counters.add("clicks", 5);
+        REQUIRE(counters.get("views") == 100);
+        REQUIRE(counters.get("clicks") == 5);
+        REQUIRE(counters.get("unknown") == 0);
+        REQUIRE(storage.count<counter_shard<>>(where(c(&counter_shard<>::name) == "views")) <= 4);
+
+        counters.reset("views");
+        REQUIRE(counters.get("views") == 0);
+    }
+    SECTION("batched increments") {
+        counter_options options;
+        options.flush_interval = std::chrono::hours{1};
+        auto counters = storage.make_counter_table(options);
+        counters.add("views");
+        counters.add("views", 2);
+        REQUIRE(counters.get("views") == 3);
+        REQUIRE(storage.count<counter_shard<>>() == 0);
+        counters.flush();
+        REQUIRE(storage.count<counter_shard<>>() == 1);
+        REQUIRE(counters.get("views") == 3);
+    }
+    SECTION("pending increments are written on destruction") {
+        {
+            counter_options options;
+            options.flush_interval = std::chrono::hours{1};
+            auto counters = storage.make_counter_table(options);
+            counters.add("views", 7);
+        }
+        REQUIRE(storage.make_counter_table().get("views") == 7);
+    }
+    SECTION("cached reads") {
+        counter_options options;
+        options.read_cache = std::chrono::hours{1};
+        auto counters = storage.make_counter_table(options);
+        counters.add("views");
+        REQUIRE(counters.get("views") == 1);
+        storage.make_counter_table().add("views", 10);
+        REQUIRE(counters.get("views") == 1);
+        counters.add("views");
+        REQUIRE(counters.get("views") == 2);
+    }
+    ::remove(filename);
+}
+#endif
@@ -0,0 +1,86 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <cstdio>  //  std::remove
+#include <fstream>  //  std::ofstream
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Trade {
+        int id = 0;
+        std::string symbol;
+        double price = 0;
+        std::unique_ptr<int> volume;
+    };
+
+    void write_file(const std::string& path, const std::string& content) {
+        std::ofstream stream{path, std::ios::binary};
+        stream << content;
+    }
+}
+
+TEST_CASE("import_csv") {
+    const std::string path = "import_csv.csv";
+    auto storage = make_storage("",
+                                make_table("trades",
+                                           make_column("id", &Trade::id, primary_key()),
+                                           make_column("symbol", &Trade::symbol),
+                                           make_column("price", &Trade::price),
+                                           make_column("volume", &Trade::volume)));
+    storage.sync_schema();
+
+    SECTION("mapped columns") {
+        write_file(path,
+                   "symbol,price,volume\n"
+                   "ACME,10.5,100\r\n"
+                   "\"IN,IT\",20.25,\n"
+                   "\n"
+                   "\"say \"\"hi\"\"\",1,\"\"\n"
+                   "\"two\nlines\",2,7");
+        csv_options options;
+        options.buffer_size = 8;
+        options.rows_per_statement = 2;
+        options.rows_per_transaction = 3;
+        REQUIRE(storage.import_csv<Trade>(path, columns(&Trade::symbol, &Trade::price, &Trade::volume), options) ==
+                4);
+        auto trades = storage.get_all<Trade>(order_by(&Trade::id));
+        REQUIRE(trades.size() == 4);
+        REQUIRE(trades[0].symbol == "ACME");
+        REQUIRE(trades[0].price == 10.5);
+        REQUIRE(*trades[0].volume == 100);
+        REQUIRE(trades[1].symbol == "IN,IT");
+        REQUIRE_FALSE(trades[1].volume);
+        REQUIRE(trades[2].symbol == "say \"hi\"");
+        REQUIRE(trades[2].volume);
+        REQUIRE(*trades[2].volume == 0);
+        REQUIRE(trades[3].symbol == "two\nlines");
+        REQUIRE(*trades[3].volume == 7);
+    }
+    SECTION("all columns") {
+        write_file(path, "1\tACME\t10.5\t100\n2\tINIT\t20\t\n");
+        csv_options options;
+        options.delimiter = '\t';
+        options.header = false;
+        REQUIRE(storage.import_csv<Trade>(path, options) == 2);
+        REQUIRE(storage.get<Trade>(2).symbol == "INIT");
+        REQUIRE(storage.count<Trade>(where(is_null(&Trade::volume))) == 1);
+    }
+    SECTION("wrong number of fields") {
+        write_file(path, "id,symbol\n1,ACME,10.5,100\n2,INIT\n");
+        REQUIRE_THROWS_WITH(storage.import_csv<Trade>(path),
+                            Catch::Matchers::ContainsSubstring("record 3 has 2 fields instead of 4"));
+        REQUIRE(storage.count<Trade>() == 0);
+    }
+    SECTION("unterminated quote") {
+        write_file(path, "1,\"ACME,10.5,100\n");
+        csv_options options;
+        options.header = false;
+        REQUIRE_THROWS_WITH(storage.import_csv<Trade>(path, options),
+                            Catch::Matchers::ContainsSubstring("unterminated quoted field"));
+    }
+    SECTION("missing file") {
+        std::remove(path.c_str());
+        REQUIRE_THROWS_AS(storage.import_csv<Trade>(path), std::system_error);
+    }
+    std::remove(path.c_str());
+}
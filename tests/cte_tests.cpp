@@ -0,0 +1,84 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Node {
+        int id = 0;
+        int parentId = 0;
+        std::string name;
+    };
+
+    struct Ancestor {
+        int id = 0;
+        int depth = 0;
+    };
+
+    struct ChildCount {
+        int parentId = 0;
+        int count = 0;
+    };
+}
+
+TEST_CASE("common table expressions") {
+    auto storage = make_storage({},
+                                make_table("nodes",
+                                           make_column("id", &Node::id, primary_key()),
+                                           make_column("parent_id", &Node::parentId),
+                                           make_column("name", &Node::name)));
+    storage.sync_schema();
+    storage.replace(Node{1, 0, "root"});
+    storage.replace(Node{2, 1, "a"});
+    storage.replace(Node{3, 2, "b"});
+    storage.replace(Node{4, 3, "c"});
+    storage.replace(Node{5, 1, "d"});
+
+    auto ancestors = cte("ancestors", make_column("id", &Ancestor::id), make_column("depth", &Ancestor::depth));
+    auto ancestorsOf = [&ancestors](int id) {
+        return ancestors.as(union_all(select(columns(&Node::parentId, 1), where(c(&Node::id) == id)),
+                                      select(columns(&Node::parentId, c(&Ancestor::depth) + 1),
+                                             join<Ancestor>(on(c(&Ancestor::id) == &Node::id)))));
+    };
+    auto childCounts = cte("child_counts",
+                           make_column("parent_id", &ChildCount::parentId),
+                           make_column("count", &ChildCount::count))
+                           .as(select(columns(&Node::parentId, count(&Node::id)), group_by(&Node::parentId)));
+
+    SECTION("recursive") {
+        auto rows = storage.with_recursive(
+            ancestorsOf(4),
+            select(columns(&Ancestor::id, &Ancestor::depth), where(c(&Ancestor::id) != 0), order_by(&Ancestor::depth)));
+        using row = std::tuple<int, int>;
+        REQUIRE(rows == std::vector<row>{{3, 1}, {2, 2}, {1, 3}});
+    }
+    SECTION("prepared") {
+        auto statement = storage.prepare(with_recursive(
+            ancestorsOf(4),
+            select(&Ancestor::id, where(c(&Ancestor::id) != 0), order_by(&Ancestor::id))));
+        REQUIRE(storage.execute(statement) == std::vector<int>{1, 2, 3});
+        get<1>(statement) = 5;
+        REQUIRE(storage.execute(statement) == std::vector<int>{1});
+    }
+    SECTION("materialized") {
+        auto rows = storage.with(childCounts.materialized(),
+                                 select(columns(&Node::name, &ChildCount::count),
+                                        join<ChildCount>(on(c(&ChildCount::parentId) == &Node::id)),
+                                        order_by(&Node::id)));
+        using row = std::tuple<std::string, int>;
+        REQUIRE(rows == std::vector<row>{{"root", 2}, {"a", 1}, {"b", 1}});
+    }
+    SECTION("not materialized") {
+        auto rows = storage.with(childCounts.not_materialized(),
+                                 select(&ChildCount::parentId, where(c(&ChildCount::count) > 1)));
+        REQUIRE(rows == std::vector<int>{1});
+    }
+    SECTION("several") {
+        auto rows = storage.with_recursive(std::make_tuple(ancestorsOf(3), childCounts),
+                                           select(columns(&Ancestor::id, &ChildCount::count),
+                                                  join<ChildCount>(on(c(&ChildCount::parentId) == &Ancestor::id)),
+                                                  order_by(&Ancestor::id)));
+        using row = std::tuple<int, int>;
+        REQUIRE(rows == std::vector<row>{{0, 1}, {1, 2}, {2, 1}});
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ *  Built as a separate executable: defining `SQLITE_ORM_ENABLE_EXECUTE_TRACING` changes the layout
+ *  of `storage_t` so it must not be mixed with the translation units of `unit_tests`.
+ */
+#define SQLITE_ORM_ENABLE_EXECUTE_TRACING
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <vector>  //  std::vector
+#include <algorithm>  //  std::count_if
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+}
+
+TEST_CASE("execute tracing") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+
+    std::vector<execute_event> events;
+    storage.on_execute_event = [&events](const execute_event& event) {
+        events.push_back(event);
+    };
+    auto countPhase = [&events](execute_phase phase) {
+        return std::count_if(events.begin(), events.end(), [phase](const execute_event& event) {
+            return event.phase == phase;
+        });
+    };
+
+    SECTION("prepare") {
+        auto statement = storage.prepare(get_all<User>(where(c(&User::id) > 0)));
+        REQUIRE(countPhase(execute_phase::serialize) == 1);
+        REQUIRE(countPhase(execute_phase::prepare) == 1);
+        REQUIRE(countPhase(execute_phase::step) == 0);
+        REQUIRE(events.back().stmt == statement.stmt);
+    }
+    SECTION("execute") {
+        storage.insert(User{0, "Alice"});
+        storage.insert(User{0, "Bob"});
+        events.clear();
+
+        auto statement = storage.prepare(get_all<User>());
+        events.clear();
+        auto users = storage.execute(statement);
+        REQUIRE(users.size() == 2);
+        REQUIRE(events.size() == 3);
+        REQUIRE(countPhase(execute_phase::bind) == 1);
+        REQUIRE(countPhase(execute_phase::step) == 1);
+        REQUIRE(countPhase(execute_phase::extract) == 1);
+        for(auto& event: events) {
+            REQUIRE(event.stmt == statement.stmt);
+            REQUIRE(event.duration.count() >= 0);
+        }
+    }
+    SECTION("no rows are not extracted") {
+        REQUIRE(storage.get_pointer<User>(1) == nullptr);
+        REQUIRE(countPhase(execute_phase::step) == 1);
+        REQUIRE(countPhase(execute_phase::extract) == 0);
+    }
+    SECTION("empty sink") {
+        storage.on_execute_event = nullptr;
+        storage.insert(User{0, "Alice"});
+        REQUIRE(storage.count<User>() == 1);
+        REQUIRE(events.empty());
+    }
+}
@@ -0,0 +1,138 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Document {
+        int id = 0;
+        std::string title;
+        std::string body;
+    };
+
+    struct DocumentIndex {
+        int64 rowid = 0;
+        std::string title;
+        std::string body;
+    };
+}
+
+TEST_CASE("fts5") {
+    auto table = make_fts5_table("documents",
+                                 fts5_options{},
+                                 make_column("rowid", &Document::id, primary_key()),
+                                 make_column("title", &Document::title),
+                                 make_column("body", &Document::body));
+    auto storage = make_storage("", table);
+    REQUIRE(storage.sync_schema()["documents"] == sync_schema_result::new_table_created);
+    REQUIRE(storage.sync_schema()["documents"] == sync_schema_result::already_in_sync);
+
+    storage.replace(Document{1, "sqlite orm", "a header-only library mapping structs to tables"});
+    storage.replace(Document{2, "full-text search", "fts5 indexes the text of sqlite tables"});
+    storage.replace(Document{3, "unrelated", "nothing to see here"});
+    REQUIRE(storage.count<Document>() == 3);
+    REQUIRE(storage.get<Document>(2).title == "full-text search");
+
+    SECTION("match") {
+        auto ids = storage.select(&Document::id, where(match<Document>("sqlite")), order_by(&Document::id));
+        REQUIRE(ids == std::vector<int>{1, 2});
+        ids = storage.select(&Document::id, where(match(&Document::title, "sqlite")));
+        REQUIRE(ids == std::vector<int>{1});
+        REQUIRE(storage.get_all<Document>(where(match<Document>("fts5 AND text"))).size() == 1);
+    }
+    SECTION("ranked") {
+        storage.replace(Document{4, "sqlite", "sqlite sqlite sqlite"});
+        auto rows = storage.select(columns(&Document::id, bm25<Document>()),
+                                   where(match<Document>("sqlite")),
+                                   order_by(bm25<Document>()));
+        REQUIRE(rows.size() == 3);
+        REQUIRE(std::get<0>(rows.front()) == 4);
+        REQUIRE(std::get<1>(rows.front()) <= std::get<1>(rows.back()));
+
+        //  all the weight on the title
+        auto ids = storage.select(&Document::id,
+                                  where(match<Document>("sqlite")),
+                                  order_by(bm25<Document>(1.0, 0.0)),
+                                  limit(1));
+        REQUIRE(ids.size() == 1);
+        REQUIRE(ids.front() != 2);
+    }
+    SECTION("highlight and snippet") {
+        auto titles = storage.select(highlight<Document>(0, "[", "]"), where(match<Document>("orm")));
+        REQUIRE(titles == std::vector<std::string>{"sqlite [orm]"});
+        auto snippets = storage.select(snippet<Document>(1, "<", ">", "...", 3), where(match<Document>("indexes")));
+        REQUIRE(snippets == std::vector<std::string>{"fts5 <indexes> the..."});
+    }
+    SECTION("serialization") {
+        using db_objects_t = internal::db_objects_tuple<decltype(table)>;
+        auto dbObjects = db_objects_t{table};
+        using context_t = internal::serializer_context<db_objects_t>;
+        context_t context{dbObjects};
+        REQUIRE(internal::serialize(match<Document>("x"), context) == "(\"documents\" MATCH 'x')");
+        REQUIRE(internal::serialize(bm25<Document>(2.0), context) == "(bm25(\"documents\", 2))");
+    }
+}
+
+TEST_CASE("fts5 external content") {
+    const char* filename = "fts5_external_content.sqlite";
+    ::remove(filename);
+    fts5_options options;
+    options.content = "documents";
+    options.content_rowid = "id";
+    options.tokenize = "porter unicode61";
+    auto makeStorage = [filename](fts5_options options) {
+        return make_storage(filename,
+                            make_fts5_table("documents_fts",
+                                            std::move(options),
+                                            make_column("rowid", &DocumentIndex::rowid),
+                                            make_column("title", &DocumentIndex::title),
+                                            make_column("body", &DocumentIndex::body)),
+                            make_table("documents",
+                                       make_column("id", &Document::id, primary_key()),
+                                       make_column("title", &Document::title),
+                                       make_column("body", &Document::body)));
+    };
+    auto storage = makeStorage(options);
+    storage.sync_schema();
+    storage.replace(Document{1, "running", "runners run"});
+    REQUIRE(storage.sync_schema_simulate()["documents_fts"] == sync_schema_result::already_in_sync);
+    {
+        sqlite3* db = nullptr;
+        REQUIRE(sqlite3_open(filename, &db) == SQLITE_OK);
+        std::string sql;
+        sqlite3_exec(
+            db,
+            "SELECT sql FROM sqlite_master WHERE name = 'documents_fts'",
+            [](void* data, int, char** argv, char**) -> int {
+                *static_cast<std::string*>(data) = argv[0];
+                return 0;
+            },
+            &sql,
+            nullptr);
+        sqlite3_close(db);
+        REQUIRE(sql == "CREATE VIRTUAL TABLE \"documents_fts\" USING fts5(\"title\", \"body\", content='documents', "
+                       "content_rowid='id', tokenize='porter unicode61')");
+    }
+
+    //  the triggers keep the index in sync
+    storage.replace(Document{2, "walking", "walkers walk"});
+    auto ids = storage.select(&DocumentIndex::rowid, where(match<DocumentIndex>("run")));
+    REQUIRE(ids == std::vector<int64>{1});
+    storage.update(Document{2, "walking", "walkers run"});
+    ids = storage.select(&DocumentIndex::rowid, where(match<DocumentIndex>("run")), order_by(&DocumentIndex::rowid));
+    REQUIRE(ids == std::vector<int64>{1, 2});
+    storage.remove<Document>(1);
+    ids = storage.select(&DocumentIndex::rowid, where(match<DocumentIndex>("run")));
+    REQUIRE(ids == std::vector<int64>{2});
+    REQUIRE(storage.get_all<DocumentIndex>(where(match<DocumentIndex>("walk"))).at(0).title == "walking");
+
+    //  other options create the table again and rebuild its index from the content table
+    options.tokenize = "unicode61";
+    auto storage2 = makeStorage(options);
+    REQUIRE(storage2.sync_schema()["documents_fts"] == sync_schema_result::dropped_and_recreated);
+    REQUIRE(storage2.select(&DocumentIndex::rowid, where(match<DocumentIndex>("walk"))).empty());
+    ids = storage2.select(&DocumentIndex::rowid, where(match<DocumentIndex>("walkers")));
+    REQUIRE(ids == std::vector<int64>{2});
+    storage2.replace(Document{3, "walk", ""});
+    REQUIRE(storage2.select(&DocumentIndex::rowid, where(match<DocumentIndex>("walk"))) == std::vector<int64>{3});
+}
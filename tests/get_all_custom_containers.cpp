@@ -3,6 +3,10 @@
 
 #include <list>
 #include <deque>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace sqlite_orm;
 
@@ -42,6 +46,37 @@ namespace {
     };
 }
 
+namespace {
+    struct Point {
+        int id;
+        std::string label;
+
+        Point(int id, std::string label) : id{id}, label{move(label)} {}
+    };
+
+    class Token {
+      public:
+        int id;
+        std::string value;
+
+        static Token make(int id, std::string value) {
+            return Token{id, "token " + value};
+        }
+
+      private:
+        Token(int id, std::string value) : id{id}, value{move(value)} {}
+    };
+}
+
+namespace sqlite_orm {
+    template<>
+    struct object_factory<Token> {
+        Token operator()(int id, std::string value) const {
+            return Token::make(id, move(value));
+        }
+    };
+}
+
 struct Tester {
     const std::vector<User>& expected;
 
@@ -136,3 +171,218 @@ TEST_CASE("get_all deque") {
     }
 #endif  //  SQLITE_ORM_OPTIONAL_SUPPORTED
 }
+
+TEST_CASE("get_all_into") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Nicki"});
+    storage.replace(User{2, "Karol"});
+
+    SECTION("appends") {
+        std::vector<User> users;
+        users.push_back(User{0, "kept"});
+        storage.get_all_into(users, where(c(&User::id) == 2));
+        REQUIRE(users.size() == 2);
+        REQUIRE(users[0].name == "kept");
+        REQUIRE(users[1].id == 2);
+        REQUIRE(users[1].name == "Karol");
+    }
+    SECTION("reused container") {
+        std::vector<User> users;
+        users.reserve(8);
+        const User* data = users.data();
+        for(int i = 0; i < 3; ++i) {
+            users.clear();
+            storage.get_all_into(users, order_by(&User::id));
+            REQUIRE(users.size() == 2);
+            REQUIRE(users.data() == data);
+        }
+        REQUIRE(users[0].name == "Nicki");
+    }
+    SECTION("list") {
+        std::list<User> users;
+        storage.get_all_into(users);
+        REQUIRE(users.size() == 2);
+    }
+    SECTION("prepared statement") {
+        auto statement = storage.prepare(get_all<User>(order_by(&User::id)));
+        std::vector<User> users;
+        storage.execute_into(statement, users);
+        storage.execute_into(statement, users);
+        REQUIRE(users.size() == 4);
+        REQUIRE(users[2].name == "Nicki");
+    }
+}
+
+TEST_CASE("hash containers") {
+    struct Post {
+        int id = 0;
+        std::string tag;
+        int likes = 0;
+
+        bool operator<(const Post& other) const {
+            return this->id < other.id;
+        }
+    };
+    auto storage = make_storage("",
+                                make_table("posts",
+                                           make_column("id", &Post::id, primary_key()),
+                                           make_column("tag", &Post::tag),
+                                           make_column("likes", &Post::likes)));
+    storage.sync_schema();
+    storage.replace(Post{1, "c++", 3});
+    storage.replace(Post{2, "sqlite", 5});
+    storage.replace(Post{3, "c++", 7});
+
+    SECTION("select into set") {
+        std::unordered_set<std::string> tags;
+        storage.select_into(tags, distinct(&Post::tag));
+        REQUIRE(tags == std::unordered_set<std::string>{"c++", "sqlite"});
+
+        std::set<int> likes{1};
+        storage.select_into(likes, &Post::likes, where(c(&Post::likes) > 4));
+        REQUIRE(likes == std::set<int>{1, 5, 7});
+    }
+    SECTION("select into map") {
+        std::unordered_map<std::string, int> likesByTag;
+        storage.select_into(likesByTag, columns(&Post::tag, sum(&Post::likes)), group_by(&Post::tag));
+        REQUIRE(likesByTag == std::unordered_map<std::string, int>{{"c++", 10}, {"sqlite", 5}});
+
+        std::map<int, std::string> tagById;
+        auto statement = storage.prepare(select(columns(&Post::id, &Post::tag), where(c(&Post::id) < 3)));
+        storage.select_into(tagById, statement);
+        REQUIRE(tagById == std::map<int, std::string>{{1, "c++"}, {2, "sqlite"}});
+    }
+    SECTION("select into sequence") {
+        std::deque<std::tuple<int, std::string>> rows;
+        storage.select_into(rows, columns(&Post::id, &Post::tag), order_by(&Post::id));
+        REQUIRE(rows.size() == 3);
+        REQUIRE(rows.back() == std::make_tuple(3, std::string("c++")));
+    }
+    SECTION("get_all set") {
+        auto posts = storage.get_all<Post, std::set<Post>>(where(c(&Post::tag) == "c++"));
+        REQUIRE(posts.size() == 2);
+        REQUIRE(posts.begin()->id == 1);
+    }
+    SECTION("get_all_map") {
+        std::unordered_map<int, Post> posts = storage.get_all_map<Post>(&Post::id);
+        REQUIRE(posts.size() == 3);
+        REQUIRE(posts.at(2).tag == "sqlite");
+
+        auto firstByTag = storage.get_all_map<Post, std::map<std::string, Post>>(&Post::tag, order_by(&Post::id));
+        REQUIRE(firstByTag.size() == 2);
+        REQUIRE(firstByTag.at("c++").id == 1);
+    }
+}
+
+TEST_CASE("get_all without default constructor") {
+    SECTION("constructor") {
+        auto storage = make_storage("",
+                                    make_table("points",
+                                               make_column("id", &Point::id, primary_key()),
+                                               make_column("label", &Point::label)));
+        storage.sync_schema();
+        storage.replace(Point{1, "a"});
+        storage.replace(Point{2, "b"});
+        auto points = storage.get_all<Point>(order_by(&Point::id));
+        REQUIRE(points.size() == 2);
+        REQUIRE(points[1].id == 2);
+        REQUIRE(points[1].label == "b");
+
+        std::deque<Point> deque;
+        storage.get_all_into(deque, where(c(&Point::id) == 1));
+        REQUIRE(deque.size() == 1);
+        REQUIRE(deque.front().label == "a");
+    }
+    SECTION("factory") {
+        auto storage = make_storage(
+            "",
+            make_table("tokens", make_column("id", &Token::id, primary_key()), make_column("value", &Token::value)));
+        storage.sync_schema();
+        storage.replace(Token::make(1, "a"));
+        auto tokens = storage.get_all<Token>();
+        REQUIRE(tokens.size() == 1);
+        REQUIRE(tokens[0].value == "token token a");
+    }
+}
+
+#ifdef SQLITE_ORM_MEMORY_RESOURCE_SUPPORTED
+namespace {
+    struct Document {
+        int id = 0;
+        std::pmr::string title;
+        std::pmr::vector<char> content;
+    };
+
+    struct counting_resource : std::pmr::memory_resource {
+        size_t allocations = 0;
+
+      private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++this->allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+}
+
+TEST_CASE("get_all arena") {
+    auto storage = make_storage({},
+                                make_table("documents",
+                                           make_column("id", &Document::id, primary_key()),
+                                           make_column("title", &Document::title),
+                                           make_column("content", &Document::content)));
+    storage.sync_schema();
+    const std::pmr::string longTitle(100, 't');
+    storage.replace(Document{1, longTitle, std::pmr::vector<char>{'a', 'b'}});
+    storage.replace(Document{2, "short", {}});
+
+    counting_resource arena;
+    SECTION("get_all") {
+        auto documents = storage.get_all<Document>(&arena, order_by(&Document::id));
+        STATIC_REQUIRE(std::is_same<decltype(documents), std::pmr::vector<Document>>::value);
+        REQUIRE(documents.size() == 2);
+        REQUIRE(documents.get_allocator().resource() == &arena);
+        REQUIRE(documents[0].title == longTitle);
+        REQUIRE(documents[0].content == std::pmr::vector<char>{'a', 'b'});
+        REQUIRE(documents[1].title == "short");
+        REQUIRE(documents[1].content.empty());
+        for(auto& document: documents) {
+            REQUIRE(document.title.get_allocator().resource() == &arena);
+            REQUIRE(document.content.get_allocator().resource() == &arena);
+        }
+        //  the vector, the long title and the content
+        REQUIRE(arena.allocations >= 3);
+    }
+    SECTION("conditions") {
+        auto documents = storage.get_all<Document>(&arena, where(c(&Document::id) == 2));
+        REQUIRE(documents.size() == 1);
+        REQUIRE(documents[0].id == 2);
+    }
+    SECTION("prepared statement") {
+        auto statement = storage.prepare(get_all<Document, std::pmr::vector<Document>>());
+        auto documents = storage.execute(statement, &arena);
+        REQUIRE(documents.size() == 2);
+        REQUIRE(documents[0].title.get_allocator().resource() == &arena);
+    }
+    SECTION("without arena") {
+        auto documents = storage.get_all<Document>();
+        REQUIRE(documents.size() == 2);
+        REQUIRE(documents[0].title.get_allocator().resource() == std::pmr::get_default_resource());
+        REQUIRE(arena.allocations == 0);
+    }
+    SECTION("select") {
+        auto titles = storage.select(&Document::title, where(c(&Document::id) == 1));
+        REQUIRE(titles == std::vector<std::pmr::string>{longTitle});
+    }
+}
+#endif
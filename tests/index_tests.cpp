@@ -1,5 +1,7 @@
 #include <sqlite_orm/sqlite_orm.h>
 #include <catch2/catch_all.hpp>
+#include <cstdio>  //  ::remove
+#include <cstdlib>  //  std::atoi
 
 using namespace sqlite_orm;
 
@@ -112,3 +114,170 @@ TEST_CASE("Compound index") {
     REQUIRE_NOTHROW(storage.sync_schema());
     REQUIRE_NOTHROW(storage.insert(User{1, "juan"}));
 }
+
+#if SQLITE_VERSION_NUMBER >= 3024000
+TEST_CASE("explain_query_plan") {
+    struct User {
+        int id = 0;
+        std::string name;
+        int age = 0;
+    };
+    auto storage = make_storage({},
+                                make_index("idx_users_name", &User::name),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("age", &User::age)));
+    storage.sync_schema();
+
+    auto byName = storage.explain_query_plan(select(&User::id, where(c(&User::name) == "Alice")));
+    REQUIRE_FALSE(byName.nodes.empty());
+    REQUIRE_FALSE(byName.scans("users"));
+    REQUIRE(byName.contains("idx_users_name"));
+
+    auto statement = storage.prepare(get_all<User>(where(c(&User::age) > 18)));
+    auto byAge = storage.explain_query_plan(statement);
+    REQUIRE(byAge.scans("users"));
+    REQUIRE_FALSE(byAge.scans("user"));
+
+    auto nested = storage.explain_query_plan(
+        select(&User::id, where(in(&User::id, select(&User::id, where(c(&User::age) > 18)))), order_by(&User::age)));
+    auto topLevel = nested.children(0);
+    REQUIRE_FALSE(topLevel.empty());
+    REQUIRE(nested.nodes.size() > topLevel.size());
+    REQUIRE(nested.str().find("\n  ") != std::string::npos);
+}
+#endif
+
+TEST_CASE("analyze") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto filename = "analyze.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename] {
+        return make_storage(
+            filename,
+            make_index("idx_users_name", &User::name),
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    };
+    auto statRows = [filename] {
+        sqlite3* db = nullptr;
+        sqlite3_open(filename, &db);
+        int rows = 0;
+        sqlite3_exec(
+            db,
+            "SELECT COUNT(*) FROM sqlite_stat1 WHERE tbl = 'users'",
+            [](void* data, int, char** argv, char**) {
+                *static_cast<int*>(data) = std::atoi(argv[0]);
+                return 0;
+            },
+            &rows,
+            nullptr);
+        sqlite3_close(db);
+        return rows;
+    };
+    {
+        auto storage = makeStorage();
+        storage.sync_schema();
+        storage.transaction([&storage] {
+            for(int i = 1; i <= 100; ++i) {
+                storage.replace(User{i, "user" + std::to_string(i % 10)});
+            }
+            return true;
+        });
+    }
+    REQUIRE(statRows() == 0);
+
+    auto storage = makeStorage();
+    SECTION("analyze table") {
+        storage.analyze<User>();
+        REQUIRE(statRows() > 0);
+    }
+    SECTION("analyze all") {
+        storage.analyze();
+        REQUIRE(statRows() > 0);
+    }
+    SECTION("after sync_schema") {
+        storage.auto_optimize.after_sync_schema = true;
+        storage.sync_schema();
+        REQUIRE(statRows() > 0);
+    }
+    SECTION("on close") {
+        storage.auto_optimize.on_close = true;
+        storage.get_all<User>(where(c(&User::name) == "user1"));
+        REQUIRE(statRows() > 0);
+    }
+}
+
+TEST_CASE("expression index") {
+    struct User {
+        int id = 0;
+        std::string email;
+    };
+    auto filename = "expression_index.sqlite";
+    ::remove(filename);
+    auto table = make_table("users", make_column("id", &User::id, primary_key()), make_column("email", &User::email));
+    {
+        auto storage = make_storage(filename, make_unique_index("idx_users_email", lower(&User::email)), table);
+        auto result = storage.sync_schema();
+        REQUIRE(result.at("idx_users_email") == sync_schema_result::already_in_sync);
+        storage.insert(User{0, "Alice@example.com"});
+        REQUIRE_THROWS_AS(storage.insert(User{0, "alice@EXAMPLE.com"}), std::system_error);
+        REQUIRE(storage.sync_schema_simulate().at("idx_users_email") == sync_schema_result::already_in_sync);
+    }
+    SECTION("changed expression") {
+        auto storage = make_storage(filename, make_unique_index("idx_users_email", upper(&User::email)), table);
+        REQUIRE(storage.sync_schema_simulate().at("idx_users_email") == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage.sync_schema().at("idx_users_email") == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage.sync_schema().at("idx_users_email") == sync_schema_result::already_in_sync);
+        REQUIRE_THROWS_AS(storage.insert(User{0, "ALICE@example.com"}), std::system_error);
+    }
+    SECTION("changed where") {
+        auto storage = make_storage(
+            filename,
+            make_unique_index("idx_users_email", lower(&User::email), where(is_not_null(&User::email))),
+            table);
+        REQUIRE(storage.sync_schema().at("idx_users_email") == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage.count<User>() == 1);
+    }
+}
+
+#if SQLITE_VERSION_NUMBER >= 3024000
+TEST_CASE("indexed_by") {
+    struct User {
+        int id = 0;
+        std::string name;
+        int age = 0;
+    };
+    auto storage = make_storage({},
+                                make_index("idx_users_name", &User::name),
+                                make_index("idx_users_age", &User::age),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("age", &User::age)));
+    storage.sync_schema();
+    storage.insert(User{0, "Alice", 30});
+
+    SECTION("select") {
+        auto byAge = storage.explain_query_plan(select(&User::id,
+                                                       where(c(&User::name) == "Alice" and c(&User::age) > 18),
+                                                       indexed_by<User>("idx_users_age")));
+        REQUIRE(byAge.contains("idx_users_age"));
+        REQUIRE(storage.select(&User::id,
+                               where(c(&User::name) == "Alice" and c(&User::age) > 18),
+                               indexed_by<User>("idx_users_age")) == std::vector<int>{1});
+    }
+    SECTION("get_all") {
+        auto statement = storage.prepare(get_all<User>(where(c(&User::name) == "Alice"), not_indexed<User>()));
+        REQUIRE(storage.explain_query_plan(statement).scans("users"));
+        REQUIRE(storage.dump(statement.expression).find(R"(FROM "users" NOT INDEXED WHERE)") != std::string::npos);
+        REQUIRE(storage.execute(statement).size() == 1);
+    }
+    SECTION("missing index") {
+        REQUIRE_THROWS_AS(storage.get_all<User>(indexed_by<User>("idx_missing")), std::system_error);
+    }
+}
+#endif
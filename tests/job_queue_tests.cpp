@@ -0,0 +1,84 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+#if SQLITE_VERSION_NUMBER >= 3035000
+TEST_CASE("job queue") {
+    using Job = queued_job<std::string>;
+    auto storage = make_storage({},
+                                make_job_queue_index<std::string>("jobs_pending"),
+                                make_job_lease_index<std::string>("jobs_leased"),
+                                make_job_queue_table<std::string>("jobs"));
+    storage.sync_schema();
+    auto queue = storage.make_job_queue<std::string>(2);
+    using namespace std::chrono_literals;
+
+    SECTION("claim ack") {
+        const auto first = queue.enqueue("a");
+        std::vector<std::string> payloads{"b", "c", "d"};
+        queue.enqueue(payloads.begin(), payloads.end());
+        REQUIRE(queue.pending_count() == 4);
+
+        auto jobs = queue.claim(2, 60s);
+        REQUIRE(jobs.size() == 2);
+        REQUIRE(jobs[0].id == first);
+        REQUIRE(jobs[0].payload == "a");
+        REQUIRE(jobs[1].payload == "b");
+        REQUIRE(jobs[0].state == job_claimed);
+        REQUIRE(jobs[0].attempts == 1);
+        REQUIRE(jobs[0].lease_until > 0);
+        REQUIRE(queue.pending_count() == 2);
+
+        auto next = queue.claim(5, 60s);
+        REQUIRE(next.size() == 2);
+        REQUIRE(next[0].payload == "c");
+        REQUIRE(queue.claim(5, 60s).empty());
+
+        REQUIRE(queue.ack(jobs[0]));
+        REQUIRE_FALSE(queue.ack(jobs[0]));
+        REQUIRE(storage.count<Job>() == 3);
+    }
+    SECTION("nack") {
+        queue.enqueue("a");
+        auto job = queue.claim(1, 60s).at(0);
+        REQUIRE(queue.nack(job));
+        REQUIRE(queue.pending_count() == 1);
+        job = queue.claim(1, 60s).at(0);
+        REQUIRE(job.attempts == 2);
+        REQUIRE(queue.nack(job));
+        REQUIRE(queue.pending_count() == 0);
+        REQUIRE(storage.get<Job>(job.id).state == job_failed);
+        REQUIRE(queue.claim(1, 60s).empty());
+    }
+    SECTION("lease expiry") {
+        queue.enqueue("a");
+        auto expired = queue.claim(1, 0ms).at(0);
+        auto job = queue.claim(1, 60s).at(0);
+        REQUIRE(job.id == expired.id);
+        REQUIRE(job.attempts == 2);
+        //  the first claim doesn't hold the job any more
+        REQUIRE_FALSE(queue.ack(expired));
+        REQUIRE_FALSE(queue.renew(expired, 60s));
+        REQUIRE(queue.renew(job, 120s));
+        REQUIRE(queue.ack(job));
+
+        queue.enqueue("b");
+        queue.claim(1, 0ms);
+        queue.claim(1, 0ms);
+        //  claimed twice: the expired lease fails the job
+        REQUIRE(queue.claim(1, 60s).empty());
+        REQUIRE(storage.count<Job>(where(c(&Job::state) == int(job_failed))) == 1);
+    }
+    SECTION("partial indexes") {
+        auto pending = storage.explain_query_plan(select(&Job::id,
+                                                         where(internal::job_state_is<Job>(job_pending)),
+                                                         order_by(&Job::id),
+                                                         limit(10)));
+        REQUIRE(pending.contains("jobs_pending"));
+        auto expired = storage.explain_query_plan(
+            select(&Job::id, where(internal::job_state_is<Job>(job_claimed) and c(&Job::lease_until) <= 100)));
+        REQUIRE(expired.contains("jobs_leased"));
+    }
+}
+#endif
@@ -463,4 +463,70 @@ TEST_CASE("json_group_array && json_group_object") {
         REQUIRE(rows == expected);
     }
 }
+TEST_CASE("json_each && json_tree") {
+    struct User {
+        int id = 0;
+        std::string tags;
+    };
+    auto storage = make_storage({},
+                                make_table("users", make_column("id", &User::id), make_column("tags", &User::tags)),
+                                make_json_each_table(),
+                                make_json_tree_table());
+    storage.sync_schema();
+
+    storage.insert(User{1, R"(["admin","dev"])"});
+    storage.insert(User{2, R"(["dev"])"});
+    storage.insert(User{3, R"({"team":{"lead":"ops"}})"});
+
+    SECTION("json_each") {
+        auto ids = storage.select(&User::id,
+                                  inner_join<json_each>(on(c(&json_each::json) == &User::tags)),
+                                  where(c(&json_each::value) == "dev"),
+                                  order_by(&User::id));
+        REQUIRE(ids == std::vector<int>{1, 2});
+
+        auto rows = storage.select(columns(&json_each::key, &json_each::value, &json_each::type),
+                                   where(c(&json_each::json) == R"([10,"x"])"));
+        REQUIRE(rows == std::vector<std::tuple<std::string, std::string, std::string>>{{"0", "10", "integer"},
+                                                                                          {"1", "x", "text"}});
+        REQUIRE(storage.get_all<json_each>(where(c(&json_each::json) == "[1,2,3]")).size() == 3);
+    }
+    SECTION("json_tree") {
+        auto paths = storage.select(&json_tree::fullkey,
+                                    inner_join<json_tree>(on(c(&json_tree::json) == &User::tags)),
+                                    where(c(&User::id) == 3 and c(&json_tree::atom) == "ops"));
+        REQUIRE(paths == std::vector<std::string>{"$.team.lead"});
+    }
+}
+
+TEST_CASE("select_json") {
+    struct User {
+        int id = 0;
+        std::string name;
+        std::unique_ptr<std::string> email;
+        double score = 0;
+    };
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("email", &User::email),
+                                           make_column("score", &User::score)));
+    storage.sync_schema();
+    REQUIRE(storage.select_json<User>() == "[]");
+
+    storage.replace(User{1, "Ann", std::make_unique<std::string>("ann@example.com"), 1.5});
+    storage.replace(User{2, "Bob \"B\"", nullptr, 2});
+    storage.replace(User{3, "Cid", nullptr, 0});
+    SECTION("all") {
+        REQUIRE(storage.select_json<User>(order_by(&User::id)) ==
+                R"([{"id":1,"name":"Ann","email":"ann@example.com","score":1.5},)"
+                R"({"id":2,"name":"Bob \"B\"","email":null,"score":2.0},)"
+                R"({"id":3,"name":"Cid","email":null,"score":0.0}])");
+    }
+    SECTION("conditions") {
+        REQUIRE(storage.select_json<User>(where(c(&User::id) > 1), order_by(&User::id).desc(), limit(1)) ==
+                R"([{"id":3,"name":"Cid","email":null,"score":0.0}])");
+    }
+}
 #endif  //  SQLITE_ENABLE_JSON1
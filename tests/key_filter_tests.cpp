@@ -0,0 +1,186 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <thread>  //  std::thread
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+
+    struct Setting {
+        std::string key;
+        std::string value;
+    };
+
+    struct Membership {
+        std::string group;
+        int userId = 0;
+    };
+}
+
+TEST_CASE("key filter") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)),
+        make_table("settings", make_column("key", &Setting::key, primary_key()), make_column("value", &Setting::value)),
+        make_table("memberships",
+                   make_column("group", &Membership::group),
+                   make_column("user_id", &Membership::userId),
+                   primary_key(&Membership::group, &Membership::userId)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.replace(Setting{"theme", "dark"});
+    storage.replace(Membership{"admins", 1});
+
+    SECTION("disabled") {
+        REQUIRE(storage.get_pointer<User>(3) == nullptr);
+        auto stats = storage.filter_stats<User>();
+        REQUIRE(stats.lookups == 0);
+        REQUIRE(stats.bits == 0);
+    }
+    SECTION("integer key") {
+        storage.enable_key_filter<User>(1000);
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.filter_stats<User>().rebuilds == 1);
+        int missing = 0;
+        for(int id = 100; id < 200; ++id) {
+            if(!storage.get_pointer<User>(id)) {
+                ++missing;
+            }
+        }
+        REQUIRE(missing == 100);
+        auto stats = storage.filter_stats<User>();
+        REQUIRE(stats.lookups == 101);
+        REQUIRE(stats.negatives > 90);
+        REQUIRE(stats.negatives + stats.false_positives == 100);
+        REQUIRE(stats.rebuilds == 1);
+        REQUIRE(stats.keys == 2);
+
+        REQUIRE_THROWS_AS(storage.get<User>(100), std::system_error);
+        auto result = storage.try_get<User>(100);
+        REQUIRE_FALSE(result);
+        REQUIRE(result.error() == orm_error_code::not_found);
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+        REQUIRE_FALSE(storage.get_optional<User>(100).has_value());
+#endif
+    }
+    SECTION("integer key writes") {
+        storage.enable_key_filter<User>(1000);
+        REQUIRE(storage.get_pointer<User>(3) == nullptr);
+        auto id = storage.insert(User{0, "Carol"});
+        REQUIRE(storage.get<User>(id).name == "Carol");
+        storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(50, "Dave")));
+        REQUIRE(storage.get<User>(50).name == "Dave");
+        storage.execute(storage.prepare(replace(User{60, "Eve"})));
+        REQUIRE(storage.get_pointer<User>(60)->name == "Eve");
+        auto stats = storage.filter_stats<User>();
+        REQUIRE(stats.rebuilds == 1);
+        REQUIRE(stats.keys == 5);
+
+        storage.remove<User>(60);
+        REQUIRE(storage.get_pointer<User>(60) == nullptr);
+        REQUIRE(storage.filter_stats<User>().false_positives == 1);
+    }
+    SECTION("prepared") {
+        storage.enable_key_filter<User>(1000);
+        auto statement = storage.prepare(get_pointer<User>(1));
+        REQUIRE(storage.execute(statement)->name == "Alice");
+        get<0>(statement) = 1000;
+        REQUIRE(storage.execute(statement) == nullptr);
+        get<0>(statement) = 2;
+        REQUIRE(storage.execute(statement)->name == "Bob");
+        REQUIRE(storage.filter_stats<User>().lookups == 3);
+    }
+    SECTION("text key") {
+        storage.enable_key_filter<Setting>(1000);
+        REQUIRE(storage.get<Setting>("theme").value == "dark");
+        REQUIRE(storage.get_pointer<Setting>(std::string{"language"}) == nullptr);
+        storage.replace(Setting{"language", "en"});
+        storage.execute(storage.prepare(replace(Setting{"font", "serif"})));
+        REQUIRE(storage.get<Setting>("language").value == "en");
+        REQUIRE(storage.get<Setting>("font").value == "serif");
+        storage.update(Setting{"font", "sans"});
+        REQUIRE(storage.get<Setting>("font").value == "sans");
+        REQUIRE(storage.filter_stats<Setting>().rebuilds == 1);
+
+        //  the key of a row written by SQL is unknown
+        storage.insert(into<Setting>(), columns(&Setting::key, &Setting::value), values(std::make_tuple("size", "12")));
+        REQUIRE(storage.get<Setting>("size").value == "12");
+        REQUIRE(storage.filter_stats<Setting>().rebuilds == 2);
+        REQUIRE(storage.get_pointer<Setting>("color") == nullptr);
+        REQUIRE(storage.filter_stats<Setting>().rebuilds == 2);
+    }
+    SECTION("composite key") {
+        storage.enable_key_filter<Membership>(1000);
+        REQUIRE(storage.get<Membership>("admins", 1).userId == 1);
+        REQUIRE(storage.get_pointer<Membership>("admins", 2) == nullptr);
+        REQUIRE(storage.get_pointer<Membership>("users", 1) == nullptr);
+        std::vector<Membership> memberships{{"users", 1}, {"users", 2}};
+        storage.replace_range(memberships.begin(), memberships.end());
+        REQUIRE(storage.get_pointer<Membership>("users", 2) != nullptr);
+        REQUIRE(storage.get_pointer<Membership>("users", 1) != nullptr);
+        auto stats = storage.filter_stats<Membership>();
+        REQUIRE(stats.lookups == 5);
+        REQUIRE(stats.rebuilds == 1);
+    }
+    SECTION("grows") {
+        storage.enable_key_filter<User>(1, 10);
+        REQUIRE(storage.get_pointer<User>(3) == nullptr);
+        auto bits = storage.filter_stats<User>().bits;
+        storage.transaction([&storage] {
+            for(int id = 10; id < 20; ++id) {
+                storage.replace(User{id, "User"});
+            }
+            return true;
+        });
+        REQUIRE(storage.get<User>(19).name == "User");
+        auto stats = storage.filter_stats<User>();
+        REQUIRE(stats.rebuilds == 2);
+        REQUIRE(stats.keys == 12);
+        REQUIRE(stats.bits > bits);
+    }
+    SECTION("disable") {
+        storage.enable_key_filter<User>(1000);
+        REQUIRE(storage.get_pointer<User>(3) == nullptr);
+        storage.disable_key_filter<User>();
+        REQUIRE(storage.get_pointer<User>(3) == nullptr);
+        REQUIRE(storage.filter_stats<User>().lookups == 0);
+    }
+}
+
+TEST_CASE("key filter with a transaction open on another connection") {
+    auto filename = "key_filter_writer.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        pool_options{2},
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.enable_key_filter<User>(1, 10);
+    REQUIRE(storage.get_pointer<User>(3) == nullptr);
+    REQUIRE(storage.filter_stats<User>().rebuilds == 1);
+
+    //  past twice the expected keys the filter goes stale, a rebuild on another connection can't see these rows
+    storage.begin_transaction();
+    for(int id = 10; id < 20; ++id) {
+        storage.replace(User{id, "User"});
+    }
+    bool found = true;
+    std::thread reader{[&storage, &found] {
+        found = storage.get_pointer<User>(3) != nullptr;
+    }};
+    reader.join();
+    REQUIRE_FALSE(found);
+    REQUIRE(storage.filter_stats<User>().rebuilds == 1);
+    storage.commit();
+
+    REQUIRE(storage.get<User>(19).name == "User");
+    REQUIRE(storage.filter_stats<User>().rebuilds == 2);
+    REQUIRE(storage.get_pointer<User>(3) == nullptr);
+}
@@ -0,0 +1,99 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Item {
+        int id = 0;
+        std::string category;
+    };
+}
+
+TEST_CASE("keyset pager") {
+    auto storage = make_storage(
+        {},
+        make_table("items", make_column("id", &Item::id, primary_key()), make_column("category", &Item::category)));
+    storage.sync_schema();
+    for(int i = 1; i <= 10; ++i) {
+        storage.replace(Item{i, i % 2 ? "odd" : "even"});
+    }
+    auto idsOf = [](const std::vector<Item>& items) {
+        std::vector<int> ids;
+        for(auto& item: items) {
+            ids.push_back(item.id);
+        }
+        return ids;
+    };
+
+    SECTION("objects") {
+        auto pager = storage.paginate<Item>(columns(&Item::category, &Item::id), 4);
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{2, 4, 6, 8});
+        REQUIRE_FALSE(pager.done());
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{10, 1, 3, 5});
+        REQUIRE(pager.last_key() == std::make_tuple(std::string("odd"), 5));
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{7, 9});
+        REQUIRE(pager.done());
+        REQUIRE(pager.next().empty());
+    }
+    SECTION("exact last page") {
+        auto pager = storage.paginate<Item>(columns(&Item::id), 5);
+        REQUIRE(pager.next().size() == 5);
+        REQUIRE(pager.next().size() == 5);
+        REQUIRE_FALSE(pager.done());
+        REQUIRE(pager.next().empty());
+        REQUIRE(pager.done());
+    }
+    SECTION("condition") {
+        auto pager = storage.paginate<Item>(columns(&Item::id), 2, where(c(&Item::category) == "odd"));
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{1, 3});
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{5, 7});
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{9});
+    }
+    SECTION("rows see changes behind the key") {
+        auto pager = storage.paginate<Item>(columns(&Item::id), 3);
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{1, 2, 3});
+        storage.remove<Item>(4);
+        storage.remove<Item>(1);
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{5, 6, 7});
+    }
+    SECTION("seek and rewind") {
+        auto pager = storage.paginate<Item>(columns(&Item::id), 3);
+        pager.seek(std::make_tuple(6));
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{7, 8, 9});
+        pager.rewind();
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{1, 2, 3});
+    }
+    SECTION("moved pager") {
+        auto pager = storage.paginate<Item>(columns(&Item::id), 3);
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{1, 2, 3});
+        REQUIRE(idsOf(pager.next()) == std::vector<int>{4, 5, 6});
+        auto moved = std::move(pager);
+        REQUIRE(idsOf(moved.next()) == std::vector<int>{7, 8, 9});
+    }
+    SECTION("columns") {
+        auto pager = storage.paginate(columns(&Item::category), columns(&Item::id), 4, where(c(&Item::id) > 3));
+        using row = std::tuple<std::string, int>;
+        REQUIRE(pager.next() == std::vector<row>{{"even", 4}, {"odd", 5}, {"even", 6}, {"odd", 7}});
+        REQUIRE(pager.next() == std::vector<row>{{"even", 8}, {"odd", 9}, {"even", 10}});
+        REQUIRE(pager.done());
+    }
+    SECTION("streaming") {
+        auto pager = storage.paginate<Item>(columns(&Item::id), 4);
+        std::vector<int> ids;
+        REQUIRE(pager.next([&ids](const Item& item) {
+            ids.push_back(item.id);
+            return item.id < 2;
+        }) == 2);
+        REQUIRE(ids == std::vector<int>{1, 2});
+        REQUIRE_FALSE(pager.done());
+        ids.clear();
+        REQUIRE(pager.next([&ids](const Item& item) {
+            ids.push_back(item.id);
+        }) == 4);
+        REQUIRE(ids == std::vector<int>{3, 4, 5, 6});
+        REQUIRE(pager.next([](const Item&) {}) == 4);
+        REQUIRE(pager.next([](const Item&) {}) == 0);
+        REQUIRE(pager.done());
+    }
+}
@@ -0,0 +1,78 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+#include <map>  //  std::map
+
+using namespace sqlite_orm;
+
+#if SQLITE_VERSION_NUMBER >= 3024000
+namespace {
+    struct Counters {};
+}
+
+TEST_CASE("kv store") {
+    auto storage = make_storage({},
+                                make_kv_table<std::string, std::string>("settings"),
+                                make_kv_table<std::string, int, Counters>("counters"));
+    storage.sync_schema();
+    auto settings = storage.make_kv_store<std::string, std::string>();
+
+    SECTION("get put remove") {
+        REQUIRE(settings.get_pointer("theme") == nullptr);
+        settings.put("theme", "dark");
+        REQUIRE(*settings.get_pointer("theme") == "dark");
+        settings.put("theme", "light");
+        std::string value;
+        REQUIRE(settings.get("theme", value));
+        REQUIRE(value == "light");
+        REQUIRE(storage.count<kv_entry<std::string, std::string>>() == 1);
+        settings.remove("theme");
+        REQUIRE_FALSE(settings.get("theme", value));
+        REQUIRE(value == "light");
+        settings.remove("missing");
+    }
+    SECTION("batches") {
+        std::map<std::string, std::string> entries{{"a", "1"}, {"b", "2"}, {"c", "3"}};
+        settings.multi_put(entries.begin(), entries.end());
+        std::vector<std::string> keys{"c", "x", "a"};
+        auto found = settings.multi_get(keys.begin(), keys.end());
+        decltype(found) expected{{"c", "3"}, {"a", "1"}};
+        REQUIRE(found == expected);
+    }
+    SECTION("scans") {
+        std::vector<std::pair<std::string, std::string>> entries{{"user:1", "a"},
+                                                                 {"user:2", "b"},
+                                                                 {"users", "c"},
+                                                                 {"group:1", "d"},
+                                                                 {"\xff", "e"},
+                                                                 {"\xff\xff", "f"}};
+        settings.multi_put(entries.begin(), entries.end());
+        decltype(entries) expected{{"user:1", "a"}, {"user:2", "b"}};
+        REQUIRE(settings.scan_prefix("user:") == expected);
+        expected = {{"\xff", "e"}, {"\xff\xff", "f"}};
+        REQUIRE(settings.scan_prefix("\xff") == expected);
+        REQUIRE(settings.scan_prefix("").size() == entries.size());
+
+        std::vector<std::string> keys;
+        settings.scan("user:", "users", [&keys](const std::string& key, const std::string&) {
+            keys.push_back(key);
+            return keys.size() < 1;
+        });
+        REQUIRE(keys == std::vector<std::string>{"user:1"});
+    }
+    SECTION("tables") {
+        auto counters = storage.make_kv_store<std::string, int, Counters>();
+        counters.put("visits", 3);
+        settings.put("visits", "many");
+        REQUIRE(*counters.get_pointer("visits") == 3);
+        REQUIRE(*settings.get_pointer("visits") == "many");
+    }
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+    SECTION("optional") {
+        REQUIRE_FALSE(settings.get_optional("theme"));
+        settings.put("theme", "dark");
+        REQUIRE(settings.get_optional("theme") == "dark");
+    }
+#endif
+}
+#endif
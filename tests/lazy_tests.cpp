@@ -0,0 +1,80 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Attachment {
+        int id = 0;
+        std::string name;
+        lazy<std::vector<char>> payload;
+    };
+
+    struct Note {
+        std::string key;
+        lazy<std::string> text;
+    };
+}
+
+TEST_CASE("lazy") {
+    auto storage = make_storage("",
+                                make_table("attachments",
+                                           make_column("id", &Attachment::id, primary_key()),
+                                           make_column("name", &Attachment::name),
+                                           make_column("payload", &Attachment::payload)),
+                                make_table("notes",
+                                           make_column("key", &Note::key, primary_key()),
+                                           make_column("text", &Note::text)));
+    storage.sync_schema();
+    REQUIRE(storage.pragma.table_info("attachments")[2].type == "BLOB");
+
+    const std::vector<char> payload(100000, 'p');
+    Attachment attachment;
+    attachment.id = 1;
+    attachment.name = "big";
+    attachment.payload = payload;
+    storage.replace(attachment);
+    attachment.id = 2;
+    attachment.name = "small";
+    attachment.payload = std::vector<char>{'s'};
+    storage.replace(attachment);
+
+    SECTION("get_all") {
+        auto attachments = storage.get_all<Attachment>(order_by(&Attachment::id));
+        REQUIRE(attachments.size() == 2);
+        REQUIRE(attachments[0].name == "big");
+        REQUIRE_FALSE(attachments[0].payload.is_loaded());
+        REQUIRE_FALSE(attachments[1].payload.is_loaded());
+        REQUIRE(attachments[0].payload.get() == payload);
+        REQUIRE(attachments[0].payload.is_loaded());
+        REQUIRE(attachments[1].payload.get() == std::vector<char>{'s'});
+    }
+    SECTION("get") {
+        auto small = storage.get<Attachment>(2);
+        REQUIRE_FALSE(small.payload.is_loaded());
+        small.name = "renamed";
+        storage.update(small);
+        REQUIRE(storage.get<Attachment>(2).payload.get() == std::vector<char>{'s'});
+        REQUIRE_FALSE(storage.get_pointer<Attachment>(1)->payload.is_loaded());
+    }
+    SECTION("removed row") {
+        auto big = storage.get<Attachment>(1);
+        storage.remove<Attachment>(1);
+        REQUIRE_THROWS_WITH(big.payload.get(), Catch::Matchers::ContainsSubstring("Not found"));
+    }
+    SECTION("select and non-integer primary key read right away") {
+        auto payloads = storage.select(&Attachment::payload, where(c(&Attachment::id) == 2));
+        REQUIRE(payloads.size() == 1);
+        REQUIRE(payloads[0].is_loaded());
+        REQUIRE(payloads[0].get() == std::vector<char>{'s'});
+
+        Note note;
+        note.key = "a";
+        note.text = std::string("text");
+        storage.replace(note);
+        auto notes = storage.get_all<Note>();
+        REQUIRE(notes.size() == 1);
+        REQUIRE(notes[0].text.is_loaded());
+        REQUIRE(notes[0].text.get() == "text");
+    }
+}
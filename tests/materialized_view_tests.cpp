@@ -0,0 +1,157 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Visit {
+        int id = 0;
+        int userId = 0;
+        std::unique_ptr<int> duration;
+    };
+
+    struct VisitStats {
+        int userId = 0;
+        int visits = 0;
+        int durations = 0;
+        int totalDuration = 0;
+    };
+
+    struct VisitTotals {
+        int visits = 0;
+    };
+
+    auto make_visits_storage(std::string filename) {
+        return make_storage(
+            std::move(filename),
+            make_materialized_view<VisitStats>(
+                "visit_stats_mv",
+                select(columns(&Visit::userId, count(), count(&Visit::duration), sum(&Visit::duration)),
+                       group_by(&Visit::userId))),
+            make_materialized_view<VisitTotals>("visit_totals_mv", select(columns(count<Visit>()))),
+            make_table("visit_stats",
+                       make_column("user_id", &VisitStats::userId, primary_key()),
+                       make_column("visits", &VisitStats::visits),
+                       make_column("durations", &VisitStats::durations),
+                       make_column("total_duration", &VisitStats::totalDuration)),
+            make_table("visit_totals", make_column("visits", &VisitTotals::visits)),
+            make_table("visits",
+                       make_column("id", &Visit::id, primary_key()),
+                       make_column("user_id", &Visit::userId),
+                       make_column("duration", &Visit::duration)));
+    }
+}
+
+TEST_CASE("materialized view") {
+    auto filename = "materialized_view.sqlite";
+    ::remove(filename);
+    auto storage = make_visits_storage(filename);
+    storage.sync_schema();
+    //  rows inserted before the triggers exist are picked up by the first fill
+    storage.drop_trigger("visit_stats_mv_insert");
+    storage.drop_trigger("visit_stats_mv_update");
+    storage.drop_trigger("visit_stats_mv_delete");
+    storage.insert(Visit{0, 1, std::make_unique<int>(10)});
+    auto syncResult = storage.sync_schema();
+    REQUIRE(syncResult.at("visit_stats_mv") == sync_schema_result::new_table_created);
+    REQUIRE(syncResult.at("visit_totals_mv") == sync_schema_result::already_in_sync);
+
+    auto stats = [&storage](int userId) {
+        auto row = storage.get_pointer<VisitStats>(userId);
+        return row ? std::vector<int>{row->visits, row->durations, row->totalDuration} : std::vector<int>{};
+    };
+    REQUIRE(stats(1) == std::vector<int>{1, 1, 10});
+
+    storage.insert(Visit{0, 1, std::make_unique<int>(5)});
+    storage.insert(Visit{0, 1, nullptr});
+    auto secondId = storage.insert(Visit{0, 2, std::make_unique<int>(7)});
+    REQUIRE(stats(1) == std::vector<int>{3, 2, 15});
+    REQUIRE(stats(2) == std::vector<int>{1, 1, 7});
+    REQUIRE(storage.get_all<VisitTotals>().at(0).visits == 4);
+
+    SECTION("update moves a row to another group") {
+        auto visit = storage.get<Visit>(secondId);
+        visit.userId = 1;
+        storage.update(visit);
+        REQUIRE(stats(1) == std::vector<int>{4, 3, 22});
+        REQUIRE(stats(2).empty());
+    }
+    SECTION("update of an aggregated column") {
+        storage.update_all(set(c(&Visit::duration) = 1), where(c(&Visit::userId) == 1));
+        REQUIRE(stats(1) == std::vector<int>{3, 3, 3});
+    }
+    SECTION("delete removes empty groups") {
+        storage.remove_all<Visit>(where(c(&Visit::userId) == 2));
+        REQUIRE(stats(2).empty());
+        storage.remove_all<Visit>();
+        REQUIRE(storage.count<VisitStats>() == 0);
+        REQUIRE(storage.get_all<VisitTotals>().at(0).visits == 0);
+    }
+    SECTION("sync again") {
+        auto again = make_visits_storage(filename);
+        REQUIRE(again.sync_schema_simulate().at("visit_stats_mv") == sync_schema_result::already_in_sync);
+        REQUIRE(again.sync_schema().at("visit_stats_mv") == sync_schema_result::already_in_sync);
+        REQUIRE(stats(1) == std::vector<int>{3, 2, 15});
+    }
+}
+
+TEST_CASE("time bucket rollup") {
+    struct Point {
+        int id = 0;
+        int64 ts = 0;
+        double value = 0;
+        std::string time;
+    };
+    struct PointRollup {
+        int64 bucket = 0;
+        int points = 0;
+        double total = 0;
+    };
+    auto storage = make_storage(
+        "",
+        make_materialized_view<PointRollup>(
+            "points_5m_mv",
+            select(columns(time_bucket(&Point::ts, 300), count(), total(&Point::value)),
+                   group_by(time_bucket(&Point::ts, 300)))),
+        make_table("points_5m",
+                   make_column("bucket", &PointRollup::bucket, primary_key()),
+                   make_column("points", &PointRollup::points),
+                   make_column("total", &PointRollup::total)),
+        make_table("points",
+                   make_column("id", &Point::id, primary_key()),
+                   make_column("ts", &Point::ts),
+                   make_column("value", &Point::value),
+                   make_column("time", &Point::time)));
+    storage.sync_schema();
+    storage.insert(Point{0, 1000, 1, "2024-01-01 10:01:00"});
+    storage.insert(Point{0, 1100, 2, "2024-01-01 10:04:59"});
+    storage.insert(Point{0, 1200, 3, "2024-01-01 10:05:00"});
+    auto lastId = storage.insert(Point{0, 1600, 4, "2024-01-01 11:00:00"});
+
+    auto rollup = [&storage] {
+        std::vector<std::tuple<int64, int, double>> result;
+        for(auto& row: storage.get_all<PointRollup>(order_by(&PointRollup::bucket))) {
+            result.emplace_back(row.bucket, row.points, row.total);
+        }
+        return result;
+    };
+    using rows = std::vector<std::tuple<int64, int, double>>;
+    REQUIRE(rollup() == rows{{900, 2, 3}, {1200, 1, 3}, {1500, 1, 4}});
+    auto grouped = storage.select(columns(time_bucket(&Point::ts, 300), count(), total(&Point::value)),
+                                  group_by(time_bucket(&Point::ts, 300)),
+                                  order_by(time_bucket(&Point::ts, 300)));
+    REQUIRE(grouped == rows{{900, 2, 3}, {1200, 1, 3}, {1500, 1, 4}});
+
+    auto moved = storage.get<Point>(lastId);
+    moved.ts = 1250;
+    storage.update(moved);
+    REQUIRE(rollup() == rows{{900, 2, 3}, {1200, 2, 7}});
+    storage.remove<Point>(lastId);
+    REQUIRE(rollup() == rows{{900, 2, 3}, {1200, 1, 3}});
+
+    auto hours = storage.select(columns(time_bucket(&Point::time, 3600), count()),
+                                group_by(time_bucket(&Point::time, 3600)),
+                                order_by(time_bucket(&Point::time, 3600)));
+    using hour_rows = std::vector<std::tuple<std::string, int>>;
+    REQUIRE(hours == hour_rows{{"2024-01-01 10:00:00", 3}});
+}
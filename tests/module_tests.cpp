@@ -0,0 +1,27 @@
+#include <catch2/catch_all.hpp>
+#include <string>  //  std::string
+#include <vector>  //  std::vector
+
+import sqlite_orm;
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+}
+
+TEST_CASE("import sqlite_orm") {
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+
+    auto names = storage.select(&User::name, where(c(&User::id) > 1));
+    REQUIRE(names == std::vector<std::string>{"Bob"});
+    REQUIRE(storage.count<User>() == 2);
+}
@@ -0,0 +1,172 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+
+    struct Membership {
+        std::string group;
+        int userId = 0;
+        int role = 0;
+    };
+}
+
+TEST_CASE("object cache") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)),
+        make_table("memberships",
+                   make_column("group", &Membership::group),
+                   make_column("user_id", &Membership::userId),
+                   make_column("role", &Membership::role),
+                   primary_key(&Membership::group, &Membership::userId)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.enable_object_cache<User>(16);
+
+    SECTION("hits") {
+        auto first = storage.get_shared<User>(1);
+        auto second = storage.get_shared<User>(1);
+        REQUIRE(first == second);
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.get_pointer<User>(1)->name == "Alice");
+        auto stats = storage.cache_stats<User>();
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.hits == 3);
+        REQUIRE(stats.size == 1);
+    }
+    SECTION("not found") {
+        REQUIRE_THROWS_AS(storage.get<User>(3), std::system_error);
+        REQUIRE(storage.get_pointer<User>(3) == nullptr);
+        REQUIRE(storage.cache_stats<User>().size == 0);
+    }
+    SECTION("update") {
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        storage.update(User{1, "Alicia"});
+        REQUIRE(storage.get<User>(1).name == "Alicia");
+        storage.replace(User{1, "Alice"});
+        REQUIRE(storage.get<User>(1).name == "Alice");
+    }
+    SECTION("update hook") {
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.get<User>(2).name == "Bob");
+        storage.update_all(set(c(&User::name) = "Carol"), where(c(&User::id) == 1));
+        REQUIRE(storage.cache_stats<User>().size == 1);
+        REQUIRE(storage.get<User>(1).name == "Carol");
+    }
+    SECTION("remove") {
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.get<User>(2).name == "Bob");
+        storage.remove<User>(1);
+        REQUIRE(storage.get_pointer<User>(1) == nullptr);
+        storage.remove_all<User>();
+        REQUIRE(storage.cache_stats<User>().size == 0);
+        REQUIRE(storage.get_pointer<User>(2) == nullptr);
+    }
+    SECTION("transaction") {
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        storage.begin_transaction();
+        storage.update_all(set(c(&User::name) = "Carol"), where(c(&User::id) == 1));
+        REQUIRE(storage.get<User>(1).name == "Carol");
+        //  not committed yet
+        REQUIRE(storage.cache_stats<User>().size == 0);
+        storage.rollback();
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.cache_stats<User>().size == 1);
+    }
+    SECTION("capacity") {
+        storage.enable_object_cache<User>(1);
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.get<User>(2).name == "Bob");
+        auto stats = storage.cache_stats<User>();
+        REQUIRE(stats.size == 1);
+        REQUIRE(stats.evictions == 1);
+    }
+    SECTION("composite key") {
+        storage.enable_object_cache<Membership>();
+        storage.replace(Membership{"admins", 1, 1});
+        storage.replace(Membership{"users", 1, 2});
+        REQUIRE(storage.get<Membership>("admins", 1).role == 1);
+        REQUIRE(storage.get<Membership>("users", 1).role == 2);
+        REQUIRE(storage.cache_stats<Membership>().size == 2);
+        //  rowids aren't keys, so every change drops the whole cache
+        storage.update_all(set(c(&Membership::role) = 3), where(c(&Membership::group) == "users"));
+        REQUIRE(storage.cache_stats<Membership>().size == 0);
+        REQUIRE(storage.get<Membership>("users", 1).role == 3);
+        storage.update(Membership{"users", 1, 4});
+        REQUIRE(storage.get<Membership>("users", 1).role == 4);
+    }
+    SECTION("disable") {
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        storage.disable_object_cache<User>();
+        REQUIRE(storage.cache_stats<User>().size == 0);
+        storage.update(User{1, "Alicia"});
+        REQUIRE(storage.get<User>(1).name == "Alicia");
+    }
+}
+
+TEST_CASE("cache coherence") {
+    const std::string filename = "cache_coherence.sqlite";
+    ::remove(filename.c_str());
+    auto makeStorage = [&filename] {
+        return make_storage(
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    };
+    auto storage = makeStorage();
+    auto other = makeStorage();
+    storage.sync_schema();
+    storage.open_forever();
+    other.open_forever();
+    storage.replace(User{1, "Alice"});
+    storage.enable_object_cache<User>();
+    storage.enable_query_cache();
+    auto names = [&storage] {
+        return storage.select(&User::name, where(c(&User::id) == 1), cached());
+    };
+    REQUIRE(storage.get<User>(1).name == "Alice");
+    REQUIRE(names() == std::vector<std::string>{"Alice"});
+
+    SECTION("disabled") {
+        other.update(User{1, "Bob"});
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(names() == std::vector<std::string>{"Alice"});
+    }
+    SECTION("enabled") {
+        storage.enable_cache_coherence();
+        const int version = storage.data_version();
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.cache_stats<User>().hits >= 1);
+        //  changes of the storage's own connection don't change its data version
+        storage.update(User{1, "Alicia"});
+        REQUIRE(storage.data_version() == version);
+        REQUIRE(storage.get<User>(1).name == "Alicia");
+        const auto hits = storage.cache_stats<User>().hits;
+        REQUIRE(storage.get<User>(1).name == "Alicia");
+        REQUIRE(storage.cache_stats<User>().hits == hits + 1);
+
+        other.update(User{1, "Bob"});
+        REQUIRE(storage.data_version() != version);
+        REQUIRE(storage.get<User>(1).name == "Bob");
+        REQUIRE(names() == std::vector<std::string>{"Bob"});
+
+        other.update(User{1, "Carol"});
+        storage.transaction([&storage] {
+            REQUIRE(storage.cache_stats<User>().size == 0);
+            REQUIRE(storage.get<User>(1).name == "Carol");
+            return true;
+        });
+        storage.disable_cache_coherence();
+        REQUIRE(storage.get<User>(1).name == "Carol");
+        other.update(User{1, "Dave"});
+        REQUIRE(storage.get<User>(1).name == "Carol");
+    }
+    ::remove(filename.c_str());
+}
@@ -83,6 +83,29 @@ TEST_CASE("In") {
             expected.push_back({2});
             expected.push_back({3});
         }
+        SECTION("array") {
+            SECTION("in") {
+                rows = storage.get_all<User>(where(in(&User::id, as_array({1, 3, 5}))));
+                expected.push_back({1});
+                expected.push_back({3});
+            }
+            SECTION("not in") {
+                rows = storage.get_all<User>(where(not_in(&User::id, as_array({1, 3}))));
+                expected.push_back({2});
+            }
+            SECTION("empty") {
+                rows = storage.get_all<User>(where(in(&User::id, as_array(std::vector<int>{}))));
+            }
+            SECTION("one statement for any size") {
+                auto statement = storage.prepare(get_all<User>(where(in(&User::id, as_array({1})))));
+                auto otherStatement = storage.prepare(get_all<User>(where(in(&User::id, as_array({1, 2, 3, 4})))));
+                REQUIRE(statement.sql() == otherStatement.sql());
+                get<0>(statement).values = {2, 3};
+                rows = storage.execute(statement);
+                expected.push_back({2});
+                expected.push_back({3});
+            }
+        }
         REQUIRE_THAT(rows, UnorderedEquals(expected));
     }
     {
@@ -111,5 +134,57 @@ TEST_CASE("In") {
             auto rows2 = storage.select(&Letter::name, where(in(&Letter::id, {1, 2, 3})));
             REQUIRE(rows2.size() == 3);
         }
+        {
+            auto ids = storage.select(&Letter::id, where(in(&Letter::name, as_array<std::string>({"A", "C", "\"D"}))));
+            REQUIRE_THAT(ids, UnorderedEquals(std::vector<int>{1, 3}));
+        }
+    }
+}
+
+TEST_CASE("Row values") {
+    struct Entry {
+        int day = 0;
+        int id = 0;
+        std::string text;
+    };
+    auto storage = make_storage("",
+                                make_table("entries",
+                                           make_column("day", &Entry::day),
+                                           make_column("id", &Entry::id),
+                                           make_column("text", &Entry::text),
+                                           primary_key(&Entry::day, &Entry::id))
+                                    .without_rowid());
+    storage.sync_schema();
+    storage.replace(Entry{1, 1, "a"});
+    storage.replace(Entry{1, 2, "b"});
+    storage.replace(Entry{2, 1, "c"});
+    storage.replace(Entry{2, 2, "d"});
+    auto texts = [](const std::vector<Entry>& entries) {
+        std::vector<std::string> result;
+        for(auto& entry: entries) {
+            result.push_back(entry.text);
+        }
+        return result;
+    };
+    auto order = multi_order_by(order_by(&Entry::day), order_by(&Entry::id));
+    SECTION("comparison") {
+        auto expression = get_all<Entry>(where(tuple_value(&Entry::day, &Entry::id) > std::make_tuple(1, 2)), order);
+        REQUIRE(texts(storage.execute(storage.prepare(expression))) == std::vector<std::string>{"c", "d"});
+        REQUIRE_FALSE(storage.explain_query_plan(expression).scans("entries"));
+
+        auto rows = storage.get_all<Entry>(where(tuple_value(&Entry::day, &Entry::id) <= tuple_value(1, 2)), order);
+        REQUIRE(texts(rows) == std::vector<std::string>{"a", "b"});
+    }
+    SECTION("in") {
+        std::vector<std::tuple<int, int>> keys{{1, 2}, {2, 1}, {3, 3}};
+        auto expression = get_all<Entry>(where(in(tuple_value(&Entry::day, &Entry::id), keys)), order);
+        REQUIRE(texts(storage.execute(storage.prepare(expression))) == std::vector<std::string>{"b", "c"});
+
+        auto rows = storage.get_all<Entry>(where(not_in(tuple_value(&Entry::day, &Entry::id), keys)), order);
+        REQUIRE(texts(rows) == std::vector<std::string>{"a", "d"});
+
+        keys.clear();
+        REQUIRE(storage.get_all<Entry>(where(in(tuple_value(&Entry::day, &Entry::id), keys))).empty());
+        REQUIRE(storage.count<Entry>(where(not_in(tuple_value(&Entry::day, &Entry::id), keys))) == 4);
     }
 }
@@ -0,0 +1,71 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Metric {
+        sqlite3_int64 time = 0;
+        double value = 0;
+    };
+
+    //  2026-10-14 00:00:00 UTC
+    constexpr sqlite3_int64 october = 1791936000;
+    constexpr sqlite3_int64 day = 86400;
+}
+
+TEST_CASE("monthly partitions") {
+    auto scheme = monthly_partitions();
+    REQUIRE(scheme.suffix_of(scheme.number_of(october)) == "2026_10");
+    REQUIRE(scheme.suffix_of(scheme.number_of(0)) == "1970_01");
+    REQUIRE(scheme.suffix_of(scheme.number_of(-1)) == "1969_12");
+    REQUIRE(scheme.suffix_of(scheme.number_of(october + 18 * day)) == "2026_11");
+    sqlite3_int64 number = 0;
+    REQUIRE(scheme.parse_suffix("2026_10", number));
+    REQUIRE(number == scheme.number_of(october));
+    REQUIRE_FALSE(scheme.parse_suffix("2026_13", number));
+    REQUIRE_FALSE(scheme.parse_suffix("rebuild", number));
+}
+
+TEST_CASE("partitioned storage") {
+    ::remove("partitioned.sqlite");
+    auto makePartition = [](const std::string& tableName) {
+        return make_storage(
+            "partitioned.sqlite",
+            make_table(tableName, make_column("time", &Metric::time), make_column("value", &Metric::value)));
+    };
+    auto metrics = make_partitioned_storage("metrics", &Metric::time, monthly_partitions(), makePartition);
+    REQUIRE(metrics.partition_names().empty());
+    metrics.insert(Metric{october - 30 * day, 1});
+    metrics.insert(Metric{october, 2});
+    metrics.insert(Metric{october + day, 3});
+    std::vector<Metric> november{{october + 20 * day, 4}, {october + 21 * day, 5}};
+    metrics.replace_range(november.begin(), november.end());
+
+    REQUIRE(metrics.partition_names() ==
+            std::vector<std::string>{"metrics_2026_09", "metrics_2026_10", "metrics_2026_11"});
+    REQUIRE(metrics.partition_name(october) == "metrics_2026_10");
+    REQUIRE(metrics.count() == 5);
+    REQUIRE(makePartition("metrics_2026_10").count<Metric>() == 2);
+
+    SECTION("range queries") {
+        auto rows = metrics.get_all_between(october, october + 20 * day, order_by(&Metric::time));
+        REQUIRE(rows.size() == 3);
+        REQUIRE(rows.front().value == 2);
+        REQUIRE(rows.back().value == 4);
+        REQUIRE(metrics.get_all_between(october, october + 30 * day, where(c(&Metric::value) > 2)).size() == 3);
+        REQUIRE(metrics.count_between(october - 30 * day, october) == 2);
+        REQUIRE(metrics.get_all(where(c(&Metric::value) < 3)).size() == 2);
+    }
+    SECTION("retention") {
+        REQUIRE(metrics.drop_partitions_before(october) == 1);
+        REQUIRE(metrics.partition_names() == std::vector<std::string>{"metrics_2026_10", "metrics_2026_11"});
+        REQUIRE(metrics.count() == 4);
+        REQUIRE_FALSE(makePartition("metrics").table_exists("metrics_2026_09"));
+    }
+    SECTION("existing partitions are found") {
+        auto reopened = make_partitioned_storage("metrics", &Metric::time, monthly_partitions(), makePartition);
+        REQUIRE(reopened.partition_names() == metrics.partition_names());
+        REQUIRE(reopened.count() == 5);
+    }
+}
@@ -1,5 +1,8 @@
 #include <sqlite_orm/sqlite_orm.h>
 #include <catch2/catch_all.hpp>
+#include <memory>  //  std::make_shared
+#include <set>  //  std::set
+#include <unordered_set>  //  std::unordered_set
 
 using namespace sqlite_orm;
 using std::unique_ptr;
@@ -158,3 +161,52 @@ TEST_CASE("pointer-passing") {
     }
 }
 #endif
+
+namespace {
+    struct Person {
+        int64 id = 0;
+        std::string name;
+    };
+
+    struct contains_name_fn : contains_fn<std::vector<std::string>> {
+        static const char* name() {
+            return "contains_name";
+        }
+    };
+}
+
+TEST_CASE("container binding") {
+    using id_set = std::unordered_set<int64>;
+    auto storage = make_storage(
+        "",
+        make_table("persons", make_column("id", &Person::id, primary_key()), make_column("name", &Person::name)));
+    storage.sync_schema();
+    storage.replace(Person{1, "Alice"});
+    storage.replace(Person{2, "Bob"});
+    storage.replace(Person{3, "Carol"});
+    storage.create_scalar_function<contains_fn<id_set>>();
+    storage.create_scalar_function<contains_name_fn>();
+
+    SECTION("referenced set") {
+        id_set ids{1, 3, 7};
+        auto rows = storage.select(&Person::id,
+                                   where(func<contains_fn<id_set>>(&Person::id, bind_container(ids))),
+                                   order_by(&Person::id));
+        REQUIRE(rows == std::vector<int64>{1, 3});
+    }
+    SECTION("owned vector with a prepared statement") {
+        auto statement = storage.prepare(select(
+            &Person::name,
+            where(func<contains_name_fn>(&Person::name, bind_container(std::vector<std::string>{"Bob", "Dave"})))));
+        REQUIRE(storage.execute(statement) == std::vector<std::string>{"Bob"});
+        REQUIRE(storage.execute(statement) == std::vector<std::string>{"Bob"});
+    }
+    SECTION("shared set") {
+        auto ids = std::make_shared<id_set>(id_set{2});
+        REQUIRE(storage.count<Person>(where(func<contains_fn<id_set>>(&Person::id, bind_container(ids)))) == 1);
+    }
+    SECTION("another container type is not passed") {
+        std::set<int64> ids{1, 2, 3};
+        REQUIRE(storage.count<Person>(where(func<contains_fn<id_set>>(&Person::id, bind_container(ids)))) == 0);
+    }
+}
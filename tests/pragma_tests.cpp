@@ -1,5 +1,6 @@
 #include <sqlite_orm/sqlite_orm.h>
 #include <cstdio>  //  ::remove
+#include <thread>  //  std::thread
 #include <catch2/catch_all.hpp>
 
 using namespace sqlite_orm;
@@ -83,6 +84,20 @@ TEST_CASE("User version") {
     storage.pragma.user_version(version + 2);
     REQUIRE(storage.pragma.user_version() == version + 2);
     storage.commit();
+
+    SECTION("polled with the statement cache") {
+        const auto journalMode = storage.pragma.journal_mode();
+        storage.enable_statement_cache();
+        for(int i = 0; i < 3; ++i) {
+            REQUIRE(storage.pragma.user_version() == version + 2);
+            REQUIRE(storage.pragma.journal_mode() == journalMode);
+        }
+        auto stats = storage.cached_statements_stats();
+        REQUIRE(stats.count("PRAGMA user_version") == 1);
+#if SQLITE_VERSION_NUMBER >= 3020000
+        REQUIRE(stats["PRAGMA user_version"].runs == 3);
+#endif
+    }
 }
 
 TEST_CASE("Auto vacuum") {
@@ -153,3 +168,162 @@ TEST_CASE("application_id") {
     storage.pragma.application_id(3);
     REQUIRE(storage.pragma.application_id() == 3);
 }
+
+TEST_CASE("performance pragmas") {
+    auto filename = "performance_pragmas.sqlite";
+    ::remove(filename);
+
+    //  no connection is kept open, so every call below opens a new one
+    auto storage = make_storage(filename);
+    storage.pragma.page_size(8192);
+    storage.pragma.cache_size(-4000);
+    storage.pragma.temp_store(2);
+    storage.pragma.cache_spill(0);
+    storage.pragma.mmap_size(1 << 20);
+    storage.pragma.journal_size_limit(1 << 16);
+    storage.pragma.threads(2);
+    storage.pragma.wal_autocheckpoint(500);
+
+    REQUIRE(storage.pragma.page_size() == 8192);
+    REQUIRE(storage.pragma.cache_size() == -4000);
+    REQUIRE(storage.pragma.temp_store() == 2);
+    REQUIRE(storage.pragma.cache_spill() == 0);
+    REQUIRE(storage.pragma.journal_size_limit() == 1 << 16);
+    REQUIRE(storage.pragma.wal_autocheckpoint() == 500);
+#if SQLITE_VERSION_NUMBER >= 3032000
+    storage.pragma.analysis_limit(100);
+    REQUIRE(storage.pragma.analysis_limit() == 100);
+#endif
+    storage.pragma.optimize();
+    storage.pragma.optimize(0x10002);
+
+    SECTION("opened connection") {
+        storage.open_forever();
+        storage.pragma.cache_size(-2000);
+        REQUIRE(storage.pragma.cache_size() == -2000);
+        REQUIRE(storage.pragma.temp_store() == 2);
+    }
+    SECTION("connection pool") {
+        auto pooled = make_storage(pool_options{2}, filename);
+        pooled.pragma.cache_size(-3000);
+        int cacheSize = 0;
+        std::thread{[&pooled, &cacheSize] {
+            cacheSize = pooled.pragma.cache_size();
+        }}.join();
+        REQUIRE(cacheSize == -3000);
+    }
+}
+
+TEST_CASE("performance profile") {
+    auto filename = "performance_profile.sqlite";
+    ::remove(filename);
+
+    auto profile = performance_profile::read_heavy();
+    profile.cache_size = -16000;
+    profile.mmap_size.reset();
+    auto storage = make_storage(profile, filename);
+    REQUIRE(storage.pragma.journal_mode() == journal_mode::WAL);
+    REQUIRE(storage.pragma.synchronous() == 1);
+    REQUIRE(storage.pragma.cache_size() == -16000);
+    REQUIRE(storage.pragma.temp_store() == 2);
+
+    SECTION("switching profiles") {
+        storage.open_forever();
+        storage.apply_performance_profile(performance_profile::durable());
+        REQUIRE(storage.pragma.synchronous() == 2);
+        REQUIRE(storage.pragma.journal_mode() == journal_mode::WAL);
+        REQUIRE(storage.pragma.cache_size() == -16000);
+    }
+    SECTION("low memory") {
+        const auto softHeapLimit = sqlite3_soft_heap_limit64(-1);
+        storage.apply_performance_profile(performance_profile::low_memory());
+        REQUIRE(sqlite3_soft_heap_limit64(-1) == 8 * 1024 * 1024);
+        REQUIRE(storage.pragma.cache_size() == -2048);
+        REQUIRE(storage.pragma.mmap_size() == 0);
+        sqlite3_soft_heap_limit64(softHeapLimit);
+    }
+    SECTION("connection pool") {
+        auto pooled = make_storage(pool_options{2}, performance_profile::durable(), filename);
+        REQUIRE(pooled.pragma.synchronous() == 2);
+    }
+    SECTION("in memory") {
+        auto memoryStorage = make_storage(performance_profile::bulk_load(), "");
+        REQUIRE(memoryStorage.pragma.synchronous() == 0);
+        REQUIRE(memoryStorage.pragma.journal_mode() == journal_mode::MEMORY);
+    }
+}
+
+TEST_CASE("page size") {
+    struct Blob {
+        int id = 0;
+        std::vector<char> data;
+    };
+    auto filename = "page_size.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename](const performance_profile& profile) {
+        return make_storage(
+            profile,
+            filename,
+            make_table("blobs", make_column("id", &Blob::id, primary_key()), make_column("data", &Blob::data)));
+    };
+
+    auto profile = performance_profile::read_heavy();
+    profile.page_size = 8192;
+    auto storage = makeStorage(profile);
+    storage.sync_schema();
+    REQUIRE(storage.pragma.page_size() == 8192);
+    storage.insert(Blob{0, std::vector<char>(100000, 'x')});
+
+    SECTION("existing database keeps its page size") {
+        profile.page_size = 16384;
+        auto reopened = makeStorage(profile);
+        REQUIRE(reopened.pragma.page_size() == 8192);
+    }
+    SECTION("migrate") {
+        storage.migrate_page_size(16384);
+        REQUIRE(storage.pragma.page_size() == 16384);
+        REQUIRE(storage.pragma.journal_mode() == journal_mode::WAL);
+        REQUIRE(storage.get<Blob>(1).data.size() == 100000);
+        storage.migrate_page_size(16384);
+        REQUIRE(storage.pragma.page_size() == 16384);
+    }
+}
+
+TEST_CASE("exec options") {
+    struct Value {
+        int id = 0;
+    };
+    auto filename = "exec_options.sqlite";
+    ::remove(filename);
+    auto storage =
+        make_storage(filename, make_table("values_table", make_column("id", &Value::id, primary_key())));
+    storage.sync_schema();
+    storage.open_forever();
+    for(int i = 3; i > 0; --i) {
+        storage.replace(Value{i});
+    }
+    storage.pragma.cache_size(-2000);
+    storage.pragma.temp_store(1);
+
+    exec_options options;
+    options.temp_store_memory = true;
+    options.cache_size = -4096;
+    options.worker_threads = 2;
+    auto rows = storage.get_all<Value>(order_by(&Value::id), options);
+    REQUIRE(rows.size() == 3);
+    REQUIRE(rows.front().id == 1);
+    auto ids = storage.select(&Value::id, where(c(&Value::id) > 1), order_by(&Value::id).desc(), options);
+    REQUIRE(ids == std::vector<int>{3, 2});
+    REQUIRE(storage.pragma.cache_size() == -2000);
+    REQUIRE(storage.pragma.temp_store() == 1);
+
+    SECTION("inside a transaction") {
+        storage.transaction([&] {
+            REQUIRE(storage.get_all<Value>(options).size() == 3);
+            return true;
+        });
+        REQUIRE(storage.pragma.cache_size() == -2000);
+        REQUIRE(storage.pragma.temp_store() == 1);
+    }
+    ::remove(filename);
+}
@@ -0,0 +1,85 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Order {
+        int id = 0;
+        std::string customer;
+    };
+
+    struct LineItem {
+        int id = 0;
+        int orderId = 0;
+        std::string product;
+    };
+
+    struct Node {
+        int id = 0;
+        int parentId = 0;
+    };
+}
+
+TEST_CASE("prefetch") {
+    auto storage = make_storage({},
+                                make_table("orders",
+                                           make_column("id", &Order::id, primary_key()),
+                                           make_column("customer", &Order::customer)),
+                                make_table("line_items",
+                                           make_column("id", &LineItem::id, primary_key()),
+                                           make_column("order_id", &LineItem::orderId),
+                                           make_column("product", &LineItem::product),
+                                           foreign_key(&LineItem::orderId).references(&Order::id)),
+                                make_table("nodes",
+                                           make_column("id", &Node::id, primary_key()),
+                                           make_column("parent_id", &Node::parentId)));
+    storage.sync_schema();
+    storage.replace(Order{1, "alice"});
+    storage.replace(Order{2, "bob"});
+    storage.replace(Order{3, "carol"});
+    storage.replace(LineItem{1, 1, "tea"});
+    storage.replace(LineItem{2, 2, "coffee"});
+    storage.replace(LineItem{3, 1, "milk"});
+    storage.replace(LineItem{4, 2, "sugar"});
+
+    SECTION("by foreign key") {
+        auto orders = storage.get_all<Order>(order_by(&Order::id));
+        auto items = storage.prefetch<LineItem>(orders, &LineItem::orderId, order_by(&LineItem::id).desc());
+        REQUIRE(items.size() == 3);
+        REQUIRE(items[1].size() == 2);
+        REQUIRE(items[1][0].product == "milk");
+        REQUIRE(items[1][1].product == "tea");
+        REQUIRE(items[2].size() == 2);
+        REQUIRE(items[3].empty());
+    }
+    SECTION("some parents") {
+        auto orders = storage.get_all<Order>(where(c(&Order::id) != 1));
+        auto items = storage.prefetch<LineItem>(orders, &LineItem::orderId);
+        REQUIRE(items.size() == 2);
+        REQUIRE(items.count(1) == 0);
+        REQUIRE(items[2].size() == 2);
+    }
+    SECTION("no parents") {
+        std::vector<Order> orders;
+        auto items = storage.prefetch<LineItem>(orders, &LineItem::orderId);
+        REQUIRE(items.empty());
+    }
+    SECTION("not a foreign key") {
+        auto orders = storage.get_all<Order>();
+        REQUIRE_THROWS_AS(storage.prefetch<LineItem>(orders, &LineItem::id), std::system_error);
+    }
+    SECTION("by parent key") {
+        storage.replace(Node{1, 0});
+        storage.replace(Node{2, 1});
+        storage.replace(Node{3, 1});
+        storage.replace(Node{4, 2});
+        auto nodes = storage.get_all<Node>(where(c(&Node::id) <= 2));
+        auto children = storage.prefetch<Node>(nodes, &Node::id, &Node::parentId, order_by(&Node::id));
+        REQUIRE(children.size() == 2);
+        REQUIRE(children[1].size() == 2);
+        REQUIRE(children[1][1].id == 3);
+        REQUIRE(children[2].size() == 1);
+        REQUIRE(children[2][0].id == 4);
+    }
+}
@@ -0,0 +1,57 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <array>  //  std::array
+#include <utility>  //  std::pair
+
+#include "prepared_common.h"
+
+using namespace sqlite_orm;
+
+TEST_CASE("Prepared execute_batch") {
+    using namespace PreparedStatementTests;
+
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+
+    SECTION("insert") {
+        auto statement =
+            storage.prepare(insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(0, ""))));
+        std::vector<std::tuple<int, std::string>> users{{1, "Alice"}, {2, "Bob"}, {3, "Carol"}};
+        storage.execute_batch(statement, users);
+        REQUIRE(storage.count<User>() == 3);
+        REQUIRE(storage.get<User>(2).name == "Bob");
+
+        //  the arguments of the expression are bound again by the next execution
+        storage.execute(statement);
+        REQUIRE(storage.get<User>(0).name.empty());
+    }
+    SECTION("update_all and remove_all") {
+        storage.replace(User{1, "Alice"});
+        storage.replace(User{2, "Bob"});
+        storage.replace(User{3, "Carol"});
+
+        auto rename = storage.prepare(update_all(set(c(&User::name) = ""), where(c(&User::id) == 0)));
+        std::vector<std::pair<std::string, int>> renames{{"Alicia", 1}, {"Bobby", 2}};
+        storage.execute_batch(rename, renames);
+        REQUIRE(storage.get<User>(1).name == "Alicia");
+        REQUIRE(storage.get<User>(2).name == "Bobby");
+        REQUIRE(storage.get<User>(3).name == "Carol");
+
+        auto remove = storage.prepare(remove_all<User>(where(c(&User::id) == 0)));
+        storage.execute_batch(remove, std::vector<std::array<int, 1>>{{1}, {3}});
+        REQUIRE(storage.select(&User::id) == std::vector<int>{2});
+
+        REQUIRE_THROWS_WITH(storage.execute_batch(remove, std::vector<std::tuple<int, int>>{{1, 2}}),
+                            Catch::Matchers::ContainsSubstring("count"));
+    }
+    SECTION("the batch is one transaction") {
+        storage.replace(User{2, "Bob"});
+        auto statement =
+            storage.prepare(insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(0, ""))));
+        std::vector<std::tuple<int, std::string>> users{{1, "Alice"}, {2, "Bobby"}, {3, "Carol"}};
+        REQUIRE_THROWS_AS(storage.execute_batch(statement, users), std::system_error);
+        REQUIRE(storage.count<User>() == 1);
+    }
+}
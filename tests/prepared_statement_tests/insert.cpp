@@ -236,5 +236,15 @@ TEST_CASE("Prepared insert") {
                 }
             }
         }
+        SECTION("by move") {
+            user.name = "Stromae, with a name long enough not to fit in a small string";
+            const std::string name = user.name;
+            const char* nameData = user.name.data();
+            auto statement = storage.prepare(insert(std::move(user)));
+            REQUIRE(get<0>(statement).name.data() == nameData);
+            auto insertedId = storage.execute(statement);
+            REQUIRE(insertedId == 4);
+            REQUIRE(storage.get<User>(4).name == name);
+        }
     }
 }
@@ -108,6 +108,15 @@ TEST_CASE("Prepared insert range") {
             std::ignore = get<0>(static_cast<const decltype(statement)&>(statement));
             std::ignore = get<1>(static_cast<const decltype(statement)&>(statement));
         }
+        SECTION("projected temporaries") {
+            std::vector<std::string> names{user1.name, user2.name};
+            auto statement = storage.prepare(insert_range(names.begin(), names.end(), [](const std::string& name) {
+                return User{0, name};
+            }));
+            storage.execute(statement);
+            expected.push_back(user1);
+            expected.push_back(user2);
+        }
         SECTION("container of pointers") {
             std::vector<std::unique_ptr<User>> usersPointers;
             std::transform(users.begin(), users.end(), std::back_inserter(usersPointers), [](const User& user) {
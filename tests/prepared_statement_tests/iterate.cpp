@@ -0,0 +1,70 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+#include "prepared_common.h"
+
+using namespace sqlite_orm;
+
+TEST_CASE("Prepared iterate") {
+    using namespace PreparedStatementTests;
+
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.replace(User{3, "Carol"});
+
+    auto statement = storage.prepare(iterate<User>(where(c(&User::id) > 1), order_by(&User::id)));
+    REQUIRE(storage.execute(statement) == std::vector<User>{{2, "Bob"}, {3, "Carol"}});
+
+    auto view = storage.iterate(statement);
+    std::vector<User> users;
+    for(auto& user: view) {
+        users.push_back(user);
+    }
+    REQUIRE(users == std::vector<User>{{2, "Bob"}, {3, "Carol"}});
+    REQUIRE(view.size() == 2);
+    REQUIRE_FALSE(view.empty());
+
+    SECTION("the iteration starts over with the same statement") {
+        auto stmt = statement.stmt;
+        users.clear();
+        for(auto& user: storage.iterate(statement)) {
+            users.push_back(user);
+        }
+        REQUIRE(users.size() == 2);
+        REQUIRE(statement.stmt == stmt);
+    }
+    SECTION("changed arguments") {
+        get<0>(statement) = 2;
+        users.clear();
+        for(auto& user: view) {
+            users.push_back(user);
+        }
+        REQUIRE(users == std::vector<User>{{3, "Carol"}});
+        get<0>(statement) = 3;
+        REQUIRE(view.empty());
+        REQUIRE(view.size() == 0);
+        REQUIRE(view.begin() == view.end());
+    }
+    SECTION("an iteration stopped early leaves the statement reset") {
+        {
+            auto it = view.begin();
+            REQUIRE(it->id == 2);
+        }
+        REQUIRE_FALSE(sqlite3_stmt_busy(statement.stmt));
+        storage.remove_all<User>();
+        REQUIRE(view.empty());
+    }
+    SECTION("get_all") {
+        auto getAll = storage.prepare(get_all<User>(where(c(&User::name) == "Alice")));
+        size_t count = 0;
+        for(auto& user: storage.iterate(getAll)) {
+            REQUIRE(user.name == "Alice");
+            ++count;
+        }
+        REQUIRE(count == 1);
+    }
+}
@@ -0,0 +1,55 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+#include "prepared_common.h"
+
+using namespace sqlite_orm;
+
+TEST_CASE("Prepared pipeline") {
+    using namespace PreparedStatementTests;
+
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)),
+        make_table("visits",
+                   make_column("id", &Visit::id, primary_key()),
+                   make_column("user_id", &Visit::userId),
+                   make_column("time", &Visit::time)));
+    storage.sync_schema();
+
+    User user{0, "Alice"};
+    Visit visit{0, 1, 100};
+    auto insertUser = storage.prepare(insert(std::ref(user)));
+    auto insertVisit = storage.prepare(insert(std::ref(visit)));
+    auto rename = storage.prepare(update_all(set(c(&User::name) = "Alicia"), where(c(&User::id) == 1)));
+    auto countVisits = storage.prepare(select(count<Visit>()));
+
+    auto pipeline = storage.pipeline(insertUser, insertVisit, rename, countVisits);
+    static_assert(std::is_same<decltype(pipeline.execute()),
+                               std::tuple<int64, int64, internal::no_result, std::vector<int>>>::value,
+                  "");
+    auto results = pipeline.execute();
+    REQUIRE(std::get<0>(results) == 1);
+    REQUIRE(std::get<1>(results) == 1);
+    REQUIRE(std::get<3>(results) == std::vector<int>{1});
+    REQUIRE(storage.get<User>(1).name == "Alicia");
+
+    SECTION("executing again uses the current arguments") {
+        user.name = "Bob";
+        visit.userId = 2;
+        get<1>(rename) = 2;
+        results = pipeline.execute();
+        REQUIRE(std::get<0>(results) == 2);
+        REQUIRE(std::get<3>(results) == std::vector<int>{2});
+        REQUIRE(storage.get<User>(2).name == "Alicia");
+    }
+    SECTION("transaction") {
+        auto insertDuplicate = storage.prepare(insert(into<User>(), columns(&User::id), values(std::make_tuple(1))));
+        auto failing = storage.pipeline(insertVisit, insertDuplicate);
+        REQUIRE_THROWS_AS(failing.transaction().execute(), std::system_error);
+        REQUIRE(storage.count<Visit>() == 1);
+
+        REQUIRE_THROWS_AS(storage.pipeline(insertVisit, insertDuplicate).execute(), std::system_error);
+        REQUIRE(storage.count<Visit>() == 2);
+    }
+}
@@ -120,6 +120,32 @@ TEST_CASE("Prepared select") {
             REQUIRE(rows2 == decltype(rows2){std::make_tuple("Rock", -15)});
         }
     }
+    SECTION("unchanged arguments keep their binding") {
+        std::string name = "Rock";
+        auto statement = storage.prepare(select(columns(std::string("ototo"), 25, std::ref(name))));
+        auto rows = storage.execute(statement);
+        REQUIRE(rows == decltype(rows){std::make_tuple("ototo", 25, "Rock")});
+
+        //  bound behind the back of the statement, so only a rebinding would restore them
+        sqlite3_reset(statement.stmt);
+        REQUIRE(sqlite3_bind_text(statement.stmt, 1, "moved", -1, SQLITE_TRANSIENT) == SQLITE_OK);
+        REQUIRE(sqlite3_bind_int(statement.stmt, 2, 99) == SQLITE_OK);
+        REQUIRE(sqlite3_bind_text(statement.stmt, 3, "Paper", -1, SQLITE_TRANSIENT) == SQLITE_OK);
+        auto rows2 = storage.execute(statement);
+        REQUIRE(rows2 == decltype(rows2){std::make_tuple("moved", 99, "Rock")});
+
+        get<1>(statement) = -15;
+        name = "Scissors";
+        auto rows3 = storage.execute(statement);
+        REQUIRE(rows3 == decltype(rows3){std::make_tuple("moved", -15, "Scissors")});
+        //  values are compared with the ones the statement bound, not with bindings made behind its back
+        get<0>(statement) = "ototo";
+        auto rows4 = storage.execute(statement);
+        REQUIRE(rows4 == decltype(rows4){std::make_tuple("moved", -15, "Scissors")});
+        get<0>(statement) = "Lizard";
+        auto rows5 = storage.execute(statement);
+        REQUIRE(rows5 == decltype(rows5){std::make_tuple("Lizard", -15, "Scissors")});
+    }
     SECTION("three columns, aggregate func and where") {
         SECTION("by val") {
             auto statement =
@@ -342,3 +368,82 @@ TEST_CASE("dumping") {
     }
     REQUIRE(value == expected);
 }
+
+TEST_CASE("prepare flags") {
+    auto storage = make_storage({}, make_generate_series_table());
+    SECTION("once") {
+        auto statement = storage.prepare(select(1), prepare_flags::none);
+        REQUIRE(storage.execute(statement) == std::vector<int>{1});
+    }
+    SECTION("persistent") {
+        auto statement = storage.prepare(select(1), prepare_flags::persistent | prepare_flags::no_vtab);
+        REQUIRE(storage.execute(statement) == std::vector<int>{1});
+    }
+#if SQLITE_VERSION_NUMBER >= 3028000
+    SECTION("no virtual tables") {
+        auto expression = select(&generate_series::value,
+                                 where(c(&generate_series::start) == 1 and c(&generate_series::stop) == 2));
+        REQUIRE(storage.execute(storage.prepare(expression)).size() == 2);
+        REQUIRE_THROWS_AS(storage.prepare(expression, prepare_flags::no_vtab), std::system_error);
+    }
+#endif
+}
+
+TEST_CASE("binding plan") {
+    struct Item {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        {},
+        make_table("items", make_column("id", &Item::id, primary_key()), make_column("name", &Item::name)));
+    storage.sync_schema();
+    storage.replace(Item{1, "a"});
+    storage.replace(Item{2, "b"});
+    storage.replace(Item{3, "c"});
+    SECTION("values") {
+        auto statement = storage.prepare(select(
+            &Item::id,
+            where((c(&Item::id) > 0 and c(&Item::id) < 10) and (c(&Item::name) != "x" or c(&Item::id) == 0)),
+            order_by(&Item::id)));
+        REQUIRE(storage.execute(statement) == std::vector<int>{1, 2, 3});
+        REQUIRE_FALSE(statement.bindingPlan.made);
+
+        get<1>(statement) = 3;
+        REQUIRE(storage.execute(statement) == std::vector<int>{1, 2});
+        REQUIRE(statement.bindingPlan.usable);
+        REQUIRE(statement.bindingPlan.steps.size() == 4);
+        get<2>(statement) = "a";
+        REQUIRE(storage.execute(statement) == std::vector<int>{2});
+
+        auto moved = std::move(statement);
+        REQUIRE(storage.execute(moved) == std::vector<int>{2});
+        get<1>(moved) = 10;
+        REQUIRE(storage.execute(moved) == std::vector<int>{2, 3});
+    }
+    SECTION("changed through a kept reference") {
+        auto statement = storage.prepare(get<Item>(1));
+        auto& id = get<0>(statement);
+        for(int i = 1; i <= 3; ++i) {
+            id = i;
+            REQUIRE(storage.execute(statement).id == i);
+        }
+        auto names = storage.prepare(select(&Item::id, where(c(&Item::name) == "a")));
+        auto& name = get<0>(names);
+        REQUIRE(storage.execute(names) == std::vector<int>{1});
+        name = "b";
+        REQUIRE(storage.execute(names) == std::vector<int>{2});
+        name = "c";
+        REQUIRE(storage.execute(names) == std::vector<int>{3});
+    }
+    SECTION("references") {
+        int upper = 3;
+        auto statement =
+            storage.prepare(select(&Item::id, where(c(&Item::id) < std::ref(upper)), order_by(&Item::id)));
+        REQUIRE(storage.execute(statement) == std::vector<int>{1, 2});
+        upper = 4;
+        REQUIRE(storage.execute(statement) == std::vector<int>{1, 2, 3});
+        REQUIRE(statement.bindingPlan.made);
+        REQUIRE_FALSE(statement.bindingPlan.usable);
+    }
+}
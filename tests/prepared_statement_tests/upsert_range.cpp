@@ -0,0 +1,98 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+#if SQLITE_VERSION_NUMBER >= 3024000
+TEST_CASE("upsert range") {
+    struct Product {
+        int id = 0;
+        std::string name;
+        int quantity = 0;
+    };
+    struct Deletion {
+        int productId = 0;
+    };
+    auto storage = make_storage(
+        {},
+        make_trigger("product_deleted",
+                     after().delete_().on<Product>().begin(insert(into<Deletion>(),
+                                                                  columns(&Deletion::productId),
+                                                                  values(std::make_tuple(old(&Product::id)))))
+                         .end()),
+        make_table("products",
+                   make_column("id", &Product::id, primary_key()),
+                   make_column("name", &Product::name),
+                   make_column("quantity", &Product::quantity)),
+        make_table("deletions", make_column("product_id", &Deletion::productId)));
+    storage.sync_schema();
+    storage.replace(Product{1, "tea", 5});
+    storage.replace(Product{2, "coffee", 3});
+
+    std::vector<Product> products{{2, "ground coffee", 4}, {3, "milk", 1}};
+    auto addQuantity =
+        on_conflict(&Product::id)
+            .do_update(set(c(&Product::name) = excluded(&Product::name),
+                           c(&Product::quantity) = c(&Product::quantity) + excluded(&Product::quantity)));
+    auto expectMerged = [&storage] {
+        auto rows = storage.select(columns(&Product::id, &Product::name, &Product::quantity), order_by(&Product::id));
+        decltype(rows) expected{{1, "tea", 5}, {2, "ground coffee", 7}, {3, "milk", 1}};
+        REQUIRE(rows == expected);
+        REQUIRE(storage.count<Deletion>() == 0);
+    };
+    SECTION("storage") {
+        storage.upsert_range(products.begin(), products.end(), addQuantity);
+        expectMerged();
+    }
+    SECTION("prepared") {
+        auto statement = storage.prepare(upsert_range(products.begin(), products.end(), addQuantity));
+        REQUIRE(statement.sql() == R"(INSERT INTO "products" ("id", "name", "quantity") VALUES (?, ?, ?), (?, ?, ?) )"
+                                   R"(ON CONFLICT ("products"."id") DO UPDATE SET "name" = excluded."name", )"
+                                   R"("quantity" = "products"."quantity" + excluded."quantity")");
+        storage.execute(statement);
+        expectMerged();
+    }
+    SECTION("pointers") {
+        std::vector<std::unique_ptr<Product>> pointers;
+        for(auto& product: products) {
+            pointers.push_back(std::make_unique<Product>(product));
+        }
+        storage.upsert_range<Product>(pointers.begin(),
+                                      pointers.end(),
+                                      addQuantity,
+                                      &std::unique_ptr<Product>::operator*);
+        expectMerged();
+    }
+    SECTION("bound values in the clause") {
+        storage.upsert_range(products.begin(),
+                             products.end(),
+                             on_conflict(&Product::id).do_update(set(c(&Product::quantity) = 100)));
+        REQUIRE(storage.get<Product>(2).quantity == 100);
+        REQUIRE(storage.get<Product>(2).name == "coffee");
+        REQUIRE(storage.get<Product>(3).quantity == 1);
+    }
+    SECTION("do nothing") {
+        storage.upsert_range(products.begin(), products.end(), on_conflict(&Product::id).do_nothing());
+        REQUIRE(storage.get<Product>(2).name == "coffee");
+        REQUIRE(storage.count<Product>() == 3);
+    }
+    SECTION("chunks") {
+        storage.limit.variable_number(7);
+        std::vector<Product> many;
+        for(int id = 1; id <= 10; ++id) {
+            many.push_back({id, "product", id});
+        }
+        storage.upsert_range(many.begin(),
+                             many.end(),
+                             on_conflict(&Product::id).do_update(set(c(&Product::name) = "updated")));
+        REQUIRE(storage.count<Product>() == 10);
+        REQUIRE(storage.count<Product>(where(c(&Product::name) == "updated")) == 2);
+        REQUIRE(storage.get<Product>(10).quantity == 10);
+    }
+    SECTION("empty") {
+        products.clear();
+        storage.upsert_range(products.begin(), products.end(), addQuantity);
+        REQUIRE(storage.count<Product>() == 2);
+    }
+}
+#endif
@@ -0,0 +1,82 @@
+/**
+ *  Built as a separate executable: `SQLITE_ENABLE_PREUPDATE_HOOK` changes how changes are captured,
+ *  so it must not be mixed with the translation units of `unit_tests`.
+ */
+#define SQLITE_ENABLE_PREUPDATE_HOOK
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <cstdio>  //  remove
+#include <memory>  //  std::unique_ptr
+#include <vector>  //  std::vector
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+}
+
+TEST_CASE("on_change with preupdate hook") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+
+    std::vector<change_event<User>> events;
+    storage.on_change<User>([&events](const change_event<User>& event) {
+        events.push_back(event);
+    });
+    storage.replace(User{1, "Alice"});
+    storage.update(User{1, "Alicia"});
+    storage.remove<User>(1);
+
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[0].operation == change_operation::insert);
+    REQUIRE_FALSE(events[0].old_object);
+    REQUIRE(events[0].new_object->name == "Alice");
+    REQUIRE(events[1].operation == change_operation::update);
+    REQUIRE(events[1].old_object->name == "Alice");
+    REQUIRE(events[1].new_object->name == "Alicia");
+    REQUIRE(events[2].operation == change_operation::remove);
+    REQUIRE(events[2].old_object->id == 1);
+    REQUIRE(events[2].old_object->name == "Alicia");
+    REQUIRE_FALSE(events[2].new_object);
+}
+
+TEST_CASE("audit log with preupdate hook") {
+    struct AuditValues {
+        int id = 0;
+        std::string operation;
+        std::unique_ptr<std::string> oldValues;
+        std::unique_ptr<std::string> newValues;
+    };
+    ::remove("preupdate_audited.sqlite");
+    auto storage = make_storage(
+        "preupdate_audited.sqlite",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.enable_audit_log();
+    storage.replace(User{1, "Alice"});
+    storage.update(User{1, "Ali\"ce"});
+    storage.remove<User>(1);
+    REQUIRE(storage.flush_audit_log() == 3);
+    storage.disable_audit_log();
+
+    auto audit = make_storage("preupdate_audited.sqlite",
+                              make_table("audit_log",
+                                         make_column("id", &AuditValues::id, primary_key()),
+                                         make_column("operation", &AuditValues::operation),
+                                         make_column("old_values", &AuditValues::oldValues),
+                                         make_column("new_values", &AuditValues::newValues)));
+    auto rows = audit.get_all<AuditValues>(order_by(&AuditValues::id));
+    REQUIRE(rows.size() == 3);
+    REQUIRE_FALSE(rows[0].oldValues);
+    REQUIRE(*rows[0].newValues == R"([1,"Alice"])");
+    REQUIRE(*rows[1].oldValues == R"([1,"Alice"])");
+    REQUIRE(*rows[1].newValues == R"([1,"Ali\"ce"])");
+    REQUIRE(rows[2].operation == "DELETE");
+    REQUIRE(*rows[2].oldValues == R"([1,"Ali\"ce"])");
+    REQUIRE_FALSE(rows[2].newValues);
+}
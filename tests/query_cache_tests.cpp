@@ -0,0 +1,115 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <thread>  //  std::this_thread::sleep_for
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+
+    struct Visit {
+        int id = 0;
+        int userId = 0;
+    };
+
+    struct KeyValue {
+        std::string key;
+        std::string value;
+    };
+}
+
+TEST_CASE("query cache") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)),
+        make_table("visits", make_column("id", &Visit::id, primary_key()), make_column("user_id", &Visit::userId)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.insert(Visit{0, 1});
+    storage.enable_query_cache();
+
+    SECTION("hits") {
+        REQUIRE(storage.count<User>(cached()) == 2);
+        REQUIRE(storage.count<User>(cached()) == 2);
+        REQUIRE(storage.count<User>() == 2);
+        auto stats = storage.query_cache_stats();
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.size == 1);
+    }
+    SECTION("bound values") {
+        REQUIRE(storage.select(&User::name, where(c(&User::id) == 1), cached()) == std::vector<std::string>{"Alice"});
+        REQUIRE(storage.select(&User::name, where(c(&User::id) == 2), cached()) == std::vector<std::string>{"Bob"});
+        REQUIRE(storage.query_cache_stats().size == 2);
+    }
+    SECTION("invalidation") {
+        REQUIRE(storage.count<User>(cached()) == 2);
+        storage.replace(User{3, "Carol"});
+        REQUIRE(storage.count<User>(cached()) == 3);
+        storage.remove_all<User>();
+        REQUIRE(storage.count<User>(cached()) == 0);
+        REQUIRE(storage.query_cache_stats().hits == 0);
+    }
+    SECTION("group by and join") {
+        auto visitsByName = [&storage] {
+            return storage.select(columns(&User::name, count(&Visit::id)),
+                                  inner_join<Visit>(on(c(&Visit::userId) == &User::id)),
+                                  group_by(&User::name),
+                                  cached());
+        };
+        REQUIRE(visitsByName().size() == 1);
+        REQUIRE(visitsByName().size() == 1);
+        REQUIRE(storage.query_cache_stats().hits == 1);
+        storage.insert(Visit{0, 2});
+        REQUIRE(visitsByName().size() == 2);
+    }
+    SECTION("ttl") {
+        REQUIRE(storage.count<User>(cached(std::chrono::milliseconds{1})) == 2);
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        REQUIRE(storage.count<User>(cached(std::chrono::milliseconds{1})) == 2);
+        REQUIRE(storage.query_cache_stats().hits == 0);
+    }
+    SECTION("transaction") {
+        storage.begin_transaction();
+        storage.replace(User{3, "Carol"});
+        REQUIRE(storage.count<User>(cached()) == 3);
+        //  not committed yet
+        REQUIRE(storage.query_cache_stats().size == 0);
+        storage.rollback();
+        REQUIRE(storage.count<User>(cached()) == 2);
+        REQUIRE(storage.query_cache_stats().size == 1);
+    }
+    SECTION("max entries") {
+        storage.enable_query_cache(query_cache_options{1, std::chrono::milliseconds{0}});
+        REQUIRE(storage.count<User>(cached()) == 2);
+        REQUIRE(storage.count<Visit>(cached()) == 1);
+        REQUIRE(storage.query_cache_stats().size == 1);
+    }
+    SECTION("disabled") {
+        storage.disable_query_cache();
+        REQUIRE(storage.count<User>(cached()) == 2);
+        REQUIRE(storage.query_cache_stats().size == 0);
+    }
+}
+
+TEST_CASE("query cache with a WITHOUT ROWID table") {
+    auto storage = make_storage({},
+                                make_table("key_values",
+                                           make_column("key", &KeyValue::key, primary_key()),
+                                           make_column("value", &KeyValue::value))
+                                    .without_rowid());
+    storage.sync_schema();
+    storage.replace(KeyValue{"a", "1"});
+    storage.enable_query_cache();
+
+    REQUIRE(storage.select(&KeyValue::value, where(c(&KeyValue::key) == "a"), cached()) ==
+            std::vector<std::string>{"1"});
+    storage.replace(KeyValue{"a", "2"});
+    REQUIRE(storage.select(&KeyValue::value, where(c(&KeyValue::key) == "a"), cached()) ==
+            std::vector<std::string>{"2"});
+    REQUIRE(storage.query_cache_stats().size == 0);
+}
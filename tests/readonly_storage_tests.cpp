@@ -0,0 +1,60 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Product {
+        int id = 0;
+        std::string name;
+        int category = 0;
+    };
+
+    auto make_products_table() {
+        return make_table("products",
+                          make_column("id", &Product::id, primary_key()),
+                          make_column("name", &Product::name),
+                          make_column("category", &Product::category));
+    }
+}
+
+TEST_CASE("readonly storage") {
+    auto filename = "readonly_catalogue.sqlite";
+    ::remove(filename);
+    {
+        auto storage = make_storage(filename, make_products_table());
+        storage.sync_schema();
+        for(int id = 1; id <= 100; ++id) {
+            storage.replace(Product{id, "product" + std::to_string(id), id % 5});
+        }
+    }
+    auto catalogue = make_readonly_storage(pool_options{3}, filename, make_products_table());
+    STATIC_REQUIRE_FALSE(internal::is_preparable_v<decltype(catalogue), decltype(insert(Product{}))>);
+    STATIC_REQUIRE(internal::is_preparable_v<decltype(catalogue), decltype(get_all<Product>())>);
+
+    REQUIRE(catalogue.count<Product>() == 100);
+    REQUIRE(catalogue.get<Product>(7).name == "product7");
+    REQUIRE(catalogue.get_pointer<Product>(1000) == nullptr);
+    REQUIRE(catalogue.select(&Product::id, where(c(&Product::category) == 0), order_by(&Product::id)).size() == 20);
+    REQUIRE(catalogue.pragma.query_only());
+    REQUIRE(catalogue.pragma.mmap_size() > 0);
+
+    auto statement = catalogue.prepare(select(max(&Product::id)));
+    REQUIRE(*catalogue.execute(statement).at(0) == 100);
+
+    std::vector<std::thread> readers;
+    std::atomic<int> found{0};
+    for(int i = 0; i < 8; ++i) {
+        readers.emplace_back([&catalogue, &found, i] {
+            for(int id = 1; id <= 100; ++id) {
+                if(catalogue.get<Product>(id).category == i % 5) {
+                    ++found;
+                }
+            }
+        });
+    }
+    for(auto& reader: readers) {
+        reader.join();
+    }
+    REQUIRE(found == 160);
+}
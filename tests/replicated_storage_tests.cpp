@@ -0,0 +1,102 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Order {
+        int id = 0;
+        int userId = 0;
+    };
+
+    auto make_orders_storage(std::string filename) {
+        return make_storage(std::move(filename),
+                            make_table("orders",
+                                       make_column("id", &Order::id, primary_key()),
+                                       make_column("user_id", &Order::userId)));
+    }
+
+    std::string replica_filename(size_t generation) {
+        return "replica." + std::to_string(generation) + ".sqlite";
+    }
+
+    bool file_exists(const std::string& filename) {
+        std::unique_ptr<FILE, int (*)(FILE*)> file{fopen(filename.c_str(), "rb"), fclose};
+        return file != nullptr;
+    }
+}
+
+TEST_CASE("replicated storage") {
+    auto filename = "replicated_primary.sqlite";
+    ::remove(filename);
+    for(size_t generation = 1; generation <= 3; ++generation) {
+        ::remove(replica_filename(generation).c_str());
+    }
+    auto primary = make_orders_storage(filename);
+    primary.sync_schema();
+    auto replicated = make_replicated_storage(primary, [](size_t generation) {
+        return make_orders_storage(replica_filename(generation));
+    });
+
+    replicated.insert(Order{0, 1});
+    REQUIRE(replicated.generation() == 0);
+    REQUIRE(replicated.staleness() == std::chrono::milliseconds::max());
+    //  without a replica the primary serves the reads
+    REQUIRE(replicated.count<Order>() == 1);
+
+    REQUIRE(replicated.refresh());
+    REQUIRE(replicated.generation() == 1);
+    REQUIRE(file_exists(replica_filename(1)));
+    replicated.insert(Order{0, 2});
+    REQUIRE(replicated.count<Order>() == 1);
+    REQUIRE(replicated.get_all<Order>(where(c(&Order::userId) == 2)).empty());
+    REQUIRE(replicated.primary().count<Order>() == 2);
+    auto fresh = replicated.read(
+        [](auto& storage) {
+            return storage.template count<Order>();
+        },
+        std::chrono::milliseconds{-1});
+    REQUIRE(fresh == 2);
+
+    SECTION("refresh swaps the replica") {
+        auto old = replicated.read([&replicated](auto& storage) {
+            //  the replica being read stays until the read finishes
+            replicated.refresh();
+            return storage.template count<Order>();
+        });
+        REQUIRE(old == 1);
+        REQUIRE(replicated.generation() == 2);
+        REQUIRE_FALSE(file_exists(replica_filename(1)));
+        REQUIRE(replicated.count<Order>() == 2);
+        REQUIRE(replicated.get<Order>(2).userId == 2);
+        REQUIRE(replicated.select(&Order::userId, order_by(&Order::id)) == std::vector<int>{1, 2});
+    }
+    SECTION("staleness bound") {
+        replica_options options;
+        options.max_staleness = std::chrono::milliseconds{0};
+        auto bounded = make_replicated_storage(
+            primary,
+            [](size_t generation) {
+                return make_orders_storage(replica_filename(generation + 1));
+            },
+            options);
+        REQUIRE(bounded.refresh());
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        bounded.insert(Order{0, 3});
+        REQUIRE(bounded.count<Order>() == 3);
+    }
+    SECTION("periodic refresh") {
+        replica_options options;
+        options.refresh_interval = std::chrono::milliseconds{10};
+        auto periodic = make_replicated_storage(
+            primary,
+            [](size_t) {
+                return make_orders_storage(":memory:");
+            },
+            options);
+        while(periodic.generation() < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        REQUIRE(periodic.count<Order>() == 2);
+    }
+}
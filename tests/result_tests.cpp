@@ -0,0 +1,88 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+}
+
+TEST_CASE("result") {
+    result<int> value{5};
+    REQUIRE(value.has_value());
+    REQUIRE(bool(value));
+    REQUIRE(value.value() == 5);
+    REQUIRE(*value == 5);
+    REQUIRE_FALSE(value.error());
+
+    result<int> failure{std::error_code{orm_error_code::not_found}};
+    REQUIRE_FALSE(failure.has_value());
+    REQUIRE(failure.error() == orm_error_code::not_found);
+    REQUIRE_THROWS_AS(failure.value(), std::system_error);
+
+    REQUIRE(result<void>{}.has_value());
+    REQUIRE_NOTHROW(result<void>{}.value());
+    REQUIRE_THROWS_AS(result<void>{std::error_code{sqlite_errc(SQLITE_BUSY)}}.value(), std::system_error);
+}
+
+TEST_CASE("try functions") {
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name, unique())));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    const std::error_code constraintError{sqlite_errc(SQLITE_CONSTRAINT)};
+
+    SECTION("try_get") {
+        auto found = storage.try_get<User>(1);
+        REQUIRE(found);
+        REQUIRE(found->name == "Alice");
+
+        auto missing = storage.try_get<User>(2);
+        REQUIRE_FALSE(missing);
+        REQUIRE(missing.error() == orm_error_code::not_found);
+    }
+    SECTION("try_get with the object cache") {
+        storage.enable_object_cache<User>();
+        REQUIRE(storage.try_get<User>(2).error() == orm_error_code::not_found);
+        REQUIRE(storage.try_get<User>(1)->name == "Alice");
+        REQUIRE(storage.try_get<User>(1)->name == "Alice");
+        REQUIRE(storage.try_update(User{1, "Alicia"}));
+        REQUIRE(storage.try_get<User>(1)->name == "Alicia");
+    }
+    SECTION("try_insert") {
+        auto id = storage.try_insert(User{0, "Bob"});
+        REQUIRE(id);
+        REQUIRE(*id == 2);
+
+        auto duplicate = storage.try_insert(User{0, "Bob"});
+        REQUIRE_FALSE(duplicate);
+        REQUIRE(duplicate.error() == constraintError);
+        REQUIRE(storage.count<User>() == 2);
+    }
+    SECTION("try_replace, try_update and try_remove") {
+        REQUIRE(storage.try_replace(User{2, "Bob"}));
+        REQUIRE(storage.try_update(User{2, "Alice"}).error() == constraintError);
+        REQUIRE(storage.get<User>(2).name == "Bob");
+        REQUIRE(storage.try_remove<User>(2));
+        REQUIRE(storage.count<User>() == 1);
+    }
+    SECTION("try_execute") {
+        auto statement = storage.prepare(update_all(set(c(&User::name) = "Alice"), where(c(&User::id) == 2)));
+        storage.replace(User{2, "Bob"});
+        REQUIRE(storage.try_execute(statement).error() == constraintError);
+
+        auto getStatement = storage.prepare(get_pointer<User>(2));
+        auto user = storage.try_execute(getStatement);
+        REQUIRE(user);
+        REQUIRE((*user)->name == "Bob");
+
+        //  the statement isn't in an error state after the failed step
+        get<0>(statement) = "Carol";
+        REQUIRE(storage.try_execute(statement));
+        REQUIRE(storage.get<User>(2).name == "Carol");
+    }
+}
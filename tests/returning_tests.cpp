@@ -0,0 +1,90 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+#if SQLITE_VERSION_NUMBER >= 3035000
+namespace {
+    struct Ticket {
+        int id = 0;
+        std::string title;
+        int priority = 0;
+        std::string status;
+
+        bool operator==(const Ticket& other) const {
+            return this->id == other.id && this->title == other.title && this->priority == other.priority &&
+                   this->status == other.status;
+        }
+    };
+}
+
+TEST_CASE("returning") {
+    auto storage = make_storage("",
+                                make_table("tickets",
+                                           make_column("id", &Ticket::id, primary_key()),
+                                           make_column("title", &Ticket::title),
+                                           make_column("priority", &Ticket::priority),
+                                           make_column("status", &Ticket::status, default_value("open"))));
+    storage.sync_schema();
+
+    SECTION("insert") {
+        Ticket ticket{0, "crash on start", 2, "new"};
+        auto ids = storage.returning(insert(ticket), &Ticket::id);
+        REQUIRE(ids == std::vector<int>{1});
+
+        auto statement = storage.prepare(returning(insert(ticket), columns(&Ticket::id, &Ticket::title)));
+        REQUIRE(statement.sql() ==
+                R"(INSERT INTO "tickets" ("title", "priority", "status") VALUES (?, ?, ?) RETURNING "tickets"."id", "tickets"."title")");
+        auto rows = storage.execute(statement);
+        REQUIRE(rows == std::vector<std::tuple<int, std::string>>{{2, "crash on start"}});
+    }
+    SECTION("insert explicit columns") {
+        auto rows = storage.returning(
+            insert(into<Ticket>(), columns(&Ticket::title, &Ticket::priority), values(std::make_tuple("slow sync", 1))),
+            columns(&Ticket::id, &Ticket::status));
+        REQUIRE(rows == std::vector<std::tuple<int, std::string>>{{1, "open"}});
+    }
+    SECTION("insert range") {
+        std::vector<Ticket> tickets;
+        for(int i = 0; i < 1000; ++i) {
+            tickets.push_back({0, "ticket " + std::to_string(i), i % 3, "new"});
+        }
+        //  3 values per ticket, so the tickets are inserted in chunks of 100
+        storage.limit.variable_number(300);
+        auto ids = storage.returning(insert_range(tickets.begin(), tickets.end()), &Ticket::id);
+        REQUIRE(ids.size() == tickets.size());
+        for(size_t i = 0; i < ids.size(); ++i) {
+            REQUIRE(ids[i] == int(i + 1));
+        }
+
+        auto objects = storage.returning(insert_range(tickets.begin(), tickets.begin() + 2), object<Ticket>());
+        REQUIRE(objects == std::vector<Ticket>{{1001, "ticket 0", 0, "new"}, {1002, "ticket 1", 1, "new"}});
+    }
+    SECTION("replace") {
+        storage.replace(Ticket{5, "old title", 1, "new"});
+        auto objects = storage.returning(replace(Ticket{5, "new title", 1, "new"}), object<Ticket>());
+        REQUIRE(objects == std::vector<Ticket>{{5, "new title", 1, "new"}});
+
+        std::vector<Ticket> tickets{{6, "a", 1, "new"}, {7, "b", 2, "new"}};
+        auto ids = storage.returning(replace_range(tickets.begin(), tickets.end()), &Ticket::id);
+        REQUIRE(ids == std::vector<int>{6, 7});
+    }
+    SECTION("update all") {
+        storage.replace(Ticket{1, "a", 1, "new"});
+        storage.replace(Ticket{2, "b", 2, "new"});
+        storage.replace(Ticket{3, "c", 3, "new"});
+        auto rows = storage.returning(update_all(set(c(&Ticket::status) = "closed"), where(c(&Ticket::priority) < 3)),
+                                      columns(&Ticket::id, c(&Ticket::priority) * 10));
+        std::sort(rows.begin(), rows.end());
+        REQUIRE(rows == std::vector<std::tuple<int, double>>{{1, 10}, {2, 20}});
+        REQUIRE(storage.count<Ticket>(where(c(&Ticket::status) == "closed")) == 2);
+    }
+    SECTION("remove all") {
+        storage.replace(Ticket{1, "a", 1, "new"});
+        storage.replace(Ticket{2, "b", 2, "new"});
+        auto titles = storage.returning(remove_all<Ticket>(where(c(&Ticket::id) == 2)), &Ticket::title);
+        REQUIRE(titles == std::vector<std::string>{"b"});
+        REQUIRE(storage.count<Ticket>() == 1);
+    }
+}
+#endif
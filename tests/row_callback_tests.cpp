@@ -0,0 +1,174 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <array>  //  std::array
+#include <utility>  //  std::pair
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        User() = default;
+        User(int id, std::string name) : id{id}, name{move(name)} {}
+#endif
+    };
+
+    bool operator==(const User& lhs, const User& rhs) {
+        return lhs.id == rhs.id && lhs.name == rhs.name;
+    }
+}
+
+TEST_CASE("row callbacks") {
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.replace(User{3, "Carol"});
+
+    SECTION("for_each") {
+        std::vector<User> users;
+        storage.for_each<User>(
+            [&users](const User& user) {
+                users.push_back(user);
+            },
+            where(c(&User::id) > 1),
+            order_by(&User::id));
+        REQUIRE(users == std::vector<User>{{2, "Bob"}, {3, "Carol"}});
+    }
+    SECTION("for_each stops early") {
+        std::vector<int> ids;
+        storage.for_each<User>([&ids](User user) {
+            ids.push_back(user.id);
+            return ids.size() < 2;
+        });
+        REQUIRE(ids.size() == 2);
+
+        //  the storage stays usable after stopping early
+        storage.remove<User>(1);
+        REQUIRE(storage.count<User>() == 2);
+    }
+    SECTION("select_each") {
+        std::vector<std::tuple<int, std::string>> rows;
+        storage.select_each(
+            columns(&User::id, &User::name),
+            [&rows](std::tuple<int, std::string> row) {
+                rows.push_back(move(row));
+            },
+            where(c(&User::id) != 2),
+            order_by(&User::id));
+        REQUIRE(rows == std::vector<std::tuple<int, std::string>>{{1, "Alice"}, {3, "Carol"}});
+    }
+    SECTION("select_each stops early") {
+        int visited = 0;
+        storage.select_each(&User::id, [&visited](int) {
+            ++visited;
+            return false;
+        });
+        REQUIRE(visited == 1);
+    }
+}
+
+TEST_CASE("select_columnar") {
+    struct Trade {
+        int id = 0;
+        double price = 0;
+        std::unique_ptr<int> volume;
+    };
+    auto storage = make_storage("",
+                                make_table("trades",
+                                           make_column("id", &Trade::id, primary_key()),
+                                           make_column("price", &Trade::price),
+                                           make_column("volume", &Trade::volume)));
+    storage.sync_schema();
+    storage.insert(into<Trade>(), columns(&Trade::id, &Trade::price), values(std::make_tuple(1, 1.5)));
+    storage.insert(into<Trade>(),
+                   columns(&Trade::id, &Trade::price, &Trade::volume),
+                   values(std::make_tuple(2, 2.5, 20), std::make_tuple(3, 3.5, 30)));
+
+    auto result = storage.select_columnar(columns(&Trade::id, &Trade::price, &Trade::volume, max(&Trade::volume)),
+                                          group_by(&Trade::id),
+                                          order_by(&Trade::id));
+    auto& ids = std::get<0>(result);
+    auto& prices = std::get<1>(result);
+    auto& volumes = std::get<2>(result);
+    REQUIRE(ids.size() == 3);
+    REQUIRE(ids.values == std::vector<int>{1, 2, 3});
+    REQUIRE_FALSE(ids.nullable);
+    REQUIRE(ids.nulls.empty());
+    REQUIRE(prices.values == std::vector<double>{1.5, 2.5, 3.5});
+    REQUIRE(volumes.nullable);
+    REQUIRE(volumes.values == std::vector<int>{0, 20, 30});
+    REQUIRE(volumes.nulls == std::vector<bool>{true, false, false});
+    REQUIRE(volumes.is_null(0));
+    REQUIRE_FALSE(volumes.is_null(1));
+    REQUIRE(std::get<3>(result).is_null(0));
+    REQUIRE(std::get<3>(result).values[2] == 30);
+
+    auto empty = storage.select_columnar(columns(&Trade::price), where(c(&Trade::id) > 3));
+    REQUIRE(std::get<0>(empty).values.empty());
+}
+
+TEST_CASE("select_into") {
+    struct Sample {
+        int64 ts = 0;
+        double value = 0;
+    };
+    auto storage = make_storage("",
+                                make_table("samples",
+                                           make_column("ts", &Sample::ts, primary_key()),
+                                           make_column("value", &Sample::value)));
+    storage.sync_schema();
+    std::vector<Sample> samples;
+    for(int64 ts = 1; ts <= 5; ++ts) {
+        samples.push_back(Sample{ts, double(ts) / 2});
+    }
+    storage.replace_range(samples.begin(), samples.end());
+
+    SECTION("prepared statement continues") {
+        auto statement = storage.prepare(
+            select(columns(&Sample::ts, &Sample::value), where(c(&Sample::ts) > 1), order_by(&Sample::ts)));
+        std::array<std::pair<int64, double>, 3> buffer{};
+        REQUIRE(storage.select_into(statement, buffer.data(), buffer.size()) == 3);
+        REQUIRE(buffer[0] == std::make_pair(int64(2), 1.0));
+        REQUIRE(buffer[2] == std::make_pair(int64(4), 2.0));
+        REQUIRE(storage.select_into(statement, buffer.data(), buffer.size()) == 1);
+        REQUIRE(buffer[0] == std::make_pair(int64(5), 2.5));
+
+        //  the next call starts over, with the current bound values
+        get<0>(statement) = 3;
+        REQUIRE(storage.select_into(statement, buffer.data(), buffer.size()) == 2);
+        REQUIRE(buffer[0].first == 4);
+    }
+    SECTION("exact fill") {
+        auto statement = storage.prepare(select(&Sample::value, order_by(&Sample::ts)));
+        double values[5];
+        REQUIRE(storage.select_into(statement, values, 5) == 5);
+        REQUIRE(values[4] == 2.5);
+        REQUIRE(storage.select_into(statement, values, 5) == 0);
+        REQUIRE(storage.select_into(statement, values, 5) == 5);
+    }
+    SECTION("tuple and array rows") {
+        std::tuple<int, double> tuples[2];
+        REQUIRE(storage.select_into(columns(&Sample::ts, &Sample::value), tuples, 2, order_by(&Sample::ts)) == 2);
+        REQUIRE(tuples[1] == std::make_tuple(2, 1.0));
+
+        std::array<double, 2> arrays[8];
+        REQUIRE(storage.select_into(columns(&Sample::value, &Sample::ts), arrays, 8) == 5);
+        //  the statement was reset, so it starts over
+        REQUIRE(storage.select_into(columns(&Sample::value, &Sample::ts), arrays, 1) == 1);
+    }
+#if __cpp_lib_span >= 202002L
+    SECTION("span") {
+        std::vector<std::pair<int64, double>> buffer(4);
+        REQUIRE(storage.select_into(columns(&Sample::ts, &Sample::value),
+                                    std::span<std::pair<int64, double>>{buffer},
+                                    where(c(&Sample::ts) <= 2)) == 2);
+        REQUIRE(buffer[1].first == 2);
+    }
+#endif
+}
@@ -0,0 +1,201 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Log {
+        int id = 0;
+        std::string message;
+        std::vector<char> payload;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Log() = default;
+        Log(int id, std::string message, std::vector<char> payload) :
+            id{id}, message{move(message)}, payload{move(payload)} {}
+#endif
+    };
+
+    auto make_log_storage() {
+        auto storage = make_storage("",
+                                    make_table("logs",
+                                               make_column("id", &Log::id, primary_key()),
+                                               make_column("message", &Log::message),
+                                               make_column("payload", &Log::payload)));
+        storage.sync_schema();
+        storage.replace(Log{1, "first", {'a', 'b'}});
+        storage.replace(Log{2, std::string("sec\0nd", 6), {}});
+        return storage;
+    }
+}
+
+TEST_CASE("for_each_row") {
+    auto storage = make_log_storage();
+
+    SECTION("default row type") {
+        std::vector<std::string> messages;
+        storage.for_each_row(select(&Log::message, order_by(&Log::id)), [&messages](std::string message) {
+            messages.push_back(move(message));
+        });
+        REQUIRE(messages == std::vector<std::string>{"first", std::string("sec\0nd", 6)});
+    }
+    SECTION("prepared statement") {
+        auto statement = storage.prepare(select(columns(&Log::id, &Log::message), where(c(&Log::id) == 1)));
+        std::vector<std::tuple<int, std::string>> rows;
+        storage.for_each_row(statement, [&rows](std::tuple<int, std::string> row) {
+            rows.push_back(move(row));
+        });
+        storage.for_each_row(statement, [&rows](std::tuple<int, std::string> row) {
+            rows.push_back(move(row));
+        });
+        REQUIRE(rows == std::vector<std::tuple<int, std::string>>{{1, "first"}, {1, "first"}});
+    }
+}
+
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+TEST_CASE("row_extractor<std::string_view>") {
+    auto storage = make_log_storage();
+
+    std::vector<std::string> messages;
+    storage.for_each_row<std::string_view>(select(&Log::message, order_by(&Log::id)),
+                                           [&messages](std::string_view message) {
+                                               messages.emplace_back(message);
+                                           });
+    REQUIRE(messages == std::vector<std::string>{"first", std::string("sec\0nd", 6)});
+
+    std::vector<std::tuple<int, size_t>> lengths;
+    storage.for_each_row<std::tuple<int, std::string_view>>(
+        select(columns(&Log::id, &Log::message), order_by(&Log::id)),
+        [&lengths](std::tuple<int, std::string_view> row) {
+            lengths.emplace_back(std::get<0>(row), std::get<1>(row).size());
+        });
+    REQUIRE(lengths == std::vector<std::tuple<int, size_t>>{{1, 5}, {2, 6}});
+}
+#endif
+
+#if __cpp_lib_span >= 202002L
+TEST_CASE("row_extractor<std::span<const std::byte>>") {
+    auto storage = make_log_storage();
+
+    std::vector<size_t> sizes;
+    std::vector<std::byte> firstPayload;
+    storage.for_each_row<std::span<const std::byte>>(select(&Log::payload, order_by(&Log::id)),
+                                                     [&sizes, &firstPayload](std::span<const std::byte> payload) {
+                                                         if(sizes.empty()) {
+                                                             firstPayload.assign(payload.begin(), payload.end());
+                                                         }
+                                                         sizes.push_back(payload.size());
+                                                     });
+    REQUIRE(sizes == std::vector<size_t>{2, 0});
+    REQUIRE(firstPayload == std::vector<std::byte>{std::byte{'a'}, std::byte{'b'}});
+}
+#endif
+
+TEST_CASE("row_extractor<std::tuple>") {
+    sqlite3* db = nullptr;
+    REQUIRE(sqlite3_open(":memory:", &db) == SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    REQUIRE(sqlite3_prepare_v2(db, "SELECT 0, 1, 'one', NULL", -1, &stmt, nullptr) == SQLITE_OK);
+    REQUIRE(sqlite3_step(stmt) == SQLITE_ROW);
+
+    using row_type = std::tuple<int, std::string, std::unique_ptr<int>>;
+    SECTION("extract") {
+        auto row = row_extractor<row_type>().extract(stmt, 1);
+        REQUIRE(std::get<0>(row) == 1);
+        REQUIRE(std::get<1>(row) == "one");
+        REQUIRE_FALSE(std::get<2>(row));
+    }
+    SECTION("extract into") {
+        row_type row{5, "five", std::make_unique<int>(5)};
+        internal::extract_into(row, stmt, 1);
+        REQUIRE(std::get<0>(row) == 1);
+        REQUIRE(std::get<1>(row) == "one");
+        REQUIRE_FALSE(std::get<2>(row));
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+TEST_CASE("select tuple rows") {
+    auto storage = make_log_storage();
+
+    SECTION("mixed columns") {
+        auto rows = storage.select(
+            columns(&Log::id, &Log::message, &Log::payload, nullif<std::unique_ptr<int>>(&Log::id, 2)),
+            order_by(&Log::id));
+        REQUIRE(rows.size() == 2);
+        REQUIRE(std::get<0>(rows[0]) == 1);
+        REQUIRE(std::get<1>(rows[0]) == "first");
+        REQUIRE(std::get<2>(rows[0]) == std::vector<char>{'a', 'b'});
+        REQUIRE(std::get<3>(rows[0]));
+        REQUIRE(*std::get<3>(rows[0]) == 1);
+        REQUIRE(std::get<1>(rows[1]) == std::string("sec\0nd", 6));
+        REQUIRE(std::get<2>(rows[1]).empty());
+        REQUIRE_FALSE(std::get<3>(rows[1]));
+    }
+    SECTION("rows not default constructible") {
+        struct Id {
+            int value;
+
+            explicit Id(int value) : value{value} {}
+        };
+        auto rows = storage.select(columns(&Log::id, &Log::message), order_by(&Log::id));
+        REQUIRE(rows == std::vector<std::tuple<int, std::string>>{{1, "first"}, {2, std::string("sec\0nd", 6)}});
+        STATIC_REQUIRE_FALSE(internal::is_fillable_row_v<std::tuple<int, Id>>);
+        STATIC_REQUIRE(internal::is_fillable_row_v<std::tuple<int, std::string>>);
+    }
+}
+
+TEST_CASE("chrono, enum and UUID values") {
+    enum class Level : uint8_t { debug, info, error = 200 };
+    using microtime = std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds>;
+    using uuid = std::array<uint8_t, 16>;
+    struct Event {
+        uuid id{};
+        Level level = Level::debug;
+        microtime at;
+        std::chrono::milliseconds took{0};
+        std::chrono::duration<double> load{0};
+    };
+    auto storage = make_storage("",
+                                make_table("events",
+                                           make_column("id", &Event::id, primary_key()),
+                                           make_column("level", &Event::level),
+                                           make_column("at", &Event::at),
+                                           make_column("took", &Event::took),
+                                           make_column("load", &Event::load)));
+    storage.sync_schema();
+    auto tableInfo = storage.pragma.table_info("events");
+    REQUIRE(tableInfo[0].type == "BLOB");
+    REQUIRE(tableInfo[1].type == "INTEGER");
+    REQUIRE(tableInfo[2].type == "INTEGER");
+    REQUIRE(tableInfo[3].type == "INTEGER");
+    REQUIRE(tableInfo[4].type == "REAL");
+
+    const microtime at{std::chrono::microseconds{1700000000123456}};
+    uuid first{};
+    first[15] = 1;
+    uuid second{};
+    second[0] = 0xff;
+    storage.replace(Event{first, Level::error, at, std::chrono::milliseconds{250}, std::chrono::duration<double>{0.5}});
+    storage.replace(Event{second, Level::info, at + std::chrono::seconds{1}, {}, {}});
+
+    auto event = storage.get<Event>(first);
+    REQUIRE(event.level == Level::error);
+    REQUIRE(event.at == at);
+    REQUIRE(event.took == std::chrono::milliseconds{250});
+    REQUIRE(event.load.count() == 0.5);
+    REQUIRE(storage.select(&Event::at, where(c(&Event::id) == first)) == std::vector<microtime>{at});
+
+    //  stored as plain integers, which compare as such
+    REQUIRE(storage.select(cast<int>(&Event::level), order_by(&Event::level)) == std::vector<int>{1, 200});
+    REQUIRE(storage.select(cast<int64>(&Event::at), where(c(&Event::id) == first)) ==
+            std::vector<int64>{1700000000123456});
+    REQUIRE(storage.count<Event>(where(c(&Event::at) > at)) == 1);
+    REQUIRE(storage.select(&Event::id, where(c(&Event::level) == Level::info)) == std::vector<uuid>{second});
+
+    SECTION("blob of another size") {
+        storage.update_all(set(c(&Event::id) = std::vector<char>(17, 'x')), where(c(&Event::level) == Level::info));
+        REQUIRE_THROWS_AS(storage.select(&Event::id, where(c(&Event::level) == Level::info)), std::system_error);
+    }
+}
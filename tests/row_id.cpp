@@ -54,3 +54,56 @@ TEST_CASE("Row id") {
         REQUIRE(*rows[0] == 3);
     }
 }
+
+TEST_CASE("Rowid member") {
+    struct File {
+        std::string path;
+        int size = 0;
+        int64 rowid = 0;
+    };
+
+    auto storage = make_storage(
+        "",
+        make_table("files", make_column("path", &File::path, primary_key()), make_column("size", &File::size))
+            .with_rowid_member(&File::rowid));
+    storage.sync_schema();
+
+    File readme{"README.md", 10};
+    storage.replace(readme);
+    REQUIRE(readme.rowid == storage.last_insert_rowid());
+    File license{"LICENSE", 20};
+    storage.insert(license, columns(&File::path, &File::size));
+    REQUIRE(license.rowid == readme.rowid + 1);
+
+    SECTION("get") {
+        auto files = storage.get_all<File>(order_by(&File::path));
+        REQUIRE(files.size() == 2);
+        REQUIRE(files[0].path == "LICENSE");
+        REQUIRE(files[0].rowid == license.rowid);
+        REQUIRE(files[1].rowid == readme.rowid);
+        REQUIRE(storage.get<File>("README.md").rowid == readme.rowid);
+        auto rows = storage.select(columns(object<File>(), &File::size), where(c(&File::size) > 15));
+        REQUIRE(rows.size() == 1);
+        REQUIRE(std::get<0>(rows[0]).rowid == license.rowid);
+        REQUIRE(std::get<1>(rows[0]) == 20);
+    }
+    SECTION("update") {
+        readme.size = 11;
+        storage.update(readme);
+        REQUIRE(storage.get<File>("README.md").size == 11);
+        REQUIRE(storage.get<File>("LICENSE").size == 20);
+
+        auto updated = readme;
+        updated.size = 12;
+        storage.update_changed(readme, updated);
+        REQUIRE(storage.get<File>("README.md").size == 12);
+
+        auto statement = storage.prepare(update(readme));
+        REQUIRE(statement.sql() == R"(UPDATE "files" SET "size" = ? WHERE "rowid" = ?)");
+    }
+    SECTION("remove") {
+        storage.remove(readme);
+        REQUIRE(storage.count<File>() == 1);
+        REQUIRE(storage.get_pointer<File>("README.md") == nullptr);
+    }
+}
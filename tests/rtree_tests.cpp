@@ -0,0 +1,115 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Place {
+        int id = 0;
+        std::string name;
+    };
+
+    struct Box {
+        int64 id = 0;
+        double minX = 0;
+        double maxX = 0;
+        double minY = 0;
+        double maxY = 0;
+        std::string label;
+    };
+
+    struct Circle {
+        int operator()(sqlite3_rtree_query_info* info) const {
+            const double x = info->aParam[0];
+            const double y = info->aParam[1];
+            const double radius = info->aParam[2];
+            //  the boxes whose center is inside the circle
+            const double centerX = (info->aCoord[0] + info->aCoord[1]) / 2;
+            const double centerY = (info->aCoord[2] + info->aCoord[3]) / 2;
+            const double distance = (centerX - x) * (centerX - x) + (centerY - y) * (centerY - y);
+            info->eWithin = info->iLevel > 0 || distance <= radius * radius ? PARTLY_WITHIN : NOT_WITHIN;
+            info->rScore = info->iLevel;
+            return SQLITE_OK;
+        }
+
+        static const char* name() {
+            return "circle";
+        }
+    };
+}
+
+TEST_CASE("rtree") {
+    const char* filename = "rtree.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename](rtree_options options) {
+        return make_storage(filename,
+                            make_rtree_table("places_index",
+                                             std::move(options),
+                                             make_column("id", &Box::id, primary_key()),
+                                             make_column("minX", &Box::minX),
+                                             make_column("maxX", &Box::maxX),
+                                             make_column("minY", &Box::minY),
+                                             make_column("maxY", &Box::maxY),
+                                             make_column("label", &Box::label)),
+                            make_table("places",
+                                       make_column("id", &Place::id, primary_key()),
+                                       make_column("name", &Place::name)));
+    };
+    rtree_options options;
+    options.auxiliary = {"label"};
+    auto storage = makeStorage(options);
+    REQUIRE(storage.sync_schema()["places_index"] == sync_schema_result::new_table_created);
+    REQUIRE(storage.sync_schema()["places_index"] == sync_schema_result::already_in_sync);
+
+    for(int i = 1; i <= 100; ++i) {
+        storage.replace(Place{i, "place " + std::to_string(i)});
+        const double x = i % 10;
+        const double y = i / 10;
+        storage.replace(Box{i, x, x + 0.5, y, y + 0.5, "box " + std::to_string(i)});
+    }
+    REQUIRE(storage.count<Box>() == 100);
+    REQUIRE(storage.get<Box>(21).label == "box 21");
+
+    SECTION("range query") {
+        auto ids = storage.select(&Box::id,
+                                  where(c(&Box::maxX) >= 2.2 and c(&Box::minX) <= 3.2 and c(&Box::maxY) >= 4.2 and
+                                        c(&Box::minY) <= 5.2),
+                                  order_by(&Box::id));
+        REQUIRE(ids == std::vector<int64>{42, 43, 52, 53});
+    }
+    SECTION("join") {
+        auto names = storage.select(&Place::name,
+                                    inner_join<Box>(on(c(&Box::id) == &Place::id)),
+                                    where(c(&Box::minX) >= 9 and c(&Box::maxY) <= 1),
+                                    order_by(&Place::id));
+        REQUIRE(names == std::vector<std::string>{"place 9"});
+    }
+    SECTION("changed columns recreate the table") {
+        options.integer_coordinates = true;
+        auto storage2 = makeStorage(options);
+        REQUIRE(storage2.sync_schema_simulate()["places_index"] == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage2.sync_schema()["places_index"] == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage2.count<Box>() == 0);
+    }
+    SECTION("serialization") {
+        auto table = make_rtree_table("boxes",
+                                      rtree_options{},
+                                      make_column("id", &Box::id),
+                                      make_column("minX", &Box::minX),
+                                      make_column("maxX", &Box::maxX));
+        using db_objects_t = internal::db_objects_tuple<decltype(table)>;
+        auto dbObjects = db_objects_t{table};
+        using context_t = internal::serializer_context<db_objects_t>;
+        context_t context{dbObjects};
+        context.replace_bindable_with_question = true;
+        REQUIRE(internal::serialize(match(&Box::id, rtree_query<Circle>(1, 2, 3)), context) ==
+                "(\"id\" MATCH (circle(?, ?, ?)))");
+    }
+#ifdef SQLITE_ENABLE_RTREE
+    SECTION("custom geometry") {
+        storage.create_rtree_query_function<Circle>();
+        auto ids = storage.select(&Box::id, where(match(&Box::id, rtree_query<Circle>(5.0, 5.0, 0.5))));
+        REQUIRE(ids == std::vector<int64>{55});
+    }
+#endif  //  SQLITE_ENABLE_RTREE
+}
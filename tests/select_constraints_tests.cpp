@@ -369,6 +369,44 @@ TEST_CASE("Case") {
     }
 }
 
+TEST_CASE("Conditional updates") {
+    auto storage = make_storage({},
+                                make_table("users",
+                                           make_column("id", &User2::id, primary_key()),
+                                           make_column("first_name", &User2::firstName),
+                                           make_column("last_name", &User2::lastName),
+                                           make_column("country", &User2::country)));
+    storage.sync_schema();
+    storage.replace(User2{1, "Roberto", "Almeida", "Mexico"});
+    storage.replace(User2{2, "Julia", "Bernett", "USA"});
+    storage.replace(User2{3, "Camille", "Bernard", "Argentina"});
+    auto countries = [&storage] {
+        return storage.select(&User2::country, order_by(&User2::id));
+    };
+
+    SECTION("case_map") {
+        std::map<int, std::string> moves{{1, "Spain"}, {3, "France"}};
+        std::vector<int> ids{1, 3};
+        storage.update_all(set(c(&User2::country) = case_map(&User2::id, moves)), where(in(&User2::id, ids)));
+        REQUIRE(countries() == std::vector<std::string>{"Spain", "USA", "France"});
+
+        //  a different number of rows makes a different statement
+        moves = {{2, "Canada"}};
+        ids = {2};
+        storage.update_all(set(c(&User2::country) = case_map(&User2::id, moves)), where(in(&User2::id, ids)));
+        REQUIRE(countries() == std::vector<std::string>{"Spain", "Canada", "France"});
+    }
+#if SQLITE_VERSION_NUMBER >= 3032000
+    SECTION("iif") {
+        storage.update_all(set(c(&User2::country) = iif(c(&User2::country) == "USA", "Domestic", "Foreign")));
+        REQUIRE(countries() == std::vector<std::string>{"Foreign", "Domestic", "Foreign"});
+        auto rows = storage.select(iif(c(&User2::id) > 1, &User2::firstName, &User2::lastName), order_by(&User2::id));
+        static_assert(std::is_same<decltype(rows), std::vector<std::string>>::value, "");
+        REQUIRE(rows == std::vector<std::string>{"Almeida", "Julia", "Camille"});
+    }
+#endif
+}
+
 namespace {
     struct User3 {
         int id = 0;
@@ -574,6 +612,65 @@ TEST_CASE("Dynamic order by") {
     orderBy.clear();
 }
 
+TEST_CASE("Dynamic where") {
+    auto storage = make_storage({},
+                                make_table("users",
+                                           make_column("id", &User5::id, primary_key()),
+                                           make_column("first_name", &User5::firstName),
+                                           make_column("last_name", &User5::lastName),
+                                           make_column("register_time", &User5::registerTime)));
+    storage.sync_schema();
+
+    storage.replace(User5{1, "Jack", "Johnson", 100});
+    storage.replace(User5{2, "John", "Jackson", 90});
+    storage.replace(User5{3, "Elena", "Alexandra", 80});
+    storage.replace(User5{4, "Kaye", "Styles", 70});
+
+    auto filter = dynamic_where(storage);
+    auto ids = [&storage](const decltype(filter)& filter) {
+        std::vector<decltype(User5::id)> res;
+        for(auto& user: storage.get_all<User5>(filter, order_by(&User5::id))) {
+            res.push_back(user.id);
+        }
+        return res;
+    };
+
+    SECTION("no conditions") {
+        REQUIRE(ids(filter) == std::vector<decltype(User5::id)>{1, 2, 3, 4});
+        REQUIRE(storage.dump(get_all<User5>(filter)) ==
+                R"(SELECT "users"."id", "users"."first_name", "users"."last_name", "users"."register_time" FROM "users")");
+    }
+    SECTION("conditions") {
+        filter.push_back(c(&User5::registerTime) < 95);
+        filter.push_back(like(&User5::firstName, "J%"));
+        REQUIRE(ids(filter) == std::vector<decltype(User5::id)>{2});
+        REQUIRE(storage.count<User5>(filter) == 1);
+
+        filter.clear();
+        filter.push_back(c(&User5::registerTime) < 95);
+        REQUIRE(ids(filter) == std::vector<decltype(User5::id)>{2, 3, 4});
+        std::string name = "Kaye";
+        filter.push_back(is_equal(&User5::firstName, name));
+        name = "Elena";
+        REQUIRE(ids(filter) == std::vector<decltype(User5::id)>{4});
+        REQUIRE(storage.dump(get_all<User5>(filter), false) ==
+                R"(SELECT "users"."id", "users"."first_name", "users"."last_name", "users"."register_time" )"
+                R"(FROM "users" WHERE (("users"."first_name" = 'Kaye')) AND (("users"."register_time" < 95)))");
+    }
+    SECTION("one shape whatever the order") {
+        auto other = dynamic_where(storage);
+        filter.push_back(c(&User5::registerTime) > 75);
+        filter.push_back(like(&User5::lastName, "J%"));
+        other.push_back(like(&User5::lastName, "%s%"));
+        other.push_back(c(&User5::registerTime) > 85);
+        auto first = storage.prepare(get_all<User5>(filter));
+        auto second = storage.prepare(get_all<User5>(other));
+        REQUIRE(first.sql() == second.sql());
+        REQUIRE(storage.execute(first).size() == 2);
+        REQUIRE(storage.execute(second).size() == 2);
+    }
+}
+
 TEST_CASE("rows") {
     //  https://www.sqlite.org/rowvalue.html
     auto storage = make_storage({});
@@ -582,3 +679,69 @@ TEST_CASE("rows") {
     decltype(rows) expected{true};
     REQUIRE(rows == expected);
 }
+
+TEST_CASE("select objects of a join") {
+    struct Customer {
+        int id = 0;
+        std::string name;
+    };
+    struct Order {
+        int id = 0;
+        int customerId = 0;
+        double total = 0;
+    };
+    auto storage = make_storage({},
+                                make_table("customers",
+                                           make_column("id", &Customer::id, primary_key()),
+                                           make_column("name", &Customer::name)),
+                                make_table("orders",
+                                           make_column("id", &Order::id, primary_key()),
+                                           make_column("customer_id", &Order::customerId),
+                                           make_column("total", &Order::total)));
+    storage.sync_schema();
+    storage.replace(Customer{1, "Ann"});
+    storage.replace(Customer{2, "Bob"});
+    storage.replace(Order{10, 1, 5.5});
+    storage.replace(Order{11, 1, 7});
+
+    SECTION("inner join") {
+        auto rows = storage.select(columns(object<Order>(), object<Customer>()),
+                                   inner_join<Customer>(on(c(&Order::customerId) == &Customer::id)),
+                                   order_by(&Order::id));
+        static_assert(std::is_same<decltype(rows), std::vector<std::tuple<Order, Customer>>>::value, "");
+        REQUIRE(rows.size() == 2);
+        REQUIRE(std::get<0>(rows[0]).id == 10);
+        REQUIRE(std::get<0>(rows[0]).total == 5.5);
+        REQUIRE(std::get<1>(rows[0]).id == 1);
+        REQUIRE(std::get<1>(rows[0]).name == "Ann");
+        REQUIRE(std::get<0>(rows[1]).id == 11);
+        REQUIRE(std::get<1>(rows[1]).name == "Ann");
+    }
+    SECTION("with other columns") {
+        auto statement = storage.prepare(select(columns(&Customer::name, object<Order>(), &Order::total),
+                                                inner_join<Customer>(on(c(&Order::customerId) == &Customer::id)),
+                                                order_by(&Order::id).desc()));
+        auto rows = storage.execute(statement);
+        REQUIRE(rows.size() == 2);
+        REQUIRE(std::get<0>(rows[0]) == "Ann");
+        REQUIRE(std::get<1>(rows[0]).id == 11);
+        REQUIRE(std::get<1>(rows[0]).customerId == 1);
+        REQUIRE(std::get<2>(rows[0]) == 7);
+    }
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+    SECTION("left join") {
+        auto rows = storage.select(columns(object<Customer>(), optional_object<Order>()),
+                                   left_join<Order>(on(c(&Order::customerId) == &Customer::id)),
+                                   multi_order_by(order_by(&Customer::id), order_by(&Order::id)));
+        static_assert(std::is_same<decltype(rows), std::vector<std::tuple<Customer, std::optional<Order>>>>::value,
+                      "");
+        REQUIRE(rows.size() == 3);
+        REQUIRE(std::get<0>(rows[0]).name == "Ann");
+        REQUIRE(std::get<1>(rows[0]));
+        REQUIRE(std::get<1>(rows[0])->id == 10);
+        REQUIRE(std::get<1>(rows[1])->id == 11);
+        REQUIRE(std::get<0>(rows[2]).name == "Bob");
+        REQUIRE_FALSE(std::get<1>(rows[2]));
+    }
+#endif
+}
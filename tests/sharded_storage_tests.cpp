@@ -0,0 +1,95 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Account {
+        int id = 0;
+        std::string name;
+        int balance = 0;
+    };
+}
+
+TEST_CASE("sharded storage") {
+    auto sharded = make_sharded_storage<int>(
+        3,
+        [](size_t) {
+            return make_storage({},
+                                make_table("accounts",
+                                           make_column("id", &Account::id, primary_key()),
+                                           make_column("name", &Account::name),
+                                           make_column("balance", &Account::balance)));
+        },
+        [](const int& id) {
+            return size_t(id);
+        });
+    sharded.sync_schema();
+    for(int id = 1; id <= 9; ++id) {
+        sharded.replace(Account{id, "account" + std::to_string(id), id * 10 % 7});
+    }
+
+    SECTION("routing") {
+        REQUIRE(sharded.shard_count() == 3);
+        REQUIRE(sharded.shard_of(4) == 1);
+        REQUIRE(sharded.shard(1).count<Account>() == 3);
+        REQUIRE(sharded.shard(1).get<Account>(4).name == "account4");
+        REQUIRE(sharded.get<Account>(5).name == "account5");
+        REQUIRE(sharded.get_pointer<Account>(10) == nullptr);
+
+        sharded.update(Account{5, "renamed", 0});
+        REQUIRE(sharded.shard(2).get<Account>(5).name == "renamed");
+        sharded.remove<Account>(5);
+        REQUIRE(sharded.count<Account>() == 8);
+    }
+    SECTION("replace_range") {
+        std::vector<Account> accounts{{10, "a", 1}, {11, "b", 2}, {12, "c", 3}};
+        sharded.replace_range(accounts.begin(), accounts.end());
+        REQUIRE(sharded.count<Account>() == 12);
+        REQUIRE(sharded.shard(0).count<Account>() == 4);
+    }
+    SECTION("get_all merges ordered shards") {
+        auto accounts = sharded.get_all<Account>(order_by(&Account::balance).desc(), limit(4));
+        std::vector<int> balances;
+        for(auto& account: accounts) {
+            balances.push_back(account.balance);
+        }
+        REQUIRE(balances == std::vector<int>{6, 6, 5, 4});
+        REQUIRE(sharded.get_all<Account>(where(c(&Account::balance) > 3)).size() == 4);
+    }
+    SECTION("select") {
+        REQUIRE(sharded.select(&Account::id).size() == 9);
+        REQUIRE(sharded.select(&Account::id, limit(2)).size() == 2);
+        auto rows = sharded.select_ordered(
+            [](const std::tuple<std::string, int>& lhs, const std::tuple<std::string, int>& rhs) {
+                return std::get<0>(lhs) < std::get<0>(rhs);
+            },
+            columns(&Account::name, &Account::id),
+            order_by(&Account::name),
+            limit(3));
+        REQUIRE(rows == std::vector<std::tuple<std::string, int>>{{"account1", 1}, {"account2", 2}, {"account3", 3}});
+    }
+    SECTION("prepared statements") {
+        auto statement = sharded.prepare(get_all<Account>(order_by(&Account::balance).desc(), limit(4)));
+        REQUIRE(statement.statements.size() == 3);
+        auto accounts = sharded.execute(statement);
+        std::vector<int> balances;
+        for(auto& account: accounts) {
+            balances.push_back(account.balance);
+        }
+        REQUIRE(balances == std::vector<int>{6, 6, 5, 4});
+        for(auto& shardStatement: statement.statements) {
+            get<0>(shardStatement) = 2;
+        }
+        REQUIRE(sharded.execute(statement).size() == 2);
+
+        auto names = sharded.prepare(select(&Account::name, order_by(&Account::name), limit(4)));
+        REQUIRE(sharded.execute_ordered(std::less<std::string>{}, names) ==
+                std::vector<std::string>{"account1", "account2", "account3", "account4"});
+        REQUIRE(sharded.execute(names).size() == 4);
+    }
+    SECTION("remove_all") {
+        sharded.remove_all<Account>(where(c(&Account::id) < 4));
+        REQUIRE(sharded.count<Account>() == 6);
+    }
+}
@@ -0,0 +1,480 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <thread>  //  std::thread
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        User() = default;
+        User(int id, std::string name) : id{id}, name{move(name)} {}
+#endif
+    };
+
+    struct Person {
+        int id = 0;
+        std::string first;
+        std::string last;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Person() = default;
+        Person(int id, std::string first, std::string last) : id{id}, first{move(first)}, last{move(last)} {}
+#endif
+    };
+
+    int preparedStatementsCount(sqlite3* db) {
+        int result = 0;
+        for(sqlite3_stmt* stmt = sqlite3_next_stmt(db, nullptr); stmt; stmt = sqlite3_next_stmt(db, stmt)) {
+            ++result;
+        }
+        return result;
+    }
+}
+
+TEST_CASE("statement cache") {
+    auto filename = "statement_cache.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    sqlite3* db = nullptr;
+    storage.on_open = [&db](sqlite3* db_) {
+        db = db_;
+    };
+    REQUIRE_FALSE(storage.is_statement_cache_enabled());
+    storage.enable_statement_cache();
+    REQUIRE(storage.is_statement_cache_enabled());
+    REQUIRE(db);
+    storage.sync_schema();
+
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.replace(User{3, "Carol"});
+    REQUIRE(preparedStatementsCount(db) == 1);
+
+    SECTION("same shape reuses the statement") {
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.get<User>(2).name == "Bob");
+        //  `get_pointer` has the same sql as `get`
+        REQUIRE(storage.get_pointer<User>(3)->name == "Carol");
+        REQUIRE(preparedStatementsCount(db) == 2);
+
+        REQUIRE_THROWS_AS(storage.get<User>(4), std::system_error);
+        REQUIRE(storage.get<User>(3).name == "Carol");
+        REQUIRE(preparedStatementsCount(db) == 2);
+
+        storage.update(User{1, "Alicia"});
+        storage.update(User{2, "Bobby"});
+        REQUIRE(storage.get<User>(1).name == "Alicia");
+        REQUIRE(storage.get<User>(2).name == "Bobby");
+        REQUIRE(preparedStatementsCount(db) == 3);
+    }
+    SECTION("statements with runtime shape are keyed by sql") {
+        auto rows = storage.select(&User::id, where(in(&User::id, {1, 2})));
+        REQUIRE(rows == std::vector<int>{1, 2});
+        rows = storage.select(&User::id, where(in(&User::id, {2, 3})));
+        REQUIRE(rows == std::vector<int>{2, 3});
+        REQUIRE(preparedStatementsCount(db) == 2);
+
+        rows = storage.select(&User::id, where(in(&User::id, {1, 2, 3})));
+        REQUIRE(rows == std::vector<int>{1, 2, 3});
+        REQUIRE(preparedStatementsCount(db) == 3);
+
+        REQUIRE(storage.count<User>() == 3);
+        REQUIRE(storage.count<User>(where(c(&User::id) > 1)) == 2);
+        REQUIRE(storage.count<User>(where(c(&User::id) > 2)) == 1);
+        REQUIRE(preparedStatementsCount(db) == 5);
+    }
+    SECTION("cached statements don't leak into prepared statements") {
+        auto statement = storage.prepare(get<User>(1));
+        REQUIRE(storage.get<User>(1).name == storage.execute(statement).name);
+        REQUIRE(preparedStatementsCount(db) == 3);
+    }
+    SECTION("disabling finalizes statements") {
+        storage.get_all<User>();
+        storage.remove<User>(3);
+        REQUIRE(preparedStatementsCount(db) == 3);
+        storage.disable_statement_cache();
+        REQUIRE_FALSE(storage.is_statement_cache_enabled());
+        REQUIRE(preparedStatementsCount(db) == 0);
+        REQUIRE(storage.count<User>() == 2);
+    }
+    SECTION("toggling while a cached statement is in use") {
+        std::vector<std::string> names;
+        storage.for_each<User>([&storage, &names](User user) {
+            storage.disable_statement_cache();
+            storage.enable_statement_cache();
+            names.push_back(move(user.name));
+        });
+        REQUIRE(names == std::vector<std::string>{"Alice", "Bob", "Carol"});
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        storage.disable_statement_cache();
+        REQUIRE(preparedStatementsCount(db) == 0);
+    }
+}
+
+TEST_CASE("statement cache with a small capacity") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.enable_statement_cache(2);
+    REQUIRE(storage.is_opened());
+    storage.sync_schema();
+    storage.insert(User{0, "Alice"});
+    storage.insert(User{0, "Bob"});
+    REQUIRE(storage.get_all<User>().size() == 2);
+    REQUIRE(storage.get<User>(2).name == "Bob");
+    REQUIRE(storage.count<User>() == 2);
+}
+
+TEST_CASE("static sql is kept per storage") {
+    auto makeStorage = [](std::string tableName) {
+        return make_storage(
+            {},
+            make_table(move(tableName), make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    };
+    auto first = makeStorage("users");
+    auto second = makeStorage("people");
+    first.sync_schema();
+    second.sync_schema();
+
+    first.replace(User{1, "Alice"});
+    second.replace(User{1, "Bob"});
+    REQUIRE(first.get<User>(1).name == "Alice");
+    REQUIRE(second.get<User>(1).name == "Bob");
+
+    auto statement = second.prepare(get<User>(1));
+    REQUIRE(statement.sql() == R"(SELECT "id", "name" FROM "people" WHERE "id" = ?)");
+}
+
+TEST_CASE("memoized sql of conditions") {
+    using internal::sql_shape;
+    static_assert(sql_shape<decltype(get_all<User>(where(c(&User::id) > 1 && like(&User::name, "A%")),
+                                                   order_by(&User::id),
+                                                   limit(5)))>::memoizable,
+                  "");
+    static_assert(!sql_shape<decltype(get_all<User>(where(in(&User::id, select(&User::id)))))>::memoizable, "");
+
+    auto makeStorage = [](std::string tableName) {
+        return make_storage(
+            {},
+            make_table(move(tableName), make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    };
+    auto first = makeStorage("users");
+    auto second = makeStorage("people");
+    first.sync_schema();
+    second.sync_schema();
+    first.replace(User{1, "Alice"});
+    first.replace(User{2, "Bob"});
+    second.replace(User{1, "Carol"});
+
+    auto byName = [](std::string pattern) {
+        return get_all<User>(where(c(&User::id) > 0 && like(&User::name, move(pattern))));
+    };
+    REQUIRE(first.get_all<User>(where(c(&User::id) > 0 && like(&User::name, "A%"))).size() == 1);
+    REQUIRE(first.prepare(byName("B%")).sql() ==
+            R"(SELECT "users"."id", "users"."name" FROM "users" )"
+            R"(WHERE ((("users"."id" > ?) AND "users"."name" LIKE ?)))");
+    REQUIRE(second.prepare(byName("C%")).sql() ==
+            R"(SELECT "people"."id", "people"."name" FROM "people" )"
+            R"(WHERE ((("people"."id" > ?) AND "people"."name" LIKE ?)))");
+
+    SECTION("dynamic in lists are keyed by their length") {
+        auto byIds = [](std::vector<int> ids) {
+            return get_all<User>(where(in(&User::id, move(ids))));
+        };
+        REQUIRE(first.execute(first.prepare(byIds({1}))).size() == 1);
+        REQUIRE(first.execute(first.prepare(byIds({1, 2}))).size() == 2);
+        REQUIRE(first.prepare(byIds({2})).sql() ==
+                R"(SELECT "users"."id", "users"."name" FROM "users" WHERE ("users"."id" IN (?)))");
+        REQUIRE(first.get_all<User>(where(not_in(&User::id, std::vector<int>{1}))).size() == 1);
+        REQUIRE(first.get_all<User>(where(in(&User::id, std::vector<int>{1}))).size() == 1);
+    }
+    SECTION("order by direction is part of the key") {
+        auto ascending = first.get_all<User>(order_by(&User::id).asc());
+        auto descending = first.get_all<User>(order_by(&User::id).desc());
+        REQUIRE(ascending.front().id == 1);
+        REQUIRE(descending.front().id == 2);
+    }
+    SECTION("dynamic order by is keyed by its terms") {
+        static_assert(sql_shape<decltype(get_all<User>(dynamic_order_by(first)))>::memoizable, "");
+        auto orderBy = dynamic_order_by(first);
+        REQUIRE(first.get_all<User>(orderBy).size() == 2);
+        orderBy.push_back(order_by(&User::name).desc());
+        REQUIRE(first.get_all<User>(orderBy).front().id == 2);
+        REQUIRE(first.prepare(get_all<User>(orderBy)).sql() ==
+                R"(SELECT "users"."id", "users"."name" FROM "users" ORDER BY "name" DESC)");
+        orderBy.clear();
+        orderBy.push_back(order_by(&User::name).asc());
+        REQUIRE(first.get_all<User>(orderBy).front().id == 1);
+        REQUIRE(second.get_all<User>(dynamic_order_by(second)).size() == 1);
+    }
+}
+
+TEST_CASE("memoized sql of same-typed columns") {
+    auto storage = make_storage({},
+                                make_table("people",
+                                           make_column("id", &Person::id, primary_key()),
+                                           make_column("first", &Person::first, default_value("")),
+                                           make_column("last", &Person::last, default_value(""))));
+    storage.sync_schema();
+    storage.replace(Person{1, "Ann", "Smith"});
+    storage.replace(Person{2, "Smith", "Ann"});
+
+    SECTION("where") {
+        REQUIRE(storage.get_all<Person>(where(c(&Person::first) == "Ann")).front().id == 1);
+        REQUIRE(storage.get_all<Person>(where(c(&Person::last) == "Ann")).front().id == 2);
+        REQUIRE(storage.get_all<Person>(where(c(column<Person>(&Person::last)) == "Ann")).front().id == 2);
+        REQUIRE(storage.prepare(get_all<Person>(where(c(&Person::last) == "Ann"))).sql() ==
+                R"(SELECT "people"."id", "people"."first", "people"."last" FROM "people" )"
+                R"(WHERE (("people"."last" = ?)))");
+    }
+    SECTION("order_by") {
+        REQUIRE(storage.get_all<Person>(order_by(&Person::first)).front().id == 1);
+        REQUIRE(storage.get_all<Person>(order_by(&Person::last)).front().id == 2);
+    }
+    SECTION("remove_all") {
+        storage.remove_all<Person>(where(c(&Person::first) == "Bob"));
+        storage.remove_all<Person>(where(c(&Person::last) == "Smith"));
+        auto people = storage.get_all<Person>();
+        REQUIRE(people.size() == 1);
+        REQUIRE(people.front().id == 2);
+    }
+    SECTION("insert with explicit columns") {
+        storage.insert(Person{3, "Carl", "Jones"}, columns(&Person::id, &Person::first));
+        storage.insert(Person{4, "Dave", "Brown"}, columns(&Person::id, &Person::last));
+        auto carl = storage.get<Person>(3);
+        auto dave = storage.get<Person>(4);
+        REQUIRE(carl.first == "Carl");
+        REQUIRE(carl.last.empty());
+        REQUIRE(dave.first.empty());
+        REQUIRE(dave.last == "Brown");
+    }
+}
+
+TEST_CASE("statement stats") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+
+    auto statement = storage.prepare(select(&User::id, where(c(&User::name) == "Bob")));
+    REQUIRE(storage.execute(statement).size() == 1);
+    auto stats = statement.stats(true);
+    REQUIRE(stats.fullscan_steps > 0);
+    REQUIRE(stats.vm_steps > 0);
+#if SQLITE_VERSION_NUMBER >= 3020000
+    REQUIRE(stats.runs == 1);
+    REQUIRE(stats.memory_used > 0);
+#endif
+    REQUIRE(statement.stats().fullscan_steps == 0);
+
+    REQUIRE(storage.cached_statements_stats().empty());
+    storage.enable_statement_cache();
+    storage.get_all<User>(order_by(&User::name));
+    storage.get_all<User>(order_by(&User::name));
+    storage.get<User>(1);
+    auto cachedStats = storage.cached_statements_stats();
+    REQUIRE(cachedStats.size() == 2);
+    auto it = std::find_if(cachedStats.begin(), cachedStats.end(), [](auto& p) {
+        return p.first.find("ORDER BY") != std::string::npos;
+    });
+    REQUIRE(it != cachedStats.end());
+    REQUIRE(it->second.sorts == 2);
+#if SQLITE_VERSION_NUMBER >= 3020000
+    REQUIRE(it->second.runs == 2);
+#endif
+}
+
+TEST_CASE("statement slots") {
+    auto filename = "statement_slots.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    using get_user_t = decltype(get<User>(0));
+
+    SECTION("the statement of a type is prepared once per connection") {
+        storage.open_forever();
+        auto getUser = storage.statement<get_user_t>();
+        get<0>(*getUser) = 2;
+        REQUIRE(storage.execute(*getUser).name == "Bob");
+
+        auto again = storage.statement<get_user_t>();
+        REQUIRE(&*again == &*getUser);
+        get<0>(*again) = 1;
+        REQUIRE(storage.execute(*again).name == "Alice");
+
+        auto getBobs = storage.statement(get_all<User>(where(c(&User::name) == "Bob")));
+        REQUIRE(getBobs->stmt != getUser->stmt);
+        REQUIRE(storage.execute(*getBobs).size() == 1);
+        //  the expression of later calls is ignored
+        auto getCarols = storage.statement(get_all<User>(where(c(&User::name) == "Carol")));
+        REQUIRE(storage.execute(*getCarols).front().name == "Bob");
+    }
+    SECTION("statements are finalized when the connection is closed") {
+        {
+            auto getUser = storage.statement<get_user_t>();
+            get<0>(*getUser) = 1;
+            REQUIRE(storage.execute(*getUser).name == "Alice");
+            REQUIRE(storage.is_opened());
+        }
+        REQUIRE_FALSE(storage.is_opened());
+        auto getUser = storage.statement<get_user_t>();
+        get<0>(*getUser) = 2;
+        REQUIRE(storage.execute(*getUser).name == "Bob");
+    }
+    SECTION("pooled connections have their own statements") {
+        auto pooled = make_storage(
+            pool_options{2},
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+        auto getUser = pooled.statement<get_user_t>();
+        sqlite3_stmt* otherStmt = nullptr;
+        std::string otherName;
+        std::thread other{[&pooled, &otherStmt, &otherName] {
+            auto otherGetUser = pooled.statement<get_user_t>();
+            otherStmt = otherGetUser->stmt;
+            get<0>(*otherGetUser) = 2;
+            otherName = pooled.execute(*otherGetUser).name;
+        }};
+        other.join();
+        REQUIRE(otherStmt != getUser->stmt);
+        REQUIRE(otherName == "Bob");
+        get<0>(*getUser) = 1;
+        REQUIRE(pooled.execute(*getUser).name == "Alice");
+    }
+}
+
+TEST_CASE("shared statements") {
+    auto filename = "shared_statements.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    auto pooled = make_storage(
+        pool_options{2},
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+
+    const auto getUser = make_shared_statement(get<User>(0));
+    const auto countUsers = make_shared_statement(select(count<User>()));
+    auto check = [&getUser, &countUsers](auto& storage) {
+        REQUIRE(storage.execute(countUsers) == std::vector<int>{2});
+
+        //  the workers on each connection run the statement prepared there
+        std::vector<std::string> names(4);
+        std::vector<std::thread> workers;
+        for(size_t i = 0; i < names.size(); ++i) {
+            workers.emplace_back([&storage, &getUser, &names, i] {
+                for(int j = 0; j < 20; ++j) {
+                    names[i] = storage
+                                   .execute(getUser,
+                                            [i](auto& statement) {
+                                                get<0>(statement) = int(i % 2) + 1;
+                                            })
+                                   .name;
+                }
+            });
+        }
+        for(auto& worker: workers) {
+            worker.join();
+        }
+        REQUIRE(names == std::vector<std::string>{"Alice", "Bob", "Alice", "Bob"});
+        REQUIRE_THROWS_AS(storage.execute(getUser,
+                                          [](auto& statement) {
+                                              get<0>(statement) = 3;
+                                          }),
+                          std::system_error);
+    };
+    SECTION("one connection") {
+        storage.open_forever();
+        check(storage);
+    }
+    SECTION("pool") {
+        check(pooled);
+    }
+    ::remove(filename);
+}
+
+TEST_CASE("warm up") {
+    auto filename = "warm_up.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename] {
+        return make_storage(filename,
+                            make_index("idx_users_name", &User::name),
+                            make_table("users",
+                                       make_column("id", &User::id, primary_key()),
+                                       make_column("name", &User::name)));
+    };
+    {
+        auto storage = makeStorage();
+        storage.sync_schema();
+        storage.transaction([&storage] {
+            for(int i = 1; i <= 1000; ++i) {
+                storage.replace(User{i, "user " + std::to_string(i)});
+            }
+            return true;
+        });
+    }
+    auto storage = makeStorage();
+    sqlite3* db = nullptr;
+    storage.on_open = [&db](sqlite3* db_) {
+        db = db_;
+    };
+    storage.enable_statement_cache();
+
+    SECTION("prepare_on_open") {
+        storage.prepare_on_open(get<User>(0));
+        REQUIRE(preparedStatementsCount(db) == 1);
+
+        auto pooled = make_storage(pool_options{2},
+                                   filename,
+                                   make_index("idx_users_name", &User::name),
+                                   make_table("users",
+                                              make_column("id", &User::id, primary_key()),
+                                              make_column("name", &User::name)));
+        pooled.enable_statement_cache();
+        pooled.prepare_on_open(get<User>(0));
+        //  keeps the first connection borrowed so that the other thread opens another one
+        auto session = pooled.session();
+        sqlite3* otherDb = nullptr;
+        pooled.on_open = [&otherDb](sqlite3* db_) {
+            otherDb = db_;
+        };
+        int countOnOpen = 0;
+        int countAfterGet = 0;
+        std::thread other{[&pooled, &otherDb, &countOnOpen, &countAfterGet] {
+            pooled.get<User>(5);
+            countOnOpen = preparedStatementsCount(otherDb);
+            REQUIRE(pooled.get<User>(6).name == "user 6");
+            countAfterGet = preparedStatementsCount(otherDb);
+        }};
+        other.join();
+        REQUIRE(otherDb != session.get());
+        REQUIRE(countOnOpen == 1);
+        REQUIRE(countAfterGet == 1);
+    }
+    SECTION("warm_up") {
+        int used = 0;
+        int highwater = 0;
+        sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &used, &highwater, false);
+        const int before = used;
+        storage.warm_up<User>();
+        sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &used, &highwater, false);
+        REQUIRE(used > before);
+    }
+    ::remove(filename);
+}
@@ -36,7 +36,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = avg(&User::id).filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((AVG("id")) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(AVG("id") FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
@@ -64,7 +64,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = count(&User::id).filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((COUNT("id")) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(COUNT("id") FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
@@ -86,6 +86,11 @@ TEST_CASE("statement_serializer aggregate functions") {
                 value = serialize(expression, context);
                 expected = R"(COUNT(*) FILTER (WHERE ("id" < 10)))";
             }
+            SECTION("without type") {
+                auto expression = count().filter(where(lesser_than(&User::id, 10)));
+                value = serialize(expression, context);
+                expected = R"(COUNT(*) FILTER (WHERE ("id" < 10)))";
+            }
         }
     }
     SECTION("group_concat(X)") {
@@ -106,7 +111,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = group_concat(&User::id).filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((GROUP_CONCAT("id")) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(GROUP_CONCAT("id") FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
@@ -134,7 +139,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = group_concat(&User::id, "-").filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((GROUP_CONCAT("id", '-')) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(GROUP_CONCAT("id", '-') FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
@@ -162,7 +167,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = max(&User::id).filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((MAX("id")) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(MAX("id") FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
@@ -190,7 +195,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = min(&User::id).filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((MIN("id")) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(MIN("id") FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
@@ -218,7 +223,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = sum(&User::id).filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((SUM("id")) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(SUM("id") FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
@@ -246,7 +251,7 @@ TEST_CASE("statement_serializer aggregate functions") {
                 auto expression = total(&User::id).filter(where(lesser_than(&User::id, 10)));
                 SECTION("use_parentheses") {
                     context.use_parentheses = true;
-                    expected = R"((TOTAL("id")) FILTER (WHERE ("id" < 10)))";
+                    expected = R"(TOTAL("id") FILTER (WHERE ("id" < 10)))";
                 }
                 SECTION("!use_parentheses") {
                     context.use_parentheses = false;
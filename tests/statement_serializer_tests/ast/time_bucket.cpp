@@ -0,0 +1,45 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+TEST_CASE("time_bucket") {
+    using internal::serialize;
+    struct Point {
+        int64 ts = 0;
+        double seconds = 0;
+        std::string time;
+    };
+    auto table = make_table("points",
+                            make_column("ts", &Point::ts),
+                            make_column("seconds", &Point::seconds),
+                            make_column("time", &Point::time));
+    using db_objects_t = internal::db_objects_tuple<decltype(table)>;
+    auto dbObjects = db_objects_t{table};
+    using context_t = internal::serializer_context<db_objects_t>;
+    context_t context{dbObjects};
+
+    std::string value;
+    decltype(value) expected;
+    SECTION("integer") {
+        auto statement = time_bucket(&Point::ts, 300);
+        STATIC_REQUIRE(std::is_same<internal::column_result_of_t<db_objects_t, decltype(statement)>, int64>::value);
+        value = serialize(statement, context);
+        expected = R"(("ts" / 300 * 300))";
+    }
+    SECTION("real") {
+        auto statement = time_bucket(&Point::seconds, 60);
+        value = serialize(statement, context);
+        expected = R"((CAST("seconds" AS INTEGER) / 60 * 60))";
+    }
+    SECTION("text") {
+        auto statement = time_bucket(&Point::time, 3600);
+        STATIC_REQUIRE(
+            std::is_same<internal::column_result_of_t<db_objects_t, decltype(statement)>, std::string>::value);
+        value = serialize(statement, context);
+        expected =
+            R"(strftime('%Y-%m-%d %H:%M:%S', CAST(strftime('%s', "time") AS INTEGER) / 3600 * 3600, 'unixepoch'))";
+    }
+
+    REQUIRE(value == expected);
+}
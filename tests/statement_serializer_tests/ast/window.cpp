@@ -0,0 +1,94 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+TEST_CASE("window") {
+    using internal::serialize;
+    struct Sale {
+        int id = 0;
+        std::string region;
+        int day = 0;
+        double amount = 0;
+    };
+    auto table = make_table("sales",
+                            make_column("id", &Sale::id, primary_key()),
+                            make_column("region", &Sale::region),
+                            make_column("day", &Sale::day),
+                            make_column("amount", &Sale::amount));
+    using db_objects_t = internal::db_objects_tuple<decltype(table)>;
+    auto dbObjects = db_objects_t{table};
+    using context_t = internal::serializer_context<db_objects_t>;
+    context_t context{dbObjects};
+    context.replace_bindable_with_question = true;
+    context.skip_table_name = false;
+    context.use_parentheses = false;
+
+    std::string value;
+    decltype(value) expected;
+    SECTION("row_number") {
+        auto expression = row_number().over(partition_by(&Sale::region), order_by(&Sale::day).desc());
+        value = serialize(expression, context);
+        expected = R"(ROW_NUMBER() OVER (PARTITION BY "sales"."region" ORDER BY "sales"."day" DESC))";
+    }
+    SECTION("empty definition") {
+        auto expression = count().over();
+        value = serialize(expression, context);
+        expected = "COUNT(*) OVER ()";
+    }
+    SECTION("aggregate with frame") {
+        auto expression = sum(&Sale::amount).over(order_by(&Sale::day), rows_between(preceding(2), current_row()));
+        value = serialize(expression, context);
+        expected = R"(SUM("sales"."amount") OVER (ORDER BY "sales"."day" ROWS BETWEEN 2 PRECEDING AND CURRENT ROW))";
+    }
+    SECTION("unbounded frame") {
+        auto expression = last_value(&Sale::amount)
+                              .over(partition_by(&Sale::region, &Sale::day),
+                                    range_between(unbounded_preceding(), unbounded_following()));
+        value = serialize(expression, context);
+        expected = R"(LAST_VALUE("sales"."amount") OVER (PARTITION BY "sales"."region", "sales"."day" )"
+                   R"(RANGE BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING))";
+    }
+    SECTION("groups frame") {
+        auto expression = avg(&Sale::amount).over(order_by(&Sale::day), groups_between(current_row(), following(1)));
+        value = serialize(expression, context);
+        expected = R"(AVG("sales"."amount") OVER (ORDER BY "sales"."day" GROUPS BETWEEN CURRENT ROW AND 1 FOLLOWING))";
+    }
+    SECTION("lag") {
+        auto expression = lag(&Sale::amount, 1, 0).over(order_by(&Sale::day));
+        value = serialize(expression, context);
+        expected = R"(LAG("sales"."amount", ?, ?) OVER (ORDER BY "sales"."day"))";
+    }
+    SECTION("filter") {
+        auto expression = sum(&Sale::amount).filter(where(c(&Sale::day) > 1)).over(partition_by(&Sale::region));
+        value = serialize(expression, context);
+        expected = R"(SUM("sales"."amount") FILTER (WHERE "sales"."day" > ?) OVER (PARTITION BY "sales"."region"))";
+    }
+    SECTION("named window") {
+        auto expression = rank().over("w");
+        value = serialize(expression, context);
+        expected = R"(RANK() OVER "w")";
+    }
+    SECTION("window clause") {
+        auto expression = window("w", partition_by(&Sale::region), order_by(&Sale::day));
+        value = serialize(expression, context);
+        expected = R"(WINDOW "w" AS (PARTITION BY "sales"."region" ORDER BY "sales"."day"))";
+    }
+    SECTION("window clause with several windows") {
+        auto expression = window(named_window("a", partition_by(&Sale::region)),
+                                 named_window("b", order_by(&Sale::day), rows_between(preceding(1), following(1))));
+        value = serialize(expression, context);
+        expected = R"(WINDOW "a" AS (PARTITION BY "sales"."region"), )"
+                   R"("b" AS (ORDER BY "sales"."day" ROWS BETWEEN 1 PRECEDING AND 1 FOLLOWING))";
+    }
+    SECTION("select") {
+        auto expression = select(columns(&Sale::id, dense_rank().over("w")),
+                                 window("w", order_by(&Sale::amount)),
+                                 order_by(&Sale::id));
+        expression.highest_level = true;
+        value = serialize(expression, context);
+        expected = R"(SELECT "sales"."id", DENSE_RANK() OVER "w" FROM "sales" )"
+                   R"(WINDOW "w" AS (ORDER BY "sales"."amount") ORDER BY "sales"."id")";
+    }
+    REQUIRE(value == expected);
+}
@@ -0,0 +1,79 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+TEST_CASE("with") {
+    using internal::serialize;
+    struct Node {
+        int id = 0;
+        int parentId = 0;
+    };
+    struct Ancestor {
+        int id = 0;
+        int depth = 0;
+    };
+    auto table =
+        make_table("nodes", make_column("id", &Node::id, primary_key()), make_column("parent_id", &Node::parentId));
+    using db_objects_t = internal::db_objects_tuple<decltype(table)>;
+    auto dbObjects = db_objects_t{table};
+    using context_t = internal::serializer_context<db_objects_t>;
+    context_t context{dbObjects};
+    context.replace_bindable_with_question = true;
+    context.skip_table_name = false;
+
+    auto ancestors = cte("ancestors", make_column("id", &Ancestor::id), make_column("depth", &Ancestor::depth));
+    std::string value;
+    decltype(value) expected;
+    SECTION("with") {
+        auto statement =
+            with(ancestors.as(select(columns(&Node::parentId, 1), where(c(&Node::id) == 4))), select(&Ancestor::id));
+        value = serialize(statement, context);
+        expected = R"(WITH "ancestors"("id", "depth") AS )"
+                   R"((SELECT "nodes"."parent_id", ? FROM "nodes" WHERE (("nodes"."id" = ?))) )"
+                   R"(SELECT "ancestors"."id" FROM "ancestors")";
+    }
+    SECTION("materialized") {
+        auto statement = with(ancestors.as(select(columns(&Node::id, &Node::parentId))).materialized(),
+                              select(&Ancestor::depth, where(c(&Ancestor::id) > 1)));
+        value = serialize(statement, context);
+        expected = R"(WITH "ancestors"("id", "depth") AS MATERIALIZED )"
+                   R"((SELECT "nodes"."id", "nodes"."parent_id" FROM "nodes") )"
+                   R"(SELECT "ancestors"."depth" FROM "ancestors" WHERE (("ancestors"."id" > ?)))";
+    }
+    SECTION("not materialized") {
+        auto statement =
+            with(ancestors.as(select(columns(&Node::id, &Node::parentId))).not_materialized(), select(&Ancestor::id));
+        value = serialize(statement, context);
+        expected = R"(WITH "ancestors"("id", "depth") AS NOT MATERIALIZED )"
+                   R"((SELECT "nodes"."id", "nodes"."parent_id" FROM "nodes") )"
+                   R"(SELECT "ancestors"."id" FROM "ancestors")";
+    }
+    SECTION("recursive") {
+        auto statement = with_recursive(
+            ancestors.as(union_all(select(columns(&Node::parentId, 1), where(c(&Node::id) == 4)),
+                                   select(columns(&Node::parentId, c(&Ancestor::depth) + 1),
+                                          join<Ancestor>(on(c(&Ancestor::id) == &Node::id))))),
+            select(&Ancestor::id));
+        value = serialize(statement, context);
+        expected = R"(WITH RECURSIVE "ancestors"("id", "depth") AS (SELECT "nodes"."parent_id", ? FROM "nodes" )"
+                   R"(WHERE (("nodes"."id" = ?)) UNION ALL SELECT "nodes"."parent_id", ("ancestors"."depth" + ?) )"
+                   R"(FROM "nodes" JOIN "ancestors" ON ("ancestors"."id" = "nodes"."id") ) )"
+                   R"(SELECT "ancestors"."id" FROM "ancestors")";
+    }
+    SECTION("several") {
+        struct Leaf {
+            int id = 0;
+        };
+        auto leaves = cte("leaves", make_column("id", &Leaf::id)).as(select(&Node::id, where(c(&Node::parentId) > 0)));
+        auto statement = with(std::make_tuple(ancestors.as(select(columns(&Node::id, &Node::parentId))), leaves),
+                              select(&Ancestor::depth, join<Leaf>(on(c(&Leaf::id) == &Ancestor::id))));
+        value = serialize(statement, context);
+        expected = R"(WITH "ancestors"("id", "depth") AS (SELECT "nodes"."id", "nodes"."parent_id" FROM "nodes"), )"
+                   R"("leaves"("id") AS (SELECT "nodes"."id" FROM "nodes" WHERE (("nodes"."parent_id" > ?))) )"
+                   R"(SELECT "ancestors"."depth" FROM "ancestors" )"
+                   R"(JOIN "leaves" ON ("leaves"."id" = "ancestors"."id") )";
+    }
+
+    REQUIRE(value == expected);
+}
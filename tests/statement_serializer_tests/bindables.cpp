@@ -206,6 +206,7 @@ TEST_CASE("bindables") {
                             unique_ptr<int>,
                             shared_ptr<int>,
                             vector<char>,
+                            vector<unsigned char>,
 #ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
                             std::optional<int>,
                             std::optional<Custom>,
@@ -230,6 +231,7 @@ TEST_CASE("bindables") {
                                                   "null",
                                                   "null",
                                                   "x''",
+                                                  "x''",
 #ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
                                                   "null",
                                                   "null",
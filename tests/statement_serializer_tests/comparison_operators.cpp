@@ -80,5 +80,20 @@ TEST_CASE("statement_serializer comparison operators") {
         }
         expected = "('lala' != 7)";
     }
+    SECTION("row value") {
+        SECTION("with tuple") {
+            value = serialize(tuple_value(1, 2) > std::make_tuple(1, 3), context);
+            expected = "((1, 2) > (1, 3))";
+        }
+        SECTION("with row value") {
+            value = serialize(tuple_value(1, "a") <= tuple_value(2, "b"), context);
+            expected = "((1, 'a') <= (2, 'b'))";
+        }
+        SECTION("question") {
+            context.replace_bindable_with_question = true;
+            value = serialize(tuple_value(1, 2) == std::make_tuple(3, 4), context);
+            expected = "((?, ?) = (?, ?))";
+        }
+    }
     REQUIRE(value == expected);
 }
@@ -84,6 +84,39 @@ TEST_CASE("statement_serializer logical operators") {
             stringValue = internal::serialize(inValue, context);
             expected = R"("id" NOT IN (1, 2, 3))";
         }
+        SECTION("array in") {
+            auto inValue = in(&User::id, as_array({1, 2, 3}));
+            stringValue = internal::serialize(inValue, context);
+            expected = R"("id" IN (SELECT value FROM json_each('[1,2,3]')))";
+        }
+        SECTION("array not in") {
+            auto inValue = not_in(&User::name, as_array<std::string>({"a'b", "c\"d"}));
+            stringValue = internal::serialize(inValue, context);
+            expected = R"("name" NOT IN (SELECT value FROM json_each('["a''b","c\"d"]')))";
+        }
+        SECTION("array in with question") {
+            auto inValue = in(&User::id, as_array({1, 2, 3}));
+            context.replace_bindable_with_question = true;
+            stringValue = internal::serialize(inValue, context);
+            expected = R"("id" IN (SELECT value FROM json_each(?)))";
+        }
+        SECTION("row value in") {
+            std::vector<std::tuple<int, std::string>> keys{{1, "a"}, {2, "b"}};
+            auto inValue = in(tuple_value(&User::id, &User::name), keys);
+            stringValue = internal::serialize(inValue, context);
+            expected = R"(("id", "name") IN (VALUES (1, 'a'), (2, 'b')))";
+        }
+        SECTION("row value not in with question") {
+            auto inValue = not_in(tuple_value(&User::id, &User::name), {std::make_tuple(1, std::string("a"))});
+            context.replace_bindable_with_question = true;
+            stringValue = internal::serialize(inValue, context);
+            expected = R"(("id", "name") NOT IN (VALUES (?, ?)))";
+        }
+        SECTION("row value in empty") {
+            auto inValue = in(tuple_value(&User::id, &User::name), std::vector<std::tuple<int, std::string>>{});
+            stringValue = internal::serialize(inValue, context);
+            expected = R"(("id", "name") IN (SELECT NULL, NULL LIMIT 0))";
+        }
     }
     REQUIRE(stringValue == expected);
 }
@@ -50,5 +50,15 @@ TEST_CASE("statement_serializer index") {
         value = internal::serialize(index, context);
         expected = R"(CREATE INDEX IF NOT EXISTS "idx" ON "users" ("id") WHERE ("id" IS NOT NULL))";
     }
+    SECTION("expression") {
+        auto index = make_unique_index("idx_users_name", lower(&User::name));
+        value = internal::serialize(index, context);
+        expected = R"(CREATE UNIQUE INDEX IF NOT EXISTS "idx_users_name" ON "users" (LOWER("name")))";
+    }
+    SECTION("expression and column") {
+        auto index = make_index("idx", indexed_column(length(&User::name)).desc(), &User::id);
+        value = internal::serialize(index, context);
+        expected = R"(CREATE INDEX IF NOT EXISTS "idx" ON "users" (LENGTH("name") DESC, "id"))";
+    }
     REQUIRE(value == expected);
 }
@@ -371,6 +371,13 @@ TEST_CASE("statement_serializer insert/replace") {
                 value = serialize(expression, context);
                 expected = R"(INSERT INTO "users" ("id", "name") VALUES (?, ?))";
             }
+            SECTION("or ignore") {
+                auto expression = insert_range<User>(users.begin(), users.end(), or_ignore());
+                // deduced object type
+                assert_same(insert_range(users.begin(), users.end(), or_ignore()), expression);
+                value = serialize(expression, context);
+                expected = R"(INSERT OR IGNORE INTO "users" ("id", "name") VALUES (?, ?))";
+            }
             SECTION("indirected") {
                 std::vector<std::unique_ptr<User>> userPtrs;
                 userPtrs.push_back(std::make_unique<User>(users.front()));
@@ -58,3 +58,47 @@ TEST_CASE("statement_serializer update_all") {
         R"(UPDATE "contacts" SET "phone" = (SELECT "customers"."Phone" FROM "customers" WHERE (("CustomerId" = 1))))";
     REQUIRE(value == expected);
 }
+
+TEST_CASE("statement_serializer update_all from") {
+    using internal::serialize;
+    struct Product {
+        int id = 0;
+        double price = 0;
+    };
+    struct PriceUpdate {
+        int productId = 0;
+        double price = 0;
+    };
+    auto productsTable =
+        make_table("products", make_column("id", &Product::id, primary_key()), make_column("price", &Product::price));
+    auto updatesTable = make_table("a_price_updates",
+                                   make_column("product_id", &PriceUpdate::productId),
+                                   make_column("price", &PriceUpdate::price));
+    using db_objects_t = internal::db_objects_tuple<decltype(productsTable), decltype(updatesTable)>;
+    auto dbObjects = db_objects_t{productsTable, updatesTable};
+    using context_t = internal::serializer_context<db_objects_t>;
+    context_t context{dbObjects};
+    context.replace_bindable_with_question = true;
+    context.skip_table_name = false;
+
+    std::string value;
+    decltype(value) expected;
+    SECTION("from") {
+        auto statement = update_all(set(c(&Product::price) = &PriceUpdate::price),
+                                    from<PriceUpdate>(),
+                                    where(c(&PriceUpdate::productId) == &Product::id));
+        value = serialize(statement, context);
+        expected = R"(UPDATE "products" SET "price" = "a_price_updates"."price" FROM "a_price_updates" )"
+                   R"(WHERE (("a_price_updates"."product_id" = "products"."id")))";
+    }
+    SECTION("from with expression") {
+        auto statement = update_all(set(c(&Product::price) = c(&Product::price) + c(&PriceUpdate::price) * 2),
+                                    from<PriceUpdate>(),
+                                    where(c(&PriceUpdate::productId) == &Product::id and c(&PriceUpdate::price) > 0));
+        value = serialize(statement, context);
+        expected = R"(UPDATE "products" SET "price" = ("products"."price" + ("a_price_updates"."price" * ?)) )"
+                   R"(FROM "a_price_updates" WHERE ((("a_price_updates"."product_id" = "products"."id") )"
+                   R"(AND ("a_price_updates"."price" > ?))))";
+    }
+    REQUIRE(value == expected);
+}
@@ -51,6 +51,7 @@ TEST_CASE("bindable_filter") {
                                  StringVeneer<wchar_t>,
 #endif
                                  std::vector<char>,
+                                 std::vector<unsigned char>,
                                  std::nullptr_t,
 #ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
                                  std::nullopt_t,
@@ -0,0 +1,52 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Employee {
+        int id;
+        std::string name;
+        int departmentId;
+    };
+
+    struct Department {
+        int id;
+        std::string name;
+    };
+
+    inline auto make_company_storage(const std::string& path) {
+        return make_storage(path,
+                            make_index("idx_employees_department", &Employee::departmentId),
+                            make_table("employees",
+                                       make_column("id", &Employee::id, primary_key()),
+                                       make_column("name", &Employee::name),
+                                       make_column("department_id", &Employee::departmentId)),
+                            make_table("departments",
+                                       make_column("id", &Department::id, primary_key()),
+                                       make_column("name", &Department::name)));
+    }
+
+    using CompanyStorage = decltype(make_company_storage(""));
+}
+
+SQLITE_ORM_EXTERN_STORAGE(CompanyStorage, 3);
+
+TEST_CASE("storage instantiation") {
+    static_assert(std::is_same<internal::storage_db_object_t<CompanyStorage, 2>,
+                               internal::storage_find_table_t<Department, CompanyStorage::db_objects_type>>::value,
+                  "");
+
+    CompanyStorage storage = make_company_storage("");
+    storage.sync_schema();
+    storage.replace(Department{1, "Research"});
+    storage.replace(Employee{1, "Ada", 1});
+    storage.replace(Employee{2, "Grace", 1});
+
+    REQUIRE(storage.count<Employee>(where(c(&Employee::departmentId) == 1)) == 2);
+    REQUIRE(storage.get<Department>(1).name == "Research");
+    REQUIRE(storage.table_exists("employees"));
+}
+
+//  the definition may follow the uses in the same translation unit
+SQLITE_ORM_INSTANTIATE_STORAGE(CompanyStorage, 3);
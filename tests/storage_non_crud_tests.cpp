@@ -626,3 +626,78 @@ TEST_CASE("Explicit insert") {
         }
     }
 }
+
+TEST_CASE("attach database") {
+    struct Customer {
+        int id = 0;
+        std::string name;
+    };
+    struct Invoice {
+        int id = 0;
+        int customerId = 0;
+        int amount = 0;
+    };
+    ::remove("attach_main.sqlite");
+    ::remove("attach_archive.sqlite");
+    auto storage = make_storage(
+        "attach_main.sqlite",
+        make_table("customers", make_column("id", &Customer::id, primary_key()), make_column("name", &Customer::name)),
+        make_table("invoices",
+                   make_column("id", &Invoice::id, primary_key()),
+                   make_column("customer_id", &Invoice::customerId),
+                   make_column("amount", &Invoice::amount))
+            .in_schema("archive"));
+    storage.attach_database("attach_archive.sqlite", "archive");
+    storage.sync_schema();
+
+    SECTION("serialization") {
+        REQUIRE(storage.dump(select(&Invoice::amount)) == R"(SELECT "invoices"."amount" FROM "archive"."invoices")");
+    }
+    SECTION("crud") {
+        storage.replace(Invoice{1, 1, 10});
+        storage.replace(Invoice{2, 1, 20});
+        REQUIRE(storage.count<Invoice>() == 2);
+        storage.update(Invoice{2, 1, 25});
+        REQUIRE(storage.get<Invoice>(2).amount == 25);
+        storage.remove<Invoice>(1);
+        REQUIRE(storage.count<Invoice>() == 1);
+
+        auto archive = make_storage(
+            "attach_archive.sqlite",
+            make_table("invoices",
+                       make_column("id", &Invoice::id, primary_key()),
+                       make_column("customer_id", &Invoice::customerId),
+                       make_column("amount", &Invoice::amount)));
+        REQUIRE(archive.count<Invoice>() == 1);
+        REQUIRE_FALSE(storage.table_exists("invoices"));
+    }
+    SECTION("join") {
+        storage.replace(Customer{1, "Ann"});
+        storage.replace(Invoice{1, 1, 10});
+        storage.replace(Invoice{2, 1, 20});
+        auto rows = storage.select(columns(&Customer::name, sum(&Invoice::amount)),
+                                   inner_join<Invoice>(on(c(&Invoice::customerId) == &Customer::id)),
+                                   group_by(&Customer::name));
+        REQUIRE(rows.size() == 1);
+        REQUIRE(std::get<0>(rows[0]) == "Ann");
+        REQUIRE(*std::get<1>(rows[0]) == 30);
+    }
+    SECTION("sync_schema adds a column in the attached database") {
+        auto storage2 = make_storage(
+            "attach_main.sqlite",
+            make_table("invoices",
+                       make_column("id", &Invoice::id, primary_key()),
+                       make_column("customer_id", &Invoice::customerId),
+                       make_column("amount", &Invoice::amount),
+                       make_column("note", &Invoice::amount, default_value(0)))
+                .in_schema("archive"));
+        storage2.attach_database("attach_archive.sqlite", "archive");
+        auto result = storage2.sync_schema();
+        REQUIRE(result.at("invoices") == sync_schema_result::new_columns_added);
+        REQUIRE(storage2.sync_schema().at("invoices") == sync_schema_result::already_in_sync);
+    }
+    SECTION("detach") {
+        storage.detach_database("archive");
+        REQUIRE_THROWS(storage.count<Invoice>());
+    }
+}
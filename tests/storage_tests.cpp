@@ -1,5 +1,11 @@
 #include <sqlite_orm/sqlite_orm.h>
 #include <catch2/catch_all.hpp>
+#include <cstdio>  //  ::remove
+#include <thread>  //  std::this_thread::get_id, std::this_thread::sleep_for, std::thread
+#include <chrono>  //  std::chrono::milliseconds
+#include <mutex>  //  std::mutex, std::lock_guard, std::unique_lock
+#include <condition_variable>  //  std::condition_variable
+#include <future>  //  std::future
 
 using namespace sqlite_orm;
 
@@ -10,6 +16,558 @@ TEST_CASE("busy handler") {
     });
 }
 
+TEST_CASE("wal checkpoint") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    const char* filename = "wal_checkpoint.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.open_forever();
+    storage.pragma.journal_mode(journal_mode::WAL);
+    storage.sync_schema();
+
+    SECTION("checkpoint") {
+        storage.pragma.wal_autocheckpoint(0);
+        REQUIRE(storage.pragma.wal_autocheckpoint() == 0);
+        storage.replace(User{1, "Alice"});
+        auto result = storage.checkpoint();
+        REQUIRE(result.log_frames > 0);
+        REQUIRE(result.completed());
+
+        result = storage.checkpoint(checkpoint_mode::truncate, "main");
+        REQUIRE(result.log_frames == 0);
+        REQUIRE_FALSE(result.busy);
+    }
+    SECTION("wal hook") {
+        std::vector<int> commits;
+        storage.on_wal_commit([&commits](const std::string& schema, int pages) {
+            REQUIRE(schema == "main");
+            commits.push_back(pages);
+        });
+        storage.replace(User{1, "Alice"});
+        storage.replace(User{2, "Bob"});
+        REQUIRE(commits.size() == 2);
+        REQUIRE(commits[1] > commits[0]);
+
+        storage.on_wal_commit({});
+        storage.replace(User{3, "Carl"});
+        REQUIRE(commits.size() == 2);
+    }
+    SECTION("scheduler") {
+        std::mutex mutex;
+        std::condition_variable checkpointed;
+        std::vector<checkpoint_mode> modes;
+        checkpoint_scheduler_options options;
+        options.wal_pages = 1;
+        options.idle = std::chrono::milliseconds{0};
+        options.on_checkpoint = [&](checkpoint_mode mode, const checkpoint_result&) {
+            std::lock_guard<std::mutex> lock{mutex};
+            modes.push_back(mode);
+            checkpointed.notify_one();
+        };
+        storage.start_checkpoint_scheduler(options);
+        storage.replace(User{1, "Alice"});
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            REQUIRE(checkpointed.wait_for(lock, std::chrono::seconds{10}, [&modes] {
+                return !modes.empty();
+            }));
+            REQUIRE(modes[0] == checkpoint_mode::passive);
+        }
+        storage.stop_checkpoint_scheduler();
+        REQUIRE(storage.count<User>() == 1);
+    }
+}
+
+TEST_CASE("lookaside") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    auto run = [&storage] {
+        storage.sync_schema();
+        for(int id = 1; id <= 10; ++id) {
+            storage.replace(User{id, "user" + std::to_string(id)});
+        }
+        return storage.get_all<User>().size();
+    };
+    SECTION("disabled") {
+        storage.lookaside(0, 0);
+        REQUIRE(run() == 10);
+        REQUIRE(storage.status().connections.lookaside_hit == 0);
+    }
+    SECTION("enabled") {
+        storage.lookaside(256, 100);
+        REQUIRE(run() == 10);
+        //  e.g. Debian builds SQLite without lookaside
+        if(!sqlite3_compileoption_used("OMIT_LOOKASIDE")) {
+            REQUIRE(storage.status().connections.lookaside_hit > 0);
+        }
+    }
+    SECTION("connections opened later") {
+        auto filename = "lookaside.sqlite";
+        ::remove(filename);
+        auto fileStorage = make_storage(filename);
+        fileStorage.lookaside(256, 100);
+        fileStorage.open_forever();
+        REQUIRE(fileStorage.status().connections_count == 1);
+    }
+}
+
+TEST_CASE("configure_memory") {
+    //  SQLite is initialized by the first opened connection, after that it can't be configured
+    auto storage = make_storage({});
+    memory_config config;
+    config.lookaside_slot_size = 128;
+    config.lookaside_slots = 100;
+    REQUIRE_THROWS_AS(configure_memory(config), std::system_error);
+
+    //  nothing to set
+    configure_memory(memory_config{});
+}
+
+TEST_CASE("open options") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    //  `%` has to be escaped in URI filenames
+    const char* filename = "open_options%.sqlite";
+    ::remove(filename);
+    auto makeTable = [] {
+        return make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name));
+    };
+    {
+        auto storage = make_storage(filename, makeTable());
+        storage.sync_schema();
+        storage.replace(User{1, "Alice"});
+    }
+    open_options options;
+    SECTION("readonly") {
+        options.readonly = true;
+        auto storage = make_storage(options, filename, makeTable());
+        REQUIRE(storage.count<User>() == 1);
+        REQUIRE_THROWS_AS(storage.replace(User{2, "Bob"}), std::system_error);
+    }
+    SECTION("immutable") {
+        options.immutable = true;
+        options.nolock = true;
+        auto storage = make_storage(options, filename, makeTable());
+        REQUIRE(storage.get<User>(1).name == "Alice");
+        REQUIRE(storage.filename() == filename);
+    }
+    SECTION("no create") {
+        options.create = false;
+        const char* missingFilename = "open_options_missing.sqlite";
+        ::remove(missingFilename);
+        auto storage = make_storage(options, missingFilename, makeTable());
+        REQUIRE_THROWS_AS(storage.sync_schema(), std::system_error);
+    }
+    SECTION("no mutex pool") {
+        options.no_mutex = true;
+        options.vfs = sqlite3_vfs_find(nullptr)->zName;
+        auto storage = make_storage(pool_options{2}, options, filename, makeTable());
+        std::thread thread{[&storage] {
+            storage.replace(User{2, "Bob"});
+        }};
+        thread.join();
+        REQUIRE(storage.count<User>() == 2);
+    }
+    SECTION("extended result codes") {
+        options.extended_result_codes = true;
+        auto storage = make_storage(options, filename, makeTable());
+        try {
+            storage.insert(User{1, "Alice"}, columns(&User::id, &User::name));
+            FAIL("no constraint error");
+        } catch(const std::system_error& e) {
+            REQUIRE(e.code() == sqlite_errc(SQLITE_CONSTRAINT_PRIMARYKEY));
+        }
+    }
+    SECTION("single process") {
+        options.single_process = true;
+        const std::string shmFilename = std::string{filename} + "-shm";
+        {
+            auto storage = make_storage(pool_options{4}, options, filename, makeTable());
+            storage.pragma.journal_mode(journal_mode::WAL);
+            storage.replace(User{2, "Bob"});
+            REQUIRE(storage.count<User>() == 2);
+            storage.open_forever();
+            REQUIRE(storage.opened_connections_count() == 1);
+            //  WAL without shared memory
+            std::unique_ptr<FILE, int (*)(FILE*)> shm{fopen(shmFilename.c_str(), "rb"), fclose};
+            REQUIRE(shm == nullptr);
+
+            auto other = make_storage(filename, makeTable());
+            REQUIRE_THROWS_AS(other.count<User>(), std::system_error);
+        }
+        auto storage = make_storage(filename, makeTable());
+        REQUIRE(storage.count<User>() == 2);
+        storage.pragma.journal_mode(journal_mode::DELETE);
+    }
+    SECTION("unknown vfs") {
+        options.vfs = "no such vfs";
+        auto storage = make_storage(options, filename, makeTable());
+        REQUIRE_THROWS_AS(storage.count<User>(), std::system_error);
+    }
+}
+
+#if SQLITE_VERSION_NUMBER >= 3010000
+TEST_CASE("shrink_memory") {
+    struct Item {
+        int id = 0;
+        std::string text;
+    };
+    const char* filename = "shrink_memory.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(pool_options{2},
+                                filename,
+                                make_table("items",
+                                           make_column("id", &Item::id, primary_key()),
+                                           make_column("text", &Item::text)));
+    storage.sync_schema();
+    storage.transaction([&storage] {
+        for(int i = 0; i < 1000; ++i) {
+            storage.replace(Item{i, std::string(100, 'x')});
+        }
+        return true;
+    });
+    auto fillCache = [&storage] {
+        REQUIRE(storage.count<Item>(where(c(&Item::text) != "")) == 1000);
+        return storage.status().connections.cache_used;
+    };
+
+    SECTION("shrink_memory") {
+        auto cacheUsed = fillCache();
+        REQUIRE(storage.shrink_memory() == 1);
+        REQUIRE(storage.status().connections.cache_used < cacheUsed);
+    }
+    SECTION("memory pressure") {
+        storage.shrink_on_memory_pressure();
+        auto cacheUsed = fillCache();
+        notify_memory_pressure();
+        REQUIRE(storage.status().connections.cache_used < cacheUsed);
+
+        storage.shrink_on_memory_pressure(false);
+        cacheUsed = fillCache();
+        notify_memory_pressure();
+        REQUIRE(storage.status().connections.cache_used == cacheUsed);
+    }
+    SECTION("heap limits") {
+        const sqlite3_int64 limit = 512 * 1024 * 1024;
+        auto previousSoftLimit = soft_heap_limit(limit);
+        REQUIRE(soft_heap_limit(-1) == limit);
+#if SQLITE_VERSION_NUMBER >= 3031001
+        auto previousHardLimit = hard_heap_limit(2 * limit);
+        REQUIRE(hard_heap_limit(-1) == 2 * limit);
+        hard_heap_limit(previousHardLimit);
+#endif
+        soft_heap_limit(previousSoftLimit);
+    }
+}
+#endif
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+TEST_CASE("on_profile") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+
+    std::vector<statement_profile> profiles;
+    storage.on_profile([&profiles](const statement_profile& profile) {
+        profiles.push_back(profile);
+    });
+    auto users = storage.get_all<User>(where(c(&User::id) > 0));
+    REQUIRE(users.size() == 2);
+    REQUIRE(profiles.size() == 1);
+    REQUIRE(profiles[0].rows == 2);
+    REQUIRE(profiles[0].duration.count() >= 0);
+    REQUIRE(profiles[0].expanded_sql.find("> 0") != std::string::npos);
+    REQUIRE(profiles[0].normalized_sql.find("> ?") != std::string::npos);
+
+    storage.on_profile({});
+    storage.get_all<User>();
+    REQUIRE(profiles.size() == 1);
+}
+#endif
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+TEST_CASE("slow query log") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+
+    slow_query_log_options options;
+    options.threshold = std::chrono::nanoseconds{0};
+    SECTION("top k") {
+        options.top_k = 2;
+        storage.enable_slow_query_log(options);
+        for(int id = 0; id < 3; ++id) {
+            storage.get_all<User>(where(c(&User::id) > id));
+        }
+        auto shapes = storage.slow_queries();
+        REQUIRE(shapes.size() == 1);
+        auto& shape = shapes[0];
+        REQUIRE(shape.sql.find("> ?") != std::string::npos);
+        REQUIRE(shape.count == 3);
+        REQUIRE(shape.slowest.size() == 2);
+        REQUIRE(shape.slowest[0].duration >= shape.slowest[1].duration);
+        REQUIRE(shape.slowest[0].expanded_sql.find("> ?") == std::string::npos);
+#if SQLITE_VERSION_NUMBER >= 3024000
+        REQUIRE(shape.plan.contains("users"));
+#endif
+
+        storage.disable_slow_query_log();
+        storage.get_all<User>();
+        REQUIRE(storage.slow_queries().size() == 1);
+
+        storage.clear_slow_queries();
+        REQUIRE(storage.slow_queries().empty());
+    }
+    SECTION("threshold") {
+        options.threshold = std::chrono::hours{1};
+        storage.enable_slow_query_log(options);
+        storage.get_all<User>();
+        REQUIRE(storage.slow_queries().empty());
+    }
+    SECTION("sampling") {
+        options.sample_rate = 0;
+        storage.enable_slow_query_log(options);
+        storage.get_all<User>();
+        REQUIRE(storage.slow_queries().empty());
+    }
+    SECTION("max shapes") {
+        options.max_shapes = 1;
+        storage.enable_slow_query_log(options);
+        storage.get_all<User>();
+        storage.count<User>();
+        REQUIRE(storage.slow_queries().size() == 1);
+    }
+}
+#endif
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+TEST_CASE("index advisor") {
+    struct User {
+        int id = 0;
+        std::string name;
+        int age = 0;
+    };
+    auto storage = make_storage({},
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("age", &User::age)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice", 30});
+    storage.replace(User{2, "Bob", 40});
+
+    storage.enable_index_advisor();
+    SECTION("equality and range") {
+        for(auto name: {"Alice", "Bob"}) {
+            storage.get_all<User>(where(c(&User::name) == name and c(&User::age) > 18));
+        }
+        storage.get<User>(1);
+        storage.remove_all<User>(where(c(&User::name) == "Carol"));
+
+        auto suggestions = storage.suggest_indexes();
+        REQUIRE(suggestions.size() == 2);
+        auto& first = suggestions[0];
+        REQUIRE(first.table == "users");
+        REQUIRE(first.columns == std::vector<std::string>{"name", "age"});
+        REQUIRE(first.executions == 2);
+        REQUIRE(first.queries.size() == 1);
+        REQUIRE(first.reasons.size() == 1);
+        REQUIRE(first.reasons[0].find("SCAN") == 0);
+        REQUIRE(first.sql() == R"(CREATE INDEX "idx_users_name_age" ON "users" ("name", "age"))");
+        REQUIRE(first.cpp() == R"(make_index("idx_users_name_age", &T::name, &T::age))");
+
+        auto& second = suggestions[1];
+        REQUIRE(second.columns == std::vector<std::string>{"name"});
+        REQUIRE(second.executions == 1);
+
+        auto session = storage.session();
+        REQUIRE(sqlite3_exec(session.get(), first.sql().c_str(), nullptr, nullptr, nullptr) == SQLITE_OK);
+        REQUIRE(storage.suggest_indexes().empty());
+    }
+    SECTION("order by") {
+        storage.get_all<User>(where(c(&User::age) == 30), order_by(&User::name));
+        storage.get_all<User>(order_by(&User::id));
+
+        auto suggestions = storage.suggest_indexes();
+        REQUIRE(suggestions.size() == 1);
+        REQUIRE(suggestions[0].columns == std::vector<std::string>{"age", "name"});
+        REQUIRE(suggestions[0].reasons.size() == 2);
+    }
+    SECTION("disable and clear") {
+        storage.disable_index_advisor();
+        storage.get_all<User>(where(c(&User::name) == "Alice"));
+        REQUIRE(storage.suggest_indexes().empty());
+
+        storage.enable_index_advisor();
+        storage.get_all<User>(where(c(&User::name) == "Alice"));
+        REQUIRE(storage.suggest_indexes().size() == 1);
+        storage.clear_index_advisor();
+        REQUIRE(storage.suggest_indexes().empty());
+    }
+}
+
+TEST_CASE("index advisor automatic index") {
+    struct Customer {
+        int id = 0;
+        std::string name;
+    };
+    struct Order {
+        int id = 0;
+        std::string customerName;
+    };
+    auto storage = make_storage({},
+                                make_table("customers",
+                                           make_column("id", &Customer::id, primary_key()),
+                                           make_column("name", &Customer::name)),
+                                make_table("orders",
+                                           make_column("id", &Order::id, primary_key()),
+                                           make_column("customer_name", &Order::customerName)));
+    storage.sync_schema();
+    storage.replace(Customer{1, "Alice"});
+    storage.replace(Order{1, "Alice"});
+    storage.replace(Order{2, "Alice"});
+
+    std::vector<std::pair<std::string, int>> audited;
+    index_advisor_options options;
+    options.on_automatic_index = [&audited](const std::string& sql, int rows) {
+        audited.emplace_back(sql, rows);
+    };
+    storage.enable_index_advisor(options);
+    for(int i = 0; i < 2; ++i) {
+        auto rows = storage.select(columns(&Customer::name, &Order::id),
+                                   inner_join<Order>(on(c(&Order::customerName) == &Customer::name)));
+        REQUIRE(rows.size() == 2);
+    }
+    REQUIRE(audited.size() == 2);
+    REQUIRE(audited[0].second > 0);
+
+    auto suggestions = storage.suggest_indexes();
+    REQUIRE(suggestions.size() == 1);
+    auto& suggestion = suggestions[0];
+    REQUIRE(suggestion.table == "orders");
+    REQUIRE(suggestion.columns == std::vector<std::string>{"customer_name"});
+    REQUIRE(suggestion.executions == 2);
+    REQUIRE(suggestion.automatic_index_executions == 2);
+    REQUIRE(suggestion.reasons.size() == 1);
+    REQUIRE(suggestion.reasons[0].find("AUTOMATIC") != std::string::npos);
+    REQUIRE(suggestion.cpp() == R"(make_index("idx_orders_customer_name", &T::customer_name))");
+}
+#endif
+
+#if SQLITE_VERSION_NUMBER >= 3010000
+TEST_CASE("status") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    REQUIRE(storage.get<User>(1).name == "Alice");
+
+    auto status = storage.status(true);
+    REQUIRE(status.connections_count == 1);
+    REQUIRE(status.connections.cache_used > 0);
+    REQUIRE(status.connections.schema_used > 0);
+    REQUIRE(status.connections.cache_hit + status.connections.cache_miss > 0);
+    REQUIRE(status.process.memory_used > 0);
+    REQUIRE(status.process.memory_used_highwater >= status.process.memory_used);
+
+    auto afterReset = storage.status();
+    REQUIRE(afterReset.connections.cache_hit == 0);
+    REQUIRE(afterReset.connections.cache_miss == 0);
+}
+#endif
+
+namespace {
+    struct SleepFunction {
+        int operator()(int value) const {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            return value;
+        }
+
+        static const char* name() {
+            return "SLEEP";
+        }
+    };
+}
+
+TEST_CASE("deadline and interrupt") {
+    struct User {
+        int id = 0;
+    };
+    auto storage = make_storage({}, make_table("users", make_column("id", &User::id, primary_key())));
+    storage.sync_schema();
+    storage.transaction([&storage] {
+        for(int i = 1; i <= 500; ++i) {
+            storage.replace(User{i});
+        }
+        return true;
+    });
+    storage.create_scalar_function<SleepFunction>();
+
+    SECTION("deadline") {
+        REQUIRE(storage.with_deadline(std::chrono::seconds{10}, [&storage] {
+            return storage.count<User>();
+        }) == 500);
+
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            storage.with_deadline(std::chrono::milliseconds{20}, [&storage] {
+                storage.select(func<SleepFunction>(&User::id));
+            });
+            FAIL("deadline is not exceeded");
+        } catch(const std::system_error& e) {
+            REQUIRE(e.code() == orm_error_code::deadline_exceeded);
+        }
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds{250});
+
+        //  the deadline is gone after the call
+        REQUIRE(storage.count<User>(where(c(func<SleepFunction>(&User::id)) < 10)) == 9);
+    }
+    SECTION("interrupt") {
+        std::thread interrupter{[&storage] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            storage.interrupt();
+        }};
+        try {
+            storage.select(func<SleepFunction>(&User::id));
+            FAIL("statement is not interrupted");
+        } catch(const std::system_error& e) {
+            REQUIRE(e.code() == std::error_code{sqlite_errc(SQLITE_INTERRUPT)});
+        }
+        interrupter.join();
+    }
+}
+
 TEST_CASE("drop table") {
     struct User {
         int id = 0;
@@ -151,6 +709,61 @@ TEST_CASE("Storage copy") {
     storageCopy.remove_all<User>();
 }
 
+namespace {
+    struct TwiceFunction {
+        int operator()(int value) const {
+            return 2 * value;
+        }
+
+        static const char* name() {
+            return "TWICE";
+        }
+    };
+}
+
+TEST_CASE("Storage fork") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    const char* filename = "storage_fork.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.create_scalar_function<TwiceFunction>();
+    storage.create_collation("reversed", [](int leftLength, const void* lhs, int rightLength, const void* rhs) {
+        return -std::string{(const char*)lhs, size_t(leftLength)}.compare(
+            std::string{(const char*)rhs, size_t(rightLength)});
+    });
+
+    SECTION("shares the schema with forks, not copies") {
+        auto fork = storage.fork();
+        REQUIRE(&obtain_db_objects(fork) == &obtain_db_objects(storage));
+        auto copy = storage;
+        REQUIRE(&obtain_db_objects(copy) != &obtain_db_objects(storage));
+    }
+    SECTION("shares functions and collations") {
+        storage.replace(User{1, "a"});
+        storage.replace(User{2, "b"});
+        auto fork = storage.fork();
+        REQUIRE(fork.select(func<TwiceFunction>(&User::id), order_by(&User::id)) == std::vector<int>{2, 4});
+        REQUIRE(fork.select(&User::name, order_by(&User::name).collate("reversed")) ==
+                std::vector<std::string>{"b", "a"});
+    }
+    SECTION("own connection on another thread") {
+        open_options options;
+        options.no_mutex = true;
+        std::thread worker{[fork = storage.fork(options)]() mutable {
+            fork.replace(User{3, "c"});
+        }};
+        worker.join();
+        REQUIRE(storage.count<User>(where(c(&User::id) == 3)) == 1);
+    }
+    ::remove(filename);
+}
+
 TEST_CASE("column_name") {
     struct User {
         int id = 0;
@@ -216,3 +829,129 @@ TEST_CASE("non-unique DBOs") {
                                       make_column("time", &Record::setTime, &Record::time)));
     db.sync_schema();
 }
+
+TEST_CASE("async calls") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    const auto callerThread = std::this_thread::get_id();
+
+    auto replaced = storage.async([&storage] {
+        storage.replace(User{1, "Alice"});
+        storage.replace(User{2, "Bob"});
+        return std::this_thread::get_id();
+    });
+    REQUIRE(replaced.get() != callerThread);
+
+    auto users = storage.async_get_all<User>(where(c(&User::id) > 1));
+    auto rows = users.get();
+    REQUIRE(rows.size() == 1);
+    REQUIRE(rows.front().name == "Bob");
+
+    auto statement = storage.prepare(select(&User::name, order_by(&User::id)));
+    REQUIRE(storage.async_execute(statement).get() == std::vector<std::string>{"Alice", "Bob"});
+
+    auto failed = storage.async([&storage] {
+        return storage.get<User>(3);
+    });
+    REQUIRE_THROWS_AS(failed.get(), std::system_error);
+
+    SECTION("queued calls outlive the storage") {
+        std::vector<std::future<std::vector<User>>> queued;
+        {
+            auto doomed = make_storage(
+                "",
+                make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+            doomed.sync_schema();
+            doomed.replace(User{1, "Alice"});
+            for(int i = 0; i < 50; ++i) {
+                queued.push_back(doomed.async_get_all<User>());
+            }
+        }
+        for(auto& future: queued) {
+            REQUIRE(future.get().size() == 1);
+        }
+    }
+}
+
+TEST_CASE("session") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    const char* filename = "session.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    REQUIRE_FALSE(storage.is_opened());
+
+    auto opened = storage.opened_connections_count();
+    storage.insert(User{0, "Alice"});
+    storage.insert(User{0, "Bob"});
+    REQUIRE(storage.opened_connections_count() == opened + 2);
+
+    opened = storage.opened_connections_count();
+    {
+        auto statement = [&storage, opened] {
+            auto session = storage.session();
+            REQUIRE(storage.is_opened());
+            storage.insert(User{0, "Carol"});
+            REQUIRE(storage.get<User>(3).name == "Carol");
+            {
+                auto nested = storage.session();
+                storage.update(User{3, "Caroline"});
+            }
+            REQUIRE(storage.is_opened());
+            REQUIRE(storage.count<User>() == 3);
+            REQUIRE(storage.opened_connections_count() == opened + 1);
+            return storage.prepare(get<User>(3));
+        }();
+        //  a prepared statement keeps the connection open beyond the session
+        REQUIRE(storage.is_opened());
+        REQUIRE(storage.execute(statement).name == "Caroline");
+    }
+    REQUIRE_FALSE(storage.is_opened());
+    ::remove(filename);
+}
+
+#ifdef SQLITE_ENABLE_UNLOCK_NOTIFY
+TEST_CASE("unlock notify") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    const char* filename = "unlock_notify.sqlite";
+    ::remove(filename);
+    open_options options;
+    options.shared_cache = true;
+    auto makeStorage = [&options, filename] {
+        return make_storage(
+            options,
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    };
+    auto writer = makeStorage();
+    writer.sync_schema();
+    writer.begin_transaction();
+    writer.insert(User{0, "Alice"});
+
+    //  the reader waits for the write lock of the shared cache instead of failing with SQLITE_LOCKED
+    int count = -1;
+    std::thread reader{[&makeStorage, &count] {
+        auto storage = makeStorage();
+        count = storage.count<User>();
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    writer.commit();
+    reader.join();
+    REQUIRE(count == 1);
+    ::remove(filename);
+}
+#endif
@@ -0,0 +1,70 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+#ifdef SQLITE_ORM_COROUTINES_SUPPORTED
+#include <ranges>  //  std::views::filter, std::views::take
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+}
+
+TEST_CASE("stream") {
+    auto storage = make_storage(
+        {},
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    for(int id = 1; id <= 10; ++id) {
+        storage.replace(User{id, "user" + std::to_string(id)});
+    }
+
+    SECTION("objects") {
+        std::vector<int> ids;
+        for(auto& user: storage.stream<User>(where(c(&User::id) > 7), order_by(&User::id))) {
+            ids.push_back(user.id);
+        }
+        REQUIRE(ids == std::vector<int>{8, 9, 10});
+    }
+    SECTION("one object is reused") {
+        const User* first = nullptr;
+        bool reused = true;
+        for(auto& user: storage.stream<User>()) {
+            if(!first) {
+                first = &user;
+            }
+            reused = reused && first == &user;
+        }
+        REQUIRE(reused);
+    }
+    SECTION("columns") {
+        std::vector<std::string> names;
+        for(auto& [id, name]: storage.stream(select(columns(&User::id, &User::name), where(c(&User::id) <= 2)))) {
+            names.push_back(std::to_string(id) + name);
+        }
+        REQUIRE(names == std::vector<std::string>{"1user1", "2user2"});
+    }
+    SECTION("lazy pipeline stops stepping") {
+        int stepped = 0;
+        auto odd = [&stepped](const User& user) {
+            ++stepped;
+            return user.id % 2 == 1;
+        };
+        std::vector<int> ids;
+        for(auto& user: storage.stream<User>(order_by(&User::id)) | std::views::filter(odd) | std::views::take(2)) {
+            ids.push_back(user.id);
+        }
+        REQUIRE(ids == std::vector<int>{1, 3});
+        //  take() advances the filter past its last row, to the next odd row
+        REQUIRE(stepped == 5);
+    }
+    SECTION("errors are thrown by the iteration") {
+        auto rows = storage.stream(select(&User::id, from<User>(), where(c(&User::id) > 0)));
+        storage.drop_table("users");
+        REQUIRE_THROWS_AS(rows.begin(), std::system_error);
+    }
+}
+#endif
@@ -0,0 +1,164 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <atomic>  //  std::atomic_int
+#include <chrono>  //  std::chrono::milliseconds
+#include <cstdio>  //  ::remove
+#include <string>  //  std::string
+#include <system_error>  //  std::system_error
+#include <thread>  //  std::thread, std::this_thread::sleep_for
+#include <vector>  //  std::vector
+
+using namespace sqlite_orm;
+
+/**
+ *  Several threads doing mixed CRUD on one storage. Build with `SQLITE_ORM_TSAN_STRESS_TESTS` to run them under
+ *  ThreadSanitizer, which fails them on data races the final checks can't see.
+ */
+namespace {
+    struct Account {
+        int id = 0;
+        int owner = 0;
+        int balance = 0;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Account() = default;
+        Account(int id, int owner, int balance) : id{id}, owner{owner}, balance{balance} {}
+#endif
+    };
+
+    const int threadsCount = 8;
+    const int accountsPerThread = 50;
+
+    auto make_table_of_accounts() {
+        return make_table("accounts",
+                          make_column("id", &Account::id, primary_key()),
+                          make_column("owner", &Account::owner),
+                          make_column("balance", &Account::balance));
+    }
+
+    /**
+     *  Every thread works on accounts of its own, so the expected totals don't depend on the interleaving.
+     *  Ids are given explicitly: threads sharing a connection can't tell whose row `last_insert_rowid()` is.
+     *  A thread creates its accounts, deposits into each of them twice, reads them back and closes every
+     *  second one.
+     */
+    template<class S>
+    void run_mixed_crud(S& storage) {
+        std::vector<std::thread> threads;
+        std::vector<int> failures(threadsCount);
+        for(int owner = 0; owner < threadsCount; ++owner) {
+            threads.emplace_back([&storage, &failures, owner] {
+                const int firstId = owner * accountsPerThread + 1;
+                for(int id = firstId; id < firstId + accountsPerThread; ++id) {
+                    storage.replace(Account{id, owner, 0});
+                }
+                for(int round = 0; round < 2; ++round) {
+                    for(int id = firstId; id < firstId + accountsPerThread; ++id) {
+                        auto account = storage.template get<Account>(id);
+                        account.balance += id;
+                        storage.update(account);
+                    }
+                }
+                auto accounts = storage.template get_all<Account>(where(c(&Account::owner) == owner));
+                for(auto& account: accounts) {
+                    if(account.balance != 2 * account.id) {
+                        ++failures[owner];
+                    }
+                    if(account.id % 2) {
+                        storage.template remove<Account>(account.id);
+                    }
+                }
+                if(int(accounts.size()) != accountsPerThread) {
+                    ++failures[owner];
+                }
+            });
+        }
+        for(auto& thread: threads) {
+            thread.join();
+        }
+        REQUIRE(failures == std::vector<int>(threadsCount));
+
+        //  the even ids are left, each with twice its id
+        const int accountsCount = threadsCount * accountsPerThread;
+        REQUIRE(storage.template count<Account>() == accountsCount / 2);
+        const auto total = storage.total(&Account::balance);
+        REQUIRE(int(total) == 2 * (accountsCount / 2) * (accountsCount / 2 + 1));
+    }
+}
+
+TEST_CASE("stress") {
+    const std::string filename = "stress.sqlite";
+    ::remove(filename.c_str());
+    ::remove((filename + "-wal").c_str());
+    ::remove((filename + "-shm").c_str());
+
+    SECTION("shared connection opened per call") {
+        //  the connection opens and closes while other threads retain and release it
+        auto storage = make_storage(filename, make_table_of_accounts());
+        storage.sync_schema();
+        run_mixed_crud(storage);
+    }
+    SECTION("shared connection opened forever") {
+        auto storage = make_storage(filename, make_table_of_accounts());
+        storage.open_forever();
+        storage.sync_schema();
+        run_mixed_crud(storage);
+    }
+    SECTION("pooled connections") {
+        auto storage = make_storage(pool_options{4}, filename, make_table_of_accounts());
+        storage.on_open = [](sqlite3* db) {
+            sqlite3_busy_timeout(db, 5000);
+        };
+        storage.pragma.journal_mode(journal_mode::WAL);
+        storage.sync_schema();
+        run_mixed_crud(storage);
+    }
+    SECTION("pooled connections with a statement cache") {
+        auto storage = make_storage(pool_options{4}, filename, make_table_of_accounts());
+        storage.on_open = [](sqlite3* db) {
+            sqlite3_busy_timeout(db, 5000);
+        };
+        storage.pragma.journal_mode(journal_mode::WAL);
+        storage.enable_statement_cache(16);
+        storage.sync_schema();
+        run_mixed_crud(storage);
+    }
+    ::remove(filename.c_str());
+    ::remove((filename + "-wal").c_str());
+    ::remove((filename + "-shm").c_str());
+}
+
+TEST_CASE("stress connection set up before it is shared") {
+    struct Scratch {
+        int value = 0;
+    };
+    const std::string filename = "stress_setup.sqlite";
+    ::remove(filename.c_str());
+    //  the table exists only on connections `on_open` has set up
+    auto storage = make_storage(filename, make_table("scratch", make_column("value", &Scratch::value)));
+    std::atomic_int opensCount{0};
+    storage.on_open = [&opensCount](sqlite3* db) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        sqlite3_exec(db, "CREATE TEMP TABLE scratch (value INTEGER)", nullptr, nullptr, nullptr);
+        ++opensCount;
+    };
+    std::vector<std::thread> threads;
+    std::atomic_int failuresCount{0};
+    for(int i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&storage, &failuresCount] {
+            for(int call = 0; call < 100; ++call) {
+                try {
+                    storage.count<Scratch>();
+                } catch(const std::system_error&) {
+                    ++failuresCount;
+                }
+            }
+        });
+    }
+    for(auto& thread: threads) {
+        thread.join();
+    }
+    REQUIRE(failuresCount == 0);
+    REQUIRE(opensCount > 0);
+    ::remove(filename.c_str());
+}
@@ -554,3 +554,236 @@ TEST_CASE("sync_schema with generated columns") {
     }
 }
 #endif
+
+#if SQLITE_VERSION_NUMBER >= 3037000
+TEST_CASE("sync_schema table options") {
+    struct Sample {
+        int sensorId = 0;
+        int time = 0;
+        double value = 0;
+    };
+    auto storagePath = "sync_schema_table_options.sqlite";
+    ::remove(storagePath);
+    auto makeTable = [] {
+        return make_table("samples",
+                          make_column("sensor_id", &Sample::sensorId),
+                          make_column("time", &Sample::time),
+                          make_column("value", &Sample::value),
+                          primary_key(&Sample::sensorId, &Sample::time));
+    };
+    {
+        auto storage = make_storage(storagePath, makeTable());
+        storage.sync_schema();
+        storage.replace(Sample{1, 10, 0.5});
+        storage.replace(Sample{1, 20, 1.5});
+    }
+    SECTION("strict without rowid") {
+        auto storage = make_storage(storagePath, makeTable().strict().without_rowid());
+        REQUIRE(storage.sync_schema_simulate(true).at("samples") == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage.sync_schema(true).at("samples") == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage.sync_schema(true).at("samples") == sync_schema_result::already_in_sync);
+        REQUIRE(storage.count<Sample>() == 2);
+        REQUIRE_THROWS_AS(storage.insert(into<Sample>(),
+                                         columns(&Sample::sensorId, &Sample::time, &Sample::value),
+                                         values(std::make_tuple(1, 30, "text"))),
+                          std::system_error);
+        REQUIRE_THROWS(storage.select(rowid<Sample>()));
+
+        auto storage2 = make_storage(storagePath, makeTable());
+        REQUIRE(storage2.sync_schema(true).at("samples") == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage2.count<Sample>() == 2);
+        REQUIRE(storage2.select(rowid<Sample>()).size() == 2);
+    }
+    SECTION("without preserve") {
+        auto storage = make_storage(storagePath, makeTable().strict());
+        REQUIRE(storage.sync_schema().at("samples") == sync_schema_result::dropped_and_recreated);
+        REQUIRE(storage.count<Sample>() == 0);
+    }
+}
+#endif
+
+TEST_CASE("sync_schema_if_changed") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storagePath = "sync_schema_if_changed.sqlite";
+    ::remove(storagePath);
+    auto makeTable = [] {
+        return make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name));
+    };
+    {
+        auto storage = make_storage(storagePath, makeTable());
+        REQUIRE(storage.sync_schema_if_changed().at("users") == sync_schema_result::new_table_created);
+        REQUIRE(storage.pragma.user_version() == storage.schema_fingerprint());
+    }
+    SECTION("unchanged") {
+        auto storage = make_storage(storagePath, makeTable());
+        storage.drop_table("users");
+        REQUIRE(storage.sync_schema_if_changed().at("users") == sync_schema_result::already_in_sync);
+        REQUIRE_FALSE(storage.table_exists("users"));
+    }
+    SECTION("changed") {
+        auto storage = make_storage(storagePath, make_index("idx_users_name", &User::name), makeTable());
+        REQUIRE(storage.schema_fingerprint() != make_storage(storagePath, makeTable()).schema_fingerprint());
+        auto result = storage.sync_schema_if_changed();
+        REQUIRE(result.at("users") == sync_schema_result::already_in_sync);
+        REQUIRE(result.at("idx_users_name") == sync_schema_result::already_in_sync);
+        REQUIRE(storage.pragma.user_version() == storage.schema_fingerprint());
+    }
+}
+
+TEST_CASE("sync_schema transaction") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    struct Post {
+        int id = 0;
+        std::string title;
+    };
+    auto storagePath = "sync_schema_transaction.sqlite";
+    ::remove(storagePath);
+    auto makeUsers = [] {
+        return make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name));
+    };
+    {
+        auto storage = make_storage(storagePath, makeUsers());
+        storage.sync_schema();
+        storage.insert(User{0, "Alice"});
+        storage.insert(User{0, "Alice"});
+    }
+    auto storage = make_storage(storagePath,
+                                make_unique_index("idx_users_name", &User::name),
+                                make_table("posts", make_column("id", &Post::id), make_column("title", &Post::title)),
+                                makeUsers());
+    SECTION("rolled back") {
+        REQUIRE_THROWS_AS(storage.sync_schema(), std::system_error);
+        REQUIRE_FALSE(storage.table_exists("posts"));
+    }
+    SECTION("opt-out") {
+        storage.sync_schema_in_transaction = false;
+        REQUIRE_THROWS_AS(storage.sync_schema(), std::system_error);
+        REQUIRE(storage.table_exists("posts"));
+    }
+    SECTION("inside a transaction") {
+        auto guard = storage.transaction_guard();
+        storage.remove_all<User>();
+        REQUIRE(storage.sync_schema().at("posts") == sync_schema_result::new_table_created);
+        guard.commit();
+        REQUIRE(storage.table_exists("posts"));
+    }
+}
+
+TEST_CASE("schema cache") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storagePath = "schema_cache.sqlite";
+    ::remove(storagePath);
+    auto storage = make_storage(
+        storagePath,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.open_forever();
+    storage.sync_schema();
+    REQUIRE(storage.table_exists("users"));
+    REQUIRE(storage.table_names() == std::vector<std::string>{"users"});
+    REQUIRE(storage.pragma.table_info("users").size() == 2);
+    REQUIRE(storage.pragma.table_xinfo("users").size() == 2);
+
+    SECTION("changes of other connections") {
+        auto other = make_storage(storagePath);
+        other.rename_table("users", "people");
+        REQUIRE_FALSE(storage.table_exists("users"));
+        REQUIRE(storage.table_names() == std::vector<std::string>{"people"});
+        REQUIRE(storage.pragma.table_info("people").size() == 2);
+    }
+    SECTION("own DDL") {
+        storage.drop_table("users");
+        REQUIRE_FALSE(storage.table_exists("users"));
+        REQUIRE(storage.sync_schema().at("users") == sync_schema_result::new_table_created);
+        REQUIRE(storage.table_exists("users"));
+    }
+    SECTION("rolled back DDL") {
+        storage.begin_transaction();
+        storage.drop_table("users");
+        REQUIRE_FALSE(storage.table_exists("users"));
+        storage.rollback();
+        REQUIRE(storage.table_exists("users"));
+        //  the schema version the transaction had
+        make_storage(storagePath).rename_table("users", "people");
+        REQUIRE_FALSE(storage.table_exists("users"));
+        REQUIRE(storage.table_exists("people"));
+    }
+#if SQLITE_VERSION_NUMBER >= 3026000
+    SECTION("read once") {
+        std::vector<std::string> sqls;
+        storage.on_profile([&sqls](const statement_profile& profile) {
+            sqls.push_back(profile.normalized_sql);
+        });
+        REQUIRE(storage.table_exists("users"));
+        REQUIRE(storage.pragma.table_xinfo("users").size() == 2);
+        storage.on_profile({});
+        REQUIRE(sqls.size() == 2);
+        for(auto& sql: sqls) {
+            REQUIRE(sql.find("schema_version") != std::string::npos);
+        }
+    }
+#endif
+    ::remove(storagePath);
+}
+
+TEST_CASE("rebuild_table_online") {
+    struct Sample {
+        int id = 0;
+        int value = 0;
+        std::string note;
+    };
+    auto storagePath = "rebuild_table_online.sqlite";
+    ::remove(storagePath);
+    {
+        auto storage = make_storage(
+            storagePath,
+            make_table("samples", make_column("id", &Sample::id, primary_key()), make_column("value", &Sample::value)));
+        storage.sync_schema();
+        storage.transaction([&storage] {
+            for(int i = 1; i <= 250; ++i) {
+                storage.insert(Sample{0, i, {}});
+            }
+            return true;
+        });
+    }
+    auto storage = make_storage(storagePath,
+                                make_table("samples",
+                                           make_column("id", &Sample::id, primary_key()),
+                                           make_column("value", &Sample::value),
+                                           make_column("note", &Sample::note, default_value("none"))));
+    REQUIRE(storage.sync_schema_simulate(true).at("samples") == sync_schema_result::new_columns_added);
+
+    auto writer = make_storage(
+        storagePath,
+        make_table("samples", make_column("id", &Sample::id, primary_key()), make_column("value", &Sample::value)));
+    std::vector<size_t> progress;
+    storage.rebuild_table_online<Sample>(100, [&writer, &progress](size_t copiedCount) {
+        if(progress.empty()) {
+            //  rows written while the table is copied: in a copied chunk, in a chunk to copy and new ones
+            writer.update_all(set(c(&Sample::value) = 1000), where(c(&Sample::id) == 50));
+            writer.update_all(set(c(&Sample::value) = 2000), where(c(&Sample::id) == 150));
+            writer.remove<Sample>(10);
+            writer.insert(Sample{0, 3000, {}});
+        }
+        progress.push_back(copiedCount);
+    });
+    REQUIRE(progress.front() == 100);
+    REQUIRE(progress.back() >= 249);
+    REQUIRE(storage.sync_schema_simulate(true).at("samples") == sync_schema_result::already_in_sync);
+    REQUIRE(storage.count<Sample>() == 250);
+    REQUIRE(storage.get<Sample>(50).value == 1000);
+    REQUIRE(storage.get<Sample>(150).value == 2000);
+    REQUIRE(storage.get<Sample>(251).value == 3000);
+    REQUIRE(storage.get<Sample>(251).note == "none");
+    REQUIRE_FALSE(storage.get_pointer<Sample>(10));
+    REQUIRE_FALSE(storage.table_exists("samples_rebuild"));
+    REQUIRE_FALSE(storage.table_exists("samples_rebuild_delta"));
+}
@@ -207,3 +207,26 @@ TEST_CASE("for_each_foreign_key") {
     });
     REQUIRE(visitCallsCount == 1);
 }
+
+#ifdef SQLITE_ORM_CLASSTYPE_TEMPLATE_ARGS_SUPPORTED
+TEST_CASE("fixed names") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto table = make_table<"users">(make_column<"id">(&User::id, primary_key()), make_column<"name">(&User::name));
+    STATIC_REQUIRE(std::is_same<decltype(table), decltype(make_table("users",
+                                                                      make_column("id", &User::id, primary_key()),
+                                                                      make_column("name", &User::name)))>::value);
+    REQUIRE(table.name == "users");
+    REQUIRE(*table.find_column_name(&User::name) == "name");
+
+    auto explicitTable = make_table<"people", User>(make_column<"id">(&User::id, primary_key()));
+    REQUIRE(explicitTable.name == "people");
+
+    auto storage = make_storage("", std::move(table));
+    storage.sync_schema();
+    storage.insert(User{0, "Ann"});
+    REQUIRE(storage.get<User>(1).name == "Ann");
+}
+#endif
@@ -0,0 +1,72 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+
+    struct WantedId {
+        int id = 0;
+    };
+}
+
+TEST_CASE("with_temp_table") {
+    const std::string filename = "temp_table.sqlite";
+    ::remove(filename.c_str());
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)),
+        make_table("wanted_ids", make_column("id", &WantedId::id)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.replace(User{3, "Carol"});
+    storage.insert(WantedId{9});
+    const std::vector<WantedId> wanted{{3}, {1}};
+
+    SECTION("join") {
+        auto names = storage.with_temp_table<WantedId>(wanted, [&storage](const temp_table& tmp) {
+            REQUIRE(tmp.name == "wanted_ids");
+            REQUIRE(tmp.rows_count == 2);
+            return storage.select(&User::name,
+                                  inner_join<WantedId>(on(c(&WantedId::id) == &User::id)),
+                                  order_by(&User::id));
+        });
+        REQUIRE(names == std::vector<std::string>{"Alice", "Carol"});
+        REQUIRE(storage.select(&WantedId::id) == std::vector<int>{9});
+    }
+    SECTION("many rows") {
+        std::vector<WantedId> many;
+        for(int i = 1; i <= 10000; ++i) {
+            many.push_back({i});
+        }
+        storage.with_temp_table<WantedId>(many, [&storage](const temp_table&) {
+            REQUIRE(storage.count<WantedId>() == 10000);
+            REQUIRE(storage.pragma.temp_store() == 2);
+        });
+        REQUIRE(storage.count<WantedId>() == 1);
+        REQUIRE(storage.pragma.temp_store() == 0);
+    }
+    SECTION("empty range") {
+        auto count = storage.with_temp_table<WantedId>(std::vector<WantedId>{}, [&storage](const temp_table&) {
+            return storage.count<WantedId>();
+        });
+        REQUIRE(count == 0);
+    }
+    SECTION("dropped when f throws") {
+        REQUIRE_THROWS_AS(storage.with_temp_table<WantedId>(wanted,
+                                                            [](const temp_table&) {
+                                                                throw std::runtime_error("failed");
+                                                            }),
+                          std::runtime_error);
+        REQUIRE(storage.select(&WantedId::id) == std::vector<int>{9});
+        storage.with_temp_table<WantedId>(wanted, [&storage](const temp_table&) {
+            REQUIRE(storage.count<WantedId>() == 2);
+        });
+    }
+    ::remove(filename.c_str());
+}
@@ -0,0 +1,93 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <cstdio>  //  std::remove
+#include <thread>  //  std::this_thread
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Note {
+        int id = 0;
+        std::string text;
+    };
+
+    std::string tenant_file(const std::string& tenant) {
+        return "tenant_" + tenant + ".sqlite";
+    }
+}
+
+TEST_CASE("tenant storage manager") {
+    const std::vector<std::string> names{"a", "b", "c"};
+    for(auto& name: names) {
+        std::remove(tenant_file(name).c_str());
+    }
+    tenant_options options;
+    options.max_open = 2;
+    auto tenants = make_tenant_storage_manager(
+        tenant_file,
+        options,
+        make_table("notes", make_column("id", &Note::id, primary_key()), make_column("text", &Note::text)));
+
+    SECTION("one file per tenant, schema shared") {
+        for(auto& name: names) {
+            tenants.storage(name)->replace(Note{1, name});
+        }
+        for(auto& name: names) {
+            auto storage = tenants.storage(name);
+            REQUIRE(storage->filename() == tenant_file(name));
+            REQUIRE(storage->get<Note>(1).text == name);
+            REQUIRE(&obtain_db_objects(*storage) == &obtain_db_objects(tenants.schema()));
+        }
+    }
+    SECTION("least recently used tenant is closed") {
+        tenants.storage("a");
+        tenants.storage("b");
+        tenants.storage("a");
+        tenants.storage("c");
+        REQUIRE(tenants.open_count() == 2);
+        REQUIRE(tenants.stats("a").open);
+        REQUIRE_FALSE(tenants.stats("b").open);
+        REQUIRE(tenants.stats("b").evictions == 1);
+        REQUIRE(tenants.stats("a").hits == 1);
+
+        tenants.storage("b");
+        auto stats = tenants.stats("b");
+        REQUIRE(stats.opens == 2);
+        REQUIRE(stats.schema_synced);
+        REQUIRE(stats.schema_changed);
+        REQUIRE(tenants.stats("unknown").opens == 0);
+    }
+    SECTION("a held storage outlives its eviction") {
+        auto storage = tenants.storage("a");
+        tenants.close_all();
+        REQUIRE(tenants.open_count() == 0);
+        storage->replace(Note{2, "still open"});
+        REQUIRE(tenants.storage("a")->count<Note>() == 1);
+    }
+    SECTION("schema in sync is not synced again") {
+        tenants.storage("a");
+        auto other = make_tenant_storage_manager(
+            tenant_file,
+            options,
+            make_table("notes", make_column("id", &Note::id, primary_key()), make_column("text", &Note::text)));
+        other.storage("a");
+        REQUIRE(other.stats("a").schema_synced);
+        REQUIRE_FALSE(other.stats("a").schema_changed);
+    }
+    SECTION("idle timeout") {
+        options.idle_timeout = std::chrono::milliseconds{1};
+        auto idle = make_tenant_storage_manager(
+            tenant_file,
+            options,
+            make_table("notes", make_column("id", &Note::id, primary_key()), make_column("text", &Note::text)));
+        idle.storage("a");
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        idle.close_idle();
+        REQUIRE(idle.open_count() == 0);
+        REQUIRE(idle.stats("a").evictions == 1);
+    }
+    tenants.close_all();
+    for(auto& name: names) {
+        std::remove(tenant_file(name).c_str());
+    }
+}
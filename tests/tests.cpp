@@ -217,6 +217,65 @@ TEST_CASE("Custom collate") {
     REQUIRE(rows.size() == static_cast<size_t>(storage.count<Item>()));
 }
 
+TEST_CASE("Collation object") {
+    struct Item {
+        int id;
+        std::string name;
+    };
+
+    struct CountingCollation {
+        static int& constructions() {
+            static int value = 0;
+            return value;
+        }
+
+        CountingCollation() {
+            ++constructions();
+        }
+
+        int operator()(int leftLength, const void* lhs, int rightLength, const void* rhs) const {
+            return ::strcmp(std::string((const char*)lhs, leftLength).c_str(),
+                            std::string((const char*)rhs, rightLength).c_str());
+        }
+
+        static const char* name() {
+            return "counting";
+        }
+    };
+
+    auto storage = make_storage(
+        "",
+        make_table("items", make_column("id", &Item::id, primary_key()), make_column("name", &Item::name)));
+    storage.sync_schema();
+    for(auto name: {"Venus", "Earth", "Mars", "Mercury"}) {
+        storage.insert(Item{0, name});
+    }
+
+    CountingCollation::constructions() = 0;
+    storage.create_collation<CountingCollation>();
+    auto rows = storage.select(&Item::name, order_by(&Item::name).collate<CountingCollation>());
+    REQUIRE(rows == std::vector<std::string>{"Earth", "Mars", "Mercury", "Venus"});
+    REQUIRE(CountingCollation::constructions() == 1);
+
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+    struct ReverseCollation {
+        int operator()(std::string_view lhs, std::string_view rhs) const {
+            return rhs.compare(lhs);
+        }
+
+        static const char* name() {
+            return "reverse";
+        }
+    };
+
+    storage.create_collation<ReverseCollation>();
+    rows = storage.select(&Item::name, order_by(&Item::name).collate<ReverseCollation>());
+    REQUIRE(rows == std::vector<std::string>{"Venus", "Mercury", "Mars", "Earth"});
+    rows = storage.select(&Item::name, where(is_equal(&Item::name, "Mars").collate<ReverseCollation>()));
+    REQUIRE(rows == std::vector<std::string>{"Mars"});
+#endif
+}
+
 TEST_CASE("Vacuum") {
     struct Item {
         int id;
@@ -235,3 +294,60 @@ TEST_CASE("Vacuum") {
     storage.remove_all<Item>();
     storage.vacuum();
 }
+
+TEST_CASE("incremental_vacuum") {
+    struct Item {
+        int id;
+        std::string name;
+    };
+    auto filename = "incremental_vacuum.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("items", make_column("id", &Item::id, primary_key()), make_column("name", &Item::name)));
+    storage.pragma.auto_vacuum(2);
+    storage.sync_schema();
+    storage.transaction([&storage] {
+        for(int i = 0; i < 200; ++i) {
+            storage.insert(Item{0, std::string(200, 'x')});
+        }
+        return true;
+    });
+    storage.remove_all<Item>();
+    auto freePages = storage.pragma.freelist_count();
+    REQUIRE(freePages > 2);
+    auto pageCount = storage.pragma.page_count();
+
+    storage.incremental_vacuum(2);
+    REQUIRE(storage.pragma.freelist_count() == freePages - 2);
+    REQUIRE(storage.pragma.page_count() == pageCount - 2);
+
+    storage.incremental_vacuum();
+    REQUIRE(storage.pragma.freelist_count() == 0);
+}
+
+#if SQLITE_VERSION_NUMBER >= 3027000
+TEST_CASE("vacuum_into") {
+    struct Item {
+        int id;
+        std::string name;
+    };
+    auto makeStorage = [](std::string filename) {
+        return make_storage(
+            std::move(filename),
+            make_table("items", make_column("id", &Item::id, primary_key()), make_column("name", &Item::name)));
+    };
+    auto copyFilename = "vacuum_into.sqlite";
+    ::remove(copyFilename);
+    auto storage = makeStorage({});
+    storage.sync_schema();
+    storage.insert(Item{0, "One"});
+    storage.insert(Item{0, "Two"});
+    storage.vacuum_into(copyFilename);
+    REQUIRE_THROWS_AS(storage.vacuum_into(copyFilename), std::system_error);
+
+    auto copy = makeStorage(copyFilename);
+    REQUIRE(copy.count<Item>() == 2);
+    REQUIRE(copy.get<Item>(2).name == "Two");
+}
+#endif
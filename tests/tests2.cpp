@@ -5,6 +5,8 @@
 #endif  // SQLITE_ORM_OPTIONAL_SUPPORTED
 #include <memory>  // std::default_delete
 #include <stdlib.h>  // free()
+#include <algorithm>  // std::transform, std::mismatch
+#include <cctype>  // std::tolower
 
 using namespace sqlite_orm;
 using std::default_delete;
@@ -67,6 +69,65 @@ TEST_CASE("Remove") {
         REQUIRE(storage.count<Object>() == 1);
     }
 }
+
+TEST_CASE("remove_range and get_range") {
+    struct Object {
+        int id = 0;
+        std::string name;
+    };
+    SECTION("single column primary key") {
+        auto storage = make_storage(
+            "",
+            make_table("objects", make_column("id", &Object::id, primary_key()), make_column("name", &Object::name)));
+        storage.sync_schema();
+        for(int id = 1; id <= 10; ++id) {
+            storage.replace(Object{id, "object" + std::to_string(id)});
+        }
+        //  three keys per IN list
+        storage.limit.variable_number(3);
+
+        std::vector<int> ids{9, 2, 5, 11, 7, 1, 3};
+        auto objects = storage.get_range<Object>(ids.begin(), ids.end());
+        REQUIRE(objects.size() == 6);
+        REQUIRE(objects.count(11) == 0);
+        REQUIRE(objects.at(5).name == "object5");
+        REQUIRE(objects.at(9).id == 9);
+
+        storage.remove_range<Object>(ids.begin(), ids.end());
+        REQUIRE(storage.select(&Object::id, order_by(&Object::id)) == std::vector<int>{4, 6, 8, 10});
+        storage.remove_range<Object>(ids.begin(), ids.begin());
+        REQUIRE(storage.count<Object>() == 4);
+    }
+#if SQLITE_VERSION_NUMBER >= 3015000
+    SECTION("composite primary key") {
+        auto storage = make_storage("",
+                                    make_table("objects",
+                                               make_column("id", &Object::id),
+                                               make_column("name", &Object::name),
+                                               primary_key(&Object::id, &Object::name)));
+        storage.sync_schema();
+        storage.replace(Object{1, "a"});
+        storage.replace(Object{1, "b"});
+        storage.replace(Object{2, "a"});
+        storage.limit.variable_number(4);
+
+        std::vector<std::tuple<int, std::string>> keys{{1, "b"}, {2, "a"}, {2, "b"}};
+        auto objects = storage.get_range<Object>(keys.begin(), keys.end());
+        REQUIRE(objects.size() == 2);
+        REQUIRE(objects.count(std::make_tuple(1, std::string{"b"})) == 1);
+
+        storage.remove_range<Object>(keys.begin(), keys.end());
+        auto rest = storage.get_all<Object>();
+        REQUIRE(rest.size() == 1);
+        REQUIRE(rest[0].name == "a");
+        REQUIRE(rest[0].id == 1);
+
+        std::vector<int> ids{1};
+        REQUIRE_THROWS_AS(storage.remove_range<Object>(ids.begin(), ids.end()), std::system_error);
+    }
+#endif
+}
+
 #if SQLITE_VERSION_NUMBER >= 3031000
 TEST_CASE("insert with generated column") {
     struct Product {
@@ -112,6 +173,42 @@ TEST_CASE("insert with generated column") {
     expectedProducts.push_back({"ABC Widget", 100, 0.05, 0.07, 101.65});
     REQUIRE(allProducts == expectedProducts);
 }
+
+TEST_CASE("read-only generated column") {
+    struct Product {
+        int id = 0;
+        std::string name;
+
+        const std::string& key() const {
+            return this->_key;
+        }
+
+      private:
+        std::string _key;
+    };
+    auto storage = make_storage({},
+                                make_index("idx_products_key", &Product::key),
+                                make_table("products",
+                                           make_column("id", &Product::id, primary_key()),
+                                           make_column("name", &Product::name),
+                                           make_column("key", &Product::key, as(lower(&Product::name)).stored())));
+    storage.sync_schema();
+    Product product;
+    product.name = "ABC Widget";
+    product.id = storage.insert(product);
+    REQUIRE(product.key().empty());
+
+    product = storage.get<Product>(product.id);
+    REQUIRE(product.key() == "abc widget");
+
+    product.name = "XYZ Gadget";
+    storage.update(product);
+    REQUIRE(storage.get<Product>(product.id).key() == "xyz gadget");
+    REQUIRE(storage.get_all<Product>(where(c(&Product::key) == "xyz gadget")).size() == 1);
+    REQUIRE(storage.select(&Product::key) == std::vector<std::string>{"xyz gadget"});
+    REQUIRE(storage.explain_query_plan(get_all<Product>(where(c(&Product::key) == "xyz gadget")))
+                .contains("USING INDEX idx_products_key"));
+}
 #endif
 TEST_CASE("insert") {
     struct Object {
@@ -189,6 +286,62 @@ TEST_CASE("insert") {
     REQUIRE(storage.get<ObjectWithoutRowid>(20).name == "Death");
 }
 
+TEST_CASE("insert_range in chunks") {
+    struct Person {
+        int id = 0;
+        std::string name;
+        int age = 0;
+    };
+    auto storage = make_storage("",
+                                make_table("persons",
+                                           make_column("id", &Person::id, primary_key()),
+                                           make_column("name", &Person::name, unique()),
+                                           make_column("age", &Person::age)));
+    storage.sync_schema();
+
+    std::vector<Person> persons;
+    for(int i = 1; i <= 7; ++i) {
+        persons.push_back(Person{i, "Person" + std::to_string(i), 20 + i});
+    }
+    //  two rows per INSERT and one row per REPLACE
+    storage.limit.variable_number(5);
+
+    SECTION("insert") {
+        storage.insert_range(persons.begin(), persons.end());
+        auto rows = storage.select(columns(&Person::name, &Person::age), order_by(&Person::id));
+        REQUIRE(rows.size() == persons.size());
+        for(size_t i = 0; i < rows.size(); ++i) {
+            REQUIRE(std::get<0>(rows[i]) == persons[i].name);
+            REQUIRE(std::get<1>(rows[i]) == persons[i].age);
+        }
+    }
+    SECTION("replace") {
+        storage.replace_range(persons.begin(), persons.end());
+        REQUIRE(storage.select(&Person::id) == std::vector<int>{1, 2, 3, 4, 5, 6, 7});
+    }
+    SECTION("inside a transaction") {
+        storage.begin_transaction();
+        storage.replace_range(persons.begin(), persons.end());
+        REQUIRE(storage.count<Person>() == 7);
+        storage.rollback();
+        REQUIRE(storage.count<Person>() == 0);
+    }
+    SECTION("failing chunk rolls back the whole range") {
+        persons.back().name = persons.front().name;
+        REQUIRE_THROWS_AS(storage.insert_range(persons.begin(), persons.end()), std::system_error);
+        REQUIRE(storage.count<Person>() == 0);
+    }
+    SECTION("or ignore skips duplicates") {
+        storage.insert(Person{0, "Person2", 0});
+        persons.push_back(Person{8, "Person5", 0});
+        persons.push_back(Person{9, "Person9", 29});
+        REQUIRE(storage.insert_range(persons.begin(), persons.end(), or_ignore()) == 7);
+        REQUIRE(storage.count<Person>() == 8);
+        REQUIRE(storage.get_all<Person>(where(c(&Person::age) == 0)).size() == 1);
+        REQUIRE(storage.insert_range(persons.begin(), persons.end(), or_ignore()) == 0);
+    }
+}
+
 struct SqrtFunction {
     static int callsCount;
 
@@ -404,8 +557,9 @@ TEST_CASE("custom functions") {
     REQUIRE(HasPrefixFunction::callsCount == 0);
     REQUIRE(HasPrefixFunction::objectsCount == 0);
     storage.create_scalar_function<HasPrefixFunction>();
+    //  the function has no state so a single object serves all calls
     REQUIRE(HasPrefixFunction::callsCount == 0);
-    REQUIRE(HasPrefixFunction::objectsCount == 0);
+    REQUIRE(HasPrefixFunction::objectsCount == 1);
 
     //  call after creation
     {
@@ -415,7 +569,7 @@ TEST_CASE("custom functions") {
         REQUIRE(rows == expected);
     }
     REQUIRE(HasPrefixFunction::callsCount == 1);
-    REQUIRE(HasPrefixFunction::objectsCount == 0);
+    REQUIRE(HasPrefixFunction::objectsCount == 1);
     {
         auto rows = storage.select(func<HasPrefixFunction>("two", "b"));
         decltype(rows) expected;
@@ -423,10 +577,11 @@ TEST_CASE("custom functions") {
         REQUIRE(rows == expected);
     }
     REQUIRE(HasPrefixFunction::callsCount == 2);
-    REQUIRE(HasPrefixFunction::objectsCount == 0);
+    REQUIRE(HasPrefixFunction::objectsCount == 1);
 
     //  delete function
     storage.delete_scalar_function<HasPrefixFunction>();
+    REQUIRE(HasPrefixFunction::objectsCount == 0);
 
     //  delete function
     storage.delete_scalar_function<SqrtFunction>();
@@ -448,12 +603,14 @@ TEST_CASE("custom functions") {
     storage.delete_aggregate_function<MeanFunction>();
 
     storage.create_scalar_function<FirstFunction>();
+    //  operator() is const so a single object serves all calls
+    REQUIRE(FirstFunction::objectsCount == 1);
     {
         auto rows = storage.select(func<FirstFunction>("Vanotek", "Tinashe", "Pitbull"));
         decltype(rows) expected;
         expected.push_back("VTP");
         REQUIRE(rows == expected);
-        REQUIRE(FirstFunction::objectsCount == 0);
+        REQUIRE(FirstFunction::objectsCount == 1);
         REQUIRE(FirstFunction::callsCount == 1);
     }
     {
@@ -461,7 +618,7 @@ TEST_CASE("custom functions") {
         decltype(rows) expected;
         expected.push_back("CR");
         REQUIRE(rows == expected);
-        REQUIRE(FirstFunction::objectsCount == 0);
+        REQUIRE(FirstFunction::objectsCount == 1);
         REQUIRE(FirstFunction::callsCount == 2);
     }
     {
@@ -469,7 +626,7 @@ TEST_CASE("custom functions") {
         decltype(rows) expected;
         expected.push_back("T");
         REQUIRE(rows == expected);
-        REQUIRE(FirstFunction::objectsCount == 0);
+        REQUIRE(FirstFunction::objectsCount == 1);
         REQUIRE(FirstFunction::callsCount == 3);
     }
     {
@@ -477,10 +634,11 @@ TEST_CASE("custom functions") {
         decltype(rows) expected;
         expected.push_back("");
         REQUIRE(rows == expected);
-        REQUIRE(FirstFunction::objectsCount == 0);
+        REQUIRE(FirstFunction::objectsCount == 1);
         REQUIRE(FirstFunction::callsCount == 4);
     }
     storage.delete_scalar_function<FirstFunction>();
+    REQUIRE(FirstFunction::objectsCount == 0);
 
     storage.create_aggregate_function<MultiSum>();
     {
@@ -494,6 +652,186 @@ TEST_CASE("custom functions") {
     storage.delete_aggregate_function<MultiSum>();
 }
 
+TEST_CASE("stateful scalar function gets a new object for every call") {
+    struct CounterFunction {
+        int calls = 0;
+
+        int operator()(int value) {
+            return value + ++this->calls;
+        }
+
+        static const char* name() {
+            return "COUNTER";
+        }
+    };
+    auto storage = make_storage("");
+    storage.create_scalar_function<CounterFunction>();
+    REQUIRE(storage.select(func<CounterFunction>(1)) == std::vector<int>{2});
+    REQUIRE(storage.select(func<CounterFunction>(1)) == std::vector<int>{2});
+}
+
+struct LowerFunction {
+    static constexpr bool deterministic = true;
+
+    std::string operator()(std::string value) const {
+        std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+            return char(std::tolower(c));
+        });
+        return value;
+    }
+
+    static const char* name() {
+        return "LOWER_CUSTOM";
+    }
+};
+
+#if SQLITE_VERSION_NUMBER >= 3025000
+struct MovingSumFunction {
+    static int inverseCallsCount;
+
+    int sum = 0;
+
+    void step(int value) {
+        this->sum += value;
+    }
+
+    void inverse(int value) {
+        ++inverseCallsCount;
+        this->sum -= value;
+    }
+
+    int value() const {
+        return this->sum;
+    }
+
+    int fin() const {
+        return this->sum;
+    }
+
+    static const char* name() {
+        return "MOVING_SUM";
+    }
+};
+
+int MovingSumFunction::inverseCallsCount = 0;
+
+TEST_CASE("aggregate window function") {
+    MovingSumFunction::inverseCallsCount = 0;
+    auto storage = make_storage("");
+    storage.create_aggregate_function<MovingSumFunction>();
+    auto statement = storage.prepare(select(1));
+    sqlite3* db = statement.con.get();
+
+    sqlite3_stmt* stmt = nullptr;
+    REQUIRE(sqlite3_prepare_v2(db,
+                               "SELECT MOVING_SUM(value) OVER (ORDER BY value ROWS BETWEEN 1 PRECEDING AND CURRENT ROW) "
+                               "FROM (SELECT 1 AS value UNION ALL SELECT 2 UNION ALL SELECT 3 UNION ALL SELECT 4)",
+                               -1,
+                               &stmt,
+                               nullptr) == SQLITE_OK);
+    std::vector<int> sums;
+    while(sqlite3_step(stmt) == SQLITE_ROW) {
+        sums.push_back(sqlite3_column_int(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    REQUIRE(sums == std::vector<int>{1, 3, 5, 7});
+    REQUIRE(MovingSumFunction::inverseCallsCount == 2);
+
+    //  still works as a plain aggregate
+    REQUIRE(storage.select(func<MovingSumFunction>(3)) == std::vector<int>{3});
+}
+#endif
+
+#ifdef SQLITE_ORM_STRING_VIEW_SUPPORTED
+struct CommonPrefixLengthFunction {
+    int operator()(std::string_view lhs, std::string_view rhs) const {
+        auto mismatch = std::mismatch(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return int(mismatch.first - lhs.begin());
+    }
+
+    static const char* name() {
+        return "COMMON_PREFIX_LENGTH";
+    }
+};
+
+struct TotalLengthFunction {
+    int operator()(const arg_values& args) const {
+        int res = 0;
+        for(auto value: args) {
+            res += int(value.text().size());
+            REQUIRE(value.bytes() == int(value.text().size()));
+        }
+        return res;
+    }
+
+    static const char* name() {
+        return "TOTAL_LENGTH";
+    }
+};
+
+#if __cpp_lib_span >= 202002L
+struct BlobSumFunction {
+    int operator()(std::span<const std::byte> blob) const {
+        int res = 0;
+        for(auto byte: blob) {
+            res += int(byte);
+        }
+        return res;
+    }
+
+    static const char* name() {
+        return "BLOB_SUM";
+    }
+};
+#endif
+
+TEST_CASE("scalar function with arguments that are not copied") {
+    auto storage = make_storage("");
+    storage.create_scalar_function<CommonPrefixLengthFunction>();
+    storage.create_scalar_function<TotalLengthFunction>();
+    REQUIRE(storage.select(func<CommonPrefixLengthFunction>("sqlite_orm", "sqlite3")) == std::vector<int>{6});
+    REQUIRE(storage.select(func<TotalLengthFunction>("one", "three", "")) == std::vector<int>{8});
+#if __cpp_lib_span >= 202002L
+    storage.create_scalar_function<BlobSumFunction>();
+    REQUIRE(storage.select(func<BlobSumFunction>(std::vector<char>{1, 2, 3})) == std::vector<int>{6});
+#endif
+}
+#endif  //  SQLITE_ORM_STRING_VIEW_SUPPORTED
+
+TEST_CASE("deterministic scalar function") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    struct RandomFunction {
+        int operator()() const {
+            return 4;
+        }
+
+        static const char* name() {
+            return "RANDOM_CUSTOM";
+        }
+    };
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.create_scalar_function<LowerFunction>();
+    storage.create_scalar_function<RandomFunction>();
+
+    auto statement = storage.prepare(select(1));
+    sqlite3* db = statement.con.get();
+    //  only deterministic functions can be used in an index on an expression
+    REQUIRE(sqlite3_exec(db, "CREATE INDEX users_lower_name ON users(LOWER_CUSTOM(name))", nullptr, nullptr, nullptr) ==
+            SQLITE_OK);
+    REQUIRE(sqlite3_exec(db, "CREATE INDEX users_random ON users(RANDOM_CUSTOM())", nullptr, nullptr, nullptr) ==
+            SQLITE_ERROR);
+
+    storage.insert(User{0, "Alice"});
+    REQUIRE(storage.select(&User::id, where(is_equal(func<LowerFunction>(&User::name), "alice"))) ==
+            std::vector<int>{1});
+}
+
 // Wrap std::default_delete in a function
 #ifndef SQLITE_ORM_BROKEN_VARIADIC_PACK_EXPANSION
 template<typename T>
@@ -120,6 +120,48 @@ TEST_CASE("Wide string") {
         REQUIRE(storage.get<Alphabet>(id).letters == expectedString);
     }
 }
+
+TEST_CASE("Wide string conversion") {
+    using internal::from_utf8;
+    using internal::to_utf8;
+    const std::wstring emoji = internal::is_wchar_utf16_v ? std::wstring{wchar_t(0xD83D), wchar_t(0xDE00)}
+                                                          : std::wstring{wchar_t(0x1F600)};
+    SECTION("to UTF-8") {
+        REQUIRE(to_utf8(std::wstring{}).empty());
+        REQUIRE(to_utf8(L"plain ascii text") == "plain ascii text");
+        REQUIRE(to_utf8(L"\u00e7\u0434\u20ac") == "\xc3\xa7\xd0\xb4\xe2\x82\xac");
+        REQUIRE(to_utf8(emoji) == "\xf0\x9f\x98\x80");
+    }
+    SECTION("from UTF-8") {
+        REQUIRE(from_utf8("", 0).empty());
+        REQUIRE(from_utf8("plain ascii text", 16) == L"plain ascii text");
+        REQUIRE(from_utf8("\xc3\xa7\xd0\xb4\xe2\x82\xac", 7) == L"\u00e7\u0434\u20ac");
+        REQUIRE(from_utf8("\xf0\x9f\x98\x80", 4) == emoji);
+    }
+    SECTION("invalid UTF-8") {
+        //  truncated, overlong and stray continuation bytes
+        REQUIRE(from_utf8("a\xe2\x82", 3) == L"a\ufffd\ufffd");
+        REQUIRE(from_utf8("\xc0\xaf" "b", 3) == L"\ufffd\ufffdb");
+        REQUIRE(from_utf8("\x80", 1) == L"\ufffd");
+    }
+    SECTION("storage") {
+        struct Note {
+            int id = 0;
+            std::wstring text;
+        };
+        auto storage = make_storage(
+            "",
+            make_table("notes", make_column("id", &Note::id, primary_key()), make_column("text", &Note::text)));
+        storage.sync_schema();
+        const std::wstring text = L"smile " + emoji + L" \u00e7";
+        auto id = storage.insert(Note{0, text});
+        REQUIRE(storage.get<Note>(id).text == text);
+        REQUIRE(storage.select(length(&Note::text)) == std::vector<int>{9});
+        REQUIRE(storage.select(&Note::text, where(c(&Note::text) == text)) == std::vector<std::wstring>{text});
+        storage.insert(Note{0, L""});
+        REQUIRE(storage.count<Note>(where(c(&Note::text) == L"")) == 1);
+    }
+}
 #endif  //  SQLITE_ORM_OMITS_CODECVT
 #ifdef SQLITE_ENABLE_DBSTAT_VTAB
 TEST_CASE("dbstat") {
@@ -140,6 +182,53 @@ TEST_CASE("dbstat") {
     auto dbstatRows = storage.get_all<dbstat>();
     std::ignore = dbstatRows;
 }
+
+TEST_CASE("space_report") {
+    struct Document {
+        int id = 0;
+        std::string title;
+        std::string body;
+    };
+    auto storage = make_storage("",
+                                make_index("idx_documents_title", &Document::title),
+                                make_table("documents",
+                                           make_column("id", &Document::id, primary_key()),
+                                           make_column("title", &Document::title),
+                                           make_column("body", &Document::body)));
+    storage.sync_schema();
+    for(int i = 1; i <= 20; ++i) {
+        storage.replace(Document{i, "title " + std::to_string(i), std::string(size_t(i % 2 ? 10 : 10000), 'x')});
+    }
+
+    auto report = storage.space_report();
+    auto find = [&report](const std::string& name) {
+        auto it = std::find_if(report.begin(), report.end(), [&name](const btree_space& btree) {
+            return btree.name == name;
+        });
+        REQUIRE(it != report.end());
+        return *it;
+    };
+    auto documents = find("documents");
+    REQUIRE_FALSE(documents.is_index);
+    REQUIRE(documents.table_name == "documents");
+    REQUIRE(documents.pages > documents.overflow_pages);
+    REQUIRE(documents.overflow_pages > 0);
+    REQUIRE(documents.payload_bytes >= 10 * 10000);
+    REQUIRE(documents.total_bytes == documents.pages * storage.pragma.page_size());
+    REQUIRE(documents.unused_ratio() > 0);
+    REQUIRE(documents.unused_ratio() < 1);
+    REQUIRE(documents.fragmentation >= 0);
+    REQUIRE(documents.fragmentation <= 1);
+
+    auto index = find("idx_documents_title");
+    REQUIRE(index.is_index);
+    REQUIRE(index.table_name == "documents");
+    REQUIRE(index.pages == 1);
+    REQUIRE(index.overflow_pages == 0);
+    REQUIRE(index.fragmentation == 0);
+
+    REQUIRE_THROWS_AS(storage.space_report("missing"), std::system_error);
+}
 #endif  //  SQLITE_ENABLE_DBSTAT_VTAB
 TEST_CASE("Busy timeout") {
     auto storage = make_storage("testBusyTimeout.sqlite");
@@ -265,6 +354,134 @@ TEST_CASE("Aggregate functions") {
     }
 }
 
+TEST_CASE("Scalar aggregates") {
+    struct Item {
+        int id = 0;
+        double price = 0;
+    };
+    auto storage = make_storage(
+        "",
+        make_table("items", make_column("id", &Item::id, primary_key()), make_column("price", &Item::price)));
+    storage.sync_schema();
+
+    static_assert(std::is_same<decltype(storage.count<Item>()), int64>::value, "");
+    REQUIRE(storage.count<Item>() == 0);
+    REQUIRE(storage.count(&Item::price) == 0);
+    REQUIRE(storage.avg(&Item::price) == 0);
+    REQUIRE(storage.total(&Item::price) == 0);
+    REQUIRE_FALSE(storage.max(&Item::price));
+    REQUIRE_FALSE(storage.min(&Item::price));
+    REQUIRE_FALSE(storage.sum(&Item::price));
+    REQUIRE(storage.group_concat(&Item::id).empty());
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+    REQUIRE_FALSE(storage.max_optional(&Item::price).has_value());
+    REQUIRE_FALSE(storage.sum_optional(&Item::price).has_value());
+#endif
+
+    storage.replace(Item{1, 2.5});
+    storage.replace(Item{2, 4.5});
+    REQUIRE(storage.count<Item>(where(c(&Item::price) > 3)) == 1);
+    REQUIRE(storage.avg(&Item::price) == 3.5);
+    REQUIRE(*storage.max(&Item::price) == 4.5);
+    REQUIRE(*storage.min(&Item::price) == 2.5);
+    REQUIRE(*storage.sum(&Item::price) == 7);
+    REQUIRE(storage.group_concat(&Item::id, "-") == "1-2");
+#ifdef SQLITE_ORM_OPTIONAL_SUPPORTED
+    REQUIRE(storage.max_optional(&Item::price) == 4.5);
+    REQUIRE(storage.min_optional(&Item::price, where(c(&Item::id) == 2)) == 4.5);
+    REQUIRE(storage.sum_optional(&Item::price) == 7);
+#endif
+#if SQLITE_VERSION_NUMBER >= 3014000
+    storage.enable_query_cache();
+    REQUIRE(storage.count<Item>(where(c(&Item::id) > 0), cached()) == 2);
+    REQUIRE(storage.count<Item>(where(c(&Item::id) > 0), cached()) == 2);
+#endif
+}
+
+TEST_CASE("Multi aggregate") {
+    struct Order {
+        int id = 0;
+        int userId = 0;
+        double amount = 0;
+    };
+    auto storage = make_storage("",
+                                make_table("orders",
+                                           make_column("id", &Order::id, primary_key()),
+                                           make_column("user_id", &Order::userId),
+                                           make_column("amount", &Order::amount)));
+    storage.sync_schema();
+    storage.replace(Order{1, 1, 10});
+    storage.replace(Order{2, 1, 30});
+    storage.replace(Order{3, 2, 5});
+
+    auto stats = storage.aggregate(columns(count<Order>(), sum(&Order::amount), avg(&Order::amount), max(&Order::id)),
+                                   where(c(&Order::userId) == 1));
+    static_assert(std::is_same<decltype(stats),
+                               std::tuple<int, std::unique_ptr<double>, double, std::unique_ptr<int>>>::value,
+                  "");
+    REQUIRE(std::get<0>(stats) == 2);
+    REQUIRE(*std::get<1>(stats) == 40);
+    REQUIRE(std::get<2>(stats) == 20);
+    REQUIRE(*std::get<3>(stats) == 2);
+
+    auto none = storage.aggregate(columns(count<Order>(), max(&Order::amount)), where(c(&Order::userId) == 3));
+    REQUIRE(std::get<0>(none) == 0);
+    REQUIRE_FALSE(std::get<1>(none));
+
+    //  with GROUP BY the first group is returned, with no rows the values are value-initialized
+    auto grouped = storage.aggregate(columns(&Order::userId, count<Order>()),
+                                     where(c(&Order::amount) > 100),
+                                     group_by(&Order::userId));
+    REQUIRE(grouped == std::make_tuple(0, 0));
+}
+
+namespace {
+    struct LatencyMax {
+        double value = 0;
+
+        void step(double latency) {
+            this->value = std::max(this->value, latency);
+        }
+
+        double fin() const {
+            return this->value;
+        }
+
+        static const char* name() {
+            return "LATENCY_MAX";
+        }
+    };
+}
+
+TEST_CASE("Filtered aggregates") {
+    struct Request {
+        int id = 0;
+        bool failed = false;
+        double latency = 0;
+    };
+    auto storage = make_storage("",
+                                make_table("requests",
+                                           make_column("id", &Request::id, primary_key()),
+                                           make_column("failed", &Request::failed),
+                                           make_column("latency", &Request::latency)));
+    storage.sync_schema();
+    storage.create_aggregate_function<LatencyMax>();
+    storage.replace(Request{1, false, 10});
+    storage.replace(Request{2, true, 500});
+    storage.replace(Request{3, false, 30});
+
+    //  one scan instead of one query per condition
+    auto stats = storage.aggregate(columns(count(),
+                                           count().filter(where(c(&Request::failed) == true)),
+                                           total(&Request::latency).filter(where(c(&Request::failed) == false)),
+                                           func<LatencyMax>(&Request::latency)
+                                               .filter(where(c(&Request::failed) == false))));
+    REQUIRE(std::get<0>(stats) == 3);
+    REQUIRE(std::get<1>(stats) == 1);
+    REQUIRE(std::get<2>(stats) == 40);
+    REQUIRE(std::get<3>(stats) == 30);
+}
+
 TEST_CASE("Current timestamp") {
     auto storage = make_storage("");
     REQUIRE(storage.current_timestamp().size());
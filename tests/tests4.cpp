@@ -288,3 +288,34 @@ TEST_CASE("two joins") {
                                  inner_join<als_b>(on(c(alias_column<als_t>(&Transaccion::fkey_account_own)) ==
                                                       alias_column<als_b>(&Account::id_account))));
 }
+
+#if SQLITE_VERSION_NUMBER >= 3033000
+TEST_CASE("update_all from") {
+    struct Product {
+        int id = 0;
+        double price = 0;
+    };
+    struct PriceUpdate {
+        int productId = 0;
+        double price = 0;
+    };
+    auto storage = make_storage(
+        {},
+        make_table("products", make_column("id", &Product::id, primary_key()), make_column("price", &Product::price)),
+        make_table("a_price_updates",
+                   make_column("product_id", &PriceUpdate::productId),
+                   make_column("price", &PriceUpdate::price)));
+    storage.sync_schema();
+    storage.replace(Product{1, 10});
+    storage.replace(Product{2, 20});
+    storage.replace(Product{3, 30});
+    storage.insert(PriceUpdate{1, 11});
+    storage.insert(PriceUpdate{3, 33});
+
+    storage.update_all(set(c(&Product::price) = &PriceUpdate::price),
+                       from<PriceUpdate>(),
+                       where(c(&PriceUpdate::productId) == &Product::id));
+    auto prices = storage.select(&Product::price, order_by(&Product::id));
+    REQUIRE(prices == std::vector<double>{11, 20, 33});
+}
+#endif
@@ -1,6 +1,7 @@
 #include <sqlite_orm/sqlite_orm.h>
 #include <catch2/catch_all.hpp>
 #include <numeric>  //  std::iota
+#include <list>  //  std::list
 
 using namespace sqlite_orm;
 
@@ -349,3 +350,264 @@ TEST_CASE("issue822") {
         REQUIRE(*records[0].getValue() == 10);
     }
 }
+
+TEST_CASE("Iterate reuses the object") {
+    struct User {
+        int id = 0;
+        std::string name;
+        std::unique_ptr<std::string> nickname;
+    };
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("nickname", &User::nickname)));
+    storage.sync_schema();
+    storage.insert(into<User>(),
+                   columns(&User::id, &User::name, &User::nickname),
+                   values(std::make_tuple(1, "Alexander", "Alex")));
+    storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(2, "Bob")));
+    storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(3, "Christopher")));
+
+    SECTION("single pass") {
+        auto view = storage.iterate<User>(order_by(&User::id));
+        auto it = view.begin();
+        const User* first = &*it;
+        REQUIRE(it->name == "Alexander");
+        REQUIRE(*it->nickname == "Alex");
+        ++it;
+        REQUIRE(&*it == first);
+        REQUIRE(it->id == 2);
+        REQUIRE(it->name == "Bob");
+        REQUIRE_FALSE(it->nickname);
+        ++it;
+        REQUIRE(&*it == first);
+        REQUIRE(it->name == "Christopher");
+        ++it;
+        REQUIRE(it == view.end());
+    }
+    SECTION("copies keep their row") {
+        auto view = storage.iterate<User>(order_by(&User::id));
+        auto it = view.begin();
+        auto copy = it;
+        ++it;
+        REQUIRE(copy->id == 1);
+        REQUIRE(copy->name == "Alexander");
+        REQUIRE(it->id == 2);
+        REQUIRE(it != copy);
+    }
+}
+
+TEST_CASE("Iterate view size") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(1, "Alice")));
+    storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(2, "Bob")));
+    storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(3, "Carol")));
+
+    REQUIRE(storage.iterate<User>().size() == 3);
+    REQUIRE_FALSE(storage.iterate<User>().empty());
+
+    auto filtered = storage.iterate<User>(where(c(&User::id) > 1));
+    REQUIRE(filtered.size() == 2);
+    REQUIRE_FALSE(filtered.empty());
+    REQUIRE(storage.iterate<User>(where(c(&User::id) > 1), limit(1)).size() == 1);
+    REQUIRE(storage.iterate<User>(where(c(&User::id) > 3)).size() == 0);
+    REQUIRE(storage.iterate<User>(where(c(&User::id) > 3)).empty());
+}
+
+TEST_CASE("Iterate with prefetch") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto filename = "iterate_prefetch.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename](auto... options) {
+        return make_storage(
+            options...,
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    };
+    auto storage = makeStorage();
+    storage.sync_schema();
+    storage.transaction([&storage] {
+        for(int id = 1; id <= 100; ++id) {
+            storage.replace(User{id, "user" + std::to_string(id)});
+        }
+        return true;
+    });
+
+    SECTION("all rows in order") {
+        std::vector<int> ids;
+        for(auto& user: storage.iterate<User>(prefetch(8), order_by(&User::id))) {
+            REQUIRE(user.name == "user" + std::to_string(user.id));
+            ids.push_back(user.id);
+        }
+        std::vector<int> expected(100);
+        std::iota(expected.begin(), expected.end(), 1);
+        REQUIRE(ids == expected);
+    }
+    SECTION("leaving the loop early") {
+        auto view = storage.iterate<User>(where(c(&User::id) > 10), prefetch(4));
+        REQUIRE(view.size() == 90);
+        int count = 0;
+        for(auto& user: view) {
+            REQUIRE(user.id > 10);
+            if(++count == 5) {
+                break;
+            }
+        }
+        REQUIRE(count == 5);
+        REQUIRE(view.begin() != view.end());
+        auto none = storage.iterate<User>(where(c(&User::id) > 100), prefetch(4));
+        REQUIRE(none.begin() == none.end());
+    }
+    SECTION("pooled connections") {
+        auto pooled = makeStorage(pool_options{2});
+        int count = 0;
+        for(auto& user: pooled.iterate<User>(prefetch(16))) {
+            count += user.id > 0;
+        }
+        REQUIRE(count == 100);
+    }
+    ::remove(filename);
+}
+
+TEST_CASE("get_all reserve") {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+    auto storage = make_storage(
+        "",
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(1, "Alice")));
+    storage.insert(into<User>(), columns(&User::id, &User::name), values(std::make_tuple(2, "Bob")));
+
+    auto users = storage.get_all<User>(where(c(&User::id) > 0), reserve(100));
+    REQUIRE(users.size() == 2);
+    REQUIRE(users.capacity() >= 100);
+
+    auto pointers = storage.get_all_pointer<User>(reserve(50));
+    REQUIRE(pointers.size() == 2);
+    REQUIRE(pointers.capacity() >= 50);
+
+    auto list = storage.get_all<User, std::list<User>>(reserve(10));
+    REQUIRE(list.size() == 2);
+}
+
+TEST_CASE("get_all only") {
+    struct User {
+        int id = 0;
+        std::string name;
+        int age = -1;
+        std::vector<char> avatar;
+    };
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("age", &User::age),
+                                           make_column("avatar", &User::avatar)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice", 30, {'a'}});
+    storage.replace(User{2, "Bob", 40, {'b'}});
+
+    auto expectPartial = [](const User& user, int id, const std::string& name) {
+        REQUIRE(user.id == id);
+        REQUIRE(user.name == name);
+        REQUIRE(user.age == -1);
+        REQUIRE(user.avatar.empty());
+    };
+    SECTION("get_all") {
+        auto users = storage.get_all<User>(where(c(&User::id) > 1), only(&User::name, &User::id));
+        REQUIRE(users.size() == 1);
+        expectPartial(users[0], 2, "Bob");
+    }
+    SECTION("get_all_pointer") {
+        auto users = storage.get_all_pointer<User>(only(&User::id, &User::name), order_by(&User::id));
+        REQUIRE(users.size() == 2);
+        expectPartial(*users[0], 1, "Alice");
+        expectPartial(*users[1], 2, "Bob");
+    }
+    SECTION("for_each") {
+        std::vector<User> users;
+        storage.for_each<User>(
+            [&users](User user) {
+                users.push_back(std::move(user));
+            },
+            only(&User::id, &User::name),
+            where(c(&User::id) == 1));
+        REQUIRE(users.size() == 1);
+        expectPartial(users[0], 1, "Alice");
+    }
+    SECTION("iterate") {
+        std::vector<User> users;
+        for(auto& user: storage.iterate<User>(only(&User::id, &User::name), order_by(&User::id))) {
+            users.push_back(user);
+        }
+        REQUIRE(users.size() == 2);
+        expectPartial(users[1], 2, "Bob");
+    }
+    SECTION("dump") {
+        auto statement = get_all<User>(only(&User::id, &User::name), where(c(&User::age) > 35));
+        REQUIRE(storage.dump(statement) ==
+                R"(SELECT "users"."id", "users"."name" FROM "users" WHERE (("users"."age" > 35)))");
+    }
+}
+
+TEST_CASE("update_changed") {
+    struct User {
+        int id = 0;
+        std::string name;
+        int age = 0;
+        std::unique_ptr<std::string> email;
+    };
+    auto storage = make_storage({},
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("age", &User::age),
+                                           make_column("email", &User::email)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice", 30, std::make_unique<std::string>("alice@example.com")});
+
+    auto old = storage.get<User>(1);
+    auto user = storage.get<User>(1);
+    user.age = 31;
+
+    //  a concurrent change of a column that is not changed in `user` must survive the update
+    storage.update_all(set(c(&User::name) = "Alicia"), where(c(&User::id) == 1));
+    storage.update_changed(old, user);
+    auto updated = storage.get<User>(1);
+    REQUIRE(updated.name == "Alicia");
+    REQUIRE(updated.age == 31);
+    REQUIRE(updated.email);
+    REQUIRE(*updated.email == "alice@example.com");
+
+    SECTION("pointee comparison") {
+        user.email = std::make_unique<std::string>("alice@example.com");
+        storage.update_all(set(c(&User::age) = 40), where(c(&User::id) == 1));
+        old.age = 31;
+        storage.update_changed(old, user);
+        REQUIRE(storage.get<User>(1).age == 40);
+
+        user.email.reset();
+        storage.update_changed(old, user);
+        REQUIRE_FALSE(storage.get<User>(1).email);
+        REQUIRE(storage.get<User>(1).age == 40);
+    }
+    SECTION("nothing changed") {
+        auto totalChanges = storage.total_changes();
+        storage.update_changed(user, user);
+        REQUIRE(storage.total_changes() == totalChanges);
+    }
+}
@@ -1,5 +1,7 @@
 #include <sqlite_orm/sqlite_orm.h>
 #include <catch2/catch_all.hpp>
+#include <chrono>  //  std::chrono::milliseconds
+#include <thread>  //  std::thread, std::this_thread::sleep_for
 
 using namespace sqlite_orm;
 
@@ -204,3 +206,222 @@ TEST_CASE("Transaction guard") {
     }
     ::remove("guard.sqlite");
 }
+
+TEST_CASE("Savepoints") {
+    auto storage = make_storage(
+        "",
+        make_table("objects", make_column("id", &Object::id, primary_key()), make_column("name", &Object::name)));
+    storage.sync_schema();
+    REQUIRE_FALSE(storage.in_transaction());
+
+    SECTION("savepoint guard inside a transaction") {
+        auto guard = storage.transaction_guard();
+        storage.replace(Object{1, "Jack"});
+        {
+            auto savepoint = storage.savepoint_guard("inner");
+            REQUIRE(storage.in_transaction());
+            storage.replace(Object{2, "John"});
+            REQUIRE(storage.count<Object>() == 2);
+        }
+        REQUIRE(storage.count<Object>() == 1);
+        {
+            auto savepoint = storage.savepoint_guard("inner");
+            storage.replace(Object{3, "Jim"});
+            savepoint.commit();
+        }
+        guard.commit();
+        REQUIRE_FALSE(storage.in_transaction());
+        REQUIRE(storage.select(&Object::id) == std::vector<int>{1, 3});
+    }
+    SECTION("nested transaction calls") {
+        storage.transaction([&storage] {
+            storage.replace(Object{1, "Jack"});
+            storage.transaction([&storage] {
+                storage.replace(Object{2, "John"});
+                return false;
+            });
+            storage.transaction([&storage] {
+                storage.replace(Object{3, "Jim"});
+                return true;
+            });
+            return true;
+        });
+        REQUIRE(storage.select(&Object::id) == std::vector<int>{1, 3});
+    }
+    SECTION("outer rollback undoes released savepoints") {
+        storage.begin_transaction();
+        storage.savepoint("first");
+        storage.replace(Object{1, "Jack"});
+        storage.release_savepoint("first");
+        storage.savepoint("second");
+        storage.replace(Object{2, "John"});
+        storage.rollback_to_savepoint("second");
+        REQUIRE(storage.count<Object>() == 1);
+        storage.release_savepoint("second");
+        storage.rollback();
+        REQUIRE(storage.count<Object>() == 0);
+    }
+    SECTION("savepoint outside of a transaction") {
+        storage.savepoint("outer");
+        REQUIRE(storage.in_transaction());
+        storage.replace(Object{1, "Jack"});
+        storage.release_savepoint("outer");
+        REQUIRE_FALSE(storage.in_transaction());
+        REQUIRE(storage.count<Object>() == 1);
+    }
+}
+
+TEST_CASE("Transaction with retry policy") {
+    using std::chrono::milliseconds;
+    auto filename = "transaction_retry.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename] {
+        return make_storage(
+            filename,
+            make_table("objects", make_column("id", &Object::id, primary_key()), make_column("name", &Object::name)));
+    };
+    auto writer = makeStorage();
+    writer.sync_schema();
+    auto storage = makeStorage();
+    storage.sync_schema();
+
+    writer.begin_immediate_transaction();
+    writer.replace(Object{1, "Jack"});
+
+    SECTION("gives up after max attempts") {
+        try {
+            storage.transaction(
+                [&storage] {
+                    storage.replace(Object{2, "John"});
+                    return true;
+                },
+                retry_policy{3, milliseconds{1}, milliseconds{2}});
+            REQUIRE(false);
+        } catch(const std::system_error& e) {
+            REQUIRE(e.code() == sqlite_errc(SQLITE_BUSY));
+        }
+        REQUIRE_FALSE(storage.in_transaction());
+        writer.commit();
+        REQUIRE(storage.count<Object>() == 1);
+    }
+    SECTION("succeeds once the lock is released") {
+        std::thread committer{[&writer] {
+            std::this_thread::sleep_for(milliseconds{30});
+            writer.commit();
+        }};
+        int calls = 0;
+        auto committed = storage.transaction(
+            [&storage, &calls] {
+                ++calls;
+                storage.replace(Object{2, "John"});
+                return true;
+            },
+            retry_policy{1000, milliseconds{1}, milliseconds{5}});
+        committer.join();
+        REQUIRE(committed);
+        REQUIRE(calls == 1);
+        REQUIRE(storage.count<Object>() == 2);
+    }
+}
+
+TEST_CASE("Transaction with retry policy and a busy commit") {
+    using std::chrono::milliseconds;
+    auto filename = "transaction_retry_commit.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("objects", make_column("id", &Object::id, primary_key()), make_column("name", &Object::name)));
+    storage.sync_schema();
+
+    //  a reader holding the shared lock lets BEGIN IMMEDIATE through but makes COMMIT busy
+    sqlite3* reader = nullptr;
+    REQUIRE(sqlite3_open(filename, &reader) == SQLITE_OK);
+    REQUIRE(sqlite3_exec(reader, "BEGIN; SELECT * FROM objects", nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    int calls = 0;
+    SECTION("gives up after max attempts") {
+        try {
+            storage.transaction(
+                [&storage, &calls] {
+                    ++calls;
+                    storage.replace(Object{1, "Jack"});
+                    return true;
+                },
+                retry_policy{3, milliseconds{1}, milliseconds{2}});
+            REQUIRE(false);
+        } catch(const std::system_error& e) {
+            REQUIRE(e.code() == sqlite_errc(SQLITE_BUSY));
+        }
+        REQUIRE(calls == 3);
+        REQUIRE_FALSE(storage.in_transaction());
+        sqlite3_exec(reader, "COMMIT", nullptr, nullptr, nullptr);
+        REQUIRE(storage.count<Object>() == 0);
+    }
+    SECTION("retried in a new transaction") {
+        auto committed = storage.transaction(
+            [&storage, &calls, reader] {
+                if(++calls == 2) {
+                    sqlite3_exec(reader, "COMMIT", nullptr, nullptr, nullptr);
+                }
+                storage.replace(Object{calls, "Jack"});
+                return true;
+            },
+            retry_policy{3, milliseconds{1}, milliseconds{2}});
+        REQUIRE(committed);
+        REQUIRE(calls == 2);
+        REQUIRE_FALSE(storage.in_transaction());
+        REQUIRE(storage.get_all<Object>() == std::vector<Object>{Object{2, "Jack"}});
+    }
+    sqlite3_close(reader);
+}
+
+TEST_CASE("Read transaction") {
+    auto filename = "read_transaction.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename] {
+        return make_storage(
+            filename,
+            make_table("objects", make_column("id", &Object::id, primary_key()), make_column("name", &Object::name)));
+    };
+    auto writer = makeStorage();
+    writer.sync_schema();
+    writer.pragma.journal_mode(journal_mode::WAL);
+    writer.replace(Object{1, "Jack"});
+    auto storage = makeStorage();
+    storage.open_forever();
+
+    SECTION("one snapshot") {
+        {
+            auto guard = storage.read_transaction();
+            REQUIRE(storage.in_transaction());
+            REQUIRE(storage.count<Object>() == 1);
+            writer.replace(Object{2, "John"});
+            REQUIRE(storage.count<Object>() == 1);
+            REQUIRE(storage.get_pointer<Object>(2) == nullptr);
+            auto view = storage.iterate<Object>();
+            REQUIRE(view.size() == 1);
+        }
+        REQUIRE_FALSE(storage.in_transaction());
+        REQUIRE(storage.count<Object>() == 2);
+    }
+    SECTION("explicit commit") {
+        auto guard = storage.read_transaction();
+        REQUIRE(storage.count<Object>() == 1);
+        guard.commit();
+        REQUIRE_FALSE(storage.in_transaction());
+        writer.replace(Object{2, "John"});
+        REQUIRE(storage.count<Object>() == 2);
+    }
+    SECTION("inside a transaction") {
+        storage.transaction([&storage] {
+            storage.replace(Object{2, "John"});
+            {
+                auto guard = storage.read_transaction();
+                REQUIRE(storage.count<Object>() == 2);
+            }
+            REQUIRE(storage.in_transaction());
+            return false;
+        });
+        REQUIRE(storage.count<Object>() == 1);
+    }
+}
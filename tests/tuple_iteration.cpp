@@ -79,3 +79,34 @@ TEST_CASE("creation from tuple") {
         REQUIRE_THAT(strings, Equals(expected));
     }
 }
+
+TEST_CASE("find in tuple") {
+    using namespace internal;
+
+    std::tuple<int, std::string, long> tpl{1, "abc", 3};
+    std::vector<std::type_index> visited;
+    auto visit = [&visited](const auto& item) {
+        visited.emplace_back(typeid(item));
+    };
+    SECTION("stops at the first match") {
+        bool found = find_in_tuple(tpl, std::make_index_sequence<3>{}, [&visit](const auto& item) {
+            visit(item);
+            return std::is_same<std::decay_t<decltype(item)>, std::string>::value;
+        });
+        REQUIRE(found);
+        REQUIRE(visited == std::vector<std::type_index>{typeid(int), typeid(std::string)});
+    }
+    SECTION("no match") {
+        bool found = find_in_tuple(tpl, std::index_sequence<0, 2>{}, [&visit](const auto& item) {
+            visit(item);
+            return false;
+        });
+        REQUIRE_FALSE(found);
+        REQUIRE(visited == std::vector<std::type_index>{typeid(int), typeid(long)});
+    }
+    SECTION("empty") {
+        REQUIRE_FALSE(find_in_tuple(tpl, std::index_sequence<>{}, [](const auto&) {
+            return true;
+        }));
+    }
+}
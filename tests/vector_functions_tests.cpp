@@ -0,0 +1,99 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Item {
+        int id = 0;
+        int category = 0;
+        std::vector<char> embedding;
+    };
+
+    bool near(double a, double b) {
+        return std::fabs(a - b) < 1e-4;
+    }
+}
+
+TEST_CASE("vector kernels") {
+    auto& cpu = internal::cpu_vector_kernels();
+    auto& scalar = internal::scalar_vector_kernels();
+    INFO(cpu.isa);
+    for(size_t count = 0; count < 40; ++count) {
+        std::vector<float> a;
+        std::vector<float> b;
+        for(size_t i = 0; i < count; ++i) {
+            a.push_back(float(i % 7) - 3.5f);
+            b.push_back(float(i % 5) * 0.25f);
+        }
+        //  blobs are read at any offset
+        auto blobA = vector_blob(a);
+        blobA.insert(blobA.begin(), 0);
+        auto blobB = vector_blob(b);
+        auto pa = reinterpret_cast<const unsigned char*>(blobA.data() + 1);
+        auto pb = reinterpret_cast<const unsigned char*>(blobB.data());
+        REQUIRE(near(cpu.dot(pa, pb, count), scalar.dot(pa, pb, count)));
+        REQUIRE(near(cpu.squared_l2(pa, pb, count), scalar.squared_l2(pa, pb, count)));
+        float dot, aa, bb;
+        cpu.cosine_sums(pa, pb, count, dot, aa, bb);
+        float scalarDot, scalarAa, scalarBb;
+        scalar.cosine_sums(pa, pb, count, scalarDot, scalarAa, scalarBb);
+        REQUIRE(near(dot, scalarDot));
+        REQUIRE(near(aa, scalarAa));
+        REQUIRE(near(bb, scalarBb));
+    }
+}
+
+TEST_CASE("vector functions") {
+    auto storage = make_storage({},
+                                make_table("items",
+                                           make_column("id", &Item::id, primary_key()),
+                                           make_column("category", &Item::category),
+                                           make_column("embedding", &Item::embedding)));
+    storage.sync_schema();
+    storage.replace(Item{1, 1, vector_blob({1, 0, 0})});
+    storage.replace(Item{2, 1, vector_blob({0, 1, 0})});
+    storage.replace(Item{3, 2, vector_blob({1, 1, 0})});
+    storage.replace(Item{4, 2, vector_blob({-1, 0, 0})});
+    storage.enable_vector_functions();
+    const auto query = vector_blob({1, 0.4f, 0});
+
+    SECTION("values") {
+        auto rows = storage.select(columns(vec_dot(&Item::embedding, query),
+                                           vec_l2(&Item::embedding, query),
+                                           vec_cosine(&Item::embedding, query)),
+                                   where(c(&Item::id) == 3));
+        REQUIRE(rows.size() == 1);
+        REQUIRE(near(std::get<0>(rows[0]), 1.4));
+        REQUIRE(near(std::get<1>(rows[0]), 0.6));
+        REQUIRE(near(std::get<2>(rows[0]), 1.4 / std::sqrt(2 * 1.16)));
+    }
+    SECTION("nearest") {
+        auto ids = storage.select(&Item::id, order_by(vec_l2(&Item::embedding, query)), limit(2));
+        REQUIRE(ids == std::vector<int>{1, 3});
+        ids = storage.select(&Item::id, order_by(vec_cosine(&Item::embedding, query)).desc(), limit(1));
+        REQUIRE(ids == std::vector<int>{1});
+    }
+    SECTION("null") {
+        auto ids = storage.select(&Item::id,
+                                  where(and_(is_null(vec_cosine(&Item::embedding, vector_blob({0, 0, 0}))),
+                                             is_null(vec_dot(&Item::embedding, nullptr)))));
+        REQUIRE(ids.size() == 4);
+    }
+    SECTION("dimensions differ") {
+        REQUIRE_THROWS_AS(storage.select(vec_dot(&Item::embedding, vector_blob({1, 0}))), std::system_error);
+    }
+    SECTION("top_k") {
+        auto all = storage.select(top_k(&Item::id, vec_l2(&Item::embedding, query), 3));
+        REQUIRE(all == std::vector<std::string>{"[1,3,2]"});
+        auto byCategory = storage.select(columns(&Item::category, top_k(&Item::id, vec_l2(&Item::embedding, query), 1)),
+                                         group_by(&Item::category),
+                                         order_by(&Item::category));
+        REQUIRE(byCategory == std::vector<std::tuple<int, std::string>>{{1, "[1]"}, {2, "[3]"}});
+        auto mostSimilar = storage.select(top_k(&Item::id, sub(0, vec_dot(&Item::embedding, query)), 2));
+        REQUIRE(mostSimilar == std::vector<std::string>{"[3,1]"});
+        auto none = storage.select(top_k(&Item::id, vec_l2(&Item::embedding, query), 3), where(c(&Item::id) > 10));
+        REQUIRE(none == std::vector<std::string>{"[]"});
+        REQUIRE_THROWS_AS(storage.select(top_k(&Item::id, vec_l2(&Item::embedding, query), 0)), std::system_error);
+    }
+}
@@ -0,0 +1,84 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Account {
+        int id = 0;
+        int balance = 0;
+        sqlite_int64 version = 0;
+    };
+}
+
+TEST_CASE("version column") {
+    auto storage = make_storage({},
+                                make_table("accounts",
+                                           make_column("id", &Account::id, primary_key()),
+                                           make_column("balance", &Account::balance),
+                                           make_column("version", &Account::version, default_value(0)))
+                                    .version_column(&Account::version));
+    storage.sync_schema();
+    storage.replace(Account{1, 100, 0});
+
+    SECTION("update increments the version") {
+        auto account = storage.get<Account>(1);
+        account.balance = 90;
+        storage.update(account);
+        auto updated = storage.get<Account>(1);
+        REQUIRE(updated.balance == 90);
+        REQUIRE(updated.version == 1);
+        REQUIRE(storage.dump(update(account)) ==
+                R"(UPDATE "accounts" SET "balance" = 90, "version" = "version" + 1 WHERE "id" = 1 AND "version" = 0)");
+    }
+    SECTION("stale update is a conflict") {
+        auto first = storage.get<Account>(1);
+        auto second = storage.get<Account>(1);
+        first.balance = 50;
+        storage.update(first);
+        second.balance = 70;
+        REQUIRE_THROWS_WITH(storage.update(second), Catch::Matchers::ContainsSubstring("since it was read"));
+        REQUIRE_FALSE(storage.try_update(second));
+        REQUIRE(storage.get<Account>(1).balance == 50);
+    }
+    SECTION("try_update keeps the object current") {
+        auto account = storage.get<Account>(1);
+        account.balance = 10;
+        REQUIRE(storage.try_update(account));
+        REQUIRE(account.version == 1);
+        account.balance = 20;
+        REQUIRE(storage.try_update(account));
+        REQUIRE(storage.get<Account>(1).version == 2);
+    }
+    SECTION("update_changed") {
+        auto old = storage.get<Account>(1);
+        auto account = old;
+        account.balance = 30;
+        storage.update_changed(old, account);
+        REQUIRE(storage.get<Account>(1).version == 1);
+        REQUIRE_THROWS_AS(storage.update_changed(old, account), std::system_error);
+    }
+    SECTION("optimistic_update retries") {
+        int calls = 0;
+        auto account = storage.optimistic_update<Account>(
+            3,
+            [&storage, &calls](Account& account) {
+                //  another writer gets in between the first read and the update
+                if(++calls == 1) {
+                    storage.update_all(set(c(&Account::version) = c(&Account::version) + 1));
+                }
+                account.balance += 5;
+            },
+            1);
+        REQUIRE(calls == 2);
+        REQUIRE(account.balance == 105);
+        REQUIRE(account.version == 2);
+        REQUIRE(storage.get<Account>(1).balance == 105);
+    }
+    SECTION("optimistic_update gives up") {
+        auto conflict = [&storage](Account&) {
+            storage.update_all(set(c(&Account::version) = c(&Account::version) + 1));
+        };
+        REQUIRE_THROWS_AS(storage.optimistic_update<Account>(2, conflict, 1), std::system_error);
+    }
+}
@@ -0,0 +1,128 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Tenant {
+        int id = 0;
+        std::string name;
+    };
+
+    struct counting_shim : vfs_shim {
+        std::atomic<int> opened_files{0};
+        std::atomic<int> closed_files{0};
+
+        void opened(vfs_file& file) override {
+            if(file.is_main_db()) {
+                ++this->opened_files;
+            }
+        }
+
+        void closing(vfs_file& file) override {
+            if(file.is_main_db()) {
+                ++this->closed_files;
+            }
+        }
+    };
+}
+
+TEST_CASE("vfs shim") {
+    auto filename = "vfs_shim.sqlite";
+    ::remove(filename);
+    auto makeStorage = [filename](const std::string& vfs) {
+        open_options options;
+        options.vfs = vfs;
+        return make_storage(options,
+                            filename,
+                            make_table("tenants",
+                                       make_column("id", &Tenant::id, primary_key()),
+                                       make_column("name", &Tenant::name)));
+    };
+
+    SECTION("forwarding") {
+        auto shim = std::make_shared<counting_shim>();
+        register_vfs_shim("counting", shim);
+        {
+            auto storage = makeStorage("counting");
+            storage.sync_schema();
+            storage.insert(Tenant{0, "Acme"});
+            REQUIRE(storage.get<Tenant>(1).name == "Acme");
+        }
+        REQUIRE(shim->opened_files > 0);
+        REQUIRE(shim->opened_files == shim->closed_files);
+        unregister_vfs_shim("counting");
+        REQUIRE(sqlite3_vfs_find("counting") == nullptr);
+    }
+    SECTION("page cache") {
+        auto cache = std::make_shared<page_cache_shim>(1 << 20);
+        register_vfs_shim("page_cache", cache);
+        auto writer = makeStorage("page_cache");
+        writer.sync_schema();
+        writer.insert(Tenant{0, "Acme"});
+
+        auto reader = makeStorage("page_cache");
+        REQUIRE(reader.get<Tenant>(1).name == "Acme");
+        auto before = cache->stats();
+        REQUIRE(before.cached_bytes > 0);
+        REQUIRE(reader.get<Tenant>(1).name == "Acme");
+        auto after = cache->stats();
+        REQUIRE(after.hits > before.hits);
+        REQUIRE(after.misses == before.misses);
+
+        //  a write replaces the cached blocks, other connections read the new rows
+        writer.update_all(set(c(&Tenant::name) = "Globex"));
+        REQUIRE(cache->stats().writes > after.writes);
+        REQUIRE(reader.get<Tenant>(1).name == "Globex");
+
+        cache->clear();
+        REQUIRE(cache->stats().cached_bytes == 0);
+        REQUIRE(reader.get<Tenant>(1).name == "Globex");
+        unregister_vfs_shim("page_cache");
+    }
+    SECTION("unknown base vfs") {
+        REQUIRE_THROWS_WITH(register_vfs_shim("broken", std::make_shared<vfs_shim>(), "no such vfs"),
+                            "VFS not found");
+    }
+}
+
+TEST_CASE("io accounting") {
+    auto filename = "io_accounting.sqlite";
+    ::remove(filename);
+    register_vfs_shim("accounted", std::make_shared<io_accounting_shim>());
+    open_options options;
+    options.vfs = "accounted";
+    auto storage = make_storage(options,
+                                filename,
+                                make_table("tenants",
+                                           make_column("id", &Tenant::id, primary_key()),
+                                           make_column("name", &Tenant::name)));
+    storage.sync_schema();
+    storage.io_stats(true);
+
+    storage.insert(Tenant{0, "Acme"});
+    auto written = storage.io_stats();
+    REQUIRE(written.writes > 0);
+    REQUIRE(written.bytes_written >= written.writes);
+    REQUIRE(written.syncs > 0);
+    REQUIRE(written.write_latency.count() == written.writes);
+    REQUIRE(written.sync_latency.count() == written.syncs);
+
+    std::vector<statement_profile> profiles;
+    storage.on_profile([&profiles](const statement_profile& profile) {
+        profiles.push_back(profile);
+    });
+    storage.insert(Tenant{0, "Globex"});
+    storage.on_profile(nullptr);
+    REQUIRE(profiles.size() == 1);
+    REQUIRE(profiles[0].io.writes > 0);
+    REQUIRE(profiles[0].io.syncs > 0);
+
+    auto total = storage.io_stats(true);
+    REQUIRE(total.writes >= written.writes + profiles[0].io.writes);
+    REQUIRE(storage.io_stats().writes == 0);
+
+    auto memory = make_storage(":memory:");
+    REQUIRE(memory.io_stats().reads == 0);
+    unregister_vfs_shim("accounted");
+}
@@ -0,0 +1,142 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+    };
+
+    struct WantedUser {
+        int id = 0;
+        double score = 0;
+    };
+
+    struct Failing {
+        int value = 0;
+    };
+
+    struct failing_module {
+        struct cursor_type {
+            void filter(int, const char*, int, sqlite3_value**) {
+                throw std::runtime_error("no rows today");
+            }
+
+            bool eof() const {
+                return true;
+            }
+
+            void next() {}
+
+            void column(sqlite3_context*, int) const {}
+
+            sqlite3_int64 rowid() const {
+                return 0;
+            }
+        };
+
+        cursor_type open() const {
+            return {};
+        }
+
+        int best_index(sqlite3_index_info&) const {
+            return SQLITE_OK;
+        }
+    };
+}
+
+TEST_CASE("generate_series") {
+    auto storage = make_storage("", make_generate_series_table());
+    storage.sync_schema();
+
+    SECTION("start and stop") {
+        auto rows = storage.select(&generate_series::value,
+                                   where(c(&generate_series::start) == 1 and c(&generate_series::stop) == 5));
+        REQUIRE(rows == std::vector<int64>{1, 2, 3, 4, 5});
+    }
+    SECTION("step") {
+        auto rows = storage.select(
+            &generate_series::value,
+            where(c(&generate_series::start) == 10 and c(&generate_series::stop) == 0 and
+                  c(&generate_series::step) == -4));
+        REQUIRE(rows == std::vector<int64>{10, 6, 2});
+    }
+    SECTION("aggregate") {
+        auto rows = storage.select(sum(&generate_series::value),
+                                   where(c(&generate_series::start) == 1 and c(&generate_series::stop) == 100));
+        REQUIRE(rows.size() == 1);
+        REQUIRE(rows.front());
+        REQUIRE(*rows.front() == 5050);
+    }
+}
+
+TEST_CASE("span table") {
+    std::vector<WantedUser> wanted{{1, 0.5}, {3, 2.5}};
+    auto storage = make_storage("",
+                                make_span_table("wanted_users",
+                                                wanted,
+                                                make_column("id", &WantedUser::id),
+                                                make_column("score", &WantedUser::score)),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice"});
+    storage.replace(User{2, "Bob"});
+    storage.replace(User{3, "Carol"});
+
+    SECTION("get_all") {
+        auto rows = storage.get_all<WantedUser>();
+        REQUIRE(rows.size() == 2);
+        REQUIRE(rows[1].id == 3);
+        REQUIRE(rows[1].score == 2.5);
+    }
+    SECTION("join") {
+        auto rows = storage.select(columns(&User::name, &WantedUser::score),
+                                   inner_join<WantedUser>(on(c(&WantedUser::id) == &User::id)),
+                                   order_by(&User::id));
+        REQUIRE(rows == std::vector<std::tuple<std::string, double>>{{"Alice", 0.5}, {"Carol", 2.5}});
+    }
+    SECTION("the vector is read by every statement") {
+        wanted.push_back({2, 1.5});
+        REQUIRE(storage.count<WantedUser>() == 3);
+        wanted.clear();
+        REQUIRE(storage.count<WantedUser>() == 0);
+    }
+    SECTION("sync_schema doesn't create it") {
+        REQUIRE(storage.sync_schema_simulate().at("wanted_users") == sync_schema_result::already_in_sync);
+        REQUIRE_FALSE(storage.table_exists("wanted_users"));
+    }
+}
+
+TEST_CASE("virtual table on connections opened later") {
+    const std::string filename = "virtual_table.sqlite";
+    ::remove(filename.c_str());
+    std::vector<WantedUser> wanted{{7, 1}};
+    auto storage = make_storage(
+        filename,
+        make_span_table("wanted_users",
+                        wanted,
+                        make_column("id", &WantedUser::id),
+                        make_column("score", &WantedUser::score)),
+        make_generate_series_table());
+    REQUIRE(storage.select(&WantedUser::id) == std::vector<int>{7});
+    REQUIRE(storage.select(count(), where(c(&generate_series::start) == 1 and c(&generate_series::stop) == 3)) ==
+            std::vector<int>{3});
+    auto copy = storage;
+    REQUIRE(copy.select(&WantedUser::id) == std::vector<int>{7});
+    ::remove(filename.c_str());
+}
+
+TEST_CASE("virtual table errors") {
+    auto storage =
+        make_storage("", make_virtual_table("failing", failing_module{}, make_column("value", &Failing::value)));
+    try {
+        storage.get_all<Failing>();
+        FAIL("get_all didn't throw");
+    } catch(const std::system_error& e) {
+        REQUIRE(std::string(e.what()).find("no rows today") != std::string::npos);
+    }
+}
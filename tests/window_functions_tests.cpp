@@ -0,0 +1,90 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Sale {
+        int id = 0;
+        std::string region;
+        int day = 0;
+        int amount = 0;
+    };
+}
+
+TEST_CASE("window functions") {
+    auto storage = make_storage({},
+                                make_table("sales",
+                                           make_column("id", &Sale::id, primary_key()),
+                                           make_column("region", &Sale::region),
+                                           make_column("day", &Sale::day),
+                                           make_column("amount", &Sale::amount)));
+    storage.sync_schema();
+    storage.replace(Sale{1, "north", 1, 10});
+    storage.replace(Sale{2, "north", 2, 20});
+    storage.replace(Sale{3, "north", 3, 20});
+    storage.replace(Sale{4, "south", 1, 5});
+    storage.replace(Sale{5, "south", 2, 15});
+
+    SECTION("row_number") {
+        auto rows = storage.select(
+            columns(&Sale::id, row_number().over(partition_by(&Sale::region), order_by(&Sale::day).desc())),
+            order_by(&Sale::id));
+        decltype(rows) expected{{1, 3}, {2, 2}, {3, 1}, {4, 2}, {5, 1}};
+        REQUIRE(rows == expected);
+    }
+    SECTION("rank") {
+        auto rows = storage.select(columns(&Sale::id,
+                                           rank().over(order_by(&Sale::amount)),
+                                           dense_rank().over(order_by(&Sale::amount))),
+                                   where(c(&Sale::region) == "north"),
+                                   order_by(&Sale::id));
+        decltype(rows) expected{{1, 1, 1}, {2, 2, 2}, {3, 2, 2}};
+        REQUIRE(rows == expected);
+    }
+    SECTION("running total") {
+        auto rows = storage.select(
+            columns(&Sale::id,
+                    total(&Sale::amount)
+                        .over(partition_by(&Sale::region),
+                              order_by(&Sale::day),
+                              rows_between(unbounded_preceding(), current_row())),
+                    total(&Sale::amount).over(order_by(&Sale::id), rows_between(preceding(1), current_row()))),
+            order_by(&Sale::id));
+        decltype(rows) expected{{1, 10, 10}, {2, 30, 30}, {3, 50, 40}, {4, 5, 25}, {5, 20, 20}};
+        REQUIRE(rows == expected);
+    }
+    SECTION("lag and lead") {
+        auto rows = storage.select(columns(&Sale::id,
+                                           lag(&Sale::amount).over(partition_by(&Sale::region), order_by(&Sale::day)),
+                                           lead(&Sale::amount, 1, -1).over(order_by(&Sale::id))),
+                                   order_by(&Sale::id));
+        REQUIRE(rows.size() == 5);
+        REQUIRE_FALSE(std::get<1>(rows[0]));
+        REQUIRE(*std::get<1>(rows[1]) == 10);
+        REQUIRE(*std::get<1>(rows[2]) == 20);
+        REQUIRE_FALSE(std::get<1>(rows[3]));
+        REQUIRE(*std::get<1>(rows[4]) == 5);
+        REQUIRE(*std::get<2>(rows[0]) == 20);
+        REQUIRE(*std::get<2>(rows[4]) == -1);
+    }
+    SECTION("named window") {
+        auto rows = storage.select(columns(&Sale::id,
+                                           count().over("w"),
+                                           first_value(&Sale::amount).over("w"),
+                                           nth_value(&Sale::amount, 2).over("w")),
+                                   window("w", partition_by(&Sale::region), order_by(&Sale::day)),
+                                   order_by(&Sale::id));
+        REQUIRE(rows.size() == 5);
+        REQUIRE(std::get<1>(rows[2]) == 3);
+        REQUIRE(*std::get<2>(rows[2]) == 10);
+        REQUIRE_FALSE(std::get<3>(rows[0]));
+        REQUIRE(*std::get<3>(rows[2]) == 20);
+        REQUIRE(*std::get<2>(rows[4]) == 5);
+    }
+    SECTION("ntile") {
+        auto rows = storage.select(ntile(2).over(order_by(&Sale::id)), order_by(&Sale::id));
+        decltype(rows) expected{1, 1, 1, 2, 2};
+        REQUIRE(rows == expected);
+    }
+}
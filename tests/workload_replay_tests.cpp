@@ -0,0 +1,98 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <chrono>  //  std::chrono::nanoseconds
+#include <memory>  //  std::make_shared
+#include <sstream>  //  std::stringstream
+#include <system_error>  //  std::system_error
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        User() = default;
+        User(int id, std::string name) : id{id}, name{move(name)} {}
+#endif
+    };
+
+    auto make_users_storage(const char* filename) {
+        return make_storage(
+            filename,
+            make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name)));
+    }
+}
+
+TEST_CASE("workload trace save and load") {
+    workload_trace trace;
+    workload_statement statement;
+    statement.start = std::chrono::nanoseconds{10};
+    statement.duration = std::chrono::nanoseconds{5};
+    statement.thread = 2;
+    statement.normalized_sql = "SELECT ?\n";
+    statement.expanded_sql = "SELECT 'a\tb\\c'";
+    trace.statements.push_back(statement);
+
+    std::stringstream stream;
+    trace.save(stream);
+    auto loaded = workload_trace::load(stream);
+    REQUIRE(loaded.statements.size() == 1);
+    REQUIRE(loaded.statements[0].start == statement.start);
+    REQUIRE(loaded.statements[0].duration == statement.duration);
+    REQUIRE(loaded.statements[0].thread == 2);
+    REQUIRE(loaded.statements[0].normalized_sql == statement.normalized_sql);
+    REQUIRE(loaded.statements[0].expanded_sql == statement.expanded_sql);
+
+    std::stringstream malformed{"1\t2\tSELECT 1\n"};
+    REQUIRE_THROWS_AS(workload_trace::load(malformed), std::system_error);
+}
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+TEST_CASE("workload replay") {
+    const char* capturedFilename = "workload_captured.sqlite";
+    const char* replayedFilename = "workload_replayed.sqlite";
+    ::remove(capturedFilename);
+    ::remove(replayedFilename);
+    auto captured = make_users_storage(capturedFilename);
+    captured.sync_schema();
+    auto recorder = std::make_shared<workload_recorder>();
+    captured.on_profile([recorder](const statement_profile& profile) {
+        recorder->record(profile);
+    });
+    captured.transaction([&captured] {
+        captured.replace(User{1, "Alice"});
+        captured.replace(User{2, "Bob"});
+        return true;
+    });
+    REQUIRE(captured.get<User>(2).name == "Bob");
+    captured.on_profile(nullptr);
+    auto trace = recorder->trace();
+    REQUIRE(trace.statements.size() >= 4);
+
+    auto replayed = make_users_storage(replayedFilename);
+    replayed.sync_schema();
+    SECTION("one thread") {
+        auto report = replayed.replay_workload(trace);
+        REQUIRE(report.statements == trace.statements.size());
+        REQUIRE(report.errors == 0);
+        REQUIRE(report.p50 <= report.p90);
+        REQUIRE(report.p99 <= report.max);
+        REQUIRE(replayed.count<User>() == 2);
+    }
+    SECTION("replaying again on two threads") {
+        replayed.replay_workload(trace);
+        workload_replay_options options;
+        options.threads = 2;
+        options.speed = 100;
+        auto report = replayed.replay_workload(trace, options);
+        REQUIRE(report.statements == trace.statements.size());
+        REQUIRE(report.errors == 0);
+        REQUIRE(replayed.count<User>() == 2);
+    }
+    REQUIRE(replayed.replay_sql("SELECT * FROM users") == 2);
+    ::remove(capturedFilename);
+    ::remove(replayedFilename);
+}
+#endif
@@ -0,0 +1,81 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <chrono>  //  std::chrono::milliseconds
+#include <future>  //  std::future
+#include <mutex>  //  std::mutex, std::lock_guard
+#include <thread>  //  std::thread
+#include <vector>  //  std::vector
+
+using namespace sqlite_orm;
+
+namespace {
+    struct User {
+        int id = 0;
+        std::string name;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        User() = default;
+        User(int id, std::string name) : id{id}, name{move(name)} {}
+#endif
+    };
+}
+
+TEST_CASE("write batcher") {
+    auto filename = "write_batcher.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(
+        filename,
+        make_table("users", make_column("id", &User::id, primary_key()), make_column("name", &User::name, unique())));
+    storage.sync_schema();
+    int commitsCount = 0;
+    storage.open_forever();
+    auto statement = storage.prepare(select(1));
+    sqlite3_commit_hook(
+        statement.con.get(),
+        [](void* data) {
+            ++*static_cast<int*>(data);
+            return 0;
+        },
+        &commitsCount);
+
+    SECTION("writes from many threads are committed in batches") {
+        std::vector<std::future<int>> ids;
+        {
+            auto batcher = storage.make_write_batcher(50, std::chrono::milliseconds{200});
+            std::mutex idsMutex;
+            std::vector<std::thread> threads;
+            for(int t = 0; t < 4; ++t) {
+                threads.emplace_back([&batcher, &ids, &idsMutex, t] {
+                    for(int i = 0; i < 25; ++i) {
+                        auto id = batcher->insert(User{0, std::to_string(t) + "_" + std::to_string(i)});
+                        std::lock_guard<std::mutex> lock{idsMutex};
+                        ids.push_back(std::move(id));
+                    }
+                });
+            }
+            for(auto& thread: threads) {
+                thread.join();
+            }
+            for(auto& id: ids) {
+                REQUIRE(id.get() > 0);
+            }
+        }
+        REQUIRE(storage.count<User>() == 100);
+        REQUIRE(commitsCount <= 3);
+    }
+    SECTION("a failing write fails only its own future") {
+        auto batcher = storage.make_write_batcher(3, std::chrono::milliseconds{200});
+        auto first = batcher->replace(User{1, "Alice"});
+        auto duplicate = batcher->insert(User{0, "Alice"});
+        auto second = batcher->replace(User{2, "Bob"});
+        REQUIRE_NOTHROW(first.get());
+        REQUIRE_THROWS_AS(duplicate.get(), std::system_error);
+        REQUIRE_NOTHROW(second.get());
+        REQUIRE(commitsCount == 1);
+        REQUIRE(storage.count<User>() == 2);
+
+        auto removed = batcher->remove<User>(1);
+        removed.get();
+        REQUIRE(storage.count<User>() == 1);
+    }
+}
@@ -0,0 +1,112 @@
+#include <sqlite_orm/sqlite_orm.h>
+#include <catch2/catch_all.hpp>
+#include <chrono>  //  std::chrono::milliseconds, std::chrono::hours, std::chrono::steady_clock
+#include <thread>  //  std::this_thread::sleep_for
+
+using namespace sqlite_orm;
+
+namespace {
+    struct Session {
+        int id = 0;
+        std::string user;
+        int64 lastSeen = 0;
+
+#ifndef SQLITE_ORM_AGGREGATE_NSDMI_SUPPORTED
+        Session() = default;
+        Session(int id, std::string user, int64 lastSeen) : id{id}, user{move(user)}, lastSeen{lastSeen} {}
+#endif
+    };
+
+    template<class F>
+    bool eventually(F condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while(!condition()) {
+            if(std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return true;
+    }
+}
+
+TEST_CASE("write behind") {
+    auto storage = make_storage({},
+                                make_table("sessions",
+                                           make_column("id", &Session::id, primary_key()),
+                                           make_column("user", &Session::user, unique()),
+                                           make_column("last_seen", &Session::lastSeen)));
+    storage.sync_schema();
+    storage.replace(Session{1, "alice", 0});
+    storage.replace(Session{2, "bob", 0});
+    auto lastSeen = [&storage](int id) {
+        return storage.get<Session>(id).lastSeen;
+    };
+
+    SECTION("coalesces") {
+        auto sessions = storage.make_write_behind<Session>(write_behind_options{std::chrono::hours{1}, 1000});
+        for(int64 time = 1; time <= 100; ++time) {
+            sessions->update(Session{1, "alice", time});
+        }
+        sessions->update(Session{2, "bob", 7});
+        REQUIRE(sessions->pending_count() == 2);
+        REQUIRE(lastSeen(1) == 0);
+        REQUIRE(sessions->get(1).lastSeen == 100);
+        REQUIRE(sessions->get_pointer(2)->lastSeen == 7);
+        REQUIRE(sessions->get_pointer(3) == nullptr);
+        REQUIRE_THROWS_AS(sessions->get(3), std::system_error);
+
+        sessions->flush();
+        REQUIRE(sessions->pending_count() == 0);
+        REQUIRE(lastSeen(1) == 100);
+        REQUIRE(lastSeen(2) == 7);
+        auto stats = sessions->stats();
+        REQUIRE(stats.updates == 101);
+        REQUIRE(stats.coalesced == 99);
+        REQUIRE(stats.flushes == 1);
+        REQUIRE(stats.rows_written == 2);
+    }
+    SECTION("max pending") {
+        auto sessions = storage.make_write_behind<Session>(write_behind_options{std::chrono::hours{1}, 2});
+        sessions->update(Session{1, "alice", 5});
+        sessions->update(Session{1, "alice", 6});
+        REQUIRE(sessions->pending_count() == 1);
+        sessions->update(Session{2, "bob", 6});
+        REQUIRE(eventually([&sessions] {
+            return sessions->stats().flushes == 1;
+        }));
+        REQUIRE(lastSeen(1) == 6);
+        REQUIRE(lastSeen(2) == 6);
+    }
+    SECTION("interval") {
+        auto sessions = storage.make_write_behind<Session>(write_behind_options{std::chrono::milliseconds{10}, 1000});
+        sessions->update(Session{1, "alice", 9});
+        REQUIRE(eventually([&sessions] {
+            return sessions->stats().flushes == 1;
+        }));
+        REQUIRE(lastSeen(1) == 9);
+    }
+    SECTION("destructor flushes") {
+        {
+            auto sessions = storage.make_write_behind<Session>(write_behind_options{std::chrono::hours{1}, 1000});
+            sessions->update(Session{2, "bob", 3});
+        }
+        REQUIRE(lastSeen(2) == 3);
+    }
+    SECTION("failed flush") {
+        auto sessions = storage.make_write_behind<Session>(write_behind_options{std::chrono::hours{1}, 1000});
+        sessions->update(Session{1, "bob", 4});
+        sessions->update(Session{2, "bob", 4});
+        REQUIRE_THROWS_AS(sessions->flush(), std::system_error);
+        REQUIRE(sessions->pending_count() == 2);
+        REQUIRE(sessions->get(1).user == "bob");
+        REQUIRE(lastSeen(2) == 0);
+        sessions->update(Session{1, "alice", 5});
+        sessions->flush();
+        REQUIRE(lastSeen(1) == 5);
+        REQUIRE(lastSeen(2) == 4);
+        auto stats = sessions->stats();
+        REQUIRE(stats.failed_flushes == 1);
+        REQUIRE(stats.flushes == 1);
+    }
+}